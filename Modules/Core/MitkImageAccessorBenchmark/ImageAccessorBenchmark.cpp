@@ -0,0 +1,107 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkImage.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// MitkCommandLine depends on MitkCore, so the arguments are parsed by hand:
+// ImageAccessorBenchmark [maximum number of threads (default: 64)] [accesses per thread (default: 2000)]
+
+const unsigned int NUMBER_OF_SLICES = 16;
+const unsigned int SLICE_SIZE = 64 * 64;
+
+mitk::Image::Pointer CreateImage()
+{
+  auto image = mitk::Image::New();
+  std::array<unsigned int, 4> dimensions = {{64, 64, NUMBER_OF_SLICES, 2}};
+  image->Initialize(mitk::MakeScalarPixelType<unsigned short>(), 4, dimensions.data());
+
+  mitk::ImageWriteAccessor accessor(image);
+  std::fill_n(static_cast<unsigned short *>(accessor.GetData()), SLICE_SIZE * NUMBER_OF_SLICES * 2, 0);
+  return image;
+}
+
+// runs the given function in numberOfThreads threads and returns the accessors acquired per second
+template <typename TFunction>
+double MeasureThroughput(unsigned int numberOfThreads, unsigned int accessesPerThread, TFunction function)
+{
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+
+  for (unsigned int i = 0; i < numberOfThreads; ++i)
+  {
+    threads.emplace_back(function, i);
+  }
+
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+  return (numberOfThreads * accessesPerThread) / std::max(duration.count(), 1e-9);
+}
+
+int main(int argc, char *argv[])
+{
+  const unsigned int maximumNumberOfThreads = argc > 1 ? std::max(1, std::atoi(argv[1])) : 64;
+  const unsigned int accessesPerThread = argc > 2 ? std::max(1, std::atoi(argv[2])) : 2000;
+
+  mitk::Image::Pointer image = CreateImage();
+
+  for (unsigned int numberOfThreads = 1; numberOfThreads <= maximumNumberOfThreads; numberOfThreads *= 2)
+  {
+    const double readThroughput =
+      MeasureThroughput(numberOfThreads, accessesPerThread, [&image, accessesPerThread](unsigned int threadId) {
+        for (unsigned int i = 0; i < accessesPerThread; ++i)
+        {
+          mitk::ImageReadAccessor accessor(image, image->GetSliceData((threadId + i) % NUMBER_OF_SLICES));
+        }
+      });
+
+    // every 16th access writes a slice, all others read one
+    const double mixedThroughput =
+      MeasureThroughput(numberOfThreads, accessesPerThread, [&image, accessesPerThread](unsigned int threadId) {
+        for (unsigned int i = 0; i < accessesPerThread; ++i)
+        {
+          auto slice = image->GetSliceData((threadId * 7 + i) % NUMBER_OF_SLICES);
+          if ((threadId + i) % 16 == 0)
+          {
+            mitk::ImageWriteAccessor accessor(image, slice);
+            std::fill_n(static_cast<unsigned short *>(accessor.GetData()), SLICE_SIZE, threadId + i);
+          }
+          else
+          {
+            mitk::ImageReadAccessor accessor(image, slice);
+          }
+        }
+      });
+
+    std::cout << numberOfThreads << " threads: read accessors " << readThroughput << " acquisitions/s, mixed accessors "
+              << mixedThroughput << " acquisitions/s" << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -36,6 +36,10 @@ namespace mitk
    * faster by several orders of magnitude as long as the input image was
    * neither changed nor modified.
    *
+   * Nearest neighbor and linear interpolation of scalar pixel types do not
+   * evaluate ITK interpolate image functions but step through the input
+   * buffer along each row of the output image, which is considerably faster.
+   *
    * This filter is completely based on ITK compared to the VTK-based
    * mitk::ExtractSliceFilter. It is more robust, easy to use, and produces
    * an mitk::Image with valid geometry. Generally it is not as fast as
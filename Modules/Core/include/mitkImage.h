@@ -21,8 +21,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageAccessorBase.h"
 #include "mitkImageDataItem.h"
 #include "mitkImageDescriptor.h"
+#include "mitkImageTimeStepSwapStorage.h"
 #include "mitkImageVtkAccessor.h"
 #include "mitkLevelWindow.h"
+#include "mitkMemoryMappedFile.h"
 #include "mitkPlaneGeometry.h"
 #include "mitkSlicedData.h"
 #include <MitkCoreExports.h>
@@ -31,6 +33,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 // DEPRECATED
 #include <mitkTimeSlicedGeometry.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+
 #ifndef __itkHistogram_h
 #include <itkHistogram.h>
 #endif
@@ -261,6 +268,14 @@ namespace mitk
                                   int n = 0,
                                   ImportMemoryManagementType importMemoryManagement = CopyMemory);
 
+    //##Documentation
+    //## @brief Use the memory mapped file @a mappedFile as data of channel @a n.
+    //##
+    //## The data is not copied. Slices and volumes are only read from disk when
+    //## they are accessed for the first time. The image keeps the mapping alive.
+    //## Returns false if the mapped part of the file is smaller than a channel.
+    virtual bool SetMappedChannel(MemoryMappedFile::Pointer mappedFile, int n = 0);
+
     //##Documentation
     //## initialize new (or re-initialize) image information
     //## @warning Initialize() by pic assumes a plane, evenly spaced geometry starting at (0,0,0).
@@ -646,6 +661,40 @@ namespace mitk
       new \a ImageStatisticsHolder object.
       */
     StatisticsHolderPointer GetStatistics() const { return m_ImageStatistics; }
+
+    /** \brief Counters of the time step cache, see SetTimeStepSwapStorage() */
+    struct TimeStepCacheStatistics
+    {
+      /** Number of volume requests that were served from memory */
+      unsigned long m_Hits;
+      /** Number of volume requests that had to be restored from the swap storage */
+      unsigned long m_Misses;
+      /** Number of volumes that were moved to the swap storage */
+      unsigned long m_Evictions;
+      /** Size of the evictable volumes that are currently held in memory */
+      size_t m_ResidentBytes;
+    };
+
+    /**
+      \brief Sets the storage that takes the least recently used time steps if the memory budget is exceeded.
+
+      Evicted volumes are restored transparently as soon as they are requested again, e.g. by an image accessor.
+      Only volumes that are neither referenced outside of the image nor locked by an accessor are evicted. As
+      volumes of a complete channel share its memory, the channels of a dynamic image are split into separate
+      volumes by this method. Requesting the data of a complete channel later on restores all its volumes.
+
+      Set nullptr to disable the eviction. All evicted volumes are restored in this case.
+      */
+    void SetTimeStepSwapStorage(ImageTimeStepSwapStorage *storage);
+    ImageTimeStepSwapStorage *GetTimeStepSwapStorage() const;
+
+    /** \brief Sets the number of bytes that the volumes of the image may occupy before the least recently used ones
+     *  are evicted. 0 (default) means unlimited. */
+    void SetTimeStepMemoryBudget(size_t numberOfBytes);
+    size_t GetTimeStepMemoryBudget() const;
+
+    TimeStepCacheStatistics GetTimeStepCacheStatistics() const;
+
   protected:
     mitkCloneMacro(Self);
 
@@ -737,10 +786,89 @@ namespace mitk
     /** Stores all existing ImageVtkAccessors */
     mutable std::vector<ImageAccessorBase *> m_VtkReaders;
 
+    /** Number of ImageWriteAccessors that hold or wait for a lock. ImageReadAccessors only take the
+     *  lock-free fast path as long as this counter is zero. */
+    mutable std::atomic<unsigned int> m_PendingWriterCount;
+
+    /** Registers an ImageReadAccessor that was granted access on the fast path together with the memory it reads.
+     *  m_Reader only identifies the accessor and is never dereferenced by other threads. */
+    struct FastPathReaderSlot
+    {
+      std::atomic<const ImageAccessorBase *> m_Reader;
+      std::atomic<const void *> m_AddressBegin;
+      std::atomic<const void *> m_AddressEnd;
+    };
+
+    /** Number of ImageReadAccessors that can take the fast path at the same time, all others are regular readers */
+    static const unsigned int NumberOfFastPathReaderSlots = 32;
+
+    /** ImageReadAccessors that were granted access on the fast path and are not listed in m_Readers */
+    mutable FastPathReaderSlot m_FastPathReaders[NumberOfFastPathReaderSlots];
+    /** Write accessors wait on m_FastPathReaderReleased for overlapping fast path readers, which notify it under
+     *  m_FastPathReaderMutex when they are released while a writer is pending */
+    mutable std::mutex m_FastPathReaderMutex;
+    mutable std::condition_variable m_FastPathReaderReleased;
+
+    /** Returns if a fast path reader reads memory in [begin, end) */
+    bool HasFastPathReader(const void *begin, const void *end) const;
+
+    /** Returns if any image accessor reads or writes memory in [begin, end). m_ReadWriteLock must be locked. */
+    bool HasAccessor(const void *begin, const void *end) const;
+
+    /** Number of ImageWriteAccessors that were granted access so far, guarded by m_ReadWriteLock */
+    unsigned long m_WriteAccessCount;
+
     /** A mutex, which needs to be locked to manage m_Readers and m_Writers */
-    itk::SimpleFastMutexLock m_ReadWriteLock;
+    mutable itk::SimpleFastMutexLock m_ReadWriteLock;
     /** A mutex, which needs to be locked to manage m_VtkReaders */
     itk::SimpleFastMutexLock m_VtkReadersLock;
+
+    /** Returns if the volume at position pos of m_Volumes is held by the swap storage */
+    bool IsVolumeSwappedOut_unlocked(int pos) const;
+    /** Moves a volume back from the swap storage into m_Volumes */
+    ImageDataItemPointer RestoreVolume_unlocked(int t, int n) const;
+    /** Marks the volume at position pos of m_Volumes as most recently used */
+    void TouchVolume_unlocked(int pos) const;
+    /** Returns if the volume at position pos of m_Volumes is only referenced by the image itself */
+    bool IsVolumeEvictable_unlocked(int pos) const;
+    /** Returns the least recently used volume that is evictable and not locked by an accessor, or -1.
+     *  m_ReadWriteLock must be locked as well. */
+    int FindEvictionCandidate_unlocked(const std::vector<bool> &skipped) const;
+    /** Removes the volume at position pos of m_Volumes from the list of resident volumes */
+    void ForgetResidentVolume_unlocked(int pos) const;
+    /** Forgets all resident and swapped out volumes, e.g. after the layout of the image changed */
+    void ResetTimeStepCache_unlocked() const;
+    /** Evicts least recently used volumes until the time step memory budget is met */
+    void EvictTimeSteps() const;
+    /** Replaces complete channels of dynamic images by separately allocated volumes, so that these can be evicted */
+    void SplitChannelsIntoVolumes();
+
+    /** A volume that occupies memory of its own and may be evicted. m_Item is only compared, never dereferenced,
+     *  since the volume might have been replaced in m_Volumes in the meantime. */
+    struct ResidentVolume
+    {
+      int m_Position;
+      const ImageDataItem *m_Item;
+      size_t m_Size;
+    };
+    typedef std::list<ResidentVolume> ResidentVolumeList;
+
+    itk::SmartPointer<ImageTimeStepSwapStorage> m_TimeStepSwapStorage;
+    size_t m_TimeStepMemoryBudget;
+    /** Serializes the calls of m_TimeStepSwapStorage, which stores evicted volumes while m_ImageDataArraysLock is
+     *  not locked. Locked after m_ImageDataArraysLock, if both are needed. */
+    mutable std::mutex m_TimeStepSwapStorageMutex;
+    /** Only one thread evicts volumes at a time */
+    mutable std::mutex m_EvictionMutex;
+    /** One entry per element of m_Volumes */
+    mutable std::vector<bool> m_SwappedOutVolumes;
+    /** Resident volumes, least recently used first */
+    mutable ResidentVolumeList m_ResidentVolumes;
+    /** One entry per element of m_Volumes, pointing into m_ResidentVolumes or to its end */
+    mutable std::vector<ResidentVolumeList::iterator> m_ResidentVolumeEntries;
+    /** Sum of the sizes in m_ResidentVolumes, so that accesses within the budget return right away */
+    mutable std::atomic<size_t> m_ResidentVolumeBytes;
+    mutable TimeStepCacheStatistics m_TimeStepCacheStatistics;
   };
 
   /**
@@ -128,6 +128,15 @@ namespace mitk
     /** \brief Pointer to a WaitLock struct, that allows other ImageAccessors to wait for this ImageAccessor */
     ImageAccessorWaitLock *m_WaitLock;
 
+    /** \brief Defines if this accessor was granted read access on the lock-free fast path.
+      * Such an accessor is neither listed in mitk::Image::m_Readers nor holds m_WaitLock. It occupies the slot
+      * m_FastPathSlot of mitk::Image::m_FastPathReaders, which holds its memory area, and is registered for the thread
+      * that created it.
+      */
+    bool m_FastPath;
+
+    unsigned int m_FastPathSlot;
+
     /** \brief Increments m_WaiterCount. A call of this method is prohibited unless the Mutex m_ReadWriteLock in the
      * mitk::Image class is Locked. */
     inline void Increment() { m_WaitLock->m_WaiterCount += 1; }
@@ -147,6 +156,22 @@ namespace mitk
 
     virtual const Image *GetImage() const = 0;
 
+    /** \brief Registers this fast path reader for the calling thread. */
+    void RegisterFastPathReader();
+
+    /** \brief Removes this fast path reader from the registry of the calling thread. */
+    void UnregisterFastPathReader();
+
+    /** \brief Prevents a recursive lock by fast path readers of the calling thread, which access the image of this
+      * accessor. Non-overlapping ones are ignored by write accessors of the same thread.
+      * \throws mitk::Exception if one of them overlaps with this accessor (recursive lock)
+      */
+    void PreventRecursiveFastPathLock();
+
+    /** \brief Computes if a fast path reader of another thread accesses a part of the image that overlaps with the
+      * image part of this accessor. */
+    bool OverlapsFastPathReaderOfOtherThread() const;
+
   private:
     /** \brief System dependend thread method, to prevent recursive mutex access */
     ThreadIDType CurrentThreadHandle();
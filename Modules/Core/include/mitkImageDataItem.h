@@ -22,6 +22,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 //#include <mitkIpPic.h>
 //#include "mitkPixelType.h"
 #include "mitkImageDescriptor.h"
+#include "mitkMemoryMappedFile.h"
 //#include "mitkImageVtkAccessor.h"
 
 class vtkImageData;
@@ -90,6 +91,13 @@ namespace mitk
                   void *data,
                   bool manageMemory);
 
+    /**
+     * @brief Uses the memory mapped file as data. The item keeps the mapping alive as long as it or one of its
+     * sub-items exists.
+     * @throws mitk::Exception if the mapped part of the file is smaller than the item.
+     */
+    ImageDataItem(const mitk::ImageDescriptor::Pointer desc, int timestep, MemoryMappedFile::Pointer mappedFile);
+
     ImageDataItem(const ImageDataItem &other);
 
     /**
@@ -150,6 +158,9 @@ namespace mitk
 
     size_t m_Size;
 
+    /** Keeps the file mapping alive, if m_Data points into a memory mapped file */
+    MemoryMappedFile::Pointer m_MappedFile;
+
   private:
     void ComputeItemSize(const unsigned int *dimensions, unsigned int dimension);
 
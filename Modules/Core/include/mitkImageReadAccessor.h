@@ -26,6 +26,12 @@ namespace mitk
 
   /**
    * @brief ImageReadAccessor class to get locked read access for a particular image part
+   *
+   * As long as no ImageWriteAccessor is active or waiting for the image, read access is granted without locking
+   * any mutex (fast path). The accessed memory is still registered, so that write accessors only wait for
+   * overlapping readers. Otherwise the accessor is registered in the image and waits for overlapping writers.
+   * A read accessor has to be destroyed by the thread that created it.
+   *
    * @ingroup Data
    */
   class MITKCORE_EXPORT ImageReadAccessor : public ImageAccessorBase
@@ -67,6 +73,13 @@ namespace mitk
     /** \brief manages a consistent read access and locks the ordered image part */
     void OrganizeReadAccess();
 
+    /** \brief grants read access without locking if no write accessor is active or waiting
+     *  \return true, if access was granted on the fast path */
+    bool TryFastPathReadAccess();
+
+    /** \brief frees the slot of this fast path reader and wakes up write accessors waiting for it */
+    void ReleaseFastPathSlot();
+
     ImageReadAccessor &operator=(const ImageReadAccessor &); // Not implemented on purpose.
     ImageReadAccessor(const ImageReadAccessor &);
 
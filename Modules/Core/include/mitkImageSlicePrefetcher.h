@@ -0,0 +1,160 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKIMAGESLICEPREFETCHER_H
+#define MITKIMAGESLICEPREFETCHER_H
+
+#include <MitkCoreExports.h>
+#include <mitkExtractSliceFilter.h>
+#include <mitkImage.h>
+#include <mitkPlaneGeometry.h>
+
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkSmartPointer.h>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * \brief Extracts slices of an image in the background before they are rendered.
+   *
+   * Used by ImageVtkMapper2D to keep scrolling through large images smooth: while the user scrolls, the
+   * slices following the current one in scroll direction are requested via Prefetch(). The mapper asks for
+   * them with GetSlice() before extracting a slice itself. GetSlice() never waits for the background thread.
+   *
+   * Cached slices are only returned as long as neither the image nor its geometry were modified since they
+   * were requested. Cancel() drops all pending requests and cached slices, e.g. when the plane orientation
+   * changes. A slice that is being extracted while Cancel() is called is discarded once it is finished.
+   *
+   * All prefetchers share one background thread, which processes their requests in turn, so that the number
+   * of threads does not grow with the number of mappers and render windows. The thread is stopped when the
+   * last prefetcher is destroyed.
+   *
+   * Prefetch(), GetSlice() and Cancel() are called on the rendering thread. The plane, the geometry of the
+   * image and the data item of the requested volume (Image::GetVolumeData()) are taken there when a slice is
+   * requested. The only calls on the image in the background thread are an ImageReadAccessor of that data
+   * item, which skips the slice if the image is locked by a writer, and the reference counting of the image
+   * pointer. The slice is extracted from a private image that only references the locked memory.
+   *
+   * \ingroup Renderer
+   */
+  class MITKCORE_EXPORT ImageSlicePrefetcher
+  {
+  public:
+    /** \brief Parameters of mitk::ExtractSliceFilter that affect the extracted slice */
+    struct Settings
+    {
+      Settings();
+      bool operator==(const Settings &other) const;
+
+      int m_TimeStep;
+      ExtractSliceFilter::ResliceInterpolation m_InterpolationMode;
+      bool m_InPlaneResampleExtentByGeometry;
+    };
+
+    /** \brief An extracted slice along with the output information of mitk::ExtractSliceFilter */
+    struct Slice
+    {
+      vtkSmartPointer<vtkImageData> m_Image;
+      vtkSmartPointer<vtkMatrix4x4> m_ResliceAxes;
+      double m_ClippedPlaneBounds[6];
+      ScalarType m_Spacing[2];
+    };
+
+    typedef std::shared_ptr<Slice> SlicePointer;
+
+    ImageSlicePrefetcher();
+    ~ImageSlicePrefetcher();
+
+    /** \brief Returns the slice of image along plane if it has been extracted already, nullptr otherwise. */
+    SlicePointer GetSlice(const Image *image, const PlaneGeometry *plane, const Settings &settings);
+
+    /** \brief Requests slices of image along planes, which are extracted in the given order.
+     *
+     * Pending requests for other planes, images or settings are dropped. */
+    void Prefetch(const Image *image, const std::vector<PlaneGeometry::ConstPointer> &planes, const Settings &settings);
+
+    /** \brief Drops all pending requests and cached slices. */
+    void Cancel();
+
+    /** \brief Returns the number of cached slices. */
+    std::size_t GetNumberOfCachedSlices() const;
+
+    /** \brief Blocks until all pending requests are processed. Intended for testing. */
+    void WaitUntilIdle();
+
+  private:
+    ImageSlicePrefetcher(const ImageSlicePrefetcher &) = delete;
+    ImageSlicePrefetcher &operator=(const ImageSlicePrefetcher &) = delete;
+
+    /** The background thread shared by all prefetchers */
+    class Worker;
+
+    struct Request
+    {
+      Image::ConstPointer m_Image;
+      /** Shares the memory of m_Image, so that the background thread has its own vtkImageData and geometry */
+      Image::Pointer m_ImageView;
+      /** Requested volume of m_Image, which is read by the background thread */
+      Image::ImageDataItemPointer m_VolumeData;
+      /** Copy of the requested plane, which references m_ReferenceGeometry */
+      PlaneGeometry::ConstPointer m_Plane;
+      BaseGeometry::ConstPointer m_ReferenceGeometry;
+      /** Reference geometry of the requested plane, only compared and never dereferenced */
+      const BaseGeometry *m_RequestedReferenceGeometry;
+      Settings m_Settings;
+      unsigned long m_ImageMTime;
+      unsigned long m_Generation;
+    };
+
+    struct CacheEntry
+    {
+      Request m_Request;
+      SlicePointer m_Slice;
+    };
+
+    /** Returns if the request and the image, plane and settings of a slice belong together */
+    static bool Matches(const Request &request,
+                        const Image *image,
+                        unsigned long imageMTime,
+                        const PlaneGeometry *plane,
+                        const Settings &settings);
+
+    static unsigned long GetImageMTime(const Image *image, int timeStep);
+
+    /** Processes the first pending request in the background thread. Returns if more requests are pending. */
+    bool ProcessNextRequest();
+    SlicePointer ExtractSlice(const Request &request);
+
+    std::shared_ptr<Worker> m_Worker;
+
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_RequestProcessed;
+    std::deque<Request> m_Requests;
+    std::deque<CacheEntry> m_Cache;
+    std::size_t m_CacheCapacity;
+    unsigned long m_Generation;
+    bool m_IsBusy;
+  };
+}
+
+#endif
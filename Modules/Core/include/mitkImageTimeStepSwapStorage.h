@@ -0,0 +1,67 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKIMAGETIMESTEPSWAPSTORAGE_H
+#define MITKIMAGETIMESTEPSWAPSTORAGE_H
+
+#include "mitkCommon.h"
+#include <MitkCoreExports.h>
+
+#include <itkObject.h>
+
+namespace mitk
+{
+  /**
+   * \brief Interface for storages that hold the data of time steps which were evicted from an mitk::Image.
+   *
+   * An image with a swap storage (see mitk::Image::SetTimeStepSwapStorage()) moves the least recently used
+   * volumes into it as soon as its time step memory budget is exceeded and restores them as soon as they are
+   * requested again. Implementations may compress the data or write it to disk.
+   *
+   * The image serializes all calls, so implementations do not need to be thread-safe as long as they are not shared
+   * between images. Store() is called while the image data arrays are not locked, so that the image stays
+   * accessible while the data is compressed or written.
+   *
+   * \ingroup Data
+   */
+  class MITKCORE_EXPORT ImageTimeStepSwapStorage : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(ImageTimeStepSwapStorage, itk::Object);
+
+    /** \brief Stores a copy of the data of volume t of channel n. Replaces data stored before. */
+    virtual void Store(int t, int n, const void *data, size_t size) = 0;
+
+    /** \brief Copies the data of volume t of channel n into data and removes it from the storage.
+     *  \return false, if no data of size bytes is stored for this volume. */
+    virtual bool Restore(int t, int n, void *data, size_t size) = 0;
+
+    /** \brief Removes the data of volume t of channel n, if any. */
+    virtual void Discard(int t, int n) = 0;
+
+    /** \brief Removes all stored data. */
+    virtual void DiscardAll() = 0;
+
+    /** \brief Returns the number of bytes occupied by the stored data. */
+    virtual size_t GetStoredSize() const = 0;
+
+  protected:
+    ImageTimeStepSwapStorage() {}
+    ~ImageTimeStepSwapStorage() override {}
+  };
+}
+
+#endif
@@ -213,6 +213,17 @@ namespace mitk
      */
     void CreateSurface(int time, vtkImageData *vtkimage, mitk::Surface *surface, const ScalarType threshold);
 
+    /**
+     * Smoothes and decimates a surface created by vtkMarchingCubes in index coordinates of the image, transforms
+     * it into world coordinates and sets it as time step of the output. This is the part of CreateSurface() after
+     * the marching cubes, for subclasses that assemble the marching cubes surface themselves.
+     *
+     * @param time selected slice or "0" for single
+     * @param *polydata marching cubes surface, the origin of the image at (0, 0, 0)
+     * @param *surface output
+     */
+    void ProcessSurface(int time, vtkPolyData *polydata, mitk::Surface *surface);
+
     /**
     * Flag whether the created surface shall be smoothed or not (default is "false"). SetSmooth (bool _arg)
     * */
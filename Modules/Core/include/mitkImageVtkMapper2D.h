@@ -23,6 +23,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 // MITK Rendering
 #include "mitkBaseRenderer.h"
 #include "mitkExtractSliceFilter.h"
+#include "mitkImageSlicePrefetcher.h"
 #include "mitkVtkMapper.h"
 
 // VTK
@@ -190,6 +191,13 @@ namespace mitk
       /** \brief This filter is used to apply the level window to Grayvalue and RBG(A) images. */
       vtkSmartPointer<vtkMitkLevelWindowFilter> m_LevelWindowFilter;
 
+      /** \brief Extracts the next slices in scroll direction in the background. */
+      std::unique_ptr<ImageSlicePrefetcher> m_SlicePrefetcher;
+      /** \brief Prefetched slice that is currently rendered instead of the output of m_Reslicer, if any. */
+      ImageSlicePrefetcher::SlicePointer m_PrefetchedSlice;
+      /** \brief World plane of the last rendered slice to determine the scroll direction. */
+      PlaneGeometry::ConstPointer m_LastWorldPlane;
+
       /** \brief Default constructor of the local storage. */
       LocalStorage();
       /** \brief Default deconstructor of the local storage. */
@@ -303,6 +311,18 @@ namespace mitk
       * If the distances have different sign, there is an intersection.
       **/
     bool RenderingGeometryIntersectsImage(const PlaneGeometry *renderingGeometry, SlicedGeometry3D *imageGeometry);
+
+    /**
+      * \brief Requests the next slices in scroll direction from the slice prefetcher of the renderer.
+      *
+      * If the current world plane is the last one shifted along its normal, the property
+      * "reslice.prefetch slices" (default: 4) determines how many of the following planes
+      * are extracted in the background. Any other change of the world plane cancels
+      * pending requests. A value of 0 disables prefetching.
+      */
+    void PrefetchSlices(mitk::BaseRenderer *renderer,
+                        const PlaneGeometry *worldPlane,
+                        const ImageSlicePrefetcher::Settings &settings);
   };
 
 } // namespace mitk
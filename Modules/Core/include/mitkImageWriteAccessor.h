@@ -59,6 +59,14 @@ namespace mitk
     /** \brief manages a consistent write access and locks the ordered image part */
     void OrganizeWriteAccess();
 
+    /** \brief waits until all read accessors of other threads, which were granted access on the fast path and
+     * overlap with this accessor, are released.
+     *  \throws mitk::MemoryIsLockedException if there are such readers and mitk::ImageAccessorBase::ExceptionIfLocked
+     * is set
+     *  \throws mitk::Exception if an overlapping fast path reader of the current thread exists (recursive lock)
+     */
+    void WaitForFastPathReaders();
+
     ImageWriteAccessor &operator=(const ImageWriteAccessor &); // Not implemented on purpose.
     ImageWriteAccessor(const ImageWriteAccessor &);
 
@@ -103,6 +103,25 @@ namespace mitk
     //## @param limit the maximum number of items on the stack
     void SetUndoLimit(std::size_t limit) override;
 
+    //##Documentation
+    //## @brief Gets the limit on the memory of the undo history in bytes.
+    //## If the value is 0 that means that there is no limit.
+    std::size_t GetMemoryLimit() const;
+
+    //##Documentation
+    //## @brief Sets a limit on the memory of the undo and redo stack in bytes.
+    //## If the limit is exceeded, the oldest undo groups (items of the same
+    //## GroupEventId) will be dropped as a whole from the bottom of the undo
+    //## stack; the latest group is always kept.
+    //## The memory of an item is given by UndoStackItem::GetMemorySize().
+    //## The 0 value means that there is no limit.
+    //## @param limit the maximum number of bytes of all items on the stacks
+    void SetMemoryLimit(std::size_t limit);
+
+    //##Documentation
+    //## @brief Returns the memory of all items on the undo and redo stack in bytes
+    std::size_t GetMemorySize() const;
+
     //##Documentation
     //## @brief Returns the ObjectEventId of the
     //## top element in the OperationHistory
@@ -131,6 +150,13 @@ namespace mitk
     //## elements in the list and to clear the list
     void ClearList(UndoContainer *list);
 
+    //## @brief Puts a new item on top of the undo stack and drops the oldest items
+    //## as long as the undo limit or the memory limit is exceeded
+    void PushUndoItem(UndoStackItem *item);
+
+    //## @brief Drops the oldest groups of the undo stack until the memory limit is kept
+    void EnforceMemoryLimit();
+
     UndoContainer m_UndoList;
 
     UndoContainer m_RedoList;
@@ -140,6 +166,8 @@ namespace mitk
 
     std::size_t m_UndoLimit;
 
+    std::size_t m_MemoryLimit;
+
   };
 
 #pragma GCC visibility push(default)
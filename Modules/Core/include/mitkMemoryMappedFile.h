@@ -0,0 +1,105 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKMEMORYMAPPEDFILE_H
+#define MITKMEMORYMAPPEDFILE_H
+
+#include <MitkCoreExports.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace mitk
+{
+  /**
+   * \brief Maps a part of a file into memory.
+   *
+   * The mapping is private (copy-on-write): the data can be modified, but changes are never written back to the
+   * file. Pages are only read from disk when they are accessed for the first time, so the resident memory of a
+   * mapped image tracks the part of it that is actually used.
+   *
+   * The file must not be truncated or modified by other processes while it is mapped. Writers that overwrite a file
+   * within this process call DetachFromFile() first.
+   *
+   * \ingroup Data
+   */
+  class MITKCORE_EXPORT MemoryMappedFile
+  {
+  public:
+    typedef std::shared_ptr<MemoryMappedFile> Pointer;
+
+    /**
+     * \brief Maps length bytes of the file, starting at offset. The offset does not need to be page aligned.
+     * \throws mitk::Exception if the file cannot be opened or mapped or is too small.
+     */
+    MemoryMappedFile(const std::string &fileName, std::size_t offset, std::size_t length);
+
+    ~MemoryMappedFile();
+
+    /** \brief Returns the address of the first mapped byte of the file (at the requested offset). */
+    void *GetData() const { return m_Data; }
+
+    /** \brief Returns the number of mapped bytes, starting at GetData(). */
+    std::size_t GetLength() const { return m_Length; }
+
+    const std::string &GetFileName() const { return m_FileName; }
+
+    /**
+     * \brief Image readers map the data of uncompressed files instead of reading it completely, if the image data is
+     * at least this large (default: 64 MiB).
+     */
+    static std::size_t GetReaderThreshold();
+    static void SetReaderThreshold(std::size_t numberOfBytes);
+
+    /**
+     * \brief Removes the given file from its directory if it is mapped, so that it can be written anew without
+     * invalidating data that is still in use.
+     *
+     * Must be called before a file is overwritten which might be mapped, e.g. when an image is saved to the file it
+     * was loaded from. The existing mappings keep referring to the removed file, so their data is neither copied nor
+     * changed and may be read and written concurrently.
+     *
+     * \throws mitk::Exception if the file is mapped and cannot be removed, and always on Windows if the file is
+     * mapped, since it cannot be written while a view of it exists.
+     */
+    static void DetachFromFile(const std::string &fileName);
+
+  private:
+    MemoryMappedFile(const MemoryMappedFile &) = delete;
+    MemoryMappedFile &operator=(const MemoryMappedFile &) = delete;
+
+    std::string m_FileName;
+
+    void *m_Data;
+    std::size_t m_Length;
+
+    /** The mapping itself starts at an aligned offset, which can be in front of m_Data */
+    void *m_MappingBegin;
+    std::size_t m_MappingLength;
+
+    /** Identifies the mapped file independently of the path it was opened with */
+    unsigned long long m_FileDevice;
+    unsigned long long m_FileIndex;
+
+#ifdef _WIN32
+    void *m_FileHandle;
+    void *m_MappingHandle;
+#endif
+  };
+}
+
+#endif
@@ -43,6 +43,13 @@ namespace mitk
 
     OperationType GetOperationType();
 
+    //##Documentation
+    //## @brief Returns the approximate number of bytes the operation occupies.
+    //##
+    //## Used to limit the memory of the undo history, see LimitedLinearUndo::SetMemoryLimit().
+    //## Operations that keep large data, e.g. image slices, should override this.
+    virtual std::size_t GetMemorySize() const;
+
   protected:
     OperationType m_OperationType;
   };
@@ -78,6 +78,10 @@ namespace mitk
     virtual void ReverseOperations();
     virtual void ReverseAndExecute();
 
+    //##Documentation
+    //## @brief Returns the approximate number of bytes the item occupies on the undo or redo stack
+    virtual std::size_t GetMemorySize() const;
+
     //##Documentation
     //## @brief Increases the current ObjectEventId
     //## For example if a button click generates operations the ObjectEventId has to be incremented to be able to undo
@@ -174,6 +178,9 @@ namespace mitk
     //## and false if it already has been deleted
     virtual bool IsValid();
 
+    //## @brief Returns the memory of the item including both operations
+    std::size_t GetMemorySize() const override;
+
   protected:
     void OnObjectDeleted();
 
@@ -0,0 +1,110 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKRUNINPARALLEL_H
+#define MITKRUNINPARALLEL_H
+
+#include <itkMultiThreader.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * @brief Default number of threads for algorithms that use RunInParallel().
+   *
+   * Follows the global default of ITK, so that the thread count of MITK algorithms can be limited
+   * together with the one of ITK filters (e.g. via the environment variable ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS).
+   */
+  inline unsigned int GetDefaultNumberOfThreads()
+  {
+    return std::max(1u, static_cast<unsigned int>(itk::MultiThreader::GetGlobalDefaultNumberOfThreads()));
+  }
+
+  /**
+   * @brief Number of threads RunInParallel() uses for the given number of threads and tasks.
+   *
+   * Useful to size per-thread results before the call.
+   */
+  inline std::size_t GetNumberOfParallelThreads(unsigned int numberOfThreads, std::size_t numberOfTasks)
+  {
+    return std::max<std::size_t>(1, std::min<std::size_t>(numberOfThreads, numberOfTasks));
+  }
+
+  /**
+   * @brief Runs task(taskId, threadId) for all taskId < numberOfTasks on at most numberOfThreads threads.
+   *
+   * Tasks are handed out dynamically in increasing order, so each thread processes its tasks in
+   * increasing order as well. threadId is smaller than GetNumberOfParallelThreads(numberOfThreads,
+   * numberOfTasks) and can be used to index per-thread results; thread 0 is the calling thread.
+   * The first exception thrown by a task stops the distribution of further tasks and is rethrown
+   * after all threads have finished.
+   *
+   * Threads are started for every call, so tasks should be coarse enough to amortize that.
+   */
+  template <typename TFunction>
+  void RunInParallel(unsigned int numberOfThreads, std::size_t numberOfTasks, const TFunction &task)
+  {
+    const std::size_t threadCount = GetNumberOfParallelThreads(numberOfThreads, numberOfTasks);
+
+    std::atomic<std::size_t> nextTask(0);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto worker = [&](std::size_t threadId) {
+      try
+      {
+        for (std::size_t taskId = nextTask++; taskId < numberOfTasks; taskId = nextTask++)
+        {
+          task(taskId, threadId);
+        }
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error)
+        {
+          error = std::current_exception();
+        }
+        nextTask = numberOfTasks;
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t threadId = 1; threadId < threadCount; ++threadId)
+    {
+      threads.emplace_back(worker, threadId);
+    }
+    worker(0);
+
+    for (auto &thread : threads)
+    {
+      thread.join();
+    }
+
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+#endif
@@ -120,7 +120,23 @@ namespace mitk
     //## especially to retrieve text descriptions of the undo/redo stack
     static UndoModel *GetCurrentUndoModel();
 
+    //##Documentation
+    //## @brief Gets the limit on the memory of the undo history in bytes, 0 means no limit
+    static std::size_t GetMemoryLimit();
+
+    //##Documentation
+    //## @brief Sets a limit on the memory of the undo history in bytes, 0 means no limit
+    //##
+    //## The limit is applied to all UndoModels, including the ones added later,
+    //## see LimitedLinearUndo::SetMemoryLimit().
+    static void SetMemoryLimit(std::size_t memoryLimit);
+
   private:
+    //##Documentation
+    //## applies m_MemoryLimit to an UndoModel that supports it
+    static void ApplyMemoryLimit(UndoModel *undoModel);
+
+
     //##Documentation
     //## current selected UndoModel
     static UndoModel::Pointer m_CurUndoModel;
@@ -130,6 +146,9 @@ namespace mitk
     //##Documentation
     //## different UndoModels to select and activate
     static UndoModelMap m_UndoModelList;
+    //##Documentation
+    //## memory limit of all UndoModels in bytes
+    static std::size_t m_MemoryLimit;
   };
 } // namespace mitk
 
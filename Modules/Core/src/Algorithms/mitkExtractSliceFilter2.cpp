@@ -23,7 +23,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkLinearInterpolateImageFunction.h>
 #include <itkNearestNeighborInterpolateImageFunction.h>
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <type_traits>
 
 struct mitk::ExtractSliceFilter2::Impl
 {
@@ -78,8 +81,180 @@ namespace
     result = interpolateImageFunction.GetPointer();
   }
 
+  /** \brief Rounds half-integers up like itk::Math::RoundHalfIntegerUp, which ITK uses for inside checks. */
+  inline long RoundHalfIntegerUp(double value)
+  {
+    return static_cast<long>(std::floor(value + 0.5));
+  }
+
+  /** \brief Input volume as seen by the row kernels below.
+   *
+   * Continuous indices of output pixels are an affine function of the output pixel index. They are stepped
+   * along each row instead of transforming every output pixel from physical space, which saves a 3x3 matrix
+   * multiplication, a region check and a virtual interpolator call per pixel.
+   */
+  template <typename TPixel>
+  struct InputVolume
+  {
+    const TPixel* Buffer;
+    long Size[3];
+    std::size_t Stride[3];
+  };
+
+  template <typename TPixel>
+  void ExtractRowNearestNeighbor(const InputVolume<TPixel>& volume, const double* rowIndex, const double* step, std::size_t count, TPixel background, TPixel* output)
+  {
+    for (std::size_t x = 0; x < count; ++x)
+    {
+      const long i = RoundHalfIntegerUp(rowIndex[0] + step[0] * x);
+      const long j = RoundHalfIntegerUp(rowIndex[1] + step[1] * x);
+      const long k = RoundHalfIntegerUp(rowIndex[2] + step[2] * x);
+
+      const bool isInside = static_cast<unsigned long>(i) < static_cast<unsigned long>(volume.Size[0]) &&
+                            static_cast<unsigned long>(j) < static_cast<unsigned long>(volume.Size[1]) &&
+                            static_cast<unsigned long>(k) < static_cast<unsigned long>(volume.Size[2]);
+
+      output[x] = isInside
+        ? volume.Buffer[i * volume.Stride[0] + j * volume.Stride[1] + k * volume.Stride[2]]
+        : background;
+    }
+  }
+
+  template <typename TPixel>
+  void ExtractRowLinear(const InputVolume<TPixel>& volume, const double* rowIndex, const double* step, std::size_t count, TPixel background, TPixel* output)
+  {
+    std::size_t lower[3];
+    std::size_t upper[3];
+    double distance[3];
+
+    for (std::size_t x = 0; x < count; ++x)
+    {
+      bool isInside = true;
+
+      for (int d = 0; d < 3; ++d)
+      {
+        const double index = rowIndex[d] + step[d] * x;
+        isInside &= static_cast<unsigned long>(RoundHalfIntegerUp(index)) < static_cast<unsigned long>(volume.Size[d]);
+
+        // Neighbors outside of the volume are clamped to its border like itk::LinearInterpolateImageFunction does
+        const double base = std::floor(index);
+        const long baseIndex = static_cast<long>(base);
+        distance[d] = index - base;
+        lower[d] = static_cast<std::size_t>(std::max(baseIndex, 0L)) * volume.Stride[d];
+        upper[d] = static_cast<std::size_t>(std::min(baseIndex + 1, volume.Size[d] - 1)) * volume.Stride[d];
+      }
+
+      if (!isInside)
+      {
+        output[x] = background;
+        continue;
+      }
+
+      const TPixel* buffer = volume.Buffer;
+
+      auto interpolateAlongX = [&](std::size_t j, std::size_t k) {
+        const double value = buffer[lower[0] + j + k];
+        return value + distance[0] * (buffer[upper[0] + j + k] - value);
+      };
+
+      const double v00 = interpolateAlongX(lower[1], lower[2]);
+      const double v10 = interpolateAlongX(upper[1], lower[2]);
+      const double v01 = interpolateAlongX(lower[1], upper[2]);
+      const double v11 = interpolateAlongX(upper[1], upper[2]);
+
+      const double v0 = v00 + distance[1] * (v10 - v00);
+      const double v1 = v01 + distance[1] * (v11 - v01);
+
+      output[x] = static_cast<TPixel>(v0 + distance[2] * (v1 - v0));
+    }
+  }
+
+  /** \brief Extracts the slice without itk::InterpolateImageFunction, see InputVolume.
+   *
+   * \return false, if the fast path is not applicable. The input buffer must be complete, as continuous
+   * indices are relative to the largest possible region, and cubic interpolation needs B-spline coefficients.
+   */
   template <typename TPixel, unsigned int VImageDimension>
-  void GenerateData(const itk::Image<TPixel, VImageDimension>* inputImage, mitk::Image* outputImage, const mitk::ExtractSliceFilter2::OutputImageRegionType& outputRegion, itk::Object* interpolateImageFunction)
+  bool GenerateDataFast(const itk::Image<TPixel, VImageDimension>* inputImage, const mitk::Point3D& origin, const mitk::Vector3D& spacingAlongXDirection, const mitk::Vector3D& spacingAlongYDirection, const mitk::ExtractSliceFilter2::OutputImageRegionType& outputRegion, mitk::ExtractSliceFilter2::Interpolator interpolatorType, TPixel* data, std::size_t width, std::true_type)
+  {
+    auto inputRegion = inputImage->GetBufferedRegion();
+
+    if (mitk::ExtractSliceFilter2::Cubic == interpolatorType ||
+        inputRegion != inputImage->GetLargestPossibleRegion() ||
+        0 != inputRegion.GetIndex(0) || 0 != inputRegion.GetIndex(1) || 0 != inputRegion.GetIndex(2))
+    {
+      return false;
+    }
+
+    InputVolume<TPixel> volume;
+    volume.Buffer = inputImage->GetBufferPointer();
+    volume.Stride[0] = 1;
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      volume.Size[i] = static_cast<long>(inputRegion.GetSize(i));
+
+      if (i > 0)
+        volume.Stride[i] = volume.Stride[i - 1] * inputRegion.GetSize(i - 1);
+    }
+
+    const auto& physicalPointToIndex = inputImage->GetPhysicalPointToIndex();
+
+    itk::ContinuousIndex<mitk::ScalarType, 3> index;
+    inputImage->TransformPhysicalPointToContinuousIndex(origin, index);
+
+    double originIndex[3];
+    double xStep[3];
+    double yStep[3];
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      originIndex[i] = index[i];
+      xStep[i] = 0.0;
+      yStep[i] = 0.0;
+
+      for (unsigned int j = 0; j < 3; ++j)
+      {
+        xStep[i] += physicalPointToIndex[i][j] * spacingAlongXDirection[j];
+        yStep[i] += physicalPointToIndex[i][j] * spacingAlongYDirection[j];
+      }
+    }
+
+    const TPixel backgroundPixel = std::numeric_limits<TPixel>::lowest();
+    const std::size_t xBegin = outputRegion.GetIndex(0);
+    const std::size_t yBegin = outputRegion.GetIndex(1);
+    const std::size_t xEnd = xBegin + outputRegion.GetSize(0);
+    const std::size_t yEnd = yBegin + outputRegion.GetSize(1);
+
+    double rowIndex[3];
+
+    for (std::size_t y = yBegin; y < yEnd; ++y)
+    {
+      for (unsigned int i = 0; i < 3; ++i)
+        rowIndex[i] = originIndex[i] + yStep[i] * y + xStep[i] * xBegin;
+
+      if (mitk::ExtractSliceFilter2::NearestNeighbor == interpolatorType)
+      {
+        ExtractRowNearestNeighbor(volume, rowIndex, xStep, xEnd - xBegin, backgroundPixel, data + width * y + xBegin);
+      }
+      else
+      {
+        ExtractRowLinear(volume, rowIndex, xStep, xEnd - xBegin, backgroundPixel, data + width * y + xBegin);
+      }
+    }
+
+    return true;
+  }
+
+  /** \brief Composite pixel types like RGB always take the generic path. */
+  template <typename TPixel, unsigned int VImageDimension>
+  bool GenerateDataFast(const itk::Image<TPixel, VImageDimension>*, const mitk::Point3D&, const mitk::Vector3D&, const mitk::Vector3D&, const mitk::ExtractSliceFilter2::OutputImageRegionType&, mitk::ExtractSliceFilter2::Interpolator, TPixel*, std::size_t, std::false_type)
+  {
+    return false;
+  }
+
+  template <typename TPixel, unsigned int VImageDimension>
+  void GenerateData(const itk::Image<TPixel, VImageDimension>* inputImage, mitk::Image* outputImage, const mitk::ExtractSliceFilter2::OutputImageRegionType& outputRegion, itk::Object* interpolateImageFunction, mitk::ExtractSliceFilter2::Interpolator interpolatorType)
   {
     typedef itk::Image<TPixel, VImageDimension> TInputImage;
     typedef itk::InterpolateImageFunction<TInputImage> TInterpolateImageFunction;
@@ -108,6 +283,9 @@ namespace
     mitk::ImageWriteAccessor writeAccess(outputImage, nullptr, mitk::ImageAccessorBase::IgnoreLock);
     auto data = static_cast<char*>(writeAccess.GetData());
 
+    if (GenerateDataFast(inputImage, origin, spacingAlongXDirection, spacingAlongYDirection, outputRegion, interpolatorType, reinterpret_cast<TPixel*>(data), width, std::is_arithmetic<TPixel>()))
+      return;
+
     const TPixel backgroundPixel = std::numeric_limits<TPixel>::lowest();
     TPixel pixel;
 
@@ -217,17 +395,18 @@ void mitk::ExtractSliceFilter2::ThreadedGenerateData(const OutputImageRegionType
 
 void mitk::ExtractSliceFilter2::GenerateData()
 {
-  if (nullptr != m_Impl->InterpolateImageFunction && this->GetInput()->GetMTime() < this->GetMTime())
-    return;
-
   const auto* inputImage = this->GetInput();
 
-  AccessFixedDimensionByItk_2(inputImage, CreateInterpolateImageFunction, 3, this->GetInterpolator(), m_Impl->InterpolateImageFunction);
+  // Only the interpolate image function is reused as long as the input is unchanged, the output geometry may differ
+  if (nullptr == m_Impl->InterpolateImageFunction || inputImage->GetMTime() > m_Impl->InterpolateImageFunction->GetMTime())
+  {
+    AccessFixedDimensionByItk_2(inputImage, CreateInterpolateImageFunction, 3, this->GetInterpolator(), m_Impl->InterpolateImageFunction);
+  }
 
   this->AllocateOutputs();
   auto outputRegion = this->GetOutput()->GetLargestPossibleRegion();
 
-  AccessFixedDimensionByItk_3(inputImage, ::GenerateData, 3, this->GetOutput(), outputRegion, m_Impl->InterpolateImageFunction);
+  AccessFixedDimensionByItk_n(inputImage, ::GenerateData, 3, (this->GetOutput(), outputRegion, m_Impl->InterpolateImageFunction, this->GetInterpolator()));
 }
 
 void mitk::ExtractSliceFilter2::SetInput(const InputImageType* image)
@@ -60,16 +60,20 @@ void mitk::ImageToSurfaceFilter::CreateSurface(int time,
   indexCoordinatesImageFilter->Delete();
   skinExtractor->SetValue(0, threshold);
 
-  vtkPolyData *polydata;
   skinExtractor->Update();
-  polydata = skinExtractor->GetOutput();
+
+  this->ProcessSurface(time, skinExtractor->GetOutput(), surface);
+}
+
+void mitk::ImageToSurfaceFilter::ProcessSurface(int time, vtkPolyData *polydata, mitk::Surface *surface)
+{
   polydata->Register(nullptr); // RC++
 
   if (m_Smooth)
   {
     vtkSmoothPolyDataFilter *smoother = vtkSmoothPolyDataFilter::New();
     // read poly1 (poly1 can be the original polygon, or the decimated polygon)
-    smoother->SetInputConnection(skinExtractor->GetOutputPort()); // RC++
+    smoother->SetInputData(polydata); // RC++
     smoother->SetNumberOfIterations(m_SmoothIteration);
     smoother->SetRelaxationFactor(m_SmoothRelaxation);
     smoother->SetFeatureAngle(60);
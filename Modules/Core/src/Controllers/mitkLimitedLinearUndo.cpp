@@ -18,7 +18,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkRenderingManager.h>
 
 mitk::LimitedLinearUndo::LimitedLinearUndo()
-: m_UndoLimit(0)
+: m_UndoLimit(0), m_MemoryLimit(0)
 {
   // nothing to do
 }
@@ -53,17 +53,45 @@ bool mitk::LimitedLinearUndo::SetOperationEvent(UndoStackItem *stackItem)
     InvokeEvent(RedoEmptyEvent());
   }
 
+  this->PushUndoItem(operationEvent);
+
+  InvokeEvent(UndoNotEmptyEvent());
+
+  return true;
+}
+
+void mitk::LimitedLinearUndo::PushUndoItem(UndoStackItem *item)
+{
   if (0 != m_UndoLimit && m_UndoList.size() == m_UndoLimit)
   {
-    auto item = m_UndoList.front();
+    auto oldestItem = m_UndoList.front();
     m_UndoList.pop_front();
-    delete item;
+    delete oldestItem;
   }
-  m_UndoList.push_back(operationEvent);
+  m_UndoList.push_back(item);
 
-  InvokeEvent(UndoNotEmptyEvent());
+  this->EnforceMemoryLimit();
+}
 
-  return true;
+void mitk::LimitedLinearUndo::EnforceMemoryLimit()
+{
+  if (0 == m_MemoryLimit)
+    return;
+
+  // whole groups are dropped, a partially dropped group could not be undone any more
+  std::size_t memorySize = this->GetMemorySize();
+  while (memorySize > m_MemoryLimit && !m_UndoList.empty() &&
+         m_UndoList.front()->GetGroupEventId() != m_UndoList.back()->GetGroupEventId())
+  {
+    int oldestGroupEventId = m_UndoList.front()->GetGroupEventId();
+    do
+    {
+      auto oldestItem = m_UndoList.front();
+      m_UndoList.pop_front();
+      memorySize -= oldestItem->GetMemorySize();
+      delete oldestItem;
+    } while (m_UndoList.front()->GetGroupEventId() == oldestGroupEventId);
+  }
 }
 
 bool mitk::LimitedLinearUndo::Undo(bool fine)
@@ -186,14 +214,44 @@ void mitk::LimitedLinearUndo::SetUndoLimit(std::size_t undoLimit)
 {
   if (undoLimit != m_UndoLimit)
   {
-    if (m_UndoList.size() > undoLimit)
+    if (0 != undoLimit && m_UndoList.size() > undoLimit)
     {
+      for (auto iter = m_UndoList.begin(); iter != m_UndoList.end() - undoLimit; ++iter)
+        delete *iter;
+
       m_UndoList.erase(m_UndoList.begin(), m_UndoList.end() - undoLimit);
     }
     m_UndoLimit = undoLimit;
   }
 }
 
+std::size_t mitk::LimitedLinearUndo::GetMemoryLimit() const
+{
+  return m_MemoryLimit;
+}
+
+void mitk::LimitedLinearUndo::SetMemoryLimit(std::size_t memoryLimit)
+{
+  if (memoryLimit != m_MemoryLimit)
+  {
+    m_MemoryLimit = memoryLimit;
+    this->EnforceMemoryLimit();
+  }
+}
+
+std::size_t mitk::LimitedLinearUndo::GetMemorySize() const
+{
+  std::size_t memorySize = 0;
+
+  for (auto item : m_UndoList)
+    memorySize += item->GetMemorySize();
+
+  for (auto item : m_RedoList)
+    memorySize += item->GetMemorySize();
+
+  return memorySize;
+}
+
 int mitk::LimitedLinearUndo::GetLastObjectEventIdInList()
 {
   return m_UndoList.back()->GetObjectEventId();
@@ -76,6 +76,11 @@ void mitk::UndoStackItem::ReverseAndExecute()
   ReverseOperations();
 }
 
+std::size_t mitk::UndoStackItem::GetMemorySize() const
+{
+  return sizeof(UndoStackItem) + m_Description.capacity();
+}
+
 // ******************** mitk::OperationEvent ********************
 
 mitk::Operation *mitk::OperationEvent::GetOperation()
@@ -152,3 +157,16 @@ bool mitk::OperationEvent::IsValid()
 {
   return !m_Invalid;
 }
+
+std::size_t mitk::OperationEvent::GetMemorySize() const
+{
+  std::size_t memorySize = UndoStackItem::GetMemorySize() + sizeof(OperationEvent) - sizeof(UndoStackItem);
+
+  if (m_Operation != nullptr)
+    memorySize += m_Operation->GetMemorySize();
+
+  if (m_UndoOperation != nullptr)
+    memorySize += m_UndoOperation->GetMemorySize();
+
+  return memorySize;
+}
@@ -24,6 +24,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 mitk::UndoModel::Pointer mitk::UndoController::m_CurUndoModel;
 mitk::UndoController::UndoModelMap mitk::UndoController::m_UndoModelList;
 mitk::UndoController::UndoType mitk::UndoController::m_CurUndoType;
+std::size_t mitk::UndoController::m_MemoryLimit = 0;
 
 // const mitk::UndoController::UndoType mitk::UndoController::DEFAULTUNDOMODEL = LIMITEDLINEARUNDO;
 const mitk::UndoController::UndoType mitk::UndoController::DEFAULTUNDOMODEL = VERBOSE_LIMITEDLINEARUNDO;
@@ -52,6 +53,7 @@ mitk::UndoController::UndoController(UndoType undoType)
         m_CurUndoType = undoType;
         m_UndoModelList.insert(UndoModelMap::value_type(undoType, m_CurUndoModel));
     }
+    ApplyMemoryLimit(m_CurUndoModel);
   }
 }
 
@@ -157,6 +159,7 @@ bool mitk::UndoController::AddUndoModel(UndoType undoType)
       // that undoType is not implemented!
       return false;
   }
+  ApplyMemoryLimit(m_CurUndoModel);
   return true;
 }
 
@@ -215,3 +218,23 @@ mitk::UndoModel *mitk::UndoController::GetCurrentUndoModel()
 {
   return m_CurUndoModel;
 }
+
+std::size_t mitk::UndoController::GetMemoryLimit()
+{
+  return m_MemoryLimit;
+}
+
+void mitk::UndoController::SetMemoryLimit(std::size_t memoryLimit)
+{
+  m_MemoryLimit = memoryLimit;
+
+  for (const auto &undoModel : m_UndoModelList)
+    ApplyMemoryLimit(undoModel.second);
+}
+
+void mitk::UndoController::ApplyMemoryLimit(UndoModel *undoModel)
+{
+  // only the linear undo models know the memory of their items
+  if (auto *limitedLinearUndo = dynamic_cast<LimitedLinearUndo *>(undoModel))
+    limitedLinearUndo->SetMemoryLimit(m_MemoryLimit);
+}
@@ -20,6 +20,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageStatisticsHolder.h"
 #include "mitkImageVtkReadAccessor.h"
 #include "mitkImageVtkWriteAccessor.h"
+#include "mitkImageWriteAccessor.h"
 #include "mitkPixelTypeMultiplex.h"
 #include <mitkProportionalTimeGeometry.h>
 
@@ -30,6 +31,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkMutexLockHolder.h>
 
 // Other
+#include <algorithm>
 #include <cmath>
 
 #define FILL_C_ARRAY(_arr, _size, _value)                                                                              \
@@ -45,11 +47,23 @@ mitk::Image::Image()
     m_ImageDescriptor(nullptr),
     m_OffsetTable(nullptr),
     m_CompleteData(nullptr),
-    m_ImageStatistics(nullptr)
+    m_ImageStatistics(nullptr),
+    m_PendingWriterCount(0),
+    m_WriteAccessCount(0),
+    m_TimeStepMemoryBudget(0),
+    m_ResidentVolumeBytes(0),
+    m_TimeStepCacheStatistics()
 {
   m_Dimensions = new unsigned int[MAX_IMAGE_DIMENSIONS];
   FILL_C_ARRAY(m_Dimensions, MAX_IMAGE_DIMENSIONS, 0u);
 
+  for (auto &slot : m_FastPathReaders)
+  {
+    slot.m_Reader = nullptr;
+    slot.m_AddressBegin = nullptr;
+    slot.m_AddressEnd = nullptr;
+  }
+
   m_Initialized = false;
 }
 
@@ -60,11 +74,23 @@ mitk::Image::Image(const Image &other)
     m_ImageDescriptor(nullptr),
     m_OffsetTable(nullptr),
     m_CompleteData(nullptr),
-    m_ImageStatistics(nullptr)
+    m_ImageStatistics(nullptr),
+    m_PendingWriterCount(0),
+    m_WriteAccessCount(0),
+    m_TimeStepMemoryBudget(0),
+    m_ResidentVolumeBytes(0),
+    m_TimeStepCacheStatistics()
 {
   m_Dimensions = new unsigned int[MAX_IMAGE_DIMENSIONS];
   FILL_C_ARRAY(m_Dimensions, MAX_IMAGE_DIMENSIONS, 0u);
 
+  for (auto &slot : m_FastPathReaders)
+  {
+    slot.m_Reader = nullptr;
+    slot.m_AddressBegin = nullptr;
+    slot.m_AddressEnd = nullptr;
+  }
+
   this->Initialize(other.GetPixelType(), other.GetDimension(), other.GetDimensions());
 
   // Since the above called "Initialize" method doesn't take the geometry into account we need to set it
@@ -247,8 +273,13 @@ const vtkImageData *mitk::Image::GetVtkImageData(int t, int n) const
 mitk::Image::ImageDataItemPointer mitk::Image::GetSliceData(
   int s, int t, int n, void *data, ImportMemoryManagementType importMemoryManagement) const
 {
-  MutexHolder lock(m_ImageDataArraysLock);
-  return GetSliceData_unlocked(s, t, n, data, importMemoryManagement);
+  ImageDataItemPointer sl;
+  {
+    MutexHolder lock(m_ImageDataArraysLock);
+    sl = GetSliceData_unlocked(s, t, n, data, importMemoryManagement);
+  }
+  EvictTimeSteps();
+  return sl;
 }
 
 mitk::Image::ImageDataItemPointer mitk::Image::GetSliceData_unlocked(
@@ -266,6 +297,12 @@ mitk::Image::ImageDataItemPointer mitk::Image::GetSliceData_unlocked(
     return m_Slices[pos];
   }
 
+  // is slice available as part of a volume that has been swapped out?
+  if (IsVolumeSwappedOut_unlocked(GetVolumeIndex(t, n)))
+  {
+    RestoreVolume_unlocked(t, n);
+  }
+
   // is slice available as part of a volume that is available?
   ImageDataItemPointer sl, ch, vol;
   vol = m_Volumes[GetVolumeIndex(t, n)];
@@ -332,8 +369,13 @@ mitk::Image::ImageDataItemPointer mitk::Image::GetVolumeData(int t,
                                                              void *data,
                                                              ImportMemoryManagementType importMemoryManagement) const
 {
-  MutexHolder lock(m_ImageDataArraysLock);
-  return GetVolumeData_unlocked(t, n, data, importMemoryManagement);
+  ImageDataItemPointer vol;
+  {
+    MutexHolder lock(m_ImageDataArraysLock);
+    vol = GetVolumeData_unlocked(t, n, data, importMemoryManagement);
+  }
+  EvictTimeSteps();
+  return vol;
 }
 mitk::Image::ImageDataItemPointer mitk::Image::GetVolumeData_unlocked(
   int t, int n, void *data, ImportMemoryManagementType importMemoryManagement) const
@@ -347,7 +389,18 @@ mitk::Image::ImageDataItemPointer mitk::Image::GetVolumeData_unlocked(
   int pos = GetVolumeIndex(t, n);
   vol = m_Volumes[pos];
   if ((vol.GetPointer() != nullptr) && (vol->IsComplete()))
+  {
+    if (m_TimeStepSwapStorage.IsNotNull())
+    {
+      TouchVolume_unlocked(pos);
+      ++m_TimeStepCacheStatistics.m_Hits;
+    }
     return vol;
+  }
+
+  // volume available in the swap storage?
+  if (IsVolumeSwappedOut_unlocked(pos))
+    return RestoreVolume_unlocked(t, n);
 
   const size_t ptypeSize = this->m_ImageDescriptor->GetChannelTypeById(n).GetSize();
 
@@ -573,6 +626,16 @@ mitk::Image::ImageDataItemPointer mitk::Image::GetChannelData_unlocked(
   }
 }
 
+bool mitk::Image::HasFastPathReader(const void *begin, const void *end) const
+{
+  for (const auto &slot : m_FastPathReaders)
+  {
+    if (slot.m_Reader != nullptr && slot.m_AddressBegin.load() < end && begin < slot.m_AddressEnd.load())
+      return true;
+  }
+  return false;
+}
+
 bool mitk::Image::IsSliceSet(int s, int t, int n) const
 {
   MutexHolder lock(m_ImageDataArraysLock);
@@ -595,6 +658,10 @@ bool mitk::Image::IsSliceSet_unlocked(int s, int t, int n) const
   {
     return true;
   }
+  if (IsVolumeSwappedOut_unlocked(GetVolumeIndex(t, n)))
+  {
+    return true;
+  }
   ch = m_Channels[n];
   if ((ch.GetPointer() != nullptr) && (ch->IsComplete()))
   {
@@ -620,6 +687,10 @@ bool mitk::Image::IsVolumeSet_unlocked(int t, int n) const
   if ((vol.GetPointer() != nullptr) && (vol->IsComplete()))
     return true;
 
+  // volume available in the swap storage?
+  if (IsVolumeSwappedOut_unlocked(GetVolumeIndex(t, n)))
+    return true;
+
   // is volume available as part of a channel that is available?
   ch = m_Channels[n];
   if ((ch.GetPointer() != nullptr) && (ch->IsComplete()))
@@ -804,6 +875,48 @@ bool mitk::Image::SetImportChannel(void *data, int n, ImportMemoryManagementType
   return true;
 }
 
+bool mitk::Image::SetMappedChannel(MemoryMappedFile::Pointer mappedFile, int n)
+{
+  if (IsValidChannel(n) == false || mappedFile == nullptr)
+    return false;
+
+  const size_t ptypeSize = this->m_ImageDescriptor->GetChannelTypeById(n).GetSize();
+  if (mappedFile->GetLength() < m_OffsetTable[4] * ptypeSize)
+  {
+    MITK_ERROR << "Memory mapped part of " << mappedFile->GetFileName() << " is smaller than an image channel.";
+    return false;
+  }
+
+  ImageDataItemPointer ch = new ImageDataItem(this->m_ImageDescriptor, -1, mappedFile);
+  ch->SetComplete(true);
+
+  bool replaced = false;
+  {
+    MutexHolder lock(m_ImageDataArraysLock);
+
+    replaced = m_Channels[n].GetPointer() != nullptr;
+
+    // Slices and volumes of a former channel reference its memory, they are recreated on demand
+    for (unsigned int t = 0; t < GetDimension(3); ++t)
+    {
+      m_Volumes[GetVolumeIndex(t, n)] = nullptr;
+      for (unsigned int s = 0; s < GetDimension(2); ++s)
+      {
+        m_Slices[GetSliceIndex(s, t, n)] = nullptr;
+      }
+    }
+
+    m_Channels[n] = ch;
+    this->m_ImageDescriptor->GetChannelDescriptor(n).SetData(ch->GetData());
+  }
+
+  // as in SetImportChannel, only the replacement of existing data is regarded as modification
+  if (replaced)
+    Modified();
+
+  return true;
+}
+
 void mitk::Image::Initialize()
 {
   ImageDataItemPointerArray::iterator it, end;
@@ -821,6 +934,9 @@ void mitk::Image::Initialize()
   }
   m_CompleteData = nullptr;
 
+  // data of the former layout is gone
+  ResetTimeStepCache_unlocked();
+
   if (m_ImageStatistics == nullptr)
   {
     m_ImageStatistics = new mitk::ImageStatisticsHolder(this);
@@ -1185,6 +1301,12 @@ mitk::Image::ImageDataItemPointer mitk::Image::AllocateSliceData_unlocked(
 
   const size_t ptypeSize = this->m_ImageDescriptor->GetChannelTypeById(n).GetSize();
 
+  // is slice available as part of a volume that has been swapped out?
+  if (IsVolumeSwappedOut_unlocked(GetVolumeIndex(t, n)))
+  {
+    RestoreVolume_unlocked(t, n);
+  }
+
   // is slice available as part of a volume that is available?
   ImageDataItemPointer sl, ch, vol;
   vol = m_Volumes[GetVolumeIndex(t, n)];
@@ -1248,6 +1370,14 @@ mitk::Image::ImageDataItemPointer mitk::Image::AllocateVolumeData_unlocked(
   int pos;
   pos = GetVolumeIndex(t, n);
 
+  // a newly allocated volume replaces swapped out data
+  if (IsVolumeSwappedOut_unlocked(pos))
+  {
+    std::lock_guard<std::mutex> storageLock(m_TimeStepSwapStorageMutex);
+    m_TimeStepSwapStorage->Discard(t, n);
+    m_SwappedOutVolumes[pos] = false;
+  }
+
   const size_t ptypeSize = this->m_ImageDescriptor->GetChannelTypeById(n).GetSize();
 
   // is volume available as part of a channel that is available?
@@ -1279,6 +1409,8 @@ mitk::Image::ImageDataItemPointer mitk::Image::AllocateVolumeData_unlocked(
     vol = new ImageDataItem(chPixelType, t, 3, m_Dimensions, data, importMemoryManagement == ManageMemory);
   }
   m_Volumes[pos] = vol;
+  if (m_TimeStepSwapStorage.IsNotNull())
+    TouchVolume_unlocked(pos);
   return vol;
 }
 
@@ -1310,6 +1442,376 @@ mitk::Image::ImageDataItemPointer mitk::Image::AllocateChannelData_unlocked(
   return ch;
 }
 
+void mitk::Image::SetTimeStepSwapStorage(ImageTimeStepSwapStorage *storage)
+{
+  if (m_TimeStepSwapStorage.GetPointer() == storage)
+    return;
+
+  // bring back everything held by the former storage
+  if (m_TimeStepSwapStorage.IsNotNull())
+  {
+    MutexHolder lock(m_ImageDataArraysLock);
+    for (unsigned int n = 0; n < GetNumberOfChannels(); ++n)
+    {
+      for (unsigned int t = 0; t < m_Dimensions[3]; ++t)
+      {
+        if (IsVolumeSwappedOut_unlocked(GetVolumeIndex(t, n)))
+          RestoreVolume_unlocked(t, n);
+      }
+    }
+  }
+
+  {
+    MutexHolder lock(m_ImageDataArraysLock);
+    ResetTimeStepCache_unlocked();
+    m_TimeStepSwapStorage = storage;
+    m_TimeStepCacheStatistics = TimeStepCacheStatistics();
+  }
+
+  if (m_TimeStepSwapStorage.IsNotNull())
+  {
+    SplitChannelsIntoVolumes();
+
+    // the volumes that already exist are the least recently used ones
+    {
+      MutexHolder lock(m_ImageDataArraysLock);
+      for (unsigned int pos = 0; pos < m_Volumes.size(); ++pos)
+        TouchVolume_unlocked(pos);
+    }
+
+    EvictTimeSteps();
+  }
+}
+
+mitk::ImageTimeStepSwapStorage *mitk::Image::GetTimeStepSwapStorage() const
+{
+  return m_TimeStepSwapStorage.GetPointer();
+}
+
+void mitk::Image::SetTimeStepMemoryBudget(size_t numberOfBytes)
+{
+  m_TimeStepMemoryBudget = numberOfBytes;
+  EvictTimeSteps();
+}
+
+size_t mitk::Image::GetTimeStepMemoryBudget() const
+{
+  return m_TimeStepMemoryBudget;
+}
+
+mitk::Image::TimeStepCacheStatistics mitk::Image::GetTimeStepCacheStatistics() const
+{
+  MutexHolder lock(m_ImageDataArraysLock);
+
+  TimeStepCacheStatistics statistics = m_TimeStepCacheStatistics;
+  statistics.m_ResidentBytes = 0;
+  for (unsigned int pos = 0; pos < m_Volumes.size(); ++pos)
+  {
+    const ImageDataItem *vol = m_Volumes[pos].GetPointer();
+    if (vol != nullptr && vol->IsComplete() && vol->GetParent().IsNull() && vol->GetManageMemory())
+      statistics.m_ResidentBytes += vol->GetSize();
+  }
+  return statistics;
+}
+
+bool mitk::Image::IsVolumeSwappedOut_unlocked(int pos) const
+{
+  return m_TimeStepSwapStorage.IsNotNull() && pos >= 0 && static_cast<size_t>(pos) < m_SwappedOutVolumes.size() &&
+         m_SwappedOutVolumes[pos];
+}
+
+mitk::Image::ImageDataItemPointer mitk::Image::RestoreVolume_unlocked(int t, int n) const
+{
+  const int pos = GetVolumeIndex(t, n);
+
+  ImageDataItemPointer vol =
+    new ImageDataItem(this->m_ImageDescriptor->GetChannelTypeById(n), t, 3, m_Dimensions, nullptr, true);
+  {
+    std::lock_guard<std::mutex> storageLock(m_TimeStepSwapStorageMutex);
+    if (!m_TimeStepSwapStorage->Restore(t, n, vol->GetData(), vol->GetSize()))
+    {
+      mitkThrow() << "Time step " << t << " of channel " << n << " could not be restored from the swap storage.";
+    }
+  }
+  vol->SetComplete(true);
+
+  m_Volumes[pos] = vol;
+  m_SwappedOutVolumes[pos] = false;
+  TouchVolume_unlocked(pos);
+  ++m_TimeStepCacheStatistics.m_Misses;
+
+  return vol;
+}
+
+void mitk::Image::TouchVolume_unlocked(int pos) const
+{
+  if (static_cast<size_t>(pos) >= m_ResidentVolumeEntries.size())
+    return;
+
+  const ImageDataItem *vol = m_Volumes[pos].GetPointer();
+  auto &entry = m_ResidentVolumeEntries[pos];
+  if (entry != m_ResidentVolumes.end() && entry->m_Item == vol)
+  {
+    m_ResidentVolumes.splice(m_ResidentVolumes.end(), m_ResidentVolumes, entry);
+    return;
+  }
+
+  // the volume was replaced since it was listed
+  ForgetResidentVolume_unlocked(pos);
+
+  // volumes sharing the memory of a channel or foreign memory do not occupy memory of their own
+  if (vol == nullptr || vol->GetParent().IsNotNull() || !vol->GetManageMemory())
+    return;
+
+  ResidentVolume residentVolume = {pos, vol, vol->GetSize()};
+  entry = m_ResidentVolumes.insert(m_ResidentVolumes.end(), residentVolume);
+  m_ResidentVolumeBytes += residentVolume.m_Size;
+}
+
+void mitk::Image::ForgetResidentVolume_unlocked(int pos) const
+{
+  auto &entry = m_ResidentVolumeEntries[pos];
+  if (entry == m_ResidentVolumes.end())
+    return;
+
+  m_ResidentVolumeBytes -= entry->m_Size;
+  m_ResidentVolumes.erase(entry);
+  entry = m_ResidentVolumes.end();
+}
+
+void mitk::Image::ResetTimeStepCache_unlocked() const
+{
+  m_SwappedOutVolumes.assign(m_Volumes.size(), false);
+  m_ResidentVolumes.clear();
+  m_ResidentVolumeEntries.assign(m_Volumes.size(), m_ResidentVolumes.end());
+  m_ResidentVolumeBytes = 0;
+
+  if (m_TimeStepSwapStorage.IsNotNull())
+  {
+    std::lock_guard<std::mutex> storageLock(m_TimeStepSwapStorageMutex);
+    m_TimeStepSwapStorage->DiscardAll();
+  }
+}
+
+bool mitk::Image::IsVolumeEvictable_unlocked(int pos) const
+{
+  const ImageDataItem *vol = m_Volumes[pos].GetPointer();
+
+  // volumes sharing the memory of a channel or foreign memory cannot be evicted
+  if (vol == nullptr || !vol->IsComplete() || vol->GetParent().IsNotNull() || !vol->GetManageMemory())
+    return false;
+
+  // vtk pipelines keep references to the vtkImageData of the volume
+  if (vol->m_VtkImageData != nullptr && vol->m_VtkImageData->GetReferenceCount() > 1)
+    return false;
+
+  // besides m_Volumes, only slices held by m_Slices may reference the volume
+  int references = 1;
+  const int t = pos % m_Dimensions[3];
+  const int n = pos / m_Dimensions[3];
+  for (unsigned int s = 0; s < m_Dimensions[2]; ++s)
+  {
+    const ImageDataItem *sl = m_Slices[GetSliceIndex(s, t, n)].GetPointer();
+    if (sl != nullptr && sl->GetParent().GetPointer() == vol)
+    {
+      if (sl->GetReferenceCount() > 1 ||
+          (sl->m_VtkImageData != nullptr && sl->m_VtkImageData->GetReferenceCount() > 1))
+        return false;
+      ++references;
+    }
+  }
+
+  return vol->GetReferenceCount() == references;
+}
+
+bool mitk::Image::HasAccessor(const void *begin, const void *end) const
+{
+  for (const std::vector<ImageAccessorBase *> *accessors : {&m_Readers, &m_Writers})
+  {
+    for (const ImageAccessorBase *accessor : *accessors)
+    {
+      if (accessor->m_AddressBegin < end && begin < accessor->m_AddressEnd)
+        return true;
+    }
+  }
+
+  return HasFastPathReader(begin, end);
+}
+
+int mitk::Image::FindEvictionCandidate_unlocked(const std::vector<bool> &skipped) const
+{
+  auto iter = m_ResidentVolumes.begin();
+  while (iter != m_ResidentVolumes.end())
+  {
+    const int pos = iter->m_Position;
+    ++iter;
+
+    // drop volumes that were replaced or released since they were listed
+    if (m_Volumes[pos].GetPointer() != m_ResidentVolumeEntries[pos]->m_Item)
+    {
+      ForgetResidentVolume_unlocked(pos);
+      continue;
+    }
+
+    if (skipped[pos] || !IsVolumeEvictable_unlocked(pos))
+      continue;
+
+    const ImageDataItem *vol = m_Volumes[pos].GetPointer();
+    if (!HasAccessor(vol->m_Data, vol->m_Data + vol->GetSize()))
+      return pos;
+  }
+
+  return -1;
+}
+
+void mitk::Image::EvictTimeSteps() const
+{
+  // called after every access, so return right away as long as the budget is met
+  if (m_TimeStepSwapStorage.IsNull() || m_TimeStepMemoryBudget == 0 ||
+      m_ResidentVolumeBytes <= m_TimeStepMemoryBudget || this->GetReferenceCount() < 1)
+    return;
+
+  std::unique_lock<std::mutex> evictionLock(m_EvictionMutex, std::try_to_lock);
+  if (!evictionLock.owns_lock())
+    return;
+
+  // volumes that were written while they were stored are skipped in this round
+  std::vector<bool> skipped;
+
+  while (m_ResidentVolumeBytes > m_TimeStepMemoryBudget)
+  {
+    int candidate = -1;
+    ImageDataItemPointer vol;
+    unsigned long writeAccessCount = 0;
+    {
+      // accessors lock the data arrays while holding the accessor lock
+      MutexHolder accessorLock(m_ReadWriteLock);
+      MutexHolder lock(m_ImageDataArraysLock);
+      skipped.resize(m_Volumes.size(), false);
+
+      candidate = FindEvictionCandidate_unlocked(skipped);
+      if (candidate < 0)
+        return;
+
+      vol = m_Volumes[candidate];
+      writeAccessCount = m_WriteAccessCount;
+    }
+
+    const int t = candidate % m_Dimensions[3];
+    const int n = candidate / m_Dimensions[3];
+    skipped[candidate] = true;
+
+    // The volume may still be read while it is stored, which can take a while if the storage compresses it
+    try
+    {
+      std::lock_guard<std::mutex> storageLock(m_TimeStepSwapStorageMutex);
+      m_TimeStepSwapStorage->Store(t, n, vol->m_Data, vol->GetSize());
+    }
+    catch (const mitk::Exception &e)
+    {
+      MITK_ERROR << "Time step " << t << " of channel " << n << " could not be evicted: " << e.GetDescription();
+      return;
+    }
+
+    MutexHolder accessorLock(m_ReadWriteLock);
+    MutexHolder lock(m_ImageDataArraysLock);
+
+    // only swap the stored copy in if nobody got hold of the volume in the meantime
+    const bool replaced = m_Volumes[candidate] != vol;
+    vol = nullptr;
+    const ImageDataItem *item = m_Volumes[candidate].GetPointer();
+    if (replaced || writeAccessCount != m_WriteAccessCount || !IsVolumeEvictable_unlocked(candidate) ||
+        HasAccessor(item->m_Data, item->m_Data + item->GetSize()))
+    {
+      std::lock_guard<std::mutex> storageLock(m_TimeStepSwapStorageMutex);
+      m_TimeStepSwapStorage->Discard(t, n);
+      continue;
+    }
+
+    for (unsigned int s = 0; s < m_Dimensions[2]; ++s)
+    {
+      ImageDataItemPointer &sl = m_Slices[GetSliceIndex(s, t, n)];
+      if (sl.GetPointer() != nullptr && sl->GetParent().GetPointer() == item)
+        sl = nullptr;
+    }
+    ForgetResidentVolume_unlocked(candidate);
+    m_Volumes[candidate] = nullptr;
+    m_SwappedOutVolumes[candidate] = true;
+    ++m_TimeStepCacheStatistics.m_Evictions;
+  }
+}
+
+void mitk::Image::SplitChannelsIntoVolumes()
+{
+  if (m_Dimensions[3] <= 1 || GetReferenceCount() < 1)
+    return;
+
+  {
+    MutexHolder lock(m_ImageDataArraysLock);
+    if (std::none_of(m_Channels.begin(), m_Channels.end(), [](const ImageDataItemPointer &ch) {
+          return ch.GetPointer() != nullptr && ch->IsComplete();
+        }))
+      return;
+  }
+
+  try
+  {
+    // make sure that nobody is accessing the channels while they are replaced
+    ImageWriteAccessor accessor(this, nullptr, ImageAccessorBase::ExceptionIfLocked);
+
+    MutexHolder lock(m_ImageDataArraysLock);
+    for (unsigned int n = 0; n < GetNumberOfChannels(); ++n)
+    {
+      const ImageDataItem *ch = m_Channels[n].GetPointer();
+      if (ch == nullptr || !ch->IsComplete())
+        continue;
+
+      // the channel may only be referenced by the image and its own volumes and slices
+      int references = 1;
+      bool referencedElsewhere = ch == m_CompleteData.GetPointer();
+      for (const ImageDataItemPointerArray *items : {&m_Volumes, &m_Slices})
+      {
+        for (const auto &item : *items)
+        {
+          if (item.GetPointer() != nullptr && item->GetParent().GetPointer() == ch)
+          {
+            referencedElsewhere |= item->GetReferenceCount() > 1;
+            ++references;
+          }
+        }
+      }
+
+      if (referencedElsewhere || ch->GetReferenceCount() != references ||
+          (ch->m_VtkImageData != nullptr && ch->m_VtkImageData->GetReferenceCount() > 1))
+      {
+        MITK_WARN << "Channel " << n << " is in use and cannot be split into evictable volumes.";
+        continue;
+      }
+
+      const size_t volumeSize = m_OffsetTable[3] * this->m_ImageDescriptor->GetChannelTypeById(n).GetSize();
+      for (unsigned int t = 0; t < m_Dimensions[3]; ++t)
+      {
+        ImageDataItemPointer vol =
+          new ImageDataItem(this->m_ImageDescriptor->GetChannelTypeById(n), t, 3, m_Dimensions, nullptr, true);
+        std::memcpy(vol->GetData(), static_cast<char *>(ch->GetData()) + t * volumeSize, volumeSize);
+        vol->SetComplete(true);
+        m_Volumes[GetVolumeIndex(t, n)] = vol;
+
+        for (unsigned int s = 0; s < m_Dimensions[2]; ++s)
+        {
+          m_Slices[GetSliceIndex(s, t, n)] = nullptr;
+        }
+      }
+      m_Channels[n] = nullptr;
+      m_ImageDescriptor->GetChannelDescriptor(n).SetData(nullptr);
+    }
+  }
+  catch (const mitk::Exception &)
+  {
+    MITK_WARN << "Image is in use, its channels cannot be split into evictable volumes.";
+  }
+}
+
 unsigned int *mitk::Image::GetDimensions() const
 {
   return m_Dimensions;
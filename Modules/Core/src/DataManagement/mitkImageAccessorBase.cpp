@@ -17,6 +17,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageAccessorBase.h"
 #include "mitkImage.h"
 
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+  /** Fast path readers are not listed in mitk::Image::m_Readers. Every thread keeps track of its own ones, so that
+   * they can be registered regularly as soon as the same thread orders write access to the image. Read accessors
+   * are therefore expected to be released by the thread that created them. */
+  thread_local std::vector<mitk::ImageAccessorBase *> FastPathReadersOfThread;
+}
+
 mitk::ImageAccessorBase::ThreadIDType mitk::ImageAccessorBase::CurrentThreadHandle()
 {
 #ifdef ITK_USE_SPROC
@@ -49,7 +60,9 @@ mitk::ImageAccessorBase::ImageAccessorBase(ImageConstPointer image,
     //, imageDataItem(iDI)
     m_SubRegion(nullptr),
     m_Options(OptionFlags),
-    m_CoherentMemory(false)
+    m_CoherentMemory(false),
+    m_FastPath(false),
+    m_FastPathSlot(0)
 {
   m_Thread = CurrentThreadHandle();
 
@@ -186,3 +199,58 @@ void mitk::ImageAccessorBase::PreventRecursiveMutexLock(mitk::ImageAccessorBase
   }
 #endif
 }
+
+void mitk::ImageAccessorBase::RegisterFastPathReader()
+{
+  FastPathReadersOfThread.push_back(this);
+}
+
+void mitk::ImageAccessorBase::UnregisterFastPathReader()
+{
+  auto it = std::find(FastPathReadersOfThread.begin(), FastPathReadersOfThread.end(), this);
+
+  if (it != FastPathReadersOfThread.end())
+  {
+    FastPathReadersOfThread.erase(it);
+  }
+}
+
+void mitk::ImageAccessorBase::PreventRecursiveFastPathLock()
+{
+  const Image *image = GetImage();
+
+  for (ImageAccessorBase *r : FastPathReadersOfThread)
+  {
+    if (r->GetImage() == image && Overlap(r))
+    {
+      image->m_ReadWriteLock.Lock();
+      PreventRecursiveMutexLock(r);
+      image->m_ReadWriteLock.Unlock();
+    }
+  }
+}
+
+bool mitk::ImageAccessorBase::OverlapsFastPathReaderOfOtherThread() const
+{
+  const Image *image = GetImage();
+
+  for (const auto &slot : image->m_FastPathReaders)
+  {
+    const ImageAccessorBase *reader = slot.m_Reader;
+
+    // Readers of the calling thread do not overlap, see PreventRecursiveFastPathLock()
+    if (reader == nullptr ||
+        std::find(FastPathReadersOfThread.begin(), FastPathReadersOfThread.end(), reader) != FastPathReadersOfThread.end())
+    {
+      continue;
+    }
+
+    if (!m_CoherentMemory ||
+        (slot.m_AddressBegin.load() < m_AddressEnd && m_AddressBegin < slot.m_AddressEnd.load()))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
@@ -168,6 +168,39 @@ mitk::ImageDataItem::ImageDataItem(const mitk::PixelType &type,
   m_ReferenceCount = 0;
 }
 
+mitk::ImageDataItem::ImageDataItem(const mitk::ImageDescriptor::Pointer desc,
+                                   int timestep,
+                                   MemoryMappedFile::Pointer mappedFile)
+  : m_Data(static_cast<unsigned char *>(mappedFile->GetData())),
+    m_PixelType(new mitk::PixelType(desc->GetChannelDescriptor(0).GetPixelType())),
+    m_ManageMemory(false),
+    m_VtkImageData(nullptr),
+    m_VtkImageReadAccessor(nullptr),
+    m_VtkImageWriteAccessor(nullptr),
+    m_Offset(0),
+    m_IsComplete(false),
+    m_Size(0),
+    m_MappedFile(mappedFile),
+    m_Dimension(desc->GetNumberOfDimensions()),
+    m_Timestep(timestep)
+{
+  const unsigned int *dimensions = desc->GetDimensions();
+  for (unsigned int i = 0; i < m_Dimension; i++)
+  {
+    m_Dimensions[i] = dimensions[i];
+  }
+
+  this->ComputeItemSize(m_Dimensions, m_Dimension);
+
+  if (m_MappedFile->GetLength() < m_Size)
+  {
+    delete m_PixelType;
+    mitkThrow() << "Memory mapped part of " << m_MappedFile->GetFileName() << " is smaller than the image data item";
+  }
+
+  m_ReferenceCount = 0;
+}
+
 mitk::ImageDataItem::ImageDataItem(const ImageDataItem &other)
   : itk::LightObject(),
     m_Data(other.m_Data),
@@ -179,6 +212,7 @@ mitk::ImageDataItem::ImageDataItem(const ImageDataItem &other)
     m_Offset(other.m_Offset),
     m_IsComplete(other.m_IsComplete),
     m_Size(other.m_Size),
+    m_MappedFile(other.m_MappedFile),
     m_Parent(other.m_Parent),
     m_Dimension(other.m_Dimension),
     m_Timestep(other.m_Timestep)
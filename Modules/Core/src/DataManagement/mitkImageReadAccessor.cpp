@@ -60,7 +60,13 @@ mitk::ImageReadAccessor::ImageReadAccessor(const mitk::Image *image, const Image
 
 mitk::ImageReadAccessor::~ImageReadAccessor()
 {
-  if (!(m_Options & ImageAccessorBase::IgnoreLock))
+  if (m_FastPath)
+  {
+    UnregisterFastPathReader();
+    ReleaseFastPathSlot();
+    delete m_WaitLock;
+  }
+  else if (!(m_Options & ImageAccessorBase::IgnoreLock))
   {
     // Future work: In case of non-coherent memory, copied area needs to be deleted
 
@@ -94,8 +100,58 @@ const mitk::Image *mitk::ImageReadAccessor::GetImage() const
   return m_Image.GetPointer();
 }
 
+bool mitk::ImageReadAccessor::TryFastPathReadAccess()
+{
+  if (m_Image->m_PendingWriterCount != 0)
+    return false;
+
+  for (unsigned int i = 0; i < Image::NumberOfFastPathReaderSlots; ++i)
+  {
+    auto &slot = m_Image->m_FastPathReaders[i];
+    const ImageAccessorBase *expected = nullptr;
+
+    if (!slot.m_Reader.compare_exchange_strong(expected, this))
+      continue;
+
+    // Announce this reader and its memory first and check for writers afterwards. Write accessors do it the other
+    // way round (see ImageWriteAccessor::WaitForFastPathReaders), so at least one of both sides sees the other one.
+    slot.m_AddressBegin = m_AddressBegin;
+    slot.m_AddressEnd = m_AddressEnd;
+    m_FastPathSlot = i;
+
+    if (m_Image->m_PendingWriterCount == 0)
+    {
+      m_FastPath = true;
+      RegisterFastPathReader();
+      return true;
+    }
+
+    ReleaseFastPathSlot();
+    return false;
+  }
+
+  // All slots are taken, so this reader is registered regularly
+  return false;
+}
+
+void mitk::ImageReadAccessor::ReleaseFastPathSlot()
+{
+  m_Image->m_FastPathReaders[m_FastPathSlot].m_Reader = nullptr;
+
+  // Only write accessors wait for fast path readers, and only after announcing themselves
+  if (m_Image->m_PendingWriterCount != 0)
+  {
+    std::lock_guard<std::mutex> lock(m_Image->m_FastPathReaderMutex);
+    m_Image->m_FastPathReaderReleased.notify_all();
+  }
+}
+
 void mitk::ImageReadAccessor::OrganizeReadAccess()
 {
+  // Uncontended readers neither need the image mutex nor a place in the readers list
+  if (TryFastPathReadAccess())
+    return;
+
   m_Image->m_ReadWriteLock.Lock();
 
   // Check, if there is any Write-Access going on
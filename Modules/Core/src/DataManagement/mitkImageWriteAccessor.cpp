@@ -20,7 +20,19 @@ mitk::ImageWriteAccessor::ImageWriteAccessor(ImagePointer image, const mitk::Ima
   : ImageAccessorBase(image.GetPointer(), iDI, OptionFlags), m_Image(image)
 
 {
-  OrganizeWriteAccess();
+  // From now on, read accessors do not take the fast path anymore
+  m_Image->m_PendingWriterCount += 1;
+
+  try
+  {
+    OrganizeWriteAccess();
+  }
+  catch (...)
+  {
+    m_Image->m_PendingWriterCount -= 1;
+    delete m_WaitLock;
+    throw;
+  }
 }
 
 mitk::ImageWriteAccessor::~ImageWriteAccessor()
@@ -45,6 +57,8 @@ mitk::ImageWriteAccessor::~ImageWriteAccessor()
     m_WaitLock->m_Mutex.Unlock();
   }
 
+  m_Image->m_PendingWriterCount -= 1;
+
   m_Image->m_ReadWriteLock.Unlock();
 }
 
@@ -53,8 +67,30 @@ const mitk::Image *mitk::ImageWriteAccessor::GetImage() const
   return m_Image.GetPointer();
 }
 
+void mitk::ImageWriteAccessor::WaitForFastPathReaders()
+{
+  PreventRecursiveFastPathLock();
+
+  // m_PendingWriterCount is already incremented, so no new fast path readers can show up. The remaining ones
+  // notify m_FastPathReaderReleased when they are released.
+  std::unique_lock<std::mutex> lock(m_Image->m_FastPathReaderMutex);
+
+  if (!OverlapsFastPathReaderOfOtherThread())
+    return;
+
+  if (m_Options & ExceptionIfLocked)
+  {
+    mitkThrowException(mitk::MemoryIsLockedException)
+      << "The image part being ordered by the ImageAccessor is already in use and locked";
+  }
+
+  m_Image->m_FastPathReaderReleased.wait(lock, [this]() { return !OverlapsFastPathReaderOfOtherThread(); });
+}
+
 void mitk::ImageWriteAccessor::OrganizeWriteAccess()
 {
+  WaitForFastPathReaders();
+
   m_Image->m_ReadWriteLock.Lock();
 
   bool readOverlap = false;
@@ -144,6 +180,7 @@ void mitk::ImageWriteAccessor::OrganizeWriteAccess()
 
   // insert self into Writers list in Image
   m_Image->m_Writers.push_back(this);
+  ++m_Image->m_WriteAccessCount;
 
   // printf("WriteAccess %d %d\n",(int) m_Image->m_Readers.size(),(int) m_Image->m_Writers.size());
   // fflush(0);
@@ -0,0 +1,245 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkMemoryMappedFile.h"
+#include "mitkException.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+  std::atomic<std::size_t> ReaderThreshold(64 * 1024 * 1024);
+
+  /** All live mappings, so that writers can detach them from a file before overwriting it */
+  std::mutex MappedFilesMutex;
+  std::vector<mitk::MemoryMappedFile *> MappedFiles;
+
+  /** Returns false if the file does not exist */
+  bool GetFileId(const std::string &fileName, unsigned long long &device, unsigned long long &index)
+  {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(fileName.c_str(),
+                              0,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+      return false;
+    }
+
+    BY_HANDLE_FILE_INFORMATION information;
+    const bool success = GetFileInformationByHandle(file, &information) != 0;
+    CloseHandle(file);
+    if (success)
+    {
+      device = information.dwVolumeSerialNumber;
+      index = (static_cast<unsigned long long>(information.nFileIndexHigh) << 32) | information.nFileIndexLow;
+    }
+    return success;
+#else
+    struct stat fileStatus;
+    if (stat(fileName.c_str(), &fileStatus) != 0)
+    {
+      return false;
+    }
+
+    device = static_cast<unsigned long long>(fileStatus.st_dev);
+    index = static_cast<unsigned long long>(fileStatus.st_ino);
+    return true;
+#endif
+  }
+}
+
+std::size_t mitk::MemoryMappedFile::GetReaderThreshold()
+{
+  return ReaderThreshold;
+}
+
+void mitk::MemoryMappedFile::SetReaderThreshold(std::size_t numberOfBytes)
+{
+  ReaderThreshold = numberOfBytes;
+}
+
+mitk::MemoryMappedFile::MemoryMappedFile(const std::string &fileName, std::size_t offset, std::size_t length)
+  : m_FileName(fileName),
+    m_Data(nullptr),
+    m_Length(length),
+    m_MappingBegin(nullptr),
+    m_MappingLength(0),
+    m_FileDevice(0),
+    m_FileIndex(0)
+{
+  if (length == 0)
+  {
+    mitkThrow() << "Cannot map zero bytes of file " << fileName;
+  }
+
+#ifdef _WIN32
+  m_FileHandle = nullptr;
+  m_MappingHandle = nullptr;
+
+  HANDLE file =
+    CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    mitkThrow() << "Cannot open file " << fileName << " for memory mapping";
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || static_cast<unsigned long long>(fileSize.QuadPart) < offset + length)
+  {
+    CloseHandle(file);
+    mitkThrow() << "File " << fileName << " is too small to map " << length << " bytes at offset " << offset;
+  }
+
+  BY_HANDLE_FILE_INFORMATION fileInformation;
+  if (GetFileInformationByHandle(file, &fileInformation))
+  {
+    m_FileDevice = fileInformation.dwVolumeSerialNumber;
+    m_FileIndex =
+      (static_cast<unsigned long long>(fileInformation.nFileIndexHigh) << 32) | fileInformation.nFileIndexLow;
+  }
+
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  if (mapping == nullptr)
+  {
+    CloseHandle(file);
+    mitkThrow() << "Cannot create a file mapping for " << fileName;
+  }
+
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  const std::size_t alignedOffset = offset - offset % systemInfo.dwAllocationGranularity;
+  m_MappingLength = length + (offset - alignedOffset);
+
+  m_MappingBegin = MapViewOfFile(mapping,
+                                 FILE_MAP_COPY,
+                                 static_cast<DWORD>(static_cast<unsigned long long>(alignedOffset) >> 32),
+                                 static_cast<DWORD>(alignedOffset & 0xFFFFFFFF),
+                                 m_MappingLength);
+  if (m_MappingBegin == nullptr)
+  {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    mitkThrow() << "Cannot map " << length << " bytes of file " << fileName;
+  }
+
+  m_FileHandle = file;
+  m_MappingHandle = mapping;
+#else
+  int file = open(fileName.c_str(), O_RDONLY);
+  if (file < 0)
+  {
+    mitkThrow() << "Cannot open file " << fileName << " for memory mapping";
+  }
+
+  struct stat fileStatus;
+  if (fstat(file, &fileStatus) != 0 || static_cast<std::size_t>(fileStatus.st_size) < offset + length)
+  {
+    close(file);
+    mitkThrow() << "File " << fileName << " is too small to map " << length << " bytes at offset " << offset;
+  }
+
+  m_FileDevice = static_cast<unsigned long long>(fileStatus.st_dev);
+  m_FileIndex = static_cast<unsigned long long>(fileStatus.st_ino);
+
+  const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  const std::size_t alignedOffset = offset - offset % pageSize;
+  m_MappingLength = length + (offset - alignedOffset);
+
+  void *mapping =
+    mmap(nullptr, m_MappingLength, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, static_cast<off_t>(alignedOffset));
+
+  // The mapping stays valid after the file descriptor is closed
+  close(file);
+
+  if (mapping == MAP_FAILED)
+  {
+    mitkThrow() << "Cannot map " << length << " bytes of file " << fileName;
+  }
+
+  m_MappingBegin = mapping;
+#endif
+
+  m_Data = static_cast<unsigned char *>(m_MappingBegin) + (offset - alignedOffset);
+
+  std::lock_guard<std::mutex> lock(MappedFilesMutex);
+  MappedFiles.push_back(this);
+}
+
+mitk::MemoryMappedFile::~MemoryMappedFile()
+{
+  {
+    std::lock_guard<std::mutex> lock(MappedFilesMutex);
+    MappedFiles.erase(std::remove(MappedFiles.begin(), MappedFiles.end(), this), MappedFiles.end());
+  }
+
+#ifdef _WIN32
+  UnmapViewOfFile(m_MappingBegin);
+  CloseHandle(m_MappingHandle);
+  CloseHandle(m_FileHandle);
+#else
+  munmap(m_MappingBegin, m_MappingLength);
+#endif
+}
+
+void mitk::MemoryMappedFile::DetachFromFile(const std::string &fileName)
+{
+  unsigned long long device = 0;
+  unsigned long long index = 0;
+  if (!GetFileId(fileName, device, index))
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(MappedFilesMutex);
+  const bool isMapped =
+    std::any_of(MappedFiles.begin(), MappedFiles.end(), [device, index](const MemoryMappedFile *mappedFile) {
+      return mappedFile->m_FileDevice == device && mappedFile->m_FileIndex == index;
+    });
+
+  if (!isMapped)
+  {
+    return;
+  }
+
+#ifdef _WIN32
+  mitkThrow() << "File " << fileName << " is memory mapped and cannot be overwritten, save to another file instead";
+#else
+  // Truncating the file would also discard the private copies of its pages. Instead, the mapped file is unlinked
+  // and the writer creates a new one. The mappings keep the unlinked file alive, so the mapped data is neither
+  // copied nor changed and may still be written concurrently.
+  if (unlink(fileName.c_str()) != 0)
+  {
+    mitkThrow() << "File " << fileName << " is memory mapped and cannot be replaced, save to another file instead";
+  }
+#endif
+}
@@ -24,7 +24,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkImage.h>
 #include <mitkImageReadAccessor.h>
 #include <mitkLocaleSwitch.h>
+#include <mitkMemoryMappedFile.h>
 
+#include <itkByteSwapper.h>
 #include <itkImage.h>
 #include <itkImageFileReader.h>
 #include <itkImageIOFactory.h>
@@ -32,6 +34,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkMetaDataObject.h>
 
 #include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
 
 namespace mitk
 {
@@ -241,6 +246,81 @@ namespace mitk
     return result;
   };
 
+  /**Helper function that determines where the data of an attached, raw encoded NRRD file starts.
+   * Returns false for all other files (compressed, detached, skipped or byte swapped data) and for
+   * files whose data is not stored in the layout of mitk::Image, whose data has to be read by the ImageIO.
+   * The NrrdImageIO permutes the axes of vector images if the vector axis is not the first one.*/
+  bool GetRawNrrdDataOffset(const std::string &path, std::size_t &offset)
+  {
+    std::ifstream stream(path.c_str(), std::ios::binary);
+    std::string line;
+
+    if (!std::getline(stream, line) || line.compare(0, 4, "NRRD") != 0)
+      return false;
+
+    bool isRaw = false;
+    bool isNativeByteOrder = true;
+
+    while (std::getline(stream, line))
+    {
+      if (!line.empty() && line[line.size() - 1] == '\r')
+        line.erase(line.size() - 1);
+
+      if (line.empty())
+      {
+        // The blank line terminates the header, the data follows immediately
+        std::streamoff position = stream.tellg();
+        if (position < 0)
+          return false;
+
+        offset = static_cast<std::size_t>(position);
+        return isRaw && isNativeByteOrder;
+      }
+
+      const std::size_t fieldSeparator = line.find(": ");
+      if (line[0] == '#' || fieldSeparator == std::string::npos || line.find(":=") < fieldSeparator)
+        continue;
+
+      // Field identifiers may be written with or without spaces ("data file", "datafile")
+      std::string field;
+      for (std::size_t i = 0; i < fieldSeparator; ++i)
+      {
+        if (line[i] != ' ')
+          field += static_cast<char>(std::tolower(static_cast<unsigned char>(line[i])));
+      }
+      const std::string value = line.substr(fieldSeparator + 2);
+
+      if (field == "encoding")
+      {
+        isRaw = value == "raw";
+      }
+      else if (field == "endian")
+      {
+        isNativeByteOrder = (value == "big") == itk::ByteSwapper<int>::SystemIsBigEndian();
+      }
+      else if (field == "kinds")
+      {
+        // Only the first axis may hold the components of a pixel, all other axes have to be domain axes
+        std::istringstream kinds(value);
+        std::string kind;
+        for (unsigned int axis = 0; kinds >> kind; ++axis)
+        {
+          std::transform(kind.begin(), kind.end(), kind.begin(), [](unsigned char c) { return std::tolower(c); });
+          const bool isDomainAxis =
+            kind == "domain" || kind == "space" || kind == "time" || kind == "???" || kind == "none";
+          if (axis > 0 && !isDomainAxis)
+            return false;
+        }
+      }
+      else if (field == "datafile" || ((field == "lineskip" || field == "byteskip") && value != "0"))
+      {
+        return false;
+      }
+    }
+
+    return false;
+  }
+
   std::vector<BaseData::Pointer> ItkImageIO::Read()
   {
     std::vector<BaseData::Pointer> result;
@@ -316,11 +396,33 @@ namespace mitk
 
     MITK_INFO << "ioRegion: " << ioRegion << std::endl;
     m_ImageIO->SetIORegion(ioRegion);
-    void *buffer = new unsigned char[m_ImageIO->GetImageSizeInBytes()];
-    m_ImageIO->Read(buffer);
-
     image->Initialize(MakePixelType(m_ImageIO), ndim, dimensions);
-    image->SetImportChannel(buffer, 0, Image::ManageMemory);
+
+    // Large uncompressed files are mapped, so that only the parts which are accessed are read from disk
+    void *buffer = nullptr;
+    const std::size_t imageSizeInBytes = m_ImageIO->GetImageSizeInBytes();
+    std::size_t dataOffset = 0;
+    bool isMapped = false;
+
+    if (imageSizeInBytes >= MemoryMappedFile::GetReaderThreshold() &&
+        std::string(m_ImageIO->GetNameOfClass()) == "NrrdImageIO" && GetRawNrrdDataOffset(path, dataOffset))
+    {
+      try
+      {
+        isMapped = image->SetMappedChannel(std::make_shared<MemoryMappedFile>(path, dataOffset, imageSizeInBytes));
+      }
+      catch (const mitk::Exception &e)
+      {
+        MITK_WARN << "Memory mapping failed, reading the complete image instead: " << e.GetDescription();
+      }
+    }
+
+    if (!isMapped)
+    {
+      buffer = new unsigned char[imageSizeInBytes];
+      m_ImageIO->Read(buffer);
+      image->SetImportChannel(buffer, 0, Image::ManageMemory);
+    }
 
     const itk::MetaDataDictionary &dictionary = m_ImageIO->GetMetaDataDictionary();
 
@@ -654,6 +756,10 @@ namespace mitk
         itk::EncapsulateMetaData<std::string>(m_ImageIO->GetMetaDataDictionary(), key, value);
       }
       ImageReadAccessor imageAccess(image);
+
+      // Images loaded from this file may still map it, give them a private copy before it is overwritten
+      MemoryMappedFile::DetachFromFile(path);
+
       LocaleSwitch localeSwitch2("C");
       m_ImageIO->Write(imageAccess.GetData());
     }
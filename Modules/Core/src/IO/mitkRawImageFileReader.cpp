@@ -20,6 +20,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkITKImageImport.h"
 #include "mitkImageCast.h"
 
+#include <itkByteSwapper.h>
 #include <itkImage.h>
 #include <itkImageFileReader.h>
 #include <itkRawImageIO.h>
@@ -154,6 +155,33 @@ mitk::BaseData::Pointer mitk::RawImageFileReaderService::TypedRead(const std::st
   typedef itk::ImageFileReader<ImageType> ReaderType;
   typedef itk::RawImageIO<TPixel, VImageDimensions> IOType;
 
+  // Large files in native byte order are mapped, so that only the parts which are accessed are read from disk
+  const bool isNativeByteOrder = (endianity == BIG) == itk::ByteSwapper<TPixel>::SystemIsBigEndian();
+  unsigned int dimensions[VImageDimensions];
+  std::size_t imageSizeInBytes = sizeof(TPixel);
+  for (unsigned int dim = 0; dim < VImageDimensions; ++dim)
+  {
+    dimensions[dim] = static_cast<unsigned int>(size[dim]);
+    imageSizeInBytes *= dimensions[dim];
+  }
+
+  if (isNativeByteOrder && imageSizeInBytes > 0 && imageSizeInBytes >= MemoryMappedFile::GetReaderThreshold())
+  {
+    try
+    {
+      auto mappedFile = std::make_shared<MemoryMappedFile>(path, 0, imageSizeInBytes);
+
+      mitk::Image::Pointer image = mitk::Image::New();
+      image->Initialize(MakeScalarPixelType<TPixel>(), VImageDimensions, dimensions);
+      if (image->SetMappedChannel(mappedFile))
+        return image.GetPointer();
+    }
+    catch (const mitk::Exception &e)
+    {
+      MITK_WARN << "Memory mapping failed, reading the complete image instead: " << e.GetDescription();
+    }
+  }
+
   typename ReaderType::Pointer reader = ReaderType::New();
   typename IOType::Pointer io = IOType::New();
 
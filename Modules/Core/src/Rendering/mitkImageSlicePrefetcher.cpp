@@ -0,0 +1,413 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkImageSlicePrefetcher.h"
+
+#include <mitkImageReadAccessor.h>
+
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+  /** Slices are only reused for planes that are equal up to this tolerance in mm */
+  const mitk::ScalarType PlaneEpsilon = 1e-6;
+
+  const std::size_t MinimumCacheCapacity = 16;
+}
+
+/** Processes the requests of all prefetchers in turn, one request at a time. The worker is owned by the
+ * prefetchers, so it lives exactly as long as at least one prefetcher exists and never outlives the static
+ * destruction of a prefetcher that is destroyed late. */
+class mitk::ImageSlicePrefetcher::Worker
+{
+public:
+  /** Returns the worker of all existing prefetchers or a new one if there is none */
+  static std::shared_ptr<Worker> GetInstance()
+  {
+    static std::mutex instanceMutex;
+    static std::weak_ptr<Worker> instance;
+
+    std::lock_guard<std::mutex> lock(instanceMutex);
+
+    auto worker = instance.lock();
+    if (nullptr == worker)
+    {
+      worker.reset(new Worker);
+      instance = worker;
+    }
+
+    return worker;
+  }
+
+  ~Worker()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Stop = true;
+    }
+
+    m_PrefetcherScheduled.notify_all();
+
+    if (m_Thread.joinable())
+      m_Thread.join();
+  }
+
+  /** Makes sure that the pending requests of prefetcher are processed */
+  void Schedule(ImageSlicePrefetcher *prefetcher)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+
+      if (std::find(m_Prefetchers.begin(), m_Prefetchers.end(), prefetcher) == m_Prefetchers.end())
+        m_Prefetchers.push_back(prefetcher);
+
+      if (!m_Thread.joinable())
+        m_Thread = std::thread(&Worker::ThreadMain, this);
+    }
+
+    m_PrefetcherScheduled.notify_one();
+  }
+
+  /** Returns as soon as the background thread does not use prefetcher anymore */
+  void Remove(ImageSlicePrefetcher *prefetcher)
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    // the background thread puts a prefetcher back into the list after processing a request of it
+    m_RequestProcessed.wait(lock, [this, prefetcher]() { return m_CurrentPrefetcher != prefetcher; });
+    m_Prefetchers.erase(std::remove(m_Prefetchers.begin(), m_Prefetchers.end(), prefetcher), m_Prefetchers.end());
+  }
+
+private:
+  Worker() : m_CurrentPrefetcher(nullptr), m_Stop(false) {}
+
+  void ThreadMain()
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    while (true)
+    {
+      m_PrefetcherScheduled.wait(lock, [this]() { return m_Stop || !m_Prefetchers.empty(); });
+
+      if (m_Stop)
+        return;
+
+      m_CurrentPrefetcher = m_Prefetchers.front();
+      m_Prefetchers.pop_front();
+
+      lock.unlock();
+      const bool hasMoreRequests = m_CurrentPrefetcher->ProcessNextRequest();
+      lock.lock();
+
+      // round robin, so that a long list of requests does not stall the other render windows
+      if (hasMoreRequests &&
+          std::find(m_Prefetchers.begin(), m_Prefetchers.end(), m_CurrentPrefetcher) == m_Prefetchers.end())
+        m_Prefetchers.push_back(m_CurrentPrefetcher);
+
+      m_CurrentPrefetcher = nullptr;
+      m_RequestProcessed.notify_all();
+    }
+  }
+
+  std::thread m_Thread;
+  std::mutex m_Mutex;
+  std::condition_variable m_PrefetcherScheduled;
+  std::condition_variable m_RequestProcessed;
+  std::deque<ImageSlicePrefetcher *> m_Prefetchers;
+  ImageSlicePrefetcher *m_CurrentPrefetcher;
+  bool m_Stop;
+};
+
+mitk::ImageSlicePrefetcher::Settings::Settings()
+  : m_TimeStep(0), m_InterpolationMode(ExtractSliceFilter::RESLICE_NEAREST), m_InPlaneResampleExtentByGeometry(false)
+{
+}
+
+bool mitk::ImageSlicePrefetcher::Settings::operator==(const Settings &other) const
+{
+  return m_TimeStep == other.m_TimeStep && m_InterpolationMode == other.m_InterpolationMode &&
+         m_InPlaneResampleExtentByGeometry == other.m_InPlaneResampleExtentByGeometry;
+}
+
+mitk::ImageSlicePrefetcher::ImageSlicePrefetcher()
+  : m_Worker(Worker::GetInstance()), m_CacheCapacity(MinimumCacheCapacity), m_Generation(0), m_IsBusy(false)
+{
+}
+
+mitk::ImageSlicePrefetcher::~ImageSlicePrefetcher()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Requests.clear();
+  }
+
+  m_Worker->Remove(this);
+}
+
+unsigned long mitk::ImageSlicePrefetcher::GetImageMTime(const Image *image, int timeStep)
+{
+  unsigned long mTime = std::max(image->GetMTime(), image->GetTimeGeometry()->GetMTime());
+
+  auto geometry = image->GetTimeGeometry()->GetGeometryForTimeStep(timeStep);
+  if (geometry.IsNotNull())
+    mTime = std::max(mTime, geometry->GetMTime());
+
+  return mTime;
+}
+
+bool mitk::ImageSlicePrefetcher::Matches(const Request &request,
+                                         const Image *image,
+                                         unsigned long imageMTime,
+                                         const PlaneGeometry *plane,
+                                         const Settings &settings)
+{
+  return request.m_Image.GetPointer() == image && request.m_ImageMTime == imageMTime &&
+         request.m_Settings == settings && request.m_RequestedReferenceGeometry == plane->GetReferenceGeometry() &&
+         Equal(*request.m_Plane, *plane, PlaneEpsilon, false);
+}
+
+mitk::ImageSlicePrefetcher::SlicePointer mitk::ImageSlicePrefetcher::GetSlice(const Image *image,
+                                                                              const PlaneGeometry *plane,
+                                                                              const Settings &settings)
+{
+  if (nullptr == image || nullptr == plane)
+    return nullptr;
+
+  const unsigned long imageMTime = GetImageMTime(image, settings.m_TimeStep);
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  for (const auto &entry : m_Cache)
+  {
+    if (Matches(entry.m_Request, image, imageMTime, plane, settings))
+      return entry.m_Slice;
+  }
+
+  return nullptr;
+}
+
+void mitk::ImageSlicePrefetcher::Prefetch(const Image *image,
+                                          const std::vector<PlaneGeometry::ConstPointer> &planes,
+                                          const Settings &settings)
+{
+  if (nullptr == image || planes.empty())
+    return;
+
+  Request request;
+  request.m_Image = image;
+  request.m_RequestedReferenceGeometry = nullptr;
+  request.m_Settings = settings;
+  request.m_ImageMTime = GetImageMTime(image, settings.m_TimeStep);
+
+  std::vector<Request> requests;
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    request.m_Generation = m_Generation;
+    m_CacheCapacity = std::max(MinimumCacheCapacity, 2 * planes.size());
+
+    // Cached slices of a modified image are useless
+    m_Cache.erase(std::remove_if(m_Cache.begin(),
+                                 m_Cache.end(),
+                                 [&](const CacheEntry &entry) {
+                                   return entry.m_Request.m_Image.GetPointer() == image &&
+                                          entry.m_Request.m_ImageMTime != request.m_ImageMTime;
+                                 }),
+                  m_Cache.end());
+
+    for (const auto &plane : planes)
+    {
+      if (plane.IsNull())
+        continue;
+
+      bool isAvailable = false;
+
+      for (const auto &entry : m_Cache)
+      {
+        if (Matches(entry.m_Request, image, request.m_ImageMTime, plane, settings))
+        {
+          isAvailable = true;
+          break;
+        }
+      }
+
+      for (auto iter = m_Requests.begin(); !isAvailable && iter != m_Requests.end(); ++iter)
+      {
+        if (Matches(*iter, image, request.m_ImageMTime, plane, settings))
+        {
+          requests.push_back(*iter);
+          isAvailable = true;
+        }
+      }
+
+      if (!isAvailable)
+      {
+        request.m_Plane = plane;
+        requests.push_back(request);
+      }
+    }
+  }
+
+  // The plane and the image geometry may be changed by the calling thread while the background thread extracts
+  // the slices, so the background thread only gets copies of them. The volume is looked up here as well, since
+  // GetVolumeData() may initialize the data items of the image.
+  Image::Pointer imageView;
+  Image::ImageDataItemPointer volumeData;
+
+  for (auto &newRequest : requests)
+  {
+    if (newRequest.m_ImageView.IsNull())
+    {
+      if (imageView.IsNull())
+      {
+        imageView = Image::New();
+        imageView->Initialize(image);
+        volumeData = image->GetVolumeData(settings.m_TimeStep);
+      }
+
+      newRequest.m_ImageView = imageView;
+      newRequest.m_VolumeData = volumeData;
+
+      auto plane = newRequest.m_Plane->Clone();
+      newRequest.m_RequestedReferenceGeometry = plane->GetReferenceGeometry();
+      if (nullptr != newRequest.m_RequestedReferenceGeometry)
+      {
+        newRequest.m_ReferenceGeometry = newRequest.m_RequestedReferenceGeometry->Clone().GetPointer();
+        plane->SetReferenceGeometry(newRequest.m_ReferenceGeometry);
+      }
+      newRequest.m_Plane = plane.GetPointer();
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Requests.assign(requests.begin(), requests.end());
+  }
+
+  m_Worker->Schedule(this);
+}
+
+void mitk::ImageSlicePrefetcher::Cancel()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  ++m_Generation;
+  m_Requests.clear();
+  m_Cache.clear();
+}
+
+std::size_t mitk::ImageSlicePrefetcher::GetNumberOfCachedSlices() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Cache.size();
+}
+
+void mitk::ImageSlicePrefetcher::WaitUntilIdle()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_RequestProcessed.wait(lock, [this]() { return m_Requests.empty() && !m_IsBusy; });
+}
+
+bool mitk::ImageSlicePrefetcher::ProcessNextRequest()
+{
+  Request request;
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    if (m_Requests.empty())
+      return false;
+
+    request = m_Requests.front();
+    m_Requests.pop_front();
+    m_IsBusy = true;
+  }
+
+  auto slice = this->ExtractSlice(request);
+  bool hasMoreRequests = false;
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    if (nullptr != slice && request.m_Generation == m_Generation)
+    {
+      m_Cache.push_back({request, slice});
+
+      // The view references the image memory only while it is read by the background thread
+      m_Cache.back().m_Request.m_ImageView = nullptr;
+      m_Cache.back().m_Request.m_VolumeData = nullptr;
+
+      while (m_Cache.size() > m_CacheCapacity)
+        m_Cache.pop_front();
+    }
+
+    m_IsBusy = false;
+    hasMoreRequests = !m_Requests.empty();
+  }
+
+  m_RequestProcessed.notify_all();
+  return hasMoreRequests;
+}
+
+mitk::ImageSlicePrefetcher::SlicePointer mitk::ImageSlicePrefetcher::ExtractSlice(const Request &request)
+{
+  const int timeStep = request.m_Settings.m_TimeStep;
+
+  try
+  {
+    // Writers have priority, the slice is requested again when the user keeps on scrolling
+    // A slice of an image that is modified meanwhile is never returned by GetSlice(), since the modification
+    // time of the image does not match m_ImageMTime anymore
+    if (request.m_VolumeData.IsNull())
+      return nullptr;
+
+    ImageReadAccessor accessor(request.m_Image, request.m_VolumeData, ImageAccessorBase::ExceptionIfLocked);
+
+    auto &imageView = request.m_ImageView;
+    if (!imageView->SetImportVolume(const_cast<void *>(accessor.GetData()), timeStep, 0, Image::ReferenceMemory))
+      return nullptr;
+
+    auto reslicer = ExtractSliceFilter::New();
+    reslicer->SetInput(imageView);
+    reslicer->SetWorldGeometry(request.m_Plane);
+    reslicer->SetTimeStep(timeStep);
+    reslicer->SetResliceTransformByGeometry(imageView->GetTimeGeometry()->GetGeometryForTimeStep(timeStep));
+    reslicer->SetInPlaneResampleExtentByGeometry(request.m_Settings.m_InPlaneResampleExtentByGeometry);
+    reslicer->SetInterpolationMode(request.m_Settings.m_InterpolationMode);
+    reslicer->SetVtkOutputRequest(true);
+    reslicer->UpdateLargestPossibleRegion();
+
+    auto slice = std::make_shared<Slice>();
+    slice->m_Image = vtkSmartPointer<vtkImageData>::New();
+    slice->m_Image->DeepCopy(reslicer->GetVtkOutput());
+    slice->m_ResliceAxes = vtkSmartPointer<vtkMatrix4x4>::New();
+    slice->m_ResliceAxes->DeepCopy(reslicer->GetResliceAxes());
+
+    std::fill_n(slice->m_ClippedPlaneBounds, 6, 0.0);
+    reslicer->GetClippedPlaneBounds(slice->m_ClippedPlaneBounds);
+    std::copy_n(reslicer->GetOutputSpacing(), 2, slice->m_Spacing);
+
+    return slice;
+  }
+  catch (const std::exception &e)
+  {
+    MITK_DEBUG << "Slice could not be prefetched: " << e.what();
+  }
+
+  return nullptr;
+}
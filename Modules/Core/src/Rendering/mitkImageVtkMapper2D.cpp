@@ -59,6 +59,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkRGBAPixel.h>
 #include <mitkRenderingModeProperty.h>
 
+// STL
+#include <algorithm>
+
 mitk::ImageVtkMapper2D::ImageVtkMapper2D()
 {
 }
@@ -144,10 +147,15 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
     // the latest image is used there if the plane is out of the geometry
     // see bug-13275
     localStorage->m_ReslicedImage = nullptr;
+    localStorage->m_PrefetchedSlice = nullptr;
     localStorage->m_Mapper->SetInputData(localStorage->m_EmptyPolyData);
     return;
   }
 
+  // parameters of the reslicer that determine the slice, used to look up prefetched slices
+  ImageSlicePrefetcher::Settings prefetchSettings;
+  prefetchSettings.m_TimeStep = this->GetTimestep();
+
   // set main input for ExtractSliceFilter
   localStorage->m_Reslicer->SetInput(image);
   localStorage->m_Reslicer->SetWorldGeometry(worldGeometry);
@@ -161,6 +169,7 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
   bool inPlaneResampleExtentByGeometry = false;
   datanode->GetBoolProperty("in plane resample extent by geometry", inPlaneResampleExtentByGeometry, renderer);
   localStorage->m_Reslicer->SetInPlaneResampleExtentByGeometry(inPlaneResampleExtentByGeometry);
+  prefetchSettings.m_InPlaneResampleExtentByGeometry = inPlaneResampleExtentByGeometry;
 
   // Initialize the interpolation mode for resampling; switch to nearest
   // neighbor if the input image is too small.
@@ -178,20 +187,21 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
     switch (interpolationMode)
     {
       case VTK_RESLICE_NEAREST:
-        localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_NEAREST);
+        prefetchSettings.m_InterpolationMode = ExtractSliceFilter::RESLICE_NEAREST;
         break;
       case VTK_RESLICE_LINEAR:
-        localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_LINEAR);
+        prefetchSettings.m_InterpolationMode = ExtractSliceFilter::RESLICE_LINEAR;
         break;
       case VTK_RESLICE_CUBIC:
-        localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_CUBIC);
+        prefetchSettings.m_InterpolationMode = ExtractSliceFilter::RESLICE_CUBIC;
         break;
     }
   }
   else
   {
-    localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_NEAREST);
+    prefetchSettings.m_InterpolationMode = ExtractSliceFilter::RESLICE_NEAREST;
   }
+  localStorage->m_Reslicer->SetInterpolationMode(prefetchSettings.m_InterpolationMode);
 
   // set the vtk output property to true, makes sure that no unneeded mitk image convertion
   // is done.
@@ -227,8 +237,13 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
 
   const auto *planeGeometry = dynamic_cast<const PlaneGeometry *>(worldGeometry);
 
+  localStorage->m_PrefetchedSlice = nullptr;
+
   if (thickSlicesMode > 0)
   {
+    localStorage->m_SlicePrefetcher->Cancel();
+    localStorage->m_LastWorldPlane = nullptr;
+
     double dataZSpacing = 1.0;
 
     Vector3D normInIndex, normal;
@@ -277,10 +292,26 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
     localStorage->m_Reslicer->SetOutputSpacingZDirection(1.0);
     localStorage->m_Reslicer->SetOutputExtentZDirection(0, 0);
 
-    localStorage->m_Reslicer->Modified();
-    // start the pipeline with updating the largest possible, needed if the geometry of the input has changed
-    localStorage->m_Reslicer->UpdateLargestPossibleRegion();
-    localStorage->m_ReslicedImage = localStorage->m_Reslicer->GetVtkOutput();
+    // use the slice if it was extracted in the background while scrolling, abstract transform geometries
+    // (e.g. curved planes) are never prefetched
+    if (nullptr != planeGeometry && nullptr == dynamic_cast<const AbstractTransformGeometry *>(worldGeometry))
+    {
+      localStorage->m_PrefetchedSlice =
+        localStorage->m_SlicePrefetcher->GetSlice(image, planeGeometry, prefetchSettings);
+      this->PrefetchSlices(renderer, planeGeometry, prefetchSettings);
+    }
+
+    if (nullptr != localStorage->m_PrefetchedSlice)
+    {
+      localStorage->m_ReslicedImage = localStorage->m_PrefetchedSlice->m_Image;
+    }
+    else
+    {
+      localStorage->m_Reslicer->Modified();
+      // start the pipeline with updating the largest possible, needed if the geometry of the input has changed
+      localStorage->m_Reslicer->UpdateLargestPossibleRegion();
+      localStorage->m_ReslicedImage = localStorage->m_Reslicer->GetVtkOutput();
+    }
   }
 
   // Bounds information for reslicing (only reuqired if reference geometry
@@ -291,10 +322,20 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
   {
     sliceBound = 0.0;
   }
-  localStorage->m_Reslicer->GetClippedPlaneBounds(sliceBounds);
+  if (nullptr != localStorage->m_PrefetchedSlice)
+  {
+    std::copy_n(localStorage->m_PrefetchedSlice->m_ClippedPlaneBounds, 6, sliceBounds);
+
+    // get the spacing of the slice
+    localStorage->m_mmPerPixel = localStorage->m_PrefetchedSlice->m_Spacing;
+  }
+  else
+  {
+    localStorage->m_Reslicer->GetClippedPlaneBounds(sliceBounds);
 
-  // get the spacing of the slice
-  localStorage->m_mmPerPixel = localStorage->m_Reslicer->GetOutputSpacing();
+    // get the spacing of the slice
+    localStorage->m_mmPerPixel = localStorage->m_Reslicer->GetOutputSpacing();
+  }
 
   // calculate minimum bounding rect of IMAGE in texture
   {
@@ -1032,7 +1073,9 @@ void mitk::ImageVtkMapper2D::TransformActor(mitk::BaseRenderer *renderer)
   LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
   // get the transformation matrix of the reslicer in order to render the slice as axial, coronal or saggital
   vtkSmartPointer<vtkTransform> trans = vtkSmartPointer<vtkTransform>::New();
-  vtkSmartPointer<vtkMatrix4x4> matrix = localStorage->m_Reslicer->GetResliceAxes();
+  vtkSmartPointer<vtkMatrix4x4> matrix = nullptr != localStorage->m_PrefetchedSlice
+                                           ? localStorage->m_PrefetchedSlice->m_ResliceAxes.GetPointer()
+                                           : localStorage->m_Reslicer->GetResliceAxes();
   trans->SetMatrix(matrix);
   // transform the plane/contour (the actual actor) to the corresponding view (axial, coronal or saggital)
   localStorage->m_Actor->SetUserTransform(trans);
@@ -1076,6 +1119,67 @@ bool mitk::ImageVtkMapper2D::RenderingGeometryIntersectsImage(const PlaneGeometr
   return false;
 }
 
+void mitk::ImageVtkMapper2D::PrefetchSlices(mitk::BaseRenderer *renderer,
+                                            const PlaneGeometry *worldPlane,
+                                            const ImageSlicePrefetcher::Settings &settings)
+{
+  LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
+  auto *image = const_cast<mitk::Image *>(this->GetInput());
+
+  PlaneGeometry::ConstPointer lastWorldPlane = localStorage->m_LastWorldPlane;
+  localStorage->m_LastWorldPlane = worldPlane->Clone().GetPointer();
+
+  int numberOfSlices = 4;
+  this->GetDataNode()->GetIntProperty("reslice.prefetch slices", numberOfSlices, renderer);
+
+  if (numberOfSlices <= 0 || lastWorldPlane.IsNull())
+  {
+    localStorage->m_SlicePrefetcher->Cancel();
+    return;
+  }
+
+  Vector3D shift = worldPlane->GetOrigin() - lastWorldPlane->GetOrigin();
+
+  if (shift.GetNorm() < mitk::eps && Equal(*worldPlane, *lastWorldPlane, mitk::eps, false))
+  {
+    return; // same plane, e.g. level window changed
+  }
+
+  // scrolling means that the plane is only shifted along its normal
+  Vector3D normal = worldPlane->GetNormal();
+  normal.Normalize();
+
+  const bool isScrolling = worldPlane->GetReferenceGeometry() == lastWorldPlane->GetReferenceGeometry() &&
+                           shift.GetNorm() >= mitk::eps &&
+                           (shift - normal * (shift * normal)).GetNorm() < 1e-6 * shift.GetNorm() &&
+                           Equal(*worldPlane->GetIndexToWorldTransform(),
+                                 *lastWorldPlane->GetIndexToWorldTransform(),
+                                 mitk::eps,
+                                 false) &&
+                           Equal(*worldPlane->GetBoundingBox(), *lastWorldPlane->GetBoundingBox(), mitk::eps, false);
+
+  if (!isScrolling)
+  {
+    localStorage->m_SlicePrefetcher->Cancel();
+    return;
+  }
+
+  std::vector<PlaneGeometry::ConstPointer> planes;
+
+  for (int i = 1; i <= numberOfSlices; ++i)
+  {
+    auto plane = worldPlane->Clone();
+    plane->SetOrigin(worldPlane->GetOrigin() + shift * static_cast<ScalarType>(i));
+
+    if (!this->RenderingGeometryIntersectsImage(plane, image->GetSlicedGeometry()))
+      break;
+
+    planes.push_back(plane.GetPointer());
+  }
+
+  localStorage->m_SlicePrefetcher->Prefetch(image, planes, settings);
+}
+
 mitk::ImageVtkMapper2D::LocalStorage::~LocalStorage()
 {
 }
@@ -1095,6 +1199,7 @@ mitk::ImageVtkMapper2D::LocalStorage::LocalStorage()
   m_Actor = vtkSmartPointer<vtkActor>::New();
   m_Actors = vtkSmartPointer<vtkPropAssembly>::New();
   m_Reslicer = mitk::ExtractSliceFilter::New();
+  m_SlicePrefetcher.reset(new ImageSlicePrefetcher);
   m_TSFilter = vtkSmartPointer<vtkMitkThickSlicesFilter>::New();
   m_OutlinePolyData = vtkSmartPointer<vtkPolyData>::New();
   m_ReslicedImage = vtkSmartPointer<vtkImageData>::New();
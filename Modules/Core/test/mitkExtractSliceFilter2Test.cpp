@@ -0,0 +1,225 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkExtractSliceFilter2.h>
+#include <mitkITKImageImport.h>
+#include <mitkImagePixelReadAccessor.h>
+
+#include <itkImage.h>
+#include <itkImageRegionIterator.h>
+#include <itkLinearInterpolateImageFunction.h>
+#include <itkNearestNeighborInterpolateImageFunction.h>
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+/**
+ * Compares the slices extracted by mitk::ExtractSliceFilter2 at oblique plane orientations with the values of the
+ * corresponding itk::InterpolateImageFunction, which the filter used for every pixel before, and logs the speedup.
+ */
+class mitkExtractSliceFilter2TestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkExtractSliceFilter2TestSuite);
+  MITK_TEST(NearestNeighborUnsignedChar);
+  MITK_TEST(NearestNeighborShort);
+  MITK_TEST(LinearUnsignedShort);
+  MITK_TEST(LinearFloat);
+  MITK_TEST(BenchmarkLargeVolume);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  template <typename TPixel>
+  using ItkImageType = itk::Image<TPixel, 3>;
+
+  template <typename TPixel>
+  typename ItkImageType<TPixel>::Pointer CreateVolume(unsigned int size)
+  {
+    auto image = ItkImageType<TPixel>::New();
+    typename ItkImageType<TPixel>::RegionType region;
+    region.SetSize(0, size);
+    region.SetSize(1, size);
+    region.SetSize(2, size);
+    image->SetRegions(region);
+
+    typename ItkImageType<TPixel>::SpacingType spacing;
+    spacing[0] = 0.8;
+    spacing[1] = 0.8;
+    spacing[2] = 1.5;
+    image->SetSpacing(spacing);
+    image->Allocate();
+
+    itk::ImageRegionIterator<ItkImageType<TPixel>> iter(image, region);
+    for (iter.GoToBegin(); !iter.IsAtEnd(); ++iter)
+    {
+      auto index = iter.GetIndex();
+      iter.Set(static_cast<TPixel>((index[0] * 3 + index[1] * 5 + index[2] * 7) % 100 - 20));
+    }
+
+    return image;
+  }
+
+  /** Oblique plane through the center of the volume, rotated by angle around an oblique axis */
+  mitk::PlaneGeometry::Pointer CreatePlane(unsigned int size, double angle)
+  {
+    mitk::Vector3D right;
+    mitk::Vector3D down;
+    right[0] = std::cos(angle);
+    right[1] = std::sin(angle);
+    right[2] = 0.3;
+    down[0] = -std::sin(angle) * 0.5;
+    down[1] = std::cos(angle) * 0.5;
+    down[2] = -0.5;
+    right.Normalize();
+    down -= right * (down * right);
+    down.Normalize();
+
+    auto plane = mitk::PlaneGeometry::New();
+    plane->InitializeStandardPlane(size, size, right, down);
+    plane->SetImageGeometry(true);
+
+    mitk::Point3D center;
+    center[0] = size * 0.4;
+    center[1] = size * 0.4;
+    center[2] = size * 0.75;
+    plane->SetOrigin(center - right * (size * 0.5) - down * (size * 0.5));
+
+    return plane;
+  }
+
+  /** Evaluates the interpolate image function at every pixel of the plane like the filter did before */
+  template <typename TPixel>
+  std::vector<TPixel> ExtractReference(const ItkImageType<TPixel> *image,
+                                       const mitk::PlaneGeometry *plane,
+                                       mitk::ExtractSliceFilter2::Interpolator interpolator)
+  {
+    typename itk::InterpolateImageFunction<ItkImageType<TPixel>>::Pointer function;
+    if (mitk::ExtractSliceFilter2::NearestNeighbor == interpolator)
+      function = itk::NearestNeighborInterpolateImageFunction<ItkImageType<TPixel>>::New().GetPointer();
+    else
+      function = itk::LinearInterpolateImageFunction<ItkImageType<TPixel>>::New().GetPointer();
+    function->SetInputImage(image);
+
+    auto xDirection = plane->GetAxisVector(0);
+    auto yDirection = plane->GetAxisVector(1);
+    xDirection.Normalize();
+    yDirection.Normalize();
+
+    const unsigned int width = plane->GetExtent(0);
+    const unsigned int height = plane->GetExtent(1);
+    std::vector<TPixel> result(width * height);
+    itk::ContinuousIndex<mitk::ScalarType, 3> index;
+
+    for (unsigned int y = 0; y < height; ++y)
+    {
+      for (unsigned int x = 0; x < width; ++x)
+      {
+        auto point = plane->GetOrigin() + yDirection * y + xDirection * x;
+        result[y * width + x] = image->TransformPhysicalPointToContinuousIndex(point, index)
+                                  ? static_cast<TPixel>(function->EvaluateAtContinuousIndex(index))
+                                  : std::numeric_limits<TPixel>::lowest();
+      }
+    }
+
+    return result;
+  }
+
+  /** Returns the fraction of pixels that differ by more than tolerance and logs the speedup */
+  template <typename TPixel>
+  double CompareWithReference(unsigned int volumeSize,
+                              unsigned int numberOfPlanes,
+                              mitk::ExtractSliceFilter2::Interpolator interpolator,
+                              double tolerance)
+  {
+    auto itkImage = CreateVolume<TPixel>(volumeSize);
+    auto image = mitk::ImportItkImage(itkImage);
+
+    auto filter = mitk::ExtractSliceFilter2::New();
+    filter->SetInput(image);
+    filter->SetInterpolator(interpolator);
+
+    std::chrono::duration<double> filterDuration(0);
+    std::chrono::duration<double> referenceDuration(0);
+    unsigned long numberOfDifferences = 0;
+    unsigned long numberOfPixels = 0;
+
+    for (unsigned int i = 0; i < numberOfPlanes; ++i)
+    {
+      auto plane = CreatePlane(volumeSize, 0.1 + i * 0.7);
+      filter->SetOutputGeometry(plane);
+
+      auto start = std::chrono::steady_clock::now();
+      filter->Update();
+      filterDuration += std::chrono::steady_clock::now() - start;
+
+      start = std::chrono::steady_clock::now();
+      auto reference = ExtractReference<TPixel>(itkImage, plane, interpolator);
+      referenceDuration += std::chrono::steady_clock::now() - start;
+
+      mitk::ImagePixelReadAccessor<TPixel, 2> accessor(filter->GetOutput());
+      auto data = accessor.GetData();
+
+      for (std::size_t j = 0; j < reference.size(); ++j)
+      {
+        if (std::abs(static_cast<double>(data[j]) - static_cast<double>(reference[j])) > tolerance)
+          ++numberOfDifferences;
+      }
+
+      numberOfPixels += reference.size();
+    }
+
+    MITK_INFO << volumeSize << "^3 volume, interpolator " << interpolator << ": "
+              << filterDuration.count() / numberOfPlanes << " s per slice, interpolate image function "
+              << referenceDuration.count() / numberOfPlanes << " s per slice";
+
+    return static_cast<double>(numberOfDifferences) / numberOfPixels;
+  }
+
+public:
+  // Results may only differ where a continuous index is rounded differently due to the order of operations
+  void NearestNeighborUnsignedChar()
+  {
+    CPPUNIT_ASSERT(CompareWithReference<unsigned char>(64, 4, mitk::ExtractSliceFilter2::NearestNeighbor, 0) < 1e-3);
+  }
+
+  void NearestNeighborShort()
+  {
+    CPPUNIT_ASSERT(CompareWithReference<short>(64, 4, mitk::ExtractSliceFilter2::NearestNeighbor, 0) < 1e-3);
+  }
+
+  // Integral results may differ by one due to truncation of slightly different interpolated values
+  void LinearUnsignedShort()
+  {
+    CPPUNIT_ASSERT(CompareWithReference<unsigned short>(64, 4, mitk::ExtractSliceFilter2::Linear, 1) < 1e-3);
+  }
+
+  void LinearFloat()
+  {
+    CPPUNIT_ASSERT(CompareWithReference<float>(64, 4, mitk::ExtractSliceFilter2::Linear, 1e-3) < 1e-3);
+  }
+
+  void BenchmarkLargeVolume()
+  {
+    CPPUNIT_ASSERT(CompareWithReference<unsigned char>(512, 8, mitk::ExtractSliceFilter2::NearestNeighbor, 0) < 1e-3);
+    CPPUNIT_ASSERT(CompareWithReference<unsigned char>(512, 8, mitk::ExtractSliceFilter2::Linear, 1) < 1e-3);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkExtractSliceFilter2)
@@ -0,0 +1,217 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkImage.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Checks that concurrent readers never observe a partially written slice and that writers only wait for overlapping
+ * readers. The throughput of the accessors is measured by the ImageAccessorBenchmark mini app.
+ */
+class mitkImageAccessorConcurrencyTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageAccessorConcurrencyTestSuite);
+  MITK_TEST(ConcurrentReadAccessors);
+  MITK_TEST(ConcurrentMixedAccessors);
+  MITK_TEST(ReadAccessorFollowedByWriteAccessorInSameThread);
+  MITK_TEST(WriteAccessorIgnoresDisjointReadersOfOtherThreads);
+  MITK_TEST(WriteAccessorWaitsForOverlappingReaderOfOtherThread);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_Image;
+
+  static const unsigned int NumberOfSlices = 16;
+  static const unsigned int NumberOfThreads = 8;
+  static const unsigned int AccessesPerThread = 200;
+
+  /** Runs the given function in NumberOfThreads threads */
+  template <typename TFunction>
+  void RunInThreads(TFunction function)
+  {
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < NumberOfThreads; ++i)
+    {
+      threads.emplace_back(function, i);
+    }
+
+    for (auto &thread : threads)
+    {
+      thread.join();
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = mitk::Image::New();
+    std::array<unsigned int, 4> dimensions = {{64, 64, NumberOfSlices, 2}};
+    m_Image->Initialize(mitk::MakeScalarPixelType<unsigned short>(), 4, dimensions.data());
+
+    mitk::ImageWriteAccessor accessor(m_Image);
+    std::fill_n(static_cast<unsigned short *>(accessor.GetData()), 64 * 64 * NumberOfSlices * 2, 0);
+  }
+
+  void tearDown() override { m_Image = nullptr; }
+
+  void ConcurrentReadAccessors()
+  {
+    std::atomic<unsigned int> failures(0);
+
+    RunInThreads([this, &failures](unsigned int threadId) {
+      for (unsigned int i = 0; i < AccessesPerThread; ++i)
+      {
+        try
+        {
+          mitk::ImageReadAccessor accessor(m_Image, m_Image->GetSliceData((threadId + i) % NumberOfSlices));
+          if (accessor.GetData() == nullptr)
+            ++failures;
+        }
+        catch (const mitk::Exception &)
+        {
+          ++failures;
+        }
+      }
+    });
+
+    CPPUNIT_ASSERT_EQUAL(0u, failures.load());
+  }
+
+  void ConcurrentMixedAccessors()
+  {
+    const unsigned int sliceSize = 64 * 64;
+    std::atomic<unsigned int> inconsistentReads(0);
+
+    RunInThreads([&, this](unsigned int threadId) {
+      for (unsigned int i = 0; i < AccessesPerThread; ++i)
+      {
+        auto slice = m_Image->GetSliceData((threadId * 7 + i) % NumberOfSlices);
+
+        // Every 16th access writes a whole slice with one value, all others check that the slice is uniform
+        if ((threadId + i) % 16 == 0)
+        {
+          mitk::ImageWriteAccessor accessor(m_Image, slice);
+          std::fill_n(static_cast<unsigned short *>(accessor.GetData()), sliceSize, threadId + i);
+        }
+        else
+        {
+          mitk::ImageReadAccessor accessor(m_Image, slice);
+          auto data = static_cast<const unsigned short *>(accessor.GetData());
+          if (std::any_of(data, data + sliceSize, [data](unsigned short value) { return value != data[0]; }))
+            ++inconsistentReads;
+        }
+      }
+    });
+
+    CPPUNIT_ASSERT_EQUAL(0u, inconsistentReads.load());
+  }
+
+  void ReadAccessorFollowedByWriteAccessorInSameThread()
+  {
+    // Non-overlapping parts may be read and written by the same thread
+    mitk::ImageReadAccessor readAccessor(m_Image, m_Image->GetSliceData(0));
+    mitk::ImageWriteAccessor writeAccessor(m_Image, m_Image->GetSliceData(1));
+    CPPUNIT_ASSERT(writeAccessor.GetData() != nullptr);
+
+    // Overlapping parts must not be locked recursively
+    CPPUNIT_ASSERT_THROW(mitk::ImageWriteAccessor(m_Image, m_Image->GetSliceData(0)), mitk::Exception);
+  }
+
+  /** Holds a read accessor of the given slice in another thread until Release() is called */
+  class ReaderThread
+  {
+  public:
+    ReaderThread(mitk::Image *image, unsigned int slice) : m_Acquired(false), m_Released(false)
+    {
+      m_Thread = std::thread([this, image, slice]() {
+        mitk::ImageReadAccessor accessor(image, image->GetSliceData(slice));
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Acquired = true;
+        m_Condition.notify_all();
+        m_Condition.wait(lock, [this]() { return m_Released; });
+      });
+
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_Condition.wait(lock, [this]() { return m_Acquired; });
+    }
+
+    void Release()
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Released = true;
+      }
+      m_Condition.notify_all();
+      m_Thread.join();
+    }
+
+  private:
+    std::thread m_Thread;
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    bool m_Acquired;
+    bool m_Released;
+  };
+
+  void WriteAccessorIgnoresDisjointReadersOfOtherThreads()
+  {
+    ReaderThread reader(m_Image, 0);
+
+    // The slices do not overlap, so neither waiting nor an exception is expected
+    mitk::ImageWriteAccessor writeAccessor(m_Image, m_Image->GetSliceData(1), mitk::ImageAccessorBase::ExceptionIfLocked);
+    CPPUNIT_ASSERT(writeAccessor.GetData() != nullptr);
+
+    reader.Release();
+  }
+
+  void WriteAccessorWaitsForOverlappingReaderOfOtherThread()
+  {
+    ReaderThread reader(m_Image, 2);
+
+    CPPUNIT_ASSERT_THROW(
+      mitk::ImageWriteAccessor(m_Image, m_Image->GetSliceData(2), mitk::ImageAccessorBase::ExceptionIfLocked),
+      mitk::MemoryIsLockedException);
+
+    std::atomic<bool> released(false);
+    std::atomic<bool> writtenAfterRelease(false);
+    std::thread writer([&, this]() {
+      mitk::ImageWriteAccessor writeAccessor(m_Image, m_Image->GetSliceData(2));
+      writtenAfterRelease = released.load();
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    released = true;
+    reader.Release();
+    writer.join();
+
+    CPPUNIT_ASSERT(writtenAfterRelease);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageAccessorConcurrency)
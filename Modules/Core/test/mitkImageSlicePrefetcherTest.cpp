@@ -0,0 +1,203 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkExtractSliceFilter.h>
+#include <mitkImageSlicePrefetcher.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <array>
+#include <cstring>
+#include <memory>
+
+class mitkImageSlicePrefetcherTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageSlicePrefetcherTestSuite);
+  MITK_TEST(PrefetchedSliceEqualsExtractedSlice);
+  MITK_TEST(ModifiedImageInvalidatesSlices);
+  MITK_TEST(DifferentSettingsDoNotMatch);
+  MITK_TEST(CancelDropsSlices);
+  MITK_TEST(RequestedPlanesAreCopied);
+  MITK_TEST(PrefetchersShareBackgroundThread);
+  MITK_TEST(BackgroundThreadIsRestarted);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  static const unsigned int Size = 32;
+
+  mitk::Image::Pointer m_Image;
+  mitk::ImageSlicePrefetcher::Settings m_Settings;
+
+  mitk::PlaneGeometry::Pointer CreatePlane(unsigned int slice)
+  {
+    auto plane = mitk::PlaneGeometry::New();
+    plane->InitializeStandardPlane(m_Image->GetGeometry(), mitk::PlaneGeometry::Axial, slice);
+    plane->SetReferenceGeometry(m_Image->GetGeometry());
+    return plane;
+  }
+
+  std::vector<mitk::PlaneGeometry::ConstPointer> CreatePlanes(unsigned int firstSlice, unsigned int numberOfSlices)
+  {
+    std::vector<mitk::PlaneGeometry::ConstPointer> planes;
+    for (unsigned int i = 0; i < numberOfSlices; ++i)
+    {
+      planes.push_back(CreatePlane(firstSlice + i).GetPointer());
+    }
+    return planes;
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = mitk::Image::New();
+    std::array<unsigned int, 3> dimensions = {{Size, Size, Size}};
+    m_Image->Initialize(mitk::MakeScalarPixelType<short>(), 3, dimensions.data());
+
+    mitk::ImageWriteAccessor accessor(m_Image);
+    auto data = static_cast<short *>(accessor.GetData());
+    for (unsigned int i = 0; i < Size * Size * Size; ++i)
+    {
+      data[i] = static_cast<short>(i % 1013);
+    }
+
+    m_Settings = mitk::ImageSlicePrefetcher::Settings();
+  }
+
+  void tearDown() override { m_Image = nullptr; }
+
+  void PrefetchedSliceEqualsExtractedSlice()
+  {
+    mitk::ImageSlicePrefetcher prefetcher;
+    prefetcher.Prefetch(m_Image, CreatePlanes(10, 4), m_Settings);
+    prefetcher.WaitUntilIdle();
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), prefetcher.GetNumberOfCachedSlices());
+    CPPUNIT_ASSERT(nullptr == prefetcher.GetSlice(m_Image, CreatePlane(9), m_Settings));
+
+    auto plane = CreatePlane(12);
+    auto slice = prefetcher.GetSlice(m_Image, plane, m_Settings);
+    CPPUNIT_ASSERT(nullptr != slice);
+
+    auto reslicer = mitk::ExtractSliceFilter::New();
+    reslicer->SetInput(m_Image);
+    reslicer->SetWorldGeometry(plane);
+    reslicer->SetResliceTransformByGeometry(m_Image->GetGeometry());
+    reslicer->SetVtkOutputRequest(true);
+    reslicer->UpdateLargestPossibleRegion();
+    auto expected = reslicer->GetVtkOutput();
+
+    CPPUNIT_ASSERT_EQUAL(expected->GetNumberOfPoints(), slice->m_Image->GetNumberOfPoints());
+    CPPUNIT_ASSERT_EQUAL(0,
+                         std::memcmp(expected->GetScalarPointer(),
+                                     slice->m_Image->GetScalarPointer(),
+                                     expected->GetNumberOfPoints() * sizeof(short)));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(reslicer->GetOutputSpacing()[0], slice->m_Spacing[0], mitk::eps);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(reslicer->GetOutputSpacing()[1], slice->m_Spacing[1], mitk::eps);
+  }
+
+  void ModifiedImageInvalidatesSlices()
+  {
+    mitk::ImageSlicePrefetcher prefetcher;
+    prefetcher.Prefetch(m_Image, CreatePlanes(0, 2), m_Settings);
+    prefetcher.WaitUntilIdle();
+    CPPUNIT_ASSERT(nullptr != prefetcher.GetSlice(m_Image, CreatePlane(1), m_Settings));
+
+    m_Image->Modified();
+    CPPUNIT_ASSERT(nullptr == prefetcher.GetSlice(m_Image, CreatePlane(1), m_Settings));
+
+    prefetcher.Prefetch(m_Image, CreatePlanes(1, 1), m_Settings);
+    prefetcher.WaitUntilIdle();
+    CPPUNIT_ASSERT(nullptr != prefetcher.GetSlice(m_Image, CreatePlane(1), m_Settings));
+  }
+
+  void DifferentSettingsDoNotMatch()
+  {
+    mitk::ImageSlicePrefetcher prefetcher;
+    prefetcher.Prefetch(m_Image, CreatePlanes(5, 1), m_Settings);
+    prefetcher.WaitUntilIdle();
+
+    auto settings = m_Settings;
+    settings.m_InterpolationMode = mitk::ExtractSliceFilter::RESLICE_LINEAR;
+    CPPUNIT_ASSERT(nullptr == prefetcher.GetSlice(m_Image, CreatePlane(5), settings));
+    CPPUNIT_ASSERT(nullptr != prefetcher.GetSlice(m_Image, CreatePlane(5), m_Settings));
+  }
+
+  void CancelDropsSlices()
+  {
+    mitk::ImageSlicePrefetcher prefetcher;
+    prefetcher.Prefetch(m_Image, CreatePlanes(0, Size), m_Settings);
+    prefetcher.Cancel();
+    prefetcher.WaitUntilIdle();
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), prefetcher.GetNumberOfCachedSlices());
+  }
+
+  void RequestedPlanesAreCopied()
+  {
+    auto planes = CreatePlanes(3, 2);
+    mitk::ImageSlicePrefetcher prefetcher;
+    prefetcher.Prefetch(m_Image, planes, m_Settings);
+
+    // the caller may change its planes while the slices are extracted
+    for (const auto &plane : planes)
+    {
+      const_cast<mitk::PlaneGeometry *>(plane.GetPointer())->SetOrigin(CreatePlane(20)->GetOrigin());
+    }
+    prefetcher.WaitUntilIdle();
+
+    CPPUNIT_ASSERT(nullptr != prefetcher.GetSlice(m_Image, CreatePlane(3), m_Settings));
+    CPPUNIT_ASSERT(nullptr != prefetcher.GetSlice(m_Image, CreatePlane(4), m_Settings));
+    CPPUNIT_ASSERT(nullptr == prefetcher.GetSlice(m_Image, CreatePlane(20), m_Settings));
+  }
+
+  void PrefetchersShareBackgroundThread()
+  {
+    std::vector<std::unique_ptr<mitk::ImageSlicePrefetcher>> prefetchers;
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+      prefetchers.emplace_back(new mitk::ImageSlicePrefetcher);
+      prefetchers.back()->Prefetch(m_Image, CreatePlanes(i, 3), m_Settings);
+    }
+
+    // prefetchers with pending requests can be destroyed at any time
+    prefetchers[0].reset();
+
+    for (unsigned int i = 1; i < prefetchers.size(); ++i)
+    {
+      prefetchers[i]->WaitUntilIdle();
+      CPPUNIT_ASSERT_EQUAL(std::size_t(3), prefetchers[i]->GetNumberOfCachedSlices());
+      CPPUNIT_ASSERT(nullptr != prefetchers[i]->GetSlice(m_Image, CreatePlane(i + 2), m_Settings));
+    }
+  }
+
+  void BackgroundThreadIsRestarted()
+  {
+    // the background thread is stopped with the last prefetcher, also while requests are pending
+    {
+      mitk::ImageSlicePrefetcher prefetcher;
+      prefetcher.Prefetch(m_Image, CreatePlanes(0, Size), m_Settings);
+    }
+
+    mitk::ImageSlicePrefetcher prefetcher;
+    prefetcher.Prefetch(m_Image, CreatePlanes(7, 2), m_Settings);
+    prefetcher.WaitUntilIdle();
+    CPPUNIT_ASSERT(nullptr != prefetcher.GetSlice(m_Image, CreatePlane(8), m_Settings));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageSlicePrefetcher)
@@ -0,0 +1,220 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkIOUtil.h>
+#include <mitkImage.h>
+#include <mitkImagePixelReadAccessor.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+#include <mitkMemoryMappedFile.h>
+
+#include <itkByteSwapper.h>
+
+#include <array>
+#include <cstdio>
+#include <fstream>
+
+class mitkMemoryMappedFileTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkMemoryMappedFileTestSuite);
+  MITK_TEST(MapUnalignedOffset);
+  MITK_TEST(MapTooLargeRegion);
+  MITK_TEST(ImageWithMappedChannel);
+  MITK_TEST(LoadRawNrrdMapped);
+  MITK_TEST(LoadVectorNrrdWithTrailingComponentAxis);
+  MITK_TEST(SaveMappedImageOverItsFile);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  static const unsigned int HeaderSize = 37;
+  static const unsigned int NumberOfValues = 8 * 8 * 4 * 3;
+
+  std::string m_FileName;
+  std::size_t m_OriginalThreshold;
+
+  void WriteFile(const std::string &header)
+  {
+    std::ofstream stream(m_FileName.c_str(), std::ios::binary | std::ios::trunc);
+    stream << header;
+    for (unsigned int i = 0; i < NumberOfValues; ++i)
+    {
+      unsigned short value = static_cast<unsigned short>(i);
+      stream.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+  }
+
+  unsigned short ReadValueFromFile(std::size_t offset, unsigned int index)
+  {
+    std::ifstream stream(m_FileName.c_str(), std::ios::binary);
+    stream.seekg(offset + index * sizeof(unsigned short));
+    unsigned short value = 0;
+    stream.read(reinterpret_cast<char *>(&value), sizeof(value));
+    return value;
+  }
+
+  std::string RawNrrdHeader(const std::string &layout = "dimension: 4\nsizes: 8 8 4 3\n")
+  {
+    std::string header = "NRRD0004\n"
+                         "# Complete NRRD file format specification at:\n"
+                         "type: unsigned short\n" +
+                         layout + "encoding: raw\n";
+    header += itk::ByteSwapper<unsigned short>::SystemIsBigEndian() ? "endian: big\n" : "endian: little\n";
+    header += "\n";
+    return header;
+  }
+
+public:
+  void setUp() override
+  {
+    m_FileName = mitk::IOUtil::CreateTemporaryFile("mappedXXXXXX.nrrd");
+    WriteFile(std::string(HeaderSize, 'x'));
+    m_OriginalThreshold = mitk::MemoryMappedFile::GetReaderThreshold();
+  }
+
+  void tearDown() override
+  {
+    mitk::MemoryMappedFile::SetReaderThreshold(m_OriginalThreshold);
+    std::remove(m_FileName.c_str());
+  }
+
+  void MapUnalignedOffset()
+  {
+    mitk::MemoryMappedFile mappedFile(m_FileName, HeaderSize, NumberOfValues * sizeof(unsigned short));
+    auto data = static_cast<unsigned short *>(mappedFile.GetData());
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(NumberOfValues * sizeof(unsigned short)), mappedFile.GetLength());
+    for (unsigned int i = 0; i < NumberOfValues; ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL(static_cast<unsigned short>(i), data[i]);
+    }
+
+    // The mapping is private, changes must not reach the file
+    data[5] = 1000;
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned short>(5), ReadValueFromFile(HeaderSize, 5));
+  }
+
+  void MapTooLargeRegion()
+  {
+    CPPUNIT_ASSERT_THROW(mitk::MemoryMappedFile(m_FileName, HeaderSize, NumberOfValues * sizeof(unsigned short) + 1),
+                         mitk::Exception);
+    CPPUNIT_ASSERT_THROW(mitk::MemoryMappedFile(m_FileName + ".missing", 0, 1), mitk::Exception);
+  }
+
+  void ImageWithMappedChannel()
+  {
+    auto image = mitk::Image::New();
+    std::array<unsigned int, 4> dimensions = {{8, 8, 4, 3}};
+    image->Initialize(mitk::MakeScalarPixelType<unsigned short>(), 4, dimensions.data());
+
+    auto mappedFile =
+      std::make_shared<mitk::MemoryMappedFile>(m_FileName, HeaderSize, NumberOfValues * sizeof(unsigned short));
+    CPPUNIT_ASSERT(image->SetMappedChannel(mappedFile));
+
+    // Volumes and slices reference the mapped memory
+    mitk::ImagePixelReadAccessor<unsigned short, 3> volumeAccessor(image, image->GetVolumeData(2));
+    itk::Index<3> index = {{1, 2, 3}};
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned short>(2 * 256 + 3 * 64 + 2 * 8 + 1),
+                         volumeAccessor.GetPixelByIndex(index));
+
+    {
+      mitk::ImageWriteAccessor writeAccessor(image, image->GetSliceData(0, 1));
+      static_cast<unsigned short *>(writeAccessor.GetData())[0] = 4711;
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned short>(256), ReadValueFromFile(HeaderSize, 256));
+
+    // Too small mappings are rejected
+    auto smallMappedFile = std::make_shared<mitk::MemoryMappedFile>(m_FileName, HeaderSize, 16);
+    CPPUNIT_ASSERT(!image->SetMappedChannel(smallMappedFile));
+  }
+
+  void LoadRawNrrdMapped()
+  {
+    WriteFile(RawNrrdHeader());
+
+    mitk::MemoryMappedFile::SetReaderThreshold(0);
+    auto image = mitk::IOUtil::Load<mitk::Image>(m_FileName);
+
+    CPPUNIT_ASSERT_EQUAL(3u, image->GetDimension(3));
+    mitk::ImagePixelReadAccessor<unsigned short, 3> accessor(image, image->GetVolumeData(1));
+    itk::Index<3> index = {{7, 6, 2}};
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned short>(256 + 2 * 64 + 6 * 8 + 7), accessor.GetPixelByIndex(index));
+  }
+
+  void LoadVectorNrrdWithTrailingComponentAxis()
+  {
+    // The components are stored on the last axis, which does not match the interleaved layout of mitk::Image
+    WriteFile(RawNrrdHeader("dimension: 3\nsizes: 16 16 3\nkinds: domain domain vector\n"));
+
+    mitk::MemoryMappedFile::SetReaderThreshold(0);
+    auto image = mitk::IOUtil::Load<mitk::Image>(m_FileName);
+
+    CPPUNIT_ASSERT_EQUAL(3u, image->GetPixelType().GetNumberOfComponents());
+    mitk::ImageReadAccessor accessor(image);
+    auto data = static_cast<const unsigned short *>(accessor.GetData());
+    for (unsigned int pixel = 0; pixel < 16 * 16; ++pixel)
+    {
+      for (unsigned int component = 0; component < 3; ++component)
+      {
+        CPPUNIT_ASSERT_EQUAL(static_cast<unsigned short>(component * 16 * 16 + pixel), data[pixel * 3 + component]);
+      }
+    }
+  }
+
+  void SaveMappedImageOverItsFile()
+  {
+    WriteFile(RawNrrdHeader());
+
+    mitk::MemoryMappedFile::SetReaderThreshold(0);
+    auto image = mitk::IOUtil::Load<mitk::Image>(m_FileName);
+    {
+      mitk::ImageWriteAccessor writeAccessor(image, image->GetVolumeData(2));
+      static_cast<unsigned short *>(writeAccessor.GetData())[3] = 4711;
+    }
+
+    // The writer replaces the file the image data is still mapped from
+    mitk::MemoryMappedFile::SetReaderThreshold(m_OriginalThreshold);
+#ifdef _WIN32
+    // Windows does not allow writing to a mapped file
+    CPPUNIT_ASSERT_THROW(mitk::IOUtil::Save(image, m_FileName), mitk::Exception);
+#else
+    mitk::IOUtil::Save(image, m_FileName);
+
+    // The mapped data can still be written, the saved file is not affected
+    {
+      mitk::ImageWriteAccessor writeAccessor(image, image->GetVolumeData(1));
+      static_cast<unsigned short *>(writeAccessor.GetData())[5] = 815;
+    }
+
+    mitk::ImagePixelReadAccessor<unsigned short, 4> mappedAccessor(image);
+    auto reloadedImage = mitk::IOUtil::Load<mitk::Image>(m_FileName);
+    mitk::ImagePixelReadAccessor<unsigned short, 4> reloadedAccessor(reloadedImage);
+
+    CPPUNIT_ASSERT_EQUAL(3u, reloadedImage->GetDimension(3));
+    for (unsigned int i = 0; i < NumberOfValues; ++i)
+    {
+      const unsigned short expected = i == 2 * 256 + 3 ? 4711 : static_cast<unsigned short>(i);
+      CPPUNIT_ASSERT_EQUAL(i == 256 + 5 ? static_cast<unsigned short>(815) : expected,
+                           static_cast<const unsigned short *>(mappedAccessor.GetData())[i]);
+      CPPUNIT_ASSERT_EQUAL(expected, static_cast<const unsigned short *>(reloadedAccessor.GetData())[i]);
+    }
+#endif
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkMemoryMappedFile)
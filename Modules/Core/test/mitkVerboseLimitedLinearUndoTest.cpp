@@ -36,6 +36,16 @@ namespace mitk
     TestOperation(OperationType operationType) : Operation(operationType) { g_GlobalCounter++; };
     ~TestOperation() override { g_GlobalCounter--; };
   };
+
+  /**
+  * @brief Operation that claims one megabyte of memory to check the memory limit of the undo history
+  **/
+  class LargeTestOperation : public TestOperation
+  {
+  public:
+    LargeTestOperation(OperationType operationType) : TestOperation(operationType){};
+    std::size_t GetMemorySize() const override { return 1024 * 1024; };
+  };
 } // namespace
 
 /**
@@ -111,6 +121,29 @@ int mitkVerboseLimitedLinearUndoTest(int /* argc */, char * /*argv*/ [])
   myUndoController->Clear();
   MITK_TEST_CONDITION_REQUIRED(g_GlobalCounter == 0, "checking deleting all operations in UndoModel");
 
+  // the memory limit is applied to the current undo model
+  mitk::UndoController::SetMemoryLimit(5 * 1024 * 1024);
+  auto *limitedLinearUndo = dynamic_cast<mitk::LimitedLinearUndo *>(myUndoController->GetCurrentUndoModel());
+  MITK_TEST_CONDITION_REQUIRED(limitedLinearUndo != nullptr && limitedLinearUndo->GetMemoryLimit() == 5 * 1024 * 1024,
+                               "checking memory limit of the UndoModel");
+
+  // two groups of two and one OperationEvents with 2 MB each, the first group is dropped as a whole
+  for (int i = 0; i < 3; i++)
+  {
+    if (2 == i)
+      mitk::OperationEvent::IncCurrGroupEventId();
+
+    auto doOp = new mitk::LargeTestOperation(mitk::OpTEST);
+    auto undoOp = new mitk::LargeTestOperation(mitk::OpTEST);
+    mitk::OperationEvent *operationEvent = new mitk::OperationEvent(nullptr, doOp, undoOp, "Test");
+    myUndoController->SetOperationEvent(operationEvent);
+    mitk::OperationEvent::IncCurrObjectEventId();
+  }
+  MITK_TEST_CONDITION_REQUIRED(g_GlobalCounter == 2, "checking dropping whole groups at the memory limit");
+
+  myUndoController->Clear();
+  mitk::UndoController::SetMemoryLimit(0);
+
   // sending two new OperationEvents
   for (int i = 0; i < 2; i++)
   {
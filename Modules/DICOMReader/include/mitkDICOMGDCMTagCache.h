@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <set>
 #include <memory>
+#include <vector>
 
 #include <gdcmScanner.h>
 
@@ -46,7 +47,19 @@ namespace mitk
       DICOMDatasetAccessingImageFrameList GetFrameInfoList() const override;
 
       void InitCache(const std::set<DICOMTag>& scannedTags, const std::shared_ptr<gdcm::Scanner>& scanner, const StringList& inputFiles);
-
+      /**
+        \brief Initialize the cache from several scanners that each scanned a
+        contiguous part of inputFiles, given in the order of inputFiles.
+        All scanners are kept alive by the cache because the frame infos
+        reference the tag values stored in them.
+        \param cachedFrames Optional frame infos of files that were not scanned
+        (e.g. taken from a DICOMPersistentTagCache), one entry per input file.
+        The scanners only cover the input files whose entry is nullptr.
+      */
+      void InitCache(const std::set<DICOMTag>& scannedTags, const std::vector<std::shared_ptr<gdcm::Scanner>>& scanners, const StringList& inputFiles,
+        const DICOMDatasetAccessingImageFrameList& cachedFrames = DICOMDatasetAccessingImageFrameList());
+
+      /** \brief Returns the first scanner the cache was initialized with. */
       const gdcm::Scanner& GetScanner() const;
 
   protected:
@@ -56,7 +69,7 @@ namespace mitk
 
       std::set<DICOMTag> m_ScannedTags;
 
-      std::shared_ptr<gdcm::Scanner> m_Scanner;
+      std::vector<std::shared_ptr<gdcm::Scanner>> m_Scanners;
 
       DICOMDatasetAccessingImageFrameList m_ScanResult;
 
@@ -0,0 +1,137 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkDICOMPersistentTagCache_h
+#define mitkDICOMPersistentTagCache_h
+
+#include <itkObject.h>
+
+#include "mitkCommon.h"
+#include "mitkDICOMTagPath.h"
+#include "mitkDICOMGenericImageFrameInfo.h"
+
+#include "MitkDICOMReaderExports.h"
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace mitk
+{
+
+  /**
+    \ingroup DICOMReaderModule
+    \brief Stores tag scan results of DICOM files in a compact binary file
+    so that re-opening the same files does not require scanning them again.
+
+    Entries are keyed by the name of the scanner class and the file path.
+    An entry is only used if size and modification time of the file are
+    unchanged and if it covers all tag paths requested by the scanner.
+    Otherwise the scanner reads the file and updates the entry.
+
+    DICOMTagScanner instances consult the cache given by
+    DICOMTagScanner::SetPersistentCache(). Scanners that are created
+    internally (e.g. by DICOMITKSeriesGDCMReader or DICOMFileReaderSelector)
+    use the default cache set via DICOMTagScanner::SetDefaultPersistentCache().
+
+    The cache file is loaded on first use and written by Save(). All methods
+    are thread-safe, so one instance can be shared by several scanners.
+
+    @remark Modification times have a resolution of one second. A file that is
+    rewritten with the same size within the second it was scanned is not detected.
+  */
+  class MITKDICOMREADER_EXPORT DICOMPersistentTagCache : public itk::Object
+  {
+    public:
+
+      mitkClassMacroItkParent(DICOMPersistentTagCache, itk::Object);
+      itkFactorylessNewMacro( DICOMPersistentTagCache );
+
+      typedef std::set<DICOMTagPath> TagPathSetType;
+
+      /**
+        \brief File the cache is loaded from and saved to.
+        Changing the file discards all entries that are currently held in memory.
+      */
+      void SetCacheFile(const std::string& cacheFile);
+      std::string GetCacheFile() const;
+
+      /**
+        \brief Return the cached scan result of a file or nullptr if the file
+        has to be (re-)scanned.
+        \param scannerName Name of the scanner class, scanners differ in how they report values.
+        \param filename Path of the scanned file.
+        \param tagPaths Tag paths the scanner was asked for.
+      */
+      DICOMGenericImageFrameInfo::Pointer Lookup(const std::string& scannerName, const std::string& filename, const TagPathSetType& tagPaths);
+
+      /**
+        \brief Remember the scan result of a file.
+        All valid findings of info for the given tag paths are stored. If the file
+        is unchanged since it was last stored, the entry is extended, otherwise replaced.
+      */
+      void Store(const std::string& scannerName, const std::string& filename, const TagPathSetType& tagPaths, const DICOMDatasetAccess& info);
+
+      /**
+        \brief Write all entries to the cache file, if anything changed since the last load or save.
+        Failures are reported as warnings, the in-memory entries stay valid.
+      */
+      void Save();
+
+      /** \brief Forget all entries. The cache file is not touched until the next Save(). */
+      void Clear();
+
+      /** \brief Number of Lookup() calls answered from the cache. */
+      unsigned long GetNumberOfHits() const;
+      /** \brief Number of Lookup() calls that required a scan. */
+      unsigned long GetNumberOfMisses() const;
+
+    protected:
+
+      DICOMPersistentTagCache();
+      ~DICOMPersistentTagCache() override;
+
+      struct Entry
+      {
+        unsigned long long FileSize = 0;
+        long long ModificationTime = 0;
+        TagPathSetType TagPaths;
+        std::vector<std::pair<DICOMTagPath, std::string>> Values;
+      };
+
+      typedef std::pair<std::string, std::string> KeyType;
+      typedef std::map<KeyType, Entry> EntryMapType;
+
+      void Load_unlocked();
+
+      mutable std::mutex m_Mutex;
+
+      std::string m_CacheFile;
+      EntryMapType m_Entries;
+      bool m_Loaded;
+      bool m_Modified;
+
+      unsigned long m_NumberOfHits;
+      unsigned long m_NumberOfMisses;
+
+    private:
+      DICOMPersistentTagCache(const DICOMPersistentTagCache&);
+  };
+}
+
+#endif
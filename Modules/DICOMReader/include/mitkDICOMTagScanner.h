@@ -17,13 +17,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 #ifndef mitkDICOMTagScanner_h
 #define mitkDICOMTagScanner_h
 
+#include <functional>
 #include <stack>
+#include <utility>
+#include <vector>
 #include "itkMutexLock.h"
 
 #include "mitkDICOMEnums.h"
 #include "mitkDICOMTagPath.h"
 #include "mitkDICOMTagCache.h"
 #include "mitkDICOMDatasetAccessingImageFrameInfo.h"
+#include "mitkDICOMPersistentTagCache.h"
 
 namespace mitk
 {
@@ -90,8 +94,59 @@ namespace mitk
       */
       virtual DICOMTagCache::Pointer GetScanCache() const = 0;
 
+      /**
+        \brief Maximum number of threads used by Scan().
+        The input files are split into contiguous partitions that are scanned
+        concurrently; the results are merged in the order of the input files.
+        Defaults to the number of hardware threads. A value of 1 enforces a
+        sequential scan.
+      */
+      itkSetMacro(NumberOfThreads, unsigned int);
+      itkGetConstMacro(NumberOfThreads, unsigned int);
+
+      /**
+        \brief Persistent cache that Scan() consults before reading a file.
+        Only files that are not in the cache, or whose size or modification time
+        changed, are scanned; their results are added to the cache, which is saved
+        at the end of Scan(). Initialized with GetDefaultPersistentCache(), set to
+        nullptr to always scan all files.
+      */
+      itkSetObjectMacro(PersistentCache, DICOMPersistentTagCache);
+      itkGetObjectMacro(PersistentCache, DICOMPersistentTagCache);
+
+      /**
+        \brief Persistent cache used by all scanners created afterwards.
+        Allows to enable the cache for scanners that are created inside of
+        readers, e.g. DICOMITKSeriesGDCMReader or DICOMFileReaderSelector.
+      */
+      static void SetDefaultPersistentCache(DICOMPersistentTagCache* cache);
+      static DICOMPersistentTagCache::Pointer GetDefaultPersistentCache();
+
     protected:
 
+      /** Half-open index range [first, second) into the list of input files. */
+      using FileRange = std::pair<std::size_t, std::size_t>;
+
+      /**
+      \brief Split the indices of numberOfFiles input files into contiguous ranges,
+      one per scan thread. Lists too small to profit from threading are not split.
+      */
+      std::vector<FileRange> PartitionInputFiles(std::size_t numberOfFiles) const;
+      /**
+      \brief Call scanPartition(partitionIndex, range) for every range, each on its own thread.
+      Blocks until all partitions are done. The first exception thrown by any
+      partition is rethrown in the calling thread.
+      */
+      static void ScanPartitions(const std::vector<FileRange>& partitions,
+        const std::function<void(std::size_t, const FileRange&)>& scanPartition);
+
+      /**
+      \brief Look up all files in the persistent cache (if any).
+      Returns one entry per file, entries of files that have to be scanned are nullptr.
+      */
+      DICOMDatasetAccessingImageFrameList LookupPersistentCache(const StringList& filenames,
+        const DICOMPersistentTagCache::TagPathSetType& tagPaths) const;
+
       /** \brief Return active C locale */
       static std::string GetActiveLocale();
       /**
@@ -108,6 +163,9 @@ namespace mitk
       DICOMTagScanner();
       ~DICOMTagScanner() override;
 
+      unsigned int m_NumberOfThreads;
+      DICOMPersistentTagCache::Pointer m_PersistentCache;
+
     private:
 
       static itk::MutexLock::Pointer s_LocaleMutex;
@@ -108,57 +108,117 @@ void mitk::DICOMDCMTKTagScanner::Scan()
 
   try
   {
-    DcmPathProcessor processor;
-    processor.setItemWildcardSupport(true);
+    std::vector<std::string> searchPaths;
+    searchPaths.reserve(this->m_ScannedTags.size());
+    for (const auto& path : this->m_ScannedTags)
+    {
+      searchPaths.push_back(DICOMTagPathToDCMTKSearchPath(path));
+    }
 
-    DICOMGenericTagCache::Pointer newCache = DICOMGenericTagCache::New();
+    const DICOMDatasetAccessingImageFrameList cachedFrames = this->LookupPersistentCache(this->m_InputFilenames, this->m_ScannedTags);
 
-    for (const auto& fileName : this->m_InputFilenames)
+    std::vector<std::size_t> filesToScan;
+    for (std::size_t i = 0; i < cachedFrames.size(); ++i)
     {
-      DcmFileFormat dfile;
-      OFCondition cond = dfile.loadFile(fileName.c_str());
-      if (cond.bad())
+      if (cachedFrames[i].IsNull())
       {
-        MITK_ERROR << "Error when scanning for tags. Cannot open given file. File: " << fileName;
+        filesToScan.push_back(i);
       }
-      else
+    }
+
+    const auto partitions = this->PartitionInputFiles(filesToScan.size());
+    std::vector<std::vector<DICOMGenericImageFrameInfo::Pointer>> partitionResults(partitions.size());
+
+    ScanPartitions(partitions, [&](std::size_t index, const FileRange& range)
+    {
+      DcmPathProcessor processor;
+      processor.setItemWildcardSupport(true);
+
+      auto& results = partitionResults[index];
+      results.reserve(range.second - range.first);
+
+      for (auto scanIndex = range.first; scanIndex < range.second; ++scanIndex)
       {
-        DICOMGenericImageFrameInfo::Pointer info = DICOMGenericImageFrameInfo::New(fileName);
+        const auto& fileName = this->m_InputFilenames[filesToScan[scanIndex]];
 
-        for (const auto& path : this->m_ScannedTags)
+        // Values longer than DCM_MaxReadLength (e.g. pixel data) are skipped
+        // while parsing and only loaded if they are accessed later on.
+        DcmFileFormat dfile;
+        OFCondition cond = dfile.loadFile(fileName.c_str(), EXS_Unknown, EGL_noChange, DCM_MaxReadLength);
+        if (cond.bad())
+        {
+          MITK_ERROR << "Error when scanning for tags. Cannot open given file. File: " << fileName;
+        }
+        else
         {
-          std::string tagPath = DICOMTagPathToDCMTKSearchPath(path);
-          cond = processor.findOrCreatePath(dfile.getDataset(), tagPath.c_str());
-          if (cond.good())
+          DICOMGenericImageFrameInfo::Pointer info = DICOMGenericImageFrameInfo::New(fileName);
+
+          for (const auto& tagPath : searchPaths)
           {
-            OFList< DcmPath * > findings;
-            processor.getResults(findings);
-            for (const auto& finding : findings)
+            cond = processor.findOrCreatePath(dfile.getDataset(), tagPath.c_str());
+            if (cond.good())
             {
-              auto element = dynamic_cast<DcmElement*>(finding->back()->m_obj);
-              if (!element)
+              OFList< DcmPath * > findings;
+              processor.getResults(findings);
+              for (const auto& finding : findings)
               {
-                auto item = dynamic_cast<DcmItem*>(finding->back()->m_obj);
-                if (item)
+                auto element = dynamic_cast<DcmElement*>(finding->back()->m_obj);
+                if (!element)
                 {
-                  element = item->getElement(finding->back()->m_itemNo);
+                  auto item = dynamic_cast<DcmItem*>(finding->back()->m_obj);
+                  if (item)
+                  {
+                    element = item->getElement(finding->back()->m_itemNo);
+                  }
                 }
-              }
 
-              if (element)
-              {
-                OFString value;
-                cond = element->getOFStringArray(value);
-                if (cond.good())
+                if (element)
                 {
-                  info->SetTagValue(DcmPathToTagPath(finding), std::string(value.c_str()));
+                  OFString value;
+                  cond = element->getOFStringArray(value);
+                  if (cond.good())
+                  {
+                    info->SetTagValue(DcmPathToTagPath(finding), std::string(value.c_str()));
+                  }
                 }
               }
             }
           }
+          results.push_back(info);
         }
-        newCache->AddFrameInfo(info);
       }
+    });
+
+    // merge cached and scanned frames in input order; unreadable files have no frame
+    std::vector<DICOMGenericImageFrameInfo::Pointer> scannedFrames;
+    scannedFrames.reserve(filesToScan.size());
+    for (const auto& results : partitionResults)
+    {
+      scannedFrames.insert(scannedFrames.end(), results.cbegin(), results.cend());
+    }
+
+    DICOMGenericTagCache::Pointer newCache = DICOMGenericTagCache::New();
+    auto scannedIter = scannedFrames.cbegin();
+    for (std::size_t i = 0; i < cachedFrames.size(); ++i)
+    {
+      if (cachedFrames[i].IsNotNull())
+      {
+        newCache->AddFrameInfo(cachedFrames[i]);
+      }
+      else if (scannedIter != scannedFrames.cend() && (*scannedIter)->Filename == this->m_InputFilenames[i])
+      {
+        newCache->AddFrameInfo(*scannedIter);
+        if (m_PersistentCache.IsNotNull())
+        {
+          m_PersistentCache->Store(this->GetNameOfClass(), this->m_InputFilenames[i], this->m_ScannedTags, **scannedIter);
+        }
+        ++scannedIter;
+      }
+    }
+
+    if (m_PersistentCache.IsNotNull() && !scannedFrames.empty())
+    {
+      m_PersistentCache->Save();
     }
 
     m_Cache = newCache;
@@ -89,7 +89,7 @@ mitk::DICOMGDCMTagCache::InitCache(const std::set<DICOMTag>& scannedTags, const
 {
   m_ScannedTags = scannedTags;
   m_InputFilenames = inputFiles;
-  m_Scanner = scanner;
+  m_Scanners.assign(1, scanner);
 
   m_ScanResult.clear();
   m_ScanResult.reserve(m_InputFilenames.size());
@@ -97,12 +97,60 @@ mitk::DICOMGDCMTagCache::InitCache(const std::set<DICOMTag>& scannedTags, const
   for (auto inputIter = m_InputFilenames.cbegin(); inputIter != m_InputFilenames.cend(); ++inputIter)
   {
     m_ScanResult.push_back(DICOMGDCMImageFrameInfo::New(DICOMImageFrameInfo::New(*inputIter, 0),
-      m_Scanner->GetMapping(inputIter->c_str())).GetPointer());
+      scanner->GetMapping(inputIter->c_str())).GetPointer());
+  }
+}
+
+void
+mitk::DICOMGDCMTagCache::InitCache(const std::set<DICOMTag>& scannedTags, const std::vector<std::shared_ptr<gdcm::Scanner>>& scanners, const StringList& inputFiles,
+  const DICOMDatasetAccessingImageFrameList& cachedFrames)
+{
+  if (!cachedFrames.empty() && cachedFrames.size() != inputFiles.size())
+  {
+    mitkThrow() << "Invalid call to DICOMGDCMTagCache::InitCache(). Number of cached frames does not match the number of input files.";
+  }
+
+  m_ScannedTags = scannedTags;
+  m_InputFilenames = inputFiles;
+  m_Scanners = scanners;
+
+  m_ScanResult.clear();
+  m_ScanResult.reserve(m_InputFilenames.size());
+
+  auto scannerIter = m_Scanners.cbegin();
+  std::size_t scannedFileIndex = 0;
+
+  for (std::size_t i = 0; i < m_InputFilenames.size(); ++i)
+  {
+    if (!cachedFrames.empty() && cachedFrames[i].IsNotNull())
+    {
+      m_ScanResult.push_back(cachedFrames[i]);
+      continue;
+    }
+
+    while (scannerIter != m_Scanners.cend() && scannedFileIndex >= (*scannerIter)->GetFilenames().size())
+    {
+      ++scannerIter;
+      scannedFileIndex = 0;
+    }
+
+    if (scannerIter == m_Scanners.cend() || (*scannerIter)->GetFilenames()[scannedFileIndex] != m_InputFilenames[i])
+    {
+      mitkThrow() << "Invalid call to DICOMGDCMTagCache::InitCache(). Scanners did not scan the input file " << m_InputFilenames[i];
+    }
+
+    m_ScanResult.push_back(DICOMGDCMImageFrameInfo::New(DICOMImageFrameInfo::New(m_InputFilenames[i], 0),
+      (*scannerIter)->GetMapping(m_InputFilenames[i].c_str())).GetPointer());
+    ++scannedFileIndex;
   }
 }
 
 const gdcm::Scanner&
 mitk::DICOMGDCMTagCache::GetScanner() const
 {
-  return *(this->m_Scanner);
+  if (m_Scanners.empty())
+  {
+    mitkThrow() << "Invalid call to DICOMGDCMTagCache::GetScanner(). Cache was not initialized.";
+  }
+  return *(this->m_Scanners.front());
 }
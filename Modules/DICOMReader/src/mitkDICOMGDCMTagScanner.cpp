@@ -97,10 +97,54 @@ void mitk::DICOMGDCMTagScanner::SetInputFiles( const StringList& filenames )
 void mitk::DICOMGDCMTagScanner::Scan()
 {
   // TODO integrate push/pop locale??
-  m_GDCMScanner->Scan( m_InputFilenames );
+  const DICOMPersistentTagCache::TagPathSetType scannedPaths(m_ScannedTags.cbegin(), m_ScannedTags.cend());
+  const DICOMDatasetAccessingImageFrameList cachedFrames = this->LookupPersistentCache(m_InputFilenames, scannedPaths);
+
+  StringList filesToScan;
+  for (std::size_t i = 0; i < m_InputFilenames.size(); ++i)
+  {
+    if (cachedFrames[i].IsNull())
+    {
+      filesToScan.push_back(m_InputFilenames[i]);
+    }
+  }
+
+  const auto partitions = this->PartitionInputFiles(filesToScan.size());
+
+  // gdcm::Scanner reads each file only up to the last tag of interest,
+  // so the partitions only need their own scanner to run concurrently.
+  std::vector<std::shared_ptr<gdcm::Scanner>> scanners(partitions.size());
+  scanners.front() = m_GDCMScanner;
+  for (std::size_t i = 1; i < scanners.size(); ++i)
+  {
+    scanners[i] = std::make_shared<gdcm::Scanner>();
+    for (const auto& tag : m_ScannedTags)
+    {
+      scanners[i]->AddTag(gdcm::Tag(tag.GetGroup(), tag.GetElement()));
+    }
+  }
+
+  ScanPartitions(partitions, [&](std::size_t index, const FileRange& range)
+  {
+    const StringList partitionFiles(filesToScan.cbegin() + range.first, filesToScan.cbegin() + range.second);
+    scanners[index]->Scan(partitionFiles);
+  });
 
   DICOMGDCMTagCache::Pointer newCache = DICOMGDCMTagCache::New();
-  newCache->InitCache(m_ScannedTags, m_GDCMScanner, m_InputFilenames);
+  newCache->InitCache(m_ScannedTags, scanners, m_InputFilenames, cachedFrames);
+
+  if (m_PersistentCache.IsNotNull() && !filesToScan.empty())
+  {
+    const DICOMDatasetAccessingImageFrameList frames = newCache->GetFrameInfoList();
+    for (std::size_t i = 0; i < frames.size(); ++i)
+    {
+      if (cachedFrames[i].IsNull())
+      {
+        m_PersistentCache->Store(this->GetNameOfClass(), m_InputFilenames[i], scannedPaths, *(frames[i]));
+      }
+    }
+    m_PersistentCache->Save();
+  }
 
   m_Cache = newCache;
 }
@@ -0,0 +1,420 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkDICOMPersistentTagCache.h"
+#include "mitkExceptionMacro.h"
+#include "mitkIOUtil.h"
+
+#include <itksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace
+{
+  // "MITK DICOM tag cache", followed by the format version
+  const char Magic[8] = { 'M', 'I', 'T', 'K', 'D', 'T', 'C', '\0' };
+  const std::uint32_t FormatVersion = 1;
+
+  struct FileStamp
+  {
+    bool Exists;
+    unsigned long long FileSize;
+    long long ModificationTime;
+  };
+
+  FileStamp GetFileStamp(const std::string& filename)
+  {
+    FileStamp stamp = { false, 0, 0 };
+    if (itksys::SystemTools::FileExists(filename.c_str(), true))
+    {
+      stamp.Exists = true;
+      stamp.FileSize = itksys::SystemTools::FileLength(filename.c_str());
+      stamp.ModificationTime = itksys::SystemTools::ModifiedTime(filename.c_str());
+    }
+    return stamp;
+  }
+
+  template <typename T>
+  void WriteValue(std::ostream& stream, T value)
+  {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  T ReadValue(std::istream& stream)
+  {
+    T value = T();
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!stream)
+    {
+      mitkThrow() << "Unexpected end of DICOM tag cache file.";
+    }
+    return value;
+  }
+
+  void WriteString(std::ostream& stream, const std::string& value)
+  {
+    WriteValue<std::uint32_t>(stream, static_cast<std::uint32_t>(value.size()));
+    stream.write(value.data(), value.size());
+  }
+
+  /** Returns the number of bytes between the read position and streamSize */
+  std::uint64_t GetRemainingSize(std::istream& stream, std::uint64_t streamSize)
+  {
+    const auto position = stream.tellg();
+    if (position < 0 || static_cast<std::uint64_t>(position) > streamSize)
+    {
+      mitkThrow() << "Invalid read position in DICOM tag cache file.";
+    }
+    return streamSize - static_cast<std::uint64_t>(position);
+  }
+
+  std::string ReadString(std::istream& stream, std::uint64_t streamSize)
+  {
+    const auto size = ReadValue<std::uint32_t>(stream);
+    if (size > GetRemainingSize(stream, streamSize))
+    {
+      mitkThrow() << "String exceeds the size of the DICOM tag cache file.";
+    }
+
+    std::string value(size, '\0');
+    stream.read(&value[0], value.size());
+    if (!stream)
+    {
+      mitkThrow() << "Unexpected end of DICOM tag cache file.";
+    }
+    return value;
+  }
+
+  void WritePath(std::ostream& stream, const mitk::DICOMTagPath& path)
+  {
+    WriteValue<std::uint32_t>(stream, static_cast<std::uint32_t>(path.Size()));
+    for (const auto& node : path.GetNodes())
+    {
+      WriteValue<std::uint8_t>(stream, static_cast<std::uint8_t>(node.type));
+      WriteValue<std::uint16_t>(stream, static_cast<std::uint16_t>(node.tag.GetGroup()));
+      WriteValue<std::uint16_t>(stream, static_cast<std::uint16_t>(node.tag.GetElement()));
+      WriteValue<std::int32_t>(stream, static_cast<std::int32_t>(node.selection));
+    }
+  }
+
+  mitk::DICOMTagPath ReadPath(std::istream& stream)
+  {
+    mitk::DICOMTagPath path;
+    const auto numberOfNodes = ReadValue<std::uint32_t>(stream);
+    for (std::uint32_t i = 0; i < numberOfNodes; ++i)
+    {
+      const auto type = ReadValue<std::uint8_t>(stream);
+      const auto group = ReadValue<std::uint16_t>(stream);
+      const auto element = ReadValue<std::uint16_t>(stream);
+      const auto selection = ReadValue<std::int32_t>(stream);
+
+      if (type > static_cast<std::uint8_t>(mitk::DICOMTagPath::NodeInfo::NodeType::AnyElement))
+      {
+        mitkThrow() << "Invalid tag path node in DICOM tag cache file.";
+      }
+
+      path.AddNode(mitk::DICOMTagPath::NodeInfo(mitk::DICOMTag(group, element),
+        static_cast<mitk::DICOMTagPath::NodeInfo::NodeType>(type), selection));
+    }
+    return path;
+  }
+
+  /** Replaces target by source in one step, so that other processes see either the old or the new file */
+  bool ReplaceFile(const std::string& source, const std::string& target)
+  {
+#ifdef _WIN32
+    return MoveFileExA(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(source.c_str(), target.c_str()) == 0;
+#endif
+  }
+}
+
+mitk::DICOMPersistentTagCache::DICOMPersistentTagCache()
+  : m_Loaded(false),
+    m_Modified(false),
+    m_NumberOfHits(0),
+    m_NumberOfMisses(0)
+{
+}
+
+mitk::DICOMPersistentTagCache::~DICOMPersistentTagCache()
+{
+}
+
+void mitk::DICOMPersistentTagCache::SetCacheFile(const std::string& cacheFile)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  if (cacheFile != m_CacheFile)
+  {
+    m_CacheFile = cacheFile;
+    m_Entries.clear();
+    m_Loaded = false;
+    m_Modified = false;
+    this->Modified();
+  }
+}
+
+std::string mitk::DICOMPersistentTagCache::GetCacheFile() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_CacheFile;
+}
+
+mitk::DICOMGenericImageFrameInfo::Pointer mitk::DICOMPersistentTagCache::Lookup(const std::string& scannerName,
+  const std::string& filename, const TagPathSetType& tagPaths)
+{
+  const FileStamp stamp = GetFileStamp(filename);
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  this->Load_unlocked();
+
+  const auto finding = m_Entries.find(std::make_pair(scannerName, filename));
+  if (!stamp.Exists || finding == m_Entries.cend() || finding->second.FileSize != stamp.FileSize ||
+      finding->second.ModificationTime != stamp.ModificationTime ||
+      !std::includes(finding->second.TagPaths.cbegin(), finding->second.TagPaths.cend(), tagPaths.cbegin(), tagPaths.cend()))
+  {
+    ++m_NumberOfMisses;
+    return nullptr;
+  }
+
+  DICOMGenericImageFrameInfo::Pointer info = DICOMGenericImageFrameInfo::New(filename);
+  for (const auto& value : finding->second.Values)
+  {
+    info->SetTagValue(value.first, value.second);
+  }
+
+  ++m_NumberOfHits;
+  return info;
+}
+
+void mitk::DICOMPersistentTagCache::Store(const std::string& scannerName, const std::string& filename,
+  const TagPathSetType& tagPaths, const DICOMDatasetAccess& info)
+{
+  const FileStamp stamp = GetFileStamp(filename);
+  if (!stamp.Exists)
+  {
+    return;
+  }
+
+  std::vector<std::pair<DICOMTagPath, std::string>> values;
+  for (const auto& path : tagPaths)
+  {
+    for (const auto& finding : info.GetTagValueAsString(path))
+    {
+      if (finding.isValid)
+      {
+        values.emplace_back(finding.path, finding.value);
+      }
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  this->Load_unlocked();
+
+  Entry& entry = m_Entries[std::make_pair(scannerName, filename)];
+  if (entry.FileSize != stamp.FileSize || entry.ModificationTime != stamp.ModificationTime)
+  {
+    entry.FileSize = stamp.FileSize;
+    entry.ModificationTime = stamp.ModificationTime;
+    entry.TagPaths.clear();
+    entry.Values.clear();
+  }
+
+  entry.TagPaths.insert(tagPaths.cbegin(), tagPaths.cend());
+  for (const auto& value : values)
+  {
+    const auto pos = std::find_if(entry.Values.begin(), entry.Values.end(),
+      [&value](const std::pair<DICOMTagPath, std::string>& existing) { return existing.first == value.first; });
+    if (pos != entry.Values.end())
+    {
+      pos->second = value.second;
+    }
+    else
+    {
+      entry.Values.push_back(value);
+    }
+  }
+
+  m_Modified = true;
+}
+
+void mitk::DICOMPersistentTagCache::Save()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  if (!m_Modified || m_CacheFile.empty())
+  {
+    return;
+  }
+
+  // Write to a temporary file of a unique name next to the cache file and replace the cache file with it,
+  // so that concurrent readers and writers never see a partially written cache
+  std::string directory = itksys::SystemTools::GetFilenamePath(m_CacheFile);
+  directory = (directory.empty() ? std::string(".") : directory) + "/";
+
+  std::string temporaryFile;
+  {
+    std::ofstream stream;
+    try
+    {
+      temporaryFile = IOUtil::CreateTemporaryFile(stream, std::ios::binary,
+        itksys::SystemTools::GetFilenameName(m_CacheFile) + ".XXXXXX.tmp", directory);
+    }
+    catch (const mitk::Exception& e)
+    {
+      MITK_WARN << "Cannot write DICOM tag cache file " << m_CacheFile << ": " << e.GetDescription();
+      return;
+    }
+
+    stream.write(Magic, sizeof(Magic));
+    WriteValue<std::uint32_t>(stream, FormatVersion);
+    WriteValue<std::uint64_t>(stream, m_Entries.size());
+
+    for (const auto& iter : m_Entries)
+    {
+      WriteString(stream, iter.first.first);
+      WriteString(stream, iter.first.second);
+      WriteValue<std::uint64_t>(stream, iter.second.FileSize);
+      WriteValue<std::int64_t>(stream, iter.second.ModificationTime);
+
+      WriteValue<std::uint32_t>(stream, static_cast<std::uint32_t>(iter.second.TagPaths.size()));
+      for (const auto& path : iter.second.TagPaths)
+      {
+        WritePath(stream, path);
+      }
+
+      WriteValue<std::uint32_t>(stream, static_cast<std::uint32_t>(iter.second.Values.size()));
+      for (const auto& value : iter.second.Values)
+      {
+        WritePath(stream, value.first);
+        WriteString(stream, value.second);
+      }
+    }
+
+    stream.close();
+    if (!stream)
+    {
+      MITK_WARN << "Cannot write DICOM tag cache file " << temporaryFile;
+      std::remove(temporaryFile.c_str());
+      return;
+    }
+  }
+
+  if (!ReplaceFile(temporaryFile, m_CacheFile))
+  {
+    MITK_WARN << "Cannot replace DICOM tag cache file " << m_CacheFile;
+    std::remove(temporaryFile.c_str());
+    return;
+  }
+
+  m_Modified = false;
+}
+
+void mitk::DICOMPersistentTagCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  m_Entries.clear();
+  m_Loaded = true;
+  m_Modified = true;
+}
+
+unsigned long mitk::DICOMPersistentTagCache::GetNumberOfHits() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumberOfHits;
+}
+
+unsigned long mitk::DICOMPersistentTagCache::GetNumberOfMisses() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumberOfMisses;
+}
+
+void mitk::DICOMPersistentTagCache::Load_unlocked()
+{
+  if (m_Loaded)
+  {
+    return;
+  }
+  m_Loaded = true;
+
+  if (m_CacheFile.empty() || !itksys::SystemTools::FileExists(m_CacheFile.c_str(), true))
+  {
+    return;
+  }
+
+  std::ifstream stream(m_CacheFile.c_str(), std::ios::binary);
+  const std::uint64_t streamSize = itksys::SystemTools::FileLength(m_CacheFile.c_str());
+
+  try
+  {
+    char magic[sizeof(Magic)];
+    stream.read(magic, sizeof(magic));
+    if (!stream || !std::equal(magic, magic + sizeof(magic), Magic) || ReadValue<std::uint32_t>(stream) != FormatVersion)
+    {
+      MITK_WARN << "Ignoring DICOM tag cache file " << m_CacheFile << " of unknown format.";
+      return;
+    }
+
+    EntryMapType entries;
+    const auto numberOfEntries = ReadValue<std::uint64_t>(stream);
+    for (std::uint64_t i = 0; i < numberOfEntries; ++i)
+    {
+      KeyType key;
+      key.first = ReadString(stream, streamSize);
+      key.second = ReadString(stream, streamSize);
+
+      Entry& entry = entries[key];
+      entry.FileSize = ReadValue<std::uint64_t>(stream);
+      entry.ModificationTime = ReadValue<std::int64_t>(stream);
+
+      const auto numberOfPaths = ReadValue<std::uint32_t>(stream);
+      for (std::uint32_t j = 0; j < numberOfPaths; ++j)
+      {
+        entry.TagPaths.insert(ReadPath(stream));
+      }
+
+      const auto numberOfValues = ReadValue<std::uint32_t>(stream);
+      if (numberOfValues > GetRemainingSize(stream, streamSize))
+      {
+        mitkThrow() << "Number of values exceeds the size of the DICOM tag cache file.";
+      }
+      entry.Values.reserve(numberOfValues);
+      for (std::uint32_t j = 0; j < numberOfValues; ++j)
+      {
+        DICOMTagPath path = ReadPath(stream);
+        entry.Values.emplace_back(path, ReadString(stream, streamSize));
+      }
+    }
+
+    m_Entries.swap(entries);
+  }
+  catch (const std::exception& e)
+  {
+    MITK_WARN << "Ignoring corrupt DICOM tag cache file " << m_CacheFile << ": " << e.what();
+  }
+}
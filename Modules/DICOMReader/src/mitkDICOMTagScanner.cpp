@@ -16,9 +16,25 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkDICOMTagScanner.h"
 
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+  /** Partitions with fewer files are not worth the thread start-up. */
+  const std::size_t MinimumFilesPerThread = 16;
+
+  std::mutex DefaultPersistentCacheMutex;
+  mitk::DICOMPersistentTagCache::Pointer DefaultPersistentCache;
+}
+
 itk::MutexLock::Pointer mitk::DICOMTagScanner::s_LocaleMutex = itk::MutexLock::New();
 
 mitk::DICOMTagScanner::DICOMTagScanner()
+  : m_NumberOfThreads(std::max(1u, std::thread::hardware_concurrency())),
+    m_PersistentCache(GetDefaultPersistentCache())
 {
 }
 
@@ -74,3 +90,97 @@ std::string mitk::DICOMTagScanner::GetActiveLocale()
 {
   return setlocale(LC_NUMERIC, nullptr);
 }
+
+void mitk::DICOMTagScanner::SetDefaultPersistentCache(DICOMPersistentTagCache* cache)
+{
+  std::lock_guard<std::mutex> lock(DefaultPersistentCacheMutex);
+  DefaultPersistentCache = cache;
+}
+
+mitk::DICOMPersistentTagCache::Pointer mitk::DICOMTagScanner::GetDefaultPersistentCache()
+{
+  std::lock_guard<std::mutex> lock(DefaultPersistentCacheMutex);
+  return DefaultPersistentCache;
+}
+
+std::vector<mitk::DICOMTagScanner::FileRange> mitk::DICOMTagScanner::PartitionInputFiles(std::size_t numberOfFiles) const
+{
+  const std::size_t numberOfPartitions = std::max<std::size_t>(1,
+    std::min<std::size_t>(m_NumberOfThreads, numberOfFiles / MinimumFilesPerThread));
+
+  std::vector<FileRange> partitions;
+  partitions.reserve(numberOfPartitions);
+
+  std::size_t first = 0;
+  for (std::size_t i = 0; i < numberOfPartitions; ++i)
+  {
+    const std::size_t last = first + numberOfFiles / numberOfPartitions + (i < numberOfFiles % numberOfPartitions ? 1 : 0);
+    partitions.emplace_back(first, last);
+    first = last;
+  }
+
+  return partitions;
+}
+
+void mitk::DICOMTagScanner::ScanPartitions(const std::vector<FileRange>& partitions,
+  const std::function<void(std::size_t, const FileRange&)>& scanPartition)
+{
+  if (partitions.size() == 1)
+  {
+    scanPartition(0, partitions.front());
+    return;
+  }
+
+  std::exception_ptr firstError;
+  std::mutex errorMutex;
+
+  auto worker = [&](std::size_t index)
+  {
+    try
+    {
+      scanPartition(index, partitions[index]);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(errorMutex);
+      if (!firstError)
+      {
+        firstError = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(partitions.size() - 1);
+  for (std::size_t i = 1; i < partitions.size(); ++i)
+  {
+    threads.emplace_back(worker, i);
+  }
+  worker(0);
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  if (firstError)
+  {
+    std::rethrow_exception(firstError);
+  }
+}
+
+mitk::DICOMDatasetAccessingImageFrameList mitk::DICOMTagScanner::LookupPersistentCache(const StringList& filenames,
+  const DICOMPersistentTagCache::TagPathSetType& tagPaths) const
+{
+  DICOMDatasetAccessingImageFrameList result(filenames.size());
+
+  if (m_PersistentCache.IsNotNull())
+  {
+    for (std::size_t i = 0; i < filenames.size(); ++i)
+    {
+      result[i] = m_PersistentCache->Lookup(this->GetNameOfClass(), filenames[i], tagPaths).GetPointer();
+    }
+  }
+
+  return result;
+}
@@ -1,6 +1,8 @@
 set(MODULE_TESTS
   mitkDICOMReaderConfiguratorTest.cpp
   mitkDICOMDCMTKTagScannerTest.cpp
+  mitkDICOMTagScannerParallelScanTest.cpp
+  mitkDICOMPersistentTagCacheTest.cpp
   mitkDICOMSimpleVolumeImportTest.cpp
   mitkDICOMTagPathTest.cpp
   mitkDICOMPropertyTest.cpp
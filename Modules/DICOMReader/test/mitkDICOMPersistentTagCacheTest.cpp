@@ -0,0 +1,214 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkDICOMDCMTKTagScanner.h"
+#include "mitkDICOMGDCMTagScanner.h"
+#include "mitkDICOMPersistentTagCache.h"
+
+#include "mitkIOUtil.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <itksys/Directory.hxx>
+#include <itksys/SystemTools.hxx>
+
+#include <cstdint>
+#include <fstream>
+
+class mitkDICOMPersistentTagCacheTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkDICOMPersistentTagCacheTestSuite);
+
+  MITK_TEST(SecondScanIsAnsweredFromCache);
+  MITK_TEST(CacheIsPersistedToFile);
+  MITK_TEST(ChangedFilesAreRescanned);
+  MITK_TEST(AdditionalTagsTriggerRescan);
+  MITK_TEST(ScannersDoNotShareEntries);
+  MITK_TEST(SaveReplacesCacheFile);
+  MITK_TEST(OversizedStringIsRejected);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  std::string m_TempDirectory;
+  std::string m_CacheFile;
+  mitk::StringList m_Files;
+  mitk::DICOMTagPath m_InstanceUID;
+
+  template <typename TScanner>
+  mitk::DICOMDatasetAccessingImageFrameList Scan(mitk::DICOMPersistentTagCache* cache, const mitk::DICOMTagPathList& paths)
+  {
+    auto scanner = TScanner::New();
+    scanner->SetPersistentCache(cache);
+    scanner->AddTagPaths(paths);
+    scanner->SetInputFiles(m_Files);
+    scanner->Scan();
+    return scanner->GetFrameInfoList();
+  }
+
+  mitk::DICOMPersistentTagCache::Pointer CreateCache()
+  {
+    auto cache = mitk::DICOMPersistentTagCache::New();
+    cache->SetCacheFile(m_CacheFile);
+    return cache;
+  }
+
+  std::string GetInstanceUID(const mitk::DICOMDatasetAccessingImageFrameList& frames, std::size_t index)
+  {
+    const mitk::DICOMDatasetFinding finding = frames[index]->GetTagValueAsString(m_InstanceUID.GetFirstNode().tag);
+    CPPUNIT_ASSERT_MESSAGE("Instance UID is available", finding.isValid);
+    return finding.value;
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_TempDirectory = mitk::IOUtil::CreateTemporaryDirectory("DICOMPersistentTagCacheTest-XXXXXX");
+    m_CacheFile = m_TempDirectory + "/tags.cache";
+    m_InstanceUID = mitk::DICOMTagPath(0x0008, 0x0018);
+
+    for (const std::string slice : { "100", "101", "102", "104" })
+    {
+      const std::string copy = m_TempDirectory + "/" + slice;
+      CPPUNIT_ASSERT(itksys::SystemTools::CopyFileAlways(GetTestDataFilePath("TinyCTAbdomen/" + slice), copy));
+      m_Files.push_back(copy);
+    }
+  }
+
+  void tearDown() override
+  {
+    m_Files.clear();
+    itksys::SystemTools::RemoveADirectory(m_TempDirectory.c_str());
+  }
+
+  void SecondScanIsAnsweredFromCache()
+  {
+    auto cache = this->CreateCache();
+
+    const auto scanned = this->Scan<mitk::DICOMGDCMTagScanner>(cache, { m_InstanceUID });
+    CPPUNIT_ASSERT_EQUAL(0ul, cache->GetNumberOfHits());
+    CPPUNIT_ASSERT_EQUAL(4ul, cache->GetNumberOfMisses());
+
+    const auto cached = this->Scan<mitk::DICOMGDCMTagScanner>(cache, { m_InstanceUID });
+    CPPUNIT_ASSERT_EQUAL(4ul, cache->GetNumberOfHits());
+    CPPUNIT_ASSERT_EQUAL(4ul, cache->GetNumberOfMisses());
+
+    CPPUNIT_ASSERT_EQUAL(scanned.size(), cached.size());
+    for (std::size_t i = 0; i < scanned.size(); ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL(scanned[i]->Filename, cached[i]->Filename);
+      CPPUNIT_ASSERT_EQUAL(this->GetInstanceUID(scanned, i), this->GetInstanceUID(cached, i));
+    }
+    CPPUNIT_ASSERT_EQUAL(std::string("1.2.276.0.99.1.4.8323329.3795.1303917947.940051"), this->GetInstanceUID(cached, 0));
+  }
+
+  void CacheIsPersistedToFile()
+  {
+    this->Scan<mitk::DICOMDCMTKTagScanner>(this->CreateCache(), { m_InstanceUID });
+    CPPUNIT_ASSERT_MESSAGE("Cache file was written", itksys::SystemTools::FileExists(m_CacheFile.c_str(), true));
+
+    auto reloadedCache = this->CreateCache();
+    const auto cached = this->Scan<mitk::DICOMDCMTKTagScanner>(reloadedCache, { m_InstanceUID });
+    CPPUNIT_ASSERT_EQUAL(4ul, reloadedCache->GetNumberOfHits());
+    CPPUNIT_ASSERT_EQUAL(0ul, reloadedCache->GetNumberOfMisses());
+    CPPUNIT_ASSERT_EQUAL(std::string("1.2.276.0.99.1.4.8323329.3795.1303917947.940055"), this->GetInstanceUID(cached, 3));
+  }
+
+  void ChangedFilesAreRescanned()
+  {
+    auto cache = this->CreateCache();
+    const auto scanned = this->Scan<mitk::DICOMDCMTKTagScanner>(cache, { m_InstanceUID });
+
+    CPPUNIT_ASSERT(itksys::SystemTools::CopyFileAlways(GetTestDataFilePath("RT/Dose/RD.dcm"), m_Files[1]));
+
+    const auto rescanned = this->Scan<mitk::DICOMDCMTKTagScanner>(cache, { m_InstanceUID });
+    CPPUNIT_ASSERT_EQUAL(3ul, cache->GetNumberOfHits());
+    CPPUNIT_ASSERT_EQUAL(5ul, cache->GetNumberOfMisses());
+    CPPUNIT_ASSERT_EQUAL(this->GetInstanceUID(scanned, 0), this->GetInstanceUID(rescanned, 0));
+    CPPUNIT_ASSERT_MESSAGE("Value of changed file is updated", this->GetInstanceUID(scanned, 1) != this->GetInstanceUID(rescanned, 1));
+  }
+
+  void AdditionalTagsTriggerRescan()
+  {
+    auto cache = this->CreateCache();
+    const mitk::DICOMTagPath patientName(0x0010, 0x0010);
+
+    this->Scan<mitk::DICOMGDCMTagScanner>(cache, { m_InstanceUID });
+    const auto extended = this->Scan<mitk::DICOMGDCMTagScanner>(cache, { m_InstanceUID, patientName });
+    CPPUNIT_ASSERT_EQUAL(0ul, cache->GetNumberOfHits());
+    CPPUNIT_ASSERT_EQUAL(8ul, cache->GetNumberOfMisses());
+    CPPUNIT_ASSERT(extended.front()->GetTagValueAsString(patientName.GetFirstNode().tag).isValid);
+
+    // a subset of the stored tags is answered from the cache
+    this->Scan<mitk::DICOMGDCMTagScanner>(cache, { patientName });
+    CPPUNIT_ASSERT_EQUAL(4ul, cache->GetNumberOfHits());
+  }
+
+  void ScannersDoNotShareEntries()
+  {
+    auto cache = this->CreateCache();
+
+    this->Scan<mitk::DICOMGDCMTagScanner>(cache, { m_InstanceUID });
+    this->Scan<mitk::DICOMDCMTKTagScanner>(cache, { m_InstanceUID });
+    CPPUNIT_ASSERT_EQUAL(0ul, cache->GetNumberOfHits());
+    CPPUNIT_ASSERT_EQUAL(8ul, cache->GetNumberOfMisses());
+  }
+
+  void SaveReplacesCacheFile()
+  {
+    this->Scan<mitk::DICOMGDCMTagScanner>(this->CreateCache(), { m_InstanceUID });
+    this->Scan<mitk::DICOMDCMTKTagScanner>(this->CreateCache(), { m_InstanceUID });
+
+    // both scanners are in the file, no temporary file is left behind
+    auto reloadedCache = this->CreateCache();
+    this->Scan<mitk::DICOMGDCMTagScanner>(reloadedCache, { m_InstanceUID });
+    this->Scan<mitk::DICOMDCMTKTagScanner>(reloadedCache, { m_InstanceUID });
+    CPPUNIT_ASSERT_EQUAL(8ul, reloadedCache->GetNumberOfHits());
+
+    itksys::Directory directory;
+    CPPUNIT_ASSERT(directory.Load(m_TempDirectory.c_str()));
+    for (unsigned long i = 0; i < directory.GetNumberOfFiles(); ++i)
+    {
+      const std::string file = directory.GetFile(i);
+      CPPUNIT_ASSERT_MESSAGE("Temporary file " + file + " was removed", itksys::SystemTools::GetFilenameLastExtension(file) != ".tmp");
+    }
+  }
+
+  void OversizedStringIsRejected()
+  {
+    {
+      std::ofstream stream(m_CacheFile.c_str(), std::ios::binary);
+      const char magic[8] = { 'M', 'I', 'T', 'K', 'D', 'T', 'C', '\0' };
+      const std::uint32_t version = 1;
+      const std::uint64_t numberOfEntries = 1;
+      const std::uint32_t stringSize = 0xfffffff0;
+      stream.write(magic, sizeof(magic));
+      stream.write(reinterpret_cast<const char*>(&version), sizeof(version));
+      stream.write(reinterpret_cast<const char*>(&numberOfEntries), sizeof(numberOfEntries));
+      stream.write(reinterpret_cast<const char*>(&stringSize), sizeof(stringSize));
+    }
+
+    auto cache = this->CreateCache();
+    this->Scan<mitk::DICOMGDCMTagScanner>(cache, { m_InstanceUID });
+    CPPUNIT_ASSERT_EQUAL(0ul, cache->GetNumberOfHits());
+    CPPUNIT_ASSERT_EQUAL(4ul, cache->GetNumberOfMisses());
+  }
+
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkDICOMPersistentTagCache)
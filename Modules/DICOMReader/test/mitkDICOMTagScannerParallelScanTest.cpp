@@ -0,0 +1,190 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkDICOMDCMTKTagScanner.h"
+#include "mitkDICOMGDCMTagScanner.h"
+
+#include "mitkIOUtil.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <dcmtk/dcmdata/dctk.h>
+
+#include <itksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <vector>
+
+class mitkDICOMTagScannerParallelScanTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkDICOMTagScannerParallelScanTestSuite);
+
+  MITK_TEST(GDCMParallelScanMatchesSequentialScan);
+  MITK_TEST(DCMTKParallelScanMatchesSequentialScan);
+  MITK_TEST(ScanThroughputBenchmark);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  static const unsigned int NumberOfFiles = 256;
+  static const Uint16 Rows = 256;
+  static const Uint16 Columns = 256;
+
+  std::string m_StudyDirectory;
+  mitk::StringList m_Files;
+  mitk::DICOMTagList m_Tags;
+
+  /** Writes a synthetic CT series with small headers and 128 KiB of pixel data per file. */
+  void WriteSyntheticStudy()
+  {
+    m_StudyDirectory = mitk::IOUtil::CreateTemporaryDirectory("DICOMTagScannerTest-XXXXXX");
+
+    const std::vector<Uint16> pixels(Rows * Columns, 1000);
+
+    for (unsigned int i = 0; i < NumberOfFiles; ++i)
+    {
+      std::ostringstream sopInstanceUID;
+      sopInstanceUID << "1.2.826.0.1.3680043.2.1125.1." << i + 1;
+      std::ostringstream imagePosition;
+      imagePosition << "0\\0\\" << i;
+
+      DcmFileFormat fileFormat;
+      DcmDataset* dataset = fileFormat.getDataset();
+      dataset->putAndInsertString(DCM_SOPClassUID, UID_CTImageStorage);
+      dataset->putAndInsertString(DCM_SOPInstanceUID, sopInstanceUID.str().c_str());
+      dataset->putAndInsertString(DCM_Modality, "CT");
+      dataset->putAndInsertString(DCM_PatientName, "Synthetic^Study");
+      dataset->putAndInsertString(DCM_StudyInstanceUID, "1.2.826.0.1.3680043.2.1125.2");
+      dataset->putAndInsertString(DCM_SeriesInstanceUID, "1.2.826.0.1.3680043.2.1125.3");
+      dataset->putAndInsertString(DCM_InstanceNumber, std::to_string(i + 1).c_str());
+      dataset->putAndInsertString(DCM_ImagePositionPatient, imagePosition.str().c_str());
+      dataset->putAndInsertString(DCM_ImageOrientationPatient, "1\\0\\0\\0\\1\\0");
+      dataset->putAndInsertString(DCM_PixelSpacing, "1\\1");
+      dataset->putAndInsertString(DCM_PhotometricInterpretation, "MONOCHROME2");
+      dataset->putAndInsertUint16(DCM_SamplesPerPixel, 1);
+      dataset->putAndInsertUint16(DCM_Rows, Rows);
+      dataset->putAndInsertUint16(DCM_Columns, Columns);
+      dataset->putAndInsertUint16(DCM_BitsAllocated, 16);
+      dataset->putAndInsertUint16(DCM_BitsStored, 16);
+      dataset->putAndInsertUint16(DCM_HighBit, 15);
+      dataset->putAndInsertUint16(DCM_PixelRepresentation, 0);
+      dataset->putAndInsertUint16Array(DCM_PixelData, pixels.data(), pixels.size());
+
+      const std::string fileName = m_StudyDirectory + "/" + std::to_string(i) + ".dcm";
+      CPPUNIT_ASSERT_MESSAGE("Writing synthetic DICOM file " + fileName,
+        fileFormat.saveFile(fileName.c_str(), EXS_LittleEndianExplicit).good());
+      m_Files.push_back(fileName);
+    }
+  }
+
+  template <typename TScanner>
+  typename TScanner::Pointer Scan(unsigned int numberOfThreads)
+  {
+    auto scanner = TScanner::New();
+    scanner->AddTags(m_Tags);
+    scanner->SetInputFiles(m_Files);
+    scanner->SetNumberOfThreads(numberOfThreads);
+    scanner->Scan();
+    return scanner;
+  }
+
+  template <typename TScanner>
+  void CheckParallelScanMatchesSequentialScan()
+  {
+    auto sequential = this->Scan<TScanner>(1);
+    auto parallel = this->Scan<TScanner>(4);
+
+    mitk::DICOMDatasetAccessingImageFrameList sequentialFrames = sequential->GetFrameInfoList();
+    mitk::DICOMDatasetAccessingImageFrameList parallelFrames = parallel->GetFrameInfoList();
+    CPPUNIT_ASSERT_EQUAL(m_Files.size(), sequentialFrames.size());
+    CPPUNIT_ASSERT_EQUAL(m_Files.size(), parallelFrames.size());
+
+    for (std::size_t i = 0; i < m_Files.size(); ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Frames are in input order", m_Files[i], parallelFrames[i]->Filename);
+
+      for (const auto& tag : m_Tags)
+      {
+        const mitk::DICOMDatasetFinding expected = sequentialFrames[i]->GetTagValueAsString(tag);
+        const mitk::DICOMDatasetFinding actual = parallelFrames[i]->GetTagValueAsString(tag);
+        CPPUNIT_ASSERT_MESSAGE("Tag found in sequential scan", expected.isValid);
+        CPPUNIT_ASSERT_MESSAGE("Tag found in parallel scan", actual.isValid);
+        CPPUNIT_ASSERT_EQUAL(expected.value, actual.value);
+      }
+    }
+  }
+
+  template <typename TScanner>
+  double MeasureFilesPerSecond(unsigned int numberOfThreads)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    this->Scan<TScanner>(numberOfThreads);
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    return m_Files.size() / std::max(duration.count(), 1e-9);
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_Tags.push_back(mitk::DICOMTag(0x0008, 0x0018)); // SOP instance UID
+    m_Tags.push_back(mitk::DICOMTag(0x0010, 0x0010)); // patient name
+    m_Tags.push_back(mitk::DICOMTag(0x0020, 0x000e)); // series instance UID
+    m_Tags.push_back(mitk::DICOMTag(0x0020, 0x0013)); // instance number
+    m_Tags.push_back(mitk::DICOMTag(0x0020, 0x0032)); // image position patient
+    m_Tags.push_back(mitk::DICOMTag(0x0028, 0x0010)); // rows
+
+    this->WriteSyntheticStudy();
+  }
+
+  void tearDown() override
+  {
+    m_Files.clear();
+    m_Tags.clear();
+    itksys::SystemTools::RemoveADirectory(m_StudyDirectory.c_str());
+  }
+
+  void GDCMParallelScanMatchesSequentialScan()
+  {
+    this->CheckParallelScanMatchesSequentialScan<mitk::DICOMGDCMTagScanner>();
+  }
+
+  void DCMTKParallelScanMatchesSequentialScan()
+  {
+    this->CheckParallelScanMatchesSequentialScan<mitk::DICOMDCMTKTagScanner>();
+
+    auto scanner = this->Scan<mitk::DICOMDCMTKTagScanner>(4);
+    mitk::DICOMDatasetAccessingImageFrameList frames = scanner->GetFrameInfoList();
+    mitk::DICOMDatasetFinding finding = frames.back()->GetTagValueAsString(mitk::DICOMTag(0x0008, 0x0018));
+    CPPUNIT_ASSERT_EQUAL(std::string("1.2.826.0.1.3680043.2.1125.1.256"), finding.value);
+  }
+
+  void ScanThroughputBenchmark()
+  {
+    for (unsigned int numberOfThreads : { 1u, 2u, 4u, 8u })
+    {
+      MITK_INFO << "Tag scan of " << m_Files.size() << " files with " << numberOfThreads << " thread(s): "
+                << this->MeasureFilesPerSecond<mitk::DICOMGDCMTagScanner>(numberOfThreads) << " files/s (GDCM), "
+                << this->MeasureFilesPerSecond<mitk::DICOMDCMTKTagScanner>(numberOfThreads) << " files/s (DCMTK)";
+    }
+  }
+
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkDICOMTagScannerParallelScan)
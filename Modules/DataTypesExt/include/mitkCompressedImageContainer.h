@@ -59,6 +59,11 @@ namespace mitk
      */
     Image::Pointer GetImage();
 
+    /**
+     * \brief Returns the number of bytes of the compressed data.
+     */
+    std::size_t GetMemorySize() const;
+
   protected:
     CompressedImageContainer(); // purposely hidden
     ~CompressedImageContainer() override;
@@ -0,0 +1,70 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkCompressedImageTimeStepStorage_h_Included
+#define mitkCompressedImageTimeStepStorage_h_Included
+
+#include "MitkDataTypesExtExports.h"
+#include "mitkImageTimeStepSwapStorage.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace mitk
+{
+  /**
+    \brief Keeps the time steps evicted from an mitk::Image zlib-compressed in memory
+
+    Intended for dynamic images that exceed the available memory, e.g. segmentations of long 3D+t acquisitions,
+    which usually compress very well:
+
+    \code
+    image->SetTimeStepSwapStorage(mitk::CompressedImageTimeStepStorage::New());
+    image->SetTimeStepMemoryBudget(512 * 1024 * 1024);
+    \endcode
+  */
+  class MITKDATATYPESEXT_EXPORT CompressedImageTimeStepStorage : public ImageTimeStepSwapStorage
+  {
+  public:
+    mitkClassMacro(CompressedImageTimeStepStorage, ImageTimeStepSwapStorage);
+    itkFactorylessNewMacro(Self);
+
+    void Store(int t, int n, const void *data, size_t size) override;
+    bool Restore(int t, int n, void *data, size_t size) override;
+    void Discard(int t, int n) override;
+    void DiscardAll() override;
+    size_t GetStoredSize() const override;
+
+  protected:
+    CompressedImageTimeStepStorage();
+    ~CompressedImageTimeStepStorage() override;
+
+    struct CompressedVolume
+    {
+      std::vector<unsigned char> m_Buffer;
+      size_t m_UncompressedSize;
+    };
+
+    /// key: (time step, channel)
+    std::map<std::pair<int, int>, CompressedVolume> m_Volumes;
+
+    size_t m_StoredSize;
+  };
+
+} // namespace
+
+#endif
@@ -180,3 +180,13 @@ mitk::Image::Pointer mitk::CompressedImageContainer::GetImage()
 
   return image;
 }
+
+std::size_t mitk::CompressedImageContainer::GetMemorySize() const
+{
+  std::size_t memorySize = sizeof(CompressedImageContainer);
+
+  for (const auto &byteBuffer : m_ByteBuffers)
+    memorySize += byteBuffer.second;
+
+  return memorySize;
+}
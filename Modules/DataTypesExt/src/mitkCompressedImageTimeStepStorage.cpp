@@ -0,0 +1,100 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkCompressedImageTimeStepStorage.h"
+#include "mitkExceptionMacro.h"
+
+#include "itk_zlib.h"
+
+mitk::CompressedImageTimeStepStorage::CompressedImageTimeStepStorage() : m_StoredSize(0)
+{
+}
+
+mitk::CompressedImageTimeStepStorage::~CompressedImageTimeStepStorage()
+{
+}
+
+void mitk::CompressedImageTimeStepStorage::Store(int t, int n, const void *data, size_t size)
+{
+  this->Discard(t, n);
+
+  CompressedVolume volume;
+  volume.m_UncompressedSize = size;
+  volume.m_Buffer.resize(::compressBound(static_cast<uLong>(size)));
+
+  ::uLongf destLen(volume.m_Buffer.size());
+  int zlibRetVal = ::compress2(volume.m_Buffer.data(),
+                               &destLen,
+                               static_cast<const Bytef *>(data),
+                               static_cast<uLong>(size),
+                               Z_BEST_SPEED);
+  if (zlibRetVal != Z_OK)
+  {
+    mitkThrow() << "Time step " << t << " of channel " << n << " could not be compressed (zlib error " << zlibRetVal
+                << ").";
+  }
+
+  // only keep the neccessary amount of memory
+  volume.m_Buffer.resize(destLen);
+  volume.m_Buffer.shrink_to_fit();
+
+  m_StoredSize += volume.m_Buffer.size();
+  m_Volumes[std::make_pair(t, n)] = std::move(volume);
+}
+
+bool mitk::CompressedImageTimeStepStorage::Restore(int t, int n, void *data, size_t size)
+{
+  auto iter = m_Volumes.find(std::make_pair(t, n));
+  if (iter == m_Volumes.end() || iter->second.m_UncompressedSize != size)
+    return false;
+
+  ::uLongf destLen(size);
+  int zlibRetVal = ::uncompress(static_cast<Bytef *>(data),
+                                &destLen,
+                                iter->second.m_Buffer.data(),
+                                static_cast<uLong>(iter->second.m_Buffer.size()));
+  if (zlibRetVal != Z_OK || destLen != size)
+  {
+    MITK_ERROR << "Time step " << t << " of channel " << n << " could not be uncompressed (zlib error "
+               << zlibRetVal << ").";
+    return false;
+  }
+
+  m_StoredSize -= iter->second.m_Buffer.size();
+  m_Volumes.erase(iter);
+  return true;
+}
+
+void mitk::CompressedImageTimeStepStorage::Discard(int t, int n)
+{
+  auto iter = m_Volumes.find(std::make_pair(t, n));
+  if (iter != m_Volumes.end())
+  {
+    m_StoredSize -= iter->second.m_Buffer.size();
+    m_Volumes.erase(iter);
+  }
+}
+
+void mitk::CompressedImageTimeStepStorage::DiscardAll()
+{
+  m_Volumes.clear();
+  m_StoredSize = 0;
+}
+
+size_t mitk::CompressedImageTimeStepStorage::GetStoredSize() const
+{
+  return m_StoredSize;
+}
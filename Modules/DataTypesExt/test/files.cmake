@@ -1,5 +1,6 @@
 set(MODULE_TESTS
   mitkColorSequenceRainbowTest.cpp
+  mitkCompressedImageTimeStepStorageTest.cpp
   mitkMeshTest.cpp
   mitkMultiStepperTest.cpp
   mitkUnstructuredGridTest.cpp
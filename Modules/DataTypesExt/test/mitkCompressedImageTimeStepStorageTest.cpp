@@ -0,0 +1,144 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkCompressedImageTimeStepStorage.h>
+#include <mitkImage.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <algorithm>
+#include <array>
+
+class mitkCompressedImageTimeStepStorageTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkCompressedImageTimeStepStorageTestSuite);
+  MITK_TEST(EvictLeastRecentlyUsedTimeSteps);
+  MITK_TEST(ModifiedTimeStepSurvivesEviction);
+  MITK_TEST(ReferencedTimeStepIsNotEvicted);
+  MITK_TEST(RemoveStorageRestoresTimeSteps);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  static const unsigned int NumberOfTimeSteps = 6;
+  static const unsigned int VolumeSize = 16 * 16 * 8;
+
+  mitk::Image::Pointer m_Image;
+  mitk::CompressedImageTimeStepStorage::Pointer m_Storage;
+
+  bool IsTimeStepFilledWith(unsigned int t, unsigned short value)
+  {
+    mitk::ImageReadAccessor accessor(m_Image, m_Image->GetVolumeData(t));
+    auto data = static_cast<const unsigned short *>(accessor.GetData());
+    return std::all_of(data, data + VolumeSize, [value](unsigned short v) { return v == value; });
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = mitk::Image::New();
+    std::array<unsigned int, 4> dimensions = {{16, 16, 8, NumberOfTimeSteps}};
+    m_Image->Initialize(mitk::MakeScalarPixelType<unsigned short>(), 4, dimensions.data());
+
+    {
+      mitk::ImageWriteAccessor accessor(m_Image);
+      auto data = static_cast<unsigned short *>(accessor.GetData());
+      for (unsigned int t = 0; t < NumberOfTimeSteps; ++t)
+      {
+        std::fill_n(data + t * VolumeSize, VolumeSize, t);
+      }
+    }
+
+    m_Storage = mitk::CompressedImageTimeStepStorage::New();
+    m_Image->SetTimeStepSwapStorage(m_Storage);
+    m_Image->SetTimeStepMemoryBudget(2 * VolumeSize * sizeof(unsigned short));
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+    m_Storage = nullptr;
+  }
+
+  void EvictLeastRecentlyUsedTimeSteps()
+  {
+    auto statistics = m_Image->GetTimeStepCacheStatistics();
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned long>(NumberOfTimeSteps - 2), statistics.m_Evictions);
+    CPPUNIT_ASSERT(statistics.m_ResidentBytes <= m_Image->GetTimeStepMemoryBudget());
+    CPPUNIT_ASSERT(m_Storage->GetStoredSize() > 0);
+    CPPUNIT_ASSERT(m_Storage->GetStoredSize() < (NumberOfTimeSteps - 2) * VolumeSize * sizeof(unsigned short));
+
+    for (unsigned int t = 0; t < NumberOfTimeSteps; ++t)
+    {
+      CPPUNIT_ASSERT(IsTimeStepFilledWith(t, t));
+    }
+
+    // the most recently used time step is still in memory
+    CPPUNIT_ASSERT(IsTimeStepFilledWith(NumberOfTimeSteps - 1, NumberOfTimeSteps - 1));
+
+    statistics = m_Image->GetTimeStepCacheStatistics();
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned long>(NumberOfTimeSteps), statistics.m_Misses);
+    CPPUNIT_ASSERT(statistics.m_Hits >= 1);
+    CPPUNIT_ASSERT(statistics.m_ResidentBytes <= m_Image->GetTimeStepMemoryBudget());
+  }
+
+  void ModifiedTimeStepSurvivesEviction()
+  {
+    {
+      mitk::ImageWriteAccessor accessor(m_Image, m_Image->GetVolumeData(1));
+      std::fill_n(static_cast<unsigned short *>(accessor.GetData()), VolumeSize, 4711);
+    }
+
+    for (unsigned int t = 2; t < NumberOfTimeSteps; ++t)
+    {
+      CPPUNIT_ASSERT(IsTimeStepFilledWith(t, t));
+    }
+
+    CPPUNIT_ASSERT(IsTimeStepFilledWith(1, 4711));
+  }
+
+  void ReferencedTimeStepIsNotEvicted()
+  {
+    mitk::ImageReadAccessor accessor(m_Image, m_Image->GetVolumeData(0));
+    auto data = static_cast<const unsigned short *>(accessor.GetData());
+
+    for (unsigned int t = 1; t < NumberOfTimeSteps; ++t)
+    {
+      CPPUNIT_ASSERT(IsTimeStepFilledWith(t, t));
+    }
+
+    // the reader only pins its own time step, the others are still evicted
+    CPPUNIT_ASSERT(m_Image->GetTimeStepCacheStatistics().m_ResidentBytes <= m_Image->GetTimeStepMemoryBudget());
+    CPPUNIT_ASSERT(std::all_of(data, data + VolumeSize, [](unsigned short v) { return v == 0; }));
+  }
+
+  void RemoveStorageRestoresTimeSteps()
+  {
+    m_Image->SetTimeStepSwapStorage(nullptr);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), m_Storage->GetStoredSize());
+
+    mitk::ImageReadAccessor accessor(m_Image);
+    auto data = static_cast<const unsigned short *>(accessor.GetData());
+    for (unsigned int t = 0; t < NumberOfTimeSteps; ++t)
+    {
+      CPPUNIT_ASSERT_EQUAL(static_cast<unsigned short>(t), data[t * VolumeSize]);
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkCompressedImageTimeStepStorage)
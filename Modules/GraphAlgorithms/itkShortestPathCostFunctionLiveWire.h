@@ -21,6 +21,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "itkImageRegionConstIterator.h"
 
+#include <memory>
+
 namespace itk
 {
   /** \brief Cost function for LiveWire purposes.
@@ -68,6 +70,23 @@ namespace itk
     typedef TInputImageType ImageType;
     typedef itk::ImageRegion<2> RegionType;
 
+    /** \brief Images derived from the input image that the costs are computed from.
+    They only depend on the image, thus they can be computed in advance (e.g. in a background thread)
+    and shared between cost functions.*/
+    struct CostFeatures
+    {
+      FloatImageType::Pointer m_GradientMagnitudeImage;
+      FloatImageType::Pointer m_EdgeImage;
+      VectorOutputImageType::Pointer m_GradientImage;
+      double m_GradientMax;
+    };
+
+    typedef std::shared_ptr<const CostFeatures> CostFeaturesPointer;
+
+    /** \brief Computes the cost features of an image. The image is only read, so this can be called
+    from any thread.*/
+    static CostFeaturesPointer ComputeCostFeatures(const TInputImageType *image);
+
     /** \brief calculates the costs for going from p1 to p2*/
     double GetCost(IndexType p1, IndexType p2) override;
 
@@ -86,11 +105,18 @@ namespace itk
     /** \brief Clear repulsive points in cost function*/
     virtual void ClearRepulsivePoints();
 
-    itkSetMacro(RequestedRegion, RegionType);
+    /** \brief The requested region does not influence the costs, so setting it does not modify the cost function.
+    Otherwise the search tree of the shortest path filter could not be reused between LiveWire queries.*/
+    void SetRequestedRegion(const RegionType &region) { this->m_RequestedRegion = region; }
     itkGetMacro(RequestedRegion, RegionType);
 
     void SetImage(const TInputImageType *_arg) override;
 
+    /** \brief Use precomputed cost features of the image instead of computing them in Initialize().
+    Features that do not fit to the image are ignored. Setting a new image discards them.*/
+    void SetCostFeatures(const CostFeaturesPointer &features);
+    const CostFeaturesPointer &GetCostFeatures() const { return this->m_CostFeatures; }
+
     void SetDynamicCostMap(std::map<int, int> &costMap)
     {
       this->m_CostMap = costMap;
@@ -99,11 +125,18 @@ namespace itk
       this->Modified();
     }
 
-    void SetUseCostMap(bool useCostMap) { this->m_UseCostMap = useCostMap; }
+    itkSetMacro(UseCostMap, bool);
     /**
      \brief Set the maximum of the dynamic cost map to save computation time.
     */
-    void SetCostMapMaximum(double max) { this->m_MaxMapCosts = max; }
+    void SetCostMapMaximum(double max)
+    {
+      if (this->m_MaxMapCosts != max)
+      {
+        this->m_MaxMapCosts = max;
+        this->Modified();
+      }
+    }
     enum Constants
     {
       MAPSCALEFACTOR = 10
@@ -133,6 +166,7 @@ namespace itk
     FloatImageType::Pointer m_EdgeImage;
     UnsignedCharImageType::Pointer m_MaskImage;
     VectorOutputImageType::Pointer m_GradientImage;
+    CostFeaturesPointer m_CostFeatures;
 
     double m_MinCosts;
 
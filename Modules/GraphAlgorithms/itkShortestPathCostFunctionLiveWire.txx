@@ -42,12 +42,14 @@ namespace itk
   {
     this->m_MaskImage->SetPixel(index, 255);
     m_UseRepulsivePoints = true;
+    this->Modified();
   }
 
   template <class TInputImageType>
   void ShortestPathCostFunctionLiveWire<TInputImageType>::RemoveRepulsivePoint(const IndexType &index)
   {
     this->m_MaskImage->SetPixel(index, 0);
+    this->Modified();
   }
 
   template <class TInputImageType>
@@ -66,6 +68,7 @@ namespace itk
       this->m_MaskImage->Allocate();
       this->m_MaskImage->FillBuffer(0);
 
+      this->m_CostFeatures = nullptr;
       this->Modified();
       this->m_Initialized = false;
     }
@@ -76,6 +79,7 @@ namespace itk
   {
     m_UseRepulsivePoints = false;
     this->m_MaskImage->FillBuffer(0);
+    this->Modified();
   }
 
   template <class TInputImageType>
@@ -295,77 +299,109 @@ namespace itk
     return m_MinCosts;
   }
 
+  template <class TInputImageType>
+  typename ShortestPathCostFunctionLiveWire<TInputImageType>::CostFeaturesPointer
+    ShortestPathCostFunctionLiveWire<TInputImageType>::ComputeCostFeatures(const TInputImageType *image)
+  {
+    auto features = std::make_shared<CostFeatures>();
+
+    typedef itk::CastImageFilter<TInputImageType, FloatImageType> CastFilterType;
+    typename CastFilterType::Pointer castFilter = CastFilterType::New();
+    castFilter->SetInput(image);
+
+    // init gradient magnitude image
+    typedef itk::GradientMagnitudeImageFilter<FloatImageType, FloatImageType> GradientMagnitudeFilterType;
+    typename GradientMagnitudeFilterType::Pointer gradientFilter = GradientMagnitudeFilterType::New();
+    gradientFilter->SetInput(castFilter->GetOutput());
+    // gradientFilter->SetNumberOfThreads(4);
+    // gradientFilter->GetOutput()->SetRequestedRegion(m_RequestedRegion);
+
+    gradientFilter->Update();
+    features->m_GradientMagnitudeImage = gradientFilter->GetOutput();
+
+    typedef itk::StatisticsImageFilter<FloatImageType> StatisticsImageFilterType;
+    typename StatisticsImageFilterType::Pointer statisticsImageFilter = StatisticsImageFilterType::New();
+    statisticsImageFilter->SetInput(features->m_GradientMagnitudeImage);
+    statisticsImageFilter->Update();
+
+    features->m_GradientMax = statisticsImageFilter->GetMaximum();
+
+    typedef itk::GradientImageFilter<FloatImageType> GradientFilterType;
+
+    typename GradientFilterType::Pointer filter = GradientFilterType::New();
+    // sigma is specified in millimeters
+    // filter->SetSigma( 1.5 );
+    filter->SetInput(castFilter->GetOutput());
+    filter->Update();
+
+    features->m_GradientImage = filter->GetOutput();
+
+    // init zero crossings
+    // typedef  itk::ZeroCrossingImageFilter< TInputImageType, UnsignedCharImageType  > ZeroCrossingImageFilterType;
+    // ZeroCrossingImageFilterType::Pointer zeroCrossingImageFilter = ZeroCrossingImageFilterType::New();
+    // zeroCrossingImageFilter->SetInput(this->m_Image);
+    // zeroCrossingImageFilter->SetBackgroundValue(1);
+    // zeroCrossingImageFilter->SetForegroundValue(0);
+    // zeroCrossingImageFilter->SetNumberOfThreads(4);
+    // zeroCrossingImageFilter->Update();
+
+    // m_EdgeImage = zeroCrossingImageFilter->GetOutput();
+
+    // cast image to float to apply canny edge dection filter
+    /*typedef itk::CastImageFilter< TInputImageType, FloatImageType > CastFilterType;
+    CastFilterType::Pointer castFilter = CastFilterType::New();
+    castFilter->SetInput(this->m_Image);*/
+
+    // typedef itk::LaplacianImageFilter<FloatImageType, FloatImageType >  filterType;
+    // filterType::Pointer laplacianFilter = filterType::New();
+    // laplacianFilter->SetInput( castFilter->GetOutput() ); // NOTE: input image type must be double or float
+    // laplacianFilter->Update();
+
+    // m_EdgeImage = laplacianFilter->GetOutput();
+
+    // init canny edge detection
+    typedef itk::CannyEdgeDetectionImageFilter<FloatImageType, FloatImageType> CannyEdgeDetectionImageFilterType;
+    typename CannyEdgeDetectionImageFilterType::Pointer cannyEdgeDetectionfilter =
+      CannyEdgeDetectionImageFilterType::New();
+    cannyEdgeDetectionfilter->SetInput(castFilter->GetOutput());
+    cannyEdgeDetectionfilter->SetUpperThreshold(30);
+    cannyEdgeDetectionfilter->SetLowerThreshold(15);
+    cannyEdgeDetectionfilter->SetVariance(4);
+    cannyEdgeDetectionfilter->SetMaximumError(.01f);
+
+    cannyEdgeDetectionfilter->Update();
+    features->m_EdgeImage = cannyEdgeDetectionfilter->GetOutput();
+
+    return features;
+  }
+
+  template <class TInputImageType>
+  void ShortestPathCostFunctionLiveWire<TInputImageType>::SetCostFeatures(const CostFeaturesPointer &features)
+  {
+    if (this->m_CostFeatures != features)
+    {
+      this->m_CostFeatures = features;
+      this->Modified();
+      this->m_Initialized = false;
+    }
+  }
+
   template <class TInputImageType>
   void ShortestPathCostFunctionLiveWire<TInputImageType>::Initialize()
   {
     if (!m_Initialized)
     {
-      typedef itk::CastImageFilter<TInputImageType, FloatImageType> CastFilterType;
-      typename CastFilterType::Pointer castFilter = CastFilterType::New();
-      castFilter->SetInput(this->m_Image);
-
-      // init gradient magnitude image
-      typedef itk::GradientMagnitudeImageFilter<FloatImageType, FloatImageType> GradientMagnitudeFilterType;
-      typename GradientMagnitudeFilterType::Pointer gradientFilter = GradientMagnitudeFilterType::New();
-      gradientFilter->SetInput(castFilter->GetOutput());
-      // gradientFilter->SetNumberOfThreads(4);
-      // gradientFilter->GetOutput()->SetRequestedRegion(m_RequestedRegion);
-
-      gradientFilter->Update();
-      this->m_GradientMagnitudeImage = gradientFilter->GetOutput();
-
-      typedef itk::StatisticsImageFilter<FloatImageType> StatisticsImageFilterType;
-      typename StatisticsImageFilterType::Pointer statisticsImageFilter = StatisticsImageFilterType::New();
-      statisticsImageFilter->SetInput(this->m_GradientMagnitudeImage);
-      statisticsImageFilter->Update();
-
-      m_GradientMax = statisticsImageFilter->GetMaximum();
-
-      typedef itk::GradientImageFilter<FloatImageType> GradientFilterType;
-
-      typename GradientFilterType::Pointer filter = GradientFilterType::New();
-      // sigma is specified in millimeters
-      // filter->SetSigma( 1.5 );
-      filter->SetInput(castFilter->GetOutput());
-      filter->Update();
-
-      m_GradientImage = filter->GetOutput();
-
-      // init zero crossings
-      // typedef  itk::ZeroCrossingImageFilter< TInputImageType, UnsignedCharImageType  > ZeroCrossingImageFilterType;
-      // ZeroCrossingImageFilterType::Pointer zeroCrossingImageFilter = ZeroCrossingImageFilterType::New();
-      // zeroCrossingImageFilter->SetInput(this->m_Image);
-      // zeroCrossingImageFilter->SetBackgroundValue(1);
-      // zeroCrossingImageFilter->SetForegroundValue(0);
-      // zeroCrossingImageFilter->SetNumberOfThreads(4);
-      // zeroCrossingImageFilter->Update();
-
-      // m_EdgeImage = zeroCrossingImageFilter->GetOutput();
-
-      // cast image to float to apply canny edge dection filter
-      /*typedef itk::CastImageFilter< TInputImageType, FloatImageType > CastFilterType;
-      CastFilterType::Pointer castFilter = CastFilterType::New();
-      castFilter->SetInput(this->m_Image);*/
-
-      // typedef itk::LaplacianImageFilter<FloatImageType, FloatImageType >  filterType;
-      // filterType::Pointer laplacianFilter = filterType::New();
-      // laplacianFilter->SetInput( castFilter->GetOutput() ); // NOTE: input image type must be double or float
-      // laplacianFilter->Update();
-
-      // m_EdgeImage = laplacianFilter->GetOutput();
-
-      // init canny edge detection
-      typedef itk::CannyEdgeDetectionImageFilter<FloatImageType, FloatImageType> CannyEdgeDetectionImageFilterType;
-      typename CannyEdgeDetectionImageFilterType::Pointer cannyEdgeDetectionfilter =
-        CannyEdgeDetectionImageFilterType::New();
-      cannyEdgeDetectionfilter->SetInput(castFilter->GetOutput());
-      cannyEdgeDetectionfilter->SetUpperThreshold(30);
-      cannyEdgeDetectionfilter->SetLowerThreshold(15);
-      cannyEdgeDetectionfilter->SetVariance(4);
-      cannyEdgeDetectionfilter->SetMaximumError(.01f);
-
-      cannyEdgeDetectionfilter->Update();
-      m_EdgeImage = cannyEdgeDetectionfilter->GetOutput();
+      // precomputed features are only used if they fit to the image
+      if (nullptr == m_CostFeatures || m_CostFeatures->m_GradientMagnitudeImage->GetLargestPossibleRegion() !=
+                                          this->m_Image->GetLargestPossibleRegion())
+      {
+        m_CostFeatures = ComputeCostFeatures(this->m_Image);
+      }
+
+      m_GradientMagnitudeImage = m_CostFeatures->m_GradientMagnitudeImage;
+      m_GradientMax = m_CostFeatures->m_GradientMax;
+      m_GradientImage = m_CostFeatures->m_GradientImage;
+      m_EdgeImage = m_CostFeatures->m_EdgeImage;
 
       // set minCosts
       m_MinCosts = 0.0; // The lower, the more thouroughly! 0 = dijkstra. If estimate costs are lower than actual costs
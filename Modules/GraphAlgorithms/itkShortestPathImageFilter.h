@@ -23,6 +23,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <itkMacro.h>
 
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
 // ------- INFORMATION ----------
 /// SET FUNCTIONS
 // void SetInput( ItkImage ) // Compulsory
@@ -39,6 +43,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 // for GetVectorOrderImage
 // void AddEndIndex(const IndexType & EndIndex) //Optional. By calling this function you can add several endpoints! The
 // algorithm will look for several shortest Pathes. From Start to all Endpoints.
+// void SetSearchRegion(const RegionType & region) // Optional (default=empty, i.e. whole image), only pixels inside
+// this window are visited. End points outside the window cannot be reached.
+// void SetReuseSearchTree(bool) // Optional (default=true), successive queries from the same start point continue
+// the search of the previous query instead of starting from scratch
 //
 /// GET FUNCTIONS
 // std::vector< itk::Index<3> > GetVectorPath(); // returns the shortest path as vector
@@ -72,6 +80,7 @@ namespace itk
     typedef typename TInputImageType::PixelType InputImagePixelType;
     typedef typename TInputImageType::SizeType InputImageSizeType;
     typedef typename TInputImageType::IndexType IndexType;
+    typedef typename TInputImageType::RegionType RegionType;
     typedef typename itk::ImageRegionIteratorWithIndex<InputImageType> InputImageIteratorType;
 
     typedef TOutputImageType OutputImageType;
@@ -105,6 +114,18 @@ namespace itk
     // \brief Set Endpoint for ShortestPath Calculation
     void SetEndIndex(const IndexType &EndIndex);
 
+    // \brief Restricts the search to the given window (default=empty region, i.e. no restriction). Only nodes inside
+    // the window are visited, thus end points must lie inside the window.
+    void SetSearchRegion(const RegionType &region);
+    itkGetConstReferenceMacro(SearchRegion, RegionType);
+
+    // \brief (default=true), Reuse the search tree of the previous query, if the start point, the input and the cost
+    // function did not change in between. Nodes that are already closed do not need to be visited again, so moving
+    // the end point around the same start point (e.g. LiveWire) becomes cheap. The search tree is never reused for
+    // multiple end points or if the vector order is stored.
+    itkSetMacro(ReuseSearchTree, bool);
+    itkGetMacro(ReuseSearchTree, bool);
+
     // \brief Set FullNeighborsMode. false = no diagonal neighbors, in 2D this means N4 Neigborhood. true = would be N8
     // in 2D
     itkSetMacro(FullNeighborsMode, bool);
@@ -163,7 +184,18 @@ namespace itk
       m_endPoints; // if you fill this vector, the algo will not rest until all endPoints have been reached
     std::vector<IndexType> m_endPointsClosed;
 
-    ShortestPathNode *m_Nodes; // main list that contains all nodes
+    // Nodes are only created when they are discovered, so the memory consumption and initialization costs depend
+    // on the visited part of the image and not on its size.
+    typedef std::unordered_map<NodeNumType, ShortestPathNode> NodeMapType;
+    NodeMapType m_Nodes; // main list that contains all discovered nodes
+
+    // Binary heap of discovered nodes, ordered by distAndEst. Entries are not removed when the distance of a node
+    // decreases; outdated entries (closed nodes or entries with a different key) are skipped when popped.
+    typedef std::pair<DistanceType, NodeNumType> FrontierEntryType;
+    typedef std::priority_queue<FrontierEntryType, std::vector<FrontierEntryType>, std::greater<FrontierEntryType>>
+      FrontierType;
+    FrontierType m_Frontier;
+
     NodeNumType m_Graph_NumberOfNodes;
     NodeNumType m_Graph_StartNode;
     NodeNumType m_Graph_EndNode;
@@ -184,7 +216,17 @@ namespace itk
 
     bool m_ActivateTimeOut; // if true, then i search max. 30 secs. then abort
 
-    bool m_Initialized;
+    bool m_Initialized; // true if m_Nodes and m_Frontier contain a valid search tree for the current start node
+
+    RegionType m_SearchRegion;
+    bool m_ReuseSearchTree;
+
+    // state the current search tree was built for
+    TimeStamp m_SearchTreeTime;
+    const InputImageType *m_SearchTreeInput;
+    const CostFunctionType *m_SearchTreeCostFunction;
+    NodeNumType m_SearchTreeEndNode;
+    bool m_SearchTreeFullNeighbors;
 
     CostFunctionTypePointer m_CostFunction;
     IndexType m_StartIndex, m_EndIndex;
@@ -214,12 +256,18 @@ namespace itk
     // \brief Convert image coordinate to a indexnumber of a node in m_Nodes
     unsigned int CoordToNode(IndexType);
 
-    // \brief Returns the neighbors of a node
-    std::vector<ShortestPathNode *> GetNeighbors(NodeNumType nodeNum, bool FullNeighbors);
+    // \brief Returns the node with the given number. Nodes that have not been discovered yet are created.
+    ShortestPathNode &GetNode(NodeNumType nodeNum);
 
-    // \brief Check if coords are in bounds of image
+    // \brief Fills nodeList with the neighbors of a node
+    void GetNeighbors(NodeNumType nodeNum, bool FullNeighbors, std::vector<ShortestPathNode *> &nodeList);
+
+    // \brief Check if coords are in bounds of image (and of the search region, if set)
     bool CoordIsInBounds(IndexType);
 
+    // \brief Checks if the search tree of the previous query may be continued
+    bool CanReuseSearchTree(NodeNumType numberOfNodes) const;
+
     // \brief Initializes the graph
     void InitGraph();
 
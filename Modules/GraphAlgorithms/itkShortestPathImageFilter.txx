@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkMemoryUtilities.h"
 #include <ctime>
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <vector>
 
@@ -29,8 +30,7 @@ namespace itk
   // Constructor  (initialize standard values)
   template <class TInputImageType, class TOutputImageType>
   ShortestPathImageFilter<TInputImageType, TOutputImageType>::ShortestPathImageFilter()
-    : m_Nodes(nullptr),
-      m_Graph_NumberOfNodes(0),
+    : m_Graph_NumberOfNodes(0),
       m_Graph_fullNeighbors(false),
       m_FullNeighborsMode(false),
       m_MakeOutputImage(true),
@@ -38,7 +38,12 @@ namespace itk
       m_CalcAllDistances(false),
       multipleEndPoints(false),
       m_ActivateTimeOut(false),
-      m_Initialized(false)
+      m_Initialized(false),
+      m_ReuseSearchTree(true),
+      m_SearchTreeInput(nullptr),
+      m_SearchTreeCostFunction(nullptr),
+      m_SearchTreeEndNode(0),
+      m_SearchTreeFullNeighbors(false)
   {
     m_endPoints.clear();
     m_endPointsClosed.clear();
@@ -53,7 +58,6 @@ namespace itk
   template <class TInputImageType, class TOutputImageType>
   ShortestPathImageFilter<TInputImageType, TOutputImageType>::~ShortestPathImageFilter()
   {
-    delete[] m_Nodes;
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -128,7 +132,7 @@ namespace itk
       if ((coord[0] >= 0) && ((unsigned long)coord[0] < size[0]) && (coord[1] >= 0) &&
           ((unsigned long)coord[1] < size[1]))
       {
-        return true;
+        return m_SearchRegion.GetNumberOfPixels() == 0 || m_SearchRegion.IsInside(coord);
       }
     }
     if (dim == 3)
@@ -136,21 +140,38 @@ namespace itk
       if ((coord[0] >= 0) && ((unsigned long)coord[0] < size[0]) && (coord[1] >= 0) &&
           ((unsigned long)coord[1] < size[1]) && (coord[2] >= 0) && ((unsigned long)coord[2] < size[2]))
       {
-        return true;
+        return m_SearchRegion.GetNumberOfPixels() == 0 || m_SearchRegion.IsInside(coord);
       }
     }
     return false;
   }
 
   template <class TInputImageType, class TOutputImageType>
-  inline std::vector<ShortestPathNode *> ShortestPathImageFilter<TInputImageType, TOutputImageType>::GetNeighbors(
-    unsigned int nodeNum, bool FullNeighbors)
+  inline ShortestPathNode &ShortestPathImageFilter<TInputImageType, TOutputImageType>::GetNode(NodeNumType nodeNum)
   {
-    // returns a vector of nodepointers.. these nodes are the neighbors
+    auto iter = m_Nodes.find(nodeNum);
+    if (iter == m_Nodes.end())
+    {
+      ShortestPathNode node;
+      node.distAndEst = -1;
+      node.distance = -1;
+      node.prevNode = -1;
+      node.mainListIndex = nodeNum;
+      node.closed = false;
+      iter = m_Nodes.insert(std::make_pair(nodeNum, node)).first;
+    }
+    return iter->second;
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  inline void ShortestPathImageFilter<TInputImageType, TOutputImageType>::GetNeighbors(
+    NodeNumType nodeNum, bool FullNeighbors, std::vector<ShortestPathNode *> &nodeList)
+  {
+    // fills the vector with nodepointers.. these nodes are the neighbors
     int dim = InputImageType::ImageDimension;
     IndexType Coord = NodeToCoord(nodeNum);
     IndexType NeighborCoord;
-    std::vector<ShortestPathNode *> nodeList;
+    nodeList.clear();
 
     int neighborDistance = 1; // if i increase that, i might not hit the endnote
 
@@ -162,22 +183,22 @@ namespace itk
       NeighborCoord[0] = Coord[0];
       NeighborCoord[1] = Coord[1] - neighborDistance;
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
       NeighborCoord[0] = Coord[0] + neighborDistance;
       NeighborCoord[1] = Coord[1];
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
       NeighborCoord[0] = Coord[0];
       NeighborCoord[1] = Coord[1] + neighborDistance;
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
       NeighborCoord[0] = Coord[0] - neighborDistance;
       NeighborCoord[1] = Coord[1];
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
       if (FullNeighbors)
       {
@@ -185,22 +206,22 @@ namespace itk
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
       }
     }
     if (dim == 3)
@@ -210,37 +231,37 @@ namespace itk
       NeighborCoord[1] = Coord[1] - neighborDistance;
       NeighborCoord[2] = Coord[2];
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
       NeighborCoord[0] = Coord[0] + neighborDistance;
       NeighborCoord[1] = Coord[1];
       NeighborCoord[2] = Coord[2];
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
       NeighborCoord[0] = Coord[0];
       NeighborCoord[1] = Coord[1] + neighborDistance;
       NeighborCoord[2] = Coord[2];
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
       NeighborCoord[0] = Coord[0] - neighborDistance;
       NeighborCoord[1] = Coord[1];
       NeighborCoord[2] = Coord[2];
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
       NeighborCoord[0] = Coord[0];
       NeighborCoord[1] = Coord[1];
       NeighborCoord[2] = Coord[2] + neighborDistance;
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
       NeighborCoord[0] = Coord[0];
       NeighborCoord[1] = Coord[1];
       NeighborCoord[2] = Coord[2] - neighborDistance;
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
       if (FullNeighbors)
       {
@@ -250,134 +271,139 @@ namespace itk
         NeighborCoord[1] = Coord[1] - neighborDistance;
         NeighborCoord[2] = Coord[2];
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1] - neighborDistance;
         NeighborCoord[2] = Coord[2];
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1] + neighborDistance;
         NeighborCoord[2] = Coord[2];
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1] + neighborDistance;
         NeighborCoord[2] = Coord[2];
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         // BackSlice (Diagonal)
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1] - neighborDistance;
         NeighborCoord[2] = Coord[2] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1] - neighborDistance;
         NeighborCoord[2] = Coord[2] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1] + neighborDistance;
         NeighborCoord[2] = Coord[2] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1] + neighborDistance;
         NeighborCoord[2] = Coord[2] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         // BackSlice (Non-Diag)
         NeighborCoord[0] = Coord[0];
         NeighborCoord[1] = Coord[1] - neighborDistance;
         NeighborCoord[2] = Coord[2] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1];
         NeighborCoord[2] = Coord[2] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0];
         NeighborCoord[1] = Coord[1] + neighborDistance;
         NeighborCoord[2] = Coord[2] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1];
         NeighborCoord[2] = Coord[2] - neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         // FrontSlice (Diagonal)
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1] - neighborDistance;
         NeighborCoord[2] = Coord[2] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1] - neighborDistance;
         NeighborCoord[2] = Coord[2] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1] + neighborDistance;
         NeighborCoord[2] = Coord[2] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1] + neighborDistance;
         NeighborCoord[2] = Coord[2] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         // FrontSlice(Non-Diag)
         NeighborCoord[0] = Coord[0];
         NeighborCoord[1] = Coord[1] - neighborDistance;
         NeighborCoord[2] = Coord[2] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] + neighborDistance;
         NeighborCoord[1] = Coord[1];
         NeighborCoord[2] = Coord[2] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0];
         NeighborCoord[1] = Coord[1] + neighborDistance;
         NeighborCoord[2] = Coord[2] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
 
         NeighborCoord[0] = Coord[0] - neighborDistance;
         NeighborCoord[1] = Coord[1];
         NeighborCoord[2] = Coord[2] + neighborDistance;
         if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+          nodeList.push_back(&GetNode(CoordToNode(NeighborCoord)));
       }
     }
-    return nodeList;
   }
 
   template <class TInputImageType, class TOutputImageType>
   void ShortestPathImageFilter<TInputImageType, TOutputImageType>::SetStartIndex(
     const typename TInputImageType::IndexType &StartIndex)
   {
+    if (m_Initialized && m_StartIndex == StartIndex)
+    {
+      // keep the search tree, it might be reused by the next query
+      return;
+    }
+
     for (unsigned int i = 0; i < TInputImageType::ImageDimension; ++i)
     {
       m_StartIndex[i] = StartIndex[i];
@@ -386,6 +412,7 @@ namespace itk
     // MITK_INFO << "StartIndex = " << StartIndex;
     // MITK_INFO << "StartNode = " << m_Graph_StartNode;
     m_Initialized = false;
+    this->Modified();
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -398,6 +425,18 @@ namespace itk
     }
     m_Graph_EndNode = CoordToNode(m_EndIndex);
     // MITK_INFO << "EndNode = " << m_Graph_EndNode;
+    this->Modified();
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  void ShortestPathImageFilter<TInputImageType, TOutputImageType>::SetSearchRegion(const RegionType &region)
+  {
+    if (m_SearchRegion != region)
+    {
+      m_SearchRegion = region;
+      m_Initialized = false;
+      this->Modified();
+    }
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -420,51 +459,82 @@ namespace itk
     const typename TInputImageType::IndexType &a)
   {
     // Returns the minimal possible costs for a path from "a" to targetnode.
-    itk::Vector<float, 3> v;
-    v[0] = m_EndIndex[0] - a[0];
-    v[1] = m_EndIndex[1] - a[1];
-    v[2] = m_EndIndex[2] - a[2];
+    double squaredNorm = 0.0;
+    for (unsigned int i = 0; i < TInputImageType::ImageDimension; ++i)
+    {
+      const double difference = m_EndIndex[i] - a[i];
+      squaredNorm += difference * difference;
+    }
 
-    return m_CostFunction->GetMinCost() * v.GetNorm();
+    return m_CostFunction->GetMinCost() * std::sqrt(squaredNorm);
   }
 
   template <class TInputImageType, class TOutputImageType>
-  void ShortestPathImageFilter<TInputImageType, TOutputImageType>::InitGraph()
+  bool ShortestPathImageFilter<TInputImageType, TOutputImageType>::CanReuseSearchTree(NodeNumType numberOfNodes) const
   {
-    if (!m_Initialized)
-    {
-      // Clean up previous stuff
-      CleanUp();
+    // Closed nodes keep their (optimal) distance independent of the target, as long as the costs do not change.
+    // This only holds while the heuristic of getEstimatedCostsToTarget() (MinCost times the Euclidean distance) is
+    // consistent, i.e. GetCost() of every step is at least GetMinCost() times the length of the step. With an
+    // inconsistent heuristic, nodes may be closed before their optimal distance is known and reusing them for
+    // another target returns suboptimal paths.
+    return m_Initialized && m_ReuseSearchTree && !multipleEndPoints && !m_StoreVectorOrder &&
+           numberOfNodes == m_Graph_NumberOfNodes && m_SearchTreeFullNeighbors == m_Graph_fullNeighbors &&
+           m_SearchTreeInput == this->GetInput() && m_SearchTreeCostFunction == m_CostFunction.GetPointer() &&
+           this->GetInput()->GetMTime() < m_SearchTreeTime.GetMTime() &&
+           m_CostFunction->GetMTime() < m_SearchTreeTime.GetMTime();
+  }
 
-      // Calc Number of nodes
-      auto imageDimensions = TInputImageType::ImageDimension;
-      const InputImageSizeType &size = this->GetInput()->GetRequestedRegion().GetSize();
-      m_Graph_NumberOfNodes = 1;
-      for (NodeNumType i = 0; i < imageDimensions; ++i)
-        m_Graph_NumberOfNodes = m_Graph_NumberOfNodes * size[i];
+  template <class TInputImageType, class TOutputImageType>
+  void ShortestPathImageFilter<TInputImageType, TOutputImageType>::InitGraph()
+  {
+    // initalize cost function
+    m_CostFunction->Initialize();
 
-      // Initialize mainNodeList with that number
-      m_Nodes = new ShortestPathNode[m_Graph_NumberOfNodes];
+    // Calc Number of nodes
+    auto imageDimensions = TInputImageType::ImageDimension;
+    const InputImageSizeType &size = this->GetInput()->GetRequestedRegion().GetSize();
+    NodeNumType numberOfNodes = 1;
+    for (NodeNumType i = 0; i < imageDimensions; ++i)
+      numberOfNodes = numberOfNodes * size[i];
 
-      // Initialize each node in nodelist
-      for (NodeNumType i = 0; i < m_Graph_NumberOfNodes; i++)
+    if (CanReuseSearchTree(numberOfNodes))
+    {
+      if (m_Graph_EndNode != m_SearchTreeEndNode)
       {
-        m_Nodes[i].distAndEst = -1;
-        m_Nodes[i].distance = -1;
-        m_Nodes[i].prevNode = -1;
-        m_Nodes[i].mainListIndex = i;
-        m_Nodes[i].closed = false;
+        // The estimates of the open nodes refer to the old target, so the frontier has to be rebuilt. The closed
+        // nodes stay closed, they do not depend on the target (requires a consistent heuristic, see
+        // CanReuseSearchTree()).
+        m_Frontier = FrontierType();
+        for (auto &iter : m_Nodes)
+        {
+          ShortestPathNode &node = iter.second;
+          if (!node.closed && node.distance != -1)
+          {
+            node.distAndEst = node.distance + getEstimatedCostsToTarget(NodeToCoord(node.mainListIndex));
+            m_Frontier.push(FrontierEntryType(node.distAndEst, node.mainListIndex));
+          }
+        }
+        m_SearchTreeEndNode = m_Graph_EndNode;
       }
-
-      m_Initialized = true;
+      return;
     }
 
-    // In the beginning, the Startnode needs a distance of 0
-    m_Nodes[m_Graph_StartNode].distance = 0;
-    m_Nodes[m_Graph_StartNode].distAndEst = 0;
+    // Clean up previous stuff
+    CleanUp();
+    m_Graph_NumberOfNodes = numberOfNodes;
 
-    // initalize cost function
-    m_CostFunction->Initialize();
+    // In the beginning, the Startnode needs a distance of 0
+    ShortestPathNode &startNode = GetNode(m_Graph_StartNode);
+    startNode.distance = 0;
+    startNode.distAndEst = 0;
+    m_Frontier.push(FrontierEntryType(startNode.distAndEst, m_Graph_StartNode));
+
+    m_SearchTreeTime.Modified();
+    m_SearchTreeInput = this->GetInput();
+    m_SearchTreeCostFunction = m_CostFunction.GetPointer();
+    m_SearchTreeEndNode = m_Graph_EndNode;
+    m_SearchTreeFullNeighbors = m_Graph_fullNeighbors;
+    m_Initialized = true;
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -481,43 +551,38 @@ namespace itk
     DistanceType curNodeDistance = 0;
     NodeNumType numberOfNodesChecked = 0;
 
-    // Create Multimap (tree structure for fast searching)
-    std::multimap<double, ShortestPathNode *> myMap;
-    std::pair<std::multimap<double, ShortestPathNode *>::iterator, std::multimap<double, ShortestPathNode *>::iterator>
-      ret;
-    std::multimap<double, ShortestPathNode *>::iterator it;
+    std::vector<ShortestPathNode *> neighborNodes;
 
-    // At first, only startNote is discovered.
-    myMap.insert(
-      std::pair<double, ShortestPathNode *>(m_Nodes[m_Graph_StartNode].distAndEst, &m_Nodes[m_Graph_StartNode]));
+    // If the target has already been closed by a previous query from the same start node, its path is known.
+    if (!multipleEndPoints && !m_CalcAllDistances)
+    {
+      auto endIter = m_Nodes.find(m_Graph_EndNode);
+      if (endIter != m_Nodes.end() && endIter->second.closed)
+      {
+        return;
+      }
+    }
 
     // While there are discovered Nodes, pick the one with lowest distance,
     // update its neighbors and eventually delete it from the discovered Nodes list.
-    while (!myMap.empty())
+    while (!m_Frontier.empty())
     {
-      numberOfNodesChecked++;
-      /*if ( (numberOfNodesChecked % (m_Graph_NumberOfNodes/100)) == 0)
-      {
-        MITK_INFO << "Checked " << ( numberOfNodesChecked / (m_Graph_NumberOfNodes/100) ) << "% List: " << myMap.size()
-      << "\n";
-      }*/
-
-      // Get element with lowest score
-      mainNodeListIndex = myMap.begin()->second->mainListIndex;
-      curNodeDistance = myMap.begin()->second->distance;
-      myMap.begin()->second->closed = true; // close it
-
-      // Debug:
-      // MITK_INFO << "INFO: size " << myMap.size();
-      /*
-      for (it = myMap.begin(); it != myMap.end(); ++it)
+      // Get element with lowest score and kick it out
+      const FrontierEntryType entry = m_Frontier.top();
+      m_Frontier.pop();
+
+      ShortestPathNode &curNode = m_Nodes.find(entry.second)->second;
+      if (curNode.closed || entry.first != curNode.distAndEst)
       {
-      MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
+        // outdated entry, the node has been reinserted with a lower distance
+        continue;
       }
-      */
 
-      // Kicks out element with lowest score
-      myMap.erase(myMap.begin());
+      numberOfNodesChecked++;
+
+      mainNodeListIndex = curNode.mainListIndex;
+      curNodeDistance = curNode.distance;
+      curNode.closed = true; // close it
 
       // if wanted, store vector order
       if (m_StoreVectorOrder)
@@ -526,138 +591,26 @@ namespace itk
       }
 
       // Check neighbors
-      std::vector<ShortestPathNode *> neighborNodes = GetNeighbors(mainNodeListIndex, m_Graph_fullNeighbors);
+      IndexType coordCurNode = NodeToCoord(mainNodeListIndex);
+      GetNeighbors(mainNodeListIndex, m_Graph_fullNeighbors, neighborNodes);
       for (NodeNumType i = 0; i < neighborNodes.size(); i++)
       {
         if (neighborNodes[i]->closed)
           continue; // this nodes is already closed, go to next neighbor
 
-        IndexType coordCurNode = NodeToCoord(mainNodeListIndex);
         IndexType coordNeighborNode = NodeToCoord(neighborNodes[i]->mainListIndex);
 
         // calculate the new Distance to the current neighbor
         double newDistance = curNodeDistance + (m_CostFunction->GetCost(coordCurNode, coordNeighborNode));
 
         // if it is shorter than any yet known path to this neighbor, than the current path is better. Save that!
+        // The node is (re)inserted into the frontier, an older entry of it will be skipped.
         if ((newDistance < neighborNodes[i]->distance) || (neighborNodes[i]->distance == -1))
         {
-          // if that neighbornode is not in discoverednodeList yet, Push it there and update
-          if (neighborNodes[i]->distance == -1)
-          {
-            neighborNodes[i]->distance = newDistance;
-            neighborNodes[i]->distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
-            neighborNodes[i]->prevNode = mainNodeListIndex;
-            myMap.insert(std::pair<double, ShortestPathNode *>(m_Nodes[neighborNodes[i]->mainListIndex].distAndEst,
-                                                               &m_Nodes[neighborNodes[i]->mainListIndex]));
-            /*
-            MITK_INFO << "Inserted: " << m_Nodes[neighborNodes[i]->mainListIndex].distAndEst << "|" <<
-            m_Nodes[neighborNodes[i]->mainListIndex].mainListIndex;
-            MITK_INFO << "INFO: size " << myMap.size();
-            for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-            }
-            */
-          }
-          // or if is already in discoverednodelist, update
-          else
-          {
-            /*
-            it = myMap.find(neighborNodes[i]->distAndEst);
-            if (it == myMap.end() )
-            {
-            MITK_INFO << "Nothing!";
-            // look further
-            for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            if ((*it).second->mainListIndex == lookForId)
-            {
-            MITK_INFO << "But it is there!!!";
-            MITK_INFO << "Searched for: " << lookFor << "   but had: " << (*it).second->distAndEst;
-            }
-
-            }
-            }
-            */
-
-            // 1st : find and delete old element
-            bool found = false;
-            ret = myMap.equal_range(neighborNodes[i]->distAndEst);
-
-            if ((ret.first == ret.second))
-            {
-              /*+++++++++++++ no exact match +++++++++++++*/
-              // MITK_INFO << "No exact match!"; // if this happens, you are screwed
-              /*
-              MITK_INFO << "Was looking for: " << lookFor << "  ID: " << lookForId;
-              if (ret.first != myMap.end() )
-              {
-              it = ret.first;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              ++it;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              --it;
-              --it;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              }
-
-              // look if that ID is found in the map
-              for (it = myMap.begin(); it != myMap.end(); ++it)
-              {
-              if ((*it).second->mainListIndex == lookForId)
-              {
-              MITK_INFO << "But it is there!!!";
-              MITK_INFO << "Searched dist: " << lookFor << "  found dist: " << (*it).second->distAndEst;
-              }
-
-              }
-              */
-            }
-            else
-            {
-              for (it = ret.first; it != ret.second; ++it)
-              {
-                if (it->second->mainListIndex == neighborNodes[i]->mainListIndex)
-                {
-                  found = true;
-                  myMap.erase(it);
-                  /*
-                  MITK_INFO << "INFO: size " << myMap.size();
-                  MITK_INFO << "Erase: " << it->first << "|" << it->second->mainListIndex;
-
-                  MITK_INFO << "INFO: size " << myMap.size();
-                  for (it = myMap.begin(); it != myMap.end(); ++it)
-                  {
-                  MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-                  }
-                  */
-                  break;
-                }
-              }
-            }
-
-            if (!found)
-            {
-              // MITK_INFO << "Could not find it! :(";
-              continue;
-            }
-
-            // 2nd: update and insert new element
-            neighborNodes[i]->distance = newDistance;
-            neighborNodes[i]->distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
-            neighborNodes[i]->prevNode = mainNodeListIndex;
-            // myMap.insert( std::pair<double,ShortestPathNode*> (neighborNodes[i]->distAndEst, neighborNodes[i]));
-            myMap.insert(std::pair<double, ShortestPathNode *>(m_Nodes[neighborNodes[i]->mainListIndex].distAndEst,
-                                                               &m_Nodes[neighborNodes[i]->mainListIndex]));
-
-            // MITK_INFO << "Re-Inserted: " << m_Nodes[neighborNodes[i]->mainListIndex].distAndEst << "|" <<
-            // m_Nodes[neighborNodes[i]->mainListIndex].mainListIndex;
-            // MITK_INFO << "INFO: size " << myMap.size();
-            /*for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-            }*/
-          }
+          neighborNodes[i]->distance = newDistance;
+          neighborNodes[i]->distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
+          neighborNodes[i]->prevNode = mainNodeListIndex;
+          m_Frontier.push(FrontierEntryType(neighborNodes[i]->distAndEst, neighborNodes[i]->mainListIndex));
         }
       }
       // finished with checking all neighbors.
@@ -786,15 +739,15 @@ namespace itk
     image->Allocate();
     ;
     OutputImageIteratorType distanceImageIt(image, image->GetRequestedRegion());
-    // Create Distance Image (Output 1)
-    NodeNumType myNodeNum;
+    // Create Distance Image (Output 1), pixels that have not been discovered get -1
     for (distanceImageIt.GoToBegin(); !distanceImageIt.IsAtEnd(); ++distanceImageIt)
     {
       IndexType index = distanceImageIt.GetIndex();
-      myNodeNum = CoordToNode(index);
-      double newVal = m_Nodes[myNodeNum].distance;
+      auto iter = m_Nodes.find(CoordToNode(index));
+      double newVal = iter != m_Nodes.end() ? iter->second.distance : -1;
       distanceImageIt.Set(newVal);
     }
+    return image;
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -822,6 +775,13 @@ namespace itk
       // fill m_VectorPath with the Shortest Path
       m_VectorPath.clear();
 
+      // the end node has not been reached (e.g. it is outside of the search region or a timeout occured)
+      auto endIter = m_Nodes.find(m_Graph_EndNode);
+      if (endIter == m_Nodes.end() || endIter->second.distance == -1)
+      {
+        return;
+      }
+
       // Go backwards from endnote to startnode
       NodeNumType prevNode = m_Graph_EndNode;
       while (prevNode != m_Graph_StartNode)
@@ -863,8 +823,9 @@ namespace itk
     m_VectorPath.clear();
     // TODO: if multiple Path, clear all multiple Paths
 
-    if (m_Nodes)
-      delete[] m_Nodes;
+    m_Nodes.clear();
+    m_Frontier = FrontierType();
+    m_Initialized = false;
   }
 
   template <class TInputImageType, class TOutputImageType>
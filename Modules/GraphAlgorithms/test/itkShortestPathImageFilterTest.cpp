@@ -0,0 +1,385 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include <mitkTestFixture.h>
+
+#include <itkShortestPathImageFilter.h>
+
+#include <itkImageRegionIterator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <vector>
+
+namespace
+{
+  typedef itk::Image<float, 2> CostImageType;
+
+  // Cost of a step is the mean of both pixel values times the step length, so the minimal pixel value times the
+  // euclidean distance is a consistent estimate for A*.
+  class TestCostFunction : public itk::ShortestPathCostFunction<CostImageType>
+  {
+  public:
+    typedef TestCostFunction Self;
+    typedef itk::ShortestPathCostFunction<CostImageType> Superclass;
+    typedef itk::SmartPointer<Self> Pointer;
+    typedef itk::SmartPointer<const Self> ConstPointer;
+
+    itkNewMacro(Self);
+    itkTypeMacro(TestCostFunction, ShortestPathCostFunction);
+
+    double GetCost(IndexType p1, IndexType p2) override
+    {
+      const double dx = p1[0] - p2[0];
+      const double dy = p1[1] - p2[1];
+      return 0.5 * (m_Image->GetPixel(p1) + m_Image->GetPixel(p2)) * std::sqrt(dx * dx + dy * dy);
+    }
+
+    double GetMinCost() override { return m_MinCost; }
+
+    void Initialize() override
+    {
+      m_MinCost = std::numeric_limits<double>::max();
+      for (itk::ImageRegionConstIterator<CostImageType> it(m_Image, m_Image->GetLargestPossibleRegion()); !it.IsAtEnd();
+           ++it)
+      {
+        m_MinCost = std::min<double>(m_MinCost, it.Get());
+      }
+    }
+
+  protected:
+    TestCostFunction() : m_MinCost(0.0) {}
+
+    double m_MinCost;
+  };
+}
+
+class itkShortestPathImageFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(itkShortestPathImageFilterTestSuite);
+  MITK_TEST(PathsMatchFullDijkstra);
+  MITK_TEST(FullNeighborPathsMatchFullDijkstra);
+  MITK_TEST(DistancesMatchFullDijkstra);
+  MITK_TEST(ReusedSearchTreeMatchesFreshSearch);
+  MITK_TEST(SearchTreeIsNotReusedForModifiedInput);
+  MITK_TEST(TargetOutsideOfSearchRegion);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::ShortestPathImageFilter<CostImageType, CostImageType> FilterType;
+  typedef FilterType::IndexType IndexType;
+  typedef std::vector<IndexType> PathType;
+
+  static const unsigned int ImageSize = 96;
+
+  CostImageType::Pointer m_Image;
+  TestCostFunction::Pointer m_CostFunction;
+
+  void FillRandomCosts(unsigned int seed)
+  {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> distribution(1.0f, 10.0f);
+    for (itk::ImageRegionIterator<CostImageType> it(m_Image, m_Image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+    {
+      it.Set(distribution(generator));
+    }
+  }
+
+  IndexType MakeIndex(itk::IndexValueType x, itk::IndexValueType y)
+  {
+    IndexType index;
+    index[0] = x;
+    index[1] = y;
+    return index;
+  }
+
+  CostImageType::RegionType MakeRegion(const IndexType &center, itk::IndexValueType radius)
+  {
+    CostImageType::RegionType region;
+    region.SetIndex(MakeIndex(center[0] - radius, center[1] - radius));
+    region.SetSize(0, 2 * radius + 1);
+    region.SetSize(1, 2 * radius + 1);
+    region.Crop(m_Image->GetLargestPossibleRegion());
+    return region;
+  }
+
+  FilterType::Pointer CreateFilter(bool fullNeighbors = false)
+  {
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(m_Image);
+    filter->SetCostFunction(m_CostFunction);
+    filter->SetGraph_fullNeighbors(fullNeighbors);
+    filter->SetMakeOutputImage(false);
+    return filter;
+  }
+
+  PathType ComputePath(FilterType *filter, const IndexType &start, const IndexType &end)
+  {
+    filter->SetStartIndex(start);
+    filter->SetEndIndex(end);
+    filter->Update();
+    return filter->GetVectorPath();
+  }
+
+  // The plain Dijkstra over the whole image (or region) the filter used before the search was restricted to the
+  // discovered nodes. Returns the distances of all pixels, unreachable pixels get -1.
+  std::vector<double> ComputeDijkstraDistances(const IndexType &start,
+                                               bool fullNeighbors,
+                                               const CostImageType::RegionType &region)
+  {
+    typedef std::pair<double, itk::OffsetValueType> EntryType;
+
+    std::vector<double> distances(ImageSize * ImageSize, -1.0);
+    std::vector<bool> closed(ImageSize * ImageSize, false);
+    std::priority_queue<EntryType, std::vector<EntryType>, std::greater<EntryType>> frontier;
+
+    const int numberOfOffsets = fullNeighbors ? 8 : 4;
+    const int offsets[8][2] = {{0, -1}, {1, 0}, {0, 1}, {-1, 0}, {-1, -1}, {1, -1}, {-1, 1}, {1, 1}};
+
+    distances[start[1] * ImageSize + start[0]] = 0.0;
+    frontier.push(EntryType(0.0, start[1] * ImageSize + start[0]));
+    while (!frontier.empty())
+    {
+      const EntryType entry = frontier.top();
+      frontier.pop();
+      if (closed[entry.second])
+        continue;
+      closed[entry.second] = true;
+
+      const IndexType current = MakeIndex(entry.second % ImageSize, entry.second / ImageSize);
+      for (int i = 0; i < numberOfOffsets; ++i)
+      {
+        const IndexType neighbor = MakeIndex(current[0] + offsets[i][0], current[1] + offsets[i][1]);
+        if (!region.IsInside(neighbor))
+          continue;
+
+        const itk::OffsetValueType node = neighbor[1] * ImageSize + neighbor[0];
+        const double distance = entry.first + m_CostFunction->GetCost(current, neighbor);
+        if (!closed[node] && (distances[node] == -1.0 || distance < distances[node]))
+        {
+          distances[node] = distance;
+          frontier.push(EntryType(distance, node));
+        }
+      }
+    }
+    return distances;
+  }
+
+  std::vector<double> ComputeDijkstraDistances(const IndexType &start, bool fullNeighbors = false)
+  {
+    return ComputeDijkstraDistances(start, fullNeighbors, m_Image->GetLargestPossibleRegion());
+  }
+
+  double GetDistance(const std::vector<double> &distances, const IndexType &index)
+  {
+    return distances[index[1] * ImageSize + index[0]];
+  }
+
+  // Checks that the path connects start and end with neighboring pixels and returns its costs.
+  double GetPathCosts(const PathType &path, const IndexType &start, const IndexType &end, bool fullNeighbors)
+  {
+    CPPUNIT_ASSERT(!path.empty());
+    CPPUNIT_ASSERT_EQUAL(start, path.front());
+    CPPUNIT_ASSERT_EQUAL(end, path.back());
+
+    double costs = 0.0;
+    for (std::size_t i = 1; i < path.size(); ++i)
+    {
+      const auto dx = std::abs(path[i][0] - path[i - 1][0]);
+      const auto dy = std::abs(path[i][1] - path[i - 1][1]);
+      CPPUNIT_ASSERT(dx <= 1 && dy <= 1 && dx + dy > 0);
+      CPPUNIT_ASSERT(fullNeighbors || dx + dy == 1);
+      costs += m_CostFunction->GetCost(path[i - 1], path[i]);
+    }
+    return costs;
+  }
+
+  void AssertShortestPath(const PathType &path,
+                          const IndexType &start,
+                          const IndexType &end,
+                          const std::vector<double> &distances,
+                          bool fullNeighbors = false)
+  {
+    const double expected = GetDistance(distances, end);
+    CPPUNIT_ASSERT(expected > 0.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, GetPathCosts(path, start, end, fullNeighbors), 1e-6 * expected);
+  }
+
+  std::vector<IndexType> CreateTargets()
+  {
+    // near and far targets, the second one is closed by the search for the first one, the last one is the start
+    return {MakeIndex(50, 47), MakeIndex(49, 46), MakeIndex(90, 5), MakeIndex(3, 92), MakeIndex(70, 60),
+            MakeIndex(0, 0), MakeIndex(95, 95), MakeIndex(48, 48)};
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = CostImageType::New();
+    CostImageType::SizeType size;
+    size.Fill(ImageSize);
+    m_Image->SetRegions(size);
+    m_Image->Allocate();
+    this->FillRandomCosts(4711);
+
+    m_CostFunction = TestCostFunction::New();
+    m_CostFunction->SetImage(m_Image);
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+    m_CostFunction = nullptr;
+  }
+
+  void PathsMatchFullDijkstra()
+  {
+    const IndexType start = MakeIndex(10, 20);
+    const auto distances = this->ComputeDijkstraDistances(start);
+
+    for (const auto &end : this->CreateTargets())
+    {
+      auto filter = this->CreateFilter();
+      this->AssertShortestPath(this->ComputePath(filter, start, end), start, end, distances);
+    }
+  }
+
+  void FullNeighborPathsMatchFullDijkstra()
+  {
+    const IndexType start = MakeIndex(60, 30);
+    const auto distances = this->ComputeDijkstraDistances(start, true);
+
+    for (const auto &end : this->CreateTargets())
+    {
+      auto filter = this->CreateFilter(true);
+      this->AssertShortestPath(this->ComputePath(filter, start, end), start, end, distances, true);
+    }
+  }
+
+  void DistancesMatchFullDijkstra()
+  {
+    const IndexType start = MakeIndex(33, 77);
+    const auto distances = this->ComputeDijkstraDistances(start);
+
+    auto filter = this->CreateFilter();
+    filter->SetCalcAllDistances(true);
+    this->ComputePath(filter, start, MakeIndex(80, 10));
+
+    auto distanceImage = filter->GetDistanceImage();
+    for (itk::ImageRegionConstIterator<CostImageType> it(distanceImage, distanceImage->GetLargestPossibleRegion());
+         !it.IsAtEnd();
+         ++it)
+    {
+      const double expected = this->GetDistance(distances, it.GetIndex());
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, it.Get(), 1e-4 * std::max(1.0, expected));
+    }
+  }
+
+  void ReusedSearchTreeMatchesFreshSearch()
+  {
+    const IndexType start = MakeIndex(48, 48);
+    const auto distances = this->ComputeDijkstraDistances(start);
+
+    auto reusingFilter = this->CreateFilter();
+    auto nonReusingFilter = this->CreateFilter();
+    nonReusingFilter->SetReuseSearchTree(false);
+
+    for (const auto &end : this->CreateTargets())
+    {
+      if (end == start)
+        continue;
+
+      auto freshFilter = this->CreateFilter();
+      const PathType freshPath = this->ComputePath(freshFilter, start, end);
+      this->AssertShortestPath(freshPath, start, end, distances);
+
+      CPPUNIT_ASSERT(freshPath == this->ComputePath(reusingFilter, start, end));
+      CPPUNIT_ASSERT(freshPath == this->ComputePath(nonReusingFilter, start, end));
+    }
+
+    // a new start point discards the search tree
+    const IndexType newStart = MakeIndex(5, 90);
+    const IndexType end = MakeIndex(90, 5);
+    this->AssertShortestPath(
+      this->ComputePath(reusingFilter, newStart, end), newStart, end, this->ComputeDijkstraDistances(newStart));
+  }
+
+  void SearchTreeIsNotReusedForModifiedInput()
+  {
+    const IndexType start = MakeIndex(20, 70);
+    const IndexType end = MakeIndex(75, 15);
+
+    auto filter = this->CreateFilter();
+    this->AssertShortestPath(this->ComputePath(filter, start, end), start, end, this->ComputeDijkstraDistances(start));
+
+    this->FillRandomCosts(42);
+    m_Image->Modified();
+
+    this->AssertShortestPath(this->ComputePath(filter, start, end), start, end, this->ComputeDijkstraDistances(start));
+  }
+
+  void TargetOutsideOfSearchRegion()
+  {
+    const IndexType start = MakeIndex(40, 40);
+    const IndexType nearEnd = MakeIndex(45, 35);
+    const IndexType farEnd = MakeIndex(85, 90);
+
+    auto filter = this->CreateFilter();
+    auto region = this->MakeRegion(start, 16);
+    filter->SetSearchRegion(region);
+
+    // inside of the window the path is the shortest path that does not leave the window
+    this->AssertShortestPath(
+      this->ComputePath(filter, start, nearEnd), start, nearEnd, this->ComputeDijkstraDistances(start, false, region));
+
+    // the target outside of the window is not reached
+    CPPUNIT_ASSERT(this->ComputePath(filter, start, farEnd).empty());
+
+    // growing the window like the live wire does it finds the target
+    itk::IndexValueType radius = 32;
+    while (!region.IsInside(farEnd))
+    {
+      radius *= 2;
+      region = this->MakeRegion(start, radius);
+    }
+    filter->SetSearchRegion(region);
+    this->AssertShortestPath(
+      this->ComputePath(filter, start, farEnd), start, farEnd, this->ComputeDijkstraDistances(start, false, region));
+
+    // once the window covers the whole image, the paths of the reused tree are the ones of the full search
+    region = this->MakeRegion(start, ImageSize);
+    filter->SetSearchRegion(region);
+    const auto distances = this->ComputeDijkstraDistances(start);
+    for (const auto &end : this->CreateTargets())
+    {
+      if (end == start)
+        continue;
+
+      auto freshFilter = this->CreateFilter();
+      const PathType path = this->ComputePath(filter, start, end);
+      this->AssertShortestPath(path, start, end, distances);
+      CPPUNIT_ASSERT(this->ComputePath(freshFilter, start, end) == path);
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(itkShortestPathImageFilter)
@@ -4,6 +4,7 @@ set(MODULE_TESTS
   mitkPointSetDifferenceStatisticsCalculatorTest.cpp
   mitkImageStatisticsTextureAnalysisTest.cpp
   mitkImageStatisticsContainerManagerTest.cpp
+  mitkMultiLabelStatisticsAccumulatorTest.cpp
 )
 
 set(MODULE_CUSTOM_TESTS
@@ -0,0 +1,230 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkExtendedLabelStatisticsImageFilter.h>
+#include <mitkMinMaxLabelmageFilterWithIndex.h>
+#include <mitkMultiLabelStatisticsAccumulator.h>
+
+#include <itkImageRegionIterator.h>
+
+#include <chrono>
+#include <random>
+
+class mitkMultiLabelStatisticsAccumulatorTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkMultiLabelStatisticsAccumulatorTestSuite);
+  MITK_TEST(StatisticsMatchLabelStatisticsFilter);
+  MITK_TEST(ResultsDoNotDependOnNumberOfThreads);
+  MITK_TEST(OnlyRequestedLabelsAreComputed);
+  MITK_TEST(DifferentRegionSizesAreRejected);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<short, 3> ImageType;
+  typedef itk::Image<unsigned short, 3> LabelImageType;
+  typedef mitk::MultiLabelStatisticsAccumulator<short, 3> AccumulatorType;
+
+  static const unsigned int NumberOfBins = 100;
+
+  std::vector<ImageType::Pointer> m_Images;
+  LabelImageType::Pointer m_Labels;
+
+  template <typename TImage>
+  typename TImage::Pointer CreateImage(unsigned int size)
+  {
+    typename TImage::Pointer image = TImage::New();
+    typename TImage::SizeType imageSize;
+    imageSize.Fill(size);
+    image->SetRegions(imageSize);
+    image->Allocate();
+    return image;
+  }
+
+  AccumulatorType::LabelStatisticsMapType Compute(const ImageType* image, unsigned int numberOfThreads)
+  {
+    AccumulatorType accumulator;
+    accumulator.SetNumberOfThreads(numberOfThreads);
+    accumulator.SetBinCountFunction([](short, short) { return NumberOfBins; });
+    const auto timeStep = accumulator.AddTimeStep(image, m_Labels);
+    accumulator.Compute();
+    return accumulator.GetLabelStatistics(timeStep);
+  }
+
+public:
+  void setUp() override
+  {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<short> values(-1000, 3000);
+
+    // two "time steps" with different values, three labels plus background in slabs of varying thickness
+    m_Labels = this->CreateImage<LabelImageType>(64);
+    for (itk::ImageRegionIterator<LabelImageType> it(m_Labels, m_Labels->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+    {
+      const auto& index = it.GetIndex();
+      it.Set(static_cast<unsigned short>((index[2] * index[2] + index[1]) % 4));
+    }
+
+    for (unsigned int t = 0; t < 2; ++t)
+    {
+      ImageType::Pointer image = this->CreateImage<ImageType>(64);
+      for (itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+      {
+        it.Set(values(generator));
+      }
+      m_Images.push_back(image);
+    }
+  }
+
+  void tearDown() override
+  {
+    m_Images.clear();
+    m_Labels = nullptr;
+  }
+
+  void StatisticsMatchLabelStatisticsFilter()
+  {
+    typedef itk::MinMaxLabelImageFilterWithIndex<ImageType, LabelImageType> MinMaxFilterType;
+    typedef itk::ExtendedLabelStatisticsImageFilter<ImageType, LabelImageType> StatisticsFilterType;
+
+    AccumulatorType accumulator;
+    accumulator.SetBinCountFunction([](short, short) { return NumberOfBins; });
+    for (const auto& image : m_Images)
+    {
+      accumulator.AddTimeStep(image, m_Labels);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    accumulator.Compute();
+    const std::chrono::duration<double> accumulatorDuration = std::chrono::steady_clock::now() - start;
+
+    std::chrono::duration<double> filterDuration(0);
+    for (std::size_t t = 0; t < m_Images.size(); ++t)
+    {
+      const auto filterStart = std::chrono::steady_clock::now();
+      MinMaxFilterType::Pointer minMaxFilter = MinMaxFilterType::New();
+      minMaxFilter->SetInput(m_Images[t]);
+      minMaxFilter->SetLabelInput(m_Labels);
+      minMaxFilter->UpdateLargestPossibleRegion();
+
+      std::map<unsigned short, unsigned int> nBins;
+      std::map<unsigned short, short> minVals;
+      std::map<unsigned short, short> maxVals;
+      for (const auto label : minMaxFilter->GetRelevantLabels())
+      {
+        nBins[label] = NumberOfBins;
+        minVals[label] = minMaxFilter->GetMin(label);
+        maxVals[label] = minMaxFilter->GetMax(label);
+      }
+
+      StatisticsFilterType::Pointer statisticsFilter = StatisticsFilterType::New();
+      statisticsFilter->SetInput(m_Images[t]);
+      statisticsFilter->SetLabelInput(m_Labels);
+      statisticsFilter->SetHistogramParametersForLabels(nBins, minVals, maxVals);
+      statisticsFilter->Update();
+      filterDuration += std::chrono::steady_clock::now() - filterStart;
+
+      const auto& statistics = accumulator.GetLabelStatistics(t);
+      // like the filters, the background label 0 is computed as well
+      CPPUNIT_ASSERT_EQUAL(std::size_t(4), statistics.size());
+      CPPUNIT_ASSERT(statistics.find(0) != statistics.end());
+
+      for (const auto& iter : statistics)
+      {
+        const unsigned short label = iter.first;
+        const AccumulatorType::LabelStatistics& labelStatistics = iter.second;
+
+        CPPUNIT_ASSERT_EQUAL(static_cast<unsigned long>(statisticsFilter->GetCount(label)), labelStatistics.Count);
+        CPPUNIT_ASSERT_EQUAL(minMaxFilter->GetMin(label), labelStatistics.Minimum);
+        CPPUNIT_ASSERT_EQUAL(minMaxFilter->GetMax(label), labelStatistics.Maximum);
+        CPPUNIT_ASSERT_EQUAL(minMaxFilter->GetMinIndex(label), labelStatistics.MinimumIndex);
+        CPPUNIT_ASSERT_EQUAL(minMaxFilter->GetMaxIndex(label), labelStatistics.MaximumIndex);
+
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(statisticsFilter->GetMean(label), labelStatistics.Mean, mitk::eps);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(statisticsFilter->GetSigma(label), labelStatistics.Sigma, mitk::eps);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(statisticsFilter->GetSkewness(label), labelStatistics.Skewness, mitk::eps);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(statisticsFilter->GetKurtosis(label), labelStatistics.Kurtosis, mitk::eps);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(statisticsFilter->GetMPP(label), labelStatistics.MPP, mitk::eps);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(statisticsFilter->GetMedian(label), labelStatistics.Median, mitk::eps);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(statisticsFilter->GetEntropy(label), labelStatistics.Entropy, mitk::eps);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(statisticsFilter->GetUniformity(label), labelStatistics.Uniformity, mitk::eps);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(statisticsFilter->GetUPP(label), labelStatistics.UPP, mitk::eps);
+      }
+    }
+
+    MITK_INFO << "Statistics of " << m_Images.size() << " time steps: " << accumulatorDuration.count()
+              << " s (accumulator), " << filterDuration.count() << " s (label statistics filters)";
+  }
+
+  void ResultsDoNotDependOnNumberOfThreads()
+  {
+    const auto reference = this->Compute(m_Images.front(), 1);
+    for (unsigned int numberOfThreads : { 2u, 3u, 8u })
+    {
+      const auto statistics = this->Compute(m_Images.front(), numberOfThreads);
+      CPPUNIT_ASSERT_EQUAL(reference.size(), statistics.size());
+
+      for (const auto& iter : reference)
+      {
+        const auto& labelStatistics = statistics.at(iter.first);
+        CPPUNIT_ASSERT_EQUAL(iter.second.Count, labelStatistics.Count);
+        CPPUNIT_ASSERT_EQUAL(iter.second.MinimumIndex, labelStatistics.MinimumIndex);
+        CPPUNIT_ASSERT_EQUAL(iter.second.MaximumIndex, labelStatistics.MaximumIndex);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(iter.second.Mean, labelStatistics.Mean, mitk::eps);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(iter.second.Kurtosis, labelStatistics.Kurtosis, mitk::eps);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(iter.second.Median, labelStatistics.Median, mitk::eps);
+      }
+    }
+  }
+
+  void OnlyRequestedLabelsAreComputed()
+  {
+    const auto reference = this->Compute(m_Images.front(), 4);
+
+    AccumulatorType accumulator;
+    accumulator.SetNumberOfThreads(4);
+    accumulator.SetBinCountFunction([](short, short) { return NumberOfBins; });
+    accumulator.SetLabels({ 1, 2 });
+    const auto timeStep = accumulator.AddTimeStep(m_Images.front(), m_Labels);
+    accumulator.Compute();
+    const auto& statistics = accumulator.GetLabelStatistics(timeStep);
+
+    // the background and label 3 are not requested
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), statistics.size());
+    CPPUNIT_ASSERT(statistics.find(0) == statistics.end());
+    CPPUNIT_ASSERT(statistics.find(3) == statistics.end());
+
+    const auto& labelStatistics = statistics.at(2);
+    const auto& referenceStatistics = reference.at(2);
+    CPPUNIT_ASSERT_EQUAL(referenceStatistics.Count, labelStatistics.Count);
+    CPPUNIT_ASSERT_EQUAL(referenceStatistics.MinimumIndex, labelStatistics.MinimumIndex);
+    CPPUNIT_ASSERT_EQUAL(referenceStatistics.MaximumIndex, labelStatistics.MaximumIndex);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(referenceStatistics.Mean, labelStatistics.Mean, mitk::eps);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(referenceStatistics.Median, labelStatistics.Median, mitk::eps);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(referenceStatistics.Entropy, labelStatistics.Entropy, mitk::eps);
+  }
+
+  void DifferentRegionSizesAreRejected()
+  {
+    AccumulatorType accumulator;
+    LabelImageType::Pointer smallLabels = this->CreateImage<LabelImageType>(32);
+    CPPUNIT_ASSERT_THROW(accumulator.AddTimeStep(m_Images.front(), smallLabels), mitk::Exception);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkMultiLabelStatisticsAccumulator)
@@ -38,6 +38,7 @@ set(H_FILES
   mitkIgnorePixelMaskGenerator.h
   mitkMinMaxImageFilterWithIndex.h
   mitkMinMaxLabelmageFilterWithIndex.h
+  mitkMultiLabelStatisticsAccumulator.h
   mitkImageStatisticsPredicateHelper.h
   mitkImageStatisticsContainerNodeHelper.h
   mitkImageStatisticsContainerManager.h
@@ -15,7 +15,6 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include "mitkImageStatisticsCalculator.h"
-#include <mitkExtendedLabelStatisticsImageFilter.h>
 #include <mitkExtendedStatisticsImageFilter.h>
 #include <mitkImage.h>
 #include <mitkImageAccessByItk.h>
@@ -25,7 +24,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkImageToItk.h>
 #include <mitkMaskUtilities.h>
 #include <mitkMinMaxImageFilterWithIndex.h>
-#include <mitkMinMaxLabelmageFilterWithIndex.h>
+#include <mitkMultiLabelStatisticsAccumulator.h>
 #include <mitkitkMaskImageFilter.h>
 
 namespace mitk
@@ -109,6 +108,7 @@ namespace mitk
     if (IsUpdateRequired(label))
     {
       auto timeGeometry = m_Image->GetTimeGeometry();
+      std::vector<MaskedTimeStep> maskedTimeSteps;
       // always compute statistics on all timesteps
       for (unsigned int timeStep = 0; timeStep < m_Image->GetTimeSteps(); timeStep++)
       {
@@ -153,10 +153,40 @@ namespace mitk
         }
         else
         {
-          // 2) calculate statistics masked
-          AccessByItk_2(m_ImageTimeSlice, InternalCalculateStatisticsMasked, timeGeometry, timeStep)
+          // 2) collect the masked timestep, statistics of all masked timesteps are calculated at once below
+          MaskedTimeStep maskedTimeStep;
+          maskedTimeStep.TimeStep = timeStep;
+          maskedTimeStep.ImageTimeSlice = m_ImageTimeSlice;
+          maskedTimeStep.ImageForStatistics = m_InternalImageForStatistics;
+          maskedTimeStep.Mask = m_InternalMask;
+          maskedTimeStep.SecondaryMask = m_SecondaryMask;
+
+          // workaround: if m_SecondaryMaskGenerator ist not null but m_MaskGenerator is! (this is the case if we request a
+          // 'ignore zuero valued pixels' mask in the gui but do not define a primary mask)
+          if (maskedTimeStep.Mask.IsNull())
+          {
+            maskedTimeStep.Mask = maskedTimeStep.SecondaryMask;
+            maskedTimeStep.SecondaryMask = nullptr;
+          }
+          // dirty workaround for a bug when pf mask + any other mask is used in conjunction. We need a proper fix for
+          // this (Fabian Isensee is responsible and probably working on it!)
+          else if (maskedTimeStep.SecondaryMask.IsNotNull() && maskedTimeStep.Mask->GetDimension() == 2 &&
+                   (maskedTimeStep.SecondaryMask->GetDimension() == 3 || maskedTimeStep.SecondaryMask->GetDimension() == 4))
+          {
+            mitk::Image::ConstPointer old_img = m_SecondaryMaskGenerator->GetReferenceImage();
+            m_SecondaryMaskGenerator->SetInputImage(m_MaskGenerator->GetReferenceImage());
+            maskedTimeStep.SecondaryMask = m_SecondaryMaskGenerator->GetMask();
+            m_SecondaryMaskGenerator->SetInputImage(old_img);
+          }
+
+          maskedTimeSteps.push_back(maskedTimeStep);
         }
       }
+
+      if (!maskedTimeSteps.empty())
+      {
+        AccessByItk_2(maskedTimeSteps.front().ImageTimeSlice, InternalCalculateStatisticsMasked, timeGeometry, maskedTimeSteps)
+      }
     }
 
     auto it = m_StatisticContainers.find(label);
@@ -299,214 +329,169 @@ namespace mitk
   template <typename TPixel, unsigned int VImageDimension>
   void ImageStatisticsCalculator::InternalCalculateStatisticsMasked(typename itk::Image<TPixel, VImageDimension> *image,
                                                                     const TimeGeometry *timeGeometry,
-                                                                    unsigned int timeStep)
+                                                                    const std::vector<MaskedTimeStep> &maskedTimeSteps)
   {
     typedef itk::Image<TPixel, VImageDimension> ImageType;
     typedef itk::Image<MaskPixelType, VImageDimension> MaskType;
-    typedef typename MaskType::PixelType LabelPixelType;
-    typedef itk::ExtendedLabelStatisticsImageFilter<ImageType, MaskType> ImageStatisticsFilterType;
     typedef MaskUtilities<TPixel, VImageDimension> MaskUtilType;
-    typedef typename itk::MinMaxLabelImageFilterWithIndex<ImageType, MaskType> MinMaxLabelFilterType;
-    typedef typename ImageType::PixelType InputImgPixelType;
+    typedef MultiLabelStatisticsAccumulator<TPixel, VImageDimension, MaskPixelType> AccumulatorType;
 
-    // workaround: if m_SecondaryMaskGenerator ist not null but m_MaskGenerator is! (this is the case if we request a
-    // 'ignore zuero valued pixels' mask in the gui but do not define a primary mask)
-    bool swapMasks = false;
-    if (m_SecondaryMask.IsNotNull() && m_InternalMask.IsNull())
-    {
-      m_InternalMask = m_SecondaryMask;
-      m_SecondaryMask = nullptr;
-      swapMasks = true;
-    }
+    AccumulatorType accumulator;
+    // histogram parameters are determined for each label individually (min/max may be different for each label)
+    accumulator.SetBinCountFunction([this](TPixel minimum, TPixel maximum) -> unsigned int {
+      if (m_UseBinSizeOverNBins)
+      {
+        return std::max(static_cast<double>(std::ceil(maximum - minimum)) / m_binSizeForHistogramStatistics,
+                        10.); // do not allow less than 10 bins
+      }
+      return m_nBinsForHistogramStatistics;
+    });
 
-    // maskImage has to have the same dimension as image
-    typename MaskType::Pointer maskImage = MaskType::New();
-    try
-    {
-      // try to access the pixel values directly (no copying or casting). Only works if mask pixels are of pixelType
-      // unsigned short
-      maskImage = ImageToItkImage<MaskPixelType, VImageDimension>(m_InternalMask);
-    }
-    catch (const itk::ExceptionObject &)
+    std::vector<double> voxelVolumes;
 
+    for (std::size_t i = 0; i < maskedTimeSteps.size(); ++i)
     {
-      // if the pixel type of the mask is not short, then we have to make a copy of m_InternalMask (and cast the values)
-      CastToItkImage(m_InternalMask, maskImage);
-    }
+      const MaskedTimeStep &maskedTimeStep = maskedTimeSteps[i];
 
-    // if we have a secondary mask (say a ignoreZeroPixelMask) we need to combine the masks (corresponds to AND)
-    if (m_SecondaryMask.IsNotNull())
-    {
-      // dirty workaround for a bug when pf mask + any other mask is used in conjunction. We need a proper fix for this
-      // (Fabian Isensee is responsible and probably working on it!)
-      if (m_InternalMask->GetDimension() == 2 &&
-          (m_SecondaryMask->GetDimension() == 3 || m_SecondaryMask->GetDimension() == 4))
+      // the slice of the first timestep is already accessed by the caller
+      typename ImageType::ConstPointer timeStepImage = image;
+      if (i > 0)
       {
-        mitk::Image::ConstPointer old_img = m_SecondaryMaskGenerator->GetReferenceImage();
-        m_SecondaryMaskGenerator->SetInputImage(m_MaskGenerator->GetReferenceImage());
-        m_SecondaryMask = m_SecondaryMaskGenerator->GetMask();
-        m_SecondaryMaskGenerator->SetInputImage(old_img);
+        timeStepImage = ImageToItkImage<TPixel, VImageDimension>(
+          static_cast<const mitk::Image *>(maskedTimeStep.ImageTimeSlice.GetPointer()));
       }
-      typename MaskType::Pointer secondaryMaskImage = MaskType::New();
-      secondaryMaskImage = ImageToItkImage<MaskPixelType, VImageDimension>(m_SecondaryMask);
-
-      // secondary mask should be a ignore zero value pixel mask derived from image. it has to be cropped to the mask
-      // region (which may be planar or simply smaller)
-      typename MaskUtilities<MaskPixelType, VImageDimension>::Pointer secondaryMaskMaskUtil =
-        MaskUtilities<MaskPixelType, VImageDimension>::New();
-      secondaryMaskMaskUtil->SetImage(secondaryMaskImage.GetPointer());
-      secondaryMaskMaskUtil->SetMask(maskImage.GetPointer());
-      typename MaskType::Pointer adaptedSecondaryMaskImage = secondaryMaskMaskUtil->ExtractMaskImageRegion();
-
-      typename itk::MaskImageFilter2<MaskType, MaskType, MaskType>::Pointer maskFilter =
-        itk::MaskImageFilter2<MaskType, MaskType, MaskType>::New();
-      maskFilter->SetInput1(maskImage);
-      maskFilter->SetInput2(adaptedSecondaryMaskImage);
-      maskFilter->SetMaskingValue(
-        1); // all pixels of maskImage where secondaryMaskImage==1 will be kept, all the others are set to 0
-      maskFilter->UpdateLargestPossibleRegion();
-      maskImage = maskFilter->GetOutput();
-    }
-
-    typename MaskUtilType::Pointer maskUtil = MaskUtilType::New();
-    maskUtil->SetImage(image);
-    maskUtil->SetMask(maskImage.GetPointer());
-
-    // if mask is smaller than image, extract the image region where the mask is
-    typename ImageType::Pointer adaptedImage = ImageType::New();
-
-    adaptedImage = maskUtil->ExtractMaskImageRegion(); // this also checks mask sanity
-
-    // find min, max, minindex and maxindex
-    typename MinMaxLabelFilterType::Pointer minMaxFilter = MinMaxLabelFilterType::New();
-    minMaxFilter->SetInput(adaptedImage);
-    minMaxFilter->SetLabelInput(maskImage);
-    minMaxFilter->UpdateLargestPossibleRegion();
-
-    // set histogram parameters for each label individually (min/max may be different for each label)
-    typedef typename std::map<LabelPixelType, InputImgPixelType> MapType;
-    typedef typename std::pair<LabelPixelType, InputImgPixelType> PairType;
-
-    std::vector<LabelPixelType> relevantLabels = minMaxFilter->GetRelevantLabels();
-    MapType minVals;
-    MapType maxVals;
-    std::map<LabelPixelType, unsigned int> nBins;
 
-    for (LabelPixelType label : relevantLabels)
-    {
-      minVals.insert(PairType(label, minMaxFilter->GetMin(label)));
-      maxVals.insert(PairType(label, minMaxFilter->GetMax(label)));
-
-      unsigned int nBinsForHistogram;
-      if (m_UseBinSizeOverNBins)
+      // maskImage has to have the same dimension as image
+      typename MaskType::Pointer maskImage = MaskType::New();
+      try
       {
-        nBinsForHistogram =
-          std::max(static_cast<double>(std::ceil(minMaxFilter->GetMax(label) - minMaxFilter->GetMin(label))) /
-                     m_binSizeForHistogramStatistics,
-                   10.); // do not allow less than 10 bins
+        // try to access the pixel values directly (no copying or casting). Only works if mask pixels are of pixelType
+        // unsigned short. Read access only, the same mask may be used by several timesteps.
+        maskImage = const_cast<MaskType *>(
+          ImageToItkImage<MaskPixelType, VImageDimension>(
+            static_cast<const mitk::Image *>(maskedTimeStep.Mask.GetPointer())).GetPointer());
       }
-      else
+      catch (const itk::ExceptionObject &)
       {
-        nBinsForHistogram = m_nBinsForHistogramStatistics;
+        // if the pixel type of the mask is not short, then we have to make a copy of the mask (and cast the values)
+        CastToItkImage(maskedTimeStep.Mask, maskImage);
       }
 
-      nBins.insert(typename std::pair<LabelPixelType, unsigned int>(label, nBinsForHistogram));
-    }
+      // if we have a secondary mask (say a ignoreZeroPixelMask) we need to combine the masks (corresponds to AND)
+      if (maskedTimeStep.SecondaryMask.IsNotNull())
+      {
+        typename MaskType::Pointer secondaryMaskImage = const_cast<MaskType *>(
+          ImageToItkImage<MaskPixelType, VImageDimension>(
+            static_cast<const mitk::Image *>(maskedTimeStep.SecondaryMask.GetPointer())).GetPointer());
+
+        // secondary mask should be a ignore zero value pixel mask derived from image. it has to be cropped to the mask
+        // region (which may be planar or simply smaller)
+        typename MaskUtilities<MaskPixelType, VImageDimension>::Pointer secondaryMaskMaskUtil =
+          MaskUtilities<MaskPixelType, VImageDimension>::New();
+        secondaryMaskMaskUtil->SetImage(secondaryMaskImage.GetPointer());
+        secondaryMaskMaskUtil->SetMask(maskImage.GetPointer());
+        typename MaskType::Pointer adaptedSecondaryMaskImage = secondaryMaskMaskUtil->ExtractMaskImageRegion();
+
+        typename itk::MaskImageFilter2<MaskType, MaskType, MaskType>::Pointer maskFilter =
+          itk::MaskImageFilter2<MaskType, MaskType, MaskType>::New();
+        maskFilter->SetInput1(maskImage);
+        maskFilter->SetInput2(adaptedSecondaryMaskImage);
+        maskFilter->SetMaskingValue(
+          1); // all pixels of maskImage where secondaryMaskImage==1 will be kept, all the others are set to 0
+        maskFilter->UpdateLargestPossibleRegion();
+        maskImage = maskFilter->GetOutput();
+      }
 
-    typename ImageStatisticsFilterType::Pointer imageStatisticsFilter = ImageStatisticsFilterType::New();
-    imageStatisticsFilter->SetDirectionTolerance(0.001);
-    imageStatisticsFilter->SetCoordinateTolerance(0.001);
-    imageStatisticsFilter->SetInput(adaptedImage);
-    imageStatisticsFilter->SetLabelInput(maskImage);
-    imageStatisticsFilter->SetHistogramParametersForLabels(nBins, minVals, maxVals);
-    imageStatisticsFilter->Update();
+      typename MaskUtilType::Pointer maskUtil = MaskUtilType::New();
+      maskUtil->SetImage(const_cast<ImageType *>(timeStepImage.GetPointer()));
+      maskUtil->SetMask(maskImage.GetPointer());
 
-    std::list<int> labels = imageStatisticsFilter->GetRelevantLabels();
-    auto it = labels.begin();
+      // if mask is smaller than image, extract the image region where the mask is
+      typename ImageType::Pointer adaptedImage = maskUtil->ExtractMaskImageRegion(); // this also checks mask sanity
 
-    while (it != labels.end())
+      // the accumulator keeps adaptedImage and maskImage alive until all timesteps are computed
+      accumulator.AddTimeStep(adaptedImage, maskImage);
+      voxelVolumes.push_back(GetVoxelVolume<TPixel, VImageDimension>(const_cast<ImageType *>(timeStepImage.GetPointer())));
+    }
+
+    // moments, extrema and histograms of all labels (including the background) and all timesteps
+    accumulator.Compute();
+
+    for (std::size_t i = 0; i < maskedTimeSteps.size(); ++i)
     {
-      ImageStatisticsContainer::Pointer statisticContainerForLabelImage;
-      auto labelIt = m_StatisticContainers.find(*it);
-      // reset if statisticContainer already exist
-      if (labelIt != m_StatisticContainers.end())
-      {
-        statisticContainerForLabelImage = labelIt->second;
-      }
-      // create new statisticContainer
-      else
-      {
-        statisticContainerForLabelImage = ImageStatisticsContainer::New();
-        statisticContainerForLabelImage->SetTimeGeometry(const_cast<mitk::TimeGeometry*>(timeGeometry));
-        // link label (*it) to statisticContainer
-        m_StatisticContainers.emplace(*it, statisticContainerForLabelImage);
-      }
+      const MaskedTimeStep &maskedTimeStep = maskedTimeSteps[i];
 
-      ImageStatisticsContainer::ImageStatisticsObject statObj;
+      for (const auto &labelStatisticsPair : accumulator.GetLabelStatistics(i))
+      {
+        const LabelIndex label = labelStatisticsPair.first;
+        const typename AccumulatorType::LabelStatistics &labelStatistics = labelStatisticsPair.second;
 
-      // find min, max, minindex and maxindex
-      // make sure to only look in the masked region, use a masker for this
+        ImageStatisticsContainer::Pointer statisticContainerForLabelImage;
+        auto labelIt = m_StatisticContainers.find(label);
+        // reset if statisticContainer already exist
+        if (labelIt != m_StatisticContainers.end())
+        {
+          statisticContainerForLabelImage = labelIt->second;
+        }
+        // create new statisticContainer
+        else
+        {
+          statisticContainerForLabelImage = ImageStatisticsContainer::New();
+          statisticContainerForLabelImage->SetTimeGeometry(const_cast<mitk::TimeGeometry*>(timeGeometry));
+          // link label to statisticContainer
+          m_StatisticContainers.emplace(label, statisticContainerForLabelImage);
+        }
 
-      vnl_vector<int> minIndex, maxIndex;
-      mitk::Point3D worldCoordinateMin;
-      mitk::Point3D worldCoordinateMax;
-      mitk::Point3D indexCoordinateMin;
-      mitk::Point3D indexCoordinateMax;
-      m_InternalImageForStatistics->GetGeometry()->IndexToWorld(minMaxFilter->GetMinIndex(*it), worldCoordinateMin);
-      m_InternalImageForStatistics->GetGeometry()->IndexToWorld(minMaxFilter->GetMaxIndex(*it), worldCoordinateMax);
-      m_Image->GetGeometry()->WorldToIndex(worldCoordinateMin, indexCoordinateMin);
-      m_Image->GetGeometry()->WorldToIndex(worldCoordinateMax, indexCoordinateMax);
+        ImageStatisticsContainer::ImageStatisticsObject statObj;
 
-      minIndex.set_size(3);
-      maxIndex.set_size(3);
+        vnl_vector<int> minIndex, maxIndex;
+        mitk::Point3D worldCoordinateMin;
+        mitk::Point3D worldCoordinateMax;
+        mitk::Point3D indexCoordinateMin;
+        mitk::Point3D indexCoordinateMax;
+        maskedTimeStep.ImageForStatistics->GetGeometry()->IndexToWorld(labelStatistics.MinimumIndex, worldCoordinateMin);
+        maskedTimeStep.ImageForStatistics->GetGeometry()->IndexToWorld(labelStatistics.MaximumIndex, worldCoordinateMax);
+        m_Image->GetGeometry()->WorldToIndex(worldCoordinateMin, indexCoordinateMin);
+        m_Image->GetGeometry()->WorldToIndex(worldCoordinateMax, indexCoordinateMax);
 
-      // for (unsigned int i=0; i < tmpMaxIndex.GetIndexDimension(); i++)
-      for (unsigned int i = 0; i < 3; i++)
-      {
-        minIndex[i] = indexCoordinateMin[i];
-        maxIndex[i] = indexCoordinateMax[i];
-      }
+        minIndex.set_size(3);
+        maxIndex.set_size(3);
 
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MINIMUMPOSITION(), minIndex);
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MAXIMUMPOSITION(), maxIndex);
-
-      assert(std::abs(minMaxFilter->GetMax(*it) - imageStatisticsFilter->GetMaximum(*it)) < mitk::eps);
-      assert(std::abs(minMaxFilter->GetMin(*it) - imageStatisticsFilter->GetMinimum(*it)) < mitk::eps);
-
-      auto voxelVolume = GetVoxelVolume<TPixel, VImageDimension>(image);
-      auto numberOfVoxels =
-        static_cast<unsigned long>(imageStatisticsFilter->GetSum(*it) / (double)imageStatisticsFilter->GetMean(*it));
-      auto volume = static_cast<double>(numberOfVoxels) * voxelVolume;
-      auto rms = std::sqrt(std::pow(imageStatisticsFilter->GetMean(*it), 2.) +
-                           imageStatisticsFilter->GetVariance(*it)); // variance = sigma^2
-      auto variance = imageStatisticsFilter->GetSigma(*it) * imageStatisticsFilter->GetSigma(*it);
-
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::NUMBEROFVOXELS(), numberOfVoxels);
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::VOLUME(), volume);
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MEAN(), imageStatisticsFilter->GetMean(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MINIMUM(), imageStatisticsFilter->GetMinimum(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MAXIMUM(), imageStatisticsFilter->GetMaximum(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::STANDARDDEVIATION(), imageStatisticsFilter->GetSigma(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::VARIANCE(), variance);
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::SKEWNESS(), imageStatisticsFilter->GetSkewness(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::KURTOSIS(), imageStatisticsFilter->GetKurtosis(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::RMS(), rms);
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MPP(), imageStatisticsFilter->GetMPP(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::ENTROPY(), imageStatisticsFilter->GetEntropy(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MEDIAN(), imageStatisticsFilter->GetMedian(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::UNIFORMITY(), imageStatisticsFilter->GetUniformity(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::UPP(), imageStatisticsFilter->GetUPP(*it));
-      statObj.m_Histogram = imageStatisticsFilter->GetHistogram(*it).GetPointer();
-
-      statisticContainerForLabelImage->SetStatisticsForTimeStep(timeStep, statObj);
-      ++it;
-    }
+        for (unsigned int j = 0; j < 3; j++)
+        {
+          minIndex[j] = indexCoordinateMin[j];
+          maxIndex[j] = indexCoordinateMax[j];
+        }
 
-    // swap maskGenerators back
-    if (swapMasks)
-    {
-      m_SecondaryMask = m_InternalMask;
-      m_InternalMask = nullptr;
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::MINIMUMPOSITION(), minIndex);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::MAXIMUMPOSITION(), maxIndex);
+
+        // the voxels are counted, formerly the count was derived as sum / mean, which failed for labels with mean 0
+        auto numberOfVoxels = static_cast<ImageStatisticsContainer::VoxelCountType>(labelStatistics.Count);
+        auto volume = static_cast<double>(numberOfVoxels) * voxelVolumes[i];
+        auto rms = std::sqrt(std::pow(labelStatistics.Mean, 2.) + labelStatistics.Variance); // variance = sigma^2
+        auto variance = labelStatistics.Sigma * labelStatistics.Sigma;
+
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::NUMBEROFVOXELS(), numberOfVoxels);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::VOLUME(), volume);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::MEAN(), labelStatistics.Mean);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::MINIMUM(),
+                             static_cast<ImageStatisticsContainer::RealType>(labelStatistics.Minimum));
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::MAXIMUM(),
+                             static_cast<ImageStatisticsContainer::RealType>(labelStatistics.Maximum));
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::STANDARDDEVIATION(), labelStatistics.Sigma);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::VARIANCE(), variance);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::SKEWNESS(), labelStatistics.Skewness);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::KURTOSIS(), labelStatistics.Kurtosis);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::RMS(), rms);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::MPP(), labelStatistics.MPP);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::ENTROPY(), labelStatistics.Entropy);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::MEDIAN(), labelStatistics.Median);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::UNIFORMITY(), labelStatistics.Uniformity);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::UPP(), labelStatistics.UPP);
+        statObj.m_Histogram = labelStatistics.Histogram.GetPointer();
+        statisticContainerForLabelImage->SetStatisticsForTimeStep(maskedTimeStep.TimeStep, statObj);
+      }
     }
   }
 
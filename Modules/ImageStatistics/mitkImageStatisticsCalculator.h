@@ -22,6 +22,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkMaskGenerator.h>
 #include <mitkImageStatisticsContainer.h>
 
+#include <vector>
+
 namespace mitk
 {
     class MITKIMAGESTATISTICS_EXPORT ImageStatisticsCalculator: public itk::Object
@@ -95,9 +97,20 @@ namespace mitk
         template < typename TPixel, unsigned int VImageDimension > void InternalCalculateStatisticsUnmasked(
                 typename itk::Image< TPixel, VImageDimension >* image, const TimeGeometry* timeGeometry, TimeStepType timeStep);
 
+        /** Inputs of one time step whose statistics are computed with a mask. */
+        struct MaskedTimeStep
+        {
+            TimeStepType TimeStep;
+            mitk::Image::Pointer ImageTimeSlice;
+            mitk::Image::ConstPointer ImageForStatistics;
+            mitk::Image::Pointer Mask;
+            mitk::Image::Pointer SecondaryMask;
+        };
+
+        //Calculates statistics for all labels and all masked timesteps in one pass, image is the slice of the first timestep
         template < typename TPixel, unsigned int VImageDimension > void InternalCalculateStatisticsMasked(
                 typename itk::Image< TPixel, VImageDimension >* image, const TimeGeometry* timeGeometry,
-                unsigned int timeStep);
+                const std::vector<MaskedTimeStep>& maskedTimeSteps);
 
         template < typename TPixel, unsigned int VImageDimension >
         double GetVoxelVolume(typename itk::Image<TPixel, VImageDimension>* image) const;
@@ -0,0 +1,155 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKMULTILABELSTATISTICSACCUMULATOR
+#define MITKMULTILABELSTATISTICSACCUMULATOR
+
+#include <itkImage.h>
+#include <itkHistogram.h>
+
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace mitk
+{
+  /**
+  * @brief Computes the statistics of an image for the labels of a label image and for any
+  * number of time steps in one pass over the pixel data, plus a second one for histograms.
+  *
+  * The pixels of all added time steps are split into chunks that are processed by a pool of
+  * threads. Each thread accumulates count, moments and extrema with their index per (time step,
+  * label); the per-thread results are reduced at the end. Histograms depend on the final extrema of
+  * a label, so they are filled by a second pass over the chunks, in which each thread bins into
+  * histograms of its own that are summed up afterwards.
+  *
+  * Like the filters, all labels including the background 0 are computed, unless the labels are
+  * restricted via SetLabels().
+  *
+  * The results are identical to ExtendedLabelStatisticsImageFilter combined with
+  * MinMaxLabelImageFilterWithIndex: the same moment formulas are used, histograms are binned by
+  * itk::Statistics::Histogram and the extrema indices refer to the first occurrence in buffer order.
+  */
+  template <typename TPixel, unsigned int VImageDimension, typename TLabelPixel = unsigned short>
+  class MultiLabelStatisticsAccumulator
+  {
+  public:
+    typedef itk::Image<TPixel, VImageDimension> ImageType;
+    typedef itk::Image<TLabelPixel, VImageDimension> LabelImageType;
+    typedef typename ImageType::IndexType IndexType;
+    typedef itk::Statistics::Histogram<double> HistogramType;
+
+    /** Returns the number of histogram bins for a label with the given extrema. */
+    typedef std::function<unsigned int(TPixel minimum, TPixel maximum)> BinCountFunctionType;
+
+    struct LabelStatistics
+    {
+      unsigned long Count = 0;
+      unsigned long PositivePixelCount = 0;
+      double Sum = 0;
+      double SumOfSquares = 0;
+      double SumOfCubes = 0;
+      double SumOfQuadruples = 0;
+      double SumOfPositivePixels = 0;
+
+      TPixel Minimum = TPixel();
+      TPixel Maximum = TPixel();
+      IndexType MinimumIndex;
+      IndexType MaximumIndex;
+
+      double Mean = 0;
+      double Variance = 0;
+      double Sigma = 0;
+      double Skewness = 0;
+      double Kurtosis = 0;
+      double MPP = 0;
+      double Median = 0;
+      double Entropy = 0;
+      double Uniformity = 0;
+      double UPP = 0;
+
+      HistogramType::Pointer Histogram;
+    };
+
+    typedef std::map<TLabelPixel, LabelStatistics> LabelStatisticsMapType;
+
+    MultiLabelStatisticsAccumulator();
+
+    /** Number of threads used by Compute(). Defaults to mitk::GetDefaultNumberOfThreads(). */
+    void SetNumberOfThreads(unsigned int numberOfThreads);
+
+    /** Function that determines the histogram bin count per label. Without it, no histograms are computed. */
+    void SetBinCountFunction(const BinCountFunctionType& binCount);
+
+    /** Restricts the statistics to the given labels. Empty (default) means all labels, including the background 0. */
+    void SetLabels(const std::vector<TLabelPixel>& labels);
+
+    /**
+    * @brief Add a time step to be processed by the next Compute().
+    * @pre image and labels must have buffered regions of the same size.
+    * @return The index of the time step, used to retrieve its results.
+    */
+    std::size_t AddTimeStep(const ImageType* image, const LabelImageType* labels);
+
+    /** Process all added time steps in one pass. Throws mitk::Exception on invalid input. */
+    void Compute();
+
+    /** Statistics of all labels that occur in the time step with the given index. */
+    const LabelStatisticsMapType& GetLabelStatistics(std::size_t timeStepIndex) const;
+
+  private:
+    /** Accumulated values of one label, in one time step, processed by one thread. */
+    struct Partial
+    {
+      unsigned long Count = 0;
+      unsigned long PositivePixelCount = 0;
+      double Sum = 0;
+      double SumOfSquares = 0;
+      double SumOfCubes = 0;
+      double SumOfQuadruples = 0;
+      double SumOfPositivePixels = 0;
+      TPixel Minimum = TPixel();
+      TPixel Maximum = TPixel();
+      std::size_t MinimumOffset = 0;
+      std::size_t MaximumOffset = 0;
+    };
+
+    typedef std::vector<std::map<TLabelPixel, Partial>> ThreadResultType;
+    /** Histograms of one thread per (time step, label), with the bounds of the final histograms */
+    typedef std::vector<std::map<TLabelPixel, HistogramType::Pointer>> ThreadHistogramType;
+
+    bool IsLabelRequested(TLabelPixel label) const;
+    void AccumulateChunk(std::size_t timeStepIndex, std::size_t begin, std::size_t end, ThreadResultType& result) const;
+    void BinChunk(std::size_t timeStepIndex, std::size_t begin, std::size_t end, ThreadHistogramType& histograms) const;
+    void ComputeMoments(LabelStatistics& statistics) const;
+    HistogramType::Pointer CreateHistogram(const LabelStatistics& statistics) const;
+    void ComputeHistogramStatistics(LabelStatistics& statistics) const;
+
+    unsigned int m_NumberOfThreads;
+    BinCountFunctionType m_BinCount;
+    std::vector<TLabelPixel> m_RequestedLabels;
+
+    std::vector<typename ImageType::ConstPointer> m_Images;
+    std::vector<typename LabelImageType::ConstPointer> m_Labels;
+    std::vector<LabelStatisticsMapType> m_Statistics;
+  };
+}
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "mitkMultiLabelStatisticsAccumulator.hxx"
+#endif
+
+#endif
@@ -0,0 +1,432 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKMULTILABELSTATISTICSACCUMULATOR_HXX
+#define MITKMULTILABELSTATISTICSACCUMULATOR_HXX
+
+#include "mitkMultiLabelStatisticsAccumulator.h"
+
+#include <mitkExceptionMacro.h>
+#include <mitkHistogramStatisticsCalculator.h>
+#include <mitkRunInParallel.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mitk
+{
+  namespace MultiLabelStatisticsAccumulatorDetail
+  {
+    /** Number of pixels processed by a thread before it fetches the next chunk. */
+    const std::size_t ChunkSize = 65536;
+  }
+
+  template <typename TPixel, unsigned int VImageDimension, typename TLabelPixel>
+  MultiLabelStatisticsAccumulator<TPixel, VImageDimension, TLabelPixel>::MultiLabelStatisticsAccumulator()
+    : m_NumberOfThreads(GetDefaultNumberOfThreads())
+  {
+  }
+
+  template <typename TPixel, unsigned int VImageDimension, typename TLabelPixel>
+  void MultiLabelStatisticsAccumulator<TPixel, VImageDimension, TLabelPixel>::SetNumberOfThreads(unsigned int numberOfThreads)
+  {
+    m_NumberOfThreads = std::max(1u, numberOfThreads);
+  }
+
+  template <typename TPixel, unsigned int VImageDimension, typename TLabelPixel>
+  void MultiLabelStatisticsAccumulator<TPixel, VImageDimension, TLabelPixel>::SetBinCountFunction(const BinCountFunctionType& binCount)
+  {
+    m_BinCount = binCount;
+  }
+
+  template <typename TPixel, unsigned int VImageDimension, typename TLabelPixel>
+  void MultiLabelStatisticsAccumulator<TPixel, VImageDimension, TLabelPixel>::SetLabels(const std::vector<TLabelPixel>& labels)
+  {
+    m_RequestedLabels = labels;
+    std::sort(m_RequestedLabels.begin(), m_RequestedLabels.end());
+  }
+
+  template <typename TPixel, unsigned int VImageDimension, typename TLabelPixel>
+  std::size_t MultiLabelStatisticsAccumulator<TPixel, VImageDimension, TLabelPixel>::AddTimeStep(const ImageType* image, const LabelImageType* labels)
+  {
+    if (image == nullptr || labels == nullptr)
+    {
+      mitkThrow() << "Image and label image must not be null.";
+    }
+
+    if (image->GetBufferedRegion().GetSize() != labels->GetBufferedRegion().GetSize())
+    {
+      mitkThrow() << "Image and label image must have buffered regions of the same size.";
+    }
+
+    m_Images.push_back(image);
+    m_Labels.push_back(labels);
+    return m_Images.size() - 1;
+  }
+
+  template <typename TPixel, unsigned int VImageDimension, typename TLabelPixel>
+  const typename MultiLabelStatisticsAccumulator<TPixel, VImageDimension, TLabelPixel>::LabelStatisticsMapType&
+    MultiLabelStatisticsAccumulator<TPixel, VImageDimension, TLabelPixel>::GetLabelStatistics(std::size_t timeStepIndex) const
+  {
+    if (timeStepIndex >= m_Statistics.size())
+    {
+      mitkThrow() << "No statistics computed for time step index " << timeStepIndex << ".";
+    }
+    return m_Statistics[timeStepIndex];
+  }
+
+  template <typename TPixel, unsigned int VImageDimension, typename TLabelPixel>
+  bool MultiLabelStatisticsAccumulator<TPixel, VImageDimension, TLabelPixel>::IsLabelRequested(TLabelPixel label) const
+  {
+    if (m_RequestedLabels.empty())
+    {
+      return true;
+    }
+    return std::binary_search(m_RequestedLabels.begin(), m_RequestedLabels.end(), label);
+  }
+
+  template <typename TPixel, unsigned int VImageDimension, typename TLabelPixel>
+  void MultiLabelStatisticsAccumulator<TPixel, VImageDimension, TLabelPixel>::AccumulateChunk(std::size_t timeStepIndex,
+    std::size_t begin, std::size_t end, ThreadResultType& result) const
+  {
+    const TPixel* pixels = m_Images[timeStepIndex]->GetBufferPointer();
+    const TLabelPixel* labels = m_Labels[timeStepIndex]->GetBufferPointer();
+    auto& partials = result[timeStepIndex];
+
+    // nullptr for labels that are not requested
+    Partial* current = nullptr;
+    TLabelPixel currentLabel = TLabelPixel();
+    bool hasCurrentLabel = false;
+
+    for (std::size_t offset = begin; offset < end; ++offset)
+    {
+      const TPixel pixel = pixels[offset];
+      const TLabelPixel label = labels[offset];
+
+      // labels usually come in runs, only look up the map when the label changes
+      if (!hasCurrentLabel || label != currentLabel)
+      {
+        current = nullptr;
+        currentLabel = label;
+        hasCurrentLabel = true;
+
+        if (this->IsLabelRequested(label))
+        {
+          auto finding = partials.find(label);
+          if (finding == partials.end())
+          {
+            finding = partials.emplace(label, Partial()).first;
+            finding->second.Minimum = pixel;
+            finding->second.Maximum = pixel;
+            finding->second.MinimumOffset = offset;
+            finding->second.MaximumOffset = offset;
+          }
+          current = &(finding->second);
+        }
+      }
+
+      if (current == nullptr)
+      {
+        continue;
+      }
+
+      // chunks of a thread are processed in increasing order, so keeping the first
+      // occurrence here yields the smallest offset of this thread
+      if (pixel < current->Minimum)
+      {
+        current->Minimum = pixel;
+        current->MinimumOffset = offset;
+      }
+      if (pixel > current->Maximum)
+      {
+        current->Maximum = pixel;
+        current->MaximumOffset = offset;
+      }
+
+      const double value = static_cast<double>(pixel);
+      current->Sum += value;
+      current->SumOfSquares += value * value;
+      current->SumOfCubes += std::pow(value, 3.);
+      current->SumOfQuadruples += std::pow(value, 4.);
+      ++current->Count;
+
+      if (value > 0)
+      {
+        ++current->PositivePixelCount;
+        current->SumOfPositivePixels += value;
+      }
+    }
+  }
+
+  template <typename TPixel, unsigned int VImageDimension, typename TLabelPixel>
+  void MultiLabelStatisticsAccumulator<TPixel, VImageDimension, TLabelPixel>::BinChunk(std::size_t timeStepIndex,
+    std::size_t begin, std::size_t end, ThreadHistogramType& histograms) const
+  {
+    const TPixel* pixels = m_Images[timeStepIndex]->GetBufferPointer();
+    const TLabelPixel* labels = m_Labels[timeStepIndex]->GetBufferPointer();
+    auto& threadHistograms = histograms[timeStepIndex];
+    const auto& statistics = m_Statistics[timeStepIndex];
+
+    // nullptr for labels without statistics, i.e. labels that are not requested
+    HistogramType* current = nullptr;
+    TLabelPixel currentLabel = TLabelPixel();
+    bool hasCurrentLabel = false;
+
+    typename HistogramType::MeasurementVectorType measurement;
+    measurement.SetSize(1);
+    typename HistogramType::IndexType histogramIndex;
+    histogramIndex.SetSize(1);
+
+    for (std::size_t offset = begin; offset < end; ++offset)
+    {
+      const TLabelPixel label = labels[offset];
+
+      if (!hasCurrentLabel || label != currentLabel)
+      {
+        current = nullptr;
+        currentLabel = label;
+        hasCurrentLabel = true;
+
+        auto finding = threadHistograms.find(label);
+        if (finding != threadHistograms.end())
+        {
+          current = finding->second;
+        }
+        else
+        {
+          auto labelStatistics = statistics.find(label);
+          if (labelStatistics != statistics.end())
+          {
+            auto histogram = this->CreateHistogram(labelStatistics->second);
+            threadHistograms[label] = histogram;
+            current = histogram;
+          }
+        }
+      }
+
+      if (current == nullptr)
+      {
+        continue;
+      }
+
+      measurement[0] = static_cast<double>(pixels[offset]);
+      if (current->GetIndex(measurement, histogramIndex))
+      {
+        current->IncreaseFrequencyOfIndex(histogramIndex, 1);
+      }
+    }
+  }
+
+  template <typename TPixel, unsigned int VImageDimension, typename TLabelPixel>
+  void MultiLabelStatisticsAccumulator<TPixel, VImageDimension, TLabelPixel>::ComputeMoments(LabelStatistics& statistics) const
+  {
+    const double count = static_cast<double>(statistics.Count);
+
+    // same formulas as itk::ExtendedLabelStatisticsImageFilter
+    statistics.Mean = statistics.Sum / count;
+    statistics.MPP = statistics.SumOfPositivePixels / static_cast<double>(statistics.PositivePixelCount);
+    statistics.Variance = (statistics.SumOfSquares - statistics.Sum * statistics.Sum / count) / count;
+
+    const double secondMoment = statistics.SumOfSquares / count;
+    const double thirdMoment = statistics.SumOfCubes / count;
+    const double fourthMoment = statistics.SumOfQuadruples / count;
+
+    statistics.Skewness = (thirdMoment - 3. * secondMoment * statistics.Mean + 2. * std::pow(statistics.Mean, 3.)) /
+      std::pow(secondMoment - std::pow(statistics.Mean, 2.), 1.5);
+    statistics.Kurtosis = (fourthMoment - 4. * thirdMoment * statistics.Mean + 6. * secondMoment * std::pow(statistics.Mean, 2.) -
+      3. * std::pow(statistics.Mean, 4.)) / std::pow(secondMoment - std::pow(statistics.Mean, 2.), 2.);
+    statistics.Sigma = std::sqrt(statistics.Variance);
+  }
+
+  template <typename TPixel, unsigned int VImageDimension, typename TLabelPixel>
+  typename MultiLabelStatisticsAccumulator<TPixel, VImageDimension, TLabelPixel>::HistogramType::Pointer
+    MultiLabelStatisticsAccumulator<TPixel, VImageDimension, TLabelPixel>::CreateHistogram(const LabelStatistics& statistics) const
+  {
+    HistogramType::Pointer histogram = HistogramType::New();
+    typename HistogramType::SizeType size;
+    typename HistogramType::MeasurementVectorType lowerBound;
+    typename HistogramType::MeasurementVectorType upperBound;
+    size.SetSize(1);
+    lowerBound.SetSize(1);
+    upperBound.SetSize(1);
+    histogram->SetMeasurementVectorSize(1);
+    size[0] = m_BinCount(statistics.Minimum, statistics.Maximum);
+    lowerBound[0] = statistics.Minimum;
+    upperBound[0] = statistics.Maximum;
+    histogram->Initialize(size, lowerBound, upperBound);
+    return histogram;
+  }
+
+  template <typename TPixel, unsigned int VImageDimension, typename TLabelPixel>
+  void MultiLabelStatisticsAccumulator<TPixel, VImageDimension, TLabelPixel>::ComputeHistogramStatistics(LabelStatistics& statistics) const
+  {
+    HistogramStatisticsCalculator histogramStatisticsCalculator;
+    histogramStatisticsCalculator.SetHistogram(statistics.Histogram);
+    histogramStatisticsCalculator.CalculateStatistics();
+    statistics.Median = histogramStatisticsCalculator.GetMedian();
+    statistics.Entropy = histogramStatisticsCalculator.GetEntropy();
+    statistics.Uniformity = histogramStatisticsCalculator.GetUniformity();
+    statistics.UPP = histogramStatisticsCalculator.GetUPP();
+  }
+
+  template <typename TPixel, unsigned int VImageDimension, typename TLabelPixel>
+  void MultiLabelStatisticsAccumulator<TPixel, VImageDimension, TLabelPixel>::Compute()
+  {
+    const std::size_t numberOfTimeSteps = m_Images.size();
+    m_Statistics.assign(numberOfTimeSteps, LabelStatisticsMapType());
+
+    // chunks of all time steps form one pool of work
+    struct Chunk
+    {
+      std::size_t TimeStepIndex;
+      std::size_t Begin;
+      std::size_t End;
+    };
+
+    std::vector<Chunk> chunks;
+    for (std::size_t t = 0; t < numberOfTimeSteps; ++t)
+    {
+      const std::size_t numberOfPixels = m_Images[t]->GetBufferedRegion().GetNumberOfPixels();
+      for (std::size_t begin = 0; begin < numberOfPixels; begin += MultiLabelStatisticsAccumulatorDetail::ChunkSize)
+      {
+        chunks.push_back({ t, begin, std::min(begin + MultiLabelStatisticsAccumulatorDetail::ChunkSize, numberOfPixels) });
+      }
+    }
+
+    if (chunks.empty())
+    {
+      return;
+    }
+
+    const std::size_t numberOfThreads = GetNumberOfParallelThreads(m_NumberOfThreads, chunks.size());
+    std::vector<ThreadResultType> threadResults(numberOfThreads, ThreadResultType(numberOfTimeSteps));
+
+    RunInParallel(m_NumberOfThreads, chunks.size(), [&](std::size_t chunkId, std::size_t threadId)
+    {
+      const Chunk& chunk = chunks[chunkId];
+      this->AccumulateChunk(chunk.TimeStepIndex, chunk.Begin, chunk.End, threadResults[threadId]);
+    });
+
+    // reduce the partial results of all threads, ties of the extrema resolve to the smallest offset
+    for (std::size_t t = 0; t < numberOfTimeSteps; ++t)
+    {
+      std::map<TLabelPixel, Partial> reduced;
+
+      for (const auto& threadResult : threadResults)
+      {
+        for (const auto& iter : threadResult[t])
+        {
+          const Partial& partial = iter.second;
+          auto finding = reduced.find(iter.first);
+          if (finding == reduced.end())
+          {
+            reduced[iter.first] = partial;
+          }
+          else
+          {
+            Partial& target = finding->second;
+            target.Count += partial.Count;
+            target.PositivePixelCount += partial.PositivePixelCount;
+            target.Sum += partial.Sum;
+            target.SumOfSquares += partial.SumOfSquares;
+            target.SumOfCubes += partial.SumOfCubes;
+            target.SumOfQuadruples += partial.SumOfQuadruples;
+            target.SumOfPositivePixels += partial.SumOfPositivePixels;
+
+            if (partial.Minimum < target.Minimum ||
+                (!(target.Minimum < partial.Minimum) && partial.MinimumOffset < target.MinimumOffset))
+            {
+              target.Minimum = partial.Minimum;
+              target.MinimumOffset = partial.MinimumOffset;
+            }
+            if (partial.Maximum > target.Maximum ||
+                (!(target.Maximum > partial.Maximum) && partial.MaximumOffset < target.MaximumOffset))
+            {
+              target.Maximum = partial.Maximum;
+              target.MaximumOffset = partial.MaximumOffset;
+            }
+          }
+        }
+      }
+
+      for (const auto& iter : reduced)
+      {
+        const Partial& partial = iter.second;
+        LabelStatistics& statistics = m_Statistics[t][iter.first];
+        statistics.Count = partial.Count;
+        statistics.PositivePixelCount = partial.PositivePixelCount;
+        statistics.Sum = partial.Sum;
+        statistics.SumOfSquares = partial.SumOfSquares;
+        statistics.SumOfCubes = partial.SumOfCubes;
+        statistics.SumOfQuadruples = partial.SumOfQuadruples;
+        statistics.SumOfPositivePixels = partial.SumOfPositivePixels;
+        statistics.Minimum = partial.Minimum;
+        statistics.Maximum = partial.Maximum;
+        statistics.MinimumIndex = m_Images[t]->ComputeIndex(partial.MinimumOffset);
+        statistics.MaximumIndex = m_Images[t]->ComputeIndex(partial.MaximumOffset);
+        this->ComputeMoments(statistics);
+      }
+    }
+
+    if (!m_BinCount)
+    {
+      return;
+    }
+
+    // the extrema are known now, so the second pass bins the pixels right away
+    std::vector<ThreadHistogramType> threadHistograms(numberOfThreads, ThreadHistogramType(numberOfTimeSteps));
+
+    RunInParallel(m_NumberOfThreads, chunks.size(), [&](std::size_t chunkId, std::size_t threadId)
+    {
+      const Chunk& chunk = chunks[chunkId];
+      this->BinChunk(chunk.TimeStepIndex, chunk.Begin, chunk.End, threadHistograms[threadId]);
+    });
+
+    std::vector<LabelStatistics*> histogramStatistics;
+    for (std::size_t t = 0; t < numberOfTimeSteps; ++t)
+    {
+      for (auto& iter : m_Statistics[t])
+      {
+        LabelStatistics& statistics = iter.second;
+        statistics.Histogram = this->CreateHistogram(statistics);
+
+        for (const auto& threadHistogram : threadHistograms)
+        {
+          auto finding = threadHistogram[t].find(iter.first);
+          if (finding == threadHistogram[t].end())
+          {
+            continue;
+          }
+
+          for (typename HistogramType::InstanceIdentifier bin = 0; bin < statistics.Histogram->Size(); ++bin)
+          {
+            statistics.Histogram->IncreaseFrequency(bin, finding->second->GetFrequency(bin));
+          }
+        }
+
+        histogramStatistics.push_back(&statistics);
+      }
+    }
+
+    // histograms of different labels and time steps are independent
+    RunInParallel(m_NumberOfThreads, histogramStatistics.size(), [&](std::size_t taskId, std::size_t)
+    {
+      this->ComputeHistogramStatistics(*(histogramStatistics[taskId]));
+    });
+  }
+}
+
+#endif
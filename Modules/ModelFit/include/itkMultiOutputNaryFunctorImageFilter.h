@@ -20,6 +20,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "itkImageToImageFilter.h"
 #include "itkImageIterator.h"
 #include "itkArray.h"
+#include "itkProgressReporter.h"
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <vector>
 
 namespace itk
 {
@@ -38,6 +44,13 @@ namespace itk
  *
  * All the input images must be of the same type.
  *
+ * By default the output region is divided into small chunks (see SetChunkSize()) that are
+ * scheduled dynamically: every thread starts with a contiguous range of chunks and threads
+ * that finished their range steal the remaining chunks of the busiest thread. Thus regions
+ * with expensive pixels (e.g. model fits that need many iterations) do not stall the filter.
+ * Each thread works on its own copy of the functor. A chunk size of 0 restores the static
+ * region splitting of itk::ImageSource.
+ *
  * \ingroup IntensityImageFilters MultiThreaded
  * \ingroup ITKImageIntensity
  */
@@ -100,6 +113,11 @@ public:
   itkSetObjectMacro(Mask, MaskImageType);
   itkGetConstObjectMacro(Mask, MaskImageType);
 
+  /** Approximate number of pixels per scheduled chunk. Chunks always contain complete image lines
+   * (except for 1D images). 0 deactivates the dynamic scheduling. Default is 256.*/
+  itkSetMacro(ChunkSize, SizeValueType);
+  itkGetConstMacro(ChunkSize, SizeValueType);
+
   /** ImageDimension constants */
   itkStaticConstMacro(
     InputImageDimension, unsigned int, TInputImage::ImageDimension);
@@ -131,15 +149,66 @@ protected:
   void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                             ThreadIdType threadId) override;
 
+  /** If a chunk size is set, the output is generated by the dynamic chunk scheduling,
+   * otherwise the superclass implementation is used.*/
+  void GenerateData() override;
+
+  /** Creates the functor copies for the threads.*/
+  void BeforeThreadedGenerateData() override;
+
+  /** Releases the functor copies of the threads.*/
+  void AfterThreadedGenerateData() override;
+
   /** Methods actualize the output settings of the filter according to the current functor*/
   void ActualizeOutputs();
 
+  /** Applies the passed functor to all pixels of the region.
+   * @param progress Optional reporter that is updated per pixel.*/
+  void ProcessRegion(const OutputImageRegionType & region, FunctorType & functor, ProgressReporter * progress);
+
 private:
   MultiOutputNaryFunctorImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);         //purposely not implemented
 
+  /** Chunks of one thread that are not processed yet. The owning thread takes
+   * chunks from the front, stealing threads take them from the back.*/
+  struct ChunkRange
+  {
+    std::mutex Mutex;
+    std::size_t Begin = 0;
+    std::size_t End = 0;
+  };
+
+  struct ChunkSchedule
+  {
+    Self* Filter = nullptr;
+    std::vector<OutputImageRegionType> Chunks;
+    std::vector<ChunkRange> Ranges;
+    SizeValueType NumberOfPixels = 0;
+    std::atomic<SizeValueType> ProcessedPixels;
+    std::atomic<bool> Stop;
+    std::mutex ExceptionMutex;
+    std::exception_ptr Exception;
+  };
+
+  /** Divides the region in chunks of approximately m_ChunkSize pixels.*/
+  std::vector<OutputImageRegionType> GenerateChunks(const OutputImageRegionType & region) const;
+
+  /** Gets the next chunk for the thread. First its own range is used, then chunks are stolen
+   * from the thread with the most remaining chunks. Returns false if all chunks are taken.*/
+  static bool NextChunk(ChunkSchedule & schedule, ThreadIdType threadId, std::size_t & chunkId);
+
+  /** Processes chunks until the schedule is exhausted, stopped or an error occurred.*/
+  void ProcessChunks(ChunkSchedule & schedule, ThreadIdType threadId);
+
+  static ITK_THREAD_RETURN_TYPE ChunkThreaderCallback(void *arg);
+
   FunctorType m_Functor;
   MaskImagePointer m_Mask;
+  SizeValueType m_ChunkSize;
+
+  /** Copies of m_Functor (one per thread), valid during GenerateData().*/
+  std::vector<FunctorType> m_ThreadFunctors;
 };
 } // end namespace itk
 
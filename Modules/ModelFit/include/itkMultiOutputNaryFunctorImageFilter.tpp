@@ -21,6 +21,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "itkImageRegionIterator.h"
 #include "itkProgressReporter.h"
 
+#include <algorithm>
+
 namespace itk
 {
   /**
@@ -34,6 +36,8 @@ namespace itk
     // is added over the two minimum required
     this->SetNumberOfRequiredInputs(1);
 
+    m_ChunkSize = 256;
+
     this->ActualizeOutputs();
   }
 
@@ -55,6 +59,249 @@ namespace itk
     }
   };
 
+  template< class TInputImage, class TOutputImage, class TFunction, class TMaskImage >
+  void
+    MultiOutputNaryFunctorImageFilter< TInputImage, TOutputImage, TFunction, TMaskImage >
+    ::BeforeThreadedGenerateData()
+  {
+    Superclass::BeforeThreadedGenerateData();
+
+    // Functors may hold state that is reused between pixels (e.g. fit workspaces),
+    // thus every thread gets its own copy.
+    m_ThreadFunctors.assign(this->GetNumberOfThreads(), m_Functor);
+  }
+
+  template< class TInputImage, class TOutputImage, class TFunction, class TMaskImage >
+  void
+    MultiOutputNaryFunctorImageFilter< TInputImage, TOutputImage, TFunction, TMaskImage >
+    ::AfterThreadedGenerateData()
+  {
+    m_ThreadFunctors.clear();
+
+    Superclass::AfterThreadedGenerateData();
+  }
+
+  template< class TInputImage, class TOutputImage, class TFunction, class TMaskImage >
+  void
+    MultiOutputNaryFunctorImageFilter< TInputImage, TOutputImage, TFunction, TMaskImage >
+    ::GenerateData()
+  {
+    if (m_ChunkSize == 0)
+    {
+      Superclass::GenerateData();
+      return;
+    }
+
+    this->AllocateOutputs();
+
+    this->BeforeThreadedGenerateData();
+
+    ChunkSchedule schedule;
+    schedule.Filter = this;
+    schedule.Chunks = this->GenerateChunks(this->GetOutput()->GetRequestedRegion());
+    schedule.NumberOfPixels = this->GetOutput()->GetRequestedRegion().GetNumberOfPixels();
+    schedule.ProcessedPixels = 0;
+    schedule.Stop = false;
+
+    const std::size_t numberOfChunks = schedule.Chunks.size();
+    const ThreadIdType numberOfThreads = static_cast<ThreadIdType>(std::max<std::size_t>(1,
+      std::min<std::size_t>(this->GetNumberOfThreads(), numberOfChunks)));
+
+    // every thread starts with a contiguous range of chunks to keep its accesses local
+    schedule.Ranges = std::vector<ChunkRange>(numberOfThreads);
+    for (ThreadIdType i = 0; i < numberOfThreads; ++i)
+    {
+      schedule.Ranges[i].Begin = (numberOfChunks * i) / numberOfThreads;
+      schedule.Ranges[i].End = (numberOfChunks * (i + 1)) / numberOfThreads;
+    }
+
+    // the multi threader may be shared, so its thread count is only lowered for this execution
+    MultiThreader* multiThreader = this->GetMultiThreader();
+    const ThreadIdType previousNumberOfThreads = multiThreader->GetNumberOfThreads();
+    multiThreader->SetNumberOfThreads(numberOfThreads);
+    multiThreader->SetSingleMethod(this->ChunkThreaderCallback, &schedule);
+    try
+    {
+      multiThreader->SingleMethodExecute();
+    }
+    catch (...)
+    {
+      multiThreader->SetNumberOfThreads(previousNumberOfThreads);
+      m_ThreadFunctors.clear();
+      throw;
+    }
+    multiThreader->SetNumberOfThreads(previousNumberOfThreads);
+
+    if (schedule.Exception)
+    {
+      m_ThreadFunctors.clear();
+      std::rethrow_exception(schedule.Exception);
+    }
+
+    this->UpdateProgress(1.0f);
+
+    this->AfterThreadedGenerateData();
+  }
+
+  template< class TInputImage, class TOutputImage, class TFunction, class TMaskImage >
+  std::vector<typename MultiOutputNaryFunctorImageFilter< TInputImage, TOutputImage, TFunction, TMaskImage >::OutputImageRegionType>
+    MultiOutputNaryFunctorImageFilter< TInputImage, TOutputImage, TFunction, TMaskImage >
+    ::GenerateChunks(const OutputImageRegionType & region) const
+  {
+    std::vector<OutputImageRegionType> chunks;
+
+    const typename OutputImageRegionType::SizeType& size = region.GetSize();
+    if (region.GetNumberOfPixels() == 0)
+    {
+      return chunks;
+    }
+
+    if (OutputImageDimension == 1)
+    {
+      for (SizeValueType pos = 0; pos < size[0]; pos += m_ChunkSize)
+      {
+        OutputImageRegionType chunk = region;
+        chunk.SetIndex(0, region.GetIndex(0) + pos);
+        chunk.SetSize(0, std::min(m_ChunkSize, size[0] - pos));
+        chunks.push_back(chunk);
+      }
+      return chunks;
+    }
+
+    // chunks consist of complete lines (dimension 0) of one slice (dimension 1);
+    // all higher dimensions are split into single indices.
+    const SizeValueType linesPerChunk = std::max<SizeValueType>(1, m_ChunkSize / size[0]);
+
+    SizeValueType numberOfSlices = 1;
+    for (unsigned int d = 2; d < OutputImageDimension; ++d)
+    {
+      numberOfSlices *= size[d];
+    }
+
+    for (SizeValueType slice = 0; slice < numberOfSlices; ++slice)
+    {
+      OutputImageRegionType chunk = region;
+
+      SizeValueType remainder = slice;
+      for (unsigned int d = 2; d < OutputImageDimension; ++d)
+      {
+        chunk.SetIndex(d, region.GetIndex(d) + static_cast<IndexValueType>(remainder % size[d]));
+        chunk.SetSize(d, 1);
+        remainder /= size[d];
+      }
+
+      for (SizeValueType line = 0; line < size[1]; line += linesPerChunk)
+      {
+        chunk.SetIndex(1, region.GetIndex(1) + static_cast<IndexValueType>(line));
+        chunk.SetSize(1, std::min(linesPerChunk, size[1] - line));
+        chunks.push_back(chunk);
+      }
+    }
+
+    return chunks;
+  }
+
+  template< class TInputImage, class TOutputImage, class TFunction, class TMaskImage >
+  bool
+    MultiOutputNaryFunctorImageFilter< TInputImage, TOutputImage, TFunction, TMaskImage >
+    ::NextChunk(ChunkSchedule & schedule, ThreadIdType threadId, std::size_t & chunkId)
+  {
+    {
+      ChunkRange& own = schedule.Ranges[threadId];
+      std::lock_guard<std::mutex> lock(own.Mutex);
+      if (own.Begin < own.End)
+      {
+        chunkId = own.Begin++;
+        return true;
+      }
+    }
+
+    while (true)
+    {
+      // look for the thread with the most remaining chunks
+      std::size_t victim = 0;
+      std::size_t maxRemaining = 0;
+      for (std::size_t i = 0; i < schedule.Ranges.size(); ++i)
+      {
+        ChunkRange& range = schedule.Ranges[i];
+        std::lock_guard<std::mutex> lock(range.Mutex);
+        if (range.End - range.Begin > maxRemaining)
+        {
+          maxRemaining = range.End - range.Begin;
+          victim = i;
+        }
+      }
+
+      if (maxRemaining == 0)
+      {
+        return false;
+      }
+
+      ChunkRange& range = schedule.Ranges[victim];
+      std::lock_guard<std::mutex> lock(range.Mutex);
+      if (range.Begin < range.End)
+      {
+        chunkId = --range.End;
+        return true;
+      }
+      // the victim has finished its range in the meantime, search again
+    }
+  }
+
+  template< class TInputImage, class TOutputImage, class TFunction, class TMaskImage >
+  void
+    MultiOutputNaryFunctorImageFilter< TInputImage, TOutputImage, TFunction, TMaskImage >
+    ::ProcessChunks(ChunkSchedule & schedule, ThreadIdType threadId)
+  {
+    try
+    {
+      FunctorType& functor = m_ThreadFunctors[threadId];
+      std::size_t chunkId = 0;
+
+      while (!schedule.Stop && NextChunk(schedule, threadId, chunkId))
+      {
+        if (this->GetAbortGenerateData())
+        {
+          ProcessAborted e(__FILE__, __LINE__);
+          e.SetDescription("Process aborted.");
+          e.SetLocation(ITK_LOCATION);
+          throw e;
+        }
+
+        const OutputImageRegionType& chunk = schedule.Chunks[chunkId];
+        this->ProcessRegion(chunk, functor, nullptr);
+
+        const SizeValueType processed = schedule.ProcessedPixels += chunk.GetNumberOfPixels();
+        if (threadId == 0)
+        {
+          this->UpdateProgress(static_cast<float>(processed) / static_cast<float>(schedule.NumberOfPixels));
+        }
+      }
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(schedule.ExceptionMutex);
+      if (!schedule.Exception)
+      {
+        schedule.Exception = std::current_exception();
+      }
+      schedule.Stop = true;
+    }
+  }
+
+  template< class TInputImage, class TOutputImage, class TFunction, class TMaskImage >
+  ITK_THREAD_RETURN_TYPE
+    MultiOutputNaryFunctorImageFilter< TInputImage, TOutputImage, TFunction, TMaskImage >
+    ::ChunkThreaderCallback(void *arg)
+  {
+    MultiThreader::ThreadInfoStruct* info = static_cast<MultiThreader::ThreadInfoStruct*>(arg);
+    ChunkSchedule* schedule = static_cast<ChunkSchedule*>(info->UserData);
+
+    schedule->Filter->ProcessChunks(*schedule, info->ThreadID);
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
   /**
   * ThreadedGenerateData Performs the pixel-wise addition
   */
@@ -67,6 +314,15 @@ namespace itk
     ProgressReporter progress( this, threadId,
       outputRegionForThread.GetNumberOfPixels() );
 
+    this->ProcessRegion(outputRegionForThread, m_ThreadFunctors[threadId], &progress);
+  }
+
+  template< class TInputImage, class TOutputImage, class TFunction, class TMaskImage >
+  void
+    MultiOutputNaryFunctorImageFilter< TInputImage, TOutputImage, TFunction, TMaskImage >
+    ::ProcessRegion(const OutputImageRegionType & outputRegionForThread, FunctorType & functor,
+    ProgressReporter * progress)
+  {
     const unsigned int numberOfInputImages =
       static_cast< unsigned int >( this->GetNumberOfIndexedInputs() );
 
@@ -168,7 +424,7 @@ namespace itk
 
           if (isValid)
           {
-            naryOutputArray = m_Functor(naryInputArray, currentIndex);
+            naryOutputArray = functor(naryInputArray, currentIndex);
 
             if (numberOfValidOutputImages != naryOutputArray.size())
             {
@@ -192,7 +448,10 @@ namespace itk
             ++regionOutputIterators;
           }
 
-          progress.CompletedPixel();
+          if (progress)
+          {
+            progress->CompletedPixel();
+          }
         }
       }
       catch(...)
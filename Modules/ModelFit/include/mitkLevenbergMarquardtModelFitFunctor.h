@@ -64,6 +64,11 @@ namespace mitk
 
     ParameterNamesType GetCriterionNames() const override;
 
+    /** The workspace keeps the cost function (see GenerateCostFunction()) and the optimizer.
+     * Subsequent fits only update model and sample of the cost function. If the cost function
+     * is a MVConstrainedCostFunctionDecorator, its wrapped cost function is updated as well.*/
+    Workspace::Pointer CreateWorkspace() const override;
+
   protected:
 
     typedef Superclass::ParametersType ParametersType;
@@ -77,6 +82,10 @@ namespace mitk
                                       const ModelBase::ParametersType& initialParameters,
                                       DebugParameterMapType& debugParameters) const override;
 
+    ParametersType DoModelFitInWorkspace(const SignalType& value, const ModelBase* model,
+                                         const ModelBase::ParametersType& initialParameters,
+                                         DebugParameterMapType& debugParameters, Workspace* workspace) const override;
+
     OutputPixelArrayType GetCriteria(const ModelBase* model, const ParametersType& parameters,
         const SignalType& sample) const override;
 
@@ -87,6 +96,13 @@ namespace mitk
     ParameterNamesType DefineDebugParameterNames() const override;
 
   private:
+    class LevenbergMarquardtWorkspace;
+
+    /** Configures the optimizer, runs the fit and collects the debug parameters.*/
+    ParametersType Optimize(::itk::LevenbergMarquardtOptimizer* optimizer, const MVModelFitCostFunction* metric,
+                            const ModelBase* model, const ModelBase::ParametersType& initialParameters,
+                            DebugParameterMapType& debugParameters) const;
+
     double m_Epsilon;
     double m_GradientTolerance;
     double m_ValueTolerance;
@@ -78,6 +78,13 @@ namespace mitk
     typedef double DerivedParameterValueType;
     typedef std::map<ParameterNameType, DerivedParameterValueType> DerivedParameterMapType;
 
+    /** Type of a batch of parameter sets (structure of arrays). Each row holds the values of one
+     * parameter (in the order of GetParameterNames()), each column is one parameter set.*/
+    typedef itk::Array2D<ParameterValueType> BatchParametersType;
+    /** Type of the signals of a batch (structure of arrays). Each row holds the values of one
+     * time point of the time grid, each column is the signal of one parameter set.*/
+    typedef itk::Array2D<double> BatchSignalsType;
+
     /**Default implementation returns a scale of 1.0 for every defined parameter.*/
     ParamterScaleMapType GetParameterScales() const override;
 
@@ -172,10 +179,25 @@ namespace mitk
 
     ModelResultType GetSignal(const ParametersType& parameters) const;
 
+    /** Computes the signals of several parameter sets at once. Column n of signals is the result of
+     * GetSignal() for column n of parameters. The batch shares the time grid and static parameters
+     * of the model.
+     * @param parameters Parameter sets; the number of rows must equal GetNumberOfParameters().
+     * @param signals Preallocated result buffer with one row per time point of the time grid and
+     * one column per parameter set. It is not resized, so it can be reused for several batches.
+     * @pre The model must be in a valid state (see GetSignal()).*/
+    void GetSignals(const BatchParametersType& parameters, BatchSignalsType& signals) const;
+
   protected:
 
     virtual ModelResultType ComputeModelfunction(const ParametersType& parameters) const = 0;
 
+    /** Member is called by GetSignals() after the validation of the model and the buffer sizes.
+     * The default implementation calls ComputeModelfunction() for every parameter set. Reimplement it
+     * in derived classes with the parameter sets as innermost loop, so that the evaluation of the batch
+     * can be vectorized. The results must equal the ones of ComputeModelfunction().*/
+    virtual void ComputeModelfunctions(const BatchParametersType& parameters, BatchSignalsType& signals) const;
+
     /** Member is called by GetSignal() before ComputeModelfunction(). It indicates if model is in a valid state and
      * ready to compute the signal. The default implementation checks nothing and always returns true.
      * Reimplement to realize special behavior for derived classes.
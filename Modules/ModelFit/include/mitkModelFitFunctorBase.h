@@ -58,6 +58,33 @@ namespace mitk
     OutputPixelArrayType Compute(const InputPixelArrayType& value, const ModelBase* model,
                                  const ModelBase::ParametersType& initialParameters) const;
 
+    /** Objects a functor may reuse between consecutive fits instead of recreating them for
+     * every signal (e.g. cost functions and optimizers). A workspace is owned by one thread;
+     * it must not be used by concurrent Compute() calls.*/
+    class MITKMODELFIT_EXPORT Workspace : public ::itk::LightObject
+    {
+    public:
+      typedef Workspace Self;
+      typedef ::itk::LightObject Superclass;
+      typedef itk::SmartPointer< Self > Pointer;
+
+      itkTypeMacro(Workspace, ::itk::LightObject);
+
+    protected:
+      Workspace();
+      ~Workspace() override;
+    };
+
+    /** Creates a workspace for the calling thread that can be passed to Compute().
+     * The default implementation returns nullptr, which means that the functor has nothing to reuse.*/
+    virtual Workspace::Pointer CreateWorkspace() const;
+
+    /** Same as Compute() without workspace, but the functor may reuse the objects stored in the
+     * passed workspace. The results are identical. workspace may be nullptr.
+     * @pre workspace must be created by CreateWorkspace() of this functor.*/
+    OutputPixelArrayType Compute(const InputPixelArrayType& value, const ModelBase* model,
+                                 const ModelBase::ParametersType& initialParameters, Workspace* workspace) const;
+
     /** Returns the number of outputs the fit functor will return if compute is called.
      * The number depends in parts on the passed model.
      * @exception Exception will be thrown if no valid model is passed.*/
@@ -123,6 +150,13 @@ namespace mitk
                                       const ModelBase::ParametersType& initialParameters,
                                       DebugParameterMapType& debugParameters) const = 0;
 
+    /** Internal Method called by Compute() if a workspace is passed. The default implementation ignores the
+    workspace and calls DoModelFit(). Functors that offer a workspace via CreateWorkspace() reimplement this method.
+    @param workspace Workspace created by CreateWorkspace(), never nullptr.*/
+    virtual ParametersType DoModelFitInWorkspace(const SignalType& value, const ModelBase* model,
+                                                 const ModelBase::ParametersType& initialParameters,
+                                                 DebugParameterMapType& debugParameters, Workspace* workspace) const;
+
     /** Returns names of the depug parameters generated by the functor. Will be called by GetDebugParameterNames,
     if debug is activated. */
     virtual ParameterNamesType DefineDebugParameterNames()const = 0;
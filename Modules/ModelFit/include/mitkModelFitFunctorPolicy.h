@@ -41,6 +41,23 @@ namespace mitk
     ModelFitFunctorPolicy()
     {};
 
+    /** Copies share functor and parameterizer but never the workspace. Thus every per thread
+     copy of the policy lazily creates its own workspace (see ModelFitFunctorBase::CreateWorkspace()).*/
+    ModelFitFunctorPolicy(const ModelFitFunctorPolicy& other) :
+      m_Functor(other.m_Functor), m_ModelParameterizer(other.m_ModelParameterizer)
+    {};
+
+    ModelFitFunctorPolicy& operator=(const ModelFitFunctorPolicy& other)
+    {
+      if (this != &other)
+      {
+        m_Functor = other.m_Functor;
+        m_ModelParameterizer = other.m_ModelParameterizer;
+        m_Workspace = nullptr;
+      }
+      return *this;
+    }
+
     ~ModelFitFunctorPolicy() {};
 
     unsigned int GetNumberOfOutputs() const
@@ -64,6 +81,7 @@ namespace mitk
       }
 
       m_Functor = functor;
+      m_Workspace = nullptr;
     }
 
     void SetModelParameterizer(const ParameterizerType* parameterizer)
@@ -104,7 +122,13 @@ namespace mitk
         m_ModelParameterizer->GenerateParameterizedModel(currentIndex);
       ParameterizerType::ParametersType initialParams = m_ModelParameterizer->GetInitialParameterization(
             currentIndex);
-      OutputPixelArrayType result = m_Functor->Compute(value, parameterizedModel, initialParams);
+
+      if (m_Workspace.IsNull())
+      {
+        m_Workspace = m_Functor->CreateWorkspace();
+      }
+
+      OutputPixelArrayType result = m_Functor->Compute(value, parameterizedModel, initialParams, m_Workspace);
 
       return result;
     }
@@ -113,6 +137,8 @@ namespace mitk
 
     FunctorConstPointer m_Functor;
     ParameterizerConstPointer m_ModelParameterizer;
+    /** Functor specific state that is reused between the fits of one thread.*/
+    mutable ModelFitFunctorBase::Workspace::Pointer m_Workspace;
   };
 
 }
@@ -75,6 +75,15 @@ public:
     itkGetMacro(TimeGridByParameterizer, bool);
     itkBooleanMacro(TimeGridByParameterizer);
 
+    /**Approximate number of voxels that are fitted as one scheduling unit. Threads that finished their
+    voxels steal chunks of busy threads. 0 deactivates the dynamic scheduling (static region split).*/
+    itkSetMacro(ChunkSize, unsigned int);
+    itkGetConstMacro(ChunkSize, unsigned int);
+
+    /**Number of threads used for fitting. 0 (default) uses the global default of ITK.*/
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
     double GetProgress() const override;
 
     ParameterNamesType GetParameterNames() const override;
@@ -86,7 +95,7 @@ public:
     ParameterNamesType GetEvaluationParameterNames() const override;
 
 protected:
-  PixelBasedParameterFitImageGenerator() : m_Progress(0), m_TimeGridByParameterizer(false)
+  PixelBasedParameterFitImageGenerator() : m_Progress(0), m_TimeGridByParameterizer(false), m_ChunkSize(256), m_NumberOfThreads(0)
   {
     m_InternalMask = nullptr;
     m_Mask = nullptr;
@@ -127,6 +136,9 @@ private:
     /**Indicates if the time grid defined in the parameterizer should be used (True)
     or if the filter should extract the time grid from the input image (False).*/
     bool m_TimeGridByParameterizer;
+
+    unsigned int m_ChunkSize;
+    unsigned int m_NumberOfThreads;
 };
 
 }
@@ -72,6 +72,9 @@ namespace mitk
 
     ModelResultType ComputeModelfunction(const ParametersType& parameters) const override;
 
+    /** Vectorizable evaluation of a parameter batch (see ModelBase::ComputeModelfunctions()).*/
+    void ComputeModelfunctions(const BatchParametersType& parameters, BatchSignalsType& signals) const override;
+
     void SetStaticParameter(const ParameterNameType& name,
                                     const StaticParameterValuesType& values) override;
     StaticParameterValuesType GetStaticParameterValue(const ParameterNameType& name) const override;
@@ -136,6 +136,12 @@ void
     fitFilter->SetMask(this->m_InternalMask);
   }
 
+  fitFilter->SetChunkSize(this->m_ChunkSize);
+  if (this->m_NumberOfThreads > 0)
+  {
+    fitFilter->SetNumberOfThreads(this->m_NumberOfThreads);
+  }
+
   //generate the fits
   fitFilter->Update();
 
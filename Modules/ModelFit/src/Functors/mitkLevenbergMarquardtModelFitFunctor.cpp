@@ -100,11 +100,92 @@ mitk::LevenbergMarquardtModelFitFunctor::DefineDebugParameterNames() const
   return result;
 };
 
+class mitk::LevenbergMarquardtModelFitFunctor::LevenbergMarquardtWorkspace : public ModelFitFunctorBase::Workspace
+{
+public:
+  typedef LevenbergMarquardtWorkspace Self;
+  typedef ModelFitFunctorBase::Workspace Superclass;
+  typedef itk::SmartPointer< Self > Pointer;
+
+  itkFactorylessNewMacro(Self);
+
+  MVModelFitCostFunction::Pointer m_CostFunction;
+  ::itk::LevenbergMarquardtOptimizer::Pointer m_Optimizer;
+  unsigned int m_NumberOfValues = 0;
+  unsigned int m_NumberOfParameters = 0;
+
+protected:
+  LevenbergMarquardtWorkspace() {};
+  ~LevenbergMarquardtWorkspace() override {};
+};
+
+mitk::ModelFitFunctorBase::Workspace::Pointer
+mitk::LevenbergMarquardtModelFitFunctor::
+CreateWorkspace() const
+{
+  return LevenbergMarquardtWorkspace::New().GetPointer();
+};
+
 mitk::LevenbergMarquardtModelFitFunctor::ParametersType
 mitk::LevenbergMarquardtModelFitFunctor::
 DoModelFit(const SignalType& value, const ModelBase* model,
            const ModelBase::ParametersType& initialParameters,
            DebugParameterMapType& debugParameters) const
+{
+  mitk::MVModelFitCostFunction::Pointer metric = this->GenerateCostFunction(value, model);
+
+  ::itk::LevenbergMarquardtOptimizer::Pointer optimizer = ::itk::LevenbergMarquardtOptimizer::New();
+  optimizer->SetCostFunction(metric);
+
+  return this->Optimize(optimizer, metric, model, initialParameters, debugParameters);
+};
+
+mitk::LevenbergMarquardtModelFitFunctor::ParametersType
+mitk::LevenbergMarquardtModelFitFunctor::
+DoModelFitInWorkspace(const SignalType& value, const ModelBase* model,
+                      const ModelBase::ParametersType& initialParameters,
+                      DebugParameterMapType& debugParameters, Workspace* workspace) const
+{
+  auto* lmWorkspace = dynamic_cast<LevenbergMarquardtWorkspace*>(workspace);
+  if (!lmWorkspace)
+  {
+    mitkThrow() << "Fit functor has invalid state. Passed workspace was not created by this functor.";
+  }
+
+  if (lmWorkspace->m_CostFunction.IsNull() || lmWorkspace->m_NumberOfValues != value.GetSize() ||
+      lmWorkspace->m_NumberOfParameters != model->GetNumberOfParameters())
+  {
+    // the optimizer adaptor is sized by the cost function, so both have to be (re)created
+    lmWorkspace->m_CostFunction = this->GenerateCostFunction(value, model);
+    lmWorkspace->m_Optimizer = ::itk::LevenbergMarquardtOptimizer::New();
+    lmWorkspace->m_Optimizer->SetCostFunction(lmWorkspace->m_CostFunction);
+    lmWorkspace->m_NumberOfValues = value.GetSize();
+    lmWorkspace->m_NumberOfParameters = model->GetNumberOfParameters();
+  }
+  else
+  {
+    lmWorkspace->m_CostFunction->SetModel(model);
+    lmWorkspace->m_CostFunction->SetSample(value);
+
+    auto* decorator = dynamic_cast<::mitk::MVConstrainedCostFunctionDecorator*>(lmWorkspace->m_CostFunction.GetPointer());
+    if (decorator)
+    {
+      //the wrapped cost function is owned by the workspace as well, so breaking constness is safe here
+      auto* wrapped = const_cast<MVModelFitCostFunction*>(decorator->GetWrappedCostFunction());
+      wrapped->SetModel(model);
+      wrapped->SetSample(value);
+      decorator->ResetEvaluationStatistics();
+    }
+  }
+
+  return this->Optimize(lmWorkspace->m_Optimizer, lmWorkspace->m_CostFunction, model, initialParameters, debugParameters);
+};
+
+mitk::LevenbergMarquardtModelFitFunctor::ParametersType
+mitk::LevenbergMarquardtModelFitFunctor::
+Optimize(::itk::LevenbergMarquardtOptimizer* optimizer, const MVModelFitCostFunction* metric,
+         const ModelBase* model, const ModelBase::ParametersType& initialParameters,
+         DebugParameterMapType& debugParameters) const
 {
     std::chrono::time_point<std::chrono::system_clock> startTime;
     startTime = std::chrono::system_clock::now();
@@ -127,11 +208,6 @@ DoModelFit(const SignalType& value, const ModelBase* model,
     scales.Fill(1.0);
   }
 
-  mitk::MVModelFitCostFunction::Pointer metric = this->GenerateCostFunction(value, model);
-
-  ::itk::LevenbergMarquardtOptimizer::Pointer optimizer = ::itk::LevenbergMarquardtOptimizer::New();
-
-  optimizer->SetCostFunction(metric);
   optimizer->SetEpsilonFunction(m_Epsilon);
   optimizer->SetGradientTolerance(m_GradientTolerance);
   optimizer->SetNumberOfIterations(m_Iterations);
@@ -156,7 +232,7 @@ DoModelFit(const SignalType& value, const ModelBase* model,
     debugParameters.insert(std::make_pair("stop_condition", value));
 
 
-    const ::mitk::MVConstrainedCostFunctionDecorator* decorator = dynamic_cast<const ::mitk::MVConstrainedCostFunctionDecorator*>(metric.GetPointer());
+    const ::mitk::MVConstrainedCostFunctionDecorator* decorator = dynamic_cast<const ::mitk::MVConstrainedCostFunctionDecorator*>(metric);
     if (decorator)
     {
       value = decorator->GetPenaltyRatio();
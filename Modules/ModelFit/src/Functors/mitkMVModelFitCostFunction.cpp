@@ -40,17 +40,47 @@ void mitk::MVModelFitCostFunction::GetDerivative (const ParametersType &paramete
 
   derivative.SetSize(paramCount,m_Sample.Size());
 
+  //evaluate all shifted parameter sets as one batch.
+  //Column 2*i holds the parameters with parameter i decreased, column 2*i+1 with parameter i increased.
+  ModelBase::BatchParametersType shiftedParameters(paramCount, 2 * paramCount);
+  for ( ParametersType::SizeValueType p = 0; p < paramCount; p++ )
+  {
+    for ( ParametersType::SizeValueType i = 0; i < paramCount; i++ )
+    {
+      shiftedParameters[p][2 * i] = parameters[p];
+      shiftedParameters[p][2 * i + 1] = parameters[p];
+    }
+    shiftedParameters[p][2 * p] -= m_DerivativeStepLength;
+    shiftedParameters[p][2 * p + 1] += m_DerivativeStepLength;
+  }
+
+  ModelBase::BatchSignalsType signals(m_Model->GetTimeGrid().GetSize(), 2 * paramCount);
+  m_Model->GetSignals(shiftedParameters, signals);
+
+  if(signals.rows() != m_Sample.GetSize()) itkExceptionMacro("Signal size does not matche sample size!");
+  if(signals.rows() == 0)  itkExceptionMacro("Signal is empty!");
+
+  SignalType signal(signals.rows());
+
   for ( ParametersType::SizeValueType i = 0; i < paramCount; i++ )
   {
     ParametersType newParameters = parameters;
     newParameters[i] -= m_DerivativeStepLength;
 
-    MeasureType e0 = GetValue(newParameters);
+    for(SignalType::SizeValueType t = 0; t<signal.GetSize(); ++t)
+    {
+      signal[t] = signals[t][2 * i];
+    }
+    MeasureType e0 = CalcMeasure(newParameters, signal);
 
     newParameters = parameters;
     newParameters[i] += m_DerivativeStepLength;
 
-    MeasureType e1 = GetValue(newParameters);
+    for(SignalType::SizeValueType t = 0; t<signal.GetSize(); ++t)
+    {
+      signal[t] = signals[t][2 * i + 1];
+    }
+    MeasureType e1 = CalcMeasure(newParameters, signal);
 
     for(MeasureType::SizeValueType j = 0; j<measureCount; ++j)
     {
@@ -16,10 +16,42 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkModelFitFunctorBase.h"
 
+mitk::ModelFitFunctorBase::Workspace::
+Workspace()
+{};
+
+mitk::ModelFitFunctorBase::Workspace::
+~Workspace()
+{};
+
+mitk::ModelFitFunctorBase::Workspace::Pointer
+mitk::ModelFitFunctorBase::
+CreateWorkspace() const
+{
+  return nullptr;
+};
+
+mitk::ModelFitFunctorBase::ParametersType
+mitk::ModelFitFunctorBase::
+DoModelFitInWorkspace(const SignalType& value, const ModelBase* model,
+                      const ModelBase::ParametersType& initialParameters,
+                      DebugParameterMapType& debugParameters, Workspace* /*workspace*/) const
+{
+  return this->DoModelFit(value, model, initialParameters, debugParameters);
+};
+
 mitk::ModelFitFunctorBase::OutputPixelArrayType
 mitk::ModelFitFunctorBase::
 Compute(const InputPixelArrayType& value, const ModelBase* model,
         const ModelBase::ParametersType& initialParameters) const
+{
+  return this->Compute(value, model, initialParameters, nullptr);
+};
+
+mitk::ModelFitFunctorBase::OutputPixelArrayType
+mitk::ModelFitFunctorBase::
+Compute(const InputPixelArrayType& value, const ModelBase* model,
+        const ModelBase::ParametersType& initialParameters, Workspace* workspace) const
 {
   if (!model)
   {
@@ -46,7 +78,9 @@ Compute(const InputPixelArrayType& value, const ModelBase* model,
     debugNames = this->GetDebugParameterNames();
   }
 
-  ParametersType fittedParameters = DoModelFit(sample, model, initialParameters, debugParams);
+  ParametersType fittedParameters = workspace ?
+    this->DoModelFitInWorkspace(sample, model, initialParameters, debugParams, workspace) :
+    this->DoModelFit(sample, model, initialParameters, debugParams);
 
   OutputPixelArrayType derivedParameters = this->GetDerivedParameters(model, fittedParameters);
 
@@ -150,6 +150,58 @@ mitk::ModelBase::ModelResultType mitk::ModelBase::GetSignal(const ParametersType
   return signal;
 }
 
+void mitk::ModelBase::GetSignals(const BatchParametersType& parameters, BatchSignalsType& signals) const
+{
+  if (parameters.rows() != this->GetNumberOfParameters())
+  {
+    itkExceptionMacro("Passed parameter batch has wrong size for model. Cannot evaluate model. Required rows: "
+                      << this->GetNumberOfParameters() << "; passed rows: " << parameters.rows());
+  }
+
+  if (signals.rows() != m_TimeGrid.GetSize() || signals.cols() != parameters.cols())
+  {
+    itkExceptionMacro("Passed signal buffer has wrong size. Cannot evaluate model. Required size: "
+                      << m_TimeGrid.GetSize() << "x" << parameters.cols() << "; passed size: " << signals.rows() << "x"
+                      << signals.cols());
+  }
+
+  std::string error;
+
+  if (!ValidateModel(error))
+  {
+    itkExceptionMacro("Cannot evaluate model and return signals. Model is in an invalid state. Validation error: "
+                      << error);
+  }
+
+  ComputeModelfunctions(parameters, signals);
+}
+
+void mitk::ModelBase::ComputeModelfunctions(const BatchParametersType& parameters, BatchSignalsType& signals) const
+{
+  ParametersType parameterSet(parameters.rows());
+
+  for (unsigned int n = 0; n < parameters.cols(); ++n)
+  {
+    for (unsigned int p = 0; p < parameters.rows(); ++p)
+    {
+      parameterSet[p] = parameters[p][n];
+    }
+
+    const ModelResultType signal = ComputeModelfunction(parameterSet);
+
+    if (signal.GetSize() != signals.rows())
+    {
+      itkExceptionMacro("Signal of model does not match the time grid. Cannot evaluate parameter batch. Signal size: "
+                        << signal.GetSize() << "; time grid size: " << signals.rows());
+    }
+
+    for (unsigned int t = 0; t < signals.rows(); ++t)
+    {
+      signals[t][n] = signal[t];
+    }
+  }
+}
+
 bool mitk::ModelBase::ValidateModel(std::string& /*error*/) const
 {
   return true;
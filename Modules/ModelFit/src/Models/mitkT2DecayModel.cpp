@@ -61,11 +61,31 @@ mitk::T2DecayModel::ComputeModelfunction(const ParametersType& parameters) const
   for (const auto& gridPos : m_TimeGrid)
   {
     *signalPos = parameters[0] * exp(-1.0 * gridPos/ parameters[1]);
+    ++signalPos;
   }
 
   return signal;
 };
 
+void
+mitk::T2DecayModel::ComputeModelfunctions(const BatchParametersType& parameters, BatchSignalsType& signals) const
+{
+  const unsigned int count = parameters.cols();
+  const double* m0 = parameters[0];
+  const double* t2 = parameters[1];
+
+  for (unsigned int i = 0; i < m_TimeGrid.GetSize(); ++i)
+  {
+    const double gridPos = m_TimeGrid[i];
+    double* signal = signals[i];
+
+    for (unsigned int n = 0; n < count; ++n)
+    {
+      signal[n] = m0[n] * exp(-1.0 * gridPos / t2[n]);
+    }
+  }
+};
+
 mitk::T2DecayModel::ParameterNamesType mitk::T2DecayModel::GetStaticParameterNames() const
 {
   ParameterNamesType result;
@@ -13,4 +13,5 @@ SET(MODULE_TESTS
   mitkMVConstrainedCostFunctionDecoratorTest.cpp
   mitkConcreteModelFactoryBaseTest.cpp
   mitkFormulaParserTest.cpp
+  mitkT2DecayModelTest.cpp
 )
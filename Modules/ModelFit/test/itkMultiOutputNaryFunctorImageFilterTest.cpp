@@ -218,5 +218,40 @@ int itkMultiOutputNaryFunctorImageFilterTest(int  /*argc*/, char*[] /*argv[]*/)
   CPPUNIT_ASSERT_MESSAGE("Check pixel of masked output #4 index #4 (functor #2)",0 == out4->GetPixel(testIndex4));
   CPPUNIT_ASSERT_MESSAGE("Check pixel of masked output #4 index #5 (functor #2)",0 == out4->GetPixel(testIndex5));
 
+  //Test that dynamic chunk scheduling (one line per chunk) and static region splitting yield the same results
+  FilterType::Pointer staticFilter = FilterType::New();
+  staticFilter->SetInput(0,img1);
+  staticFilter->SetInput(1,img2);
+  staticFilter->SetInput(2,img3);
+  staticFilter->SetFunctor(funct2);
+  staticFilter->SetMask(mask);
+  staticFilter->SetChunkSize(0);
+  staticFilter->SetNumberOfThreads(2);
+  staticFilter->Update();
+
+  testFilter->SetChunkSize(1);
+  testFilter->SetNumberOfThreads(3);
+  testFilter->Update();
+
+  for (unsigned int i = 0; i < 4; ++i)
+  {
+    itk::ImageRegionConstIterator<mitk::TestImageType> chunkedIt(testFilter->GetOutput(i), testFilter->GetOutput(i)->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<mitk::TestImageType> staticIt(staticFilter->GetOutput(i), staticFilter->GetOutput(i)->GetLargestPossibleRegion());
+
+    bool equal = true;
+    for (; !chunkedIt.IsAtEnd() && !staticIt.IsAtEnd(); ++chunkedIt, ++staticIt)
+    {
+      equal = equal && (chunkedIt.Get() == staticIt.Get());
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("Check chunked output equals statically split output", equal && chunkedIt.IsAtEnd() && staticIt.IsAtEnd());
+  }
+
+  //Test that a single chunk does not permanently lower the thread count of the multi threader
+  const itk::ThreadIdType numberOfThreads = testFilter->GetMultiThreader()->GetNumberOfThreads();
+  testFilter->SetChunkSize(1000);
+  testFilter->Update();
+  CPPUNIT_ASSERT_EQUAL_MESSAGE("Check thread count of the multi threader is restored", numberOfThreads, testFilter->GetMultiThreader()->GetNumberOfThreads());
+
   MITK_TEST_END()
 }
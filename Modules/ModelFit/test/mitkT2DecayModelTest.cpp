@@ -0,0 +1,69 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <cmath>
+#include "mitkTestingMacros.h"
+
+#include "mitkT2DecayModel.h"
+
+int mitkT2DecayModelTest(int  /*argc*/, char*[] /*argv[]*/)
+{
+  MITK_TEST_BEGIN("mitkT2DecayModelTest")
+
+  const unsigned int frames = 12;
+  const unsigned int count = 5;
+
+  mitk::ModelBase::TimeGridType grid(frames);
+  for (unsigned int i = 0; i < frames; ++i)
+  {
+    grid[i] = 10.0 * i;
+  }
+
+  mitk::T2DecayModel::Pointer model = mitk::T2DecayModel::New();
+  model->SetTimeGrid(grid);
+
+  mitk::ModelBase::BatchParametersType parameters(2, count);
+  for (unsigned int n = 0; n < count; ++n)
+  {
+    parameters[0][n] = 100.0 + 20.0 * n;
+    parameters[1][n] = 30.0 + 15.0 * n;
+  }
+
+  mitk::ModelBase::BatchSignalsType signals(frames, count);
+  model->GetSignals(parameters, signals);
+
+  bool singleIsCorrect = true;
+  bool batchIsCorrect = true;
+  mitk::ModelBase::ParametersType parameterSet(2);
+  for (unsigned int n = 0; n < count; ++n)
+  {
+    parameterSet[0] = parameters[0][n];
+    parameterSet[1] = parameters[1][n];
+    const mitk::ModelBase::ModelResultType signal = model->GetSignal(parameterSet);
+
+    for (unsigned int i = 0; i < frames; ++i)
+    {
+      const double expected = parameterSet[0] * std::exp(-grid[i] / parameterSet[1]);
+      singleIsCorrect = singleIsCorrect && std::abs(signal[i] - expected) < 1e-10;
+      batchIsCorrect = batchIsCorrect && std::abs(signals[i][n] - expected) < 1e-10;
+    }
+  }
+
+  MITK_TEST_CONDITION(singleIsCorrect, "Testing if the signal is computed for every time point.");
+  MITK_TEST_CONDITION(batchIsCorrect, "Testing if the batched signals equal the single signals.");
+
+  MITK_TEST_END()
+}
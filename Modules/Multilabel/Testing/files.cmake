@@ -4,5 +4,8 @@ set(MODULE_TESTS
     mitkLabelSetImageTest.cpp
     mitkLabelSetImageIOTest.cpp
     mitkLabelSetImageSurfaceStampFilterTest.cpp
+    mitkRunLengthEncodedLabelLayerTest.cpp
+    mitkLabelIndexTest.cpp
+    mitkLabelSetImageToSurfaceFilterTest.cpp
 )
 
@@ -0,0 +1,185 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkLabelIndex.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <vector>
+
+class mitkLabelIndexTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLabelIndexTestSuite);
+  MITK_TEST(TestBuild);
+  MITK_TEST(TestReplaceVoxel);
+  MITK_TEST(TestTightenBoundingBox);
+  MITK_TEST(TestMergeLabel);
+  MITK_TEST(TestEraseLabel);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::LabelIndex::PixelType PixelType;
+  typedef mitk::LabelIndex::IndexType IndexType;
+
+  static const unsigned int Size = 10;
+
+  unsigned int m_Dimensions[4];
+  std::vector<PixelType> m_Buffer;
+  mitk::LabelIndex m_Index;
+
+  static IndexType GetIndex(unsigned int x, unsigned int y, unsigned int z)
+  {
+    IndexType index;
+    index[0] = x;
+    index[1] = y;
+    index[2] = z;
+    index[3] = 0;
+    return index;
+  }
+
+  PixelType &At(unsigned int x, unsigned int y, unsigned int z) { return m_Buffer[x + Size * (y + Size * z)]; }
+
+  /** Changes a voxel of the buffer and the index alike */
+  void SetVoxel(unsigned int x, unsigned int y, unsigned int z, PixelType value)
+  {
+    m_Index.ReplaceVoxel(GetIndex(x, y, z), this->At(x, y, z), value);
+    this->At(x, y, z) = value;
+  }
+
+  void AssertBoundingBox(PixelType pixelValue, const IndexType &minimumIndex, const IndexType &maximumIndex)
+  {
+    const mitk::LabelIndex::LabelStatistics *statistics = m_Index.GetStatistics(pixelValue);
+    CPPUNIT_ASSERT(nullptr != statistics);
+    CPPUNIT_ASSERT_EQUAL(minimumIndex, statistics->m_MinimumIndex);
+    CPPUNIT_ASSERT_EQUAL(maximumIndex, statistics->m_MaximumIndex);
+  }
+
+public:
+  void setUp() override
+  {
+    m_Dimensions[0] = m_Dimensions[1] = m_Dimensions[2] = Size;
+    m_Dimensions[3] = 1;
+
+    // label 1: box [1,3]^3, label 2: box [5,8] x [2,4] x [6,7]
+    m_Buffer.assign(Size * Size * Size, 0);
+    for (unsigned int z = 0; z < Size; ++z)
+    {
+      for (unsigned int y = 0; y < Size; ++y)
+      {
+        for (unsigned int x = 0; x < Size; ++x)
+        {
+          if (x >= 1 && x <= 3 && y >= 1 && y <= 3 && z >= 1 && z <= 3)
+            this->At(x, y, z) = 1;
+          else if (x >= 5 && x <= 8 && y >= 2 && y <= 4 && z >= 6 && z <= 7)
+            this->At(x, y, z) = 2;
+        }
+      }
+    }
+
+    m_Index.Build(m_Buffer.data(), m_Dimensions);
+  }
+
+  void tearDown() override { m_Index.Clear(); }
+
+  void TestBuild()
+  {
+    const mitk::LabelIndex::LabelStatistics *statistics = m_Index.GetStatistics(1);
+    CPPUNIT_ASSERT(nullptr != statistics);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(27), statistics->m_NumberOfVoxels);
+    CPPUNIT_ASSERT(!statistics->m_LooseBoundingBox);
+    this->AssertBoundingBox(1, GetIndex(1, 1, 1), GetIndex(3, 3, 3));
+
+    mitk::Point3D centroid = statistics->GetCentroidIndex();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, centroid[0], mitk::eps);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, centroid[2], mitk::eps);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(24), m_Index.GetStatistics(2)->m_NumberOfVoxels);
+    this->AssertBoundingBox(2, GetIndex(5, 2, 6), GetIndex(8, 4, 7));
+
+    CPPUNIT_ASSERT(nullptr == m_Index.GetStatistics(0));
+    CPPUNIT_ASSERT(nullptr == m_Index.GetStatistics(3));
+  }
+
+  void TestReplaceVoxel()
+  {
+    this->SetVoxel(9, 0, 0, 1);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(28), m_Index.GetStatistics(1)->m_NumberOfVoxels);
+    this->AssertBoundingBox(1, GetIndex(1, 0, 0), GetIndex(9, 3, 3));
+
+    // removing an inner voxel keeps the bounding box tight
+    this->SetVoxel(2, 2, 2, 3);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(27), m_Index.GetStatistics(1)->m_NumberOfVoxels);
+    CPPUNIT_ASSERT(!m_Index.GetStatistics(1)->m_LooseBoundingBox);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), m_Index.GetStatistics(3)->m_NumberOfVoxels);
+    this->AssertBoundingBox(3, GetIndex(2, 2, 2), GetIndex(2, 2, 2));
+
+    // removing the only voxel removes the label
+    this->SetVoxel(2, 2, 2, 1);
+    CPPUNIT_ASSERT(nullptr == m_Index.GetStatistics(3));
+
+    // replacing a voxel by the same value changes nothing
+    this->SetVoxel(2, 2, 2, 1);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(28), m_Index.GetStatistics(1)->m_NumberOfVoxels);
+  }
+
+  void TestTightenBoundingBox()
+  {
+    // removing a voxel on the border leaves a loose, but still enclosing bounding box
+    for (unsigned int y = 1; y <= 3; ++y)
+    {
+      for (unsigned int x = 1; x <= 3; ++x)
+        this->SetVoxel(x, y, 3, 0);
+    }
+
+    const mitk::LabelIndex::LabelStatistics *statistics = m_Index.GetStatistics(1);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(18), statistics->m_NumberOfVoxels);
+    CPPUNIT_ASSERT(statistics->m_LooseBoundingBox);
+    this->AssertBoundingBox(1, GetIndex(1, 1, 1), GetIndex(3, 3, 3));
+
+    m_Index.TightenBoundingBox(1, m_Buffer.data(), m_Dimensions);
+    CPPUNIT_ASSERT(!statistics->m_LooseBoundingBox);
+    this->AssertBoundingBox(1, GetIndex(1, 1, 1), GetIndex(3, 3, 2));
+
+    mitk::Point3D centroid = statistics->GetCentroidIndex();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.5, centroid[2], mitk::eps);
+  }
+
+  void TestMergeLabel()
+  {
+    m_Index.MergeLabel(1, 2);
+    CPPUNIT_ASSERT(nullptr == m_Index.GetStatistics(2));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(27 + 24), m_Index.GetStatistics(1)->m_NumberOfVoxels);
+    this->AssertBoundingBox(1, GetIndex(1, 1, 1), GetIndex(8, 4, 7));
+
+    // merging into a label without voxels moves the statistics
+    m_Index.MergeLabel(4, 1);
+    CPPUNIT_ASSERT(nullptr == m_Index.GetStatistics(1));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(27 + 24), m_Index.GetStatistics(4)->m_NumberOfVoxels);
+
+    // merging into the background erases the label
+    m_Index.MergeLabel(0, 4);
+    CPPUNIT_ASSERT(nullptr == m_Index.GetStatistics(4));
+  }
+
+  void TestEraseLabel()
+  {
+    m_Index.EraseLabel(2);
+    CPPUNIT_ASSERT(nullptr == m_Index.GetStatistics(2));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(27), m_Index.GetStatistics(1)->m_NumberOfVoxels);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLabelIndex)
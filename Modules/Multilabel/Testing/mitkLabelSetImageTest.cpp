@@ -14,7 +14,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 ===================================================================*/
 
+#include <mitkExtractSliceFilter.h>
 #include <mitkIOUtil.h>
+#include <mitkImagePixelReadAccessor.h>
+#include <mitkImagePixelWriteAccessor.h>
 #include <mitkImageStatisticsHolder.h>
 #include <mitkLabelSetImage.h>
 #include <mitkTestFixture.h>
@@ -38,6 +41,10 @@ class mitkLabelSetImageTestSuite : public mitk::TestFixture
   MITK_TEST(TestRemoveLayer);
   MITK_TEST(TestRemoveLabels);
   MITK_TEST(TestMergeLabel);
+  MITK_TEST(TestSparseLayerStorage);
+  MITK_TEST(TestSparseLayerCenterOfMass4D);
+  MITK_TEST(TestSparseLayerImageKeptWhileReferenced);
+  MITK_TEST(TestLabelIndex);
   // TODO check it these functionalities can be moved into a process object
   //  MITK_TEST(TestMergeLabels);
   //  MITK_TEST(TestConcatenate);
@@ -443,6 +450,270 @@ public:
     // Check if merge label has 507 + 823 = 1330 pixels
     CPPUNIT_ASSERT_MESSAGE("Label with value 7 was not remove from the image", m_LabelSetImage->GetStatistics()->GetCountOfMaxValuedVoxels() == 1330);
   }
+
+  void TestSparseLayerStorage()
+  {
+    mitk::Image::Pointer regularImage = mitk::Image::New();
+    unsigned int dimensions[3] = {32, 32, 16};
+    regularImage->Initialize(mitk::MakeScalarPixelType<int>(), 3, dimensions);
+    m_LabelSetImage = mitk::LabelSetImage::New();
+    m_LabelSetImage->Initialize(regularImage);
+
+    mitk::Label::Pointer label1 = mitk::Label::New();
+    label1->SetValue(1);
+    mitk::Label::Pointer label2 = mitk::Label::New();
+    label2->SetValue(2);
+    m_LabelSetImage->GetActiveLabelSet()->AddLabel(label1);
+    m_LabelSetImage->GetActiveLabelSet()->AddLabel(label2);
+
+    // label 1 in the lower, label 2 in the upper half of slice 5
+    itk::Index<3> index;
+    index[2] = 5;
+    {
+      mitk::ImagePixelWriteAccessor<mitk::Label::PixelType, 3> accessor(m_LabelSetImage);
+      for (index[1] = 0; index[1] < 32; ++index[1])
+        for (index[0] = 4; index[0] < 12; ++index[0])
+          accessor.SetPixelByIndex(index, index[1] < 16 ? 1 : 2);
+    }
+
+    m_LabelSetImage->SetSparseLayerStorage(true);
+    m_LabelSetImage->AddLayer();
+    CPPUNIT_ASSERT_MESSAGE("Inactive layer is not run-length encoded", m_LabelSetImage->IsLayerSparse(0));
+    CPPUNIT_ASSERT_MESSAGE("Active layer is run-length encoded", !m_LabelSetImage->IsLayerSparse(1));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(8 * 16), m_LabelSetImage->GetSparseLayer(0)->GetNumberOfVoxels(1));
+
+    // the slice is decoded with the geometry of the layer
+    mitk::Image::Pointer slice = m_LabelSetImage->GetSparseLayerSlice(0, 2, 5, 0);
+    CPPUNIT_ASSERT_MESSAGE("Slice of the sparse layer is not decoded", slice.IsNotNull());
+    CPPUNIT_ASSERT_MESSAGE("Wrong size of the slice", 32 == slice->GetDimension(0) && 32 == slice->GetDimension(1));
+    mitk::Point3D sliceOrigin;
+    mitk::Point3D layerOrigin;
+    mitk::Point3D sliceIndex;
+    sliceIndex.Fill(0.0);
+    slice->GetGeometry()->IndexToWorld(sliceIndex, sliceOrigin);
+    sliceIndex[2] = 5;
+    m_LabelSetImage->GetGeometry()->IndexToWorld(sliceIndex, layerOrigin);
+    CPPUNIT_ASSERT_MESSAGE("Slice is not located at the slice of the layer", mitk::Equal(sliceOrigin, layerOrigin));
+    {
+      // a single axial slice is a 2D image
+      mitk::ImagePixelReadAccessor<mitk::Label::PixelType, 2> accessor(slice);
+      itk::Index<2> sliceVoxel;
+      sliceVoxel[0] = 4;
+      sliceVoxel[1] = 20;
+      CPPUNIT_ASSERT_EQUAL(mitk::Label::PixelType(2), accessor.GetPixelByIndex(sliceVoxel));
+    }
+    CPPUNIT_ASSERT_MESSAGE("Slice of a layer kept as image",
+                           m_LabelSetImage->GetSparseLayerSlice(1, 2, 5, 0).IsNull());
+
+    // label operations work on the run-length encoded layer
+    m_LabelSetImage->MergeLabel(1, 2, 0);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(8 * 32), m_LabelSetImage->GetSparseLayer(0)->GetNumberOfVoxels(1));
+    m_LabelSetImage->UpdateCenterOfMass(1, 0);
+    mitk::Point3D centerOfMass = m_LabelSetImage->GetLabel(1, 0)->GetCenterOfMassIndex();
+    CPPUNIT_ASSERT_MESSAGE("Wrong center of mass", mitk::Equal(centerOfMass[1], 16.0) && mitk::Equal(centerOfMass[2], 5.0));
+
+    // switching back restores the image data of the layer
+    m_LabelSetImage->SetActiveLayer(0);
+    CPPUNIT_ASSERT_MESSAGE("Active layer is run-length encoded", !m_LabelSetImage->IsLayerSparse(0));
+    CPPUNIT_ASSERT_MESSAGE("Inactive layer is not run-length encoded", m_LabelSetImage->IsLayerSparse(1));
+    {
+      mitk::ImagePixelReadAccessor<mitk::Label::PixelType, 3> accessor(m_LabelSetImage);
+      index[0] = 4;
+      index[1] = 20;
+      CPPUNIT_ASSERT_EQUAL(mitk::Label::PixelType(1), accessor.GetPixelByIndex(index));
+      index[0] = 12;
+      CPPUNIT_ASSERT_EQUAL(mitk::Label::PixelType(0), accessor.GetPixelByIndex(index));
+    }
+
+    // clones and dense storage keep the layer data
+    mitk::LabelSetImage::Pointer clone = m_LabelSetImage->Clone();
+    m_LabelSetImage->SetSparseLayerStorage(false);
+    CPPUNIT_ASSERT_MESSAGE("Layer is run-length encoded without sparse layer storage",
+                           !m_LabelSetImage->IsLayerSparse(1));
+    CPPUNIT_ASSERT_MESSAGE("Clone differs", mitk::Equal(*clone, *m_LabelSetImage, mitk::eps, true));
+  }
+
+  void TestSparseLayerCenterOfMass4D()
+  {
+    mitk::Image::Pointer regularImage = mitk::Image::New();
+    unsigned int dimensions[4] = {16, 16, 8, 3};
+    regularImage->Initialize(mitk::MakeScalarPixelType<int>(), 4, dimensions);
+    m_LabelSetImage = mitk::LabelSetImage::New();
+    m_LabelSetImage->Initialize(regularImage);
+
+    mitk::Label::Pointer label = mitk::Label::New();
+    label->SetValue(1);
+    m_LabelSetImage->GetActiveLabelSet()->AddLabel(label);
+
+    // the label only exists in slice 3 of the last time step
+    itk::Index<4> index;
+    index[2] = 3;
+    index[3] = 2;
+    {
+      mitk::ImagePixelWriteAccessor<mitk::Label::PixelType, 4> accessor(m_LabelSetImage);
+      for (index[1] = 0; index[1] < 16; ++index[1])
+        for (index[0] = 4; index[0] < 12; ++index[0])
+          accessor.SetPixelByIndex(index, 1);
+    }
+
+    mitk::Point3D expectedIndex;
+    expectedIndex[0] = 4;
+    expectedIndex[1] = 8;
+    expectedIndex[2] = 3;
+    mitk::Point3D expectedCoordinates;
+    m_LabelSetImage->GetSlicedGeometry(2)->IndexToWorld(expectedIndex, expectedCoordinates);
+
+    m_LabelSetImage->SetSparseLayerStorage(true);
+    m_LabelSetImage->AddLayer();
+    CPPUNIT_ASSERT_MESSAGE("Inactive layer is not run-length encoded", m_LabelSetImage->IsLayerSparse(0));
+
+    m_LabelSetImage->UpdateCenterOfMass(1, 0);
+    CPPUNIT_ASSERT_MESSAGE("Wrong center of mass of the run-length encoded layer",
+                           mitk::Equal(expectedIndex, m_LabelSetImage->GetLabel(1, 0)->GetCenterOfMassIndex()));
+    CPPUNIT_ASSERT_MESSAGE("Wrong center of mass coordinates of the run-length encoded layer",
+                           mitk::Equal(expectedCoordinates, m_LabelSetImage->GetLabel(1, 0)->GetCenterOfMassCoordinates()));
+
+    // the image data of the active layer yields the same center
+    mitk::Point3D resetIndex;
+    resetIndex.Fill(-1.0);
+    m_LabelSetImage->GetLabel(1, 0)->SetCenterOfMassIndex(resetIndex);
+    m_LabelSetImage->SetActiveLayer(0);
+    m_LabelSetImage->UpdateCenterOfMass(1, 0);
+    CPPUNIT_ASSERT_MESSAGE("Wrong center of mass of the active layer",
+                           mitk::Equal(expectedIndex, m_LabelSetImage->GetLabel(1, 0)->GetCenterOfMassIndex()));
+    CPPUNIT_ASSERT_MESSAGE("Wrong center of mass coordinates of the active layer",
+                           mitk::Equal(expectedCoordinates, m_LabelSetImage->GetLabel(1, 0)->GetCenterOfMassCoordinates()));
+  }
+
+  void TestSparseLayerImageKeptWhileReferenced()
+  {
+    mitk::Image::Pointer regularImage = mitk::Image::New();
+    unsigned int dimensions[3] = {16, 16, 4};
+    regularImage->Initialize(mitk::MakeScalarPixelType<int>(), 3, dimensions);
+    m_LabelSetImage = mitk::LabelSetImage::New();
+    m_LabelSetImage->Initialize(regularImage);
+
+    m_LabelSetImage->SetSparseLayerStorage(true);
+    m_LabelSetImage->AddLayer();
+    m_LabelSetImage->AddLayer();
+    CPPUNIT_ASSERT_MESSAGE("Inactive layer is not run-length encoded", m_LabelSetImage->IsLayerSparse(0));
+
+    // the image of layer 0 is edited after the next layer change
+    mitk::Image::Pointer layerImage = m_LabelSetImage->GetLayerImage(0);
+    m_LabelSetImage->SetActiveLayer(1);
+    CPPUNIT_ASSERT_MESSAGE("Referenced layer image has been encoded", !m_LabelSetImage->IsLayerSparse(0));
+    CPPUNIT_ASSERT_MESSAGE("Inactive layer is not run-length encoded", m_LabelSetImage->IsLayerSparse(2));
+
+    itk::Index<3> index;
+    index[0] = 3;
+    index[1] = 7;
+    index[2] = 2;
+    {
+      mitk::ImagePixelWriteAccessor<mitk::Label::PixelType, 3> accessor(layerImage);
+      accessor.SetPixelByIndex(index, 1);
+    }
+
+    // the released image is encoded by the next layer change
+    layerImage = nullptr;
+    m_LabelSetImage->SetActiveLayer(2);
+    CPPUNIT_ASSERT_MESSAGE("Released layer image is not encoded", m_LabelSetImage->IsLayerSparse(0));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), m_LabelSetImage->GetSparseLayer(0)->GetNumberOfVoxels(1));
+
+    m_LabelSetImage->SetActiveLayer(0);
+    {
+      mitk::ImagePixelReadAccessor<mitk::Label::PixelType, 3> accessor(m_LabelSetImage);
+      CPPUNIT_ASSERT_EQUAL(mitk::Label::PixelType(1), accessor.GetPixelByIndex(index));
+    }
+  }
+
+  void TestLabelIndex()
+  {
+    mitk::Image::Pointer regularImage = mitk::Image::New();
+    unsigned int dimensions[3] = {32, 32, 16};
+    regularImage->Initialize(mitk::MakeScalarPixelType<int>(), 3, dimensions);
+    m_LabelSetImage = mitk::LabelSetImage::New();
+    m_LabelSetImage->Initialize(regularImage);
+
+    mitk::Vector3D spacing;
+    spacing[0] = 0.5;
+    spacing[1] = 0.5;
+    spacing[2] = 2.0;
+    m_LabelSetImage->SetSpacing(spacing);
+
+    mitk::Label::Pointer label1 = mitk::Label::New();
+    label1->SetValue(1);
+    mitk::Label::Pointer label2 = mitk::Label::New();
+    label2->SetValue(2);
+    m_LabelSetImage->GetActiveLabelSet()->AddLabel(label1);
+    m_LabelSetImage->GetActiveLabelSet()->AddLabel(label2);
+
+    // label 1 in the lower, label 2 in the upper half of slices 5 and 6
+    itk::Index<3> index;
+    {
+      mitk::ImagePixelWriteAccessor<mitk::Label::PixelType, 3> accessor(m_LabelSetImage);
+      for (index[2] = 5; index[2] < 7; ++index[2])
+        for (index[1] = 0; index[1] < 32; ++index[1])
+          for (index[0] = 4; index[0] < 12; ++index[0])
+            accessor.SetPixelByIndex(index, index[1] < 16 ? 1 : 2);
+    }
+    m_LabelSetImage->Modified();
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2 * 8 * 16), m_LabelSetImage->GetNumberOfVoxels(1));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), m_LabelSetImage->GetNumberOfVoxels(3));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2 * 8 * 16 * 0.5, m_LabelSetImage->GetLabelVolume(1), mitk::eps);
+
+    mitk::LabelIndex::IndexType minimumIndex;
+    mitk::LabelIndex::IndexType maximumIndex;
+    CPPUNIT_ASSERT(m_LabelSetImage->GetLabelBoundingBox(2, minimumIndex, maximumIndex));
+    CPPUNIT_ASSERT_EQUAL(itk::IndexValueType(4), minimumIndex[0]);
+    CPPUNIT_ASSERT_EQUAL(itk::IndexValueType(16), minimumIndex[1]);
+    CPPUNIT_ASSERT_EQUAL(itk::IndexValueType(11), maximumIndex[0]);
+    CPPUNIT_ASSERT_EQUAL(itk::IndexValueType(6), maximumIndex[2]);
+    CPPUNIT_ASSERT(!m_LabelSetImage->GetLabelBoundingBox(3, minimumIndex, maximumIndex));
+
+    // overwrite slice 6 like a segmentation tool: label 2 becomes label 1, the slice is reported afterwards
+    mitk::PlaneGeometry::Pointer plane = mitk::PlaneGeometry::New();
+    plane->InitializeStandardPlane(m_LabelSetImage->GetGeometry(), mitk::PlaneGeometry::Axial, 6);
+    mitk::ExtractSliceFilter::Pointer extractor = mitk::ExtractSliceFilter::New();
+    extractor->SetInput(m_LabelSetImage);
+    extractor->SetWorldGeometry(plane);
+    extractor->Update();
+    mitk::Image::Pointer previousSlice = extractor->GetOutput();
+    previousSlice->DisconnectPipeline();
+
+    {
+      mitk::ImagePixelWriteAccessor<mitk::Label::PixelType, 3> accessor(m_LabelSetImage);
+      index[2] = 6;
+      for (index[1] = 16; index[1] < 32; ++index[1])
+        for (index[0] = 4; index[0] < 12; ++index[0])
+          accessor.SetPixelByIndex(index, 1);
+    }
+    m_LabelSetImage->UpdateLabelIndex(previousSlice, 0);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3 * 8 * 16), m_LabelSetImage->GetNumberOfVoxels(1));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(8 * 16), m_LabelSetImage->GetNumberOfVoxels(2));
+    CPPUNIT_ASSERT(m_LabelSetImage->GetLabelBoundingBox(2, minimumIndex, maximumIndex));
+    CPPUNIT_ASSERT_EQUAL(itk::IndexValueType(5), maximumIndex[2]);
+
+    // label operations keep the index up to date and only visit the bounding box of the label
+    m_LabelSetImage->MergeLabel(1, 2);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4 * 8 * 16), m_LabelSetImage->GetNumberOfVoxels(1));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), m_LabelSetImage->GetNumberOfVoxels(2));
+
+    m_LabelSetImage->UpdateCenterOfMass(1);
+    mitk::Point3D centerOfMass = m_LabelSetImage->GetLabel(1)->GetCenterOfMassIndex();
+    CPPUNIT_ASSERT_MESSAGE("Wrong center of mass", mitk::Equal(centerOfMass[1], 0.0) && mitk::Equal(centerOfMass[2], 6.0));
+
+    m_LabelSetImage->EraseLabel(1);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), m_LabelSetImage->GetNumberOfVoxels(1));
+    {
+      mitk::ImagePixelReadAccessor<mitk::Label::PixelType, 3> accessor(m_LabelSetImage);
+      index[0] = 4;
+      index[1] = 20;
+      index[2] = 5;
+      CPPUNIT_ASSERT_EQUAL(mitk::Label::PixelType(0), accessor.GetPixelByIndex(index));
+    }
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkLabelSetImage)
@@ -0,0 +1,163 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkImagePixelWriteAccessor.h>
+#include <mitkLabelSetImage.h>
+#include <mitkLabelSetImageToSurfaceFilter.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <vtkPolyData.h>
+
+#include <set>
+
+class mitkLabelSetImageToSurfaceFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLabelSetImageToSurfaceFilterTestSuite);
+  MITK_TEST(TestAllLabels);
+  MITK_TEST(TestResultDoesNotDependOnNumberOfThreads);
+  MITK_TEST(TestRequestedLabel);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::LabelSetImageToSurfaceFilter::LabelType LabelType;
+
+  mitk::LabelSetImage::Pointer m_LabelSetImage;
+  std::set<LabelType> m_GeneratedLabels;
+
+  /** Fills the cube [begin, end)^3 with a label */
+  void PaintCube(LabelType pixelValue, int begin, int end)
+  {
+    mitk::ImagePixelWriteAccessor<mitk::Label::PixelType, 3> accessor(m_LabelSetImage);
+    itk::Index<3> index;
+    for (index[2] = begin; index[2] < end; ++index[2])
+      for (index[1] = begin; index[1] < end; ++index[1])
+        for (index[0] = begin; index[0] < end; ++index[0])
+          accessor.SetPixelByIndex(index, pixelValue);
+  }
+
+  void OnLabelSurfaceGenerated(LabelType label, mitk::Surface *surface)
+  {
+    CPPUNIT_ASSERT(nullptr != surface);
+    m_GeneratedLabels.insert(label);
+  }
+
+  mitk::LabelSetImageToSurfaceFilter::Pointer CreateFilter(unsigned int numberOfThreads)
+  {
+    mitk::LabelSetImageToSurfaceFilter::Pointer filter = mitk::LabelSetImageToSurfaceFilter::New();
+    filter->SetInput(m_LabelSetImage);
+    filter->SetGenerateAllLabels(true);
+    filter->SetNumberOfThreads(numberOfThreads);
+    return filter;
+  }
+
+public:
+  void setUp() override
+  {
+    mitk::Image::Pointer regularImage = mitk::Image::New();
+    unsigned int dimensions[3] = {40, 40, 40};
+    regularImage->Initialize(mitk::MakeScalarPixelType<int>(), 3, dimensions);
+    m_LabelSetImage = mitk::LabelSetImage::New();
+    m_LabelSetImage->Initialize(regularImage);
+
+    for (LabelType pixelValue = 1; pixelValue <= 3; ++pixelValue)
+    {
+      mitk::Label::Pointer label = mitk::Label::New();
+      label->SetValue(pixelValue);
+      m_LabelSetImage->GetActiveLabelSet()->AddLabel(label);
+    }
+
+    this->PaintCube(1, 5, 15);
+    this->PaintCube(2, 20, 30);
+    this->PaintCube(3, 33, 37);
+    m_LabelSetImage->Modified();
+
+    m_GeneratedLabels.clear();
+  }
+
+  void tearDown() override { m_LabelSetImage = nullptr; }
+
+  void TestAllLabels()
+  {
+    mitk::LabelSetImageToSurfaceFilter::Pointer filter = this->CreateFilter(4);
+    filter->LabelSurfaceGeneratedEvent +=
+      mitk::MessageDelegate2<mitkLabelSetImageToSurfaceFilterTestSuite, LabelType, mitk::Surface *>(
+        this, &mitkLabelSetImageToSurfaceFilterTestSuite::OnLabelSurfaceGenerated);
+    filter->Update();
+
+    CPPUNIT_ASSERT_EQUAL(3u, static_cast<unsigned int>(filter->GetNumberOfOutputs()));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), m_GeneratedLabels.size());
+
+    std::set<LabelType> labels;
+    for (unsigned int i = 0; i < filter->GetNumberOfOutputs(); ++i)
+    {
+      const LabelType label = filter->GetLabelForNthOutput(i);
+      labels.insert(label);
+
+      vtkPolyData *polydata = filter->GetOutput(i)->GetVtkPolyData();
+      CPPUNIT_ASSERT_MESSAGE("Surface of a label is empty", nullptr != polydata && polydata->GetNumberOfPoints() > 0);
+
+      if (1 == label)
+      {
+        // the surface stays close to the cube of label 1
+        double bounds[6];
+        polydata->GetBounds(bounds);
+        for (unsigned int dim = 0; dim < 3; ++dim)
+        {
+          CPPUNIT_ASSERT(bounds[2 * dim] > 2.0 && bounds[2 * dim] < 6.0);
+          CPPUNIT_ASSERT(bounds[2 * dim + 1] > 13.0 && bounds[2 * dim + 1] < 17.0);
+        }
+      }
+    }
+
+    CPPUNIT_ASSERT(labels == m_GeneratedLabels);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), labels.count(3));
+  }
+
+  void TestResultDoesNotDependOnNumberOfThreads()
+  {
+    mitk::LabelSetImageToSurfaceFilter::Pointer singleThreadedFilter = this->CreateFilter(1);
+    singleThreadedFilter->Update();
+    mitk::LabelSetImageToSurfaceFilter::Pointer filter = this->CreateFilter(3);
+    filter->Update();
+
+    CPPUNIT_ASSERT_EQUAL(singleThreadedFilter->GetNumberOfOutputs(), filter->GetNumberOfOutputs());
+    for (unsigned int i = 0; i < filter->GetNumberOfOutputs(); ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL(singleThreadedFilter->GetLabelForNthOutput(i), filter->GetLabelForNthOutput(i));
+      CPPUNIT_ASSERT_EQUAL(singleThreadedFilter->GetOutput(i)->GetVtkPolyData()->GetNumberOfPoints(),
+                           filter->GetOutput(i)->GetVtkPolyData()->GetNumberOfPoints());
+    }
+  }
+
+  void TestRequestedLabel()
+  {
+    mitk::LabelSetImageToSurfaceFilter::Pointer filter = this->CreateFilter(4);
+    filter->SetGenerateAllLabels(false);
+    filter->SetRequestedLabel(2);
+    filter->Update();
+
+    CPPUNIT_ASSERT_EQUAL(1u, static_cast<unsigned int>(filter->GetNumberOfOutputs()));
+    CPPUNIT_ASSERT_EQUAL(LabelType(2), filter->GetLabelForNthOutput(0));
+    CPPUNIT_ASSERT(filter->GetOutput()->GetVtkPolyData()->GetNumberOfPoints() > 0);
+
+    // a label without voxels can not be extracted
+    filter->SetRequestedLabel(4);
+    CPPUNIT_ASSERT_THROW(filter->Update(), itk::ExceptionObject);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLabelSetImageToSurfaceFilter)
@@ -0,0 +1,226 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkImagePixelReadAccessor.h>
+#include <mitkImagePixelWriteAccessor.h>
+#include <mitkRunLengthEncodedLabelLayer.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+class mitkRunLengthEncodedLabelLayerTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkRunLengthEncodedLabelLayerTestSuite);
+  MITK_TEST(TestEncodeDecode);
+  MITK_TEST(TestDecodeSlice);
+  MITK_TEST(TestNumberOfVoxels);
+  MITK_TEST(TestMergeLabel);
+  MITK_TEST(TestEraseLabel);
+  MITK_TEST(TestGetCenterVoxelIndex);
+  MITK_TEST(TestEncodeWrongPixelType);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::RunLengthEncodedLabelLayer::PixelType PixelType;
+
+  mitk::Image::Pointer m_Image;
+  mitk::RunLengthEncodedLabelLayer::Pointer m_Layer;
+
+  static const unsigned int Size = 20;
+
+  /** Label 1: box [2,9]^3, label 2: box [12,17]^3, label 3: the voxels of label 1 with x == 5 */
+  static PixelType GetExpectedValue(unsigned int x, unsigned int y, unsigned int z)
+  {
+    if (x >= 2 && x <= 9 && y >= 2 && y <= 9 && z >= 2 && z <= 9)
+      return 5 == x ? 3 : 1;
+
+    if (x >= 12 && x <= 17 && y >= 12 && y <= 17 && z >= 12 && z <= 17)
+      return 2;
+
+    return 0;
+  }
+
+  static itk::Index<3> GetIndex(unsigned int x, unsigned int y, unsigned int z)
+  {
+    itk::Index<3> index;
+    index[0] = x;
+    index[1] = y;
+    index[2] = z;
+    return index;
+  }
+
+  mitk::Image::Pointer CreateImage()
+  {
+    mitk::Image::Pointer image = mitk::Image::New();
+    unsigned int dimensions[3] = {Size, Size, Size};
+    image->Initialize(mitk::MakeScalarPixelType<PixelType>(), 3, dimensions);
+    return image;
+  }
+
+  bool DecodedImageIsCorrect(mitk::Image *image,
+                             PixelType (*expectedValue)(unsigned int x, unsigned int y, unsigned int z))
+  {
+    mitk::ImagePixelReadAccessor<PixelType, 3> accessor(image);
+    for (unsigned int z = 0; z < Size; ++z)
+    {
+      for (unsigned int y = 0; y < Size; ++y)
+      {
+        for (unsigned int x = 0; x < Size; ++x)
+        {
+          if (accessor.GetPixelByIndex(GetIndex(x, y, z)) != expectedValue(x, y, z))
+            return false;
+        }
+      }
+    }
+    return true;
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = this->CreateImage();
+    {
+      mitk::ImagePixelWriteAccessor<PixelType, 3> accessor(m_Image);
+      for (unsigned int z = 0; z < Size; ++z)
+      {
+        for (unsigned int y = 0; y < Size; ++y)
+        {
+          for (unsigned int x = 0; x < Size; ++x)
+          {
+            accessor.SetPixelByIndex(GetIndex(x, y, z), GetExpectedValue(x, y, z));
+          }
+        }
+      }
+    }
+
+    m_Layer = mitk::RunLengthEncodedLabelLayer::New();
+    m_Layer->Encode(m_Image);
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+    m_Layer = nullptr;
+  }
+
+  void TestEncodeDecode()
+  {
+    CPPUNIT_ASSERT_EQUAL(20u, m_Layer->GetDimensions()[0]);
+    CPPUNIT_ASSERT_EQUAL(20u, m_Layer->GetDimensions()[2]);
+    CPPUNIT_ASSERT_EQUAL(1u, m_Layer->GetDimensions()[3]);
+
+    mitk::Image::Pointer decoded = this->CreateImage();
+    m_Layer->Decode(decoded);
+    MITK_ASSERT_EQUAL(m_Image, decoded, "Decoded image differs from the encoded one");
+
+    mitk::RunLengthEncodedLabelLayer::IndexType index = {{5, 4, 3, 0}};
+    CPPUNIT_ASSERT_EQUAL(PixelType(3), m_Layer->GetValue(index));
+    index[0] = 10;
+    CPPUNIT_ASSERT_EQUAL(PixelType(0), m_Layer->GetValue(index));
+
+    CPPUNIT_ASSERT_MESSAGE("Layer needs less memory than the image",
+                           m_Layer->GetMemorySize() < Size * Size * Size * sizeof(PixelType));
+  }
+
+  void TestDecodeSlice()
+  {
+    std::vector<PixelType> slice(Size * Size);
+
+    m_Layer->DecodeSlice(2, 4, 0, slice.data());
+    for (unsigned int y = 0; y < Size; ++y)
+      for (unsigned int x = 0; x < Size; ++x)
+        CPPUNIT_ASSERT_EQUAL(GetExpectedValue(x, y, 4), slice[y * Size + x]);
+
+    m_Layer->DecodeSlice(1, 13, 0, slice.data());
+    for (unsigned int z = 0; z < Size; ++z)
+      for (unsigned int x = 0; x < Size; ++x)
+        CPPUNIT_ASSERT_EQUAL(GetExpectedValue(x, 13, z), slice[z * Size + x]);
+
+    m_Layer->DecodeSlice(0, 5, 0, slice.data());
+    for (unsigned int z = 0; z < Size; ++z)
+      for (unsigned int y = 0; y < Size; ++y)
+        CPPUNIT_ASSERT_EQUAL(GetExpectedValue(5, y, z), slice[z * Size + y]);
+
+    CPPUNIT_ASSERT_THROW(m_Layer->DecodeSlice(2, Size, 0, slice.data()), mitk::Exception);
+    CPPUNIT_ASSERT_THROW(m_Layer->DecodeSlice(2, 0, 1, slice.data()), mitk::Exception);
+  }
+
+  void TestNumberOfVoxels()
+  {
+    CPPUNIT_ASSERT_EQUAL(std::size_t(7 * 8 * 8), m_Layer->GetNumberOfVoxels(1));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(6 * 6 * 6), m_Layer->GetNumberOfVoxels(2));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(8 * 8), m_Layer->GetNumberOfVoxels(3));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(Size * Size * Size - 8 * 8 * 8 - 6 * 6 * 6), m_Layer->GetNumberOfVoxels(0));
+    CPPUNIT_ASSERT(m_Layer->ExistLabel(2));
+    CPPUNIT_ASSERT(!m_Layer->ExistLabel(4));
+  }
+
+  void TestMergeLabel()
+  {
+    m_Layer->MergeLabel(1, 3);
+    CPPUNIT_ASSERT(!m_Layer->ExistLabel(3));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(8 * 8 * 8), m_Layer->GetNumberOfVoxels(1));
+
+    mitk::Image::Pointer decoded = this->CreateImage();
+    m_Layer->Decode(decoded);
+    CPPUNIT_ASSERT_MESSAGE("Merged label is not decoded correctly",
+                           this->DecodedImageIsCorrect(decoded, [](unsigned int x, unsigned int y, unsigned int z) {
+                             PixelType value = GetExpectedValue(x, y, z);
+                             return 3 == value ? PixelType(1) : value;
+                           }));
+
+    // the merged runs are joined and the label is found in the rows of both labels
+    m_Layer->MergeLabel(2, 1);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(8 * 8 * 8 + 6 * 6 * 6), m_Layer->GetNumberOfVoxels(2));
+  }
+
+  void TestEraseLabel()
+  {
+    m_Layer->EraseLabel(1);
+    CPPUNIT_ASSERT(!m_Layer->ExistLabel(1));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(8 * 8), m_Layer->GetNumberOfVoxels(3));
+
+    mitk::Image::Pointer decoded = this->CreateImage();
+    m_Layer->Decode(decoded);
+    CPPUNIT_ASSERT_MESSAGE("Erased label is not decoded correctly",
+                           this->DecodedImageIsCorrect(decoded, [](unsigned int x, unsigned int y, unsigned int z) {
+                             PixelType value = GetExpectedValue(x, y, z);
+                             return 1 == value ? PixelType(0) : value;
+                           }));
+  }
+
+  void TestGetCenterVoxelIndex()
+  {
+    // the label 2 box has 216 voxels, voxel 108 in raster order is the first one of the fourth slice
+    mitk::RunLengthEncodedLabelLayer::IndexType index;
+    CPPUNIT_ASSERT(m_Layer->GetCenterVoxelIndex(2, index));
+    CPPUNIT_ASSERT_EQUAL(itk::IndexValueType(12), index[0]);
+    CPPUNIT_ASSERT_EQUAL(itk::IndexValueType(12), index[1]);
+    CPPUNIT_ASSERT_EQUAL(itk::IndexValueType(15), index[2]);
+
+    CPPUNIT_ASSERT(!m_Layer->GetCenterVoxelIndex(4, index));
+  }
+
+  void TestEncodeWrongPixelType()
+  {
+    mitk::Image::Pointer image = mitk::Image::New();
+    unsigned int dimensions[3] = {Size, Size, Size};
+    image->Initialize(mitk::MakeScalarPixelType<float>(), 3, dimensions);
+
+    CPPUNIT_ASSERT_THROW(m_Layer->Encode(image), mitk::Exception);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkRunLengthEncodedLabelLayer)
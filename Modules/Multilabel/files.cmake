@@ -7,7 +7,9 @@ set(CPP_FILES
   mitkLabelSetImageSurfaceStampFilter.cpp
   mitkLabelSetImageToSurfaceFilter.cpp
   mitkLabelSetImageToSurfaceThreadedFilter.cpp
+  mitkLabelIndex.cpp
   mitkLabelSetImageVtkMapper2D.cpp
+  mitkRunLengthEncodedLabelLayer.cpp
   mitkMultilabelObjectFactory.cpp
   mitkLabelSetIOHelper.cpp
   mitkDICOMSegmentationPropertyHelper.cpp
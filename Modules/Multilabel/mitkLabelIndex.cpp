@@ -0,0 +1,206 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkLabelIndex.h"
+
+#include <algorithm>
+
+mitk::Point3D mitk::LabelIndex::LabelStatistics::GetCentroidIndex() const
+{
+  mitk::Point3D centroid;
+  for (unsigned int dim = 0; dim < 3; ++dim)
+    centroid[dim] = m_NumberOfVoxels > 0 ? m_IndexSum[dim] / m_NumberOfVoxels : 0.0;
+  return centroid;
+}
+
+mitk::LabelIndex::LabelIndex()
+{
+}
+
+void mitk::LabelIndex::Build(const PixelType *buffer, const unsigned int *dimensions)
+{
+  m_Statistics.clear();
+
+  IndexType index;
+  for (index[3] = 0; index[3] < dimensions[3]; ++index[3])
+  {
+    for (index[2] = 0; index[2] < dimensions[2]; ++index[2])
+    {
+      for (index[1] = 0; index[1] < dimensions[1]; ++index[1])
+      {
+        for (index[0] = 0; index[0] < dimensions[0]; ++index[0], ++buffer)
+        {
+          if (0 != *buffer)
+            this->ReplaceVoxel(index, 0, *buffer);
+        }
+      }
+    }
+  }
+}
+
+void mitk::LabelIndex::Clear()
+{
+  m_Statistics.clear();
+}
+
+void mitk::LabelIndex::ReplaceVoxel(const IndexType &index, PixelType previousValue, PixelType value)
+{
+  if (previousValue == value)
+    return;
+
+  if (0 != previousValue)
+  {
+    auto previous = m_Statistics.find(previousValue);
+    if (previous != m_Statistics.end())
+    {
+      LabelStatistics &statistics = previous->second;
+      if (1 == statistics.m_NumberOfVoxels)
+      {
+        m_Statistics.erase(previous);
+      }
+      else
+      {
+        --statistics.m_NumberOfVoxels;
+        for (unsigned int dim = 0; dim < 3; ++dim)
+          statistics.m_IndexSum[dim] -= index[dim];
+
+        // only a voxel on the border of the bounding box may have been the last one there
+        for (unsigned int dim = 0; dim < 4; ++dim)
+        {
+          if (index[dim] == statistics.m_MinimumIndex[dim] || index[dim] == statistics.m_MaximumIndex[dim])
+            statistics.m_LooseBoundingBox = true;
+        }
+      }
+    }
+  }
+
+  if (0 != value)
+  {
+    auto current = m_Statistics.find(value);
+    if (current == m_Statistics.end())
+    {
+      LabelStatistics statistics;
+      statistics.m_NumberOfVoxels = 1;
+      statistics.m_MinimumIndex = index;
+      statistics.m_MaximumIndex = index;
+      statistics.m_LooseBoundingBox = false;
+      for (unsigned int dim = 0; dim < 3; ++dim)
+        statistics.m_IndexSum[dim] = index[dim];
+      m_Statistics.insert(std::make_pair(value, statistics));
+    }
+    else
+    {
+      LabelStatistics &statistics = current->second;
+      ++statistics.m_NumberOfVoxels;
+      for (unsigned int dim = 0; dim < 3; ++dim)
+        statistics.m_IndexSum[dim] += index[dim];
+      for (unsigned int dim = 0; dim < 4; ++dim)
+      {
+        statistics.m_MinimumIndex[dim] = std::min(statistics.m_MinimumIndex[dim], index[dim]);
+        statistics.m_MaximumIndex[dim] = std::max(statistics.m_MaximumIndex[dim], index[dim]);
+      }
+    }
+  }
+}
+
+void mitk::LabelIndex::MergeLabel(PixelType pixelValue, PixelType sourcePixelValue)
+{
+  if (pixelValue == sourcePixelValue)
+    return;
+
+  if (0 == pixelValue)
+  {
+    this->EraseLabel(sourcePixelValue);
+    return;
+  }
+
+  auto source = m_Statistics.find(sourcePixelValue);
+  if (source == m_Statistics.end())
+    return;
+
+  auto target = m_Statistics.find(pixelValue);
+  if (target == m_Statistics.end())
+  {
+    m_Statistics.insert(std::make_pair(pixelValue, source->second));
+  }
+  else
+  {
+    LabelStatistics &statistics = target->second;
+    statistics.m_NumberOfVoxels += source->second.m_NumberOfVoxels;
+    statistics.m_LooseBoundingBox = statistics.m_LooseBoundingBox || source->second.m_LooseBoundingBox;
+    for (unsigned int dim = 0; dim < 3; ++dim)
+      statistics.m_IndexSum[dim] += source->second.m_IndexSum[dim];
+    for (unsigned int dim = 0; dim < 4; ++dim)
+    {
+      statistics.m_MinimumIndex[dim] = std::min(statistics.m_MinimumIndex[dim], source->second.m_MinimumIndex[dim]);
+      statistics.m_MaximumIndex[dim] = std::max(statistics.m_MaximumIndex[dim], source->second.m_MaximumIndex[dim]);
+    }
+  }
+
+  m_Statistics.erase(sourcePixelValue);
+}
+
+void mitk::LabelIndex::EraseLabel(PixelType pixelValue)
+{
+  m_Statistics.erase(pixelValue);
+}
+
+const mitk::LabelIndex::LabelStatistics *mitk::LabelIndex::GetStatistics(PixelType pixelValue) const
+{
+  auto statistics = m_Statistics.find(pixelValue);
+  return statistics != m_Statistics.end() ? &statistics->second : nullptr;
+}
+
+void mitk::LabelIndex::TightenBoundingBox(PixelType pixelValue, const PixelType *buffer, const unsigned int *dimensions)
+{
+  auto iter = m_Statistics.find(pixelValue);
+  if (iter == m_Statistics.end() || !iter->second.m_LooseBoundingBox)
+    return;
+
+  LabelStatistics &statistics = iter->second;
+  IndexType minimumIndex = statistics.m_MaximumIndex;
+  IndexType maximumIndex = statistics.m_MinimumIndex;
+
+  IndexType index;
+  for (index[3] = statistics.m_MinimumIndex[3]; index[3] <= statistics.m_MaximumIndex[3]; ++index[3])
+  {
+    for (index[2] = statistics.m_MinimumIndex[2]; index[2] <= statistics.m_MaximumIndex[2]; ++index[2])
+    {
+      for (index[1] = statistics.m_MinimumIndex[1]; index[1] <= statistics.m_MaximumIndex[1]; ++index[1])
+      {
+        const PixelType *line =
+          buffer + dimensions[0] * (index[1] + static_cast<std::size_t>(dimensions[1]) *
+                                                 (index[2] + static_cast<std::size_t>(dimensions[2]) * index[3]));
+
+        for (index[0] = statistics.m_MinimumIndex[0]; index[0] <= statistics.m_MaximumIndex[0]; ++index[0])
+        {
+          if (line[index[0]] != pixelValue)
+            continue;
+
+          for (unsigned int dim = 0; dim < 4; ++dim)
+          {
+            minimumIndex[dim] = std::min(minimumIndex[dim], index[dim]);
+            maximumIndex[dim] = std::max(maximumIndex[dim], index[dim]);
+          }
+        }
+      }
+    }
+  }
+
+  statistics.m_MinimumIndex = minimumIndex;
+  statistics.m_MaximumIndex = maximumIndex;
+  statistics.m_LooseBoundingBox = false;
+}
@@ -0,0 +1,111 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __mitkLabelIndex_H_
+#define __mitkLabelIndex_H_
+
+#include "MitkMultilabelExports.h"
+
+#include <mitkLabel.h>
+#include <mitkPoint.h>
+
+#include <itkIndex.h>
+
+#include <map>
+
+namespace mitk
+{
+  /**
+  * \brief Bounding box, number of voxels and centroid of each label of a label image.
+  *
+  * The index is built by a single pass over the image data and updated voxel by voxel afterwards, e.g. for the
+  * voxels of a slice that a segmentation tool has overwritten. Removing voxels of a label can not shrink its
+  * bounding box without looking at the image data again. The bounding box is marked as loose then and can be
+  * tightened by TightenBoundingBox(), which only visits the old bounding box. A loose bounding box still
+  * contains all voxels of the label.
+  *
+  * The background label 0 is not indexed. Image data is passed as buffer of up to four dimensions in raster
+  * order; unused dimensions have the size one.
+  *
+  * \ingroup Data
+  */
+  class MITKMULTILABEL_EXPORT LabelIndex
+  {
+  public:
+    typedef mitk::Label::PixelType PixelType;
+    typedef itk::Index<4> IndexType;
+
+    struct LabelStatistics
+    {
+      std::size_t m_NumberOfVoxels;
+
+      /** Bounding box of the label, both corners are included */
+      IndexType m_MinimumIndex;
+      IndexType m_MaximumIndex;
+
+      /** True if the bounding box may be larger than necessary */
+      bool m_LooseBoundingBox;
+
+      /** Sum of the spatial indices of all voxels, to calculate the centroid */
+      double m_IndexSum[3];
+
+      /** Returns the mean spatial index of all voxels of the label */
+      mitk::Point3D GetCentroidIndex() const;
+    };
+
+    LabelIndex();
+
+    /**
+    * \brief Indexes all voxels of the image data.
+    */
+    void Build(const PixelType *buffer, const unsigned int *dimensions);
+
+    /**
+    * \brief Removes all labels from the index.
+    */
+    void Clear();
+
+    /**
+    * \brief Updates the index after the value of a voxel has changed from previousValue to value.
+    */
+    void ReplaceVoxel(const IndexType &index, PixelType previousValue, PixelType value);
+
+    /**
+    * \brief Updates the index after all voxels of the label sourcePixelValue have been assigned to pixelValue.
+    */
+    void MergeLabel(PixelType pixelValue, PixelType sourcePixelValue);
+
+    /**
+    * \brief Updates the index after all voxels of a label have been assigned to the background.
+    */
+    void EraseLabel(PixelType pixelValue);
+
+    /**
+    * \brief Returns the statistics of a label or nullptr if the label has no voxels.
+    */
+    const LabelStatistics *GetStatistics(PixelType pixelValue) const;
+
+    /**
+    * \brief Shrinks a loose bounding box of a label to the voxels of the label in the image data.
+    */
+    void TightenBoundingBox(PixelType pixelValue, const PixelType *buffer, const unsigned int *dimensions);
+
+  private:
+    std::map<PixelType, LabelStatistics> m_Statistics;
+  };
+} // namespace mitk
+
+#endif // __mitkLabelIndex_H_
@@ -20,6 +20,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageCast.h"
 #include "mitkImagePixelReadAccessor.h"
 #include "mitkImagePixelWriteAccessor.h"
+#include "mitkImageReadAccessor.h"
 #include "mitkInteractionConst.h"
 #include "mitkLookupTableProperty.h"
 #include "mitkPadImageFilter.h"
@@ -32,18 +33,28 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkTransformPolyDataFilter.h>
 
 #include <itkImageRegionIterator.h>
+#include <itkMath.h>
 #include <itkQuadEdgeMesh.h>
 #include <itkTriangleMeshToBinaryImageFilter.h>
 //#include <itkRelabelComponentImageFilter.h>
 
 #include <itkCommand.h>
 
+#include <cmath>
+
 template <typename TPixel, unsigned int VDimensions>
 void SetToZero(itk::Image<TPixel, VDimensions> *source)
 {
   source->FillBuffer(0);
 }
 
+/** Retrieves the size of the image data in all four dimensions, as mitk::LabelIndex expects it */
+static void GetLabelIndexDimensions(const mitk::Image *image, unsigned int *dimensions)
+{
+  for (unsigned int dim = 0; dim < 4; ++dim)
+    dimensions[dim] = dim < image->GetDimension() ? image->GetDimension(dim) : 1;
+}
+
 template <unsigned int VImageDimension = 3>
 void CreateLabelMaskProcessing(mitk::Image *layerImage, mitk::Image *mask, mitk::LabelSet::PixelType index)
 {
@@ -65,7 +76,13 @@ void CreateLabelMaskProcessing(mitk::Image *layerImage, mitk::Image *mask, mitk:
 }
 
 mitk::LabelSetImage::LabelSetImage()
-  : mitk::Image(), m_ActiveLayer(0), m_activeLayerInvalid(false), m_ExteriorLabel(nullptr)
+  : mitk::Image(),
+    m_SparseLayerStorage(false),
+    m_LabelIndexMTime(0),
+    m_LabelIndexValid(false),
+    m_ActiveLayer(0),
+    m_activeLayerInvalid(false),
+    m_ExteriorLabel(nullptr)
 {
   // Iniitlaize Background Label
   mitk::Color color;
@@ -83,6 +100,9 @@ mitk::LabelSetImage::LabelSetImage()
 
 mitk::LabelSetImage::LabelSetImage(const mitk::LabelSetImage &other)
   : Image(other),
+    m_SparseLayerStorage(other.GetSparseLayerStorage()),
+    m_LabelIndexMTime(0),
+    m_LabelIndexValid(false),
     m_ActiveLayer(other.GetActiveLayer()),
     m_activeLayerInvalid(false),
     m_ExteriorLabel(other.GetExteriorLabel()->Clone())
@@ -97,9 +117,13 @@ mitk::LabelSetImage::LabelSetImage(const mitk::LabelSetImage &other)
     lsClone->AddObserver(itk::ModifiedEvent(), command);
     m_LabelSetContainer.push_back(lsClone);
 
-    // clone layer Image data
-    mitk::Image::Pointer liClone = other.GetLayerImage(i)->Clone();
+    // clone layer data as it is stored, GetLayerImage() would decode run-length encoded layers
+    mitk::Image::Pointer liClone = other.m_LayerContainer[i].IsNotNull() ? other.m_LayerContainer[i]->Clone() : nullptr;
     m_LayerContainer.push_back(liClone);
+
+    mitk::RunLengthEncodedLabelLayer::Pointer slClone =
+      other.m_SparseLayerContainer[i].IsNotNull() ? other.m_SparseLayerContainer[i]->Clone() : nullptr;
+    m_SparseLayerContainer.push_back(slClone);
   }
 
   // Add some DICOM Tags as properties to segmentation image
@@ -108,7 +132,8 @@ mitk::LabelSetImage::LabelSetImage(const mitk::LabelSetImage &other)
 
 void mitk::LabelSetImage::OnLabelSetModified()
 {
-  Superclass::Modified();
+  // label properties do not affect the image data
+  this->ModifiedKeepingLabelIndex();
 }
 
 void mitk::LabelSetImage::SetExteriorLabel(mitk::Label *label)
@@ -166,14 +191,357 @@ mitk::LabelSetImage::~LabelSetImage()
 
 mitk::Image *mitk::LabelSetImage::GetLayerImage(unsigned int layer)
 {
+  if (this->IsLayerSparse(layer))
+    this->DecodeSparseLayer(layer);
+  else if (m_LayerContainer[layer].IsNull()) // active layer with sparse layer storage
+    return this;
+
   return m_LayerContainer[layer];
 }
 
 const mitk::Image *mitk::LabelSetImage::GetLayerImage(unsigned int layer) const
 {
+  if (this->IsLayerSparse(layer))
+    this->DecodeSparseLayer(layer);
+  else if (m_LayerContainer[layer].IsNull()) // active layer with sparse layer storage
+    return this;
+
   return m_LayerContainer[layer];
 }
 
+void mitk::LabelSetImage::SetSparseLayerStorage(bool sparseLayerStorage)
+{
+  if (sparseLayerStorage == m_SparseLayerStorage)
+    return;
+
+  m_SparseLayerStorage = sparseLayerStorage;
+
+  try
+  {
+    if (m_SparseLayerStorage)
+    {
+      this->UpdateSparseLayers();
+    }
+    else
+    {
+      for (unsigned int layer = 0; layer < m_LayerContainer.size(); ++layer)
+      {
+        if (this->IsLayerSparse(layer))
+        {
+          this->DecodeSparseLayer(layer);
+        }
+        else if (m_LayerContainer[layer].IsNull())
+        {
+          // the active layer needs an image again that its data is copied to when the layer changes
+          m_LayerContainer[layer] = this->CreateLayerImage();
+          if (4 == this->GetDimension())
+          {
+            AccessFixedDimensionByItk_n(this, ImageToLayerContainerProcessing, 4, (layer));
+          }
+          else
+          {
+            AccessByItk_1(this, ImageToLayerContainerProcessing, layer);
+          }
+        }
+      }
+    }
+  }
+  catch (itk::ExceptionObject &e)
+  {
+    mitkThrow() << e.GetDescription();
+  }
+
+  this->Modified();
+}
+
+bool mitk::LabelSetImage::GetSparseLayerStorage() const
+{
+  return m_SparseLayerStorage;
+}
+
+bool mitk::LabelSetImage::IsLayerSparse(unsigned int layer) const
+{
+  return layer < m_SparseLayerContainer.size() && m_SparseLayerContainer[layer].IsNotNull();
+}
+
+const mitk::RunLengthEncodedLabelLayer *mitk::LabelSetImage::GetSparseLayer(unsigned int layer) const
+{
+  return this->IsLayerSparse(layer) ? m_SparseLayerContainer[layer].GetPointer() : nullptr;
+}
+
+mitk::Image::Pointer mitk::LabelSetImage::GetSparseLayerSlice(unsigned int layer,
+                                                             unsigned int axis,
+                                                             unsigned int sliceIndex,
+                                                             unsigned int timeStep) const
+{
+  if (!this->IsLayerSparse(layer) || axis > 2 || sliceIndex >= this->GetDimension(axis) ||
+      !this->GetTimeGeometry()->IsValidTimeStep(timeStep))
+    return nullptr;
+
+  // geometry of the layer, restricted to the slice
+  mitk::BaseGeometry::Pointer geometry = this->GetGeometry(timeStep)->Clone();
+
+  mitk::Point3D sliceOrigin;
+  sliceOrigin.Fill(0.0);
+  sliceOrigin[axis] = sliceIndex;
+  geometry->IndexToWorld(sliceOrigin, sliceOrigin);
+  geometry->SetOrigin(sliceOrigin);
+
+  mitk::BaseGeometry::BoundsArrayType bounds = geometry->GetBounds();
+  bounds[2 * axis] = 0.0;
+  bounds[2 * axis + 1] = 1.0;
+  geometry->SetBounds(bounds);
+
+  mitk::Image::Pointer slice = mitk::Image::New();
+  slice->Initialize(this->GetPixelType(), *geometry);
+
+  mitk::ImageWriteAccessor accessor(slice);
+  m_SparseLayerContainer[layer]->DecodeSlice(axis, sliceIndex, timeStep, static_cast<PixelType *>(accessor.GetData()));
+
+  return slice;
+}
+
+mitk::Image::Pointer mitk::LabelSetImage::CreateLayerImage() const
+{
+  mitk::Image::Pointer newImage = mitk::Image::New();
+  newImage->Initialize(this->GetPixelType(),
+                       this->GetDimension(),
+                       this->GetDimensions(),
+                       this->GetImageDescriptor()->GetNumberOfChannels());
+  newImage->SetTimeGeometry(this->GetTimeGeometry()->Clone());
+  return newImage;
+}
+
+void mitk::LabelSetImage::DecodeSparseLayer(unsigned int layer) const
+{
+  mitk::Image::Pointer layerImage = this->CreateLayerImage();
+  m_SparseLayerContainer[layer]->Decode(layerImage);
+
+  m_LayerContainer[layer] = layerImage;
+  m_SparseLayerContainer[layer] = nullptr;
+}
+
+void mitk::LabelSetImage::EncodeActiveLayer()
+{
+  // encoded right from the image data, the layer image is not needed any more
+  mitk::RunLengthEncodedLabelLayer::Pointer sparseLayer = mitk::RunLengthEncodedLabelLayer::New();
+  sparseLayer->Encode(this);
+
+  m_SparseLayerContainer[this->GetActiveLayer()] = sparseLayer;
+  m_LayerContainer[this->GetActiveLayer()] = nullptr;
+}
+
+void mitk::LabelSetImage::DecodeActiveLayer()
+{
+  m_SparseLayerContainer[this->GetActiveLayer()]->Decode(this);
+  m_SparseLayerContainer[this->GetActiveLayer()] = nullptr;
+}
+
+void mitk::LabelSetImage::UpdateSparseLayers()
+{
+  if (!m_SparseLayerStorage)
+    return;
+
+  for (unsigned int layer = 0; layer < m_LayerContainer.size(); ++layer)
+  {
+    if (m_LayerContainer[layer].IsNull())
+      continue;
+
+    if (layer != this->GetActiveLayer())
+    {
+      // a layer image that has been handed out by GetLayerImage() and is still referenced elsewhere stays
+      // the image of the layer, edits to it would be lost otherwise; it is encoded once it is released
+      if (m_LayerContainer[layer]->GetReferenceCount() > 1)
+        continue;
+
+      m_SparseLayerContainer[layer] = mitk::RunLengthEncodedLabelLayer::New();
+      m_SparseLayerContainer[layer]->Encode(m_LayerContainer[layer]);
+    }
+
+    // the image data of the active layer is kept by the LabelSetImage itself
+    m_LayerContainer[layer] = nullptr;
+  }
+}
+
+bool mitk::LabelSetImage::IsLabelIndexValid() const
+{
+  return m_LabelIndexValid && m_LabelIndexMTime == this->GetMTime();
+}
+
+mitk::LabelIndex *mitk::LabelSetImage::GetValidLabelIndex() const
+{
+  if (!this->IsInitialized())
+    return nullptr;
+
+  if (!this->IsLabelIndexValid())
+  {
+    unsigned int dimensions[4];
+    GetLabelIndexDimensions(this, dimensions);
+
+    mitk::ImageReadAccessor accessor(this);
+    m_LabelIndex.Build(static_cast<const PixelType *>(accessor.GetData()), dimensions);
+
+    m_LabelIndexMTime = this->GetMTime();
+    m_LabelIndexValid = true;
+  }
+
+  return &m_LabelIndex;
+}
+
+void mitk::LabelSetImage::ModifiedKeepingLabelIndex()
+{
+  const bool labelIndexValid = this->IsLabelIndexValid();
+
+  this->Modified();
+
+  if (labelIndexValid)
+    m_LabelIndexMTime = this->GetMTime();
+}
+
+std::size_t mitk::LabelSetImage::GetNumberOfVoxels(PixelType pixelValue) const
+{
+  const LabelIndex *labelIndex = this->GetValidLabelIndex();
+  if (nullptr == labelIndex)
+    return 0;
+
+  const LabelIndex::LabelStatistics *statistics = labelIndex->GetStatistics(pixelValue);
+  return nullptr != statistics ? statistics->m_NumberOfVoxels : 0;
+}
+
+double mitk::LabelSetImage::GetLabelVolume(PixelType pixelValue) const
+{
+  const std::size_t numberOfVoxels = this->GetNumberOfVoxels(pixelValue);
+  if (0 == numberOfVoxels)
+    return 0.0;
+
+  const mitk::Vector3D spacing = this->GetGeometry()->GetSpacing();
+  return numberOfVoxels * spacing[0] * spacing[1] * spacing[2];
+}
+
+bool mitk::LabelSetImage::GetLabelBoundingBox(PixelType pixelValue,
+                                              mitk::LabelIndex::IndexType &minimumIndex,
+                                              mitk::LabelIndex::IndexType &maximumIndex) const
+{
+  LabelIndex *labelIndex = this->GetValidLabelIndex();
+  if (nullptr == labelIndex)
+    return false;
+
+  const LabelIndex::LabelStatistics *statistics = labelIndex->GetStatistics(pixelValue);
+  if (nullptr == statistics)
+    return false;
+
+  if (statistics->m_LooseBoundingBox)
+  {
+    unsigned int dimensions[4];
+    GetLabelIndexDimensions(this, dimensions);
+
+    mitk::ImageReadAccessor accessor(this);
+    labelIndex->TightenBoundingBox(pixelValue, static_cast<const PixelType *>(accessor.GetData()), dimensions);
+  }
+
+  minimumIndex = statistics->m_MinimumIndex;
+  maximumIndex = statistics->m_MaximumIndex;
+  return true;
+}
+
+void mitk::LabelSetImage::UpdateLabelIndex(const mitk::Image *previousSlice, unsigned int timeStep)
+{
+  unsigned int dimensions[4];
+  GetLabelIndexDimensions(this, dimensions);
+
+  if (!this->IsLabelIndexValid() || nullptr == previousSlice || timeStep >= dimensions[3] ||
+      previousSlice->GetDimension() < 2 || (previousSlice->GetDimension() > 2 && previousSlice->GetDimension(2) != 1) ||
+      previousSlice->GetPixelType() != this->GetPixelType())
+  {
+    this->Modified();
+    return;
+  }
+
+  // Map the first voxel of the slice and its neighbors along both slice axes into the image. The slice can
+  // only be applied voxel by voxel if it is aligned with the image axes and has the spacing of the image.
+  const mitk::BaseGeometry *sliceGeometry = previousSlice->GetGeometry();
+  const mitk::BaseGeometry *imageGeometry = this->GetGeometry(timeStep);
+
+  mitk::Point3D continuousIndex[3];
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    mitk::Point3D sliceIndex;
+    sliceIndex[0] = 1 == i ? 1.0 : 0.0;
+    sliceIndex[1] = 2 == i ? 1.0 : 0.0;
+    sliceIndex[2] = 0.0;
+
+    mitk::Point3D world;
+    sliceGeometry->IndexToWorld(sliceIndex, world);
+    imageGeometry->WorldToIndex(world, continuousIndex[i]);
+  }
+
+  const unsigned int width = previousSlice->GetDimension(0);
+  const unsigned int height = previousSlice->GetDimension(1);
+
+  itk::IndexValueType origin[3];
+  itk::IndexValueType step[2][3];
+  bool aligned = true;
+
+  for (unsigned int dim = 0; dim < 3; ++dim)
+  {
+    origin[dim] = itk::Math::Round<itk::IndexValueType>(continuousIndex[0][dim]);
+    aligned = aligned && std::abs(continuousIndex[0][dim] - origin[dim]) < 0.01;
+
+    for (unsigned int axis = 0; axis < 2; ++axis)
+    {
+      const double delta = continuousIndex[axis + 1][dim] - continuousIndex[0][dim];
+      step[axis][dim] = itk::Math::Round<itk::IndexValueType>(delta);
+      aligned = aligned && std::abs(delta - step[axis][dim]) < 0.01;
+    }
+  }
+
+  for (unsigned int axis = 0; axis < 2 && aligned; ++axis)
+  {
+    const itk::IndexValueType length = std::abs(step[axis][0]) + std::abs(step[axis][1]) + std::abs(step[axis][2]);
+    aligned = 1 == length;
+  }
+
+  // both corners of the slice have to be located within the image
+  for (unsigned int dim = 0; dim < 3 && aligned; ++dim)
+  {
+    const itk::IndexValueType end = origin[dim] + (width - 1) * step[0][dim] + (height - 1) * step[1][dim];
+    aligned = origin[dim] >= 0 && end >= 0 && origin[dim] < static_cast<itk::IndexValueType>(dimensions[dim]) &&
+              end < static_cast<itk::IndexValueType>(dimensions[dim]);
+  }
+
+  if (!aligned)
+  {
+    this->Modified();
+    return;
+  }
+
+  mitk::ImageReadAccessor previousSliceAccessor(previousSlice);
+  mitk::ImageReadAccessor accessor(this);
+
+  auto previousValues = static_cast<const PixelType *>(previousSliceAccessor.GetData());
+  auto values = static_cast<const PixelType *>(accessor.GetData());
+
+  LabelIndex::IndexType index;
+  index[3] = timeStep;
+
+  for (unsigned int y = 0; y < height; ++y)
+  {
+    for (unsigned int x = 0; x < width; ++x, ++previousValues)
+    {
+      for (unsigned int dim = 0; dim < 3; ++dim)
+        index[dim] = origin[dim] + x * step[0][dim] + y * step[1][dim];
+
+      const std::size_t offset =
+        index[0] + dimensions[0] * (index[1] + static_cast<std::size_t>(dimensions[1]) *
+                                                 (index[2] + static_cast<std::size_t>(dimensions[2]) * index[3]));
+
+      m_LabelIndex.ReplaceVoxel(index, *previousValues, values[offset]);
+    }
+  }
+
+  this->ModifiedKeepingLabelIndex();
+}
+
 unsigned int mitk::LabelSetImage::GetActiveLayer() const
 {
   return m_ActiveLayer;
@@ -204,6 +572,7 @@ void mitk::LabelSetImage::RemoveLayer()
   // remove labelset and image data
   m_LabelSetContainer.erase(m_LabelSetContainer.begin() + layerToDelete);
   m_LayerContainer.erase(m_LayerContainer.begin() + layerToDelete);
+  m_SparseLayerContainer.erase(m_SparseLayerContainer.begin() + layerToDelete);
 
   if (layerToDelete == 0)
   {
@@ -215,12 +584,7 @@ void mitk::LabelSetImage::RemoveLayer()
 
 unsigned int mitk::LabelSetImage::AddLayer(mitk::LabelSet::Pointer lset)
 {
-  mitk::Image::Pointer newImage = mitk::Image::New();
-  newImage->Initialize(this->GetPixelType(),
-                       this->GetDimension(),
-                       this->GetDimensions(),
-                       this->GetImageDescriptor()->GetNumberOfChannels());
-  newImage->SetTimeGeometry(this->GetTimeGeometry()->Clone());
+  mitk::Image::Pointer newImage = this->CreateLayerImage();
 
   if (newImage->GetDimension() < 4)
   {
@@ -259,6 +623,7 @@ unsigned int mitk::LabelSetImage::AddLayer(mitk::Image::Pointer layerImage, mitk
 
   // push a new working image for the new layer
   m_LayerContainer.push_back(layerImage);
+  m_SparseLayerContainer.push_back(nullptr);
 
   // push a new labelset for the new layer
   m_LabelSetContainer.push_back(ls);
@@ -314,12 +679,25 @@ void mitk::LabelSetImage::SetActiveLayer(unsigned int layer)
           // We should not write the invalid layer back to the vector
           m_activeLayerInvalid = false;
         }
+        else if (m_SparseLayerStorage)
+        {
+          this->EncodeActiveLayer();
+        }
         else
         {
           AccessFixedDimensionByItk_n(this, ImageToLayerContainerProcessing, 4, (GetActiveLayer()));
         }
         m_ActiveLayer = layer; // only at this place m_ActiveLayer should be manipulated!!! Use Getter and Setter
-        AccessFixedDimensionByItk_n(this, LayerContainerToImageProcessing, 4, (GetActiveLayer()));
+        m_LabelIndexValid = false;
+        if (this->IsLayerSparse(GetActiveLayer()))
+        {
+          this->DecodeActiveLayer();
+        }
+        else
+        {
+          AccessFixedDimensionByItk_n(this, LayerContainerToImageProcessing, 4, (GetActiveLayer()));
+        }
+        this->UpdateSparseLayers();
 
         AfterChangeLayerEvent.Send();
       }
@@ -335,12 +713,25 @@ void mitk::LabelSetImage::SetActiveLayer(unsigned int layer)
           // We should not write the invalid layer back to the vector
           m_activeLayerInvalid = false;
         }
+        else if (m_SparseLayerStorage)
+        {
+          this->EncodeActiveLayer();
+        }
         else
         {
           AccessByItk_1(this, ImageToLayerContainerProcessing, GetActiveLayer());
         }
         m_ActiveLayer = layer; // only at this place m_ActiveLayer should be manipulated!!! Use Getter and Setter
-        AccessByItk_1(this, LayerContainerToImageProcessing, GetActiveLayer());
+        m_LabelIndexValid = false;
+        if (this->IsLayerSparse(GetActiveLayer()))
+        {
+          this->DecodeActiveLayer();
+        }
+        else
+        {
+          AccessByItk_1(this, LayerContainerToImageProcessing, GetActiveLayer());
+        }
+        this->UpdateSparseLayers();
 
         AfterChangeLayerEvent.Send();
       }
@@ -422,14 +813,24 @@ void mitk::LabelSetImage::MergeLabel(PixelType pixelValue, PixelType sourcePixel
 {
   try
   {
-    AccessByItk_2(this, MergeLabelProcessing, pixelValue, sourcePixelValue);
+    if (this->IsLayerSparse(layer))
+    {
+      m_SparseLayerContainer[layer]->MergeLabel(pixelValue, sourcePixelValue);
+    }
+    else
+    {
+      LabelIndex *labelIndex = this->GetValidLabelIndex();
+      AccessByItk_2(this, MergeLabelProcessing, pixelValue, sourcePixelValue);
+      if (nullptr != labelIndex)
+        labelIndex->MergeLabel(pixelValue, sourcePixelValue);
+    }
   }
   catch (itk::ExceptionObject &e)
   {
     mitkThrow() << e.GetDescription();
   }
   GetLabelSet(layer)->SetActiveLabel(pixelValue);
-  Modified();
+  this->ModifiedKeepingLabelIndex();
 }
 
 void mitk::LabelSetImage::MergeLabels(PixelType pixelValue, std::vector<PixelType>& vectorOfSourcePixelValues, unsigned int layer)
@@ -438,7 +839,17 @@ void mitk::LabelSetImage::MergeLabels(PixelType pixelValue, std::vector<PixelTyp
   {
     for (unsigned int idx = 0; idx < vectorOfSourcePixelValues.size(); idx++)
     {
-      AccessByItk_2(this, MergeLabelProcessing, pixelValue, vectorOfSourcePixelValues[idx]);
+      if (this->IsLayerSparse(layer))
+      {
+        m_SparseLayerContainer[layer]->MergeLabel(pixelValue, vectorOfSourcePixelValues[idx]);
+      }
+      else
+      {
+        LabelIndex *labelIndex = this->GetValidLabelIndex();
+        AccessByItk_2(this, MergeLabelProcessing, pixelValue, vectorOfSourcePixelValues[idx]);
+        if (nullptr != labelIndex)
+          labelIndex->MergeLabel(pixelValue, vectorOfSourcePixelValues[idx]);
+      }
     }
   }
   catch (itk::ExceptionObject &e)
@@ -446,7 +857,7 @@ void mitk::LabelSetImage::MergeLabels(PixelType pixelValue, std::vector<PixelTyp
     mitkThrow() << e.GetDescription();
   }
   GetLabelSet(layer)->SetActiveLabel(pixelValue);
-  Modified();
+  this->ModifiedKeepingLabelIndex();
 }
 
 void mitk::LabelSetImage::RemoveLabels(std::vector<PixelType> &VectorOfLabelPixelValues, unsigned int layer)
@@ -470,13 +881,23 @@ void mitk::LabelSetImage::EraseLabel(PixelType pixelValue, unsigned int layer)
 {
   try
   {
-    AccessByItk_2(this, EraseLabelProcessing, pixelValue, layer);
+    if (this->IsLayerSparse(layer))
+    {
+      m_SparseLayerContainer[layer]->EraseLabel(pixelValue);
+    }
+    else
+    {
+      LabelIndex *labelIndex = this->GetValidLabelIndex();
+      AccessByItk_2(this, EraseLabelProcessing, pixelValue, layer);
+      if (nullptr != labelIndex)
+        labelIndex->EraseLabel(pixelValue);
+    }
   }
   catch (itk::ExceptionObject &e)
   {
     mitkThrow() << e.GetDescription();
   }
-  Modified();
+  this->ModifiedKeepingLabelIndex();
 }
 
 mitk::Label *mitk::LabelSetImage::GetActiveLabel(unsigned int layer)
@@ -521,12 +942,33 @@ mitk::LabelSet *mitk::LabelSetImage::GetActiveLabelSet()
 
 void mitk::LabelSetImage::UpdateCenterOfMass(PixelType pixelValue, unsigned int layer)
 {
-  if (4 == this->GetDimension())
+  if (this->IsLayerSparse(layer))
   {
+    // same voxel as CalculateCenterOfMassProcessing() retrieves, but only the runs of the label are visited
+    mitk::Point3D pos;
+    pos.Fill(0.0);
+
+    mitk::RunLengthEncodedLabelLayer::IndexType centerIndex;
+    centerIndex.Fill(0);
+    if (m_SparseLayerContainer[layer]->GetCenterVoxelIndex(pixelValue, centerIndex))
+    {
+      pos[0] = centerIndex[0];
+      pos[1] = centerIndex[1];
+      pos[2] = centerIndex[2];
+    }
+
+    GetLabelSet(layer)->GetLabel(pixelValue)->SetCenterOfMassIndex(pos);
+    this->GetSlicedGeometry(centerIndex[3])->IndexToWorld(pos, pos);
+    GetLabelSet(layer)->GetLabel(pixelValue)->SetCenterOfMassCoordinates(pos);
+  }
+  else if (4 == this->GetDimension())
+  {
+    this->GetValidLabelIndex();
     AccessFixedDimensionByItk_2(this, CalculateCenterOfMassProcessing, 4, pixelValue, layer);
   }
   else
   {
+    this->GetValidLabelIndex();
     AccessByItk_2(this, CalculateCenterOfMassProcessing, pixelValue, layer);
   }
 }
@@ -749,43 +1191,75 @@ void mitk::LabelSetImage::CalculateCenterOfMassProcessing(ImageType *itkImage, P
 {
   // for now, we just retrieve the voxel in the middle
   typedef itk::ImageRegionConstIterator<ImageType> IteratorType;
-  IteratorType iter(itkImage, itkImage->GetLargestPossibleRegion());
-  iter.GoToBegin();
 
   std::vector<typename ImageType::IndexType> indexVector;
 
-  while (!iter.IsAtEnd())
+  // the raster order of the voxels within the label region is the same as within the whole image
+  typename ImageType::RegionType region;
+  if (this->GetLabelRegion(itkImage, pixelValue, region))
   {
-    // TODO fix comparison warning more effective
-    if (iter.Get() == pixelValue)
+    IteratorType iter(itkImage, region);
+    iter.GoToBegin();
+
+    while (!iter.IsAtEnd())
     {
-      indexVector.push_back(iter.GetIndex());
+      // TODO fix comparison warning more effective
+      if (iter.Get() == pixelValue)
+      {
+        indexVector.push_back(iter.GetIndex());
+      }
+      ++iter;
     }
-    ++iter;
   }
 
   mitk::Point3D pos;
   pos.Fill(0.0);
+  unsigned int timeStep = 0;
 
   if (!indexVector.empty())
   {
-    typename itk::ImageRegionConstIteratorWithIndex<ImageType>::IndexType centerIndex;
-    centerIndex = indexVector.at(indexVector.size() / 2);
-    if (centerIndex.GetIndexDimension() == 3)
-    {
-      pos[0] = centerIndex[0];
-      pos[1] = centerIndex[1];
-      pos[2] = centerIndex[2];
-    }
-    else
+    if (ImageType::ImageDimension < 3)
       return;
+
+    // in 4D images the center is the voxel in the middle of all time steps, located in its time step
+    const typename ImageType::IndexType &centerIndex = indexVector.at(indexVector.size() / 2);
+    pos[0] = centerIndex[0];
+    pos[1] = centerIndex[1];
+    pos[2] = centerIndex[2];
+    if (ImageType::ImageDimension > 3)
+      timeStep = centerIndex[ImageType::ImageDimension - 1];
   }
 
   GetLabelSet(layer)->GetLabel(pixelValue)->SetCenterOfMassIndex(pos);
-  this->GetSlicedGeometry()->IndexToWorld(pos, pos); // TODO: TimeGeometry?
+  this->GetSlicedGeometry(timeStep)->IndexToWorld(pos, pos);
   GetLabelSet(layer)->GetLabel(pixelValue)->SetCenterOfMassCoordinates(pos);
 }
 
+template <typename ImageType>
+bool mitk::LabelSetImage::GetLabelRegion(const ImageType *itkImage,
+                                         PixelType pixelValue,
+                                         typename ImageType::RegionType &region) const
+{
+  region = itkImage->GetLargestPossibleRegion();
+
+  // the background is not indexed; the index is only used if it is up to date, it is not rebuilt while the
+  // image data is accessed by ITK
+  if (0 == pixelValue || !this->IsLabelIndexValid())
+    return true;
+
+  const LabelIndex::LabelStatistics *statistics = m_LabelIndex.GetStatistics(pixelValue);
+  if (nullptr == statistics)
+    return false;
+
+  for (unsigned int dim = 0; dim < ImageType::ImageDimension && dim < 4; ++dim)
+  {
+    region.SetIndex(dim, statistics->m_MinimumIndex[dim]);
+    region.SetSize(dim, statistics->m_MaximumIndex[dim] - statistics->m_MinimumIndex[dim] + 1);
+  }
+
+  return true;
+}
+
 template <typename ImageType>
 void mitk::LabelSetImage::ClearBufferProcessing(ImageType *itkImage)
 {
@@ -878,7 +1352,11 @@ void mitk::LabelSetImage::EraseLabelProcessing(ImageType *itkImage, PixelType pi
 {
   typedef itk::ImageRegionIterator<ImageType> IteratorType;
 
-  IteratorType iter(itkImage, itkImage->GetLargestPossibleRegion());
+  typename ImageType::RegionType region;
+  if (!this->GetLabelRegion(itkImage, pixelValue, region))
+    return;
+
+  IteratorType iter(itkImage, region);
   iter.GoToBegin();
 
   while (!iter.IsAtEnd())
@@ -898,7 +1376,11 @@ void mitk::LabelSetImage::MergeLabelProcessing(ImageType *itkImage, PixelType pi
 {
   typedef itk::ImageRegionIterator<ImageType> IteratorType;
 
-  IteratorType iter(itkImage, itkImage->GetLargestPossibleRegion());
+  typename ImageType::RegionType region;
+  if (!this->GetLabelRegion(itkImage, index, region))
+    return;
+
+  IteratorType iter(itkImage, region);
   iter.GoToBegin();
 
   while (!iter.IsAtEnd())
@@ -18,7 +18,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #define __mitkLabelSetImage_H_
 
 #include <mitkImage.h>
+#include <mitkLabelIndex.h>
 #include <mitkLabelSet.h>
+#include <mitkRunLengthEncodedLabelLayer.h>
 
 #include <MitkMultilabelExports.h>
 
@@ -245,11 +247,97 @@ namespace mitk
     void RemoveLayer();
 
     /**
-      * \brief  */
+     * @brief Returns the image data of a layer.
+     *
+     * If the layer is run-length encoded (see SetSparseLayerStorage()), it is decoded and kept as image.
+     * The next layer change encodes it again, unless the image is still referenced by a smart pointer:
+     * such a layer stays decoded, and changes to the image remain the data of the layer, until it is
+     * released. Hold an mitk::Image::Pointer to the image if it is used across layer changes; a raw
+     * pointer may be dangling afterwards. With sparse layer storage the image of the active layer is the
+     * LabelSetImage itself.
+     */
     mitk::Image *GetLayerImage(unsigned int layer);
 
     const mitk::Image *GetLayerImage(unsigned int layer) const;
 
+    /**
+     * @brief Enables or disables run-length encoded storage of the inactive layers.
+     *
+     * Every layer is a full image otherwise, although most of its voxels are usually background. If
+     * enabled, all layers except the active one are kept as mitk::RunLengthEncodedLabelLayer; the active
+     * layer is only kept as image data of the LabelSetImage itself. Label operations on inactive layers,
+     * like MergeLabel(), EraseLabel() and UpdateCenterOfMass(), then only visit the runs of the label.
+     *
+     * Disabled by default and not enabled by any part of MITK itself: applications that handle
+     * segmentations with many layers opt in explicitly, e.g. right after loading. Renderers use
+     * GetSparseLayerSlice() and do not decode whole layers.
+     */
+    void SetSparseLayerStorage(bool sparseLayerStorage);
+
+    bool GetSparseLayerStorage() const;
+
+    /**
+     * @brief Returns true if the given layer is currently kept run-length encoded.
+     */
+    bool IsLayerSparse(unsigned int layer) const;
+
+    /**
+     * @brief Returns the run-length encoded data of a layer or nullptr if the layer is not kept run-length encoded.
+     */
+    const mitk::RunLengthEncodedLabelLayer *GetSparseLayer(unsigned int layer) const;
+
+    /**
+     * @brief Decodes a single slice of a run-length encoded layer, e.g. for rendering.
+     *
+     * @param layer the layer, which has to be run-length encoded
+     * @param axis the image axis perpendicular to the slice
+     * @param sliceIndex the index of the slice along axis
+     * @param timeStep the time step of the slice
+     * @return an image with a single slice along axis (a 2D image for axis 2), located at the position of
+     *         the slice in the layer, or nullptr if the layer is not run-length encoded or the slice does not exist
+     */
+    mitk::Image::Pointer GetSparseLayerSlice(unsigned int layer,
+                                             unsigned int axis,
+                                             unsigned int sliceIndex,
+                                             unsigned int timeStep) const;
+
+    /**
+     * @brief Returns the number of voxels of a label in the active layer.
+     *
+     * The statistics of all labels of the active layer are kept in a mitk::LabelIndex. It is built by a single
+     * pass over the image data when it is first needed after the image data has been modified and is kept up to
+     * date by MergeLabel(), EraseLabel() and UpdateLabelIndex(). Queries are answered from the index.
+     */
+    std::size_t GetNumberOfVoxels(PixelType pixelValue) const;
+
+    /**
+     * @brief Returns the volume of a label in the active layer in cubic millimeters, see GetNumberOfVoxels().
+     */
+    double GetLabelVolume(PixelType pixelValue) const;
+
+    /**
+     * @brief Retrieves the bounding box of a label in the active layer in index coordinates, see GetNumberOfVoxels().
+     *
+     * Both corners are part of the bounding box; unused dimensions are zero.
+     * @return false if no voxel of the active layer has the given label value
+     */
+    bool GetLabelBoundingBox(PixelType pixelValue,
+                             mitk::LabelIndex::IndexType &minimumIndex,
+                             mitk::LabelIndex::IndexType &maximumIndex) const;
+
+    /**
+     * @brief Marks the image as modified after a slice of the active layer has been overwritten and updates the
+     * label index by the voxels of this slice only.
+     *
+     * Segmentation tools call this instead of Modified() after writing back a slice, so that the label index does
+     * not have to be rebuilt. If the slice is not aligned with the image axes, the index is rebuilt on demand.
+     *
+     * @param previousSlice the slice before it was overwritten, as extracted by mitk::ExtractSliceFilter, i.e.
+     *        with the geometry of the slice in world coordinates
+     * @param timeStep the time step of the slice
+     */
+    void UpdateLabelIndex(const mitk::Image *previousSlice, unsigned int timeStep);
+
     void OnLabelSetModified();
 
     /**
@@ -306,8 +394,47 @@ namespace mitk
     template <typename LabelSetImageType, typename ImageType>
     void InitializeByLabeledImageProcessing(LabelSetImageType *input, ImageType *other);
 
+    /** Creates an uninitialized image with the size and geometry of a layer */
+    Image::Pointer CreateLayerImage() const;
+
+    /** Replaces the run-length encoded data of an inactive layer by an image */
+    void DecodeSparseLayer(unsigned int layer) const;
+
+    /** Run-length encodes the image data of the active layer before it becomes inactive */
+    void EncodeActiveLayer();
+
+    /** Restores the image data of the active layer from its run-length encoded data */
+    void DecodeActiveLayer();
+
+    /** Run-length encodes all inactive layers that are kept as image and not referenced elsewhere if sparse layer storage is enabled */
+    void UpdateSparseLayers();
+
+    /** Returns true if the label index matches the image data */
+    bool IsLabelIndexValid() const;
+
+    /** Returns the label index, which is rebuilt if the image data has changed, or nullptr for uninitialized images */
+    LabelIndex *GetValidLabelIndex() const;
+
+    /** Calls Modified(), but keeps the label index valid; for changes that have been applied to the index as well */
+    void ModifiedKeepingLabelIndex();
+
+    /** Retrieves the region of the image data that contains all voxels of a label; false if there are none */
+    template <typename ImageType>
+    bool GetLabelRegion(const ImageType *itkImage, PixelType pixelValue, typename ImageType::RegionType &region) const;
+
     std::vector<LabelSet::Pointer> m_LabelSetContainer;
-    std::vector<Image::Pointer> m_LayerContainer;
+
+    // Layers are decoded on demand by GetLayerImage() const; for each layer either the image or the
+    // run-length encoded data is set, the image of the active layer may be a stale copy or nullptr
+    mutable std::vector<Image::Pointer> m_LayerContainer;
+    mutable std::vector<RunLengthEncodedLabelLayer::Pointer> m_SparseLayerContainer;
+
+    bool m_SparseLayerStorage;
+
+    // statistics of the labels of the active layer, valid if m_LabelIndexMTime equals the MTime of the image
+    mutable LabelIndex m_LabelIndex;
+    mutable unsigned long m_LabelIndexMTime;
+    mutable bool m_LabelIndexValid;
 
     int m_ActiveLayer;
 
@@ -18,28 +18,37 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkImageAccessByItk.h>
 #include <mitkImageCast.h>
+#include <mitkRunInParallel.h>
 
 // itk
 #include <itkAntiAliasBinaryImageFilter.h>
-#include <itkAutoCropLabelMapFilter.h>
-#include <itkBinaryThresholdImageFilter.h>
-#include <itkLabelImageToLabelMapFilter.h>
-#include <itkLabelMap.h>
-#include <itkLabelMapToLabelImageFilter.h>
-#include <itkLabelObject.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
+#include <itkImageRegionIterator.h>
 #include <itkNumericTraits.h>
 #include <itkSmoothingRecursiveGaussianImageFilter.h>
 
 // vtk
 #include <vtkCleanPolyData.h>
+#include <vtkDecimatePro.h>
 #include <vtkImageChangeInformation.h>
 #include <vtkImageData.h>
 #include <vtkLinearTransform.h>
 #include <vtkMarchingCubes.h>
-#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
 
 mitk::LabelSetImageToSurfaceFilter::LabelSetImageToSurfaceFilter()
-  : m_GenerateAllLabels(false), m_RequestedLabel(1), m_BackgroundLabel(0), m_UseSmoothing(0), m_Sigma(0.1)
+  : m_GenerateAllLabels(false),
+    m_RequestedLabel(1),
+    m_BackgroundLabel(0),
+    m_UseSmoothing(0),
+    m_Sigma(0.1),
+    m_TargetReduction(0.0),
+    m_NumberOfThreads(mitk::GetDefaultNumberOfThreads())
 {
 }
 
@@ -71,6 +80,135 @@ const mitk::Image *mitk::LabelSetImageToSurfaceFilter::GetInput(void)
 void mitk::LabelSetImageToSurfaceFilter::GenerateOutputInformation()
 {
   itkDebugMacro(<< "GenerateOutputInformation()");
+
+  if (nullptr == this->GetInput())
+    return;
+
+  this->ComputeLabelRegions();
+
+  // one output per label; the first output exists even if there is no label to extract
+  const unsigned int numberOfOutputs = std::max<std::size_t>(1, m_LabelRegions.size());
+  this->SetNumberOfIndexedOutputs(numberOfOutputs);
+  for (unsigned int i = 0; i < numberOfOutputs; ++i)
+  {
+    if (!this->GetOutput(i))
+    {
+      mitk::Surface::Pointer output = static_cast<mitk::Surface *>(this->MakeOutput(i).GetPointer());
+      this->SetNthOutput(i, output.GetPointer());
+    }
+  }
+
+  m_IndexToLabels.clear();
+  unsigned int outputIndex = 0;
+  for (const auto &labelRegion : m_LabelRegions)
+    m_IndexToLabels[outputIndex++] = labelRegion.first;
+}
+
+mitk::LabelSetImageToSurfaceFilter::LabelType mitk::LabelSetImageToSurfaceFilter::GetLabelForNthOutput(
+  unsigned int idx) const
+{
+  auto it = m_IndexToLabels.find(idx);
+  if (it != m_IndexToLabels.end())
+    return it->second;
+
+  itkWarningMacro("Unknown index encountered: " << idx << ". There are " << m_IndexToLabels.size()
+                                                << " labels available.");
+  return itk::NumericTraits<LabelType>::max();
+}
+
+void mitk::LabelSetImageToSurfaceFilter::ComputeLabelRegions()
+{
+  m_AvailableLabels.clear();
+  m_LabelRegions.clear();
+
+  Image::ConstPointer inputImage = this->GetInput();
+
+  // a labelset image already knows the bounding boxes of the labels of its active layer
+  auto labelSetImage = dynamic_cast<const LabelSetImage *>(inputImage.GetPointer());
+  if (nullptr != labelSetImage && 1 == labelSetImage->GetTimeSteps())
+  {
+    std::vector<LabelType> labels;
+    if (m_GenerateAllLabels)
+    {
+      const LabelSet *labelSet = labelSetImage->GetLabelSet(labelSetImage->GetActiveLayer());
+      for (auto it = labelSet->IteratorConstBegin(); it != labelSet->IteratorConstEnd(); ++it)
+      {
+        if (it->first != m_BackgroundLabel)
+          labels.push_back(it->first);
+      }
+    }
+    else
+    {
+      labels.push_back(static_cast<LabelType>(m_RequestedLabel));
+    }
+
+    for (LabelType label : labels)
+    {
+      LabelIndex::IndexType minimumIndex;
+      LabelIndex::IndexType maximumIndex;
+      if (!labelSetImage->GetLabelBoundingBox(label, minimumIndex, maximumIndex))
+        continue;
+
+      itk::ImageRegion<3> region;
+      for (unsigned int dim = 0; dim < 3; ++dim)
+      {
+        region.SetIndex(dim, minimumIndex[dim]);
+        region.SetSize(dim, maximumIndex[dim] - minimumIndex[dim] + 1);
+      }
+
+      m_AvailableLabels[label] = labelSetImage->GetNumberOfVoxels(label);
+      m_LabelRegions[label] = region;
+    }
+
+    return;
+  }
+
+  AccessFixedDimensionByItk(inputImage, ComputeLabelRegionsProcessing, 3);
+}
+
+template <typename TPixel, unsigned int VDimension>
+void mitk::LabelSetImageToSurfaceFilter::ComputeLabelRegionsProcessing(const itk::Image<TPixel, VDimension> *input)
+{
+  typedef itk::Image<TPixel, VDimension> ImageType;
+  typedef typename ImageType::IndexType IndexType;
+
+  std::map<LabelType, std::pair<IndexType, IndexType>> boundingBoxes;
+
+  // a single pass collects the bounding boxes of all labels
+  itk::ImageRegionConstIteratorWithIndex<ImageType> it(input, input->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const auto label = static_cast<LabelType>(it.Get());
+    if (label == m_BackgroundLabel || (!m_GenerateAllLabels && label != m_RequestedLabel))
+      continue;
+
+    const IndexType &index = it.GetIndex();
+    auto boundingBox = boundingBoxes.find(label);
+    if (boundingBox == boundingBoxes.end())
+    {
+      boundingBoxes.insert(std::make_pair(label, std::make_pair(index, index)));
+      m_AvailableLabels[label] = 1;
+      continue;
+    }
+
+    for (unsigned int dim = 0; dim < VDimension; ++dim)
+    {
+      boundingBox->second.first[dim] = std::min(boundingBox->second.first[dim], index[dim]);
+      boundingBox->second.second[dim] = std::max(boundingBox->second.second[dim], index[dim]);
+    }
+    ++m_AvailableLabels[label];
+  }
+
+  for (const auto &boundingBox : boundingBoxes)
+  {
+    itk::ImageRegion<3> region;
+    for (unsigned int dim = 0; dim < 3; ++dim)
+    {
+      region.SetIndex(dim, boundingBox.second.first[dim]);
+      region.SetSize(dim, boundingBox.second.second[dim] - boundingBox.second.first[dim] + 1);
+    }
+    m_LabelRegions[boundingBox.first] = region;
+  }
 }
 
 void mitk::LabelSetImageToSurfaceFilter::GenerateData()
@@ -79,64 +217,88 @@ void mitk::LabelSetImageToSurfaceFilter::GenerateData()
   if (inputImage.IsNull())
     return;
 
-  mitk::Surface *outputSurface = this->GetOutput();
-  if (!outputSurface)
+  if (m_LabelRegions.empty())
+  {
+    if (!m_GenerateAllLabels)
+      itkExceptionMacro("Label " << m_RequestedLabel << " has no voxels, marching cubes has failed.");
+
+    this->GetOutput(0)->SetVtkPolyData(vtkSmartPointer<vtkPolyData>::New(), 0);
     return;
+  }
 
-  AccessFixedDimensionByItk_1(inputImage, InternalProcessing, 3, outputSurface);
+  AccessFixedDimensionByItk(inputImage, InternalProcessing, 3);
 }
 
 template <typename TPixel, unsigned int VDimension>
-void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPixel, VDimension> *input,
-                                                            mitk::Surface * /*surface*/)
+void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPixel, VDimension> *input)
 {
-  typedef itk::Image<TPixel, VDimension> ImageType;
+  // larger labels first, so that a large label does not keep a single thread busy at the end
+  std::vector<unsigned int> outputIndices;
+  for (const auto &indexToLabel : m_IndexToLabels)
+    outputIndices.push_back(indexToLabel.first);
 
-  typedef itk::BinaryThresholdImageFilter<ImageType, ImageType> BinaryThresholdFilterType;
-  typedef itk::LabelObject<TPixel, VDimension> LabelObjectType;
-  typedef itk::LabelMap<LabelObjectType> LabelMapType;
-  typedef itk::LabelImageToLabelMapFilter<ImageType, LabelMapType> Image2LabelMapType;
-  typedef itk::AutoCropLabelMapFilter<LabelMapType> AutoCropType;
-  typedef itk::LabelMapToLabelImageFilter<LabelMapType, ImageType> LabelMap2ImageType;
+  std::stable_sort(outputIndices.begin(), outputIndices.end(), [this](unsigned int a, unsigned int b) {
+    return m_AvailableLabels.at(m_IndexToLabels.at(a)) > m_AvailableLabels.at(m_IndexToLabels.at(b));
+  });
 
-  typedef itk::Image<float, VDimension> RealImageType;
+  // the ITK filters of a label only use several threads if the labels are not processed in parallel
+  const bool singleThreaded = m_NumberOfThreads > 1 && outputIndices.size() > 1;
 
-  typedef itk::AntiAliasBinaryImageFilter<ImageType, RealImageType> AntiAliasFilterType;
-  typedef itk::SmoothingRecursiveGaussianImageFilter<RealImageType, RealImageType> GaussianFilterType;
+  std::mutex outputMutex;
+
+  mitk::RunInParallel(m_NumberOfThreads, outputIndices.size(), [&](std::size_t taskId, std::size_t) {
+    const unsigned int outputIndex = outputIndices[taskId];
+    const LabelType label = m_IndexToLabels.at(outputIndex);
 
-  typename BinaryThresholdFilterType::Pointer thresholdFilter = BinaryThresholdFilterType::New();
-  thresholdFilter->SetInput(input);
-  thresholdFilter->SetLowerThreshold(m_RequestedLabel);
-  thresholdFilter->SetUpperThreshold(m_RequestedLabel);
-  thresholdFilter->SetOutsideValue(0);
-  thresholdFilter->SetInsideValue(1);
-  //  thresholdFilter->ReleaseDataFlagOn();
-  thresholdFilter->Update();
+    vtkSmartPointer<vtkPolyData> polydata =
+      this->ExtractLabelSurface(input, label, m_LabelRegions.at(label), singleThreaded);
 
-  typename Image2LabelMapType::Pointer image2label = Image2LabelMapType::New();
-  image2label->SetInput(thresholdFilter->GetOutput());
+    if (!m_GenerateAllLabels && 0 == polydata->GetNumberOfPoints())
+      throw itk::ExceptionObject(__FILE__, __LINE__, "marching cubes has failed.");
 
-  typename AutoCropType::SizeType border;
-  border[0] = 3;
-  border[1] = 3;
-  border[2] = 3;
+    std::lock_guard<std::mutex> lock(outputMutex);
+    mitk::Surface *output = this->GetOutput(outputIndex);
+    output->SetVtkPolyData(polydata, 0);
+    LabelSurfaceGeneratedEvent.Send(label, output);
+  });
+}
+
+template <typename TPixel, unsigned int VDimension>
+vtkSmartPointer<vtkPolyData> mitk::LabelSetImageToSurfaceFilter::ExtractLabelSurface(
+  const itk::Image<TPixel, VDimension> *input,
+  LabelType label,
+  const itk::ImageRegion<VDimension> &labelRegion,
+  bool singleThreaded)
+{
+  typedef itk::Image<TPixel, VDimension> ImageType;
+  typedef itk::Image<float, VDimension> RealImageType;
+
+  typedef itk::AntiAliasBinaryImageFilter<ImageType, RealImageType> AntiAliasFilterType;
+  typedef itk::SmoothingRecursiveGaussianImageFilter<RealImageType, RealImageType> GaussianFilterType;
 
-  typename AutoCropType::Pointer autoCropFilter = AutoCropType::New();
-  autoCropFilter->SetInput(image2label->GetOutput());
-  autoCropFilter->SetCropBorder(border);
-  autoCropFilter->InPlaceOn();
+  typename ImageType::RegionType cropRegion = labelRegion;
+  cropRegion.PadByRadius(3);
+  cropRegion.Crop(input->GetLargestPossibleRegion());
 
-  typename LabelMap2ImageType::Pointer label2image = LabelMap2ImageType::New();
-  label2image->SetInput(autoCropFilter->GetOutput());
+  // binary image of the label, restricted to its bounding box
+  typename ImageType::Pointer binaryImage = ImageType::New();
+  binaryImage->CopyInformation(input);
+  binaryImage->SetRegions(cropRegion);
+  binaryImage->Allocate();
 
-  label2image->Update();
+  itk::ImageRegionConstIterator<ImageType> inputIt(input, cropRegion);
+  itk::ImageRegionIterator<ImageType> binaryIt(binaryImage, cropRegion);
+  for (; !inputIt.IsAtEnd(); ++inputIt, ++binaryIt)
+    binaryIt.Set(static_cast<LabelType>(inputIt.Get()) == label ? 1 : 0);
 
   typename AntiAliasFilterType::Pointer antiAliasFilter = AntiAliasFilterType::New();
-  antiAliasFilter->SetInput(label2image->GetOutput());
+  antiAliasFilter->SetInput(binaryImage);
   antiAliasFilter->SetMaximumRMSError(0.001);
   antiAliasFilter->SetNumberOfLayers(3);
   antiAliasFilter->SetUseImageSpacing(false);
   antiAliasFilter->SetNumberOfIterations(40);
+  if (singleThreaded)
+    antiAliasFilter->SetNumberOfThreads(1);
 
   antiAliasFilter->Update();
 
@@ -147,6 +309,8 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
     typename GaussianFilterType::Pointer gaussianFilter = GaussianFilterType::New();
     gaussianFilter->SetSigma(m_Sigma);
     gaussianFilter->SetInput(antiAliasFilter->GetOutput());
+    if (singleThreaded)
+      gaussianFilter->SetNumberOfThreads(1);
     gaussianFilter->Update();
     result = gaussianFilter->GetOutput();
   }
@@ -157,21 +321,18 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
 
   result->DisconnectPipeline();
 
-  typename ImageType::RegionType cropRegion;
-  cropRegion = autoCropFilter->GetOutput()->GetLargestPossibleRegion();
-
   const typename ImageType::IndexType &cropIndex = cropRegion.GetIndex();
 
-  m_ResultImage = mitk::Image::New();
-  mitk::CastToMitkImage(result, m_ResultImage);
+  mitk::Image::Pointer resultImage = mitk::Image::New();
+  mitk::CastToMitkImage(result, resultImage);
 
-  mitk::BaseGeometry *newGeometry = m_ResultImage->GetSlicedGeometry();
+  mitk::BaseGeometry *newGeometry = resultImage->GetSlicedGeometry();
   mitk::Point3D origin;
   vtk2itk(cropIndex, origin);
   this->GetInput()->GetGeometry()->IndexToWorld(origin, origin);
   newGeometry->SetOrigin(origin);
 
-  auto *vtkimage = m_ResultImage->GetVtkImageData(0);
+  auto *vtkimage = resultImage->GetVtkImageData(0);
 
   vtkSmartPointer<vtkImageChangeInformation> indexCoordinatesImageFilter =
     vtkSmartPointer<vtkImageChangeInformation>::New();
@@ -190,7 +351,7 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
   vtkPolyData *polydata = marching->GetOutput();
 
   if ((!polydata) || (!polydata->GetNumberOfPoints()))
-    throw itk::ExceptionObject(__FILE__, __LINE__, "marching cubes has failed.");
+    return vtkSmartPointer<vtkPolyData>::New();
 
   mitk::Vector3D spacing = newGeometry->GetSpacing();
 
@@ -223,6 +384,19 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
   cleanPolyDataFilter->PointMergingOn();
   cleanPolyDataFilter->Update();
 
-  mitk::Surface::Pointer output = this->GetOutput(0);
-  output->SetVtkPolyData(cleanPolyDataFilter->GetOutput(), 0);
+  vtkSmartPointer<vtkPolyData> surface = cleanPolyDataFilter->GetOutput();
+
+  if (m_TargetReduction > 0.0)
+  {
+    vtkSmartPointer<vtkDecimatePro> decimate = vtkSmartPointer<vtkDecimatePro>::New();
+    decimate->SplittingOff();
+    decimate->PreserveTopologyOn();
+    decimate->BoundaryVertexDeletionOff();
+    decimate->SetTargetReduction(m_TargetReduction);
+    decimate->SetInputData(surface);
+    decimate->Update();
+    surface = decimate->GetOutput();
+  }
+
+  return surface;
 }
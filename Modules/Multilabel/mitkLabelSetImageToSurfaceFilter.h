@@ -20,20 +20,30 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "MitkMultilabelExports.h"
 #include "mitkLabelSetImage.h"
 #include "mitkSurface.h"
+#include <mitkMessage.h>
 #include <mitkSurfaceSource.h>
 
 #include <vtkMatrix4x4.h>
+#include <vtkSmartPointer.h>
 
 #include <itkImage.h>
 
 #include <map>
 
+class vtkPolyData;
+
 namespace mitk
 {
   /**
    * Generates surface meshes from a labelset image.
    * If you want to calculate a surface representation for all available labels,
    * you may call GenerateAllLabelsOn().
+   *
+   * All labels are extracted from the same input in one update: the bounding boxes of the labels are determined
+   * first, taken from the label index of a mitk::LabelSetImage or by a single pass over any other image. Each label
+   * is then anti-aliased, smoothed, meshed and decimated within its bounding box only. The labels are distributed
+   * over NumberOfThreads threads, larger labels first. There is one output per label, see GetLabelForNthOutput();
+   * LabelSurfaceGeneratedEvent is sent as soon as the surface of a label is ready.
    */
   class MITKMULTILABEL_EXPORT LabelSetImageToSurfaceFilter : public SurfaceSource
   {
@@ -48,6 +58,16 @@ namespace mitk
 
     typedef std::map<unsigned int, LabelType> IndexToLabelMapType;
 
+    typedef std::map<LabelType, itk::ImageRegion<3>> LabelRegionMapType;
+
+    /**
+     * \brief Sent from a worker thread of GenerateData() whenever the surface of a label has been generated.
+     *
+     * The surface is the output of the filter for that label. Observers are called one at a time, but not from the
+     * thread that called Update(); they must not modify the filter.
+     */
+    Message2<LabelType, mitk::Surface *> LabelSurfaceGeneratedEvent;
+
     /**
     * Returns a const pointer to the labelset image set as input
     */
@@ -109,6 +129,24 @@ namespace mitk
      */
     itkSetMacro(Sigma, float);
 
+    /**
+     * Sets the fraction of triangles that is removed from each surface by vtkDecimatePro,
+     * 0 (the default) disables the decimation
+     */
+    itkSetClampMacro(TargetReduction, float, 0.0f, 1.0f);
+    itkGetMacro(TargetReduction, float);
+
+    /**
+     * Sets the number of threads the labels are distributed over, by default the global default of ITK
+     */
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetMacro(NumberOfThreads, unsigned int);
+
+    /**
+     * Returns the label of the surface in the output with the given index
+     */
+    LabelType GetLabelForNthOutput(unsigned int idx) const;
+
   protected:
     LabelSetImageToSurfaceFilter();
 
@@ -128,10 +166,25 @@ namespace mitk
       out[2] = z;
     }
 
-    mitk::Image::Pointer m_ResultImage;
+    /**
+    * Determines the labels to extract, their number of voxels and their bounding boxes
+    */
+    void ComputeLabelRegions();
+
+    template <typename TPixel, unsigned int VImageDimension>
+    void ComputeLabelRegionsProcessing(const itk::Image<TPixel, VImageDimension> *input);
+
+    template <typename TPixel, unsigned int VImageDimension>
+    void InternalProcessing(const itk::Image<TPixel, VImageDimension> *input);
 
+    /**
+    * Creates the surface of a label from the voxels within labelRegion and a border of three voxels
+    */
     template <typename TPixel, unsigned int VImageDimension>
-    void InternalProcessing(const itk::Image<TPixel, VImageDimension> *input, mitk::Surface *surface);
+    vtkSmartPointer<vtkPolyData> ExtractLabelSurface(const itk::Image<TPixel, VImageDimension> *input,
+                                                     LabelType label,
+                                                     const itk::ImageRegion<VImageDimension> &labelRegion,
+                                                     bool singleThreaded);
 
     bool m_GenerateAllLabels;
 
@@ -143,8 +196,14 @@ namespace mitk
 
     float m_Sigma;
 
+    float m_TargetReduction;
+
+    unsigned int m_NumberOfThreads;
+
     LabelMapType m_AvailableLabels;
 
+    LabelRegionMapType m_LabelRegions;
+
     IndexToLabelMapType m_IndexToLabels;
 
     mitk::Vector3D m_InputImageSpacing;
@@ -19,9 +19,16 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkLabelSetImage.h"
 #include "mitkLabelSetImageToSurfaceFilter.h"
 
+#include <mitkCallbackFromGUIThread.h>
+
+#include <itkCommand.h>
+
+#include <vtkPolyData.h>
+
 namespace mitk
 {
-  LabelSetImageToSurfaceThreadedFilter::LabelSetImageToSurfaceThreadedFilter() : m_RequestedLabel(1), m_Result(nullptr)
+  LabelSetImageToSurfaceThreadedFilter::LabelSetImageToSurfaceThreadedFilter()
+    : m_RequestedLabel(1), m_GenerateAllLabels(false), m_Result(nullptr)
   {
   }
 
@@ -74,13 +81,30 @@ namespace mitk
       MITK_WARN << "\"RequestedLabel\" parameter was not set: will use the default value (" << m_RequestedLabel << ").";
     }
 
+    m_GenerateAllLabels = false;
+    try
+    {
+      this->GetParameter("GenerateAllLabels", m_GenerateAllLabels);
+    }
+    catch (std::invalid_argument &)
+    {
+      // optional parameter, only a single label is extracted by default
+    }
+
     mitk::LabelSetImageToSurfaceFilter::Pointer filter = mitk::LabelSetImageToSurfaceFilter::New();
     filter->SetInput(image);
     //  filter->SetObserver(obsv);
-    filter->SetGenerateAllLabels(false);
+    filter->SetGenerateAllLabels(m_GenerateAllLabels);
     filter->SetRequestedLabel(m_RequestedLabel);
     filter->SetUseSmoothing(useSmoothing);
 
+    if (m_GenerateAllLabels)
+    {
+      filter->LabelSurfaceGeneratedEvent +=
+        MessageDelegate2<LabelSetImageToSurfaceThreadedFilter, Label::PixelType, Surface *>(
+          this, &LabelSetImageToSurfaceThreadedFilter::OnLabelSurfaceGenerated);
+    }
+
     try
     {
       filter->Update();
@@ -101,6 +125,9 @@ namespace mitk
       return false;
     }
 
+    if (m_GenerateAllLabels)
+      return true;
+
     m_Result = filter->GetOutput();
 
     if (m_Result.IsNull() || !m_Result->GetVtkPolyData())
@@ -113,22 +140,77 @@ namespace mitk
 
   void LabelSetImageToSurfaceThreadedFilter::ThreadedUpdateSuccessful()
   {
+    if (m_GenerateAllLabels)
+    {
+      // surfaces not yet inserted by the callbacks from the filter threads
+      this->InsertGeneratedSurfaces(itk::NoEvent());
+    }
+    else
+    {
+      std::string name = this->GetGroupNode()->GetName();
+      name.append("-surf");
+      this->InsertSurface(m_RequestedLabel, m_Result, name);
+    }
+
+    Superclass::ThreadedUpdateSuccessful();
+  }
+
+  void LabelSetImageToSurfaceThreadedFilter::OnLabelSurfaceGenerated(Label::PixelType label, Surface *surface)
+  {
+    if (nullptr == surface->GetVtkPolyData() || 0 == surface->GetVtkPolyData()->GetNumberOfPoints())
+      return;
+
+    // the filter output is overwritten by the next update, the data node only shares the mesh
+    Surface::Pointer result = Surface::New();
+    result->SetVtkPolyData(surface->GetVtkPolyData());
+
+    {
+      std::lock_guard<std::mutex> lock(m_GeneratedSurfacesMutex);
+      m_GeneratedSurfaces.emplace_back(label, result);
+    }
+
+    itk::ReceptorMemberCommand<LabelSetImageToSurfaceThreadedFilter>::Pointer command =
+      itk::ReceptorMemberCommand<LabelSetImageToSurfaceThreadedFilter>::New();
+    command->SetCallbackFunction(this, &LabelSetImageToSurfaceThreadedFilter::InsertGeneratedSurfaces);
+    CallbackFromGUIThread::GetInstance()->CallThisFromGUIThread(command);
+  }
+
+  void LabelSetImageToSurfaceThreadedFilter::InsertGeneratedSurfaces(const itk::EventObject &)
+  {
+    std::vector<std::pair<Label::PixelType, Surface::Pointer>> surfaces;
+    {
+      std::lock_guard<std::mutex> lock(m_GeneratedSurfacesMutex);
+      surfaces.swap(m_GeneratedSurfaces);
+    }
+
     LabelSetImage::Pointer image;
     this->GetPointerParameter("Input", image);
 
-    std::string name = this->GetGroupNode()->GetName();
-    name.append("-surf");
+    for (const auto &surface : surfaces)
+    {
+      std::string name = this->GetGroupNode()->GetName();
+      mitk::Label *label = image->GetLabel(surface.first, image->GetActiveLayer());
+      name.append("-").append(nullptr != label ? label->GetName() : std::to_string(surface.first)).append("-surf");
+      this->InsertSurface(surface.first, surface.second, name);
+    }
+  }
+
+  void LabelSetImageToSurfaceThreadedFilter::InsertSurface(Label::PixelType pixelValue,
+                                                           Surface *surface,
+                                                           const std::string &name)
+  {
+    LabelSetImage::Pointer image;
+    this->GetPointerParameter("Input", image);
 
     mitk::DataNode::Pointer node = mitk::DataNode::New();
-    node->SetData(m_Result);
+    node->SetData(surface);
     node->SetName(name);
 
-    mitk::Color color = image->GetLabel(m_RequestedLabel, image->GetActiveLayer())->GetColor();
-    node->SetColor(color);
+    mitk::Label *label = image->GetLabel(pixelValue, image->GetActiveLayer());
+    if (nullptr != label)
+      node->SetColor(label->GetColor());
 
     this->InsertBelowGroupNode(node);
-
-    Superclass::ThreadedUpdateSuccessful();
   }
 
 } // namespace
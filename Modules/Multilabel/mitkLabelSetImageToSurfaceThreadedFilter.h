@@ -17,12 +17,22 @@ See LICENSE.txt or http://www.mitk.org for details.
 #ifndef __mitkLabelSetImageToSurfaceThreadedFilter_H_
 #define __mitkLabelSetImageToSurfaceThreadedFilter_H_
 
+#include "mitkLabel.h"
 #include "mitkSegmentationSink.h"
 #include "mitkSurface.h"
 #include <MitkMultilabelExports.h>
 
+#include <mutex>
+#include <utility>
+#include <vector>
+
 namespace mitk
 {
+  /**
+   * Creates the surface of a label of the "Input" labelset image in a background thread and inserts it below the
+   * "Group node". If the bool parameter "GenerateAllLabels" is true, surfaces of all labels of the active layer are
+   * created in one pass; each one is inserted as soon as it is ready, while the other labels are still processed.
+   */
   class MITKMULTILABEL_EXPORT LabelSetImageToSurfaceThreadedFilter : public SegmentationSink
   {
   public:
@@ -41,8 +51,20 @@ namespace mitk
     void ThreadedUpdateSuccessful() override; // will be called from a thread after calling StartAlgorithm
 
   private:
+    /** Called from the threads of LabelSetImageToSurfaceFilter whenever the surface of a label is ready */
+    void OnLabelSurfaceGenerated(Label::PixelType label, Surface *surface);
+
+    /** Inserts the surfaces generated so far, called from the GUI thread */
+    void InsertGeneratedSurfaces(const itk::EventObject &);
+
+    void InsertSurface(Label::PixelType pixelValue, Surface *surface, const std::string &name);
+
     int m_RequestedLabel;
+    bool m_GenerateAllLabels;
     Surface::Pointer m_Result;
+
+    std::vector<std::pair<Label::PixelType, Surface::Pointer>> m_GeneratedSurfaces;
+    std::mutex m_GeneratedSurfacesMutex;
   };
 
 } // namespace
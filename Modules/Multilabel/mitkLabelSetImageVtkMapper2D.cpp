@@ -53,9 +53,50 @@ See LICENSE.txt or http://www.mitk.org for details.
 //#include <vtkOpenGLTexture.h>
 
 // ITK
+#include <itkMath.h>
 #include <itkRGBAPixel.h>
 #include <mitkRenderingModeProperty.h>
 
+namespace
+{
+  /** Decodes only the displayed slice of a run-length encoded layer. Returns nullptr if the layer is not run-length
+   * encoded or the plane is not parallel to the slices along one of the image axes. */
+  mitk::Image::Pointer GetSparseLayerSlice(const mitk::LabelSetImage *image,
+                                           unsigned int layer,
+                                           const mitk::PlaneGeometry *plane,
+                                           unsigned int timeStep)
+  {
+    if (!image->IsLayerSparse(layer) || !image->GetTimeGeometry()->IsValidTimeStep(timeStep))
+      return nullptr;
+
+    const mitk::BaseGeometry *geometry = image->GetGeometry(timeStep);
+
+    mitk::Vector3D normal = plane->GetNormal();
+    normal.Normalize();
+
+    for (unsigned int axis = 0; axis < 3; ++axis)
+    {
+      mitk::Vector3D axisVector = geometry->GetAxisVector(axis);
+      axisVector.Normalize();
+
+      if (std::abs(normal * axisVector) < 1.0 - mitk::eps)
+        continue;
+
+      // nearest neighbor reslicing picks the slice closest to the plane
+      mitk::Point3D index;
+      geometry->WorldToIndex(plane->GetCenter(), index);
+      const int sliceIndex = itk::Math::Round<int>(index[axis]);
+
+      if (sliceIndex < 0 || sliceIndex >= static_cast<int>(image->GetDimension(axis)))
+        return nullptr;
+
+      return image->GetSparseLayerSlice(layer, axis, sliceIndex, timeStep);
+    }
+
+    return nullptr;
+  }
+}
+
 mitk::LabelSetImageVtkMapper2D::LabelSetImageVtkMapper2D()
 {
 }
@@ -149,21 +190,31 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
 
   for (int lidx = 0; lidx < numberOfLayers; ++lidx)
   {
-    mitk::Image *layerImage = nullptr;
+    mitk::Image::Pointer layerImage;
+    unsigned int layerTimeStep = this->GetTimestep();
 
     // set main input for ExtractSliceFilter
     if (lidx == activeLayer)
+    {
       layerImage = image;
+    }
     else
-      layerImage = image->GetLayerImage(lidx);
+    {
+      layerImage = ::GetSparseLayerSlice(image, lidx, worldGeometry, layerTimeStep);
+
+      if (layerImage.IsNotNull())
+        layerTimeStep = 0; // the slice only consists of the current time step
+      else
+        layerImage = image->GetLayerImage(lidx);
+    }
 
     localStorage->m_ReslicerVector[lidx]->SetInput(layerImage);
     localStorage->m_ReslicerVector[lidx]->SetWorldGeometry(worldGeometry);
-    localStorage->m_ReslicerVector[lidx]->SetTimeStep(this->GetTimestep());
+    localStorage->m_ReslicerVector[lidx]->SetTimeStep(layerTimeStep);
 
     // set the transformation of the image to adapt reslice axis
     localStorage->m_ReslicerVector[lidx]->SetResliceTransformByGeometry(
-      layerImage->GetTimeGeometry()->GetGeometryForTimeStep(this->GetTimestep()));
+      layerImage->GetTimeGeometry()->GetGeometryForTimeStep(layerTimeStep));
 
     // is the geometry of the slice based on the image image or the worldgeometry?
     bool inPlaneResampleExtentByGeometry = false;
@@ -0,0 +1,338 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkRunLengthEncodedLabelLayer.h"
+
+#include <mitkExceptionMacro.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <algorithm>
+#include <iterator>
+
+mitk::RunLengthEncodedLabelLayer::RunLengthEncodedLabelLayer() : m_Dimension(0)
+{
+  std::fill_n(m_Dimensions, 4, 0);
+}
+
+mitk::RunLengthEncodedLabelLayer::RunLengthEncodedLabelLayer(const RunLengthEncodedLabelLayer &other)
+  : itk::Object(), m_Dimension(other.m_Dimension), m_Rows(other.m_Rows), m_LabelRows(other.m_LabelRows)
+{
+  std::copy_n(other.m_Dimensions, 4, m_Dimensions);
+}
+
+mitk::RunLengthEncodedLabelLayer::~RunLengthEncodedLabelLayer()
+{
+}
+
+std::size_t mitk::RunLengthEncodedLabelLayer::GetRowIndex(unsigned int y, unsigned int z, unsigned int t) const
+{
+  return y + static_cast<std::size_t>(m_Dimensions[1]) * (z + static_cast<std::size_t>(m_Dimensions[2]) * t);
+}
+
+void mitk::RunLengthEncodedLabelLayer::Encode(const mitk::Image *image)
+{
+  if (nullptr == image || image->GetDimension() < 2 || image->GetDimension() > 4 ||
+      image->GetPixelType() != mitk::MakeScalarPixelType<PixelType>())
+  {
+    mitkThrow() << "Only images of two to four dimensions with the pixel type of labels can be run-length encoded.";
+  }
+
+  m_Dimension = image->GetDimension();
+  for (unsigned int dim = 0; dim < 4; ++dim)
+    m_Dimensions[dim] = dim < m_Dimension ? image->GetDimension(dim) : 1;
+
+  const std::size_t numberOfRows = static_cast<std::size_t>(m_Dimensions[1]) * m_Dimensions[2] * m_Dimensions[3];
+  m_Rows.assign(numberOfRows, RowType());
+  m_LabelRows.clear();
+
+  mitk::ImageReadAccessor accessor(image);
+  auto data = static_cast<const PixelType *>(accessor.GetData());
+
+  for (std::size_t rowIndex = 0; rowIndex < numberOfRows; ++rowIndex)
+  {
+    const PixelType *line = data + rowIndex * m_Dimensions[0];
+    RowType &row = m_Rows[rowIndex];
+
+    unsigned int x = 0;
+    while (x < m_Dimensions[0])
+    {
+      const PixelType value = line[x];
+      unsigned int end = x + 1;
+      while (end < m_Dimensions[0] && line[end] == value)
+        ++end;
+
+      if (0 != value)
+      {
+        row.push_back({x, end - x, value});
+
+        // rows are visited in ascending order, so the row indices of each label stay sorted
+        RowIndicesType &labelRows = m_LabelRows[value];
+        if (labelRows.empty() || labelRows.back() != rowIndex)
+          labelRows.push_back(rowIndex);
+      }
+
+      x = end;
+    }
+
+    row.shrink_to_fit();
+  }
+
+  this->Modified();
+}
+
+void mitk::RunLengthEncodedLabelLayer::DecodeRow(const RowType &row, PixelType *line) const
+{
+  std::fill_n(line, m_Dimensions[0], 0);
+  for (const auto &run : row)
+    std::fill_n(line + run.m_Start, run.m_Length, run.m_Value);
+}
+
+void mitk::RunLengthEncodedLabelLayer::Decode(mitk::Image *image) const
+{
+  if (nullptr == image || image->GetDimension() != m_Dimension ||
+      image->GetPixelType() != mitk::MakeScalarPixelType<PixelType>())
+  {
+    mitkThrow() << "Run-length encoded layer can not be decoded into an image of different type or dimension.";
+  }
+
+  for (unsigned int dim = 0; dim < m_Dimension; ++dim)
+  {
+    if (image->GetDimension(dim) != m_Dimensions[dim])
+      mitkThrow() << "Run-length encoded layer can not be decoded into an image of different size.";
+  }
+
+  mitk::ImageWriteAccessor accessor(image);
+  auto data = static_cast<PixelType *>(accessor.GetData());
+
+  for (std::size_t rowIndex = 0; rowIndex < m_Rows.size(); ++rowIndex)
+    this->DecodeRow(m_Rows[rowIndex], data + rowIndex * m_Dimensions[0]);
+}
+
+void mitk::RunLengthEncodedLabelLayer::DecodeSlice(unsigned int axis,
+                                                   unsigned int sliceIndex,
+                                                   unsigned int timeStep,
+                                                   PixelType *buffer) const
+{
+  if (axis > 2 || sliceIndex >= m_Dimensions[axis] || timeStep >= m_Dimensions[3] || nullptr == buffer)
+    mitkThrow() << "Invalid slice " << sliceIndex << " along axis " << axis << " of time step " << timeStep << ".";
+
+  switch (axis)
+  {
+    case 2: // rows of the slice are consecutive rows of the layer
+      for (unsigned int y = 0; y < m_Dimensions[1]; ++y)
+        this->DecodeRow(m_Rows[this->GetRowIndex(y, sliceIndex, timeStep)], buffer + y * m_Dimensions[0]);
+      break;
+
+    case 1:
+      for (unsigned int z = 0; z < m_Dimensions[2]; ++z)
+        this->DecodeRow(m_Rows[this->GetRowIndex(sliceIndex, z, timeStep)], buffer + z * m_Dimensions[0]);
+      break;
+
+    default: // each row of the layer contributes a single voxel
+      for (unsigned int z = 0; z < m_Dimensions[2]; ++z)
+      {
+        for (unsigned int y = 0; y < m_Dimensions[1]; ++y)
+          buffer[z * m_Dimensions[1] + y] = this->GetValue(m_Rows[this->GetRowIndex(y, z, timeStep)], sliceIndex);
+      }
+      break;
+  }
+}
+
+mitk::RunLengthEncodedLabelLayer::PixelType mitk::RunLengthEncodedLabelLayer::GetValue(const RowType &row,
+                                                                                      unsigned int x) const
+{
+  // first run that starts behind x, the run before it is the only one that may contain x
+  auto iter = std::upper_bound(
+    row.begin(), row.end(), x, [](unsigned int value, const Run &run) { return value < run.m_Start; });
+
+  if (iter == row.begin())
+    return 0;
+
+  --iter;
+  return x < iter->m_Start + iter->m_Length ? iter->m_Value : 0;
+}
+
+mitk::RunLengthEncodedLabelLayer::PixelType mitk::RunLengthEncodedLabelLayer::GetValue(const IndexType &index) const
+{
+  for (unsigned int dim = 0; dim < 4; ++dim)
+  {
+    if (index[dim] < 0 || static_cast<unsigned int>(index[dim]) >= m_Dimensions[dim])
+      mitkThrow() << "Index " << index << " is outside of the run-length encoded layer.";
+  }
+
+  return this->GetValue(m_Rows[this->GetRowIndex(index[1], index[2], index[3])], index[0]);
+}
+
+const unsigned int *mitk::RunLengthEncodedLabelLayer::GetDimensions() const
+{
+  return m_Dimensions;
+}
+
+bool mitk::RunLengthEncodedLabelLayer::ExistLabel(PixelType pixelValue) const
+{
+  return 0 != this->GetNumberOfVoxels(pixelValue);
+}
+
+std::size_t mitk::RunLengthEncodedLabelLayer::GetNumberOfVoxels(PixelType pixelValue) const
+{
+  if (0 == pixelValue)
+  {
+    std::size_t numberOfLabeledVoxels = 0;
+    for (const auto &row : m_Rows)
+    {
+      for (const auto &run : row)
+        numberOfLabeledVoxels += run.m_Length;
+    }
+
+    return m_Rows.size() * m_Dimensions[0] - numberOfLabeledVoxels;
+  }
+
+  auto labelRows = m_LabelRows.find(pixelValue);
+  if (labelRows == m_LabelRows.end())
+    return 0;
+
+  std::size_t numberOfVoxels = 0;
+  for (auto rowIndex : labelRows->second)
+  {
+    for (const auto &run : m_Rows[rowIndex])
+    {
+      if (run.m_Value == pixelValue)
+        numberOfVoxels += run.m_Length;
+    }
+  }
+
+  return numberOfVoxels;
+}
+
+void mitk::RunLengthEncodedLabelLayer::MergeLabel(PixelType pixelValue, PixelType sourcePixelValue)
+{
+  if (pixelValue == sourcePixelValue)
+    return;
+
+  if (0 == pixelValue)
+  {
+    this->EraseLabel(sourcePixelValue);
+    return;
+  }
+
+  auto sourceRows = m_LabelRows.find(sourcePixelValue);
+  if (sourceRows == m_LabelRows.end())
+    return;
+
+  for (auto rowIndex : sourceRows->second)
+  {
+    RowType &row = m_Rows[rowIndex];
+    for (auto &run : row)
+    {
+      if (run.m_Value == sourcePixelValue)
+        run.m_Value = pixelValue;
+    }
+
+    // join neighbouring runs that have the same label now
+    RowType merged;
+    merged.reserve(row.size());
+    for (const auto &run : row)
+    {
+      if (!merged.empty() && merged.back().m_Value == run.m_Value &&
+          merged.back().m_Start + merged.back().m_Length == run.m_Start)
+      {
+        merged.back().m_Length += run.m_Length;
+      }
+      else
+      {
+        merged.push_back(run);
+      }
+    }
+    merged.shrink_to_fit();
+    row.swap(merged);
+  }
+
+  RowIndicesType &targetRows = m_LabelRows[pixelValue];
+  RowIndicesType mergedRows;
+  mergedRows.reserve(targetRows.size() + sourceRows->second.size());
+  std::set_union(targetRows.begin(),
+                 targetRows.end(),
+                 sourceRows->second.begin(),
+                 sourceRows->second.end(),
+                 std::back_inserter(mergedRows));
+  targetRows.swap(mergedRows);
+
+  m_LabelRows.erase(sourceRows);
+  this->Modified();
+}
+
+void mitk::RunLengthEncodedLabelLayer::EraseLabel(PixelType pixelValue)
+{
+  auto labelRows = m_LabelRows.find(pixelValue);
+  if (labelRows == m_LabelRows.end())
+    return;
+
+  for (auto rowIndex : labelRows->second)
+  {
+    RowType &row = m_Rows[rowIndex];
+    row.erase(std::remove_if(row.begin(), row.end(), [pixelValue](const Run &run) { return run.m_Value == pixelValue; }),
+              row.end());
+    row.shrink_to_fit();
+  }
+
+  m_LabelRows.erase(labelRows);
+  this->Modified();
+}
+
+bool mitk::RunLengthEncodedLabelLayer::GetCenterVoxelIndex(PixelType pixelValue, IndexType &index) const
+{
+  auto labelRows = m_LabelRows.find(pixelValue);
+  if (0 == pixelValue || labelRows == m_LabelRows.end())
+    return false;
+
+  // Rows are sorted and runs within a row as well, so this is the raster order of the voxels
+  std::size_t remainingVoxels = this->GetNumberOfVoxels(pixelValue) / 2;
+  for (auto rowIndex : labelRows->second)
+  {
+    for (const auto &run : m_Rows[rowIndex])
+    {
+      if (run.m_Value != pixelValue)
+        continue;
+
+      if (remainingVoxels < run.m_Length)
+      {
+        index[0] = run.m_Start + remainingVoxels;
+        index[1] = rowIndex % m_Dimensions[1];
+        index[2] = (rowIndex / m_Dimensions[1]) % m_Dimensions[2];
+        index[3] = rowIndex / (static_cast<std::size_t>(m_Dimensions[1]) * m_Dimensions[2]);
+        return true;
+      }
+
+      remainingVoxels -= run.m_Length;
+    }
+  }
+
+  return false;
+}
+
+std::size_t mitk::RunLengthEncodedLabelLayer::GetMemorySize() const
+{
+  std::size_t memorySize = sizeof(*this) + m_Rows.capacity() * sizeof(RowType);
+
+  for (const auto &row : m_Rows)
+    memorySize += row.capacity() * sizeof(Run);
+
+  for (const auto &labelRows : m_LabelRows)
+    memorySize += sizeof(labelRows) + labelRows.second.capacity() * sizeof(std::size_t);
+
+  return memorySize;
+}
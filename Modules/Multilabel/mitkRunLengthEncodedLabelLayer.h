@@ -0,0 +1,157 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __mitkRunLengthEncodedLabelLayer_H_
+#define __mitkRunLengthEncodedLabelLayer_H_
+
+#include "MitkMultilabelExports.h"
+
+#include <mitkCommon.h>
+#include <mitkImage.h>
+#include <mitkLabel.h>
+
+#include <itkIndex.h>
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+
+#include <map>
+#include <vector>
+
+namespace mitk
+{
+  /**
+  * \brief Run-length encoded storage of a label image layer.
+  *
+  * Each image row, i.e. all voxels along the first image axis with equal y, z and t index, is stored as a list
+  * of runs of equal label values. Background voxels (value 0) are not stored at all, so a layer needs memory
+  * in the order of the label boundaries instead of the image size.
+  *
+  * In addition, the rows that contain a label are indexed per label. Label-wise operations like MergeLabel(),
+  * EraseLabel() and GetCenterVoxelIndex() therefore only visit the runs of the label in question.
+  *
+  * mitk::LabelSetImage uses this class to keep its inactive layers if sparse layer storage is enabled.
+  *
+  * \ingroup Data
+  */
+  class MITKMULTILABEL_EXPORT RunLengthEncodedLabelLayer : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(RunLengthEncodedLabelLayer, itk::Object);
+    itkNewMacro(Self);
+
+    typedef mitk::Label::PixelType PixelType;
+    typedef itk::Index<4> IndexType;
+
+    /**
+    * \brief Encodes an image with two to four dimensions and the pixel type mitk::Label::PixelType.
+    *
+    * Throws an mitk::Exception for other images.
+    */
+    void Encode(const mitk::Image *image);
+
+    /**
+    * \brief Writes the layer into an image of the same size and pixel type, e.g. the one it was encoded from.
+    */
+    void Decode(mitk::Image *image) const;
+
+    /**
+    * \brief Writes one slice of a time step into buffer.
+    *
+    * \param axis the image axis perpendicular to the slice
+    * \param sliceIndex the index of the slice along axis
+    * \param timeStep the time step of the slice
+    * \param buffer receives the voxels of the slice in raster order of the two remaining axes; it has to hold
+    *        as many values as the slice has voxels
+    */
+    void DecodeSlice(unsigned int axis, unsigned int sliceIndex, unsigned int timeStep, PixelType *buffer) const;
+
+    /**
+    * \brief Returns the label value of a voxel; unused dimensions of index have to be zero.
+    */
+    PixelType GetValue(const IndexType &index) const;
+
+    /**
+    * \brief Returns the size of the encoded image in all four dimensions; unused dimensions have the size one.
+    */
+    const unsigned int *GetDimensions() const;
+
+    /**
+    * \brief Returns true if at least one voxel has the given label value.
+    */
+    bool ExistLabel(PixelType pixelValue) const;
+
+    /**
+    * \brief Returns the number of voxels with the given label value.
+    */
+    std::size_t GetNumberOfVoxels(PixelType pixelValue) const;
+
+    /**
+    * \brief Assigns all voxels of the label sourcePixelValue to the label pixelValue.
+    */
+    void MergeLabel(PixelType pixelValue, PixelType sourcePixelValue);
+
+    /**
+    * \brief Assigns all voxels of the label pixelValue to the background.
+    */
+    void EraseLabel(PixelType pixelValue);
+
+    /**
+    * \brief Retrieves the voxel in the middle of all voxels of a label in raster order, which is the voxel
+    * mitk::LabelSetImage::UpdateCenterOfMass() uses as center of mass.
+    *
+    * \return false if no voxel has the given label value
+    */
+    bool GetCenterVoxelIndex(PixelType pixelValue, IndexType &index) const;
+
+    /**
+    * \brief Returns the approximate number of bytes allocated for the layer.
+    */
+    std::size_t GetMemorySize() const;
+
+  protected:
+    mitkCloneMacro(Self)
+
+    RunLengthEncodedLabelLayer();
+    RunLengthEncodedLabelLayer(const RunLengthEncodedLabelLayer &other);
+    ~RunLengthEncodedLabelLayer() override;
+
+  private:
+    /** Voxels [m_Start, m_Start + m_Length) of a row that have the label m_Value */
+    struct Run
+    {
+      unsigned int m_Start;
+      unsigned int m_Length;
+      PixelType m_Value;
+    };
+
+    typedef std::vector<Run> RowType;
+
+    /** Sorted indices of the rows that contain a label */
+    typedef std::vector<std::size_t> RowIndicesType;
+
+    std::size_t GetRowIndex(unsigned int y, unsigned int z, unsigned int t) const;
+    PixelType GetValue(const RowType &row, unsigned int x) const;
+    void DecodeRow(const RowType &row, PixelType *line) const;
+
+    unsigned int m_Dimension;
+    unsigned int m_Dimensions[4];
+
+    std::vector<RowType> m_Rows;
+    std::map<PixelType, RowIndicesType> m_LabelRows;
+  };
+} // namespace mitk
+
+#endif // __mitkRunLengthEncodedLabelLayer_H_
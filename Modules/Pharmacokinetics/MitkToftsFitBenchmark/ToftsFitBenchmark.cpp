@@ -0,0 +1,239 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "itkImage.h"
+#include "itkImageRegionConstIterator.h"
+
+#include <mitkCommandLineParser.h>
+#include "mitkImage.h"
+#include "mitkImageCast.h"
+#include "mitkImagePixelReadAccessor.h"
+
+#include "mitkPixelBasedParameterFitImageGenerator.h"
+#include "mitkLevenbergMarquardtModelFitFunctor.h"
+#include "mitkStandardToftsModel.h"
+#include "mitkStandardToftsModelParameterizer.h"
+
+namespace
+{
+  const unsigned int NumberOfFrames = 30;
+  const double FrameDuration = 4.0;
+
+  mitk::ModelBase::TimeGridType GenerateTimeGrid()
+  {
+    mitk::ModelBase::TimeGridType grid(NumberOfFrames);
+    for (unsigned int i = 0; i < NumberOfFrames; ++i)
+    {
+      grid[i] = FrameDuration * i;
+    }
+    return grid;
+  }
+
+  /** Gamma variate shaped bolus that arrives after 8 s.*/
+  mitk::AIFBasedModelBase::AterialInputFunctionType GenerateAIF(const mitk::ModelBase::TimeGridType& grid)
+  {
+    mitk::AIFBasedModelBase::AterialInputFunctionType aif(grid.GetSize());
+    for (unsigned int i = 0; i < grid.GetSize(); ++i)
+    {
+      const double t = std::max(0.0, grid[i] - 8.0);
+      aif[i] = 0.05 * t * t * std::exp(-t / 6.0);
+    }
+    return aif;
+  }
+
+  /** Generates a 3D+t concentration image of Tofts curves. Ktrans varies along x, ve along y,
+   * every slice adds some heterogeneity, so that the voxels need different numbers of iterations.*/
+  mitk::Image::Pointer GenerateToftsImage(const mitk::ModelBase::TimeGridType& grid,
+    const mitk::AIFBasedModelBase::AterialInputFunctionType& aif, unsigned int size, unsigned int slices)
+  {
+    typedef itk::Image<double, 4> DynamicImageType;
+
+    DynamicImageType::Pointer itkImage = DynamicImageType::New();
+    DynamicImageType::SizeType imageSize;
+    imageSize[0] = size;
+    imageSize[1] = size;
+    imageSize[2] = slices;
+    imageSize[3] = NumberOfFrames;
+    itkImage->SetRegions(imageSize);
+    itkImage->Allocate();
+
+    mitk::StandardToftsModel::Pointer model = mitk::StandardToftsModel::New();
+    model->SetTimeGrid(grid);
+    model->SetAterialInputFunctionValues(aif);
+    model->SetAterialInputFunctionTimeGrid(grid);
+
+    mitk::ModelBase::ParametersType parameters(model->GetNumberOfParameters());
+    DynamicImageType::IndexType index;
+    for (unsigned int z = 0; z < slices; ++z)
+    {
+      for (unsigned int y = 0; y < size; ++y)
+      {
+        for (unsigned int x = 0; x < size; ++x)
+        {
+          parameters[mitk::StandardToftsModel::POSITION_PARAMETER_Ktrans] = 2.0 + 30.0 * x / size + z;
+          parameters[mitk::StandardToftsModel::POSITION_PARAMETER_ve] = 0.05 + 0.6 * y / size;
+
+          const mitk::ModelBase::ModelResultType signal = model->GetSignal(parameters);
+
+          index[0] = x;
+          index[1] = y;
+          index[2] = z;
+          for (unsigned int t = 0; t < NumberOfFrames; ++t)
+          {
+            index[3] = t;
+            itkImage->SetPixel(index, signal[t]);
+          }
+        }
+      }
+    }
+
+    mitk::Image::Pointer image;
+    mitk::CastToMitkImage(itkImage, image);
+    return image;
+  }
+
+  mitk::Image::Pointer Fit(mitk::Image* dynamicImage, const mitk::ModelBase::TimeGridType& grid,
+    const mitk::AIFBasedModelBase::AterialInputFunctionType& aif, unsigned int numberOfThreads,
+    unsigned int chunkSize, double& seconds)
+  {
+    mitk::StandardToftsModelParameterizer::Pointer parameterizer = mitk::StandardToftsModelParameterizer::New();
+    parameterizer->SetAIF(aif);
+    parameterizer->SetAIFTimeGrid(grid);
+    parameterizer->SetDefaultTimeGrid(grid);
+
+    mitk::LevenbergMarquardtModelFitFunctor::Pointer fitFunctor = mitk::LevenbergMarquardtModelFitFunctor::New();
+
+    mitk::PixelBasedParameterFitImageGenerator::Pointer generator = mitk::PixelBasedParameterFitImageGenerator::New();
+    generator->SetDynamicImage(dynamicImage);
+    generator->SetModelParameterizer(parameterizer);
+    generator->SetFitFunctor(fitFunctor);
+    generator->TimeGridByParameterizerOn();
+    generator->SetNumberOfThreads(numberOfThreads);
+    generator->SetChunkSize(chunkSize);
+
+    const auto start = std::chrono::steady_clock::now();
+    generator->Generate();
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return generator->GetParameterImages()["Ktrans"];
+  }
+
+  bool AreEqual(mitk::Image* reference, mitk::Image* test)
+  {
+    mitk::ImagePixelReadAccessor<mitk::ScalarType, 3> referenceAccessor(reference);
+    mitk::ImagePixelReadAccessor<mitk::ScalarType, 3> testAccessor(test);
+
+    const unsigned int numberOfPixels = reference->GetDimension(0) * reference->GetDimension(1) * reference->GetDimension(2);
+    for (unsigned int i = 0; i < numberOfPixels; ++i)
+    {
+      if (referenceAccessor.GetData()[i] != testAccessor.GetData()[i])
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+struct BenchmarkParameters
+{
+  unsigned int size;
+  unsigned int slices;
+  std::vector<unsigned int> threads;
+  unsigned int chunkSize;
+};
+
+BenchmarkParameters parseInput(int argc, char* argv[])
+{
+  mitkCommandLineParser parser;
+  parser.setCategory("Dynamic Data Analysis Tools");
+  parser.setTitle("Tofts Fit Benchmark");
+  parser.setDescription("Fits the standard Tofts model to a synthetic data set with different numbers of threads and reports the scaling of the voxel scheduling. All runs must yield identical parameter maps.");
+  parser.setContributor("DKFZ MIC");
+
+  parser.setArgumentPrefix("--", "-");
+
+  parser.beginGroup("Optional parameters");
+  parser.addArgument(
+    "size", "s", mitkCommandLineParser::Int,
+    "Size", "number of voxels along x and y (default: 32)");
+  parser.addArgument(
+    "slices", "z", mitkCommandLineParser::Int,
+    "Slices", "number of slices (default: 4)");
+  parser.addArgument(
+    "threads", "t", mitkCommandLineParser::Int,
+    "Threads", "number of threads (default: 1, 2, 4 and 8)");
+  parser.addArgument(
+    "chunkSize", "c", mitkCommandLineParser::Int,
+    "Chunk size", "number of pixels of the work stealing chunks (default: 256)");
+  parser.endGroup();
+
+  std::map<std::string, us::Any> parsedArgs = parser.parseArguments(argc, argv);
+  if (parsedArgs.size() == 0 && argc > 1)
+    exit(-1);
+
+  BenchmarkParameters input;
+  input.size = parsedArgs.count("size") ? us::any_cast<int>(parsedArgs["size"]) : 32;
+  input.slices = parsedArgs.count("slices") ? us::any_cast<int>(parsedArgs["slices"]) : 4;
+  if (parsedArgs.count("threads"))
+    input.threads.push_back(us::any_cast<int>(parsedArgs["threads"]));
+  else
+    input.threads = { 1, 2, 4, 8 };
+  input.chunkSize = parsedArgs.count("chunkSize") ? us::any_cast<int>(parsedArgs["chunkSize"]) : 256;
+
+  return input;
+}
+
+int main(int argc, char* argv[])
+{
+  auto input = parseInput(argc, argv);
+
+  const mitk::ModelBase::TimeGridType grid = GenerateTimeGrid();
+  const mitk::AIFBasedModelBase::AterialInputFunctionType aif = GenerateAIF(grid);
+  mitk::Image::Pointer dynamicImage = GenerateToftsImage(grid, aif, input.size, input.slices);
+
+  double referenceSeconds = 0;
+  mitk::Image::Pointer reference = Fit(dynamicImage, grid, aif, 1, 0, referenceSeconds);
+  std::cout << "Tofts fit, 1 thread, static split: " << referenceSeconds << " s" << std::endl;
+
+  bool isIdentical = true;
+  for (unsigned int numberOfThreads : input.threads)
+  {
+    double staticSeconds = 0;
+    mitk::Image::Pointer staticResult = Fit(dynamicImage, grid, aif, numberOfThreads, 0, staticSeconds);
+
+    double chunkedSeconds = 0;
+    mitk::Image::Pointer chunkedResult = Fit(dynamicImage, grid, aif, numberOfThreads, input.chunkSize, chunkedSeconds);
+
+    std::cout << "Tofts fit, " << numberOfThreads << " thread(s): static split " << staticSeconds
+              << " s, work stealing " << chunkedSeconds << " s (speedup vs. 1 thread: "
+              << referenceSeconds / chunkedSeconds << ")" << std::endl;
+
+    if (!AreEqual(reference, staticResult) || !AreEqual(reference, chunkedResult))
+    {
+      std::cerr << "The parameter maps of " << numberOfThreads << " thread(s) differ from the single threaded fit." << std::endl;
+      isIdentical = false;
+    }
+  }
+
+  return isIdentical ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -18,6 +18,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "itkArray.h"
 #include "mitkAIFBasedModelBase.h"
+#include <algorithm>
 #include <iostream>
 #include "MitkPharmacokineticsExports.h"
 
@@ -132,6 +133,41 @@ inline    itk::Array<double> wrap1d(itk::Array<double> kernel)
   }
 
 
+  inline void convoluteAIFWithExponentials(const mitk::ModelBase::TimeGridType& timeGrid, const mitk::AIFBasedModelBase::AterialInputFunctionType& aif,
+                                           const double* lambdas, unsigned int count, double* convolution)
+  {
+      /** @brief Batched version of convoluteAIFWithExponential() that convolves the aif with count exponential residue functions at once.
+       * The results equal the ones of convoluteAIFWithExponential().
+       * @param lambdas count decay rates.
+       * @param convolution Preallocated buffer of timeGrid.GetSize()*count values in structure of arrays layout:
+       * convolution[i*count + n] is the value of time point i for lambdas[n]. Thus the inner loop over the lambdas
+       * works on contiguous memory and can be vectorized by the compiler.
+       **/
+      std::fill(convolution, convolution + count, 0.0);
+
+      for(unsigned int i = 0; i< (timeGrid.GetSize()-1); ++i)
+      {
+          const double dt = timeGrid(i+1) - timeGrid(i);
+          const double m = (aif(i+1) - aif(i))/dt;
+          const double t0 = timeGrid(i);
+          const double t1 = timeGrid(i+1);
+          const double a0 = aif(i);
+
+          const double* previous = convolution + i*count;
+          double* current = convolution + (i+1)*count;
+
+          for(unsigned int n = 0; n < count; ++n)
+          {
+              const double lambda = lambdas[n];
+              const double edt = exp(-lambda *dt);
+
+              current[n] = edt * previous[n]
+                         + (a0 - m*t0)/lambda * (1 - edt )
+                         + m/(lambda * lambda) * ((lambda * t1 - 1) - edt*(lambda*t0 -1));
+          }
+      }
+  }
+
   inline itk::Array<double> convoluteAIFWithConstant(mitk::ModelBase::TimeGridType timeGrid, mitk::AIFBasedModelBase::AterialInputFunctionType aif, double constant)
   {
       /** @brief Iterative Formula to Convolve aif(t) with a constant value by linear interpolation of the Aif between sampling points
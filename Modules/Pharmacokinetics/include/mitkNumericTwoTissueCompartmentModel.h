@@ -84,6 +84,8 @@ namespace mitk
      */
     itk::LightObject::Pointer InternalClone() const override;
 
+    /** There is no batched ComputeModelfunctions(): the adaptive ODE stepper chooses the step sizes per
+     * parameter set, so a batch cannot be integrated in lockstep. Batches fall back to this function.*/
     ModelResultType ComputeModelfunction(const ParametersType& parameters) const override;
 
     void PrintSelf(std::ostream& os, ::itk::Indent indent) const override;
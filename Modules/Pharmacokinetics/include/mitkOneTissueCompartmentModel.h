@@ -64,6 +64,9 @@ namespace mitk
 
     ModelResultType ComputeModelfunction(const ParametersType& parameters) const override;
 
+    /** Vectorizable evaluation of a parameter batch (see ModelBase::ComputeModelfunctions()).*/
+    void ComputeModelfunctions(const BatchParametersType& parameters, BatchSignalsType& signals) const override;
+
     void PrintSelf(std::ostream& os, ::itk::Indent indent) const override;
 
   private:
@@ -72,6 +72,9 @@ namespace mitk
 
     ModelResultType ComputeModelfunction(const ParametersType& parameters) const override;
 
+    /** Vectorizable evaluation of a parameter batch (see ModelBase::ComputeModelfunctions()).*/
+    void ComputeModelfunctions(const BatchParametersType& parameters, BatchSignalsType& signals) const override;
+
     DerivedParameterMapType ComputeDerivedParameters(const mitk::ModelBase::ParametersType&
         parameters) const override;
 
@@ -207,6 +207,65 @@ const
 
 }
 
+void
+mitk::DescriptivePharmacokineticBrixModel::ComputeModelfunctions(const BatchParametersType& parameters,
+    BatchSignalsType& signals) const
+{
+  if (m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  if (m_Tau == 0)
+  {
+    itkExceptionMacro("Injection time is 0! Cannot Calculate Signal");
+  }
+
+  const unsigned int count = parameters.cols();
+
+  const double* amplitude = parameters[POSITION_PARAMETER_A];
+  const double*       kel = parameters[POSITION_PARAMETER_kel];
+  const double*       kep = parameters[POSITION_PARAMETER_kep];
+  const double*      tlag = parameters[POSITION_PARAMETER_tlag];
+
+  for (unsigned int i = 0; i < m_TimeGrid.GetSize(); ++i)
+  {
+    const double t = m_TimeGrid[i] / 60.0; //convert from [sec] to [min]
+    double* signal = signals[i];
+
+    for (unsigned int n = 0; n < count; ++n)
+    {
+      double tx = 0;
+
+      if (t <= tlag[n])
+      {
+        tx = 0;
+      }
+      else if (t < (m_Tau + tlag[n]))
+      {
+        tx = t - tlag[n];
+      }
+      else
+      {
+        tx = m_Tau;
+      }
+
+      const double kDiff  = kep[n] - kel[n];
+      const double tDiff  = t - tlag[n];
+
+      const double expkel   = (kep[n] * exp(-kel[n] * tDiff));
+      const double expkeltx =           exp(kel[n] * tx);
+      const double expkep   =           exp(-kep[n] * tDiff);
+      const double expkeptx =           exp(kep[n] * tx);
+
+      const double value =  1 + (amplitude[n] / m_Tau) * (((expkel / (kel[n] * kDiff)) * (expkeltx - 1)) - ((
+                              expkep / kDiff)  * (expkeptx - 1)));
+
+      signal[n] = value * m_S0;
+    }
+  }
+}
+
 void mitk::DescriptivePharmacokineticBrixModel::SetStaticParameter(const ParameterNameType& name,
     const StaticParameterValuesType& values)
 {
@@ -18,6 +18,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkConvolutionHelper.h"
 #include <vnl/algo/vnl_fft_1d.h>
 #include <fstream>
+#include <vector>
 
 const std::string mitk::ExtendedOneTissueCompartmentModel::MODEL_DISPLAY_NAME = "Extended One Tissue Compartment Model (with blood volume)";
 
@@ -127,6 +128,45 @@ mitk::ExtendedOneTissueCompartmentModel::ModelResultType mitk::ExtendedOneTissue
 
 }
 
+void mitk::ExtendedOneTissueCompartmentModel::ComputeModelfunctions(const BatchParametersType& parameters,
+    BatchSignalsType& signals) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  const AterialInputFunctionType aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+
+  const unsigned int timeSteps = this->m_TimeGrid.GetSize();
+  const unsigned int count = parameters.cols();
+
+  const double* k1 = parameters[POSITION_PARAMETER_k1];
+  const double* k2 = parameters[POSITION_PARAMETER_k2];
+  const double* vb = parameters[POSITION_PARAMETER_VB];
+
+  std::vector<double> lambdas(count);
+  for (unsigned int n = 0; n < count; ++n)
+  {
+    lambdas[n] = k2[n] / 60.0;
+  }
+
+  //the convolution is computed directly in the signal buffer and scaled afterwards
+  mitk::convoluteAIFWithExponentials(this->m_TimeGrid, aterialInputFunction, lambdas.data(), count,
+                                     signals.data_block());
+
+  for (unsigned int t = 0; t < timeSteps; ++t)
+  {
+    double* signal = signals[t];
+    const double Cp = aterialInputFunction[t];
+
+    for (unsigned int n = 0; n < count; ++n)
+    {
+      signal[n] = vb[n] * Cp + (1 - vb[n]) * (k1[n] / 60.0) * signal[n];
+    }
+  }
+}
+
 
 
 
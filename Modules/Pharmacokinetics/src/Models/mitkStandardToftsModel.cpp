@@ -18,6 +18,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkConvolutionHelper.h"
 #include <vnl/algo/vnl_fft_1d.h>
 #include <fstream>
+#include <vector>
 
 const std::string mitk::StandardToftsModel::MODEL_DISPLAY_NAME = "Standard Tofts Model";
 
@@ -144,6 +145,43 @@ mitk::StandardToftsModel::ModelResultType mitk::StandardToftsModel::ComputeModel
 
 }
 
+void mitk::StandardToftsModel::ComputeModelfunctions(const BatchParametersType& parameters,
+    BatchSignalsType& signals) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  const AterialInputFunctionType aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+
+  const unsigned int timeSteps = this->m_TimeGrid.GetSize();
+  const unsigned int count = parameters.cols();
+
+  const double* ktrans = parameters[POSITION_PARAMETER_Ktrans];
+  const double* ve = parameters[POSITION_PARAMETER_ve];
+
+  std::vector<double> lambdas(count);
+  for (unsigned int n = 0; n < count; ++n)
+  {
+    lambdas[n] = (ktrans[n] / 6000.0) / ve[n];
+  }
+
+  //the convolution is computed directly in the signal buffer and scaled afterwards
+  mitk::convoluteAIFWithExponentials(this->m_TimeGrid, aterialInputFunction, lambdas.data(), count,
+                                     signals.data_block());
+
+  for (unsigned int t = 0; t < timeSteps; ++t)
+  {
+    double* signal = signals[t];
+
+    for (unsigned int n = 0; n < count; ++n)
+    {
+      signal[n] = (ktrans[n] / 6000.0) * signal[n];
+    }
+  }
+}
+
 
 mitk::ModelBase::DerivedParameterMapType mitk::StandardToftsModel::ComputeDerivedParameters(
   const mitk::ModelBase::ParametersType& parameters) const
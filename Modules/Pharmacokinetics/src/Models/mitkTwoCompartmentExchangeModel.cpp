@@ -17,6 +17,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkTwoCompartmentExchangeModel.h"
 #include "mitkConvolutionHelper.h"
 #include <fstream>
+#include <vector>
 
 const std::string mitk::TwoCompartmentExchangeModel::MODEL_DISPLAY_NAME =
  "Two Compartment Exchange Model";
@@ -164,6 +165,71 @@ mitk::TwoCompartmentExchangeModel::ComputeModelfunction(const ParametersType& pa
     return signal;
 }
 
+void mitk::TwoCompartmentExchangeModel::ComputeModelfunctions(const BatchParametersType& parameters,
+    BatchSignalsType& signals) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  const AterialInputFunctionType aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+
+  const unsigned int timeSteps = this->m_TimeGrid.GetSize();
+  const unsigned int count = parameters.cols();
+
+  const double* f = parameters[POSITION_PARAMETER_F];
+  const double* ps = parameters[POSITION_PARAMETER_PS];
+  const double* ve = parameters[POSITION_PARAMETER_ve];
+  const double* vp = parameters[POSITION_PARAMETER_vp];
+
+  //lambdas[n] is Kp and lambdas[count + n] is Km of parameter set n. Without exchange (PS == 0)
+  //only Kp = F/vp is used, so E is 0 and Km is set to Kp.
+  std::vector<double> lambdas(2 * count);
+  std::vector<double> fractions(count);
+  for (unsigned int n = 0; n < count; ++n)
+  {
+    const double F = f[n] / 6000.0;
+    const double PS = ps[n] / 6000.0;
+
+    if (PS != 0)
+    {
+      const double Tp = vp[n] / (PS + F);
+      const double Te = ve[n] / PS;
+      const double Tb = vp[n] / F;
+
+      const double Kp = 0.5 * (1 / Tp + 1 / Te + sqrt((1 / Tp + 1 / Te) * (1 / Tp + 1 / Te) - 4 * 1 / Te * 1 / Tb));
+      const double Km = 0.5 * (1 / Tp + 1 / Te - sqrt((1 / Tp + 1 / Te) * (1 / Tp + 1 / Te) - 4 * 1 / Te * 1 / Tb));
+
+      lambdas[n] = Kp;
+      lambdas[count + n] = Km;
+      fractions[n] = (Kp - 1 / Tb) / (Kp - Km);
+    }
+    else
+    {
+      lambdas[n] = F / vp[n];
+      lambdas[count + n] = lambdas[n];
+      fractions[n] = 0.0;
+    }
+  }
+
+  std::vector<double> convolutions(timeSteps * 2 * count);
+  mitk::convoluteAIFWithExponentials(this->m_TimeGrid, aterialInputFunction, lambdas.data(), 2 * count,
+                                     convolutions.data());
+
+  for (unsigned int t = 0; t < timeSteps; ++t)
+  {
+    double* signal = signals[t];
+    const double* expp = convolutions.data() + t * 2 * count;
+    const double* expm = expp + count;
+
+    for (unsigned int n = 0; n < count; ++n)
+    {
+      signal[n] = f[n] / 6000.0 * (expp[n] + fractions[n] * (expm[n] - expp[n]));
+    }
+  }
+}
+
 
 itk::LightObject::Pointer mitk::TwoCompartmentExchangeModel::InternalClone() const
 {
@@ -17,6 +17,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkTwoTissueCompartmentFDGModel.h"
 #include "mitkConvolutionHelper.h"
 #include <fstream>
+#include <vector>
 const std::string mitk::TwoTissueCompartmentFDGModel::MODEL_DISPLAY_NAME = "Two Tissue Compartment Model for FDG (Sokoloff Model)";
 
 const std::string mitk::TwoTissueCompartmentFDGModel::NAME_PARAMETER_K1 = "K1";
@@ -127,7 +128,7 @@ mitk::TwoTissueCompartmentFDGModel::ComputeModelfunction(const ParametersType& p
   AterialInputFunctionType::const_iterator aifPos = aterialInputFunction.begin();
 
   for (mitk::ModelBase::ModelResultType::iterator signalPos = signal.begin();
-       signalPos != signal.end(); ++expPos, ++signalPos, ++aifPos)
+       signalPos != signal.end(); ++expPos, ++CAPos, ++signalPos, ++aifPos)
   {
       double Ci = k1 * k2 /lambda *(*expPos) + k1*k3/lambda*(*CAPos);
       *signalPos = VB * (*aifPos) + (1 - VB) * Ci;
@@ -137,6 +138,65 @@ mitk::TwoTissueCompartmentFDGModel::ComputeModelfunction(const ParametersType& p
 
 }
 
+void mitk::TwoTissueCompartmentFDGModel::ComputeModelfunctions(const BatchParametersType& parameters,
+    BatchSignalsType& signals) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  const AterialInputFunctionType aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+
+  const unsigned int timeSteps = this->m_TimeGrid.GetSize();
+  const unsigned int count = parameters.cols();
+
+  const double* K1 = parameters[POSITION_PARAMETER_K1];
+  const double* k2 = parameters[POSITION_PARAMETER_k2];
+  const double* k3 = parameters[POSITION_PARAMETER_k3];
+  const double* VB = parameters[POSITION_PARAMETER_VB];
+
+  std::vector<double> lambdas(count);
+  for (unsigned int n = 0; n < count; ++n)
+  {
+    lambdas[n] = k2[n] / 60.0 + k3[n] / 60.0;
+  }
+
+  //the convolution with the exponential is computed directly in the signal buffer
+  mitk::convoluteAIFWithExponentials(this->m_TimeGrid, aterialInputFunction, lambdas.data(), count,
+                                     signals.data_block());
+
+  //running sums of convoluteAIFWithConstant() for every k3; the AIF integral of a time step is shared
+  std::vector<double> CA(count, 0.0);
+
+  for (unsigned int t = 0; t < timeSteps; ++t)
+  {
+    double* signal = signals[t];
+    const double aif = aterialInputFunction[t];
+
+    if (t > 0)
+    {
+      const double dt = m_TimeGrid(t) - m_TimeGrid(t - 1);
+      const double m = (aterialInputFunction(t) - aterialInputFunction(t - 1)) / dt;
+      const double integral = aterialInputFunction(t - 1) * dt + m * m_TimeGrid(t - 1) * dt +
+                              m / 2 * (m_TimeGrid(t) * m_TimeGrid(t) - m_TimeGrid(t - 1) * m_TimeGrid(t - 1));
+
+      for (unsigned int n = 0; n < count; ++n)
+      {
+        CA[n] = CA[n] + (k3[n] / 60.0) * integral;
+      }
+    }
+
+    for (unsigned int n = 0; n < count; ++n)
+    {
+      const double k1n = K1[n] / 60.0;
+      const double k2n = k2[n] / 60.0;
+      const double k3n = k3[n] / 60.0;
+      const double Ci = k1n * k2n / lambdas[n] * signal[n] + k1n * k3n / lambdas[n] * CA[n];
+      signal[n] = VB[n] * aif + (1 - VB[n]) * Ci;
+    }
+  }
+}
 
 
 
@@ -17,6 +17,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkTwoTissueCompartmentModel.h"
 #include "mitkConvolutionHelper.h"
 #include <fstream>
+#include <vector>
 const std::string mitk::TwoTissueCompartmentModel::MODEL_DISPLAY_NAME = "Two Tissue Compartment Model";
 
 const std::string mitk::TwoTissueCompartmentModel::NAME_PARAMETER_K1 = "K1";
@@ -153,6 +154,59 @@ mitk::TwoTissueCompartmentModel::ComputeModelfunction(const ParametersType& para
 
 }
 
+void mitk::TwoTissueCompartmentModel::ComputeModelfunctions(const BatchParametersType& parameters,
+    BatchSignalsType& signals) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  const AterialInputFunctionType aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+
+  const unsigned int timeSteps = this->m_TimeGrid.GetSize();
+  const unsigned int count = parameters.cols();
+
+  const double* K1 = parameters[POSITION_PARAMETER_K1];
+  const double* k2 = parameters[POSITION_PARAMETER_k2];
+  const double* k3 = parameters[POSITION_PARAMETER_k3];
+  const double* k4 = parameters[POSITION_PARAMETER_k4];
+  const double* VB = parameters[POSITION_PARAMETER_VB];
+
+  //lambdas[n] is alpha1 and lambdas[count + n] is alpha2 of parameter set n
+  std::vector<double> lambdas(2 * count);
+  for (unsigned int n = 0; n < count; ++n)
+  {
+    const double k2n = k2[n] / 60.0;
+    const double k3n = k3[n] / 60.0;
+    const double k4n = k4[n] / 60.0;
+    lambdas[n] = 0.5 * ((k2n + k3n + k4n) - sqrt(square(k2n + k3n + k4n) - 4 * k2n * k4n));
+    lambdas[count + n] = 0.5 * ((k2n + k3n + k4n) + sqrt(square(k2n + k3n + k4n) - 4 * k2n * k4n));
+  }
+
+  std::vector<double> convolutions(timeSteps * 2 * count);
+  mitk::convoluteAIFWithExponentials(this->m_TimeGrid, aterialInputFunction, lambdas.data(), 2 * count,
+                                     convolutions.data());
+
+  for (unsigned int t = 0; t < timeSteps; ++t)
+  {
+    double* signal = signals[t];
+    const double* exp1 = convolutions.data() + t * 2 * count;
+    const double* exp2 = exp1 + count;
+    const double aif = aterialInputFunction[t];
+
+    for (unsigned int n = 0; n < count; ++n)
+    {
+      const double alpha1 = lambdas[n];
+      const double alpha2 = lambdas[count + n];
+      const double k3n = k3[n] / 60.0;
+      const double k4n = k4[n] / 60.0;
+      const double Ci = (K1[n] / 60.0) / (alpha2 - alpha1) * ((k4n - alpha1 + k3n) * exp1[n] + (alpha2 - k4n - k3n) * exp2[n]);
+      signal[n] = VB[n] * aif + (1 - VB[n]) * Ci;
+    }
+  }
+}
+
 
 
 
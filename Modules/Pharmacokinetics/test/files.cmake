@@ -1,4 +1,6 @@
 SET(MODULE_TESTS
   mitkDescriptivePharmacokineticBrixModelTest.cpp
+  mitkStandardToftsModelFitWorkspaceTest.cpp
+  mitkBatchedModelSignalTest.cpp
   #ConvertToConcentrationTest.cpp
 )
@@ -0,0 +1,157 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "mitkTestingMacros.h"
+
+#include "mitkStandardToftsModel.h"
+#include "mitkExtendedToftsModel.h"
+#include "mitkOneTissueCompartmentModel.h"
+#include "mitkExtendedOneTissueCompartmentModel.h"
+#include "mitkDescriptivePharmacokineticBrixModel.h"
+#include "mitkTwoCompartmentExchangeModel.h"
+#include "mitkTwoTissueCompartmentModel.h"
+#include "mitkTwoTissueCompartmentFDGModel.h"
+
+namespace
+{
+  /** Checks that every column of the batched signals equals the signal of the single evaluation
+   * (up to differences in floating point contraction of vectorized loops).*/
+  bool BatchEqualsSingleEvaluation(const mitk::ModelBase* model, const mitk::ModelBase::BatchParametersType& parameters)
+  {
+    mitk::ModelBase::BatchSignalsType signals(model->GetTimeGrid().GetSize(), parameters.cols());
+    model->GetSignals(parameters, signals);
+
+    mitk::ModelBase::ParametersType parameterSet(parameters.rows());
+    for (unsigned int n = 0; n < parameters.cols(); ++n)
+    {
+      for (unsigned int p = 0; p < parameters.rows(); ++p)
+      {
+        parameterSet[p] = parameters[p][n];
+      }
+
+      const mitk::ModelBase::ModelResultType signal = model->GetSignal(parameterSet);
+      for (unsigned int t = 0; t < signal.GetSize(); ++t)
+      {
+        if (std::abs(signal[t] - signals[t][n]) > 1e-12 * std::max(1.0, std::abs(signal[t])))
+        {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  /** Generates count parameter sets; parameter p of set n is start[p] + n*step[p].*/
+  mitk::ModelBase::BatchParametersType GenerateParameters(const std::vector<double>& start, const std::vector<double>& step, unsigned int count)
+  {
+    mitk::ModelBase::BatchParametersType parameters(start.size(), count);
+    for (unsigned int p = 0; p < start.size(); ++p)
+    {
+      for (unsigned int n = 0; n < count; ++n)
+      {
+        parameters[p][n] = start[p] + n * step[p];
+      }
+    }
+    return parameters;
+  }
+}
+
+int mitkBatchedModelSignalTest(int  /*argc*/, char*[] /*argv[]*/)
+{
+  MITK_TEST_BEGIN("mitkBatchedModelSignal")
+
+  const unsigned int frames = 40;
+  const unsigned int count = 13;
+
+  mitk::ModelBase::TimeGridType grid(frames);
+  mitk::AIFBasedModelBase::AterialInputFunctionType aif(frames);
+  for (unsigned int i = 0; i < frames; ++i)
+  {
+    grid[i] = 3.0 * i;
+    const double t = std::max(0.0, grid[i] - 10.0);
+    aif[i] = 0.1 * t * std::exp(-t / 8.0);
+  }
+
+  mitk::StandardToftsModel::Pointer tofts = mitk::StandardToftsModel::New();
+  tofts->SetTimeGrid(grid);
+  tofts->SetAterialInputFunctionValues(aif);
+  tofts->SetAterialInputFunctionTimeGrid(grid);
+  MITK_TEST_CONDITION(BatchEqualsSingleEvaluation(tofts, GenerateParameters({ 1.0, 0.05 }, { 2.5, 0.04 }, count)),
+    "Check batched signals of standard Tofts model.");
+
+  mitk::ExtendedToftsModel::Pointer extendedTofts = mitk::ExtendedToftsModel::New();
+  extendedTofts->SetTimeGrid(grid);
+  extendedTofts->SetAterialInputFunctionValues(aif);
+  extendedTofts->SetAterialInputFunctionTimeGrid(grid);
+  MITK_TEST_CONDITION(BatchEqualsSingleEvaluation(extendedTofts, GenerateParameters({ 1.0, 0.05, 0.01 }, { 2.5, 0.04, 0.005 }, count)),
+    "Check batched signals of extended Tofts model.");
+
+  mitk::OneTissueCompartmentModel::Pointer oneTissue = mitk::OneTissueCompartmentModel::New();
+  oneTissue->SetTimeGrid(grid);
+  oneTissue->SetAterialInputFunctionValues(aif);
+  oneTissue->SetAterialInputFunctionTimeGrid(grid);
+  MITK_TEST_CONDITION(BatchEqualsSingleEvaluation(oneTissue, GenerateParameters({ 0.1, 0.05 }, { 0.05, 0.02 }, count)),
+    "Check batched signals of one tissue compartment model.");
+
+  mitk::ExtendedOneTissueCompartmentModel::Pointer extendedOneTissue = mitk::ExtendedOneTissueCompartmentModel::New();
+  extendedOneTissue->SetTimeGrid(grid);
+  extendedOneTissue->SetAterialInputFunctionValues(aif);
+  extendedOneTissue->SetAterialInputFunctionTimeGrid(grid);
+  MITK_TEST_CONDITION(BatchEqualsSingleEvaluation(extendedOneTissue, GenerateParameters({ 0.1, 0.05, 0.02 }, { 0.05, 0.02, 0.01 }, count)),
+    "Check batched signals of extended one tissue compartment model.");
+
+  // the first parameter set has no exchange (PS = 0)
+  mitk::TwoCompartmentExchangeModel::Pointer exchange = mitk::TwoCompartmentExchangeModel::New();
+  exchange->SetTimeGrid(grid);
+  exchange->SetAterialInputFunctionValues(aif);
+  exchange->SetAterialInputFunctionTimeGrid(grid);
+  MITK_TEST_CONDITION(BatchEqualsSingleEvaluation(exchange, GenerateParameters({ 40.0, 0.0, 0.2, 0.05 }, { 5.0, 2.0, 0.02, 0.005 }, count)),
+    "Check batched signals of two compartment exchange model.");
+
+  mitk::TwoTissueCompartmentModel::Pointer twoTissue = mitk::TwoTissueCompartmentModel::New();
+  twoTissue->SetTimeGrid(grid);
+  twoTissue->SetAterialInputFunctionValues(aif);
+  twoTissue->SetAterialInputFunctionTimeGrid(grid);
+  MITK_TEST_CONDITION(BatchEqualsSingleEvaluation(twoTissue, GenerateParameters({ 0.2, 0.1, 0.05, 0.01, 0.05 }, { 0.02, 0.02, 0.01, 0.005, 0.005 }, count)),
+    "Check batched signals of two tissue compartment model.");
+
+  mitk::TwoTissueCompartmentFDGModel::Pointer fdg = mitk::TwoTissueCompartmentFDGModel::New();
+  fdg->SetTimeGrid(grid);
+  fdg->SetAterialInputFunctionValues(aif);
+  fdg->SetAterialInputFunctionTimeGrid(grid);
+  MITK_TEST_CONDITION(BatchEqualsSingleEvaluation(fdg, GenerateParameters({ 0.2, 0.1, 0.05, 0.05 }, { 0.02, 0.02, 0.01, 0.005 }, count)),
+    "Check batched signals of two tissue compartment FDG model.");
+
+  mitk::DescriptivePharmacokineticBrixModel::Pointer brix = mitk::DescriptivePharmacokineticBrixModel::New();
+  brix->SetTimeGrid(grid);
+  brix->SetTau(0.5);
+  brix->SetS0(2.0);
+  mitk::ModelBase::BatchParametersType brixParameters = GenerateParameters({ 1.0, 3.0, 0.1, 0.2 }, { 0.1, 0.2, 0.01, 0.1 }, count);
+  MITK_TEST_CONDITION(BatchEqualsSingleEvaluation(brix, brixParameters), "Check batched signals of Brix model.");
+
+  mitk::ModelBase::BatchSignalsType wrongSizedSignals(frames - 1, count);
+  MITK_TEST_FOR_EXCEPTION(itk::ExceptionObject, brix->GetSignals(brixParameters, wrongSizedSignals));
+
+  mitk::ModelBase::BatchSignalsType signals(frames, count);
+  MITK_TEST_FOR_EXCEPTION(itk::ExceptionObject, tofts->GetSignals(brixParameters, signals));
+
+  MITK_TEST_END()
+}
@@ -0,0 +1,229 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+
+#include "mitkTestingMacros.h"
+#include "mitkImage.h"
+#include "mitkImageCast.h"
+#include "mitkImagePixelReadAccessor.h"
+
+#include "mitkPixelBasedParameterFitImageGenerator.h"
+#include "mitkLevenbergMarquardtModelFitFunctor.h"
+#include "mitkStandardToftsModel.h"
+#include "mitkStandardToftsModelParameterizer.h"
+
+namespace
+{
+  const unsigned int NumberOfFrames = 30;
+  const double FrameDuration = 4.0;
+
+  mitk::ModelBase::TimeGridType GenerateTimeGrid()
+  {
+    mitk::ModelBase::TimeGridType grid(NumberOfFrames);
+    for (unsigned int i = 0; i < NumberOfFrames; ++i)
+    {
+      grid[i] = FrameDuration * i;
+    }
+    return grid;
+  }
+
+  /** Gamma variate shaped bolus that arrives after 8 s.*/
+  mitk::AIFBasedModelBase::AterialInputFunctionType GenerateAIF(const mitk::ModelBase::TimeGridType& grid)
+  {
+    mitk::AIFBasedModelBase::AterialInputFunctionType aif(grid.GetSize());
+    for (unsigned int i = 0; i < grid.GetSize(); ++i)
+    {
+      const double t = std::max(0.0, grid[i] - 8.0);
+      aif[i] = 0.05 * t * t * std::exp(-t / 6.0);
+    }
+    return aif;
+  }
+
+  /** Generates a 3D+t concentration image of Tofts curves. Ktrans varies along x, ve along y,
+   * every slice adds some heterogeneity, so that the voxels need different numbers of iterations.*/
+  mitk::Image::Pointer GenerateToftsImage(const mitk::ModelBase::TimeGridType& grid,
+    const mitk::AIFBasedModelBase::AterialInputFunctionType& aif, unsigned int size, unsigned int slices)
+  {
+    typedef itk::Image<double, 4> DynamicImageType;
+
+    DynamicImageType::Pointer itkImage = DynamicImageType::New();
+    DynamicImageType::SizeType imageSize;
+    imageSize[0] = size;
+    imageSize[1] = size;
+    imageSize[2] = slices;
+    imageSize[3] = NumberOfFrames;
+    itkImage->SetRegions(imageSize);
+    itkImage->Allocate();
+
+    mitk::StandardToftsModel::Pointer model = mitk::StandardToftsModel::New();
+    model->SetTimeGrid(grid);
+    model->SetAterialInputFunctionValues(aif);
+    model->SetAterialInputFunctionTimeGrid(grid);
+
+    mitk::ModelBase::ParametersType parameters(model->GetNumberOfParameters());
+    DynamicImageType::IndexType index;
+    for (unsigned int z = 0; z < slices; ++z)
+    {
+      for (unsigned int y = 0; y < size; ++y)
+      {
+        for (unsigned int x = 0; x < size; ++x)
+        {
+          parameters[mitk::StandardToftsModel::POSITION_PARAMETER_Ktrans] = 2.0 + 30.0 * x / size + z;
+          parameters[mitk::StandardToftsModel::POSITION_PARAMETER_ve] = 0.05 + 0.6 * y / size;
+
+          const mitk::ModelBase::ModelResultType signal = model->GetSignal(parameters);
+
+          index[0] = x;
+          index[1] = y;
+          index[2] = z;
+          for (unsigned int t = 0; t < NumberOfFrames; ++t)
+          {
+            index[3] = t;
+            itkImage->SetPixel(index, signal[t]);
+          }
+        }
+      }
+    }
+
+    mitk::Image::Pointer image;
+    mitk::CastToMitkImage(itkImage, image);
+    return image;
+  }
+
+  mitk::StandardToftsModelParameterizer::Pointer GenerateParameterizer(const mitk::ModelBase::TimeGridType& grid,
+    const mitk::AIFBasedModelBase::AterialInputFunctionType& aif)
+  {
+    mitk::StandardToftsModelParameterizer::Pointer parameterizer = mitk::StandardToftsModelParameterizer::New();
+    parameterizer->SetAIF(aif);
+    parameterizer->SetAIFTimeGrid(grid);
+    parameterizer->SetDefaultTimeGrid(grid);
+    return parameterizer;
+  }
+
+  mitk::Image::Pointer Fit(mitk::Image* dynamicImage, const mitk::ModelBase::TimeGridType& grid,
+    const mitk::AIFBasedModelBase::AterialInputFunctionType& aif, unsigned int numberOfThreads,
+    unsigned int chunkSize)
+  {
+    mitk::LevenbergMarquardtModelFitFunctor::Pointer fitFunctor = mitk::LevenbergMarquardtModelFitFunctor::New();
+
+    mitk::PixelBasedParameterFitImageGenerator::Pointer generator = mitk::PixelBasedParameterFitImageGenerator::New();
+    generator->SetDynamicImage(dynamicImage);
+    generator->SetModelParameterizer(GenerateParameterizer(grid, aif));
+    generator->SetFitFunctor(fitFunctor);
+    generator->TimeGridByParameterizerOn();
+    generator->SetNumberOfThreads(numberOfThreads);
+    generator->SetChunkSize(chunkSize);
+    generator->Generate();
+
+    return generator->GetParameterImages()["Ktrans"];
+  }
+
+  /** Fits every voxel of the image on its own, without a workspace, like before the fits reused their optimizers.*/
+  mitk::Image::Pointer FitWithoutWorkspace(mitk::Image* dynamicImage, const mitk::ModelBase::TimeGridType& grid,
+    const mitk::AIFBasedModelBase::AterialInputFunctionType& aif)
+  {
+    typedef itk::Image<double, 4> DynamicImageType;
+    typedef itk::Image<mitk::ScalarType, 3> ParameterImageType;
+
+    DynamicImageType::Pointer itkImage;
+    mitk::CastToItkImage(dynamicImage, itkImage);
+
+    ParameterImageType::Pointer ktransImage = ParameterImageType::New();
+    ParameterImageType::SizeType size;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      size[i] = itkImage->GetLargestPossibleRegion().GetSize()[i];
+    }
+    ktransImage->SetRegions(size);
+    ktransImage->Allocate();
+
+    mitk::StandardToftsModelParameterizer::Pointer parameterizer = GenerateParameterizer(grid, aif);
+    mitk::LevenbergMarquardtModelFitFunctor::Pointer fitFunctor = mitk::LevenbergMarquardtModelFitFunctor::New();
+
+    mitk::ModelFitFunctorBase::InputPixelArrayType signal(NumberOfFrames);
+    for (itk::ImageRegionIterator<ParameterImageType> iter(ktransImage, ktransImage->GetLargestPossibleRegion()); !iter.IsAtEnd(); ++iter)
+    {
+      const ParameterImageType::IndexType index = iter.GetIndex();
+      DynamicImageType::IndexType dynamicIndex;
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        dynamicIndex[i] = index[i];
+      }
+      for (unsigned int t = 0; t < NumberOfFrames; ++t)
+      {
+        dynamicIndex[3] = t;
+        signal[t] = itkImage->GetPixel(dynamicIndex);
+      }
+
+      mitk::ModelBase::Pointer model = parameterizer->GenerateParameterizedModel(index);
+      const mitk::ModelFitFunctorBase::OutputPixelArrayType result =
+        fitFunctor->Compute(signal, model, parameterizer->GetInitialParameterization(index));
+      iter.Set(result[mitk::StandardToftsModel::POSITION_PARAMETER_Ktrans]);
+    }
+
+    mitk::Image::Pointer image;
+    mitk::CastToMitkImage(ktransImage, image);
+    return image;
+  }
+
+  bool AreEqual(mitk::Image* reference, mitk::Image* test)
+  {
+    mitk::ImagePixelReadAccessor<mitk::ScalarType, 3> referenceAccessor(reference);
+    mitk::ImagePixelReadAccessor<mitk::ScalarType, 3> testAccessor(test);
+
+    const unsigned int numberOfPixels = reference->GetDimension(0) * reference->GetDimension(1) * reference->GetDimension(2);
+    for (unsigned int i = 0; i < numberOfPixels; ++i)
+    {
+      if (referenceAccessor.GetData()[i] != testAccessor.GetData()[i])
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+/** Fits the standard Tofts model to a synthetic data set with different numbers of threads and chunk sizes.
+ * The fits reuse their optimizer in a workspace per thread, they must yield the same parameter maps as the
+ * fits of the single voxels without workspace.*/
+int mitkStandardToftsModelFitWorkspaceTest(int  /*argc*/, char*[] /*argv[]*/)
+{
+  // always start with this!
+  MITK_TEST_BEGIN("mitkStandardToftsModelFitWorkspace")
+
+  const mitk::ModelBase::TimeGridType grid = GenerateTimeGrid();
+  const mitk::AIFBasedModelBase::AterialInputFunctionType aif = GenerateAIF(grid);
+  mitk::Image::Pointer dynamicImage = GenerateToftsImage(grid, aif, 8, 2);
+
+  mitk::Image::Pointer reference = FitWithoutWorkspace(dynamicImage, grid, aif);
+
+  mitk::Image::Pointer staticResult = Fit(dynamicImage, grid, aif, 1, 0);
+  MITK_TEST_CONDITION_REQUIRED(staticResult.IsNotNull(), "Check Ktrans image of single threaded static fit exists.");
+  MITK_TEST_CONDITION(AreEqual(reference, staticResult), "Check single threaded fit with workspace equals fits without workspace.");
+
+  for (unsigned int numberOfThreads : { 2u, 4u })
+  {
+    mitk::Image::Pointer chunkedResult = Fit(dynamicImage, grid, aif, numberOfThreads, 8);
+    MITK_TEST_CONDITION(AreEqual(reference, chunkedResult), "Check work stealing result equals fits without workspace (" << numberOfThreads << " threads).");
+  }
+
+  MITK_TEST_END()
+}
@@ -0,0 +1,150 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkCommon.h>
+#include <mitkCommandLineParser.h>
+#include <mitkException.h>
+
+#include <mitkBandpassFilter.h>
+#include <mitkBandpassFilterPlan.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+struct BenchmarkParameters
+{
+  unsigned int lines;
+  std::vector<unsigned int> samples;
+  unsigned int frames;
+  unsigned int bufferedFrames;
+};
+
+// the sampling of mitkBandpassFilterTest: 160 MHz; the pass band covers typical photoacoustic frequencies
+const float TIME_SPACING = 0.00625f / 1000000; // s
+const float HIGH_PASS = 1e6f; // Hz
+const float LOW_PASS = 8e6f; // Hz
+const float ALPHA = 0.5f;
+
+BenchmarkParameters parseInput(int argc, char* argv[])
+{
+  mitkCommandLineParser parser;
+  parser.setCategory("MITK-Photoacoustics");
+  parser.setTitle("Mitk Photoacoustics Bandpass Benchmark");
+  parser.setDescription("Measures the frame rate of mitk::BandpassFilter on a sequence of random frames, with cached and with rebuilt FFT plans.");
+  parser.setContributor("Computer Assisted Medical Interventions, DKFZ");
+
+  parser.setArgumentPrefix("--", "-");
+
+  parser.beginGroup("Optional parameters");
+  parser.addArgument(
+    "lines", "l", mitkCommandLineParser::Int,
+    "Lines", "number of lines per frame (default: 128)");
+  parser.addArgument(
+    "samples", "s", mitkCommandLineParser::Int,
+    "Samples", "number of samples per line (default: 2048 and 2000)");
+  parser.addArgument(
+    "frames", "f", mitkCommandLineParser::Int,
+    "Frames", "number of frames in the sequence (default: 1000)");
+  parser.addArgument(
+    "bufferedFrames", "b", mitkCommandLineParser::Int,
+    "Buffered frames", "number of different frames in memory, which are filtered in turn (default: 16)");
+  parser.endGroup();
+
+  std::map<std::string, us::Any> parsedArgs = parser.parseArguments(argc, argv);
+  if (parsedArgs.size() == 0 && argc > 1)
+    exit(-1);
+
+  BenchmarkParameters input;
+  input.lines = parsedArgs.count("lines") ? us::any_cast<int>(parsedArgs["lines"]) : 128;
+  if (parsedArgs.count("samples"))
+    input.samples.push_back(us::any_cast<int>(parsedArgs["samples"]));
+  else
+    input.samples = { 2048, 2000 };
+  input.frames = parsedArgs.count("frames") ? us::any_cast<int>(parsedArgs["frames"]) : 1000;
+  input.bufferedFrames = parsedArgs.count("bufferedFrames") ? us::any_cast<int>(parsedArgs["bufferedFrames"]) : 16;
+
+  if (input.lines == 0 || input.frames == 0 || input.bufferedFrames == 0)
+    mitkThrow() << "The number of lines and frames must be positive.";
+
+  return input;
+}
+
+double SecondsSince(std::chrono::high_resolution_clock::time_point begin)
+{
+  return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+}
+
+int main(int argc, char* argv[])
+{
+  auto input = parseInput(argc, argv);
+
+  std::default_random_engine randomGenerator(42);
+  std::normal_distribution<float> noise(0, 1000);
+
+  for (unsigned int samples : input.samples)
+  {
+    const size_t frameSize = (size_t)input.lines * samples;
+    std::vector<float> data(frameSize * input.bufferedFrames);
+    for (auto& value : data)
+      value = noise(randomGenerator);
+
+    std::cout << input.frames << " frames of " << input.lines << " lines x " << samples << " samples:" << std::endl;
+
+    auto filter = mitk::BandpassFilter::New();
+    filter->SetHighPass(HIGH_PASS);
+    filter->SetLowPass(LOW_PASS);
+    filter->SetHighPassAlpha(ALPHA);
+    filter->SetLowPassAlpha(ALPHA);
+    filter->SetTimeSpacing(TIME_SPACING);
+    filter->SetIsBFImage(false);
+
+    // the first frame creates the plan and the thread pool
+    auto begin = std::chrono::high_resolution_clock::now();
+    filter->FilterInPlace(data.data(), input.lines, samples, 1);
+    std::cout << "  plan and first frame: " << SecondsSince(begin) * 1000 << " ms" << std::endl;
+
+    begin = std::chrono::high_resolution_clock::now();
+    for (unsigned int frame = 0; frame < input.frames; ++frame)
+    {
+      filter->FilterInPlace(&data[frameSize * (frame % input.bufferedFrames)], input.lines, samples, 1);
+    }
+    std::cout << "  frame by frame: " << input.frames / SecondsSince(begin) << " frames/s" << std::endl;
+
+    begin = std::chrono::high_resolution_clock::now();
+    for (unsigned int frame = 0; frame < input.frames; frame += input.bufferedFrames)
+    {
+      filter->FilterInPlace(data.data(), input.lines, samples, std::min(input.bufferedFrames, input.frames - frame));
+    }
+    std::cout << "  " << input.bufferedFrames << " frames at once: " << input.frames / SecondsSince(begin) << " frames/s" << std::endl;
+
+    // without the plan cache and the thread pool: FFT tables and window built for every frame
+    const unsigned int transformLength = mitk::BandpassFilterPlan::TransformLength(samples);
+    const float singleVoxel = (double)samples / transformLength / (TIME_SPACING * transformLength);
+    const unsigned int uncachedFrames = std::min(input.frames, 100u);
+    begin = std::chrono::high_resolution_clock::now();
+    for (unsigned int frame = 0; frame < uncachedFrames; ++frame)
+    {
+      mitk::BandpassFilterPlan plan(samples, HIGH_PASS / singleVoxel, LOW_PASS / singleVoxel, ALPHA, ALPHA);
+      plan.FilterLines(&data[frameSize * (frame % input.bufferedFrames)], input.lines, input.lines);
+    }
+    std::cout << "  plan per frame, one thread: " << uncachedFrames / SecondsSince(begin) << " frames/s" << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
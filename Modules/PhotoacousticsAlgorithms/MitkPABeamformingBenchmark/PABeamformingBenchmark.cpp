@@ -0,0 +1,208 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkCommon.h>
+#include <mitkCommandLineParser.h>
+#include <mitkException.h>
+
+#include <mitkBeamformingFilter.h>
+#include <mitkBeamformingSettings.h>
+#include <mitkBeamformingUtils.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+struct BenchmarkParameters
+{
+  std::vector<unsigned int> elements;
+  unsigned int samples;
+  unsigned int reconstructedSamples;
+  unsigned int frames;
+  unsigned int referenceFrames;
+  std::vector<mitk::BeamformingSettings::BeamformingAlgorithm> algorithms;
+};
+
+// the probe of mitkBeamformingFilterTest: 0.3 mm pitch, 160 MHz sampling
+const float SPEED_OF_SOUND = 1540; // m/s
+const float PITCH_IN_METERS = 0.3f / 1000;
+const float TIME_SPACING = 0.00625f / 2 / 1000000; // s
+
+BenchmarkParameters parseInput(int argc, char* argv[])
+{
+  mitkCommandLineParser parser;
+  parser.setCategory("MITK-Photoacoustics");
+  parser.setTitle("Mitk Photoacoustics Beamforming Benchmark");
+  parser.setDescription("Measures the frame rate of the CPU beamforming of mitk::BeamformingFilter and of the former beamforming with one thread per line on random data.");
+  parser.setContributor("Computer Assisted Medical Interventions, DKFZ");
+
+  parser.setArgumentPrefix("--", "-");
+
+  parser.beginGroup("Optional parameters");
+  parser.addArgument(
+    "elements", "e", mitkCommandLineParser::Int,
+    "Transducer elements", "number of transducer elements and reconstructed lines (default: 128 and 256)");
+  parser.addArgument(
+    "samples", "s", mitkCommandLineParser::Int,
+    "Samples", "number of samples per element (default: 10000)");
+  parser.addArgument(
+    "reconstructedSamples", "r", mitkCommandLineParser::Int,
+    "Reconstructed samples", "number of samples per reconstructed line (default: 2048)");
+  parser.addArgument(
+    "frames", "f", mitkCommandLineParser::Int,
+    "Frames", "number of frames beamformed by mitk::BeamformingFilter (default: 20)");
+  parser.addArgument(
+    "referenceFrames", "rf", mitkCommandLineParser::Int,
+    "Reference frames", "number of frames beamformed with one thread per line, 0 to skip (default: 1)");
+  parser.addArgument(
+    "algorithm", "a", mitkCommandLineParser::String,
+    "Algorithm", "DAS, DMAS or sDMAS (default: all)");
+  parser.endGroup();
+
+  std::map<std::string, us::Any> parsedArgs = parser.parseArguments(argc, argv);
+  if (parsedArgs.size() == 0 && argc > 1)
+    exit(-1);
+
+  BenchmarkParameters input;
+  if (parsedArgs.count("elements"))
+    input.elements.push_back(us::any_cast<int>(parsedArgs["elements"]));
+  else
+    input.elements = { 128, 256 };
+
+  input.samples = parsedArgs.count("samples") ? us::any_cast<int>(parsedArgs["samples"]) : 10000;
+  input.reconstructedSamples = parsedArgs.count("reconstructedSamples") ? us::any_cast<int>(parsedArgs["reconstructedSamples"]) : 2048;
+  input.frames = parsedArgs.count("frames") ? us::any_cast<int>(parsedArgs["frames"]) : 20;
+  input.referenceFrames = parsedArgs.count("referenceFrames") ? us::any_cast<int>(parsedArgs["referenceFrames"]) : 1;
+
+  std::string algorithm = parsedArgs.count("algorithm") ? us::any_cast<std::string>(parsedArgs["algorithm"]) : "";
+  if (algorithm == "" || algorithm == "DAS")
+    input.algorithms.push_back(mitk::BeamformingSettings::BeamformingAlgorithm::DAS);
+  if (algorithm == "" || algorithm == "DMAS")
+    input.algorithms.push_back(mitk::BeamformingSettings::BeamformingAlgorithm::DMAS);
+  if (algorithm == "" || algorithm == "sDMAS")
+    input.algorithms.push_back(mitk::BeamformingSettings::BeamformingAlgorithm::sDMAS);
+  if (input.algorithms.empty())
+    mitkThrow() << "Unknown algorithm " << algorithm << ".";
+
+  return input;
+}
+
+std::string AlgorithmName(mitk::BeamformingSettings::BeamformingAlgorithm algorithm)
+{
+  switch (algorithm)
+  {
+  case mitk::BeamformingSettings::BeamformingAlgorithm::DAS:
+    return "DAS";
+  case mitk::BeamformingSettings::BeamformingAlgorithm::DMAS:
+    return "DMAS";
+  default:
+    return "sDMAS";
+  }
+}
+
+double SecondsSince(std::chrono::high_resolution_clock::time_point begin)
+{
+  return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+}
+
+// the CPU beamforming of mitk::BeamformingFilter before the delay tables: one thread per line and frame
+void BeamformWithThreadPerLine(float* input, float* output, unsigned int* inputDim, mitk::BeamformingSettings::Pointer settings)
+{
+  float inputDimension[2] = { (float)inputDim[0], (float)inputDim[1] };
+  float outputDimension[2] = { (float)settings->GetReconstructionLines(), (float)settings->GetSamplesPerLine() };
+  std::fill(output, output + settings->GetReconstructionLines() * settings->GetSamplesPerLine(), 0.f);
+
+  auto lineFunction = &mitk::BeamformingUtils::sDMASSphericalLine;
+  if (settings->GetAlgorithm() == mitk::BeamformingSettings::BeamformingAlgorithm::DAS)
+    lineFunction = &mitk::BeamformingUtils::DASSphericalLine;
+  else if (settings->GetAlgorithm() == mitk::BeamformingSettings::BeamformingAlgorithm::DMAS)
+    lineFunction = &mitk::BeamformingUtils::DMASSphericalLine;
+
+  std::vector<std::thread> threads;
+  for (short line = 0; line < (short)settings->GetReconstructionLines(); ++line)
+  {
+    threads.emplace_back(lineFunction, input, output, inputDimension, outputDimension, line, settings);
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  auto input = parseInput(argc, argv);
+
+  std::default_random_engine randomGenerator(42);
+  std::normal_distribution<float> noise(0, 1000);
+
+  for (unsigned int elements : input.elements)
+  {
+    unsigned int inputDim[3] = { elements, input.samples, input.frames };
+    std::vector<float> data((size_t)elements * input.samples * input.frames);
+    for (auto& value : data)
+      value = noise(randomGenerator);
+
+    mitk::Image::Pointer image = mitk::Image::New();
+    image->Initialize(mitk::MakeScalarPixelType<float>(), 3, inputDim);
+    image->SetImportVolume(data.data(), 0, 0, mitk::Image::CopyMemory);
+
+    unsigned int firstFrameDim[3] = { elements, input.samples, 1 };
+    mitk::Image::Pointer firstFrame = mitk::Image::New();
+    firstFrame->Initialize(mitk::MakeScalarPixelType<float>(), 3, firstFrameDim);
+    firstFrame->SetImportVolume(data.data(), 0, 0, mitk::Image::CopyMemory);
+
+    for (auto algorithm : input.algorithms)
+    {
+      auto settings = mitk::BeamformingSettings::New(PITCH_IN_METERS, SPEED_OF_SOUND, TIME_SPACING, 27.f, true,
+        input.reconstructedSamples, elements, inputDim, SPEED_OF_SOUND * TIME_SPACING * input.samples, false, 16,
+        mitk::BeamformingSettings::Apodization::Hann, elements * 2, algorithm,
+        mitk::BeamformingSettings::ProbeGeometry::Linear, 0);
+
+      std::cout << elements << " elements, " << input.samples << " samples, " << elements << "x" << input.reconstructedSamples
+        << " pixels, " << AlgorithmName(algorithm) << ":" << std::endl;
+
+      // the first update computes the delays of the settings
+      auto begin = std::chrono::high_resolution_clock::now();
+      auto filter = mitk::BeamformingFilter::New(settings);
+      filter->SetInput(firstFrame);
+      filter->Update();
+      std::cout << "  delay table and first frame: " << SecondsSince(begin) << " s" << std::endl;
+
+      begin = std::chrono::high_resolution_clock::now();
+      filter->SetInput(image);
+      filter->Update();
+      std::cout << "  mitk::BeamformingFilter: " << input.frames / SecondsSince(begin) << " frames/s" << std::endl;
+
+      if (input.referenceFrames > 0)
+      {
+        settings->GetMinMaxLines();
+        std::vector<float> output((size_t)elements * input.reconstructedSamples);
+
+        begin = std::chrono::high_resolution_clock::now();
+        for (unsigned int frame = 0; frame < input.referenceFrames; ++frame)
+        {
+          BeamformWithThreadPerLine(&data[(size_t)elements * input.samples * (frame % input.frames)], output.data(), inputDim, settings);
+        }
+        std::cout << "  one thread per line: " << input.referenceFrames / SecondsSince(begin) << " frames/s" << std::endl;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,3 @@
+set(CPP_FILES
+  PABeamformingBenchmark.cpp
+)
@@ -11,6 +11,10 @@ set(CPP_FILES
   source/OpenCLFilter/mitkPhotoacousticBModeFilter.cpp
   source/utils/mitkPhotoacousticFilterService.cpp
   source/utils/mitkBeamformingUtils.cpp
+  source/utils/mitkBeamformingDelayTable.cpp
+  source/utils/mitkBandpassFilterPlan.cpp
+  source/utils/mitkPhotoacousticThreadPool.cpp
+  source/utils/mitkPhotoacousticStreamingPipeline.cpp
   source/mitkPhotoacousticMotionCorrectionFilter.cpp
 )
 
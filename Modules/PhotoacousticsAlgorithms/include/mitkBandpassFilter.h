@@ -18,12 +18,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 #define MITK_BANDPASS_FILTER
 
 #include "mitkImageToImageFilter.h"
+#include "mitkPhotoacousticThreadPool.h"
 #include "MitkPhotoacousticsAlgorithmsExports.h"
-#include "mitkPhotoacousticFilterService.h"
+#include <memory>
 
 namespace mitk {
   /*!
-  * \brief Class implementing an mitk::ImageToImageFilter for casting any mitk image to a float image
+  * \brief Class implementing an mitk::ImageToImageFilter for bandpass filtering float images along the second dimension
+  *
+  *  The lines of all slices are filtered in blocks by a thread pool that lives as long as the filter. The FFT tables and the
+  *  window are cached per line length and cutoff configuration, see mitk::BandpassFilterPlan.
+  *  FilterInPlace() filters raw float buffers without creating images, e.g. for the frames of a stream.
   */
 
   class MITKPHOTOACOUSTICSALGORITHMS_EXPORT BandpassFilter : public ImageToImageFilter
@@ -42,6 +47,13 @@ namespace mitk {
     itkSetMacro(TimeSpacing, float);
     itkSetMacro(IsBFImage, bool);
 
+    /** \brief Filters the lines of a float buffer in place with the current parameters
+    *
+    * @param data The buffer of slices x samples x lines floats; sample s of line l in slice z is data[(z * samples + s) * lines + l].
+    * @param verticalSpacing The spacing of the samples in mm, which is only used for beamformed images.
+    */
+    void FilterInPlace(float* data, unsigned int lines, unsigned int samples, unsigned int slices, double verticalSpacing = 0);
+
   protected:
     BandpassFilter();
 
@@ -56,7 +68,7 @@ namespace mitk {
     float m_LowPass;
     float m_HighPassAlpha;
     float m_LowPassAlpha;
-    mitk::PhotoacousticFilterService::Pointer m_FilterService;
+    std::unique_ptr<PhotoacousticThreadPool> m_ThreadPool;
 
     void GenerateData() override;
   };
@@ -0,0 +1,97 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITK_BANDPASS_FILTER_PLAN
+#define MITK_BANDPASS_FILTER_PLAN
+
+#include <memory>
+#include <vector>
+
+#include "MitkPhotoacousticsAlgorithmsExports.h"
+
+namespace mitk {
+  /*!
+  * \brief FFT tables, Tukey window and resampling weights of mitk::BandpassFilter for one line length and cutoff configuration
+  *
+  * Each line is linearly resampled to the next power of two, transformed, multiplied with the window, transformed back and
+  * resampled to its original length, as the former ITK implementation of mitk::BandpassFilter did. The window is the
+  * one of that implementation, restricted to its part that acts on real signals, so two lines can be filtered with one
+  * complex transform.
+  *
+  * Plans only depend on their configuration and are shared through GetPlan(). FilterLines() may be called from
+  * several threads at the same time.
+  */
+  class MITKPHOTOACOUSTICSALGORITHMS_EXPORT BandpassFilterPlan final
+  {
+  public:
+    /** \brief Number of plans kept by GetPlan(); the least recently used one is released first.
+    */
+    static const unsigned int MaximumNumberOfCachedPlans = 16;
+
+    /** \brief Returns the cached plan of the configuration, creating it if it is not cached.
+    */
+    static std::shared_ptr<const BandpassFilterPlan> GetPlan(unsigned int samples, float cutoffPixelHighPass, float cutoffPixelLowPass,
+      float alphaHighPass, float alphaLowPass);
+
+    /** \brief The smallest power of two not below samples, which is the length of the transforms.
+    */
+    static unsigned int TransformLength(unsigned int samples);
+
+    /** \brief Creates the plan of lines with the given number of samples.
+    * @param cutoffPixelHighPass The frequency below which the signal is removed, in frequency bins of the transform.
+    * @param cutoffPixelLowPass The frequency above which the signal is removed, in frequency bins of the transform.
+    * @param alphaHighPass The Tukey parameter of the high pass edge of the window: 0 gives a box, 1 a Hann function.
+    * @param alphaLowPass The Tukey parameter of the low pass edge of the window.
+    */
+    BandpassFilterPlan(unsigned int samples, float cutoffPixelHighPass, float cutoffPixelLowPass, float alphaHighPass, float alphaLowPass);
+
+    unsigned int GetSamples() const { return m_Samples; }
+    unsigned int GetTransformLength() const { return m_TransformLength; }
+
+    /** \brief Whether the plan was created for the configuration.
+    */
+    bool Matches(unsigned int samples, float cutoffPixelHighPass, float cutoffPixelLowPass, float alphaHighPass, float alphaLowPass) const;
+
+    /** \brief Filters numberOfLines neighboring lines in place.
+    * @param data The first sample of the first line; sample s of line l is data[s * lineStride + l].
+    */
+    void FilterLines(float* data, unsigned int numberOfLines, unsigned int lineStride) const;
+
+  private:
+    void Transform(float* real, float* imaginary, bool inverse) const;
+    void Upsample(const float* line, float* resampled) const;
+    void Downsample(const float* resampled, float* line) const;
+
+    unsigned int m_Samples;
+    unsigned int m_TransformLength;
+    float m_CutoffPixelHighPass;
+    float m_CutoffPixelLowPass;
+    float m_AlphaHighPass;
+    float m_AlphaLowPass;
+
+    std::vector<unsigned int> m_BitReversal;
+    std::vector<float> m_TwiddleReal;
+    std::vector<float> m_TwiddleImaginary;
+    std::vector<float> m_Window;
+
+    std::vector<unsigned int> m_UpsampleIndex;
+    std::vector<float> m_UpsampleWeight;
+    std::vector<unsigned int> m_DownsampleIndex;
+    std::vector<float> m_DownsampleWeight;
+  };
+} // namespace mitk
+
+#endif //MITK_BANDPASS_FILTER_PLAN
@@ -0,0 +1,113 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITK_BEAMFORMING_DELAY_TABLE
+#define MITK_BEAMFORMING_DELAY_TABLE
+
+#include <cstddef>
+#include <vector>
+
+#include "MitkPhotoacousticsAlgorithmsExports.h"
+
+namespace mitk {
+  class BeamformingSettings;
+  class PhotoacousticThreadPool;
+
+  /*!
+  * \brief Delays and apodization weights of the CPU beamformer, which only depend on the mitk::BeamformingSettings
+  *
+  * For every output pixel, the table holds the range of transducer elements [minLine, maxLine) and the sample of each
+  * of these elements that is summed up, or InvalidDelay if the delayed sample lies outside of the input image. The
+  * delays equal the ones of mitk::BeamformingUtils::DASSphericalLine. The table is created once per settings, see
+  * mitk::BeamformingSettings::GetDelayTable(), and reused for all slices and images.
+  *
+  * If the table would exceed MaximumNumberOfDelays, only the element ranges are stored and the delays are computed
+  * per output pixel with ComputeDelays().
+  */
+  class MITKPHOTOACOUSTICSALGORITHMS_EXPORT BeamformingDelayTable final
+  {
+  public:
+    static const unsigned short InvalidDelay = 0xFFFF;
+
+    /** \brief Number of delays stored at most (2 bytes each).
+    */
+    static const std::size_t MaximumNumberOfDelays = 256 * 1024 * 1024;
+
+    /** \brief Computes the table for the settings, distributing the output lines on the thread pool if one is given.
+    * @param minMaxLines the element range of every output pixel, see mitk::BeamformingSettings::GetMinMaxLines()
+    */
+    BeamformingDelayTable(const BeamformingSettings* settings, const unsigned short* minMaxLines, PhotoacousticThreadPool* threadPool = nullptr);
+
+    unsigned int GetInputLines() const { return m_InputLines; }
+    unsigned int GetInputSamples() const { return m_InputSamples; }
+    unsigned int GetOutputLines() const { return m_OutputLines; }
+    unsigned int GetOutputSamples() const { return m_OutputSamples; }
+
+    unsigned short GetMinLine(unsigned int line, unsigned int sample) const
+    {
+      return m_MinMaxLines[2 * ((std::size_t)sample * m_OutputLines + line)];
+    }
+
+    unsigned short GetMaxLine(unsigned int line, unsigned int sample) const
+    {
+      return m_MinMaxLines[2 * ((std::size_t)sample * m_OutputLines + line) + 1];
+    }
+
+    /** \brief Whether the delays are stored, otherwise GetDelays() must not be called.
+    */
+    bool HasDelays() const { return m_HasDelays; }
+
+    /** \brief The delays of the elements [minLine, maxLine) of the output pixel.
+    */
+    const unsigned short* GetDelays(unsigned int line, unsigned int sample) const
+    {
+      return &m_Delays[m_DelayOffsets[(std::size_t)line * m_OutputSamples + sample]];
+    }
+
+    /** \brief Writes the delays of the elements [minLine, maxLine) of the output pixel to delays.
+    */
+    void ComputeDelays(unsigned int line, unsigned int sample, unsigned short* delays) const;
+
+    /** \brief The apodization weights of an element range of usedLines elements.
+    */
+    const float* GetApodization(unsigned int usedLines) const
+    {
+      return &m_Apodization[(std::size_t)usedLines * (usedLines - 1) / 2];
+    }
+
+  private:
+    unsigned int m_InputLines;
+    unsigned int m_InputSamples;
+    unsigned int m_OutputLines;
+    unsigned int m_OutputSamples;
+
+    std::vector<float> m_ElementHeights;
+    std::vector<float> m_ElementPositions;
+    float m_MetersPerSample;
+    float m_SamplesPerMeter;
+    float m_HorizontalExtent;
+    float m_TotalSamples;
+    bool m_IsPhotoacousticImage;
+
+    std::vector<unsigned short> m_MinMaxLines;
+    bool m_HasDelays;
+    std::vector<std::size_t> m_DelayOffsets;
+    std::vector<unsigned short> m_Delays;
+    std::vector<float> m_Apodization;
+  };
+} // namespace mitk
+
+#endif //MITK_BEAMFORMING_DELAY_TABLE
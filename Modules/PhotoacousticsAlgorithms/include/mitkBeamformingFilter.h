@@ -22,7 +22,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "./OpenCLFilter/mitkPhotoacousticOCLBeamformingFilter.h"
 #include "mitkBeamformingSettings.h"
 #include "mitkBeamformingUtils.h"
+#include "mitkPhotoacousticThreadPool.h"
 #include "MitkPhotoacousticsAlgorithmsExports.h"
+#include <memory>
 
 namespace mitk {
   /*!
@@ -30,6 +32,8 @@ namespace mitk {
   *
   *  The class must be given a configuration class instance of mitk::BeamformingSettings for beamforming parameters through mitk::BeamformingFilter::Configure(BeamformingSettings settings)
   *  Whether the GPU is used can be set in the configuration.
+  *  On CPU, the output is split into tiles, which are beamformed by a thread pool that lives as long as the filter. The delays are
+  *  computed once per configuration, see mitk::BeamformingSettings::GetDelayTable().
   *  For significant problems or important messages a string is written, which can be accessed via GetMessageString().
   */
 
@@ -84,6 +88,10 @@ namespace mitk {
     /** \brief Pointer to the GPU beamforming filter class; for performance reasons the filter is initialized within the constructor and kept for all later computations.
     */
     mitk::PhotoacousticOCLBeamformingFilter::Pointer m_BeamformingOclFilter;
+
+    /** \brief The threads beamforming on CPU, started with the filter and reused for all slices and updates.
+    */
+    std::unique_ptr<PhotoacousticThreadPool> m_ThreadPool;
   };
 } // namespace mitk
 
@@ -21,8 +21,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkMacro.h>
 #include <mitkCommon.h>
 #include <MitkPhotoacousticsAlgorithmsExports.h>
+#include <mutex>
 
 namespace mitk {
+  class BeamformingDelayTable;
+  class PhotoacousticThreadPool;
+
   /*!
   * \brief Class holding the configuration data for the beamforming filters mitk::BeamformingFilter and mitk::PhotoacousticOCLBeamformingFilter
   *
@@ -134,6 +138,11 @@ namespace mitk {
 
     unsigned short* GetMinMaxLines();
 
+    /** \brief The delays and apodization weights of the CPU beamformer, computed on first use.
+    * @param threadPool the threads used to compute the table, if it does not exist yet
+    */
+    const BeamformingDelayTable* GetDelayTable(PhotoacousticThreadPool* threadPool = nullptr);
+
   protected:
 
     /**
@@ -243,6 +252,14 @@ namespace mitk {
     /**
     */
     unsigned short* m_MinMaxLines;
+
+    /** \brief The delay table of the CPU beamformer, see GetDelayTable()
+    */
+    BeamformingDelayTable* m_DelayTable;
+
+    /** \brief Guards the lazy computation of the element ranges and the delay table
+    */
+    std::mutex m_LazyMutex;
   };
 }
 #endif //MITK_BEAMFORMING_SETTINGS
@@ -21,11 +21,15 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <functional>
 #include "./OpenCLFilter/mitkPhotoacousticOCLBeamformingFilter.h"
 #include "mitkBeamformingSettings.h"
+#include "mitkBeamformingDelayTable.h"
+#include "mitkPhotoacousticThreadPool.h"
 
 namespace mitk {
   /*!
   * \brief Class implementing util functionality for beamforming on CPU
   *
+  * mitk::BeamformingFilter beamforms tiles of the output with BeamformTile(). The functions for single lines compute
+  * all delays on the fly and are kept as reference implementation.
   */
   class BeamformingUtils final
   {
@@ -43,6 +47,25 @@ namespace mitk {
     */
     static void sDMASSphericalLine(float* input, float* output, float inputDim[2], float outputDim[2], const short& line, const mitk::BeamformingSettings::Pointer config);
 
+    /** \brief Function to perform beamforming on CPU for the output pixels [firstLine, endLine) x [firstSample, endSample) of a single slice
+    *
+    * The delays and apodization weights are taken from the table. The result equals the one of the functions for single lines up to
+    * rounding; DMAS and sDMAS sum up the products of all element pairs in linear time, using
+    * sum_{i<j} x_i*x_j = ((sum_i x_i)^2 - sum_i x_i^2) / 2 for the signed square roots x_i of the apodized samples.
+    */
+    static void BeamformTile(const float* input, float* output, const BeamformingDelayTable* table,
+      BeamformingSettings::BeamformingAlgorithm algorithm,
+      unsigned int firstLine, unsigned int endLine, unsigned int firstSample, unsigned int endSample);
+
+    /** \brief Function to perform beamforming on CPU for a single slice, whose tiles are distributed on the thread pool
+    */
+    static void BeamformSlice(const float* input, float* output, const BeamformingDelayTable* table,
+      BeamformingSettings::BeamformingAlgorithm algorithm, PhotoacousticThreadPool* threadPool);
+
+    /** \brief The spacing in mm of an image beamformed from an input with inputSamples samples per line
+    */
+    static mitk::Vector3D OutputSpacing(const mitk::BeamformingSettings::Pointer config, unsigned int inputSamples);
+
     /** \brief Pointer holding the Von-Hann apodization window for beamforming
     * @param samples the resolution at which the window is created
     */
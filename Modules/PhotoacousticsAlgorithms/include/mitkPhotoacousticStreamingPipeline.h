@@ -0,0 +1,191 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITK_PHOTOACOUSTIC_STREAMING_PIPELINE
+#define MITK_PHOTOACOUSTIC_STREAMING_PIPELINE
+
+#include "itkObject.h"
+#include "mitkCommon.h"
+#include "mitkImage.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "mitkBandpassFilter.h"
+#include "mitkBeamformingSettings.h"
+#include "mitkPhotoacousticFilterService.h"
+#include "mitkPhotoacousticThreadPool.h"
+#include "MitkPhotoacousticsAlgorithmsExports.h"
+
+namespace mitk {
+  /*!
+  * \brief Reconstructs a live stream of photoacoustic or ultrasound frames, one frame at a time
+  *
+  * The frames run through the stages bandpass -> beamforming -> cropping and B-mode, like the images processed with
+  * mitk::PhotoacousticFilterService. Every stage has its own worker thread, so the stages of consecutive frames overlap;
+  * beamforming additionally distributes each frame on a thread pool.
+  *
+  * The frames are held in a ring of NumberOfBufferedFrames preallocated buffers, which are reused for all frames. PushFrame()
+  * copies a frame into a free buffer. If all buffers are in use, because reconstruction does not keep up with the acquisition,
+  * the frame is dropped, or PushFrame() waits for a free buffer if WaitForFreeBuffer is set.
+  *
+  * Reconstructed frames are handed to the frame handler on the thread of the last stage. The handler may keep the image:
+  * if it still holds a reference after it returns, the buffer gets a new image, so later frames do not overwrite it.
+  *
+  * The processing time of every stage and the latency from PushFrame() to the frame handler are recorded, see GetStageStatistics().
+  * Beamforming always runs on CPU.
+  */
+  class MITKPHOTOACOUSTICSALGORITHMS_EXPORT PhotoacousticStreamingPipeline : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(mitk::PhotoacousticStreamingPipeline, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    /** \brief Timing of one stage in ms, or of the whole pipeline for the last entry of GetStageStatistics()
+    */
+    struct StageStatistics
+    {
+      std::string name;
+      unsigned long numberOfFrames;
+      double lastLatency;
+      double averageLatency;
+      double maximumLatency;
+    };
+
+    /** \brief The beamforming settings, which also define the dimensions of the input frames.
+    */
+    itkSetMacro(BeamformingSettings, BeamformingSettings::Pointer);
+    itkGetConstMacro(BeamformingSettings, BeamformingSettings::Pointer);
+
+    /** \brief Parameters of the bandpass applied to the raw frames in place, see mitk::BandpassFilter.
+    */
+    itkSetMacro(UseBandpass, bool);
+    itkGetConstMacro(UseBandpass, bool);
+    itkSetMacro(BandpassHighPass, float);
+    itkSetMacro(BandpassLowPass, float);
+    itkSetMacro(BandpassHighPassAlpha, float);
+    itkSetMacro(BandpassLowPassAlpha, float);
+
+    /** \brief How many pixels are cut off the beamformed frames on each side.
+    */
+    itkSetMacro(CropAbove, unsigned int);
+    itkSetMacro(CropBelow, unsigned int);
+    itkSetMacro(CropLeft, unsigned int);
+    itkSetMacro(CropRight, unsigned int);
+
+    /** \brief Parameters of the B-mode filter applied to the cropped frames, see mitk::PhotoacousticFilterService::ApplyBmodeFilter().
+    */
+    itkSetMacro(UseBMode, bool);
+    itkGetConstMacro(UseBMode, bool);
+    itkSetMacro(BModeMethod, PhotoacousticFilterService::BModeMethod);
+    itkSetMacro(UseLogFilter, bool);
+
+    /** \brief Number of frames that can be in the pipeline at the same time (default 4), at least 2.
+    */
+    itkSetMacro(NumberOfBufferedFrames, unsigned int);
+    itkGetConstMacro(NumberOfBufferedFrames, unsigned int);
+
+    /** \brief Whether PushFrame() waits for a free buffer instead of dropping the frame (default off).
+    */
+    itkSetMacro(WaitForFreeBuffer, bool);
+    itkGetConstMacro(WaitForFreeBuffer, bool);
+
+    /** \brief Sets the function, to which the reconstructed frames and their numbers are handed.
+    *
+    * The image can be kept by holding a smart pointer to it, which costs the allocation of a new output buffer. Raw
+    * pointers to the image or to its data must not be used after the handler returned, the buffer is reused then.
+    */
+    void SetFrameHandler(std::function<void(mitk::Image::Pointer, unsigned long)> frameHandler);
+
+    /** \brief Allocates the buffers and starts the stages. The parameters must not be changed until Stop().
+    */
+    void Start();
+
+    /** \brief Waits until all pushed frames are reconstructed and stops the stages.
+    */
+    void Stop();
+
+    bool IsRunning() const;
+
+    /** \brief Queues the first slice of the frame for reconstruction.
+    * @return false, if the frame has been dropped because no buffer was free.
+    */
+    bool PushFrame(mitk::Image::Pointer frame);
+
+    /** \brief Queues a frame of GetInputDim()[0] lines x GetInputDim()[1] samples of the beamforming settings.
+    */
+    bool PushFrame(const float* frame);
+
+    unsigned long GetNumberOfDroppedFrames() const;
+
+    /** \brief The timing of the stages in processing order, followed by the latency from PushFrame() to the end of the frame handler.
+    */
+    std::vector<StageStatistics> GetStageStatistics() const;
+
+  protected:
+    PhotoacousticStreamingPipeline();
+    ~PhotoacousticStreamingPipeline() override;
+
+  private:
+    struct Frame;
+    struct Stage;
+    struct EnvelopeDetection;
+    class FrameQueue;
+
+    void RunStage(unsigned int stage);
+    void RecordLatency(StageStatistics& statistics, double latency);
+    mitk::Image::Pointer CreateOutputImage() const;
+
+    void Bandpass(Frame& frame);
+    void Beamform(Frame& frame);
+    void CropAndBMode(Frame& frame);
+
+    BeamformingSettings::Pointer m_BeamformingSettings;
+    bool m_UseBandpass;
+    float m_BandpassHighPass;
+    float m_BandpassLowPass;
+    float m_BandpassHighPassAlpha;
+    float m_BandpassLowPassAlpha;
+    unsigned int m_CropAbove;
+    unsigned int m_CropBelow;
+    unsigned int m_CropLeft;
+    unsigned int m_CropRight;
+    bool m_UseBMode;
+    PhotoacousticFilterService::BModeMethod m_BModeMethod;
+    bool m_UseLogFilter;
+    unsigned int m_NumberOfBufferedFrames;
+    bool m_WaitForFreeBuffer;
+    std::function<void(mitk::Image::Pointer, unsigned long)> m_FrameHandler;
+
+    std::vector<std::unique_ptr<Frame>> m_Frames;
+    std::unique_ptr<FrameQueue> m_FreeFrames;
+    std::vector<std::unique_ptr<Stage>> m_Stages;
+    bool m_Running;
+    unsigned long m_NumberOfPushedFrames;
+    unsigned long m_NumberOfDroppedFrames;
+    StageStatistics m_TotalStatistics;
+    mutable std::mutex m_Mutex;
+
+    std::unique_ptr<PhotoacousticThreadPool> m_ThreadPool;
+    const BeamformingDelayTable* m_DelayTable;
+    BandpassFilter::Pointer m_BandpassFilter;
+    std::unique_ptr<EnvelopeDetection> m_EnvelopeDetection;
+  };
+} // namespace mitk
+
+#endif //MITK_PHOTOACOUSTIC_STREAMING_PIPELINE
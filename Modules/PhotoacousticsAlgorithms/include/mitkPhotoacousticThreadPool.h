@@ -0,0 +1,79 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITK_PHOTOACOUSTIC_THREAD_POOL
+#define MITK_PHOTOACOUSTIC_THREAD_POOL
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MitkPhotoacousticsAlgorithmsExports.h"
+
+namespace mitk {
+  /*!
+  * \brief Fixed set of worker threads, which are started once and reused for all parallel loops of a filter
+  *
+  * ParallelFor() hands out the tasks through an atomic counter to the workers and to the calling thread and returns
+  * when all tasks are done. Calls from several threads are serialized.
+  */
+  class MITKPHOTOACOUSTICSALGORITHMS_EXPORT PhotoacousticThreadPool final
+  {
+  public:
+    /** \brief Starts numberOfThreads - 1 workers, the calling thread of ParallelFor() is the last one.
+    * @param numberOfThreads 0 for one thread per hardware thread
+    */
+    explicit PhotoacousticThreadPool(unsigned int numberOfThreads = 0);
+
+    ~PhotoacousticThreadPool();
+
+    PhotoacousticThreadPool(const PhotoacousticThreadPool&) = delete;
+    PhotoacousticThreadPool& operator=(const PhotoacousticThreadPool&) = delete;
+
+    unsigned int GetNumberOfThreads() const;
+
+    /** \brief Calls task(i) for all i < numberOfTasks in parallel and waits for all of them to finish.
+    *
+    * If a task throws, the remaining tasks are skipped and the first exception is rethrown.
+    */
+    void ParallelFor(unsigned int numberOfTasks, const std::function<void(unsigned int)>& task);
+
+  private:
+    void WorkerLoop();
+    void RunTasks();
+
+    std::vector<std::thread> m_Workers;
+
+    std::mutex m_ParallelForMutex;
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkAvailable;
+    std::condition_variable m_WorkDone;
+
+    const std::function<void(unsigned int)>* m_Task;
+    unsigned int m_NumberOfTasks;
+    std::atomic<unsigned int> m_NextTask;
+    std::exception_ptr m_Exception;
+    unsigned long m_Generation;
+    unsigned int m_NumberOfBusyWorkers;
+    bool m_Stop;
+  };
+} // namespace mitk
+
+#endif //MITK_PHOTOACOUSTIC_THREAD_POOL
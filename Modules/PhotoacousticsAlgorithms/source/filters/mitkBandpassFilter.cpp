@@ -18,21 +18,23 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <cmath>
 
 #include "mitkBandpassFilter.h"
+#include "mitkBandpassFilterPlan.h"
+#include "mitkImageReadAccessor.h"
+#include "mitkImageWriteAccessor.h"
 
-#include "../ITKFilter/ITKUltrasound/itkFFT1DComplexConjugateToRealImageFilter.h"
-#include "../ITKFilter/ITKUltrasound/itkFFT1DRealToComplexConjugateImageFilter.h"
-#include "itkComplexToModulusImageFilter.h"
-#include "itkMultiplyImageFilter.h"
-#include "mitkIOUtil.h"
-#include "mitkITKImageImport.h"
-#include "mitkImageCast.h"
+#include <algorithm>
+
+namespace
+{
+  // number of neighboring lines filtered by one task; they share the cache lines of every sample
+  const unsigned int BlockLines = 16;
+}
 
 mitk::BandpassFilter::BandpassFilter()
   : m_HighPass(0),
     m_LowPass(50),
     m_HighPassAlpha(1),
-    m_LowPassAlpha(1),
-    m_FilterService(mitk::PhotoacousticFilterService::New())
+    m_LowPassAlpha(1)
 {
   MITK_INFO << "Instantiating BandpassFilter...";
   SetNumberOfIndexedInputs(1);
@@ -62,109 +64,36 @@ void mitk::BandpassFilter::SanityCheckPreconditions()
   }
 }
 
-itk::Image<float, 3U>::Pointer BPFunction(mitk::Image::Pointer reference,
-                                          float cutoffFrequencyPixelHighPass,
-                                          float cutoffFrequencyPixelLowPass,
-                                          float alphaHighPass,
-                                          float alphaLowPass)
+void mitk::BandpassFilter::FilterInPlace(float* data, unsigned int lines, unsigned int samples, unsigned int slices, double verticalSpacing)
 {
-  float *imageData = new float[reference->GetDimension(0) * reference->GetDimension(1)];
-
-  float width = cutoffFrequencyPixelLowPass - cutoffFrequencyPixelHighPass;
-  float center = cutoffFrequencyPixelHighPass + width / 2.f;
-
-  for (unsigned int n = 0; n < reference->GetDimension(1); ++n)
-  {
-    imageData[reference->GetDimension(0) * n] = 0;
-  }
-  for (int n = 0; n < width; ++n)
-  {
-    imageData[reference->GetDimension(0) * (int)(n + center - (width / 2.f))] = 1;
-    if (n <= (alphaHighPass * (width - 1)) / 2.f)
-    {
-      if (alphaHighPass > 0.00001f)
-      {
-        imageData[reference->GetDimension(0) * (int)(n + center - (width / 2.f))] =
-          (1 + cos(itk::Math::pi * (2 * n / (alphaHighPass * (width - 1)) - 1))) / 2;
-      }
-      else
-      {
-        imageData[reference->GetDimension(0) * (int)(n + center - (width / 2.f))] = 1;
-      }
-    }
-    else if (n >= (width - 1) * (1 - alphaLowPass / 2.f))
-    {
-      if (alphaLowPass > 0.00001f)
-      {
-        imageData[reference->GetDimension(0) * (int)(n + center - (width / 2.f))] =
-          (1 + cos(itk::Math::pi * (2 * n / (alphaLowPass * (width - 1)) + 1 - 2 / alphaLowPass))) / 2;
-      }
-      else
-      {
-        imageData[reference->GetDimension(0) * (int)(n + center - (width / 2.f))] = 1;
-      }
-    }
-  }
-
-  for (unsigned int n = reference->GetDimension(1) / 2; n < reference->GetDimension(1); ++n)
-  {
-    imageData[reference->GetDimension(0) * n] =
-      imageData[(reference->GetDimension(1) - (n + 1)) * reference->GetDimension(0)];
-  }
-
-  for (unsigned int line = 1; line < reference->GetDimension(0); ++line)
-  {
-    for (unsigned int sample = 0; sample < reference->GetDimension(1); ++sample)
-    {
-      imageData[reference->GetDimension(0) * sample + line] = imageData[reference->GetDimension(0) * sample];
-    }
-  }
-
-  typedef itk::Image<float, 3U> ImageType;
-  ImageType::RegionType region;
-  ImageType::IndexType start;
-  start.Fill(0);
-
-  region.SetIndex(start);
-
-  ImageType::SizeType size;
-  size[0] = reference->GetDimension(0);
-  size[1] = reference->GetDimension(1);
-  size[2] = reference->GetDimension(2);
-
-  region.SetSize(size);
-
-  ImageType::SpacingType SpacingItk;
-  SpacingItk[0] = reference->GetGeometry()->GetSpacing()[0];
-  SpacingItk[1] = reference->GetGeometry()->GetSpacing()[1];
-  SpacingItk[2] = reference->GetGeometry()->GetSpacing()[2];
+  if (m_HighPass > m_LowPass)
+    mitkThrow() << "High pass frequency higher than low pass frequency, abort";
+  if (lines == 0 || samples == 0 || slices == 0)
+    return;
 
-  ImageType::Pointer image = ImageType::New();
-  image->SetRegions(region);
-  image->Allocate();
-  image->FillBuffer(itk::NumericTraits<float>::Zero);
-  image->SetSpacing(SpacingItk);
+  // the lines are resampled to a power of two for the transform
+  const unsigned int transformLength = BandpassFilterPlan::TransformLength(samples);
+  double spacingResize = (double)samples / transformLength;
 
-  ImageType::IndexType pixelIndex;
+  float singleVoxel = spacingResize / (m_TimeSpacing * transformLength); // [Hz]
+  if (m_IsBFImage)
+    singleVoxel = spacingResize / (verticalSpacing / 1e3 / m_SpeedOfSound * transformLength); // [Hz]
+  float cutoffPixelHighPass = std::min((m_HighPass / singleVoxel), (float)transformLength / 2.0f);
+  float cutoffPixelLowPass = std::min((m_LowPass / singleVoxel), (float)transformLength / 2.0f);
 
-  for (unsigned int slice = 0; slice < reference->GetDimension(2); ++slice)
-  {
-    for (unsigned int line = 0; line < reference->GetDimension(0); ++line)
-    {
-      for (unsigned int sample = 0; sample < reference->GetDimension(1); ++sample)
-      {
-        pixelIndex[0] = line;
-        pixelIndex[1] = sample;
-        pixelIndex[2] = slice;
+  MITK_DEBUG << "cutoffPixelHighPass: " << cutoffPixelHighPass << ", cutoffPixelLowPass: " << cutoffPixelLowPass;
 
-        image->SetPixel(pixelIndex, imageData[line + sample * reference->GetDimension(0)]);
-      }
-    }
-  }
+  auto plan = BandpassFilterPlan::GetPlan(samples, cutoffPixelHighPass, cutoffPixelLowPass, m_HighPassAlpha, m_LowPassAlpha);
 
-  delete[] imageData;
+  if (!m_ThreadPool)
+    m_ThreadPool.reset(new PhotoacousticThreadPool());
 
-  return image;
+  const unsigned int blocksPerSlice = (lines + BlockLines - 1) / BlockLines;
+  m_ThreadPool->ParallelFor(blocksPerSlice * slices, [&](unsigned int block) {
+    const unsigned int slice = block / blocksPerSlice;
+    const unsigned int firstLine = block % blocksPerSlice * BlockLines;
+    plan->FilterLines(data + (size_t)slice * lines * samples + firstLine, std::min(BlockLines, lines - firstLine), lines);
+  });
 }
 
 void mitk::BandpassFilter::GenerateData()
@@ -172,93 +101,15 @@ void mitk::BandpassFilter::GenerateData()
   SanityCheckPreconditions();
   auto input = GetInput();
   auto output = GetOutput();
-  mitk::Image::Pointer resampledInput = input;
-
-  double powerOfTwo = std::log2(input->GetDimension(1));
-  int finalSize = 0;
-  double spacingResize = 1;
-
-  // check if this is a power of two by checking that log2 is int
-  if (std::fmod(powerOfTwo, 1.0) >= std::numeric_limits<double>::epsilon())
-  {
-    finalSize = (int)pow(2, std::ceil(powerOfTwo));
-    double dim[2] = {(double)input->GetDimension(0), (double)finalSize };
-    resampledInput = m_FilterService->ApplyResamplingToDim(input, dim);
-    spacingResize = (double)input->GetDimension(1) / finalSize;
-  }
-
-  // do a fourier transform, multiply with an appropriate window for the filter, and transform back
-  typedef itk::Image<float, 3> RealImageType;
-  RealImageType::Pointer image;
-  mitk::CastToItkImage(resampledInput, image);
-  typedef itk::FFT1DRealToComplexConjugateImageFilter<RealImageType> ForwardFFTFilterType;
-  typedef ForwardFFTFilterType::OutputImageType ComplexImageType;
-  ForwardFFTFilterType::Pointer forwardFFTFilter = ForwardFFTFilterType::New();
-  forwardFFTFilter->SetInput(image);
-  forwardFFTFilter->SetDirection(1);
 
-  try
+  unsigned int dim[] = { input->GetDimension(0), input->GetDimension(1), input->GetDimension(2) };
+  output->Initialize(mitk::MakeScalarPixelType<float>(), 3, dim);
+  output->SetSpacing(input->GetGeometry()->GetSpacing());
   {
-    forwardFFTFilter->UpdateOutputInformation();
+    ImageReadAccessor copy(input);
+    output->SetImportVolume(copy.GetData());
   }
-  catch (itk::ExceptionObject &error)
-  {
-    std::cerr << "Error: " << error << std::endl;
-    MITK_ERROR << "Bandpass could not be applied";
-    mitkThrow() << "bandpass error";
-  }
-
-  if (m_HighPass > m_LowPass)
-    mitkThrow() << "High pass frequency higher than low pass frequency, abort";
-
-  float singleVoxel = spacingResize / (m_TimeSpacing * resampledInput->GetDimension(1)); // [Hz]
-  if(m_IsBFImage)
-    singleVoxel = spacingResize / (resampledInput->GetGeometry()->GetSpacing()[1] / 1e3 / m_SpeedOfSound * resampledInput->GetDimension(1)); // [Hz]
-  float cutoffPixelHighPass = std::min((m_HighPass / singleVoxel), (float)resampledInput->GetDimension(1) / 2.0f);
-  float cutoffPixelLowPass = std::min((m_LowPass / singleVoxel), (float)resampledInput->GetDimension(1) / 2.0f);
-
-  MITK_INFO << "SingleVoxel: " << singleVoxel;
-  MITK_INFO << "HighPass: " << m_HighPass;
-  MITK_INFO << "LowPass: " << m_LowPass;
-
-  MITK_INFO << "cutoffPixelHighPass: " << cutoffPixelHighPass;
-  MITK_INFO << "cutoffPixelLowPass: " << cutoffPixelLowPass;
-
-  RealImageType::Pointer fftMultiplicator =
-    BPFunction(resampledInput, cutoffPixelHighPass, cutoffPixelLowPass, m_HighPassAlpha, m_LowPassAlpha);
-
-  typedef itk::MultiplyImageFilter<ComplexImageType, RealImageType, ComplexImageType> MultiplyFilterType;
-  MultiplyFilterType::Pointer multiplyFilter = MultiplyFilterType::New();
-  multiplyFilter->SetInput1(forwardFFTFilter->GetOutput());
-  multiplyFilter->SetInput2(fftMultiplicator);
-
-  /*
-  GrabItkImageMemory(fftMultiplicator, output);
-  mitk::IOUtil::Save(output, "D:/fftImage.nrrd");
-
-  typedef itk::ComplexToModulusImageFilter< ComplexImageType, RealImageType > modulusType;
-  modulusType::Pointer modul = modulusType::New();
-
-  modul->SetInput(multiplyFilter->GetOutput());
-  GrabItkImageMemory(modul->GetOutput(), output);
-  mitk::IOUtil::Save(output, "D:/fftout.nrrd");
-
-  modul->SetInput(forwardFFTFilter->GetOutput());
-  GrabItkImageMemory(modul->GetOutput(), output);
-  mitk::IOUtil::Save(output, "D:/fftin.nrrd");*/
-
-  typedef itk::FFT1DComplexConjugateToRealImageFilter<ComplexImageType, RealImageType> InverseFilterType;
-  InverseFilterType::Pointer inverseFFTFilter = InverseFilterType::New();
-  inverseFFTFilter->SetInput(multiplyFilter->GetOutput());
-  inverseFFTFilter->SetDirection(1);
-
-  GrabItkImageMemory(inverseFFTFilter->GetOutput(), output);
-
-  double dim[2] = { (double)input->GetDimension(0), (double)input->GetDimension(1) };
-  auto resampledOutput = m_FilterService->ApplyResamplingToDim(output, dim);
 
-  output->Initialize(mitk::MakeScalarPixelType<float>(), 3, input->GetDimensions());
-  output->SetSpacing(resampledOutput->GetGeometry()->GetSpacing());
-  ImageReadAccessor copy(resampledOutput);
-  output->SetImportVolume(copy.GetData());
+  ImageWriteAccessor writeAccess(output);
+  this->FilterInPlace((float*)writeAccess.GetData(), dim[0], dim[1], dim[2], input->GetGeometry()->GetSpacing()[1]);
 }
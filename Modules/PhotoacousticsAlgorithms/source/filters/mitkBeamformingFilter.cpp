@@ -28,7 +28,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 mitk::BeamformingFilter::BeamformingFilter(mitk::BeamformingSettings::Pointer settings) :
   m_OutputData(nullptr),
   m_InputData(nullptr),
-  m_Conf(settings)
+  m_Conf(settings),
+  m_ThreadPool(new PhotoacousticThreadPool())
 {
   MITK_INFO << "Instantiating BeamformingFilter...";
   this->SetNumberOfIndexedInputs(1);
@@ -76,12 +77,7 @@ void mitk::BeamformingFilter::GenerateOutputInformation()
   if ((output->IsInitialized()) && (this->GetMTime() <= m_TimeOfHeaderInitialization.GetMTime()))
     return;
 
-  mitk::Vector3D spacing;
-  spacing[0] = m_Conf->GetHorizontalExtent() / m_Conf->GetReconstructionLines() * 1000;
-  float desiredYSpacing = m_Conf->GetReconstructionDepth() * 1000 / m_Conf->GetSamplesPerLine();
-  float maxYSpacing = m_Conf->GetSpeedOfSound() * m_Conf->GetTimeSpacing() * input->GetDimension(1) / m_Conf->GetSamplesPerLine() * 1000;
-  spacing[1] = desiredYSpacing < maxYSpacing ? desiredYSpacing : maxYSpacing;
-  spacing[2] = 1;
+  mitk::Vector3D spacing = BeamformingUtils::OutputSpacing(m_Conf, input->GetDimension(1));
 
   unsigned int dim[] = { m_Conf->GetReconstructionLines(), m_Conf->GetSamplesPerLine(), input->GetDimension(2)};
   output->Initialize(mitk::MakeScalarPixelType<float>(), 3, dim);
@@ -114,66 +110,29 @@ void mitk::BeamformingFilter::GenerateData()
     int progInterval = output->GetDimension(2) / 20 > 1 ? output->GetDimension(2) / 20 : 1;
     // the interval at which we update the gui progress bar
 
-    float inputDim[2] = { (float)input->GetDimension(0), (float)input->GetDimension(1) };
-    float outputDim[2] = { (float)output->GetDimension(0), (float)output->GetDimension(1) };
-
-    for (unsigned int i = 0; i < output->GetDimension(2); ++i) // seperate Slices should get Beamforming seperately applied
+    if (input->GetDimension(0) != m_Conf->GetInputDim()[0] || input->GetDimension(1) != m_Conf->GetInputDim()[1])
     {
-      mitk::ImageReadAccessor inputReadAccessor(input, input->GetSliceData(i));
-      m_InputData = (float*)inputReadAccessor.GetData();
+      MITK_ERROR << "Dimensions of the input image do not match the beamforming settings.";
+      mitkThrow() << "Dimensions of the input image do not match the beamforming settings.";
+    }
 
-      m_OutputData = new float[m_Conf->GetReconstructionLines()*m_Conf->GetSamplesPerLine()];
+    // the delays only depend on the settings, so they are reused for all slices and all images beamformed with them
+    const BeamformingDelayTable* delayTable = m_Conf->GetDelayTable(m_ThreadPool.get());
+    const BeamformingSettings::BeamformingAlgorithm algorithm = m_Conf->GetAlgorithm();
 
-      // fill the image with zeros
-      for (int l = 0; l < outputDim[0]; ++l)
-      {
-        for (int s = 0; s < outputDim[1]; ++s)
-        {
-          m_OutputData[l*(short)outputDim[1] + s] = 0;
-        }
-      }
+    std::vector<float> outputData((size_t)output->GetDimension(0) * output->GetDimension(1));
 
-      std::thread *threads = new std::thread[(short)outputDim[0]];
+    for (unsigned int i = 0; i < output->GetDimension(2); ++i) // seperate Slices should get Beamforming seperately applied
+    {
+      mitk::ImageReadAccessor inputReadAccessor(input, input->GetSliceData(i));
+      const float* inputData = (const float*)inputReadAccessor.GetData();
 
-      // every line will be beamformed in a seperate thread
-      if (m_Conf->GetAlgorithm() == BeamformingSettings::BeamformingAlgorithm::DAS)
-      {
-        for (short line = 0; line < outputDim[0]; ++line)
-        {
-          threads[line] = std::thread(&BeamformingUtils::DASSphericalLine, m_InputData,
-            m_OutputData, inputDim, outputDim, line, m_Conf);
-        }
-      }
-      else if (m_Conf->GetAlgorithm() == BeamformingSettings::BeamformingAlgorithm::DMAS)
-      {
-        for (short line = 0; line < outputDim[0]; ++line)
-        {
-          threads[line] = std::thread(&BeamformingUtils::DMASSphericalLine, m_InputData,
-            m_OutputData, inputDim, outputDim, line, m_Conf);
-        }
-      }
-      else if (m_Conf->GetAlgorithm() == BeamformingSettings::BeamformingAlgorithm::sDMAS)
-      {
-        for (short line = 0; line < outputDim[0]; ++line)
-        {
-          threads[line] = std::thread(&BeamformingUtils::sDMASSphericalLine, m_InputData,
-            m_OutputData, inputDim, outputDim, line, m_Conf);
-        }
-      }
-      // wait for all lines to finish
-      for (short line = 0; line < outputDim[0]; ++line)
-      {
-        threads[line].join();
-      }
+      BeamformingUtils::BeamformSlice(inputData, outputData.data(), delayTable, algorithm, m_ThreadPool.get());
 
-      output->SetSlice(m_OutputData, i);
+      output->SetSlice(outputData.data(), i);
 
       if (i % progInterval == 0)
         m_ProgressHandle((int)((i + 1) / (float)output->GetDimension(2) * 100), "performing reconstruction");
-
-      delete[] m_OutputData;
-      m_OutputData = nullptr;
-      m_InputData = nullptr;
     }
   }
 #if defined(PHOTOACOUSTICS_USE_GPU) || DOXYGEN
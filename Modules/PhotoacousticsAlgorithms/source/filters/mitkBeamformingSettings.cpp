@@ -16,6 +16,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkBeamformingSettings.h"
 #include "mitkBeamformingUtils.h"
+#include "mitkBeamformingDelayTable.h"
 #include "itkMutexLock.h"
 
 mitk::BeamformingSettings::BeamformingSettings(float pitchInMeters,
@@ -50,7 +51,8 @@ mitk::BeamformingSettings::BeamformingSettings(float pitchInMeters,
   m_Algorithm(algorithm),
   m_Geometry(geometry),
   m_ProbeRadius(probeRadius),
-  m_MinMaxLines(nullptr)
+  m_MinMaxLines(nullptr),
+  m_DelayTable(nullptr)
 {
   if (inputDim == nullptr)
   {
@@ -131,11 +133,24 @@ mitk::BeamformingSettings::~BeamformingSettings()
   }
   if (m_MinMaxLines)
     delete[] m_MinMaxLines;
+  if (m_DelayTable)
+    delete m_DelayTable;
 }
 
 unsigned short* mitk::BeamformingSettings::GetMinMaxLines()
 {
+  std::lock_guard<std::mutex> lock(m_LazyMutex);
   if (!m_MinMaxLines)
     m_MinMaxLines = mitk::BeamformingUtils::MinMaxLines(this);
   return m_MinMaxLines;
+}
+
+const mitk::BeamformingDelayTable* mitk::BeamformingSettings::GetDelayTable(PhotoacousticThreadPool* threadPool)
+{
+  unsigned short* minMaxLines = this->GetMinMaxLines();
+
+  std::lock_guard<std::mutex> lock(m_LazyMutex);
+  if (!m_DelayTable)
+    m_DelayTable = new BeamformingDelayTable(this, minMaxLines, threadPool);
+  return m_DelayTable;
 }
\ No newline at end of file
@@ -0,0 +1,265 @@
+/*===================================================================
+mitkBandpassFilterPlan
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "mitkBandpassFilterPlan.h"
+
+#include <algorithm>
+#include <list>
+#include <mutex>
+
+std::shared_ptr<const mitk::BandpassFilterPlan> mitk::BandpassFilterPlan::GetPlan(unsigned int samples,
+  float cutoffPixelHighPass, float cutoffPixelLowPass, float alphaHighPass, float alphaLowPass)
+{
+  static std::mutex cacheMutex;
+  static std::list<std::shared_ptr<const BandpassFilterPlan>> cache;
+
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  for (auto plan = cache.begin(); plan != cache.end(); ++plan)
+  {
+    if ((*plan)->Matches(samples, cutoffPixelHighPass, cutoffPixelLowPass, alphaHighPass, alphaLowPass))
+    {
+      cache.splice(cache.begin(), cache, plan);
+      return cache.front();
+    }
+  }
+
+  cache.push_front(std::make_shared<const BandpassFilterPlan>(samples, cutoffPixelHighPass, cutoffPixelLowPass, alphaHighPass, alphaLowPass));
+  if (cache.size() > MaximumNumberOfCachedPlans)
+    cache.pop_back();
+  return cache.front();
+}
+
+unsigned int mitk::BandpassFilterPlan::TransformLength(unsigned int samples)
+{
+  unsigned int length = 1;
+  while (length < samples)
+    length *= 2;
+  return length;
+}
+
+mitk::BandpassFilterPlan::BandpassFilterPlan(unsigned int samples, float cutoffPixelHighPass, float cutoffPixelLowPass,
+  float alphaHighPass, float alphaLowPass) :
+  m_Samples(samples),
+  m_TransformLength(TransformLength(samples)),
+  m_CutoffPixelHighPass(cutoffPixelHighPass),
+  m_CutoffPixelLowPass(cutoffPixelLowPass),
+  m_AlphaHighPass(alphaHighPass),
+  m_AlphaLowPass(alphaLowPass)
+{
+  const unsigned int length = m_TransformLength;
+
+  unsigned int bits = 0;
+  while ((1u << bits) < length)
+    ++bits;
+  m_BitReversal.resize(length);
+  for (unsigned int i = 0; i < length; ++i)
+  {
+    unsigned int reversed = 0;
+    for (unsigned int bit = 0; bit < bits; ++bit)
+      reversed |= ((i >> bit) & 1) << (bits - 1 - bit);
+    m_BitReversal[i] = reversed;
+  }
+
+  m_TwiddleReal.resize(length / 2);
+  m_TwiddleImaginary.resize(length / 2);
+  for (unsigned int k = 0; k < length / 2; ++k)
+  {
+    m_TwiddleReal[k] = (float)std::cos(2 * M_PI * k / length);
+    m_TwiddleImaginary[k] = (float)-std::sin(2 * M_PI * k / length);
+  }
+
+  // the Tukey window of the former ITK implementation, including its mirroring at the center of the spectrum
+  std::vector<float> window(length, 0.f);
+  float width = cutoffPixelLowPass - cutoffPixelHighPass;
+  float center = cutoffPixelHighPass + width / 2.f;
+
+  for (int n = 0; n < width; ++n)
+  {
+    const int index = (int)(n + center - (width / 2.f));
+    if (index < 0 || index >= (int)length)
+      continue;
+
+    window[index] = 1;
+    if (n <= (alphaHighPass * (width - 1)) / 2.f)
+    {
+      if (alphaHighPass > 0.00001f)
+        window[index] = (1 + cos(M_PI * (2 * n / (alphaHighPass * (width - 1)) - 1))) / 2;
+    }
+    else if (n >= (width - 1) * (1 - alphaLowPass / 2.f))
+    {
+      if (alphaLowPass > 0.00001f)
+        window[index] = (1 + cos(M_PI * (2 * n / (alphaLowPass * (width - 1)) + 1 - 2 / alphaLowPass))) / 2;
+    }
+  }
+  for (unsigned int n = length / 2; n < length; ++n)
+  {
+    window[n] = window[length - (n + 1)];
+  }
+
+  // the real part of the filtered line only depends on the even part of the window, which keeps real lines real;
+  // the normalization of the inverse transform is included
+  m_Window.resize(length);
+  for (unsigned int k = 0; k < length; ++k)
+  {
+    m_Window[k] = (window[k] + window[(length - k) % length]) / 2 / length;
+  }
+
+  // linear interpolation as done by itk::ResampleImageFilter; positions beyond the last sample use the last sample
+  m_UpsampleIndex.resize(length);
+  m_UpsampleWeight.resize(length);
+  for (unsigned int j = 0; j < length; ++j)
+  {
+    const double position = (double)j * samples / length;
+    m_UpsampleIndex[j] = std::min((unsigned int)position, samples - 1);
+    m_UpsampleWeight[j] = (float)(position - m_UpsampleIndex[j]);
+  }
+
+  m_DownsampleIndex.resize(samples);
+  m_DownsampleWeight.resize(samples);
+  for (unsigned int i = 0; i < samples; ++i)
+  {
+    const double position = (double)i * length / samples;
+    m_DownsampleIndex[i] = std::min((unsigned int)position, length - 1);
+    m_DownsampleWeight[i] = (float)(position - m_DownsampleIndex[i]);
+  }
+}
+
+bool mitk::BandpassFilterPlan::Matches(unsigned int samples, float cutoffPixelHighPass, float cutoffPixelLowPass,
+  float alphaHighPass, float alphaLowPass) const
+{
+  return m_Samples == samples && m_CutoffPixelHighPass == cutoffPixelHighPass && m_CutoffPixelLowPass == cutoffPixelLowPass &&
+    m_AlphaHighPass == alphaHighPass && m_AlphaLowPass == alphaLowPass;
+}
+
+void mitk::BandpassFilterPlan::Transform(float* real, float* imaginary, bool inverse) const
+{
+  const unsigned int length = m_TransformLength;
+
+  for (unsigned int i = 0; i < length; ++i)
+  {
+    const unsigned int j = m_BitReversal[i];
+    if (i < j)
+    {
+      std::swap(real[i], real[j]);
+      std::swap(imaginary[i], imaginary[j]);
+    }
+  }
+
+  const float sign = inverse ? -1.f : 1.f;
+  for (unsigned int half = 1; half < length; half *= 2)
+  {
+    const unsigned int step = length / (2 * half);
+    for (unsigned int start = 0; start < length; start += 2 * half)
+    {
+      for (unsigned int k = 0; k < half; ++k)
+      {
+        const float twiddleReal = m_TwiddleReal[k * step];
+        const float twiddleImaginary = sign * m_TwiddleImaginary[k * step];
+        const unsigned int a = start + k;
+        const unsigned int b = a + half;
+
+        const float productReal = real[b] * twiddleReal - imaginary[b] * twiddleImaginary;
+        const float productImaginary = real[b] * twiddleImaginary + imaginary[b] * twiddleReal;
+        real[b] = real[a] - productReal;
+        imaginary[b] = imaginary[a] - productImaginary;
+        real[a] += productReal;
+        imaginary[a] += productImaginary;
+      }
+    }
+  }
+}
+
+void mitk::BandpassFilterPlan::Upsample(const float* line, float* resampled) const
+{
+  if (m_TransformLength == m_Samples)
+  {
+    std::copy(line, line + m_Samples, resampled);
+    return;
+  }
+
+  for (unsigned int j = 0; j < m_TransformLength; ++j)
+  {
+    const unsigned int index = m_UpsampleIndex[j];
+    const float next = line[std::min(index + 1, m_Samples - 1)];
+    resampled[j] = line[index] + (next - line[index]) * m_UpsampleWeight[j];
+  }
+}
+
+void mitk::BandpassFilterPlan::Downsample(const float* resampled, float* line) const
+{
+  if (m_TransformLength == m_Samples)
+  {
+    std::copy(resampled, resampled + m_Samples, line);
+    return;
+  }
+
+  for (unsigned int i = 0; i < m_Samples; ++i)
+  {
+    const unsigned int index = m_DownsampleIndex[i];
+    const float next = resampled[std::min(index + 1, m_TransformLength - 1)];
+    line[i] = resampled[index] + (next - resampled[index]) * m_DownsampleWeight[i];
+  }
+}
+
+void mitk::BandpassFilterPlan::FilterLines(float* data, unsigned int numberOfLines, unsigned int lineStride) const
+{
+  const unsigned int length = m_TransformLength;
+  std::vector<float> lines((size_t)numberOfLines * m_Samples);
+  std::vector<float> real(length);
+  std::vector<float> imaginary(length);
+
+  // the lines are neighbors in memory, so they are gathered and scattered together sample by sample
+  for (unsigned int sample = 0; sample < m_Samples; ++sample)
+  {
+    const float* row = data + (size_t)sample * lineStride;
+    for (unsigned int line = 0; line < numberOfLines; ++line)
+      lines[(size_t)line * m_Samples + sample] = row[line];
+  }
+
+  // two real lines are filtered at once as the real and imaginary part of one signal
+  for (unsigned int line = 0; line < numberOfLines; line += 2)
+  {
+    float* first = &lines[(size_t)line * m_Samples];
+    float* second = line + 1 < numberOfLines ? &lines[(size_t)(line + 1) * m_Samples] : nullptr;
+
+    this->Upsample(first, real.data());
+    if (second != nullptr)
+      this->Upsample(second, imaginary.data());
+    else
+      std::fill(imaginary.begin(), imaginary.end(), 0.f);
+
+    this->Transform(real.data(), imaginary.data(), false);
+    for (unsigned int k = 0; k < length; ++k)
+    {
+      real[k] *= m_Window[k];
+      imaginary[k] *= m_Window[k];
+    }
+    this->Transform(real.data(), imaginary.data(), true);
+
+    this->Downsample(real.data(), first);
+    if (second != nullptr)
+      this->Downsample(imaginary.data(), second);
+  }
+
+  for (unsigned int sample = 0; sample < m_Samples; ++sample)
+  {
+    float* row = data + (size_t)sample * lineStride;
+    for (unsigned int line = 0; line < numberOfLines; ++line)
+      row[line] = lines[(size_t)line * m_Samples + sample];
+  }
+}
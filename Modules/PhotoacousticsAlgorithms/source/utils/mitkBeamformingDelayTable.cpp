@@ -0,0 +1,114 @@
+/*===================================================================
+mitkBeamformingDelayTable
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkBeamformingDelayTable.h"
+#include "mitkBeamformingSettings.h"
+#include "mitkPhotoacousticThreadPool.h"
+
+#include <cmath>
+
+mitk::BeamformingDelayTable::BeamformingDelayTable(const BeamformingSettings* settings, const unsigned short* minMaxLines, PhotoacousticThreadPool* threadPool) :
+  m_InputLines(settings->GetInputDim()[0]),
+  m_InputSamples(settings->GetInputDim()[1]),
+  m_OutputLines(settings->GetReconstructionLines()),
+  m_OutputSamples(settings->GetSamplesPerLine()),
+  m_ElementHeights(settings->GetElementHeights(), settings->GetElementHeights() + settings->GetInputDim()[0]),
+  m_ElementPositions(settings->GetElementPositions(), settings->GetElementPositions() + settings->GetInputDim()[0]),
+  m_MetersPerSample(settings->GetSpeedOfSound() * settings->GetTimeSpacing()),
+  m_SamplesPerMeter(1 / (settings->GetTimeSpacing() * settings->GetSpeedOfSound())),
+  m_HorizontalExtent(settings->GetHorizontalExtent()),
+  m_IsPhotoacousticImage(settings->GetIsPhotoacousticImage()),
+  m_MinMaxLines(minMaxLines, minMaxLines + 2 * (std::size_t)settings->GetReconstructionLines() * settings->GetSamplesPerLine()),
+  m_HasDelays(false)
+{
+  // the reconstruction depth in input samples, as in mitk::BeamformingUtils::DASSphericalLine
+  m_TotalSamples = (float)(settings->GetReconstructionDepth()) / (float)(settings->GetSpeedOfSound() * settings->GetTimeSpacing());
+  m_TotalSamples = m_TotalSamples <= (float)m_InputSamples ? m_TotalSamples : (float)m_InputSamples;
+
+  // the apodization only depends on the number of elements and the position within the element range
+  const float* apodization = settings->GetApodizationFunction();
+  const int apodizationArraySize = settings->GetApodizationArraySize();
+  m_Apodization.resize((std::size_t)m_InputLines * (m_InputLines + 1) / 2);
+  for (unsigned int usedLines = 1; usedLines <= m_InputLines; ++usedLines)
+  {
+    float* weights = &m_Apodization[(std::size_t)usedLines * (usedLines - 1) / 2];
+    const float apodizationMultiplier = (float)apodizationArraySize / (float)usedLines;
+    for (unsigned int l = 0; l < usedLines; ++l)
+    {
+      int index = (int)((int)l * apodizationMultiplier);
+      weights[l] = apodization[index < apodizationArraySize ? index : apodizationArraySize - 1];
+    }
+  }
+
+  m_DelayOffsets.resize((std::size_t)m_OutputLines * m_OutputSamples + 1);
+  std::size_t numberOfDelays = 0;
+  for (unsigned int line = 0; line < m_OutputLines; ++line)
+  {
+    for (unsigned int sample = 0; sample < m_OutputSamples; ++sample)
+    {
+      m_DelayOffsets[(std::size_t)line * m_OutputSamples + sample] = numberOfDelays;
+      const unsigned short minLine = this->GetMinLine(line, sample);
+      const unsigned short maxLine = this->GetMaxLine(line, sample);
+      numberOfDelays += maxLine > minLine ? maxLine - minLine : 0;
+    }
+  }
+  m_DelayOffsets.back() = numberOfDelays;
+
+  if (numberOfDelays > MaximumNumberOfDelays || m_InputSamples >= InvalidDelay)
+  {
+    m_DelayOffsets.clear();
+    return;
+  }
+
+  m_Delays.resize(numberOfDelays);
+  auto computeLine = [this](unsigned int line) {
+    for (unsigned int sample = 0; sample < m_OutputSamples; ++sample)
+    {
+      this->ComputeDelays(line, sample, &m_Delays[m_DelayOffsets[(std::size_t)line * m_OutputSamples + sample]]);
+    }
+  };
+
+  if (threadPool != nullptr)
+  {
+    threadPool->ParallelFor(m_OutputLines, computeLine);
+  }
+  else
+  {
+    for (unsigned int line = 0; line < m_OutputLines; ++line)
+      computeLine(line);
+  }
+  m_HasDelays = true;
+}
+
+void mitk::BeamformingDelayTable::ComputeDelays(unsigned int line, unsigned int sample, unsigned short* delays) const
+{
+  const float l_p = (float)line / (float)m_OutputLines * m_HorizontalExtent;
+  const float s_i = (float)sample / (float)m_OutputSamples * m_TotalSamples;
+
+  const unsigned short minLine = this->GetMinLine(line, sample);
+  const unsigned short maxLine = this->GetMaxLine(line, sample);
+
+  for (unsigned short l_s = minLine; l_s < maxLine; ++l_s)
+  {
+    // same arithmetic as the delays in mitk::BeamformingUtils::DASSphericalLine, so that the samples match exactly
+    const double verticalDistance = s_i - m_ElementHeights[l_s] / m_MetersPerSample;
+    const double horizontalDistance = m_SamplesPerMeter * (l_p - m_ElementPositions[l_s]);
+    const float delay = (int)std::sqrt(verticalDistance * verticalDistance + horizontalDistance * horizontalDistance) +
+      (1 - (int)m_IsPhotoacousticImage) * s_i;
+
+    delays[l_s - minLine] = delay >= 0 && delay < (float)m_InputSamples ? (unsigned short)delay : InvalidDelay;
+  }
+}
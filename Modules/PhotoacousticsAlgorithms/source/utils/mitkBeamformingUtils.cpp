@@ -17,6 +17,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkProperties.h"
 #include "mitkImageReadAccessor.h"
 #include <algorithm>
+#include <cmath>
+#include <vector>
 #include <itkImageIOBase.h>
 #include <chrono>
 #include <thread>
@@ -24,6 +26,67 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageCast.h"
 #include "mitkBeamformingUtils.h"
 
+namespace
+{
+  // size of the output tiles beamformed by one task; neighboring pixels mostly read the same cache lines of the input
+  const unsigned int TileLines = 8;
+  const unsigned int TileSamples = 64;
+
+  // number of independent partial sums, which the compiler keeps in one SIMD register
+  const unsigned int Lanes = 8;
+
+  float Sum(const float* values, unsigned int count)
+  {
+    float partialSums[Lanes] = {};
+    unsigned int i = 0;
+    for (; i + Lanes <= count; i += Lanes)
+    {
+      for (unsigned int lane = 0; lane < Lanes; ++lane)
+        partialSums[lane] += values[i + lane];
+    }
+
+    float sum = 0;
+    for (; i < count; ++i)
+      sum += values[i];
+    for (unsigned int lane = 0; lane < Lanes; ++lane)
+      sum += partialSums[lane];
+    return sum;
+  }
+
+  // sums up sign(v) * sqrt(|v|) and |v| of the values
+  void SumSignedRoots(const float* values, unsigned int count, float& sumOfRoots, float& sumOfMagnitudes)
+  {
+    float partialRoots[Lanes] = {};
+    float partialMagnitudes[Lanes] = {};
+    unsigned int i = 0;
+    for (; i + Lanes <= count; i += Lanes)
+    {
+      for (unsigned int lane = 0; lane < Lanes; ++lane)
+      {
+        const float magnitude = std::abs(values[i + lane]);
+        const float root = std::sqrt(magnitude);
+        partialRoots[lane] += values[i + lane] < 0 ? -root : root;
+        partialMagnitudes[lane] += magnitude;
+      }
+    }
+
+    sumOfRoots = 0;
+    sumOfMagnitudes = 0;
+    for (; i < count; ++i)
+    {
+      const float magnitude = std::abs(values[i]);
+      const float root = std::sqrt(magnitude);
+      sumOfRoots += values[i] < 0 ? -root : root;
+      sumOfMagnitudes += magnitude;
+    }
+    for (unsigned int lane = 0; lane < Lanes; ++lane)
+    {
+      sumOfRoots += partialRoots[lane];
+      sumOfMagnitudes += partialMagnitudes[lane];
+    }
+  }
+}
+
 mitk::BeamformingUtils::BeamformingUtils()
 {
 }
@@ -418,3 +481,104 @@ void mitk::BeamformingUtils::sDMASSphericalLine(
     delete[] AddSample;
   }
 }
+
+void mitk::BeamformingUtils::BeamformTile(const float* input, float* output, const BeamformingDelayTable* table,
+  BeamformingSettings::BeamformingAlgorithm algorithm,
+  unsigned int firstLine, unsigned int endLine, unsigned int firstSample, unsigned int endSample)
+{
+  const unsigned int inputL = table->GetInputLines();
+  const unsigned int outputL = table->GetOutputLines();
+
+  // the delays of the current pixel, if the table does not store them, and its apodized samples
+  std::vector<unsigned short> delayBuffer(table->HasDelays() ? 0 : inputL);
+  std::vector<float> values(inputL);
+
+  // the table stores the delays line by line
+  for (unsigned int line = firstLine; line < endLine; ++line)
+  {
+    for (unsigned int sample = firstSample; sample < endSample; ++sample)
+    {
+      float& pixel = output[(size_t)sample * outputL + line];
+
+      const unsigned short minLine = table->GetMinLine(line, sample);
+      const unsigned short maxLine = table->GetMaxLine(line, sample);
+      if (maxLine <= minLine)
+      {
+        pixel = 0;
+        continue;
+      }
+      const unsigned int usedLines = maxLine - minLine;
+
+      const unsigned short* delays = nullptr;
+      if (table->HasDelays())
+      {
+        delays = table->GetDelays(line, sample);
+      }
+      else
+      {
+        table->ComputeDelays(line, sample, delayBuffer.data());
+        delays = delayBuffer.data();
+      }
+      const float* apodization = table->GetApodization(usedLines);
+
+      // gather the apodized samples of all elements whose delayed sample lies inside of the input
+      const float* elementInput = input + minLine;
+      unsigned int count = 0;
+      float sign = 0;
+      for (unsigned int l = 0; l < usedLines; ++l)
+      {
+        if (delays[l] == BeamformingDelayTable::InvalidDelay)
+          continue;
+
+        const float value = elementInput[l + (size_t)delays[l] * inputL];
+        values[count++] = value * apodization[l];
+        if (l + 1 < usedLines)
+          sign += value;
+      }
+
+      if (algorithm == BeamformingSettings::BeamformingAlgorithm::DAS)
+      {
+        pixel = count > 0 ? Sum(values.data(), count) / count : 0;
+        continue;
+      }
+
+      float sumOfRoots = 0;
+      float sumOfMagnitudes = 0;
+      SumSignedRoots(values.data(), count, sumOfRoots, sumOfMagnitudes);
+
+      // like the line functions, the normalization does not discount an invalid last element
+      const int dmasLines = (int)count + (delays[usedLines - 1] == BeamformingDelayTable::InvalidDelay ? 1 : 0);
+      pixel = (float)(0.5 * ((double)sumOfRoots * sumOfRoots - sumOfMagnitudes)) / (float)(dmasLines * dmasLines - (dmasLines - 1));
+
+      if (algorithm == BeamformingSettings::BeamformingAlgorithm::sDMAS)
+        pixel *= (float)((sign > 0) - (sign < 0));
+    }
+  }
+}
+
+void mitk::BeamformingUtils::BeamformSlice(const float* input, float* output, const BeamformingDelayTable* table,
+  BeamformingSettings::BeamformingAlgorithm algorithm, PhotoacousticThreadPool* threadPool)
+{
+  const unsigned int outputL = table->GetOutputLines();
+  const unsigned int outputS = table->GetOutputSamples();
+  const unsigned int lineTiles = (outputL + TileLines - 1) / TileLines;
+  const unsigned int sampleTiles = (outputS + TileSamples - 1) / TileSamples;
+
+  threadPool->ParallelFor(lineTiles * sampleTiles, [&](unsigned int tile) {
+    const unsigned int firstLine = tile % lineTiles * TileLines;
+    const unsigned int firstSample = tile / lineTiles * TileSamples;
+    BeamformTile(input, output, table, algorithm,
+      firstLine, std::min(firstLine + TileLines, outputL), firstSample, std::min(firstSample + TileSamples, outputS));
+  });
+}
+
+mitk::Vector3D mitk::BeamformingUtils::OutputSpacing(const mitk::BeamformingSettings::Pointer config, unsigned int inputSamples)
+{
+  mitk::Vector3D spacing;
+  spacing[0] = config->GetHorizontalExtent() / config->GetReconstructionLines() * 1000;
+  float desiredYSpacing = config->GetReconstructionDepth() * 1000 / config->GetSamplesPerLine();
+  float maxYSpacing = config->GetSpeedOfSound() * config->GetTimeSpacing() * inputSamples / config->GetSamplesPerLine() * 1000;
+  spacing[1] = desiredYSpacing < maxYSpacing ? desiredYSpacing : maxYSpacing;
+  spacing[2] = 1;
+  return spacing;
+}
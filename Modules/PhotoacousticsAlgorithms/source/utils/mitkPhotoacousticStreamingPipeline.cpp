@@ -0,0 +1,444 @@
+/*===================================================================
+mitkPhotoacousticStreamingPipeline
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPhotoacousticStreamingPipeline.h"
+#include "mitkBeamformingUtils.h"
+#include "mitkImageReadAccessor.h"
+#include "mitkImageWriteAccessor.h"
+#include "../ITKFilter/ITKUltrasound/itkBModeImageFilter.h"
+#include "../ITKFilter/itkPhotoacousticBModeImageFilter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <thread>
+
+/** \brief A blocking queue of frames. Pop() returns nullptr once the queue is closed and empty.
+*/
+class mitk::PhotoacousticStreamingPipeline::FrameQueue
+{
+public:
+  FrameQueue() : m_Closed(false) {}
+
+  void Push(Frame* frame)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Frames.push_back(frame);
+    }
+    m_Condition.notify_one();
+  }
+
+  Frame* Pop()
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Condition.wait(lock, [this] { return m_Closed || !m_Frames.empty(); });
+    return this->PopLocked();
+  }
+
+  Frame* TryPop()
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return this->PopLocked();
+  }
+
+  void Close()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Closed = true;
+    }
+    m_Condition.notify_all();
+  }
+
+private:
+  Frame* PopLocked()
+  {
+    if (m_Frames.empty())
+      return nullptr;
+    Frame* frame = m_Frames.front();
+    m_Frames.pop_front();
+    return frame;
+  }
+
+  std::deque<Frame*> m_Frames;
+  bool m_Closed;
+  std::mutex m_Mutex;
+  std::condition_variable m_Condition;
+};
+
+struct mitk::PhotoacousticStreamingPipeline::Frame
+{
+  unsigned long number;
+  std::chrono::high_resolution_clock::time_point pushTime;
+  std::vector<float> raw;
+  std::vector<float> beamformed;
+  mitk::Image::Pointer output;
+};
+
+struct mitk::PhotoacousticStreamingPipeline::Stage
+{
+  std::function<void(Frame&)> process;
+  FrameQueue input;
+  std::thread thread;
+  StageStatistics statistics;
+};
+
+/** \brief The envelope detection of the cropped frames. The filter is created once and keeps its buffers from frame to
+* frame, its input references the output image of the current frame.
+*/
+struct mitk::PhotoacousticStreamingPipeline::EnvelopeDetection
+{
+  typedef itk::Image<float, 3> ImageType;
+
+  ImageType::Pointer input;
+  itk::ImageToImageFilter<ImageType, ImageType>::Pointer filter;
+};
+
+namespace
+{
+  double MillisecondsSince(std::chrono::high_resolution_clock::time_point begin)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count();
+  }
+
+  mitk::PhotoacousticStreamingPipeline::StageStatistics EmptyStatistics(const std::string& name)
+  {
+    return { name, 0, 0, 0, 0 };
+  }
+}
+
+mitk::PhotoacousticStreamingPipeline::PhotoacousticStreamingPipeline() :
+  m_UseBandpass(false),
+  m_BandpassHighPass(0),
+  m_BandpassLowPass(0),
+  m_BandpassHighPassAlpha(0.5f),
+  m_BandpassLowPassAlpha(0.5f),
+  m_CropAbove(0),
+  m_CropBelow(0),
+  m_CropLeft(0),
+  m_CropRight(0),
+  m_UseBMode(true),
+  m_BModeMethod(PhotoacousticFilterService::BModeMethod::Abs),
+  m_UseLogFilter(false),
+  m_NumberOfBufferedFrames(4),
+  m_WaitForFreeBuffer(false),
+  m_Running(false),
+  m_NumberOfPushedFrames(0),
+  m_NumberOfDroppedFrames(0),
+  m_TotalStatistics(EmptyStatistics("total")),
+  m_DelayTable(nullptr)
+{
+}
+
+mitk::PhotoacousticStreamingPipeline::~PhotoacousticStreamingPipeline()
+{
+  this->Stop();
+}
+
+void mitk::PhotoacousticStreamingPipeline::SetFrameHandler(std::function<void(mitk::Image::Pointer, unsigned long)> frameHandler)
+{
+  if (this->IsRunning())
+    mitkThrow() << "The frame handler cannot be changed while the pipeline is running.";
+  m_FrameHandler = frameHandler;
+}
+
+void mitk::PhotoacousticStreamingPipeline::Start()
+{
+  if (this->IsRunning())
+    return;
+  if (m_BeamformingSettings.IsNull())
+    mitkThrow() << "No beamforming settings have been set.";
+  if (m_NumberOfBufferedFrames < 2)
+    mitkThrow() << "At least two frames must be buffered.";
+
+  const unsigned int inputLines = m_BeamformingSettings->GetInputDim()[0];
+  const unsigned int inputSamples = m_BeamformingSettings->GetInputDim()[1];
+  const unsigned int outputLines = m_BeamformingSettings->GetReconstructionLines();
+  const unsigned int outputSamples = m_BeamformingSettings->GetSamplesPerLine();
+  if (m_CropLeft + m_CropRight >= outputLines || m_CropAbove + m_CropBelow >= outputSamples)
+    mitkThrow() << "The cropping removes the whole beamformed image.";
+
+  // everything that depends on the settings is created here, so that the first frame is not slower than the others
+  m_ThreadPool.reset(new PhotoacousticThreadPool());
+  m_DelayTable = m_BeamformingSettings->GetDelayTable(m_ThreadPool.get());
+
+  m_Frames.clear();
+  m_FreeFrames.reset(new FrameQueue());
+  for (unsigned int i = 0; i < m_NumberOfBufferedFrames; ++i)
+  {
+    std::unique_ptr<Frame> frame(new Frame());
+    frame->number = 0;
+    frame->raw.resize((size_t)inputLines * inputSamples);
+    frame->beamformed.resize((size_t)outputLines * outputSamples);
+    frame->output = this->CreateOutputImage();
+    m_FreeFrames->Push(frame.get());
+    m_Frames.push_back(std::move(frame));
+  }
+
+  std::vector<std::pair<std::string, std::function<void(Frame&)>>> stages;
+  if (m_UseBandpass)
+  {
+    m_BandpassFilter = BandpassFilter::New();
+    m_BandpassFilter->SetHighPass(m_BandpassHighPass);
+    m_BandpassFilter->SetLowPass(m_BandpassLowPass);
+    m_BandpassFilter->SetHighPassAlpha(m_BandpassHighPassAlpha);
+    m_BandpassFilter->SetLowPassAlpha(m_BandpassLowPassAlpha);
+    m_BandpassFilter->SetTimeSpacing(m_BeamformingSettings->GetTimeSpacing());
+    m_BandpassFilter->SetSpeedOfSound(m_BeamformingSettings->GetSpeedOfSound());
+    m_BandpassFilter->SetIsBFImage(false);
+    stages.emplace_back("bandpass", [this](Frame& frame) { this->Bandpass(frame); });
+  }
+  stages.emplace_back("beamforming", [this](Frame& frame) { this->Beamform(frame); });
+  m_EnvelopeDetection.reset();
+  if (m_UseBMode && m_BModeMethod == PhotoacousticFilterService::BModeMethod::EnvelopeDetection)
+  {
+    typedef EnvelopeDetection::ImageType ImageType;
+    m_EnvelopeDetection.reset(new EnvelopeDetection());
+
+    ImageType::SizeType size;
+    size[0] = outputLines - m_CropLeft - m_CropRight;
+    size[1] = outputSamples - m_CropAbove - m_CropBelow;
+    size[2] = 1;
+    m_EnvelopeDetection->input = ImageType::New();
+    m_EnvelopeDetection->input->SetRegions(size);
+
+    // the same filters as mitk::PhotoacousticFilterService::ApplyBmodeFilter()
+    if (m_UseLogFilter)
+    {
+      auto filter = itk::BModeImageFilter<ImageType, ImageType>::New();
+      filter->SetDirection(1);
+      m_EnvelopeDetection->filter = filter;
+    }
+    else
+    {
+      auto filter = itk::PhotoacousticBModeImageFilter<ImageType, ImageType>::New();
+      filter->SetDirection(1);
+      m_EnvelopeDetection->filter = filter;
+    }
+    m_EnvelopeDetection->filter->SetInput(m_EnvelopeDetection->input);
+  }
+  stages.emplace_back("cropping and B-mode", [this](Frame& frame) { this->CropAndBMode(frame); });
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_NumberOfPushedFrames = 0;
+    m_NumberOfDroppedFrames = 0;
+    m_TotalStatistics = EmptyStatistics("total");
+    m_Stages.clear();
+    for (auto& stage : stages)
+    {
+      std::unique_ptr<Stage> newStage(new Stage());
+      newStage->process = stage.second;
+      newStage->statistics = EmptyStatistics(stage.first);
+      m_Stages.push_back(std::move(newStage));
+    }
+    m_Running = true;
+  }
+
+  for (unsigned int stage = 0; stage < m_Stages.size(); ++stage)
+  {
+    m_Stages[stage]->thread = std::thread(&PhotoacousticStreamingPipeline::RunStage, this, stage);
+  }
+}
+
+void mitk::PhotoacousticStreamingPipeline::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (!m_Running)
+      return;
+    m_Running = false;
+  }
+
+  // a stage passes all of its frames on before it ends, so the stages are closed in processing order
+  for (auto& stage : m_Stages)
+  {
+    stage->input.Close();
+    stage->thread.join();
+  }
+  m_FreeFrames->Close();
+  m_ThreadPool.reset();
+}
+
+bool mitk::PhotoacousticStreamingPipeline::IsRunning() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Running;
+}
+
+bool mitk::PhotoacousticStreamingPipeline::PushFrame(mitk::Image::Pointer frame)
+{
+  if (m_BeamformingSettings.IsNull() || frame->GetDimension(0) != m_BeamformingSettings->GetInputDim()[0] ||
+    frame->GetDimension(1) != m_BeamformingSettings->GetInputDim()[1])
+    mitkThrow() << "The dimensions of the frame do not match the beamforming settings.";
+  if (!(frame->GetPixelType() == mitk::MakeScalarPixelType<float>()))
+    mitkThrow() << "Only frames of type float can be reconstructed.";
+
+  mitk::ImageReadAccessor readAccess(frame, frame->GetSliceData(0));
+  return this->PushFrame((const float*)readAccess.GetData());
+}
+
+bool mitk::PhotoacousticStreamingPipeline::PushFrame(const float* frame)
+{
+  auto pushTime = std::chrono::high_resolution_clock::now();
+  if (!this->IsRunning())
+    mitkThrow() << "The pipeline has not been started.";
+
+  Frame* buffer = m_WaitForFreeBuffer ? m_FreeFrames->Pop() : m_FreeFrames->TryPop();
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  const unsigned long number = m_NumberOfPushedFrames++;
+  if (buffer == nullptr || !m_Running)
+  {
+    if (buffer != nullptr)
+      m_FreeFrames->Push(buffer);
+    ++m_NumberOfDroppedFrames;
+    return false;
+  }
+
+  buffer->number = number;
+  buffer->pushTime = pushTime;
+  std::copy(frame, frame + buffer->raw.size(), buffer->raw.begin());
+  m_Stages.front()->input.Push(buffer);
+  return true;
+}
+
+unsigned long mitk::PhotoacousticStreamingPipeline::GetNumberOfDroppedFrames() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumberOfDroppedFrames;
+}
+
+std::vector<mitk::PhotoacousticStreamingPipeline::StageStatistics> mitk::PhotoacousticStreamingPipeline::GetStageStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  std::vector<StageStatistics> statistics;
+  for (auto& stage : m_Stages)
+    statistics.push_back(stage->statistics);
+  statistics.push_back(m_TotalStatistics);
+  return statistics;
+}
+
+void mitk::PhotoacousticStreamingPipeline::RecordLatency(StageStatistics& statistics, double latency)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  statistics.lastLatency = latency;
+  statistics.averageLatency = (statistics.averageLatency * statistics.numberOfFrames + latency) / (statistics.numberOfFrames + 1);
+  statistics.maximumLatency = std::max(statistics.maximumLatency, latency);
+  ++statistics.numberOfFrames;
+}
+
+mitk::Image::Pointer mitk::PhotoacousticStreamingPipeline::CreateOutputImage() const
+{
+  unsigned int outputDim[] = { m_BeamformingSettings->GetReconstructionLines() - m_CropLeft - m_CropRight,
+    m_BeamformingSettings->GetSamplesPerLine() - m_CropAbove - m_CropBelow, 1 };
+
+  mitk::Image::Pointer output = mitk::Image::New();
+  output->Initialize(mitk::MakeScalarPixelType<float>(), 3, outputDim);
+  output->GetGeometry()->SetSpacing(BeamformingUtils::OutputSpacing(m_BeamformingSettings, m_BeamformingSettings->GetInputDim()[1]));
+  return output;
+}
+
+void mitk::PhotoacousticStreamingPipeline::RunStage(unsigned int stage)
+{
+  Stage& currentStage = *m_Stages[stage];
+  const bool isLastStage = stage + 1 == m_Stages.size();
+
+  while (Frame* frame = currentStage.input.Pop())
+  {
+    auto begin = std::chrono::high_resolution_clock::now();
+    try
+    {
+      currentStage.process(*frame);
+      this->RecordLatency(currentStage.statistics, MillisecondsSince(begin));
+
+      if (!isLastStage)
+      {
+        m_Stages[stage + 1]->input.Push(frame);
+        continue;
+      }
+
+      if (m_FrameHandler)
+      {
+        const int referenceCount = frame->output->GetReferenceCount();
+        m_FrameHandler(frame->output, frame->number);
+
+        // the handler kept the image, it must not be overwritten by the next frame in this buffer
+        if (frame->output->GetReferenceCount() > referenceCount)
+          frame->output = this->CreateOutputImage();
+      }
+      this->RecordLatency(m_TotalStatistics, MillisecondsSince(frame->pushTime));
+    }
+    catch (std::exception& e)
+    {
+      MITK_ERROR << "Frame " << frame->number << " has been dropped in stage " << currentStage.statistics.name << ": " << e.what();
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      ++m_NumberOfDroppedFrames;
+    }
+    m_FreeFrames->Push(frame);
+  }
+}
+
+void mitk::PhotoacousticStreamingPipeline::Bandpass(Frame& frame)
+{
+  m_BandpassFilter->FilterInPlace(frame.raw.data(), m_BeamformingSettings->GetInputDim()[0], m_BeamformingSettings->GetInputDim()[1], 1);
+}
+
+void mitk::PhotoacousticStreamingPipeline::Beamform(Frame& frame)
+{
+  BeamformingUtils::BeamformSlice(frame.raw.data(), frame.beamformed.data(), m_DelayTable, m_BeamformingSettings->GetAlgorithm(), m_ThreadPool.get());
+}
+
+void mitk::PhotoacousticStreamingPipeline::CropAndBMode(Frame& frame)
+{
+  const unsigned int beamformedLines = m_BeamformingSettings->GetReconstructionLines();
+  const unsigned int outputLines = frame.output->GetDimension(0);
+  const unsigned int outputSamples = frame.output->GetDimension(1);
+  const bool useAbs = m_UseBMode && m_BModeMethod == PhotoacousticFilterService::BModeMethod::Abs;
+
+  mitk::ImageWriteAccessor writeAccess(frame.output, frame.output->GetSliceData(0));
+  float* outputData = (float*)writeAccess.GetData();
+
+  for (unsigned int sample = 0; sample < outputSamples; ++sample)
+  {
+    const float* beamformedLine = &frame.beamformed[(size_t)(sample + m_CropAbove) * beamformedLines + m_CropLeft];
+    float* outputLine = &outputData[(size_t)sample * outputLines];
+
+    // the same operations as mitk::PhotoacousticBModeFilter
+    if (!useAbs)
+      std::copy(beamformedLine, beamformedLine + outputLines, outputLine);
+    else if (m_UseLogFilter)
+      std::transform(beamformedLine, beamformedLine + outputLines, outputLine, [](float value) { return (float)log(std::abs(value)); });
+    else
+      std::transform(beamformedLine, beamformedLine + outputLines, outputLine, [](float value) { return std::abs(value); });
+  }
+
+  if (!m_EnvelopeDetection)
+    return;
+
+  // the filter reads the cropped frame in place and is copied back, its output buffer is reused for every frame
+  const size_t numberOfPixels = (size_t)outputLines * outputSamples;
+  m_EnvelopeDetection->input->GetPixelContainer()->SetImportPointer(outputData, numberOfPixels, false);
+  m_EnvelopeDetection->input->Modified();
+  m_EnvelopeDetection->filter->Update();
+
+  const float* envelope = m_EnvelopeDetection->filter->GetOutput()->GetBufferPointer();
+  std::copy(envelope, envelope + numberOfPixels, outputData);
+}
@@ -0,0 +1,130 @@
+/*===================================================================
+mitkPhotoacousticThreadPool
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPhotoacousticThreadPool.h"
+
+mitk::PhotoacousticThreadPool::PhotoacousticThreadPool(unsigned int numberOfThreads) :
+  m_Task(nullptr),
+  m_NumberOfTasks(0),
+  m_NextTask(0),
+  m_Generation(0),
+  m_NumberOfBusyWorkers(0),
+  m_Stop(false)
+{
+  if (numberOfThreads == 0)
+    numberOfThreads = std::thread::hardware_concurrency();
+  if (numberOfThreads == 0)
+    numberOfThreads = 1;
+
+  for (unsigned int i = 1; i < numberOfThreads; ++i)
+  {
+    m_Workers.emplace_back(&PhotoacousticThreadPool::WorkerLoop, this);
+  }
+}
+
+mitk::PhotoacousticThreadPool::~PhotoacousticThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stop = true;
+  }
+  m_WorkAvailable.notify_all();
+
+  for (auto& worker : m_Workers)
+  {
+    worker.join();
+  }
+}
+
+unsigned int mitk::PhotoacousticThreadPool::GetNumberOfThreads() const
+{
+  return (unsigned int)m_Workers.size() + 1;
+}
+
+void mitk::PhotoacousticThreadPool::ParallelFor(unsigned int numberOfTasks, const std::function<void(unsigned int)>& task)
+{
+  if (numberOfTasks == 0)
+    return;
+
+  std::lock_guard<std::mutex> parallelForLock(m_ParallelForMutex);
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Task = &task;
+    m_NumberOfTasks = numberOfTasks;
+    m_NextTask = 0;
+    m_Exception = nullptr;
+    m_NumberOfBusyWorkers = (unsigned int)m_Workers.size();
+    ++m_Generation;
+  }
+  m_WorkAvailable.notify_all();
+
+  this->RunTasks();
+
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_WorkDone.wait(lock, [this] { return m_NumberOfBusyWorkers == 0; });
+  m_Task = nullptr;
+
+  if (m_Exception)
+    std::rethrow_exception(m_Exception);
+}
+
+void mitk::PhotoacousticThreadPool::WorkerLoop()
+{
+  unsigned long generation = 0;
+
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_WorkAvailable.wait(lock, [this, generation] { return m_Stop || m_Generation != generation; });
+      if (m_Stop)
+        return;
+      generation = m_Generation;
+    }
+
+    this->RunTasks();
+
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      --m_NumberOfBusyWorkers;
+    }
+    m_WorkDone.notify_one();
+  }
+}
+
+void mitk::PhotoacousticThreadPool::RunTasks()
+{
+  while (true)
+  {
+    const unsigned int task = m_NextTask.fetch_add(1);
+    if (task >= m_NumberOfTasks)
+      return;
+
+    try
+    {
+      (*m_Task)(task);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      if (!m_Exception)
+        m_Exception = std::current_exception();
+      // skip the remaining tasks
+      m_NextTask = m_NumberOfTasks;
+    }
+  }
+}
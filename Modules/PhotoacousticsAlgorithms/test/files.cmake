@@ -17,5 +17,8 @@ set(MODULE_TESTS
   mitkPAFilterServiceTest.cpp
   mitkCastToFloatImageFilterTest.cpp
   mitkCropImageFilterTest.cpp
+  mitkBeamformingUtilsTest.cpp
+  mitkPhotoacousticStreamingPipelineTest.cpp
+  mitkBandpassFilterPlanTest.cpp
   )
 set(RESOURCE_FILES)
@@ -0,0 +1,198 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+#include <mitkBandpassFilter.h>
+#include <mitkBandpassFilterPlan.h>
+#include <algorithm>
+#include <complex>
+#include <random>
+
+class mitkBandpassFilterPlanTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkBandpassFilterPlanTestSuite);
+  MITK_TEST(testFilterLines_PowerOfTwo_EqualsDiscreteFourierTransform);
+  MITK_TEST(testFilterLines_Resampled_EqualsDiscreteFourierTransform);
+  MITK_TEST(testFilterInPlace_AllSlices_EqualsFilterLines);
+  MITK_TEST(testGetPlan_ReturnsCachedPlan);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  const unsigned int LINES = 37;
+  const unsigned int SLICES = 3;
+
+  std::vector<float> m_Data;
+
+  /** \brief The window of the former ITK implementation of mitk::BandpassFilter.
+  */
+  std::vector<double> Window(unsigned int length, float cutoffPixelHighPass, float cutoffPixelLowPass, float alphaHighPass, float alphaLowPass)
+  {
+    std::vector<double> window(length, 0);
+    float width = cutoffPixelLowPass - cutoffPixelHighPass;
+    float center = cutoffPixelHighPass + width / 2.f;
+    for (int n = 0; n < width; ++n)
+    {
+      const int index = (int)(n + center - (width / 2.f));
+      window[index] = 1;
+      if (n <= (alphaHighPass * (width - 1)) / 2.f)
+      {
+        if (alphaHighPass > 0.00001f)
+          window[index] = (float)((1 + cos(M_PI * (2 * n / (alphaHighPass * (width - 1)) - 1))) / 2);
+      }
+      else if (n >= (width - 1) * (1 - alphaLowPass / 2.f))
+      {
+        if (alphaLowPass > 0.00001f)
+          window[index] = (float)((1 + cos(M_PI * (2 * n / (alphaLowPass * (width - 1)) + 1 - 2 / alphaLowPass))) / 2);
+      }
+    }
+    for (unsigned int n = length / 2; n < length; ++n)
+      window[n] = window[length - (n + 1)];
+    return window;
+  }
+
+  std::vector<double> Resample(const std::vector<double>& line, unsigned int length)
+  {
+    std::vector<double> resampled(length);
+    for (unsigned int j = 0; j < length; ++j)
+    {
+      const double position = (double)j * line.size() / length;
+      const unsigned int index = std::min((unsigned int)position, (unsigned int)line.size() - 1);
+      const unsigned int next = std::min(index + 1, (unsigned int)line.size() - 1);
+      resampled[j] = line[index] + (line[next] - line[index]) * (position - index);
+    }
+    return resampled;
+  }
+
+  /** \brief Resamples the line, multiplies its discrete Fourier transform with the window and returns the real part of the resampled inverse transform.
+  */
+  std::vector<double> FilterWithDiscreteFourierTransform(const std::vector<double>& line, float cutoffPixelHighPass, float cutoffPixelLowPass,
+    float alphaHighPass, float alphaLowPass)
+  {
+    const unsigned int length = mitk::BandpassFilterPlan::TransformLength((unsigned int)line.size());
+    const std::vector<double> window = Window(length, cutoffPixelHighPass, cutoffPixelLowPass, alphaHighPass, alphaLowPass);
+    const std::vector<double> resampled = Resample(line, length);
+
+    std::vector<std::complex<double>> spectrum(length);
+    for (unsigned int k = 0; k < length; ++k)
+    {
+      for (unsigned int n = 0; n < length; ++n)
+        spectrum[k] += resampled[n] * std::polar(1.0, -2 * M_PI * k * n / length);
+      spectrum[k] *= window[k];
+    }
+
+    std::vector<double> filtered(length);
+    for (unsigned int n = 0; n < length; ++n)
+    {
+      std::complex<double> value = 0;
+      for (unsigned int k = 0; k < length; ++k)
+        value += spectrum[k] * std::polar(1.0, 2 * M_PI * k * n / length);
+      filtered[n] = value.real() / length;
+    }
+    return Resample(filtered, (unsigned int)line.size());
+  }
+
+  void testPlan(unsigned int samples, float cutoffPixelHighPass, float cutoffPixelLowPass, float alphaHighPass, float alphaLowPass)
+  {
+    m_Data.resize((size_t)LINES * samples);
+    std::default_random_engine randomGenerator(42);
+    std::normal_distribution<float> noise(0, 1);
+    for (auto& value : m_Data)
+      value = noise(randomGenerator);
+    std::vector<float> filtered = m_Data;
+
+    mitk::BandpassFilterPlan plan(samples, cutoffPixelHighPass, cutoffPixelLowPass, alphaHighPass, alphaLowPass);
+    plan.FilterLines(filtered.data(), LINES, LINES);
+
+    for (unsigned int line = 0; line < LINES; line += 9)
+    {
+      std::vector<double> input(samples);
+      for (unsigned int sample = 0; sample < samples; ++sample)
+        input[sample] = m_Data[(size_t)sample * LINES + line];
+
+      const std::vector<double> expected = FilterWithDiscreteFourierTransform(input, cutoffPixelHighPass, cutoffPixelLowPass, alphaHighPass, alphaLowPass);
+      for (unsigned int sample = 0; sample < samples; ++sample)
+      {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Line " + std::to_string(line) + ", sample " + std::to_string(sample),
+          expected[sample], filtered[(size_t)sample * LINES + line], 1e-4);
+      }
+    }
+  }
+
+public:
+
+  void tearDown() override
+  {
+    m_Data.clear();
+  }
+
+  void testFilterLines_PowerOfTwo_EqualsDiscreteFourierTransform()
+  {
+    testPlan(256, 10.f, 60.f, 0.5f, 0.5f);
+    testPlan(128, 0.f, 64.f, 0.f, 1.f);
+  }
+
+  void testFilterLines_Resampled_EqualsDiscreteFourierTransform()
+  {
+    testPlan(300, 20.f, 100.f, 1.f, 0.2f);
+  }
+
+  void testFilterInPlace_AllSlices_EqualsFilterLines()
+  {
+    const unsigned int samples = 200;
+    const float timeSpacing = 0.00625f / 1000000; // s
+    m_Data.resize((size_t)LINES * samples * SLICES);
+    std::default_random_engine randomGenerator(42);
+    std::normal_distribution<float> noise(0, 1);
+    for (auto& value : m_Data)
+      value = noise(randomGenerator);
+
+    auto filter = mitk::BandpassFilter::New();
+    filter->SetHighPass(5e6f);
+    filter->SetLowPass(20e6f);
+    filter->SetHighPassAlpha(0.5f);
+    filter->SetLowPassAlpha(0.5f);
+    filter->SetTimeSpacing(timeSpacing);
+    filter->SetIsBFImage(false);
+
+    std::vector<float> filtered = m_Data;
+    filter->FilterInPlace(filtered.data(), LINES, samples, SLICES);
+
+    // the cutoffs in frequency bins of the transform of 256 samples
+    const float singleVoxel = (double)samples / 256 / (timeSpacing * 256);
+    mitk::BandpassFilterPlan plan(samples, 5e6f / singleVoxel, 20e6f / singleVoxel, 0.5f, 0.5f);
+    plan.FilterLines(m_Data.data(), LINES, LINES);
+    plan.FilterLines(&m_Data[(size_t)LINES * samples], LINES, LINES);
+    plan.FilterLines(&m_Data[(size_t)2 * LINES * samples], LINES, LINES);
+
+    for (size_t i = 0; i < m_Data.size(); ++i)
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(m_Data[i], filtered[i], 1e-5);
+  }
+
+  void testGetPlan_ReturnsCachedPlan()
+  {
+    auto plan = mitk::BandpassFilterPlan::GetPlan(1000, 3.f, 40.f, 0.5f, 0.5f);
+    CPPUNIT_ASSERT_EQUAL(1000u, plan->GetSamples());
+    CPPUNIT_ASSERT_EQUAL(1024u, plan->GetTransformLength());
+    CPPUNIT_ASSERT(plan == mitk::BandpassFilterPlan::GetPlan(1000, 3.f, 40.f, 0.5f, 0.5f));
+    CPPUNIT_ASSERT(plan != mitk::BandpassFilterPlan::GetPlan(1000, 3.f, 41.f, 0.5f, 0.5f));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkBandpassFilterPlan)
@@ -0,0 +1,237 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+#include <mitkImage.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkBeamformingFilter.h>
+#include <mitkBeamformingUtils.h>
+#include <mitkPhotoacousticThreadPool.h>
+#include <mitkException.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+
+class mitkBeamformingUtilsTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkBeamformingUtilsTestSuite);
+  MITK_TEST(testBeamformTile_DAS_EqualsLineFunction);
+  MITK_TEST(testBeamformTile_DMAS_EqualsLineFunction);
+  MITK_TEST(testBeamformTile_sDMAS_EqualsLineFunction);
+  MITK_TEST(testBeamformTile_ConcaveUltrasound_EqualsLineFunction);
+  MITK_TEST(testBeamformingFilter_MultipleSlices_EqualsLineFunction);
+  MITK_TEST(testThreadPool_AllTasksRunOnce);
+  MITK_TEST(testThreadPool_ExceptionIsRethrown);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  const unsigned int ELEMENTS = 40;
+  const unsigned int SAMPLES = 700;
+  const unsigned int RECONSTRUCTED_LINES = 37;
+  const unsigned int RECONSTRUCTED_SAMPLES = 250;
+  const unsigned int SLICES = 3;
+  const float SPEED_OF_SOUND = 1540; // m/s
+  const float PITCH_IN_METERS = 0.3f / 1000;
+  const float TIME_SPACING = 0.00625f / 2 / 1000000; // s
+
+  unsigned int m_InputDim[3];
+  std::vector<float> m_Data;
+
+  mitk::BeamformingSettings::Pointer CreateSettings(mitk::BeamformingSettings::BeamformingAlgorithm algorithm,
+    mitk::BeamformingSettings::ProbeGeometry geometry = mitk::BeamformingSettings::ProbeGeometry::Linear, bool isPhotoacousticImage = true)
+  {
+    return mitk::BeamformingSettings::New(PITCH_IN_METERS, SPEED_OF_SOUND, TIME_SPACING, 27.f, isPhotoacousticImage,
+      RECONSTRUCTED_SAMPLES, RECONSTRUCTED_LINES, m_InputDim, SPEED_OF_SOUND * TIME_SPACING * SAMPLES * 0.8f, false, 16,
+      mitk::BeamformingSettings::Apodization::Hann, ELEMENTS * 2, algorithm, geometry, 0.04f);
+  }
+
+  /** \brief Beamforms the slice with the line functions, pixels without any valid element are set to 0 like BeamformTile() does.
+  */
+  std::vector<float> BeamformWithLineFunctions(mitk::BeamformingSettings::Pointer settings, unsigned int slice)
+  {
+    float inputDim[2] = { (float)ELEMENTS, (float)SAMPLES };
+    float outputDim[2] = { (float)RECONSTRUCTED_LINES, (float)RECONSTRUCTED_SAMPLES };
+    float* input = &m_Data[(size_t)slice * ELEMENTS * SAMPLES];
+    std::vector<float> output((size_t)RECONSTRUCTED_LINES * RECONSTRUCTED_SAMPLES, 0.f);
+
+    for (short line = 0; line < (short)RECONSTRUCTED_LINES; ++line)
+    {
+      switch (settings->GetAlgorithm())
+      {
+      case mitk::BeamformingSettings::BeamformingAlgorithm::DAS:
+        mitk::BeamformingUtils::DASSphericalLine(input, output.data(), inputDim, outputDim, line, settings);
+        break;
+      case mitk::BeamformingSettings::BeamformingAlgorithm::DMAS:
+        mitk::BeamformingUtils::DMASSphericalLine(input, output.data(), inputDim, outputDim, line, settings);
+        break;
+      case mitk::BeamformingSettings::BeamformingAlgorithm::sDMAS:
+        mitk::BeamformingUtils::sDMASSphericalLine(input, output.data(), inputDim, outputDim, line, settings);
+        break;
+      }
+    }
+
+    for (auto& value : output)
+    {
+      if (std::isnan(value))
+        value = 0;
+    }
+    return output;
+  }
+
+  std::vector<float> BeamformWithTiles(mitk::BeamformingSettings::Pointer settings, unsigned int slice)
+  {
+    std::vector<float> output((size_t)RECONSTRUCTED_LINES * RECONSTRUCTED_SAMPLES, -1.f);
+    const mitk::BeamformingDelayTable* table = settings->GetDelayTable();
+
+    // tiles which do not divide the output evenly
+    for (unsigned int line = 0; line < RECONSTRUCTED_LINES; line += 5)
+    {
+      for (unsigned int sample = 0; sample < RECONSTRUCTED_SAMPLES; sample += 64)
+      {
+        mitk::BeamformingUtils::BeamformTile(&m_Data[(size_t)slice * ELEMENTS * SAMPLES], output.data(), table, settings->GetAlgorithm(),
+          line, std::min(line + 5, RECONSTRUCTED_LINES), sample, std::min(sample + 64, RECONSTRUCTED_SAMPLES));
+      }
+    }
+    return output;
+  }
+
+  void AssertEqual(const std::vector<float>& expected, const float* actual)
+  {
+    float maximum = 0;
+    for (auto value : expected)
+      maximum = std::max(maximum, std::abs(value));
+    CPPUNIT_ASSERT_MESSAGE("Reference image is empty", maximum > 0);
+
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+      CPPUNIT_ASSERT_MESSAGE(std::string("Pixel " + std::to_string(i) + " is " + std::to_string(actual[i]) + " instead of " + std::to_string(expected[i])),
+        std::abs(expected[i] - actual[i]) <= 1e-5f * maximum);
+    }
+  }
+
+  void testAlgorithm(mitk::BeamformingSettings::Pointer settings)
+  {
+    const std::vector<float> expected = BeamformWithLineFunctions(settings, 0);
+    const std::vector<float> actual = BeamformWithTiles(settings, 0);
+    AssertEqual(expected, actual.data());
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_InputDim[0] = ELEMENTS;
+    m_InputDim[1] = SAMPLES;
+    m_InputDim[2] = SLICES;
+
+    std::default_random_engine randomGenerator(42);
+    std::normal_distribution<float> noise(0, 1000);
+    m_Data.resize((size_t)ELEMENTS * SAMPLES * SLICES);
+    for (auto& value : m_Data)
+      value = noise(randomGenerator);
+  }
+
+  void tearDown() override
+  {
+    m_Data.clear();
+  }
+
+  void testBeamformTile_DAS_EqualsLineFunction()
+  {
+    testAlgorithm(CreateSettings(mitk::BeamformingSettings::BeamformingAlgorithm::DAS));
+  }
+
+  void testBeamformTile_DMAS_EqualsLineFunction()
+  {
+    testAlgorithm(CreateSettings(mitk::BeamformingSettings::BeamformingAlgorithm::DMAS));
+  }
+
+  void testBeamformTile_sDMAS_EqualsLineFunction()
+  {
+    testAlgorithm(CreateSettings(mitk::BeamformingSettings::BeamformingAlgorithm::sDMAS));
+  }
+
+  void testBeamformTile_ConcaveUltrasound_EqualsLineFunction()
+  {
+    testAlgorithm(CreateSettings(mitk::BeamformingSettings::BeamformingAlgorithm::DAS, mitk::BeamformingSettings::ProbeGeometry::Concave, false));
+    testAlgorithm(CreateSettings(mitk::BeamformingSettings::BeamformingAlgorithm::sDMAS, mitk::BeamformingSettings::ProbeGeometry::Concave, false));
+  }
+
+  void testBeamformingFilter_MultipleSlices_EqualsLineFunction()
+  {
+    auto settings = CreateSettings(mitk::BeamformingSettings::BeamformingAlgorithm::DMAS);
+
+    mitk::Image::Pointer inputImage = mitk::Image::New();
+    inputImage->Initialize(mitk::MakeScalarPixelType<float>(), 3, m_InputDim);
+    inputImage->SetImportVolume(m_Data.data(), 0, 0, mitk::Image::CopyMemory);
+
+    auto filter = mitk::BeamformingFilter::New(settings);
+    filter->SetInput(inputImage);
+
+    // the second update reuses the delays of the first one
+    for (unsigned int update = 0; update < 2; ++update)
+    {
+      filter->Modified();
+      filter->Update();
+
+      mitk::Image::Pointer outputImage = filter->GetOutput();
+      CPPUNIT_ASSERT_EQUAL(SLICES, outputImage->GetDimension(2));
+
+      for (unsigned int slice = 0; slice < SLICES; ++slice)
+      {
+        mitk::ImageReadAccessor readAccess(outputImage, outputImage->GetSliceData(slice));
+        AssertEqual(BeamformWithLineFunctions(settings, slice), (const float*)readAccess.GetData());
+      }
+    }
+  }
+
+  void testThreadPool_AllTasksRunOnce()
+  {
+    mitk::PhotoacousticThreadPool threadPool(4);
+    CPPUNIT_ASSERT_EQUAL(4u, threadPool.GetNumberOfThreads());
+
+    for (unsigned int numberOfTasks : { 0u, 1u, 3u, 1000u })
+    {
+      std::vector<std::atomic<int>> calls(numberOfTasks);
+      for (auto& count : calls)
+        count = 0;
+
+      threadPool.ParallelFor(numberOfTasks, [&](unsigned int task) { ++calls[task]; });
+
+      for (auto& count : calls)
+        CPPUNIT_ASSERT_EQUAL(1, count.load());
+    }
+  }
+
+  void testThreadPool_ExceptionIsRethrown()
+  {
+    mitk::PhotoacousticThreadPool threadPool(4);
+    CPPUNIT_ASSERT_THROW(threadPool.ParallelFor(100, [](unsigned int task) {
+      if (task == 50)
+        mitkThrow() << "Task failed.";
+    }), mitk::Exception);
+
+    // the pool stays usable
+    std::atomic<unsigned int> sum(0);
+    threadPool.ParallelFor(100, [&](unsigned int task) { sum += task; });
+    CPPUNIT_ASSERT_EQUAL(4950u, sum.load());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkBeamformingUtils)
@@ -0,0 +1,230 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+#include <mitkImage.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkBeamformingUtils.h>
+#include <mitkPhotoacousticStreamingPipeline.h>
+#include <mitkPhotoacousticThreadPool.h>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <random>
+
+class mitkPhotoacousticStreamingPipelineTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkPhotoacousticStreamingPipelineTestSuite);
+  MITK_TEST(testFrames_EqualBeamformedCroppedAbsoluteImages);
+  MITK_TEST(testFullBuffer_FrameIsDropped);
+  MITK_TEST(testKeptFrames_AreNotOverwritten);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  const unsigned int ELEMENTS = 32;
+  const unsigned int SAMPLES = 600;
+  const unsigned int RECONSTRUCTED_LINES = 32;
+  const unsigned int RECONSTRUCTED_SAMPLES = 200;
+  const unsigned int FRAMES = 6;
+  const unsigned int CROP_ABOVE = 10;
+  const unsigned int CROP_BELOW = 20;
+  const unsigned int CROP_LEFT = 2;
+  const unsigned int CROP_RIGHT = 3;
+  const float SPEED_OF_SOUND = 1540; // m/s
+  const float PITCH_IN_METERS = 0.3f / 1000;
+  const float TIME_SPACING = 0.00625f / 2 / 1000000; // s
+
+  unsigned int m_InputDim[3];
+  std::vector<float> m_Data;
+  mitk::BeamformingSettings::Pointer m_Settings;
+  mitk::PhotoacousticStreamingPipeline::Pointer m_Pipeline;
+
+  /** \brief A frame reconstructed step by step: beamforming, cropping and absolute value.
+  */
+  std::vector<float> ReconstructFrame(unsigned int frame)
+  {
+    std::vector<float> beamformed((size_t)RECONSTRUCTED_LINES * RECONSTRUCTED_SAMPLES);
+    mitk::PhotoacousticThreadPool threadPool(2);
+    mitk::BeamformingUtils::BeamformSlice(&m_Data[(size_t)frame * ELEMENTS * SAMPLES], beamformed.data(), m_Settings->GetDelayTable(),
+      m_Settings->GetAlgorithm(), &threadPool);
+
+    const unsigned int outputLines = RECONSTRUCTED_LINES - CROP_LEFT - CROP_RIGHT;
+    const unsigned int outputSamples = RECONSTRUCTED_SAMPLES - CROP_ABOVE - CROP_BELOW;
+    std::vector<float> output((size_t)outputLines * outputSamples);
+    for (unsigned int sample = 0; sample < outputSamples; ++sample)
+    {
+      for (unsigned int line = 0; line < outputLines; ++line)
+        output[sample * outputLines + line] = std::abs(beamformed[(sample + CROP_ABOVE) * RECONSTRUCTED_LINES + line + CROP_LEFT]);
+    }
+    return output;
+  }
+
+  void AssertFrameEquals(unsigned int frame, const float* data)
+  {
+    const std::vector<float> expected = this->ReconstructFrame(frame);
+    for (size_t i = 0; i < expected.size(); ++i)
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[i], data[i], 1e-5 * std::abs(expected[i]));
+  }
+
+  mitk::Image::Pointer CreateFrame(unsigned int frame)
+  {
+    unsigned int frameDim[3] = { ELEMENTS, SAMPLES, 1 };
+    mitk::Image::Pointer image = mitk::Image::New();
+    image->Initialize(mitk::MakeScalarPixelType<float>(), 3, frameDim);
+    image->SetImportVolume(&m_Data[(size_t)frame * ELEMENTS * SAMPLES], 0, 0, mitk::Image::CopyMemory);
+    return image;
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_InputDim[0] = ELEMENTS;
+    m_InputDim[1] = SAMPLES;
+    m_InputDim[2] = 1;
+
+    std::default_random_engine randomGenerator(42);
+    std::normal_distribution<float> noise(0, 1000);
+    m_Data.resize((size_t)ELEMENTS * SAMPLES * FRAMES);
+    for (auto& value : m_Data)
+      value = noise(randomGenerator);
+
+    m_Settings = mitk::BeamformingSettings::New(PITCH_IN_METERS, SPEED_OF_SOUND, TIME_SPACING, 27.f, true,
+      RECONSTRUCTED_SAMPLES, RECONSTRUCTED_LINES, m_InputDim, SPEED_OF_SOUND * TIME_SPACING * SAMPLES * 0.8f, false, 16,
+      mitk::BeamformingSettings::Apodization::Hann, ELEMENTS * 2, mitk::BeamformingSettings::BeamformingAlgorithm::DAS,
+      mitk::BeamformingSettings::ProbeGeometry::Linear, 0);
+
+    m_Pipeline = mitk::PhotoacousticStreamingPipeline::New();
+    m_Pipeline->SetBeamformingSettings(m_Settings);
+    m_Pipeline->SetCropAbove(CROP_ABOVE);
+    m_Pipeline->SetCropBelow(CROP_BELOW);
+    m_Pipeline->SetCropLeft(CROP_LEFT);
+    m_Pipeline->SetCropRight(CROP_RIGHT);
+    m_Pipeline->SetUseBMode(true);
+    m_Pipeline->SetBModeMethod(mitk::PhotoacousticFilterService::BModeMethod::Abs);
+  }
+
+  void tearDown() override
+  {
+    m_Pipeline = nullptr;
+    m_Settings = nullptr;
+    m_Data.clear();
+  }
+
+  void testFrames_EqualBeamformedCroppedAbsoluteImages()
+  {
+    std::vector<std::vector<float>> reconstructedFrames(FRAMES);
+    std::vector<unsigned long> frameNumbers;
+
+    m_Pipeline->SetWaitForFreeBuffer(true);
+    m_Pipeline->SetNumberOfBufferedFrames(2);
+    m_Pipeline->SetFrameHandler([&](mitk::Image::Pointer image, unsigned long number) {
+      CPPUNIT_ASSERT_EQUAL(RECONSTRUCTED_LINES - CROP_LEFT - CROP_RIGHT, image->GetDimension(0));
+      CPPUNIT_ASSERT_EQUAL(RECONSTRUCTED_SAMPLES - CROP_ABOVE - CROP_BELOW, image->GetDimension(1));
+      mitk::ImageReadAccessor readAccess(image, image->GetSliceData(0));
+      const float* data = (const float*)readAccess.GetData();
+      reconstructedFrames[number].assign(data, data + image->GetDimension(0) * image->GetDimension(1));
+      frameNumbers.push_back(number);
+    });
+
+    m_Pipeline->Start();
+    for (unsigned int frame = 0; frame < FRAMES; ++frame)
+      CPPUNIT_ASSERT(m_Pipeline->PushFrame(this->CreateFrame(frame)));
+    m_Pipeline->Stop();
+
+    CPPUNIT_ASSERT_EQUAL((unsigned long)0, m_Pipeline->GetNumberOfDroppedFrames());
+    CPPUNIT_ASSERT_EQUAL((size_t)FRAMES, frameNumbers.size());
+    for (unsigned int frame = 0; frame < FRAMES; ++frame)
+    {
+      CPPUNIT_ASSERT_EQUAL((unsigned long)frame, frameNumbers[frame]);
+      CPPUNIT_ASSERT_EQUAL(this->ReconstructFrame(frame).size(), reconstructedFrames[frame].size());
+      this->AssertFrameEquals(frame, reconstructedFrames[frame].data());
+    }
+
+    auto statistics = m_Pipeline->GetStageStatistics();
+    CPPUNIT_ASSERT_EQUAL((size_t)3, statistics.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("total"), statistics.back().name);
+    for (auto& stage : statistics)
+    {
+      CPPUNIT_ASSERT_EQUAL((unsigned long)FRAMES, stage.numberOfFrames);
+      CPPUNIT_ASSERT(stage.maximumLatency >= stage.averageLatency);
+    }
+  }
+
+  void testFullBuffer_FrameIsDropped()
+  {
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool handlerMayReturn = false;
+    std::vector<unsigned long> frameNumbers;
+
+    // the handler keeps the first frame until all frames have been pushed, so the second frame fills the two buffers
+    m_Pipeline->SetNumberOfBufferedFrames(2);
+    m_Pipeline->SetFrameHandler([&](mitk::Image::Pointer, unsigned long number) {
+      std::unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock, [&] { return handlerMayReturn; });
+      frameNumbers.push_back(number);
+    });
+
+    m_Pipeline->Start();
+    CPPUNIT_ASSERT(m_Pipeline->PushFrame(this->CreateFrame(0)));
+    CPPUNIT_ASSERT(m_Pipeline->PushFrame(this->CreateFrame(1)));
+    CPPUNIT_ASSERT(!m_Pipeline->PushFrame(this->CreateFrame(2)));
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      handlerMayReturn = true;
+    }
+    condition.notify_all();
+    m_Pipeline->Stop();
+
+    CPPUNIT_ASSERT_EQUAL((unsigned long)1, m_Pipeline->GetNumberOfDroppedFrames());
+    CPPUNIT_ASSERT_EQUAL((size_t)2, frameNumbers.size());
+    CPPUNIT_ASSERT_EQUAL((unsigned long)0, frameNumbers[0]);
+    CPPUNIT_ASSERT_EQUAL((unsigned long)1, frameNumbers[1]);
+  }
+
+  void testKeptFrames_AreNotOverwritten()
+  {
+    std::vector<mitk::Image::Pointer> keptFrames(FRAMES);
+
+    // more frames than buffers, so every buffer is reused while the handler still holds its previous image
+    m_Pipeline->SetWaitForFreeBuffer(true);
+    m_Pipeline->SetNumberOfBufferedFrames(2);
+    m_Pipeline->SetFrameHandler([&](mitk::Image::Pointer image, unsigned long number) {
+      keptFrames[number] = image;
+    });
+
+    m_Pipeline->Start();
+    for (unsigned int frame = 0; frame < FRAMES; ++frame)
+      CPPUNIT_ASSERT(m_Pipeline->PushFrame(this->CreateFrame(frame)));
+    m_Pipeline->Stop();
+
+    for (unsigned int frame = 0; frame < FRAMES; ++frame)
+    {
+      CPPUNIT_ASSERT(keptFrames[frame].IsNotNull());
+      for (unsigned int other = 0; other < frame; ++other)
+        CPPUNIT_ASSERT(keptFrames[frame] != keptFrames[other]);
+
+      mitk::ImageReadAccessor readAccess(keptFrames[frame], keptFrames[frame]->GetSliceData(0));
+      this->AssertFrameEquals(frame, (const float*)readAccess.GetData());
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkPhotoacousticStreamingPipeline)
@@ -34,6 +34,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <time.h>
 #include <thread>
 #include <chrono>
+#include <cstdint>
 
 #include <vector>
 #include <iostream>
@@ -50,6 +51,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkPAProbe.h>
 #include <mitkPALightSource.h>
 #include <mitkPAMonteCarloThreadHandler.h>
+#include <mitkPAPhotonRandomStream.h>
 
 #ifdef _WIN32
 #include <direct.h>
@@ -244,11 +246,6 @@ public:
 
 class ReturnValues
 {
-private:
-  long i1 = 0, i2 = 31; // used Random Generator
-  long ma[56];   // used Random Generator /* ma[0] is not used. */
-  long mj, mk;
-  short i, ii;
 public:
   long long Nphotons;
   double* totalFluence;
@@ -264,89 +261,6 @@ public:
 
   /* SUBROUTINES */
 
-  /**************************************************************************
-   *  RandomGen
-   *      A random number generator that generates uniformly
-   *      distributed random numbers between 0 and 1 inclusive.
-   *      The algorithm is based on:
-   *      W.H. Press, S.A. Teukolsky, W.T. Vetterling, and B.P.
-   *      Flannery, "Numerical Recipes in C," Cambridge University
-   *      Press, 2nd edition, (1992).
-   *      and
-   *      D.E. Knuth, "Seminumerical Algorithms," 2nd edition, vol. 2
-   *      of "The Art of Computer Programming", Addison-Wesley, (1981).
-   *
-   *      When Type is 0, sets Seed as the seed. Make sure 0<Seed<32000.
-   *      When Type is 1, returns a random number.
-   *      When Type is 2, gets the status of the generator.
-   *      When Type is 3, restores the status of the generator.
-   *
-   *      The status of the generator is represented by Status[0..56].
-   *
-   *      Make sure you initialize the seed before you get random
-   *      numbers.
-   ****/
-#define MBIG 1000000000
-#define MSEED 161803398
-#define MZ 0
-#define FAC 1.0E-9
-
-  double RandomGen(char Type, long Seed, long *Status) {
-    if (Type == 0) {              /* set seed. */
-      if (verbose) std::cout << "Initialized random generator " << this << " with seed: " << Seed << std::endl;
-      mj = MSEED - (Seed < 0 ? -Seed : Seed);
-      mj %= MBIG;
-      ma[55] = mj;
-      mk = 1;
-      for (i = 1; i <= 54; i++) {
-        ii = (21 * i) % 55;
-        ma[ii] = mk;
-        mk = mj - mk;
-        if (mk < MZ)
-          mk += MBIG;
-        mj = ma[ii];
-      }
-      for (ii = 1; ii <= 4; ii++)
-        for (i = 1; i <= 55; i++) {
-          ma[i] -= ma[1 + (i + 30) % 55];
-          if (ma[i] < MZ)
-            ma[i] += MBIG;
-        }
-      i1 = 0;
-      i2 = 31;
-    }
-    else if (Type == 1) {       /* get a number. */
-      if (++i1 == 56)
-        i1 = 1;
-      if (++i2 == 56)
-        i2 = 1;
-      mj = ma[i1] - ma[i2];
-      if (mj < MZ)
-        mj += MBIG;
-      ma[i1] = mj;
-      return (mj * FAC);
-    }
-    else if (Type == 2) {       /* get status. */
-      for (i = 0; i < 55; i++)
-        Status[i] = ma[i + 1];
-      Status[55] = i1;
-      Status[56] = i2;
-    }
-    else if (Type == 3) {       /* restore status. */
-      for (i = 0; i < 55; i++)
-        ma[i + 1] = Status[i];
-      i1 = Status[55];
-      i2 = Status[56];
-    }
-    else
-      puts("Wrong parameter to RandomGen().");
-    return (0);
-  }
-#undef MBIG
-#undef MSEED
-#undef MZ
-#undef FAC
-
   /***********************************************************
    *  Determine if the two position are located in the same voxel
    *  Returns 1 if same voxel, 0 if not same voxel.
@@ -623,6 +537,7 @@ bool simulatePVFC = false;
 int requestedNumberOfPhotons = 100000;
 float requestedSimulationTime = 0; // in minutes
 int concurentThreadsSupported = -1;
+unsigned long long randomSeed = 0;
 float yOffset = 0; // in mm
 bool saveLegacy = false;
 std::string normalizationFilename;
@@ -675,6 +590,9 @@ int main(int argc, char * argv[]) {
   parser.addArgument(
     "jobs", "j", mitkCommandLineParser::Int,
     "Number of jobs", "Specifies the number of jobs for simutation (default: -1 which starts as many jobs as supported).");
+  parser.addArgument(
+    "seed", "s", mitkCommandLineParser::Int,
+    "Random seed", "Specifies the seed of the random numbers (default: derived from the current time). Simulations of a number of photons with the same seed yield the same photons for any number of jobs.");
   parser.addArgument(
     "probe-xml", "p", mitkCommandLineParser::File,
     "Xml definition of the probe", "Specifies the absolute path of the location of the xml definition file of the probe design.", us::Any(), true, false, false, mitkCommandLineParser::Input);
@@ -730,6 +648,14 @@ int main(int argc, char * argv[]) {
   {
     concurentThreadsSupported = us::any_cast<int>(parsedArgs["jobs"]);
   }
+  if (parsedArgs.count("seed"))
+  {
+    randomSeed = (unsigned int)us::any_cast<int>(parsedArgs["seed"]);
+  }
+  else
+  {
+    randomSeed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  }
   if (parsedArgs.count("probe-xml"))
   {
     std::string inputXmlProbeDesign = us::any_cast<std::string>(parsedArgs["probe-xml"]);
@@ -773,12 +699,6 @@ int main(int argc, char * argv[]) {
   std::vector<ReturnValues> allValues(concurentThreadsSupported);
   auto* threads = new std::thread[concurentThreadsSupported];
 
-  for (long i = 0; i < concurentThreadsSupported; i++)
-  {
-    auto* tmp = new ReturnValues();
-    allValues.push_back(*tmp);
-  }
-
   if (verbose) std::cout << "Initializing MonteCarloThreadHandler" << std::endl;
 
   long timeMetric;
@@ -799,7 +719,7 @@ int main(int argc, char * argv[]) {
   if (simulatePVFC)
     threadHandler->SetPackageSize(1000);
 
-  if (verbose) std::cout << "\nStarting simulation ...\n" << std::endl;
+  if (verbose) std::cout << "\nStarting simulation with random seed " << randomSeed << " ...\n" << std::endl;
 
   auto simulationStartTime = std::chrono::system_clock::now();
 
@@ -820,6 +740,14 @@ int main(int argc, char * argv[]) {
   std::cout << "total time for simulation: "
     << (int)std::chrono::duration_cast<std::chrono::seconds>(simulationTimeElapsed).count() << "sec " << std::endl;
 
+  long long simulatedPhotons = 0;
+  for (int i = 0; i < concurentThreadsSupported; i++)
+  {
+    simulatedPhotons += allValues[i].Nphotons;
+  }
+  std::cout << "photons per second with " << concurentThreadsSupported << " jobs: "
+    << simulatedPhotons / std::chrono::duration<double>(simulationTimeElapsed).count() << std::endl;
+
   /**** SAVE
    Convert data to relative fluence rate [cm^-2] and save.
    *****/
@@ -1043,16 +971,16 @@ void runMonteCarlo(InputValues* inputValues, ReturnValues* returnValue, int thre
 
   /**** ======================== MAJOR CYCLE ============================ *****/
 
-  auto duration = std::chrono::system_clock::now().time_since_epoch();
-  returnValue->RandomGen(0, (std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() + thread) % 32000, nullptr); /* initiate with seed = 1, or any long integer. */
+  mitk::pa::PhotonRandomStream randomStream(randomSeed);
   for (j = 0; j < inputValues->totalNumberOfVoxels; j++) returnValue->totalFluence[j] = 0; // ensure F[] starts empty.
 
   /**** RUN Launch N photons, initializing each one before progation. *****/
 
   long photonsToSimulate = 0;
+  long long firstPhotonIndex = 0;
 
   do {
-    photonsToSimulate = threadHandler->GetNextWorkPackage();
+    photonsToSimulate = threadHandler->GetNextWorkPackage(firstPhotonIndex);
     if (returnValue->detectorVoxel != nullptr)
     {
       photonsToSimulate = photonsToSimulate * returnValue->detectorVoxel->m_PhotonNormalizationValue;
@@ -1061,11 +989,16 @@ void runMonteCarlo(InputValues* inputValues, ReturnValues* returnValue, int thre
     if (verbose)
       MITK_INFO << "Photons to simulate: " << photonsToSimulate;
 
+    // an empty package ends the simulation; the loop below would launch a photon which is not counted
+    if (photonsToSimulate <= 0)
+      break;
+
     photonIterator = 0L;
 
     do {
       /**** LAUNCH Initialize photon position and trajectory. *****/
 
+      randomStream.Start(firstPhotonIndex, (uint32_t)photonIterator);
       photonIterator += 1;        /* increment photon count */
       W = 1.0;                    /* set photon weight to one */
       photon_status = ALIVE;      /* Launch an ALIVE photon */
@@ -1086,14 +1019,14 @@ void runMonteCarlo(InputValues* inputValues, ReturnValues* returnValue, int thre
         double rnd7 = -1;
         double rnd8 = -1;
 
-        while ((rnd1 = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-        while ((rnd2 = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-        while ((rnd3 = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-        while ((rnd4 = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-        while ((rnd5 = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-        while ((rnd6 = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-        while ((rnd7 = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
-        while ((rnd8 = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
+        while ((rnd1 = randomStream.RandomGen()) <= 0.0);
+        while ((rnd2 = randomStream.RandomGen()) <= 0.0);
+        while ((rnd3 = randomStream.RandomGen()) <= 0.0);
+        while ((rnd4 = randomStream.RandomGen()) <= 0.0);
+        while ((rnd5 = randomStream.RandomGen()) <= 0.0);
+        while ((rnd6 = randomStream.RandomGen()) <= 0.0);
+        while ((rnd7 = randomStream.RandomGen()) <= 0.0);
+        while ((rnd8 = randomStream.RandomGen()) <= 0.0);
 
         mitk::pa::LightSource::PhotonInformation info = m_PhotoacousticProbe->GetNextPhoton(rnd1, rnd2, rnd3, rnd4, rnd5, rnd6, rnd7, rnd8);
         x = info.xPosition;
@@ -1122,49 +1055,48 @@ void runMonteCarlo(InputValues* inputValues, ReturnValues* returnValue, int thre
           if (inputValues->mcflag == 0) // uniform beam
           {
             // set launch point and width of beam
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0); // avoids rnd = 0
+            while ((rnd = randomStream.RandomGen()) <= 0.0); // avoids rnd = 0
             r = inputValues->radius*sqrt(rnd); // radius of beam at launch point
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0); // avoids rnd = 0
+            while ((rnd = randomStream.RandomGen()) <= 0.0); // avoids rnd = 0
             phi = rnd*2.0*PI;
             x = inputValues->xs + r*cos(phi);
             y = inputValues->ys + r*sin(phi);
             z = inputValues->zs;
             // set trajectory toward focus
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0); // avoids rnd = 0
+            while ((rnd = randomStream.RandomGen()) <= 0.0); // avoids rnd = 0
             r = inputValues->waist*sqrt(rnd); // radius of beam at focus
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0); // avoids rnd = 0
+            while ((rnd = randomStream.RandomGen()) <= 0.0); // avoids rnd = 0
             phi = rnd*2.0*PI;
 
-            // !!!!!!!!!!!!!!!!!!!!!!! setting input values will braek
-
-            inputValues->xfocus = r*cos(phi);
-            inputValues->yfocus = r*sin(phi);
-            temp = sqrt((x - inputValues->xfocus)*(x - inputValues->xfocus)
-              + (y - inputValues->yfocus)*(y - inputValues->yfocus) + inputValues->zfocus*inputValues->zfocus);
-            ux = -(x - inputValues->xfocus) / temp;
-            uy = -(y - inputValues->yfocus) / temp;
+            // the focus of this photon; the input values are shared by all threads
+            double xfocus = r*cos(phi);
+            double yfocus = r*sin(phi);
+            temp = sqrt((x - xfocus)*(x - xfocus)
+              + (y - yfocus)*(y - yfocus) + inputValues->zfocus*inputValues->zfocus);
+            ux = -(x - xfocus) / temp;
+            uy = -(y - yfocus) / temp;
             uz = sqrt(1 - ux*ux + uy*uy);
           }
           else if (inputValues->mcflag == 5) // Multispectral DKFZ prototype
           {
             // set launch point and width of beam
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
+            while ((rnd = randomStream.RandomGen()) <= 0.0);
 
             //offset in x direction in cm (random)
             x = (rnd*2.5) - 1.25;
 
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
+            while ((rnd = randomStream.RandomGen()) <= 0.0);
             double b = ((rnd)-0.5);
             y = (b > 0 ? yOffset + 1.5 : yOffset - 1.5);
             z = 0.1;
             ux = 0;
 
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
+            while ((rnd = randomStream.RandomGen()) <= 0.0);
 
             //Angle of beam in y direction
             uy = sin((rnd*0.42) - 0.21 + (b < 0 ? 1.0 : -1.0) * 0.436);
 
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
+            while ((rnd = randomStream.RandomGen()) <= 0.0);
 
             // angle of beam in x direction
             ux = sin((rnd*0.42) - 0.21);
@@ -1173,32 +1105,32 @@ void runMonteCarlo(InputValues* inputValues, ReturnValues* returnValue, int thre
           else if (inputValues->mcflag == 4) // Monospectral prototype DKFZ
           {
             // set launch point and width of beam
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
+            while ((rnd = randomStream.RandomGen()) <= 0.0);
 
             //offset in x direction in cm (random)
             x = (rnd*2.5) - 1.25;
 
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
+            while ((rnd = randomStream.RandomGen()) <= 0.0);
             double b = ((rnd)-0.5);
             y = (b > 0 ? yOffset + 0.83 : yOffset - 0.83);
             z = 0.1;
             ux = 0;
 
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
+            while ((rnd = randomStream.RandomGen()) <= 0.0);
 
             //Angle of beam in y direction
             uy = sin((rnd*0.42) - 0.21 + (b < 0 ? 1.0 : -1.0) * 0.375);
 
-            while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
+            while ((rnd = randomStream.RandomGen()) <= 0.0);
 
             // angle of beam in x direction
             ux = sin((rnd*0.42) - 0.21);
             uz = sqrt(1 - ux*ux - uy*uy);
           }
           else { // isotropic pt source
-            costheta = 1.0 - 2.0 * returnValue->RandomGen(1, 0, nullptr);
+            costheta = 1.0 - 2.0 * randomStream.RandomGen();
             sintheta = sqrt(1.0 - costheta*costheta);
-            psi = 2.0 * PI * returnValue->RandomGen(1, 0, nullptr);
+            psi = 2.0 * PI * randomStream.RandomGen();
             cospsi = cos(psi);
             if (psi < PI)
               sinpsi = sqrt(1.0 - cospsi*cospsi);
@@ -1246,7 +1178,7 @@ void runMonteCarlo(InputValues* inputValues, ReturnValues* returnValue, int thre
       s = dimensionless stepsize
       x, uy, uz are cosines of current photon trajectory
       *****/
-        while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);   /* yields 0 < rnd <= 1 */
+        while ((rnd = randomStream.RandomGen()) <= 0.0);   /* yields 0 < rnd <= 1 */
         sleft = -log(rnd);        /* dimensionless step */
         CNT += 1;
 
@@ -1412,7 +1344,7 @@ void runMonteCarlo(InputValues* inputValues, ReturnValues* returnValue, int thre
        Convert theta and psi into cosines ux, uy, uz.
        *****/
        /* Sample for costheta */
-        while ((rnd = returnValue->RandomGen(1, 0, nullptr)) <= 0.0);
+        while ((rnd = randomStream.RandomGen()) <= 0.0);
         if (inputValues->gVector[i] == 0.0)
         {
           costheta = 2.0 * rnd - 1.0;
@@ -1426,7 +1358,7 @@ void runMonteCarlo(InputValues* inputValues, ReturnValues* returnValue, int thre
         sintheta = sqrt(1.0 - costheta*costheta); /* sqrt() is faster than sin(). */
 
         /* Sample psi. */
-        psi = 2.0*PI*returnValue->RandomGen(1, 0, nullptr);
+        psi = 2.0*PI*randomStream.RandomGen();
         cospsi = cos(psi);
         if (psi < PI)
           sinpsi = sqrt(1.0 - cospsi*cospsi);     /* sqrt() is faster than sin(). */
@@ -1457,7 +1389,7 @@ void runMonteCarlo(InputValues* inputValues, ReturnValues* returnValue, int thre
       and 1-CHANCE probability of terminating.
       *****/
         if (W < THRESHOLD) {
-          if (returnValue->RandomGen(1, 0, nullptr) <= CHANCE)
+          if (randomStream.RandomGen() <= CHANCE)
             W /= CHANCE;
           else photon_status = DEAD;
         }
@@ -0,0 +1,204 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkCommon.h>
+#include <mitkCommandLineParser.h>
+#include <mitkException.h>
+
+#include "mitkPALinearSpectralUnmixingFilter.h"
+#include "mitkPASpectralUnmixingFilterVigra.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+struct BenchmarkParameters
+{
+  unsigned int xDim;
+  unsigned int yDim;
+  unsigned int numberOfWavelengths;
+  unsigned int numberOfSequences;
+  unsigned int numberOfThreads;
+};
+
+/**
+* \brief Unmixes every pixel with "SpectralUnmixingAlgorithm" as all filters did before the solvers were introduced.
+*/
+template <class TFilter>
+class PixelwiseFilter : public TFilter
+{
+public:
+  mitkClassMacro(PixelwiseFilter, TFilter)
+    itkFactorylessNewMacro(Self)
+
+protected:
+  mitk::pa::SpectralUnmixingSolver::Pointer CreateSolver(const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic>&) override
+  {
+    return nullptr;
+  }
+};
+
+BenchmarkParameters parseInput(int argc, char* argv[])
+{
+  mitkCommandLineParser parser;
+  parser.setCategory("MITK-Photoacoustics");
+  parser.setTitle("Mitk Spectral Unmixing Benchmark");
+  parser.setDescription("Measures the throughput of the spectral unmixing filters on random multispectral sequences.");
+  parser.setContributor("Computer Assisted Medical Interventions, DKFZ");
+
+  parser.setArgumentPrefix("--", "-");
+
+  parser.beginGroup("Optional parameters");
+  parser.addArgument(
+    "xDim", "x", mitkCommandLineParser::Int,
+    "X dimension", "number of pixels in x direction (default: 256)");
+  parser.addArgument(
+    "yDim", "y", mitkCommandLineParser::Int,
+    "Y dimension", "number of pixels in y direction (default: 256)");
+  parser.addArgument(
+    "wavelengths", "w", mitkCommandLineParser::Int,
+    "Wavelengths", "number of wavelengths per sequence, starting at 700 nm in steps of 10 nm (default: 8)");
+  parser.addArgument(
+    "sequences", "s", mitkCommandLineParser::Int,
+    "Sequences", "number of sequences (default: 50)");
+  parser.addArgument(
+    "threads", "t", mitkCommandLineParser::Int,
+    "Threads", "number of threads of the filters (default: number of cores)");
+  parser.endGroup();
+
+  std::map<std::string, us::Any> parsedArgs = parser.parseArguments(argc, argv);
+  if (parsedArgs.size() == 0 && argc > 1)
+    exit(-1);
+
+  BenchmarkParameters input;
+  input.xDim = parsedArgs.count("xDim") ? us::any_cast<int>(parsedArgs["xDim"]) : 256;
+  input.yDim = parsedArgs.count("yDim") ? us::any_cast<int>(parsedArgs["yDim"]) : 256;
+  input.numberOfWavelengths = parsedArgs.count("wavelengths") ? us::any_cast<int>(parsedArgs["wavelengths"]) : 8;
+  input.numberOfSequences = parsedArgs.count("sequences") ? us::any_cast<int>(parsedArgs["sequences"]) : 50;
+  input.numberOfThreads = parsedArgs.count("threads") ? us::any_cast<int>(parsedArgs["threads"])
+    : std::max(1u, std::thread::hardware_concurrency());
+
+  if (input.xDim == 0 || input.yDim == 0 || input.numberOfSequences == 0 || input.numberOfThreads == 0)
+    mitkThrow() << "The dimensions and the number of threads must be positive.";
+  if (input.numberOfWavelengths < 2 || input.numberOfWavelengths > 30)
+    mitkThrow() << "The number of wavelengths must be between 2 and 30.";
+
+  return input;
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point begin)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+void Configure(mitk::pa::SpectralUnmixingFilterBase* filter, const BenchmarkParameters& input, unsigned int numberOfThreads)
+{
+  filter->Verbose(false);
+  filter->RelativeError(false);
+  filter->AddOutputs(2);
+  filter->SetNumberOfThreads(numberOfThreads);
+  filter->AddChromophore(mitk::pa::PropertyCalculator::ChromophoreType::OXYGENATED);
+  filter->AddChromophore(mitk::pa::PropertyCalculator::ChromophoreType::DEOXYGENATED);
+  for (unsigned int wl = 0; wl < input.numberOfWavelengths; ++wl)
+    filter->AddWavelength(700 + wl * 10);
+}
+
+void Measure(const std::string& name, mitk::pa::SpectralUnmixingFilterBase* filter, mitk::Image::Pointer image,
+  const BenchmarkParameters& input, unsigned int numberOfSequences)
+{
+  filter->SetInput(image);
+  auto begin = std::chrono::steady_clock::now();
+  filter->Update();
+  const double pixels = (double)input.xDim * input.yDim * numberOfSequences;
+  std::cout << "  " << name << ": " << pixels / SecondsSince(begin) / 1000000 << " Mpixel/s" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  auto input = parseInput(argc, argv);
+  const unsigned int numberOfPixels = input.xDim * input.yDim;
+  const unsigned int sequenceSize = input.numberOfWavelengths;
+
+  std::default_random_engine randomGenerator(42);
+  std::uniform_real_distribution<float> pixelValue(0, 3000);
+  std::vector<float> data((size_t)numberOfPixels * sequenceSize * input.numberOfSequences);
+  for (auto& value : data)
+    value = pixelValue(randomGenerator);
+
+  auto image = mitk::Image::New();
+  unsigned int dimensions[3] = { input.xDim, input.yDim, sequenceSize * input.numberOfSequences };
+  image->Initialize(mitk::MakeScalarPixelType<float>(), 3, dimensions);
+  image->SetImportVolume(data.data(), mitk::Image::ImportMemoryManagementType::CopyMemory);
+
+  // the pixel by pixel filters are much slower, so they only unmix a few sequences
+  const unsigned int pixelwiseSequences = std::min(input.numberOfSequences, 2u);
+  auto pixelwiseImage = mitk::Image::New();
+  dimensions[2] = sequenceSize * pixelwiseSequences;
+  pixelwiseImage->Initialize(mitk::MakeScalarPixelType<float>(), 3, dimensions);
+  pixelwiseImage->SetImportVolume(data.data(), mitk::Image::ImportMemoryManagementType::CopyMemory);
+
+  std::cout << input.numberOfSequences << " sequences of " << input.xDim << " x " << input.yDim << " pixels and "
+    << sequenceSize << " wavelengths, 2 chromophores:" << std::endl;
+
+  // least squares by QR decomposition
+  auto pixelwiseQR = PixelwiseFilter<mitk::pa::LinearSpectralUnmixingFilter>::New();
+  pixelwiseQR->SetAlgorithm(mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::HOUSEHOLDERQR);
+  Configure(pixelwiseQR, input, 1);
+  Measure("QR pixel by pixel", pixelwiseQR, pixelwiseImage, input, pixelwiseSequences);
+
+  for (unsigned int numberOfThreads : { 1u, input.numberOfThreads })
+  {
+    auto batchedQR = mitk::pa::LinearSpectralUnmixingFilter::New();
+    batchedQR->SetAlgorithm(mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::HOUSEHOLDERQR);
+    Configure(batchedQR, input, numberOfThreads);
+    Measure("QR batched, " + std::to_string(numberOfThreads) + " thread(s)", batchedQR, image, input, input.numberOfSequences);
+  }
+
+  // non-negative least squares
+  auto pixelwiseNNLS = PixelwiseFilter<mitk::pa::SpectralUnmixingFilterVigra>::New();
+  pixelwiseNNLS->SetAlgorithm(mitk::pa::SpectralUnmixingFilterVigra::VigraAlgortihmType::LARS);
+  Configure(pixelwiseNNLS, input, 1);
+  Measure("NNLS pixel by pixel (vigra LARS)", pixelwiseNNLS, pixelwiseImage, input, pixelwiseSequences);
+
+  for (unsigned int numberOfThreads : { 1u, input.numberOfThreads })
+  {
+    auto batchedNNLS = mitk::pa::SpectralUnmixingFilterVigra::New();
+    batchedNNLS->SetAlgorithm(mitk::pa::SpectralUnmixingFilterVigra::VigraAlgortihmType::LARS);
+    Configure(batchedNNLS, input, numberOfThreads);
+    Measure("NNLS batched, " + std::to_string(numberOfThreads) + " thread(s)", batchedNNLS, image, input, input.numberOfSequences);
+  }
+
+  // streaming: one sequence after another with the factorization of the first one
+  auto streamingQR = mitk::pa::LinearSpectralUnmixingFilter::New();
+  streamingQR->SetAlgorithm(mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::HOUSEHOLDERQR);
+  Configure(streamingQR, input, input.numberOfThreads);
+  std::vector<float> resultHbO2(numberOfPixels);
+  std::vector<float> resultHb(numberOfPixels);
+  std::vector<float*> outputs = { resultHbO2.data(), resultHb.data() };
+
+  auto begin = std::chrono::steady_clock::now();
+  for (unsigned int sequence = 0; sequence < input.numberOfSequences; ++sequence)
+    streamingQR->UnmixSequence(&data[(size_t)numberOfPixels * sequenceSize * sequence], numberOfPixels, outputs);
+  const double seconds = SecondsSince(begin);
+  std::cout << "  QR streaming, " << input.numberOfThreads << " thread(s): "
+    << (double)numberOfPixels * input.numberOfSequences / seconds / 1000000 << " Mpixel/s, "
+    << input.numberOfSequences / seconds << " sequences/s" << std::endl;
+
+  return EXIT_SUCCESS;
+}
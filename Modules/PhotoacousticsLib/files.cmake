@@ -15,6 +15,7 @@ SET(H_FILES
   include/mitkPALightSource.h
   include/mitkPAIOUtil.h
   include/mitkPAMonteCarloThreadHandler.h
+  include/mitkPAPhotonRandomStream.h
   include/mitkPASimulationBatchGenerator.h
   include/mitkPAFluenceYOffsetPair.h
   include/mitkPAVolumeManipulator.h
@@ -27,6 +28,7 @@ SET(H_FILES
   include/mitkPASpectralUnmixingFilterLagrange.h
   include/mitkPASpectralUnmixingFilterSimplex.h
   include/mitkPASpectralUnmixingFilterVigra.h
+  include/mitkPASpectralUnmixingSolver.h
 )
 
 set(CPP_FILES
@@ -51,12 +53,14 @@ set(CPP_FILES
   Utils/ProbeDesign/mitkPAProbe.cpp
   Utils/ProbeDesign/mitkPALightSource.cpp
   Utils/Thread/mitkPAMonteCarloThreadHandler.cpp
+  Utils/Thread/mitkPAPhotonRandomStream.cpp
   SUFilter/mitkPASpectralUnmixingFilterBase.cpp
   SUFilter/mitkPALinearSpectralUnmixingFilter.cpp
   SUFilter/mitkPASpectralUnmixingSO2.cpp
   SUFilter/mitkPASpectralUnmixingFilterSimplex.cpp
   SUFilter/mitkPASpectralUnmixingFilterVigra.cpp
   SUFilter/mitkPASpectralUnmixingFilterLagrange.cpp
+  SUFilter/mitkPASpectralUnmixingSolver.cpp
   Utils/mitkPAVesselDrawer.cpp
 )
 
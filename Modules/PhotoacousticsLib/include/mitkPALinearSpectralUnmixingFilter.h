@@ -95,6 +95,15 @@ namespace mitk {
       Eigen::VectorXf SpectralUnmixingAlgorithm(Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic> endmemberMatrix,
         Eigen::VectorXf inputVector) override;
 
+      /**
+      * \brief overrides the baseclass method to decompose the endmember matrix once with the algorithm set by the "SetAlgorithm" method.
+      * All algorithms solve linear systems, so the decomposition is applied to the identity matrix and every pixel is unmixed by the
+      * product of the resulting matrix and its input vector.
+      * @throws if the algorithmName is not a member of the enum AlgortihmType
+      * @throws if one chooses the ldlt/llt solver and the endmember matrix is not positive definite
+      */
+      SpectralUnmixingSolver::Pointer CreateSolver(const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic>& endmemberMatrix) override;
+
     private:
       AlgortihmType algorithmName;
     };
@@ -19,7 +19,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkCommon.h>
 #include <MitkPhotoacousticsLibExports.h>
-#include <mutex>
+#include <atomic>
 
 //Includes for smart pointer usage
 #include "mitkCommon.h"
@@ -42,10 +42,23 @@ namespace mitk {
 
         long GetNextWorkPackage();
 
+      /**
+       * @brief GetNextWorkPackage Hands out the next work package without locking.
+       * The photons of all work packages are numbered consecutively in the order the packages are handed out.
+       * A package therefore always contains the same photons, no matter how many threads share the handler.
+       * @param firstPhotonIndex is set to the index of the first photon of the package
+       * @return the number of photons of the package, 0 if the simulation is finished
+       */
+      long GetNextWorkPackage(long long& firstPhotonIndex);
+
+      /**
+       * @brief SetPackageSize has to be called before the first work package is requested.
+       */
       void SetPackageSize(long sizeInMilliseconsOrNumberOfPhotons);
 
+      long GetNumberPhotonsRemaining() const;
+
       itkGetMacro(NumberPhotonsToSimulate, long);
-      itkGetMacro(NumberPhotonsRemaining, long);
       itkGetMacro(WorkPackageSize, long);
       itkGetMacro(SimulationTime, long);
       itkGetMacro(SimulateOnTimeBasis, bool);
@@ -53,13 +66,12 @@ namespace mitk {
 
     protected:
       long m_NumberPhotonsToSimulate;
-      long m_NumberPhotonsRemaining;
       long m_WorkPackageSize;
       long m_SimulationTime;
       long m_Time;
       bool m_SimulateOnTimeBasis;
       bool m_Verbose;
-      std::mutex m_MutexRemainingPhotonsManipulation;
+      std::atomic<long long> m_NextPhotonIndex;
 
       /**
        * @brief PhotoacousticThreadhandler
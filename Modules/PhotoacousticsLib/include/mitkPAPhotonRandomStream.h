@@ -0,0 +1,80 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKPHOTONRANDOMSTREAM_H
+#define MITKPHOTONRANDOMSTREAM_H
+
+#include <MitkPhotoacousticsLibExports.h>
+#include <cstdint>
+
+namespace mitk {
+  namespace pa {
+    /**
+     * @brief A counter based random number generator (Philox4x32-10) that generates uniformly distributed
+     * random numbers in [0, 1) for the photons of a Monte Carlo simulation.
+     *
+     * The algorithm is based on:
+     * J.K. Salmon, M.A. Moraes, R.O. Dror, and D.E. Shaw, "Parallel random numbers: as easy as 1, 2, 3,"
+     * Proceedings of the International Conference for High Performance Computing, Networking, Storage and
+     * Analysis (SC11), (2011).
+     *
+     * The numbers are the encrypted counter (photon, number) with the seed as key. Every photon draws its
+     * numbers from its own stream, so the simulated photons only depend on the seed and not on the number of
+     * threads or the thread which simulates them, see MonteCarloThreadHandler::GetNextWorkPackage(long long&).
+     *
+     * Make sure you start the stream of a photon before you get random numbers.
+     */
+    class MITKPHOTOACOUSTICSLIB_EXPORT PhotonRandomStream
+    {
+    public:
+      explicit PhotonRandomStream(unsigned long long seed);
+
+      /**
+       * @brief Start Starts the stream of photon photonInPackage of the work package starting with photon firstPhotonIndex.
+       */
+      void Start(unsigned long long firstPhotonIndex, uint32_t photonInPackage);
+
+      /**
+       * @brief RandomGen Returns the next number of the stream, with 53 random bits.
+       */
+      double RandomGen()
+      {
+        if (m_NumbersLeft == 0)
+        {
+          Philox(m_Counter, m_Key, m_Block);
+          ++m_Counter[0];
+          m_NumbersLeft = 2;
+        }
+        --m_NumbersLeft;
+        uint64_t bits = ((uint64_t)m_Block[2 * m_NumbersLeft] << 21) ^ (m_Block[2 * m_NumbersLeft + 1] >> 11);
+        return bits * (1.0 / 9007199254740992.0);
+      }
+
+      /**
+       * @brief Philox Encrypts the counter with the key in 10 rounds of Philox4x32.
+       */
+      static void Philox(const uint32_t counter[4], const uint32_t key[2], uint32_t result[4]);
+
+    private:
+      uint32_t m_Key[2];
+      uint32_t m_Counter[4];
+      uint32_t m_Block[4];
+      int m_NumbersLeft;
+    };
+  }
+}
+
+#endif // MITKPHOTONRANDOMSTREAM_H
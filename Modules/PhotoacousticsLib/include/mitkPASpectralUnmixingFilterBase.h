@@ -28,6 +28,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkPAPropertyCalculator.h"
 #include <eigen3/Eigen/Dense>
 
+#include "mitkPASpectralUnmixingSolver.h"
+
 namespace mitk {
   namespace pa {
     /**
@@ -48,6 +50,12 @@ namespace mitk {
     * sequences. Furthermore it is possible to creat an output image that contains the information about the relative error between unmixing result
     * and the input image.
     *
+    * Performance:
+    * Subclasses which provide a mitk::pa::SpectralUnmixingSolver factorize the endmember matrix once and unmix blocks of pixels with matrix
+    * products; the blocks of all sequences are distributed over GetNumberOfThreads() threads. The solver is kept until the filter is modified,
+    * so sequences of a live acquisition can be unmixed one after another with "UnmixSequence" without refactorizing. Subclasses without
+    * solver are called pixel by pixel on one thread.
+    *
     * Subclasses:
     * - mitkPASpectralUnmixingFilterVigra
     * - mitkPALinearSpectralUnmixingFilter (uses Eigen algorithms)
@@ -110,6 +118,16 @@ namespace mitk {
       */
       virtual void AddRelativeErrorSettings(int value);
 
+      /**
+      * \brief UnmixSequence unmixes one sequence without MITK images, e.g. for streaming the sequences of a live acquisition one after another.
+      * The endmember matrix is factorized at the first call and reused until the filter is modified.
+      * @param sequence contains numberOfPixels values for every added wavelength; the image of the first wavelength comes first
+      * @param outputs one buffer of numberOfPixels values per added chromophore and a last one for the relative error if activated
+      * @throws if no wavelengths or chromophores are selected, if there are more chromophores then wavelengths or if the number of
+      * outputs doesn't fit
+      */
+      void UnmixSequence(const float* sequence, unsigned int numberOfPixels, const std::vector<float*>& outputs);
+
       ofstream myfile; // just for testing purposes; has to be removeed
 
     protected:
@@ -130,6 +148,15 @@ namespace mitk {
       virtual Eigen::VectorXf SpectralUnmixingAlgorithm(Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic> endmemberMatrix,
         Eigen::VectorXf inputVector) = 0;
 
+      /**
+      * \brief The subclasses can override the method to create a solver which unmixes blocks of pixels with one factorization of the
+      * endmember matrix. The solver is reused until the filter is modified, so subclasses call Modified() if their algorithm changes.
+      * @param endmemberMatrix Matrix with number of chromophores colums and number of wavelengths rows
+      * @return nullptr if "SpectralUnmixingAlgorithm" has to be called for every pixel, which is the default
+      * @throws if the endmember matrix can't be factorized for the algorithm
+      */
+      virtual SpectralUnmixingSolver::Pointer CreateSolver(const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic>& endmemberMatrix);
+
       bool m_Verbose = false;
       bool m_RelativeError = false;
 
@@ -183,15 +210,38 @@ namespace mitk {
       virtual float PropertyElement(mitk::pa::PropertyCalculator::ChromophoreType, int wavelength);
 
       /*
-      * \brief calculates the relative error between the input image and the unmixing result in the L2 norm
-      * @param endmemberMatrix is a Eigen matrix containing the endmember information
-      * @param inputVector is a Eigen vector containing the multispectral information of one pixel
-      * @param resultVector is a Eigen vector containing the spectral unmmixing result
+      * \brief Checks the selected wavelengths and chromophores and computes the endmember matrix and the solver, if the filter was
+      * modified since they were computed last.
+      */
+      void PrepareUnmixing();
+
+      /*
+      * \brief Unmixes numberOfSequences consecutive sequences of numberOfPixels pixels each in blocks, which are distributed over
+      * GetNumberOfThreads() threads if there is a solver.
+      * @param outputs one buffer of numberOfPixels * numberOfSequences values per chromophore and one for the relative error if activated
+      */
+      void UnmixSequences(const float* input, unsigned int numberOfPixels, unsigned int numberOfSequences, const std::vector<float*>& outputs);
+
+      /*
+      * \brief Unmixes one block of pixels with the solver or pixel by pixel with "SpectralUnmixingAlgorithm".
+      * Returns the number of pixels for which the solver reached its iteration limit.
       */
-      float CalculateRelativeError(Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic> endmemberMatrix,
-        Eigen::VectorXf inputVector, Eigen::VectorXf resultVector);
+      unsigned int UnmixBlock(const SpectralUnmixingSolver::InputBlockType& inputBlock, SpectralUnmixingSolver::MatrixType& resultBlock);
+
+      /*
+      * \brief calculates the relative errors between the input images and the unmixing results of a block of pixels in the L2 norm
+      * @param inputBlock contains the multispectral information of one pixel per colum
+      * @param resultBlock contains the spectral unmmixing result of one pixel per colum
+      * @param relativeErrors receives one value per pixel
+      */
+      void CalculateRelativeErrors(const SpectralUnmixingSolver::InputBlockType& inputBlock,
+        const SpectralUnmixingSolver::MatrixType& resultBlock, float* relativeErrors);
 
       PropertyCalculator::Pointer m_PropertyCalculatorEigen;
+
+      Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic> m_EndmemberMatrix;
+      SpectralUnmixingSolver::Pointer m_Solver;
+      itk::ModifiedTimeType m_PreparationTime = 0;
     };
   }
 }
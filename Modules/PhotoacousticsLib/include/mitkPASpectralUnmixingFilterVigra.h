@@ -99,6 +99,15 @@ namespace mitk {
       Eigen::VectorXf SpectralUnmixingAlgorithm(Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic> EndmemberMatrix,
         Eigen::VectorXf inputVector) override;
 
+      /**
+      * \brief overrides the baseclass method to factorize the endmember matrix once for all pixels. LARS and GOLDFARB both minimize
+      * (A*x-b)^2 s.t. x>=0 and are replaced by the batched non-negative solver, WEIGHTED and LS are linear in the input vector and
+      * are replaced by the matrix of their least squares solution.
+      * @throws if the algorithmName is not a member of the enum VigraAlgortihmType
+      * @throws if the number of weights doesn't fit to the number of wavelengths for the WEIGHTED algorithm
+      */
+      SpectralUnmixingSolver::Pointer CreateSolver(const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic>& endmemberMatrix) override;
+
     private:
       std::vector<double> weightsvec;
       SpectralUnmixingFilterVigra::VigraAlgortihmType algorithmName;
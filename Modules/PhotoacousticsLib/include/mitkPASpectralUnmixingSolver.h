@@ -0,0 +1,119 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKPHOTOACOUSTICSPECTRALUNMIXINGSOLVER_H
+#define MITKPHOTOACOUSTICSPECTRALUNMIXINGSOLVER_H
+
+#include <MitkPhotoacousticsLibExports.h>
+
+//Includes for smart pointer usage
+#include "mitkCommon.h"
+#include "itkLightObject.h"
+
+#include <eigen3/Eigen/Dense>
+#include <vector>
+
+namespace mitk {
+  namespace pa {
+    /**
+    * \brief The spectral unmixing solver unmixes blocks of pixels with one factorization of the endmember matrix, which is done
+    * when the solver is created. It is created by the subclasses of mitk::pa::SpectralUnmixingFilterBase for their algorithm.
+    *
+    * Linear solvers:
+    * All least squares algorithms map the multispectral values of a pixel linearly to its unmixing result. The solver holds this
+    * map as matrix with number of chromophores rows and number of wavelengths columns, so unmixing a block is one matrix product.
+    *
+    * Non-negative solvers:
+    * The solver minimizes (A*x-b)^2 s.t. x>=0 with the active set algorithm of Lawson and Hanson on the normal equations. The
+    * right hand sides transpose(A)*b of a block are one matrix product and the Gram matrix transpose(A)*A is inverted once for
+    * every subset of chromophores, so the iterations of a pixel only consist of small matrix vector products.
+    *
+    * Solve may be called from several threads at the same time.
+    */
+    class MITKPHOTOACOUSTICSLIB_EXPORT SpectralUnmixingSolver : public itk::LightObject
+    {
+    public:
+      mitkClassMacroItkParent(SpectralUnmixingSolver, itk::LightObject)
+
+      typedef Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic> MatrixType;
+
+      /**
+      * \brief A block of pixels of one sequence: column j contains the multispectral values of pixel j. The images of the
+      * wavelengths are the rows, so a block maps the input buffer without copying it.
+      */
+      typedef Eigen::Map<const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>, 0, Eigen::OuterStride<>> InputBlockType;
+
+      /**
+      * \brief Non-negative solvers store one inverse per subset of chromophores, so their number of chromophores is limited.
+      */
+      static const unsigned int MaximumNumberOfNonNegativeChromophores = 12;
+
+      /**
+      * \brief Non-negative solvers give up on a pixel after this number of iterations per chromophore, see Solve().
+      */
+      static const unsigned int MaximumNumberOfIterationsPerChromophore = 30;
+
+      /**
+      * \brief Creates a solver which unmixes a pixel b by solverMatrix*b.
+      * @param endmemberMatrix Matrix with number of chromophores colums and number of wavelengths rows
+      * @param solverMatrix Matrix with number of chromophores rows and number of wavelengths colums
+      * @throws if the sizes of the matrices don't fit
+      */
+      static Pointer CreateLinearSolver(const MatrixType& endmemberMatrix, const MatrixType& solverMatrix);
+
+      /**
+      * \brief Creates a solver which unmixes a pixel b by minimizing (A*x-b)^2 s.t. x>=0 with A as endmember matrix.
+      * @throws if the endmember matrix has more then MaximumNumberOfNonNegativeChromophores colums
+      */
+      static Pointer CreateNonNegativeSolver(const MatrixType& endmemberMatrix);
+
+      const MatrixType& GetEndmemberMatrix() const { return m_EndmemberMatrix; }
+
+      bool IsNonNegative() const { return m_NonNegative; }
+
+      /**
+      * \brief Unmixes all pixels of the input block.
+      * @param result is resized to number of chromophores rows and one colum per pixel; colum j contains the result of pixel j
+      * @return the number of pixels for which a non-negative solver reached its iteration limit before the optimality
+      * conditions of Lawson and Hanson were met; their result is the last iterate, which is feasible but not optimal
+      */
+      unsigned int Solve(const InputBlockType& input, MatrixType& result) const;
+
+    protected:
+      SpectralUnmixingSolver();
+      ~SpectralUnmixingSolver() override;
+
+    private:
+      /*
+      * \brief Replaces the right hand side transpose(A)*b of the normal equations of one pixel by its non-negative solution.
+      * Returns false if the iteration limit has been reached first.
+      */
+      bool SolveNonNegative(float* normalEquations) const;
+
+      MatrixType m_EndmemberMatrix;
+
+      // solver matrix of linear solvers, transpose of the endmember matrix for non-negative ones
+      MatrixType m_SolverMatrix;
+
+      bool m_NonNegative = false;
+
+      // Gram matrix and the inverses of its principal submatrices, indexed by the bit mask of the chromophore subset
+      MatrixType m_GramMatrix;
+      std::vector<MatrixType> m_SubsetInverses;
+    };
+  }
+}
+#endif // MITKPHOTOACOUSTICSPECTRALUNMIXINGSOLVER_H
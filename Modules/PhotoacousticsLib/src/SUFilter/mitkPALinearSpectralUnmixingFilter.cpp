@@ -34,6 +34,7 @@ mitk::pa::LinearSpectralUnmixingFilter::~LinearSpectralUnmixingFilter()
 void mitk::pa::LinearSpectralUnmixingFilter::SetAlgorithm(mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType inputAlgorithmName)
 {
   algorithmName = inputAlgorithmName;
+  this->Modified();
 }
 
 Eigen::VectorXf mitk::pa::LinearSpectralUnmixingFilter::SpectralUnmixingAlgorithm(
@@ -82,3 +83,53 @@ Eigen::VectorXf mitk::pa::LinearSpectralUnmixingFilter::SpectralUnmixingAlgorith
 
   return resultVector;
 }
+
+mitk::pa::SpectralUnmixingSolver::Pointer mitk::pa::LinearSpectralUnmixingFilter::CreateSolver(
+  const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic>& endmemberMatrix)
+{
+  // the decompositions are computed in double precision, because they are applied to all pixels
+  Eigen::MatrixXd endmemberMatrixDouble = endmemberMatrix.cast<double>();
+  Eigen::MatrixXd identity = Eigen::MatrixXd::Identity(endmemberMatrix.rows(), endmemberMatrix.rows());
+  Eigen::MatrixXd solverMatrix;
+
+  if (mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::HOUSEHOLDERQR == algorithmName)
+    solverMatrix = endmemberMatrixDouble.householderQr().solve(identity);
+
+  else if (mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::LDLT == algorithmName)
+  {
+    Eigen::LLT<Eigen::MatrixXd> lltOfA(endmemberMatrixDouble);
+    if (lltOfA.info() == Eigen::NumericalIssue)
+    {
+      mitkThrow() << "Possibly non semi-positive definitie endmembermatrix!";
+    }
+    else
+      solverMatrix = endmemberMatrixDouble.ldlt().solve(identity);
+  }
+
+  else if (mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::LLT == algorithmName)
+  {
+    Eigen::LLT<Eigen::MatrixXd> lltOfA(endmemberMatrixDouble);
+    if (lltOfA.info() == Eigen::NumericalIssue)
+    {
+      mitkThrow() << "Possibly non semi-positive definitie endmembermatrix!";
+    }
+    else
+      solverMatrix = lltOfA.solve(identity);
+  }
+
+  else if (mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::COLPIVHOUSEHOLDERQR == algorithmName)
+    solverMatrix = endmemberMatrixDouble.colPivHouseholderQr().solve(identity);
+
+  else if (mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::JACOBISVD == algorithmName)
+    solverMatrix = endmemberMatrixDouble.jacobiSvd(Eigen::ComputeFullU | Eigen::ComputeFullV).solve(identity);
+
+  else if (mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::FULLPIVLU == algorithmName)
+    solverMatrix = endmemberMatrixDouble.fullPivLu().solve(identity);
+
+  else if (mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::FULLPIVHOUSEHOLDERQR == algorithmName)
+    solverMatrix = endmemberMatrixDouble.fullPivHouseholderQr().solve(identity);
+  else
+    mitkThrow() << "404 VIGRA ALGORITHM NOT FOUND";
+
+  return SpectralUnmixingSolver::CreateLinearSolver(endmemberMatrix, solverMatrix.cast<float>());
+}
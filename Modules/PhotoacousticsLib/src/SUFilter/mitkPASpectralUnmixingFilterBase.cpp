@@ -24,6 +24,16 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkImageReadAccessor.h>
 #include <mitkImageWriteAccessor.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace
+{
+  // a block of 1024 pixels of up to 32 wavelengths stays in the cache of a core
+  const unsigned int BLOCK_SIZE = 1024;
+}
+
 mitk::pa::SpectralUnmixingFilterBase::SpectralUnmixingFilterBase()
 {
   m_PropertyCalculatorEigen = mitk::pa::PropertyCalculator::New();
@@ -46,11 +56,13 @@ void mitk::pa::SpectralUnmixingFilterBase::AddOutputs(unsigned int outputs)
 void mitk::pa::SpectralUnmixingFilterBase::AddWavelength(int wavelength)
 {
   m_Wavelength.push_back(wavelength);
+  this->Modified();
 }
 
 void mitk::pa::SpectralUnmixingFilterBase::AddChromophore(mitk::pa::PropertyCalculator::ChromophoreType chromophore)
 {
   m_Chromophore.push_back(chromophore);
+  this->Modified();
 }
 
 void mitk::pa::SpectralUnmixingFilterBase::Verbose(bool verbose)
@@ -92,8 +104,6 @@ void mitk::pa::SpectralUnmixingFilterBase::GenerateData()
   MITK_INFO(m_Verbose) << "TotalNumberOfSequences: " << totalNumberOfSequences;
 
   InitializeOutputs(totalNumberOfSequences);
-  
-  auto endmemberMatrix = CalculateEndmemberMatrix(m_Chromophore, m_Wavelength);
 
   // test to see pixel values @ txt file
   myfile.open("SimplexNormalisation.txt");
@@ -108,50 +118,114 @@ void mitk::pa::SpectralUnmixingFilterBase::GenerateData()
     writteBufferVector.push_back(writeBuffer);
   }
 
-  if (m_RelativeError == true)
-  {
-    // -1 because rel error is output[IndexedOutputs() - 1] and loop over chromophore outputs has to end at [IndexedOutputs() - 2]
-    outputCounter -= 1;
-  }
+  UnmixSequences(inputDataArray, xDim * yDim, totalNumberOfSequences, writteBufferVector);
+
+  MITK_INFO(m_Verbose) << "GENERATING DATA...[DONE]";
+  myfile.close();
+}
+
+void mitk::pa::SpectralUnmixingFilterBase::UnmixSequence(const float* sequence, unsigned int numberOfPixels, const std::vector<float*>& outputs)
+{
+  if (m_Chromophore.size() == 0 || m_Wavelength.size() == 0)
+    mitkThrow() << "NO WAVELENGHTS/CHROMOPHORES SELECTED!";
+
+  if (m_Chromophore.size() > m_Wavelength.size())
+    mitkThrow() << "ADD MORE WAVELENGTHS OR REMOVE ENDMEMBERS!";
+
+  if (m_Chromophore.size() + m_RelativeError != outputs.size())
+    mitkThrow() << "INDEX ERROR! NUMBER OF OUTPUTS DOESN'T FIT TO OTHER SETTIGNS!";
+
+  UnmixSequences(sequence, numberOfPixels, 1, outputs);
+}
+
+mitk::pa::SpectralUnmixingSolver::Pointer mitk::pa::SpectralUnmixingFilterBase::CreateSolver(
+  const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic>& /*endmemberMatrix*/)
+{
+  return nullptr;
+}
+
+void mitk::pa::SpectralUnmixingFilterBase::PrepareUnmixing()
+{
+  if (m_PreparationTime == this->GetMTime())
+    return;
+
+  m_EndmemberMatrix = CalculateEndmemberMatrix(m_Chromophore, m_Wavelength);
+  m_Solver = CreateSolver(m_EndmemberMatrix);
+  m_PreparationTime = this->GetMTime();
+  MITK_INFO(m_Verbose) << (m_Solver.IsNotNull() ? "FACTORIZING ENDMEMBERMATRIX [DONE]" : "UNMIXING PIXEL BY PIXEL");
+}
 
-  for (unsigned int sequenceCounter = 0; sequenceCounter < totalNumberOfSequences; ++sequenceCounter)
+void mitk::pa::SpectralUnmixingFilterBase::UnmixSequences(const float* input, unsigned int numberOfPixels, unsigned int numberOfSequences,
+  const std::vector<float*>& outputs)
+{
+  PrepareUnmixing();
+
+  const unsigned int sequenceSize = m_Wavelength.size();
+  const unsigned int numberOfChromophores = m_Chromophore.size();
+  const unsigned int blocksPerSequence = (numberOfPixels + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  const unsigned int numberOfBlocks = blocksPerSequence * numberOfSequences;
+
+  // the per pixel algorithms of the subclasses are not required to be thread safe
+  unsigned int numberOfThreads = m_Solver.IsNotNull() ? std::max(1u, (unsigned int)this->GetNumberOfThreads()) : 1;
+  numberOfThreads = std::min(numberOfThreads, numberOfBlocks);
+
+  std::atomic<unsigned int> nextBlock(0);
+  std::atomic<unsigned int> numberOfUnconvergedPixels(0);
+  auto unmixBlocks = [&]()
   {
-    MITK_INFO(m_Verbose) << "SequenceCounter: " << sequenceCounter;
-    //loop over every pixel in XY-plane
-    for (unsigned int x = 0; x < xDim; x++)
+    SpectralUnmixingSolver::MatrixType resultBlock;
+    for (unsigned int block = nextBlock++; block < numberOfBlocks; block = nextBlock++)
     {
-      for (unsigned int y = 0; y < yDim; y++)
-      {
-        Eigen::VectorXf inputVector(sequenceSize);
-        for (unsigned int z = 0; z < sequenceSize; z++)
-        {
-          /**
-          * 'sequenceCounter*sequenceSize' has to be added to 'z' to ensure that one accesses the
-          * correct pixel, because the inputDataArray contains the information of all sequences and
-          * not just the one of the current sequence.
-          */
-          unsigned int pixelNumber = (xDim*yDim*(z+sequenceCounter*sequenceSize)) + x * yDim + y;
-          auto pixel = inputDataArray[pixelNumber];
-
-          inputVector[z] = pixel;
-        }
-        Eigen::VectorXf resultVector = SpectralUnmixingAlgorithm(endmemberMatrix, inputVector);
-
-        if (m_RelativeError == true)
-        {
-          float relativeError = CalculateRelativeError(endmemberMatrix, inputVector, resultVector);
-          writteBufferVector[outputCounter][(xDim*yDim * sequenceCounter) + x * yDim + y] = relativeError;
-        }
-
-        for (unsigned int outputIdx = 0; outputIdx < outputCounter; ++outputIdx)
-        {
-          writteBufferVector[outputIdx][(xDim*yDim * sequenceCounter) + x * yDim + y] = resultVector[outputIdx];
-        }
-      }
+      const unsigned int sequenceCounter = block / blocksPerSequence;
+      const unsigned int firstPixel = (block % blocksPerSequence) * BLOCK_SIZE;
+      const unsigned int pixels = std::min(BLOCK_SIZE, numberOfPixels - firstPixel);
+
+      /**
+      * 'sequenceCounter*sequenceSize' images have to be skipped to ensure that one accesses the correct
+      * pixels, because the input contains the information of all sequences and not just the one of the
+      * current sequence.
+      */
+      const float* sequence = input + (size_t)numberOfPixels * sequenceSize * sequenceCounter;
+      SpectralUnmixingSolver::InputBlockType inputBlock(sequence + firstPixel, sequenceSize, pixels,
+        Eigen::OuterStride<>(numberOfPixels));
+
+      numberOfUnconvergedPixels += UnmixBlock(inputBlock, resultBlock);
+
+      const size_t outputOffset = (size_t)numberOfPixels * sequenceCounter + firstPixel;
+      for (unsigned int outputIdx = 0; outputIdx < numberOfChromophores; ++outputIdx)
+        Eigen::Map<Eigen::RowVectorXf>(outputs[outputIdx] + outputOffset, pixels) = resultBlock.row(outputIdx);
+
+      // rel error is the output behind the chromophore outputs
+      if (m_RelativeError == true)
+        CalculateRelativeErrors(inputBlock, resultBlock, outputs[numberOfChromophores] + outputOffset);
     }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned int threadIdx = 1; threadIdx < numberOfThreads; ++threadIdx)
+    threads.emplace_back(unmixBlocks);
+  unmixBlocks();
+  for (auto& thread : threads)
+    thread.join();
+
+  if (numberOfUnconvergedPixels > 0)
+    MITK_WARN << numberOfUnconvergedPixels.load() << " PIXELS REACHED THE ITERATION LIMIT OF THE NON-NEGATIVE SOLVER, THEIR RESULT IS NOT OPTIMAL";
+}
+
+unsigned int mitk::pa::SpectralUnmixingFilterBase::UnmixBlock(const SpectralUnmixingSolver::InputBlockType& inputBlock,
+  SpectralUnmixingSolver::MatrixType& resultBlock)
+{
+  if (m_Solver.IsNotNull())
+    return m_Solver->Solve(inputBlock, resultBlock);
+
+  resultBlock.resize(m_EndmemberMatrix.cols(), inputBlock.cols());
+  for (Eigen::Index pixel = 0; pixel < inputBlock.cols(); ++pixel)
+  {
+    Eigen::VectorXf inputVector = inputBlock.col(pixel);
+    resultBlock.col(pixel) = SpectralUnmixingAlgorithm(m_EndmemberMatrix, inputVector);
   }
-  MITK_INFO(m_Verbose) << "GENERATING DATA...[DONE]";
-  myfile.close();
+
+  return 0;
 }
 
 void mitk::pa::SpectralUnmixingFilterBase::CheckPreConditions(mitk::Image::Pointer input)
@@ -226,14 +300,17 @@ float mitk::pa::SpectralUnmixingFilterBase::PropertyElement(mitk::pa::PropertyCa
   }
 }
 
-float mitk::pa::SpectralUnmixingFilterBase::CalculateRelativeError(Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic> endmemberMatrix,
-  Eigen::VectorXf inputVector, Eigen::VectorXf resultVector)
+void mitk::pa::SpectralUnmixingFilterBase::CalculateRelativeErrors(const SpectralUnmixingSolver::InputBlockType& inputBlock,
+  const SpectralUnmixingSolver::MatrixType& resultBlock, float* relativeErrors)
 {
-  float relativeError = (endmemberMatrix*resultVector - inputVector).norm() / inputVector.norm();
-  for (int i = 0; i < 2; ++i)
+  SpectralUnmixingSolver::MatrixType residuals = m_EndmemberMatrix * resultBlock - inputBlock;
+  for (Eigen::Index pixel = 0; pixel < resultBlock.cols(); ++pixel)
   {
-    if (resultVector[i] < m_RelativeErrorSettings[i])
-      return 0;
+    relativeErrors[pixel] = residuals.col(pixel).norm() / inputBlock.col(pixel).norm();
+    for (unsigned int i = 0; i < 2 && i < m_RelativeErrorSettings.size() && i < resultBlock.rows(); ++i)
+    {
+      if (resultBlock(i, pixel) < m_RelativeErrorSettings[i])
+        relativeErrors[pixel] = 0;
+    }
   }
-  return relativeError;
 }
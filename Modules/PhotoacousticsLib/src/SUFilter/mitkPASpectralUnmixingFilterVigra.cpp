@@ -25,6 +25,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vigra/regression.hxx>
 #include <vigra/quadprog.hxx>
 
+#include <cmath>
+
 mitk::pa::SpectralUnmixingFilterVigra::SpectralUnmixingFilterVigra()
 {
 }
@@ -36,12 +38,14 @@ mitk::pa::SpectralUnmixingFilterVigra::~SpectralUnmixingFilterVigra()
 void mitk::pa::SpectralUnmixingFilterVigra::SetAlgorithm(mitk::pa::SpectralUnmixingFilterVigra::VigraAlgortihmType inputAlgorithmName)
 {
   algorithmName = inputAlgorithmName;
+  this->Modified();
 }
 
 void mitk::pa::SpectralUnmixingFilterVigra::AddWeight(unsigned int weight)
 {
   double value = double(weight) / 100.0;
   weightsvec.push_back(value);
+  this->Modified();
 }
 
 Eigen::VectorXf mitk::pa::SpectralUnmixingFilterVigra::SpectralUnmixingAlgorithm(
@@ -102,3 +106,36 @@ Eigen::VectorXf mitk::pa::SpectralUnmixingFilterVigra::SpectralUnmixingAlgorithm
 
   return resultVector;
 }
+
+mitk::pa::SpectralUnmixingSolver::Pointer mitk::pa::SpectralUnmixingFilterVigra::CreateSolver(
+  const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic>& endmemberMatrix)
+{
+  unsigned int numberOfWavelengths = endmemberMatrix.rows();
+  unsigned int numberOfChromophores = endmemberMatrix.cols();
+
+  if (mitk::pa::SpectralUnmixingFilterVigra::VigraAlgortihmType::LARS == algorithmName ||
+    mitk::pa::SpectralUnmixingFilterVigra::VigraAlgortihmType::GOLDFARB == algorithmName)
+  {
+    // the vigra algorithms unmix pixel by pixel if there are too many chromophores for the batched solver
+    if (numberOfChromophores > SpectralUnmixingSolver::MaximumNumberOfNonNegativeChromophores)
+      return nullptr;
+    return SpectralUnmixingSolver::CreateNonNegativeSolver(endmemberMatrix);
+  }
+
+  // minimizing transpose(A*x-b)*diag(weights)*(A*x-b) equals minimizing (diag(sqrt(weights))*(A*x-b))^2
+  Eigen::VectorXd rowWeights = Eigen::VectorXd::Ones(numberOfWavelengths);
+  if (mitk::pa::SpectralUnmixingFilterVigra::VigraAlgortihmType::WEIGHTED == algorithmName)
+  {
+    if (weightsvec.size() != numberOfWavelengths)
+      mitkThrow() << "Number of weights and wavelengths doesn't match! OR Invalid weight!";
+    for (unsigned int i = 0; i < numberOfWavelengths; ++i)
+      rowWeights[i] = std::sqrt(weightsvec[i]);
+  }
+  else if (mitk::pa::SpectralUnmixingFilterVigra::VigraAlgortihmType::LS != algorithmName)
+    mitkThrow() << "404 VIGRA ALGORITHM NOT FOUND";
+
+  Eigen::MatrixXd weightedEndmemberMatrix = rowWeights.asDiagonal() * endmemberMatrix.cast<double>();
+  Eigen::MatrixXd solverMatrix = weightedEndmemberMatrix.householderQr().solve(Eigen::MatrixXd(rowWeights.asDiagonal()));
+
+  return SpectralUnmixingSolver::CreateLinearSolver(endmemberMatrix, solverMatrix.cast<float>());
+}
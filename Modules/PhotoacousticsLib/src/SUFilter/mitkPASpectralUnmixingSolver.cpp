@@ -0,0 +1,207 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPASpectralUnmixingSolver.h"
+
+#include <mitkException.h>
+
+#include <algorithm>
+#include <cmath>
+
+mitk::pa::SpectralUnmixingSolver::SpectralUnmixingSolver()
+{
+}
+
+mitk::pa::SpectralUnmixingSolver::~SpectralUnmixingSolver()
+{
+}
+
+mitk::pa::SpectralUnmixingSolver::Pointer mitk::pa::SpectralUnmixingSolver::CreateLinearSolver(
+  const MatrixType& endmemberMatrix, const MatrixType& solverMatrix)
+{
+  if (solverMatrix.rows() != endmemberMatrix.cols() || solverMatrix.cols() != endmemberMatrix.rows())
+    mitkThrow() << "SOLVER MATRIX DOESN'T FIT TO THE ENDMEMBER MATRIX!";
+
+  Pointer solver = new SpectralUnmixingSolver();
+  solver->UnRegister();
+  solver->m_EndmemberMatrix = endmemberMatrix;
+  solver->m_SolverMatrix = solverMatrix;
+  return solver;
+}
+
+mitk::pa::SpectralUnmixingSolver::Pointer mitk::pa::SpectralUnmixingSolver::CreateNonNegativeSolver(const MatrixType& endmemberMatrix)
+{
+  const unsigned int numberOfChromophores = endmemberMatrix.cols();
+  if (numberOfChromophores == 0 || numberOfChromophores > MaximumNumberOfNonNegativeChromophores)
+    mitkThrow() << "NUMBER OF CHROMOPHORES NOT SUPPORTED BY NON-NEGATIVE SOLVER!";
+
+  Pointer solver = new SpectralUnmixingSolver();
+  solver->UnRegister();
+  solver->m_EndmemberMatrix = endmemberMatrix;
+  solver->m_SolverMatrix = endmemberMatrix.transpose();
+  solver->m_NonNegative = true;
+
+  // the inverses are computed in double precision, because the Gram matrix squares the condition of the endmember matrix
+  Eigen::MatrixXd gramMatrix = endmemberMatrix.cast<double>().transpose() * endmemberMatrix.cast<double>();
+  solver->m_GramMatrix = gramMatrix.cast<float>();
+  solver->m_SubsetInverses.resize(1u << numberOfChromophores);
+
+  std::vector<unsigned int> indices;
+  for (unsigned int subset = 1; subset < solver->m_SubsetInverses.size(); ++subset)
+  {
+    indices.clear();
+    for (unsigned int j = 0; j < numberOfChromophores; ++j)
+    {
+      if (subset & (1u << j))
+        indices.push_back(j);
+    }
+
+    Eigen::MatrixXd subMatrix(indices.size(), indices.size());
+    for (unsigned int a = 0; a < indices.size(); ++a)
+    {
+      for (unsigned int b = 0; b < indices.size(); ++b)
+        subMatrix(a, b) = gramMatrix(indices[a], indices[b]);
+    }
+    Eigen::MatrixXd identity = Eigen::MatrixXd::Identity(indices.size(), indices.size());
+    solver->m_SubsetInverses[subset] = subMatrix.ldlt().solve(identity).cast<float>();
+  }
+  return solver;
+}
+
+unsigned int mitk::pa::SpectralUnmixingSolver::Solve(const InputBlockType& input, MatrixType& result) const
+{
+  result.noalias() = m_SolverMatrix * input;
+
+  unsigned int numberOfUnconvergedPixels = 0;
+  if (m_NonNegative)
+  {
+    for (Eigen::Index pixel = 0; pixel < result.cols(); ++pixel)
+    {
+      if (!SolveNonNegative(result.col(pixel).data()))
+        ++numberOfUnconvergedPixels;
+    }
+  }
+  return numberOfUnconvergedPixels;
+}
+
+bool mitk::pa::SpectralUnmixingSolver::SolveNonNegative(float* normalEquations) const
+{
+  const unsigned int numberOfChromophores = m_EndmemberMatrix.cols();
+  float rightHandSide[MaximumNumberOfNonNegativeChromophores];
+  float x[MaximumNumberOfNonNegativeChromophores];
+  float z[MaximumNumberOfNonNegativeChromophores];
+
+  float scale = 0;
+  for (unsigned int j = 0; j < numberOfChromophores; ++j)
+  {
+    rightHandSide[j] = normalEquations[j];
+    x[j] = 0;
+    scale = std::max(scale, std::abs(rightHandSide[j]));
+  }
+  const float tolerance = 1e-5f * scale;
+
+  // bit mask of the chromophores which may be positive; all others are zero
+  unsigned int passive = 0;
+
+  // Lawson and Hanson terminate if no gradient is positive, which happens after a finite number of iterations in exact
+  // arithmetic; the limit only guards against cycling due to rounding errors
+  bool converged = false;
+  for (unsigned int iteration = 0; iteration < MaximumNumberOfIterationsPerChromophore * numberOfChromophores; ++iteration)
+  {
+    // the chromophore with the largest gradient of the residual becomes passive
+    int next = -1;
+    float largestGradient = tolerance;
+    for (unsigned int j = 0; j < numberOfChromophores; ++j)
+    {
+      if (passive & (1u << j))
+        continue;
+
+      float gradient = rightHandSide[j];
+      for (unsigned int k = 0; k < numberOfChromophores; ++k)
+        gradient -= m_GramMatrix(k, j) * x[k];
+      if (gradient > largestGradient)
+      {
+        largestGradient = gradient;
+        next = j;
+      }
+    }
+    if (next < 0)
+    {
+      converged = true;
+      break;
+    }
+    passive |= 1u << next;
+
+    for (unsigned int step = 0; step <= numberOfChromophores && passive != 0; ++step)
+    {
+      // unconstrained least squares solution on the passive set
+      const MatrixType& inverse = m_SubsetInverses[passive];
+      unsigned int a = 0;
+      for (unsigned int j = 0; j < numberOfChromophores; ++j)
+      {
+        z[j] = 0;
+        if (!(passive & (1u << j)))
+          continue;
+
+        unsigned int b = 0;
+        for (unsigned int k = 0; k < numberOfChromophores; ++k)
+        {
+          if (passive & (1u << k))
+            z[j] += inverse(a, b++) * rightHandSide[k];
+        }
+        ++a;
+      }
+
+      // move towards the solution until the first passive chromophore gets zero
+      float alpha = 1;
+      int blocking = -1;
+      for (unsigned int j = 0; j < numberOfChromophores; ++j)
+      {
+        if ((passive & (1u << j)) && z[j] <= 0)
+        {
+          const float ratio = x[j] > z[j] ? x[j] / (x[j] - z[j]) : 0.f;
+          if (ratio < alpha)
+          {
+            alpha = ratio;
+            blocking = j;
+          }
+        }
+      }
+
+      for (unsigned int j = 0; j < numberOfChromophores; ++j)
+      {
+        if (passive & (1u << j))
+          x[j] += alpha * (z[j] - x[j]);
+      }
+      if (blocking < 0)
+        break;
+
+      for (unsigned int j = 0; j < numberOfChromophores; ++j)
+      {
+        if ((passive & (1u << j)) && ((int)j == blocking || x[j] <= 0))
+        {
+          passive &= ~(1u << j);
+          x[j] = 0;
+        }
+      }
+    }
+  }
+
+  for (unsigned int j = 0; j < numberOfChromophores; ++j)
+    normalEquations[j] = x[j];
+
+  return converged;
+}
@@ -17,6 +17,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkPAMonteCarloThreadHandler.h"
 #include "mitkCommon.h"
 
+#include <algorithm>
+#include <chrono>
+
 mitk::pa::MonteCarloThreadHandler::MonteCarloThreadHandler(long timInMillisecondsOrNumberofPhotons, bool simulateOnTimeBasis) :
   MonteCarloThreadHandler(timInMillisecondsOrNumberofPhotons, simulateOnTimeBasis, true){}
 
@@ -28,7 +31,7 @@ mitk::pa::MonteCarloThreadHandler::MonteCarloThreadHandler(long timInMillisecond
   m_SimulationTime = 0;
   m_Time = 0;
   m_NumberPhotonsToSimulate = 0;
-  m_NumberPhotonsRemaining = 0;
+  m_NextPhotonIndex = 0;
 
   if (m_SimulateOnTimeBasis)
   {
@@ -38,7 +41,6 @@ mitk::pa::MonteCarloThreadHandler::MonteCarloThreadHandler(long timInMillisecond
   else
   {
     m_NumberPhotonsToSimulate = timInMillisecondsOrNumberofPhotons;
-    m_NumberPhotonsRemaining = timInMillisecondsOrNumberofPhotons;
   }
 }
 
@@ -47,14 +49,22 @@ mitk::pa::MonteCarloThreadHandler::~MonteCarloThreadHandler()
 }
 
 long mitk::pa::MonteCarloThreadHandler::GetNextWorkPackage()
+{
+  long long firstPhotonIndex;
+  return GetNextWorkPackage(firstPhotonIndex);
+}
+
+long mitk::pa::MonteCarloThreadHandler::GetNextWorkPackage(long long& firstPhotonIndex)
 {
   long workPackageSize = 0;
+  firstPhotonIndex = 0;
   if (m_SimulateOnTimeBasis)
   {
     long now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
     if (now - m_Time <= m_SimulationTime)
     {
       workPackageSize = m_WorkPackageSize;
+      firstPhotonIndex = m_NextPhotonIndex.fetch_add(workPackageSize);
       if (m_Verbose)
       {
         std::cout << "<filter-progress-text progress='" << ((double)(now - m_Time) / m_SimulationTime) << "'></filter-progress-text>" << std::endl;
@@ -63,29 +73,30 @@ long mitk::pa::MonteCarloThreadHandler::GetNextWorkPackage()
   }
   else
   {
-    m_MutexRemainingPhotonsManipulation.lock();
-
-    if (m_NumberPhotonsRemaining < m_WorkPackageSize)
+    // every thread takes the next package size photons; the last package is truncated, all later ones are empty
+    long long nextPhotonIndex = m_NextPhotonIndex.fetch_add(m_WorkPackageSize);
+    if (nextPhotonIndex < m_NumberPhotonsToSimulate)
     {
-      workPackageSize = m_NumberPhotonsRemaining;
+      firstPhotonIndex = nextPhotonIndex;
+      workPackageSize = (long)std::min<long long>(m_WorkPackageSize, m_NumberPhotonsToSimulate - nextPhotonIndex);
     }
-    else
-    {
-      workPackageSize = m_WorkPackageSize;
-    }
-
-    m_NumberPhotonsRemaining -= workPackageSize;
-    m_MutexRemainingPhotonsManipulation.unlock();
 
     if (m_Verbose)
     {
-      std::cout << "<filter-progress-text progress='" << 1.0 - ((double)m_NumberPhotonsRemaining / m_NumberPhotonsToSimulate) << "'></filter-progress-text>" << std::endl;
+      std::cout << "<filter-progress-text progress='" << 1.0 - ((double)GetNumberPhotonsRemaining() / m_NumberPhotonsToSimulate) << "'></filter-progress-text>" << std::endl;
     }
   }
 
   return workPackageSize;
 }
 
+long mitk::pa::MonteCarloThreadHandler::GetNumberPhotonsRemaining() const
+{
+  if (m_SimulateOnTimeBasis)
+    return 0;
+  return (long)std::max<long long>(0, m_NumberPhotonsToSimulate - m_NextPhotonIndex.load());
+}
+
 void mitk::pa::MonteCarloThreadHandler::SetPackageSize(long sizeInMilliseconsOrNumberOfPhotons)
 {
   m_WorkPackageSize = sizeInMilliseconsOrNumberOfPhotons;
@@ -0,0 +1,55 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPAPhotonRandomStream.h"
+
+mitk::pa::PhotonRandomStream::PhotonRandomStream(unsigned long long seed) :
+  m_Counter{ 0, 0, 0, 0 },
+  m_Block{ 0, 0, 0, 0 },
+  m_NumbersLeft(0)
+{
+  m_Key[0] = (uint32_t)seed;
+  m_Key[1] = (uint32_t)(seed >> 32);
+}
+
+void mitk::pa::PhotonRandomStream::Start(unsigned long long firstPhotonIndex, uint32_t photonInPackage)
+{
+  m_Counter[0] = 0;
+  m_Counter[1] = photonInPackage;
+  m_Counter[2] = (uint32_t)firstPhotonIndex;
+  m_Counter[3] = (uint32_t)(firstPhotonIndex >> 32);
+  m_NumbersLeft = 0;
+}
+
+void mitk::pa::PhotonRandomStream::Philox(const uint32_t counter[4], const uint32_t key[2], uint32_t result[4])
+{
+  uint32_t roundKey[2] = { key[0], key[1] };
+  uint32_t block[4] = { counter[0], counter[1], counter[2], counter[3] };
+  for (int round = 0; round < 10; ++round)
+  {
+    uint64_t product0 = (uint64_t)0xD2511F53 * block[0];
+    uint64_t product1 = (uint64_t)0xCD9E8D57 * block[2];
+    uint32_t next[4] = {
+      (uint32_t)(product1 >> 32) ^ block[1] ^ roundKey[0], (uint32_t)product1,
+      (uint32_t)(product0 >> 32) ^ block[3] ^ roundKey[1], (uint32_t)product0 };
+    for (int j = 0; j < 4; ++j)
+      block[j] = next[j];
+    roundKey[0] += 0x9E3779B9;
+    roundKey[1] += 0xBB67AE85;
+  }
+  for (int j = 0; j < 4; ++j)
+    result[j] = block[j];
+}
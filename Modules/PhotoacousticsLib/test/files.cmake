@@ -29,6 +29,7 @@ set(MODULE_TESTS
   mitkSpectralUnmixingTest.cpp
   mitkPhotoacousticVesselMeanderStrategyTest.cpp
   mitkPhotoacousticVesselTest.cpp
+  mitkPhotonRandomStreamTest.cpp
 )
 
 set(RESOURCE_FILES
@@ -0,0 +1,142 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkPAMonteCarloThreadHandler.h>
+#include <mitkPAPhotonRandomStream.h>
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class mitkPhotonRandomStreamTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkPhotonRandomStreamTestSuite);
+  MITK_TEST(testPhiloxKnownAnswers);
+  MITK_TEST(testStreamDependsOnlyOnSeedAndPhoton);
+  MITK_TEST(testNumbersAreInUnitInterval);
+  MITK_TEST(testConcurrentWorkPackagesCoverEveryPhotonOnce);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  void AssertPhilox(uint32_t counterWord, uint32_t keyWord, const uint32_t expected[4])
+  {
+    const uint32_t counter[4] = { counterWord, counterWord, counterWord, counterWord };
+    const uint32_t key[2] = { keyWord, keyWord };
+    uint32_t result[4];
+    mitk::pa::PhotonRandomStream::Philox(counter, key, result);
+    for (int i = 0; i < 4; ++i)
+      CPPUNIT_ASSERT_EQUAL(expected[i], result[i]);
+  }
+
+  std::vector<double> Draw(mitk::pa::PhotonRandomStream& stream, unsigned long long firstPhotonIndex, uint32_t photonInPackage)
+  {
+    stream.Start(firstPhotonIndex, photonInPackage);
+    std::vector<double> numbers(9);
+    for (auto& number : numbers)
+      number = stream.RandomGen();
+    return numbers;
+  }
+
+public:
+
+  void testPhiloxKnownAnswers()
+  {
+    // known-answer vectors of Philox4x32-10 from Random123
+    const uint32_t zeros[4] = { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 };
+    this->AssertPhilox(0, 0, zeros);
+
+    const uint32_t ones[4] = { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd };
+    this->AssertPhilox(0xffffffff, 0xffffffff, ones);
+  }
+
+  void testStreamDependsOnlyOnSeedAndPhoton()
+  {
+    mitk::pa::PhotonRandomStream stream(4711);
+    mitk::pa::PhotonRandomStream otherStream(4711);
+    mitk::pa::PhotonRandomStream otherSeed(4712);
+
+    const std::vector<double> numbers = this->Draw(stream, 1ULL << 33, 5);
+    this->Draw(otherStream, 0, 1);
+    CPPUNIT_ASSERT(numbers == this->Draw(otherStream, 1ULL << 33, 5));
+    CPPUNIT_ASSERT(numbers == this->Draw(stream, 1ULL << 33, 5));
+
+    CPPUNIT_ASSERT(numbers != this->Draw(stream, 1ULL << 33, 6));
+    CPPUNIT_ASSERT(numbers != this->Draw(stream, 1, 5));
+    CPPUNIT_ASSERT(numbers != this->Draw(otherSeed, 1ULL << 33, 5));
+  }
+
+  void testNumbersAreInUnitInterval()
+  {
+    mitk::pa::PhotonRandomStream stream(42);
+    stream.Start(0, 0);
+
+    double sum = 0;
+    const int numberOfDraws = 100000;
+    for (int i = 0; i < numberOfDraws; ++i)
+    {
+      const double number = stream.RandomGen();
+      CPPUNIT_ASSERT(number >= 0.0 && number < 1.0);
+      sum += number;
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, sum / numberOfDraws, 0.01);
+  }
+
+  void testConcurrentWorkPackagesCoverEveryPhotonOnce()
+  {
+    const long numberOfPhotons = 100003;
+    const unsigned int numberOfThreads = 4;
+    auto threadHandler = mitk::pa::MonteCarloThreadHandler::New(numberOfPhotons, false, false);
+    threadHandler->SetPackageSize(97);
+
+    std::vector<std::vector<std::pair<long long, long>>> packages(numberOfThreads);
+    std::vector<std::thread> threads;
+    for (unsigned int thread = 0; thread < numberOfThreads; ++thread)
+    {
+      threads.push_back(std::thread([&threadHandler, &packages, thread]()
+      {
+        long long firstPhotonIndex = 0;
+        long nextWorkPackage = 0;
+        while ((nextWorkPackage = threadHandler->GetNextWorkPackage(firstPhotonIndex)) > 0)
+        {
+          packages[thread].push_back(std::make_pair(firstPhotonIndex, nextWorkPackage));
+        }
+      }));
+    }
+    for (auto& thread : threads)
+      thread.join();
+
+    std::vector<std::pair<long long, long>> allPackages;
+    for (const auto& threadPackages : packages)
+      allPackages.insert(allPackages.end(), threadPackages.begin(), threadPackages.end());
+    std::sort(allPackages.begin(), allPackages.end());
+
+    long long nextPhotonIndex = 0;
+    for (const auto& package : allPackages)
+    {
+      CPPUNIT_ASSERT_EQUAL(nextPhotonIndex, package.first);
+      nextPhotonIndex += package.second;
+    }
+    CPPUNIT_ASSERT_EQUAL((long long)numberOfPhotons, nextPhotonIndex);
+    CPPUNIT_ASSERT_EQUAL(0L, threadHandler->GetNumberPhotonsRemaining());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkPhotonRandomStream)
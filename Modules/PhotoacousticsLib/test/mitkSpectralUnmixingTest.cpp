@@ -21,7 +21,9 @@
 #include <mitkPASpectralUnmixingFilterVigra.h>
 #include <mitkPASpectralUnmixingFilterSimplex.h>
 #include <mitkPASpectralUnmixingSO2.h>
+#include <mitkPASpectralUnmixingSolver.h>
 #include <mitkImageReadAccessor.h>
+#include <random>
 
 class mitkSpectralUnmixingTestSuite : public mitk::TestFixture
 {
@@ -37,6 +39,9 @@ class mitkSpectralUnmixingTestSuite : public mitk::TestFixture
   MITK_TEST(testAddOutput);
   MITK_TEST(testWeightsError);
   MITK_TEST(testOutputs);
+  MITK_TEST(testUnmixSequence);
+  MITK_TEST(testLargeImageEqualsPixelwiseSolution);
+  MITK_TEST(testNonNegativeSolver);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -638,6 +643,153 @@ public:
     }
   }
 
+  // Test streaming of single sequences
+  void testUnmixSequence()
+  {
+    MITK_INFO << "UnmixSequence TEST";
+
+    auto m_SpectralUnmixingFilter = mitk::pa::LinearSpectralUnmixingFilter::New();
+    m_SpectralUnmixingFilter->Verbose(false);
+    m_SpectralUnmixingFilter->RelativeError(false);
+
+    //Set wavelengths to filter
+    for (unsigned int imageIndex = 0; imageIndex < m_inputWavelengths.size(); imageIndex++)
+    {
+      unsigned int wavelength = m_inputWavelengths[imageIndex];
+      m_SpectralUnmixingFilter->AddWavelength(wavelength);
+    }
+
+    m_SpectralUnmixingFilter->AddChromophore(
+      mitk::pa::PropertyCalculator::ChromophoreType::OXYGENATED);
+    m_SpectralUnmixingFilter->AddChromophore(
+      mitk::pa::PropertyCalculator::ChromophoreType::DEOXYGENATED);
+
+    m_SpectralUnmixingFilter->SetAlgorithm(mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::HOUSEHOLDERQR);
+
+    mitk::ImageReadAccessor readAccess(inputImage);
+    const float* inputDataArray = ((const float*)readAccess.GetData());
+
+    float resultHbO2 = 0;
+    float resultHb = 0;
+    std::vector<float*> outputs = { &resultHbO2, &resultHb };
+
+    // both sequences are unmixed with the same factorization
+    for (int sequence = 0; sequence < 2; ++sequence)
+    {
+      m_SpectralUnmixingFilter->UnmixSequence(inputDataArray + 2 * sequence, 1, outputs);
+      CPPUNIT_ASSERT(std::abs(resultHbO2 - m_CorrectResult[2 * sequence]) < threshold);
+      CPPUNIT_ASSERT(std::abs(resultHb - m_CorrectResult[2 * sequence + 1]) < threshold);
+    }
+
+    outputs.push_back(&resultHb);
+    MITK_TEST_FOR_EXCEPTION_BEGIN(itk::ExceptionObject)
+      m_SpectralUnmixingFilter->UnmixSequence(inputDataArray, 1, outputs);
+    MITK_TEST_FOR_EXCEPTION_END(itk::ExceptionObject)
+  }
+
+  // Test blocks of pixels on several threads against the solution of every single pixel
+  void testLargeImageEqualsPixelwiseSolution()
+  {
+    MITK_INFO << "LARGE IMAGE TEST";
+
+    const unsigned int xDim = 53;
+    const unsigned int yDim = 41;
+    const unsigned int numberOfSequences = 3;
+    const unsigned int numberOfPixels = xDim * yDim;
+    const unsigned int sequenceSize = m_inputWavelengths.size();
+
+    std::vector<float> data(numberOfPixels * sequenceSize * numberOfSequences);
+    std::default_random_engine randomGenerator(42);
+    std::uniform_real_distribution<float> pixelValue(0, 3000);
+    for (auto& value : data)
+      value = pixelValue(randomGenerator);
+
+    auto largeImage = mitk::Image::New();
+    unsigned int dimensions[3] = { xDim, yDim, sequenceSize * numberOfSequences };
+    largeImage->Initialize(mitk::MakeScalarPixelType<float>(), 3, dimensions);
+    largeImage->SetImportVolume(data.data(), mitk::Image::ImportMemoryManagementType::CopyMemory);
+
+    auto m_SpectralUnmixingFilter = mitk::pa::LinearSpectralUnmixingFilter::New();
+    m_SpectralUnmixingFilter->Verbose(false);
+    m_SpectralUnmixingFilter->RelativeError(false);
+    m_SpectralUnmixingFilter->SetInput(largeImage);
+    m_SpectralUnmixingFilter->AddOutputs(2);
+    m_SpectralUnmixingFilter->SetNumberOfThreads(3);
+
+    for (unsigned int imageIndex = 0; imageIndex < sequenceSize; imageIndex++)
+      m_SpectralUnmixingFilter->AddWavelength(m_inputWavelengths[imageIndex]);
+
+    m_SpectralUnmixingFilter->AddChromophore(
+      mitk::pa::PropertyCalculator::ChromophoreType::OXYGENATED);
+    m_SpectralUnmixingFilter->AddChromophore(
+      mitk::pa::PropertyCalculator::ChromophoreType::DEOXYGENATED);
+
+    m_SpectralUnmixingFilter->SetAlgorithm(mitk::pa::LinearSpectralUnmixingFilter::AlgortihmType::HOUSEHOLDERQR);
+    m_SpectralUnmixingFilter->Update();
+
+    auto propertyCalculator = mitk::pa::PropertyCalculator::New();
+    Eigen::MatrixXd endmemberMatrix(sequenceSize, 2);
+    for (unsigned int i = 0; i < sequenceSize; ++i)
+    {
+      endmemberMatrix(i, 0) = (float)propertyCalculator->GetAbsorptionForWavelength(
+        mitk::pa::PropertyCalculator::ChromophoreType::OXYGENATED, m_inputWavelengths[i]);
+      endmemberMatrix(i, 1) = (float)propertyCalculator->GetAbsorptionForWavelength(
+        mitk::pa::PropertyCalculator::ChromophoreType::DEOXYGENATED, m_inputWavelengths[i]);
+    }
+
+    mitk::ImageReadAccessor readAccessHbO2(m_SpectralUnmixingFilter->GetOutput(0));
+    mitk::ImageReadAccessor readAccessHb(m_SpectralUnmixingFilter->GetOutput(1));
+    const float* resultHbO2 = (const float*)readAccessHbO2.GetData();
+    const float* resultHb = (const float*)readAccessHb.GetData();
+
+    for (unsigned int sequence = 0; sequence < numberOfSequences; ++sequence)
+    {
+      for (unsigned int pixel = 0; pixel < numberOfPixels; ++pixel)
+      {
+        Eigen::VectorXd inputVector(sequenceSize);
+        for (unsigned int z = 0; z < sequenceSize; ++z)
+          inputVector[z] = data[numberOfPixels * (z + sequence * sequenceSize) + pixel];
+        Eigen::VectorXd resultVector = endmemberMatrix.householderQr().solve(inputVector);
+
+        CPPUNIT_ASSERT(std::abs(resultHbO2[numberOfPixels * sequence + pixel] - resultVector[0]) < threshold);
+        CPPUNIT_ASSERT(std::abs(resultHb[numberOfPixels * sequence + pixel] - resultVector[1]) < threshold);
+      }
+    }
+  }
+
+  // Test the batched non-negative least squares solver
+  void testNonNegativeSolver()
+  {
+    MITK_INFO << "NON-NEGATIVE SOLVER TEST";
+
+    Eigen::MatrixXf endmemberMatrix(3, 2);
+    endmemberMatrix << 2.77f, 7.52f,
+                       4.37f, 4.08f,
+                       5.00f, 2.00f;
+    auto solver = mitk::pa::SpectralUnmixingSolver::CreateNonNegativeSolver(endmemberMatrix);
+    CPPUNIT_ASSERT(solver->IsNonNegative());
+
+    // the first pixel is a positive mixture, the unconstrained solution of the second one has a negative second component
+    Eigen::Vector2f positive(300, 100);
+    Eigen::Vector2f negative(300, -100);
+    Eigen::Matrix<float, 3, 2> pixels;
+    pixels.col(0) = endmemberMatrix * positive;
+    pixels.col(1) = endmemberMatrix * negative;
+
+    Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> input = pixels;
+    mitk::pa::SpectralUnmixingSolver::InputBlockType inputBlock(input.data(), 3, 2, Eigen::OuterStride<>(2));
+    mitk::pa::SpectralUnmixingSolver::MatrixType result;
+    CPPUNIT_ASSERT_EQUAL(0u, solver->Solve(inputBlock, result));
+
+    CPPUNIT_ASSERT(std::abs(result(0, 0) - positive[0]) < threshold);
+    CPPUNIT_ASSERT(std::abs(result(1, 0) - positive[1]) < threshold);
+
+    // the best non-negative solution is the projection onto the first endmember
+    float expected = endmemberMatrix.col(0).dot(pixels.col(1)) / endmemberMatrix.col(0).squaredNorm();
+    CPPUNIT_ASSERT(std::abs(result(0, 1) - expected) < threshold);
+    CPPUNIT_ASSERT(result(1, 1) == 0);
+  }
+
   // TEST TEMPLATE:
   /*
   // Test exceptions for
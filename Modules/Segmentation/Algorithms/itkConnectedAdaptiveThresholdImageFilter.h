@@ -25,6 +25,9 @@ namespace itk
   * \brief ImageFilter used for processing an image with an adaptive
   *        iterator (such as itkAdaptiveThresholdIterator)
   *
+  * The threshold is expanded state by state as by itkAdaptiveThresholdIterator, the voxels connected at
+  * one state are grown in parallel by a WavefrontRegionGrower.
+  *
   * \ingroup RegionGrowingSegmentation
   */
   template <class TInputImage, class TOutputImage>
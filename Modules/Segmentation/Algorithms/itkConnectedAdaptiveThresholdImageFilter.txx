@@ -17,11 +17,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 #ifndef _itkConnectedAdaptiveThresholdImageFilter_txx
 #define _itkConnectedAdaptiveThresholdImageFilter_txx
 
-#include "itkAdaptiveThresholdIterator.h"
-#include "itkBinaryThresholdImageFunction.h"
 #include "itkConnectedAdaptiveThresholdImageFilter.h"
+#include "itkImageRegionIterator.h"
 #include "itkMinimumMaximumImageFilter.h"
 #include "itkThresholdImageFilter.h"
+#include "itkWavefrontRegionGrower.h"
+#include "mitkLogMacros.h"
+#include "mitkProgressBar.h"
+#include "mitkVector.h"
+
+#include <algorithm>
+#include <vector>
 
 namespace itk
 {
@@ -55,10 +61,9 @@ namespace itk
     // kommt drauf, wie wir hier die Pipeline aufbauen
     this->SetLower(lowerThreshold->Get());
     this->SetUpper(upperThreshold->Get());
-    typedef BinaryThresholdImageFunction<InputImageType> FunctionType;
-    typedef AdaptiveThresholdIterator<OutputImageType, FunctionType> IteratorType;
 
-    int initValue = IteratorType::CalculateInitializeValue((int)(this->GetLower()), (int)(this->GetUpper()));
+    const int minTH = (int)(this->GetLower());
+    const int maxTH = (int)(this->GetUpper());
 
     // Initialize the output according to the segmentation (fine or raw)
     if (m_FineDetectionMode)
@@ -71,23 +76,20 @@ namespace itk
     outputImage->Allocate();
     if (!m_FineDetectionMode)
     { // only initalize the output image if we are using the raw segmentation mode
-      outputImage->FillBuffer((typename ConnectedAdaptiveThresholdImageFilter::OutputImagePixelType)initValue);
+      outputImage->FillBuffer((typename ConnectedAdaptiveThresholdImageFilter::OutputImagePixelType)0);
     }
 
-    typename FunctionType::Pointer function = FunctionType::New();
-    function->SetInputImage(inputImage);
-
     typename Superclass::SeedContainerType seeds;
     seeds = this->GetSeeds();
+    if (seeds.empty() || !region.IsInside(seeds[0]) || inputImage->GetBufferedRegion() != region)
+    {
+      this->m_SegmentationCancelled = true;
+      return;
+    }
 
-    // pass parameters needed for region growing to iterator
-    IteratorType it(outputImage, function, seeds);
-    it.SetFineDetectionMode(m_FineDetectionMode);
-    it.SetExpansionDirection(m_GrowingDirectionIsUpwards);
-    it.SetMinTH((int)(this->GetLower()));
-    it.SetMaxTH((int)(this->GetUpper()));
-    it.GoToBegin();
-    this->m_SeedpointValue = it.GetSeedPointValue();
+    const IndexType seedIndex = seeds[0];
+    this->m_SeedpointValue = inputImage->GetPixel(seedIndex);
+    const int seedValue = (int)(this->m_SeedpointValue);
 
     if ((this->GetLower()) > this->m_SeedpointValue || this->m_SeedpointValue > (this->GetUpper()))
     {
@@ -97,14 +99,128 @@ namespace itk
       return;
     }
 
-    // iterate through image until
-    while (!it.IsAtEnd())
+    this->m_DetectedLeakagePoint = 0;
+    this->m_SegmentationCancelled = false;
+
+    if (seedValue <= minTH || seedValue >= maxTH)
     {
-      // make iterator go one step further (calls method DoFloodStep())
-      ++it;
+      return;
+    }
+
+    // Every voxel is labeled with the growing state (i.e. threshold expansion) at which it is connected to the
+    // seed, as initializeValue - state. Voxels outside of the current threshold are labeled with their distance to
+    // the seed value and wait for the state of that distance. The voxels of one state are grown in parallel.
+    const int initializeValue = (m_GrowingDirectionIsUpwards ? maxTH - seedValue : seedValue - minTH) + 1;
+
+    typedef WavefrontRegionGrower<TInputImage::ImageDimension> GrowerType;
+    GrowerType grower;
+    grower.SetNumberOfThreads(this->GetNumberOfThreads());
+    grower.Initialize(region);
+
+    const PixelType *input = inputImage->GetBufferPointer();
+    typename OutputImageType::PixelType *output = outputImage->GetBufferPointer();
+
+    // voxels of a previous fine segmentation are not processed again
+    if (m_FineDetectionMode)
+    {
+      const SizeValueType numberOfVoxels = region.GetNumberOfPixels();
+      for (SizeValueType offset = 0; offset < numberOfVoxels; ++offset)
+      {
+        if (output[offset] != 0)
+          grower.Claim(offset);
+      }
+    }
+
+    // waiting voxels per thread and state
+    std::vector<std::vector<typename GrowerType::OffsetListType>> waitingVoxels(
+      std::max(1u, grower.GetNumberOfThreads()),
+      std::vector<typename GrowerType::OffsetListType>(initializeValue + 1));
+
+    int state = 1;
+    int lower = m_GrowingDirectionIsUpwards ? minTH : seedValue;
+    int upper = m_GrowingDirectionIsUpwards ? seedValue : maxTH;
+
+    auto visitor = [&](typename GrowerType::OffsetType offset, unsigned int threadId) {
+      const int value = (int)input[offset];
+      if (lower <= value && value <= upper)
+      {
+        output[offset] = initializeValue - state;
+        return true;
+      }
+
+      if (value > maxTH || value < minTH)
+        return false;
+
+      const int distance = m_GrowingDirectionIsUpwards ? value - seedValue : seedValue - value;
+      output[offset] = initializeValue - distance;
+      if (distance == state)
+        return true;
+      if (distance > state && distance < initializeValue)
+        waitingVoxels[threadId][distance].push_back(offset);
+      return false;
+    };
+
+    typename GrowerType::OffsetListType wavefront;
+    const auto seedOffset = grower.ComputeOffset(seedIndex);
+    grower.Claim(seedOffset);
+    output[seedOffset] = initializeValue - state;
+    wavefront.push_back(seedOffset);
+
+    if (!m_FineDetectionMode)
+      mitk::ProgressBar::GetInstance()->AddStepsToDo(initializeValue - 1);
+
+    // leakage detection
+    const int criticalValue = 2000; // calculate a bit more "intelligent"
+    SizeValueType lastVoxelNumber = 0;
+    SizeValueType currentLeakageRatio = 0;
+    bool detectionStop = false;
+
+    while (state < initializeValue && !detectionStop)
+    {
+      for (auto &waitingVoxelsOfThread : waitingVoxels)
+      {
+        auto &waitingVoxelsOfState = waitingVoxelsOfThread[state];
+        wavefront.insert(wavefront.end(), waitingVoxelsOfState.begin(), waitingVoxelsOfState.end());
+        typename GrowerType::OffsetListType().swap(waitingVoxelsOfState);
+      }
+
+      const SizeValueType voxelCounter = wavefront.size() + grower.Grow(wavefront, visitor);
+
+      if (!m_FineDetectionMode)
+      {
+        // make the progressbar go one step further
+        mitk::ProgressBar::GetInstance()->Progress();
+
+        if (voxelCounter > lastVoxelNumber && voxelCounter - lastVoxelNumber > currentLeakageRatio)
+        {
+          currentLeakageRatio = voxelCounter - lastVoxelNumber;
+          this->m_DetectedLeakagePoint = state;
+        }
+      }
+      else // fine leakage detection
+      {
+        // counting voxels over interations; if above a critical value (to be extended) then set this to leakage
+        if ((long long)voxelCounter - (long long)lastVoxelNumber <= criticalValue)
+        {
+          // this state does not leak, so the leakage can start at the next state at the earliest; like in the coarse
+          // detection the leakage point is the state at which the leakage happens, and the last state before it is
+          // what the tool offers as threshold (seed value + leakage point - 1)
+          this->m_DetectedLeakagePoint = state + 1;
+        }
+        else
+        {
+          detectionStop = true;
+        }
+      }
+      lastVoxelNumber = voxelCounter;
+
+      // expand the threshold for the next state
+      ++state;
+      if (m_GrowingDirectionIsUpwards)
+        ++upper;
+      else
+        --lower;
     }
-    this->m_DetectedLeakagePoint = it.GetLeakagePoint();
-    this->m_SegmentationCancelled = false;
   }
 
   template <class TInputImage, class TOutputImage>
@@ -0,0 +1,123 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+#ifndef __itkParallelConnectedThresholdImageFilter_h
+#define __itkParallelConnectedThresholdImageFilter_h
+
+#include "itkConnectedThresholdImageFilter.h"
+#include "itkImage.h"
+#include "itkWavefrontRegionGrower.h"
+
+namespace itk
+{
+  /** \class ParallelConnectedThresholdImageFilter
+  * \brief Multi-threaded replacement for ConnectedThresholdImageFilter with a voxel limit and incremental updates.
+  *
+  * The region is grown by a WavefrontRegionGrower and equals the result of ConnectedThresholdImageFilter
+  * for the same seeds, thresholds and connectivity.
+  *
+  * If MaximumNumberOfVoxels is set, growing stops as soon as the region has reached this size, e.g. when a
+  * preview leaks into the surrounding tissue. GetMaximumNumberOfVoxelsReached() tells whether the result is
+  * incomplete.
+  *
+  * With IncrementalUpdate on, an update that only widens the threshold interval continues from the previous
+  * result instead of growing the whole region again. Only the voxels that were rejected at the border of the
+  * previous region are tested again. For this, the output reuses the pixel buffer of the previous update and
+  * must not be modified by consumers. The input is identified by its pixel buffer, call
+  * ResetIncrementalUpdate() if its pixel values change in place.
+  *
+  * \ingroup RegionGrowingSegmentation
+  */
+  template <class TInputImage, class TOutputImage>
+  class ITK_EXPORT ParallelConnectedThresholdImageFilter
+    : public ConnectedThresholdImageFilter<TInputImage, TOutputImage>
+  {
+  public:
+    /** Standard class typedefs. */
+    typedef ParallelConnectedThresholdImageFilter Self;
+    typedef ConnectedThresholdImageFilter<TInputImage, TOutputImage> Superclass;
+    typedef SmartPointer<Self> Pointer;
+    typedef SmartPointer<const Self> ConstPointer;
+
+    /** Method for creation through the object factory. */
+    itkFactorylessNewMacro(Self) itkCloneMacro(Self)
+
+      /** Run-time type information (and related methods).  */
+      itkTypeMacro(ParallelConnectedThresholdImageFilter, ConnectedThresholdImageFilter);
+
+    typedef TInputImage InputImageType;
+    typedef TOutputImage OutputImageType;
+    typedef typename InputImageType::PixelType InputPixelType;
+    typedef typename OutputImageType::PixelType OutputPixelType;
+    typedef typename OutputImageType::PixelContainerPointer OutputPixelContainerPointer;
+    typedef typename InputImageType::IndexType IndexType;
+    typedef WavefrontRegionGrower<TInputImage::ImageDimension> GrowerType;
+
+    /** Maximum number of voxels of the region, 0 (default) for no limit. */
+    itkSetMacro(MaximumNumberOfVoxels, SizeValueType);
+    itkGetConstMacro(MaximumNumberOfVoxels, SizeValueType);
+
+    /** Whether the last update stopped at MaximumNumberOfVoxels. */
+    itkGetConstMacro(MaximumNumberOfVoxelsReached, bool);
+
+    /** Number of voxels in the region of the last update. */
+    itkGetConstMacro(NumberOfVoxels, SizeValueType);
+
+    /** Continue from the previous result if only the threshold interval was widened (default off). */
+    itkSetMacro(IncrementalUpdate, bool);
+    itkGetConstMacro(IncrementalUpdate, bool);
+    itkBooleanMacro(IncrementalUpdate);
+
+    /** Forgets the previous result, so that the next update grows the whole region. */
+    void ResetIncrementalUpdate();
+
+  protected:
+    ParallelConnectedThresholdImageFilter();
+    ~ParallelConnectedThresholdImageFilter() override{};
+
+    void GenerateData() override;
+
+  private:
+    /** Whether the previous result can be continued with the current parameters. */
+    bool CanContinuePreviousResult(const InputImageType *input,
+                                   InputPixelType lower,
+                                   InputPixelType upper,
+                                   bool fullyConnected) const;
+
+    SizeValueType m_MaximumNumberOfVoxels;
+    bool m_MaximumNumberOfVoxelsReached;
+    SizeValueType m_NumberOfVoxels;
+    bool m_IncrementalUpdate;
+
+    // state of the previous update for incremental updates
+    GrowerType m_Grower;
+    typename GrowerType::OffsetListType m_RejectedVoxels;
+    OutputPixelContainerPointer m_PreviousResult;
+    const InputPixelType *m_PreviousInputBuffer;
+    typename InputImageType::RegionType m_PreviousRegion;
+    std::vector<IndexType> m_PreviousSeeds;
+    InputPixelType m_PreviousLower;
+    InputPixelType m_PreviousUpper;
+    OutputPixelType m_PreviousReplaceValue;
+    bool m_PreviousFullyConnected;
+  };
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkParallelConnectedThresholdImageFilter.txx"
+#endif
+
+#endif
@@ -0,0 +1,196 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef _itkParallelConnectedThresholdImageFilter_txx
+#define _itkParallelConnectedThresholdImageFilter_txx
+
+#include "itkParallelConnectedThresholdImageFilter.h"
+
+#include <algorithm>
+
+namespace itk
+{
+  /**
+  * Constructor
+  */
+  template <class TInputImage, class TOutputImage>
+  ParallelConnectedThresholdImageFilter<TInputImage, TOutputImage>::ParallelConnectedThresholdImageFilter()
+    : m_MaximumNumberOfVoxels(0),
+      m_MaximumNumberOfVoxelsReached(false),
+      m_NumberOfVoxels(0),
+      m_IncrementalUpdate(false),
+      m_PreviousInputBuffer(nullptr),
+      m_PreviousLower(0),
+      m_PreviousUpper(0),
+      m_PreviousReplaceValue(0),
+      m_PreviousFullyConnected(false)
+  {
+  }
+
+  template <class TInputImage, class TOutputImage>
+  void ParallelConnectedThresholdImageFilter<TInputImage, TOutputImage>::ResetIncrementalUpdate()
+  {
+    m_PreviousResult = nullptr;
+    m_PreviousInputBuffer = nullptr;
+    m_RejectedVoxels.clear();
+    this->Modified();
+  }
+
+  template <class TInputImage, class TOutputImage>
+  bool ParallelConnectedThresholdImageFilter<TInputImage, TOutputImage>::CanContinuePreviousResult(
+    const InputImageType *input, InputPixelType lower, InputPixelType upper, bool fullyConnected) const
+  {
+    // a result that stopped at the voxel limit has unexpanded voxels besides the rejected ones
+    return m_IncrementalUpdate && m_PreviousResult.IsNotNull() && !m_MaximumNumberOfVoxelsReached &&
+           m_PreviousInputBuffer == input->GetBufferPointer() && m_PreviousRegion == input->GetBufferedRegion() &&
+           m_PreviousSeeds == this->GetSeeds() && m_PreviousReplaceValue == this->GetReplaceValue() &&
+           m_PreviousFullyConnected == fullyConnected && lower <= m_PreviousLower && upper >= m_PreviousUpper;
+  }
+
+  template <class TInputImage, class TOutputImage>
+  void ParallelConnectedThresholdImageFilter<TInputImage, TOutputImage>::GenerateData()
+  {
+    const InputImageType *inputImage = this->GetInput();
+    OutputImageType *outputImage = this->GetOutput();
+
+    const InputPixelType lower = this->GetLowerInput()->Get();
+    const InputPixelType upper = this->GetUpperInput()->Get();
+    const OutputPixelType replaceValue = this->GetReplaceValue();
+    const bool fullyConnected = this->GetConnectivity() == Superclass::FullConnectivity;
+
+    const typename InputImageType::RegionType region = inputImage->GetBufferedRegion();
+    if (region != outputImage->GetRequestedRegion())
+    {
+      itkExceptionMacro(<< "Buffered region of the input does not match the requested region of the output.");
+    }
+
+    outputImage->SetBufferedRegion(region);
+
+    typename GrowerType::OffsetListType wavefront;
+
+    if (this->CanContinuePreviousResult(inputImage, lower, upper, fullyConnected))
+    {
+      outputImage->SetPixelContainer(m_PreviousResult);
+      OutputPixelType *output = outputImage->GetBufferPointer();
+      const InputPixelType *input = inputImage->GetBufferPointer();
+
+      // rejected voxels inside the widened interval continue the growing, the others stay rejected
+      auto rejectedEnd = m_RejectedVoxels.begin();
+      for (const auto offset : m_RejectedVoxels)
+      {
+        if (lower <= input[offset] && input[offset] <= upper)
+        {
+          output[offset] = replaceValue;
+          wavefront.push_back(offset);
+        }
+        else
+        {
+          *rejectedEnd++ = offset;
+        }
+      }
+      m_RejectedVoxels.erase(rejectedEnd, m_RejectedVoxels.end());
+      m_NumberOfVoxels += wavefront.size();
+    }
+    else
+    {
+      outputImage->Allocate();
+      outputImage->FillBuffer(NumericTraits<OutputPixelType>::ZeroValue());
+      OutputPixelType *output = outputImage->GetBufferPointer();
+      const InputPixelType *input = inputImage->GetBufferPointer();
+
+      m_Grower.SetFullyConnected(fullyConnected);
+      m_Grower.Initialize(region);
+      m_RejectedVoxels.clear();
+      m_NumberOfVoxels = 0;
+
+      for (const auto &seed : this->GetSeeds())
+      {
+        if (!region.IsInside(seed))
+          continue;
+
+        const auto offset = m_Grower.ComputeOffset(seed);
+        if (!m_Grower.Claim(offset))
+          continue;
+
+        if (lower <= input[offset] && input[offset] <= upper)
+        {
+          output[offset] = replaceValue;
+          wavefront.push_back(offset);
+        }
+        else
+        {
+          m_RejectedVoxels.push_back(offset);
+        }
+      }
+      m_NumberOfVoxels = wavefront.size();
+    }
+
+    m_Grower.SetNumberOfThreads(this->GetNumberOfThreads());
+
+    OutputPixelType *output = outputImage->GetBufferPointer();
+    const InputPixelType *input = inputImage->GetBufferPointer();
+
+    // rejected voxels are only needed to continue the growing in the next update
+    std::vector<typename GrowerType::OffsetListType> rejectedVoxels(
+      m_IncrementalUpdate ? std::max(1u, m_Grower.GetNumberOfThreads()) : 0);
+    auto visitor = [&](typename GrowerType::OffsetType offset, unsigned int threadId) {
+      if (lower <= input[offset] && input[offset] <= upper)
+      {
+        output[offset] = replaceValue;
+        return true;
+      }
+      if (!rejectedVoxels.empty())
+        rejectedVoxels[threadId].push_back(offset);
+      return false;
+    };
+
+    if (m_MaximumNumberOfVoxels > 0 && m_NumberOfVoxels >= m_MaximumNumberOfVoxels)
+    {
+      m_MaximumNumberOfVoxelsReached = !wavefront.empty();
+    }
+    else
+    {
+      m_NumberOfVoxels += m_Grower.Grow(
+        wavefront, visitor, m_MaximumNumberOfVoxels > 0 ? m_MaximumNumberOfVoxels - m_NumberOfVoxels : 0);
+      m_MaximumNumberOfVoxelsReached = !wavefront.empty();
+    }
+
+    for (const auto &rejected : rejectedVoxels)
+    {
+      m_RejectedVoxels.insert(m_RejectedVoxels.end(), rejected.begin(), rejected.end());
+    }
+
+    if (m_IncrementalUpdate)
+    {
+      m_PreviousResult = outputImage->GetPixelContainer();
+      m_PreviousInputBuffer = inputImage->GetBufferPointer();
+      m_PreviousRegion = region;
+      m_PreviousSeeds = this->GetSeeds();
+      m_PreviousLower = lower;
+      m_PreviousUpper = upper;
+      m_PreviousReplaceValue = replaceValue;
+      m_PreviousFullyConnected = fullyConnected;
+    }
+    else
+    {
+      m_PreviousResult = nullptr;
+      m_RejectedVoxels.clear();
+    }
+  }
+
+} // end namespace itk
+
+#endif
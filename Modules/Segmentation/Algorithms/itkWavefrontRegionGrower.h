@@ -0,0 +1,99 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+#ifndef __itkWavefrontRegionGrower_h
+#define __itkWavefrontRegionGrower_h
+
+#include "itkImageRegion.h"
+#include "itkIndex.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace itk
+{
+  /** \class WavefrontRegionGrower
+  * \brief Multi-threaded flood fill over the voxels of an image region.
+  *
+  * The region is grown wavefront by wavefront: all voxels of the current wavefront are expanded in parallel,
+  * the included neighbors form the next wavefront. Every voxel of the region is claimed exactly once in a
+  * bitset, so each neighbor is handed to the visitor by exactly one thread and the visitor may write to the
+  * voxel without further synchronization.
+  *
+  * Voxels are addressed by their linear offset in the region, which is the offset into the pixel buffer of
+  * an image with this buffered region.
+  *
+  * \ingroup RegionGrowingSegmentation
+  */
+  template <unsigned int VDimension>
+  class WavefrontRegionGrower
+  {
+  public:
+    typedef ImageRegion<VDimension> RegionType;
+    typedef Index<VDimension> IndexType;
+    typedef SizeValueType OffsetType;
+    typedef std::vector<OffsetType> OffsetListType;
+
+    WavefrontRegionGrower();
+
+    /** Sets the region, which is grown, and releases all claimed voxels. */
+    void Initialize(const RegionType &region);
+
+    const RegionType &GetRegion() const { return m_Region; }
+    /** Number of threads used for large wavefronts, small wavefronts are expanded by the calling thread. */
+    void SetNumberOfThreads(unsigned int numberOfThreads) { m_NumberOfThreads = numberOfThreads; }
+    unsigned int GetNumberOfThreads() const { return m_NumberOfThreads; }
+    /** Face connectivity (default) or full connectivity, takes effect on the next Initialize(). */
+    void SetFullyConnected(bool fullyConnected) { m_FullyConnected = fullyConnected; }
+    bool GetFullyConnected() const { return m_FullyConnected; }
+    OffsetType ComputeOffset(const IndexType &index) const;
+
+    /** Marks the voxel as visited. Returns false, if it has already been claimed before. Thread-safe. */
+    bool Claim(OffsetType offset);
+
+    bool IsClaimed(OffsetType offset) const;
+
+    /** Expands the wavefront until it is empty or maximumNumberOfVoxels voxels have been included (0: no
+    * limit). visitor(offset, threadId) is called once for every neighbor that has not been claimed before,
+    * with threadId < GetNumberOfThreads(), and returns whether the voxel is included in the region and thus
+    * becomes part of the next wavefront. The visitor must not throw.
+    *
+    * Returns the number of included voxels. If the growing stopped at the limit, the voxels that have not
+    * been expanded yet are left in wavefront, otherwise it is empty.
+    */
+    template <typename TVisitor>
+    SizeValueType Grow(OffsetListType &wavefront, TVisitor &visitor, SizeValueType maximumNumberOfVoxels = 0);
+
+  private:
+    template <typename TVisitor>
+    SizeValueType ExpandVoxel(OffsetType offset, TVisitor &visitor, unsigned int threadId, OffsetListType &next);
+
+    RegionType m_Region;
+    OffsetValueType m_OffsetTable[VDimension + 1];
+    std::vector<Offset<VDimension>> m_NeighborOffsets;
+    std::vector<OffsetValueType> m_NeighborLinearOffsets;
+    std::vector<std::atomic<std::uint64_t>> m_Claimed;
+    unsigned int m_NumberOfThreads;
+    bool m_FullyConnected;
+  };
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkWavefrontRegionGrower.txx"
+#endif
+
+#endif
@@ -0,0 +1,228 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef _itkWavefrontRegionGrower_txx
+#define _itkWavefrontRegionGrower_txx
+
+#include "itkWavefrontRegionGrower.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace itk
+{
+  namespace WavefrontRegionGrowerDetail
+  {
+    /** Wavefronts with less voxels per thread are expanded by fewer threads */
+    const std::size_t MinimumVoxelsPerThread = 4096;
+
+    /** Number of wavefront voxels a thread takes at a time */
+    const std::size_t ChunkSize = 256;
+  }
+
+  template <unsigned int VDimension>
+  WavefrontRegionGrower<VDimension>::WavefrontRegionGrower()
+    : m_NumberOfThreads(std::max(1u, std::thread::hardware_concurrency())), m_FullyConnected(false)
+  {
+    std::fill_n(m_OffsetTable, VDimension + 1, 0);
+  }
+
+  template <unsigned int VDimension>
+  void WavefrontRegionGrower<VDimension>::Initialize(const RegionType &region)
+  {
+    m_Region = region;
+
+    m_OffsetTable[0] = 1;
+    for (unsigned int i = 0; i < VDimension; ++i)
+    {
+      m_OffsetTable[i + 1] = m_OffsetTable[i] * static_cast<OffsetValueType>(region.GetSize(i));
+    }
+
+    // face connectivity: the 2 * VDimension direct neighbors, full connectivity: all 3^VDimension - 1 neighbors
+    m_NeighborOffsets.clear();
+    m_NeighborLinearOffsets.clear();
+    Offset<VDimension> neighborOffset;
+    neighborOffset.Fill(-1);
+    while (true)
+    {
+      unsigned int numberOfNonZeros = 0;
+      OffsetValueType linearOffset = 0;
+      for (unsigned int i = 0; i < VDimension; ++i)
+      {
+        if (neighborOffset[i] != 0)
+          ++numberOfNonZeros;
+        linearOffset += neighborOffset[i] * m_OffsetTable[i];
+      }
+
+      if (numberOfNonZeros > 0 && (m_FullyConnected || numberOfNonZeros == 1))
+      {
+        m_NeighborOffsets.push_back(neighborOffset);
+        m_NeighborLinearOffsets.push_back(linearOffset);
+      }
+
+      unsigned int dimension = 0;
+      while (dimension < VDimension && neighborOffset[dimension] == 1)
+      {
+        neighborOffset[dimension] = -1;
+        ++dimension;
+      }
+      if (dimension == VDimension)
+        break;
+      ++neighborOffset[dimension];
+    }
+
+    const std::size_t numberOfWords = (static_cast<std::size_t>(m_OffsetTable[VDimension]) + 63) / 64;
+    std::vector<std::atomic<std::uint64_t>> claimed(numberOfWords);
+    for (auto &word : claimed)
+    {
+      word.store(0, std::memory_order_relaxed);
+    }
+    m_Claimed.swap(claimed);
+  }
+
+  template <unsigned int VDimension>
+  typename WavefrontRegionGrower<VDimension>::OffsetType WavefrontRegionGrower<VDimension>::ComputeOffset(
+    const IndexType &index) const
+  {
+    OffsetValueType offset = 0;
+    for (unsigned int i = 0; i < VDimension; ++i)
+    {
+      offset += (index[i] - m_Region.GetIndex(i)) * m_OffsetTable[i];
+    }
+    return static_cast<OffsetType>(offset);
+  }
+
+  template <unsigned int VDimension>
+  bool WavefrontRegionGrower<VDimension>::Claim(OffsetType offset)
+  {
+    const std::uint64_t bit = std::uint64_t(1) << (offset & 63);
+    return (m_Claimed[offset >> 6].fetch_or(bit, std::memory_order_relaxed) & bit) == 0;
+  }
+
+  template <unsigned int VDimension>
+  bool WavefrontRegionGrower<VDimension>::IsClaimed(OffsetType offset) const
+  {
+    const std::uint64_t bit = std::uint64_t(1) << (offset & 63);
+    return (m_Claimed[offset >> 6].load(std::memory_order_relaxed) & bit) != 0;
+  }
+
+  template <unsigned int VDimension>
+  template <typename TVisitor>
+  SizeValueType WavefrontRegionGrower<VDimension>::ExpandVoxel(OffsetType offset,
+                                                               TVisitor &visitor,
+                                                               unsigned int threadId,
+                                                               OffsetListType &next)
+  {
+    // index of the voxel relative to the region
+    OffsetValueType index[VDimension];
+    OffsetValueType remainder = static_cast<OffsetValueType>(offset);
+    for (unsigned int i = VDimension; i > 0; --i)
+    {
+      index[i - 1] = remainder / m_OffsetTable[i - 1];
+      remainder -= index[i - 1] * m_OffsetTable[i - 1];
+    }
+
+    SizeValueType numberOfIncludedVoxels = 0;
+    for (std::size_t n = 0; n < m_NeighborOffsets.size(); ++n)
+    {
+      bool isInside = true;
+      for (unsigned int i = 0; i < VDimension && isInside; ++i)
+      {
+        const OffsetValueType neighborIndex = index[i] + m_NeighborOffsets[n][i];
+        isInside = neighborIndex >= 0 && neighborIndex < static_cast<OffsetValueType>(m_Region.GetSize(i));
+      }
+      if (!isInside)
+        continue;
+
+      const auto neighbor = static_cast<OffsetType>(static_cast<OffsetValueType>(offset) + m_NeighborLinearOffsets[n]);
+      if (this->Claim(neighbor) && visitor(neighbor, threadId))
+      {
+        next.push_back(neighbor);
+        ++numberOfIncludedVoxels;
+      }
+    }
+    return numberOfIncludedVoxels;
+  }
+
+  template <unsigned int VDimension>
+  template <typename TVisitor>
+  SizeValueType WavefrontRegionGrower<VDimension>::Grow(OffsetListType &wavefront,
+                                                        TVisitor &visitor,
+                                                        SizeValueType maximumNumberOfVoxels)
+  {
+    using WavefrontRegionGrowerDetail::ChunkSize;
+    using WavefrontRegionGrowerDetail::MinimumVoxelsPerThread;
+
+    const unsigned int numberOfThreads = std::max(1u, m_NumberOfThreads);
+    std::vector<OffsetListType> nextWavefronts(numberOfThreads);
+    std::atomic<SizeValueType> numberOfIncludedVoxels(0);
+
+    auto isLimitReached = [&]() {
+      return maximumNumberOfVoxels > 0 && numberOfIncludedVoxels.load() >= maximumNumberOfVoxels;
+    };
+
+    while (!wavefront.empty() && !isLimitReached())
+    {
+      std::atomic<std::size_t> nextChunk(0);
+
+      auto worker = [&](unsigned int threadId) {
+        OffsetListType &next = nextWavefronts[threadId];
+        while (!isLimitReached())
+        {
+          const std::size_t begin = nextChunk.fetch_add(ChunkSize);
+          if (begin >= wavefront.size())
+            break;
+
+          const std::size_t end = std::min(begin + ChunkSize, wavefront.size());
+          SizeValueType includedInChunk = 0;
+          for (std::size_t i = begin; i < end; ++i)
+          {
+            includedInChunk += this->ExpandVoxel(wavefront[i], visitor, threadId, next);
+          }
+          numberOfIncludedVoxels += includedInChunk;
+        }
+      };
+
+      const auto threadCount = static_cast<unsigned int>(
+        std::min<std::size_t>(numberOfThreads, std::max<std::size_t>(1, wavefront.size() / MinimumVoxelsPerThread)));
+
+      std::vector<std::thread> threads;
+      for (unsigned int threadId = 1; threadId < threadCount; ++threadId)
+      {
+        threads.emplace_back(worker, threadId);
+      }
+      worker(0);
+      for (auto &thread : threads)
+      {
+        thread.join();
+      }
+
+      // voxels of the wavefront that have not been expanded because of the limit stay in front of the next ones
+      const std::size_t numberOfExpandedVoxels = std::min(nextChunk.load(), wavefront.size());
+      wavefront.erase(wavefront.begin(), wavefront.begin() + numberOfExpandedVoxels);
+      for (auto &next : nextWavefronts)
+      {
+        wavefront.insert(wavefront.end(), next.begin(), next.end());
+        next.clear();
+      }
+    }
+
+    return numberOfIncludedVoxels;
+  }
+
+} // end namespace itk
+
+#endif
@@ -16,6 +16,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkDiffSliceOperation.h"
 
+#include <mitkExtractSliceFilter.h>
 #include <mitkImage.h>
 
 #include <itkCommand.h>
@@ -24,6 +25,7 @@ mitk::DiffSliceOperation::DiffSliceOperation() : Operation(1)
 {
   m_TimeStep = 0;
   m_zlibSliceContainer = nullptr;
+  m_SliceDiff = nullptr;
   m_Image = nullptr;
   m_WorldGeometry = nullptr;
   m_SliceGeometry = nullptr;
@@ -55,6 +57,32 @@ mitk::DiffSliceOperation::DiffSliceOperation(mitk::Image *imageVolume,
   m_zlibSliceContainer = CompressedImageContainer::New();
   m_zlibSliceContainer->SetImage(slice);
 
+  this->ObserveImage(imageVolume);
+}
+
+mitk::DiffSliceOperation::DiffSliceOperation(mitk::Image *imageVolume,
+                                             SparseSliceDiff *sliceDiff,
+                                             unsigned int timestep,
+                                             BaseGeometry *currentWorldGeometry)
+  : Operation(1)
+{
+  m_WorldGeometry = currentWorldGeometry->Clone();
+
+  // see above, bug 12338
+  m_GuardReferenceGeometry = dynamic_cast<mitk::PlaneGeometry *>(m_WorldGeometry.GetPointer())->GetReferenceGeometry();
+
+  m_SliceGeometry = nullptr;
+
+  m_TimeStep = timestep;
+
+  m_zlibSliceContainer = nullptr;
+  m_SliceDiff = sliceDiff;
+
+  this->ObserveImage(imageVolume);
+}
+
+void mitk::DiffSliceOperation::ObserveImage(mitk::Image *imageVolume)
+{
   m_Image = imageVolume;
   m_DeleteObserverTag = 0;
 
@@ -77,6 +105,7 @@ mitk::DiffSliceOperation::~DiffSliceOperation()
 {
   m_WorldGeometry = nullptr;
   m_zlibSliceContainer = nullptr;
+  m_SliceDiff = nullptr;
 
   if (m_ImageIsValid)
   {
@@ -86,15 +115,65 @@ mitk::DiffSliceOperation::~DiffSliceOperation()
   m_Image = nullptr;
 }
 
+mitk::Image::Pointer mitk::DiffSliceOperation::ExtractCurrentSlice()
+{
+  mitk::ExtractSliceFilter::Pointer extractor = mitk::ExtractSliceFilter::New();
+  extractor->SetInput(m_Image);
+  extractor->SetTimeStep(m_TimeStep);
+  extractor->SetWorldGeometry(dynamic_cast<PlaneGeometry *>(m_WorldGeometry.GetPointer()));
+  extractor->SetResliceTransformByGeometry(m_Image->GetGeometry(m_TimeStep));
+  extractor->Update();
+
+  Image::Pointer slice = extractor->GetOutput();
+  slice->DisconnectPipeline();
+  return slice;
+}
+
+mitk::Image::Pointer mitk::DiffSliceOperation::GetSlice(const Image *currentSlice)
+{
+  if (m_SliceDiff.IsNull())
+  {
+    Image::Pointer image = m_zlibSliceContainer->GetImage();
+    return image;
+  }
+
+  if (nullptr == currentSlice)
+    return nullptr;
+
+  // the voxels that are not part of the diff are taken from the current slice, which the caller may still need
+  Image::Pointer slice = currentSlice->Clone();
+  if (!m_SliceDiff->Apply(slice))
+    return nullptr;
+
+  return slice;
+}
+
 mitk::Image::Pointer mitk::DiffSliceOperation::GetSlice()
 {
-  Image::Pointer image = m_zlibSliceContainer->GetImage();
-  return image;
+  if (m_SliceDiff.IsNull())
+    return this->GetSlice(nullptr);
+
+  Image::Pointer currentSlice = this->ExtractCurrentSlice();
+  return this->GetSlice(currentSlice);
 }
 
 bool mitk::DiffSliceOperation::IsValid()
 {
-  return m_ImageIsValid && m_zlibSliceContainer.IsNotNull() && (m_WorldGeometry.IsNotNull()); // TODO improve
+  return m_ImageIsValid && (m_zlibSliceContainer.IsNotNull() || m_SliceDiff.IsNotNull()) &&
+         (m_WorldGeometry.IsNotNull()); // TODO improve
+}
+
+std::size_t mitk::DiffSliceOperation::GetMemorySize() const
+{
+  std::size_t memorySize = sizeof(DiffSliceOperation);
+
+  if (m_zlibSliceContainer.IsNotNull())
+    memorySize += m_zlibSliceContainer->GetMemorySize();
+
+  if (m_SliceDiff.IsNotNull())
+    memorySize += m_SliceDiff->GetMemorySize();
+
+  return memorySize;
 }
 
 void mitk::DiffSliceOperation::OnImageDeleted()
@@ -18,6 +18,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #define mitkDiffSliceOperation_h_Included
 
 #include "mitkCompressedImageContainer.h"
+#include "mitkSparseSliceDiff.h"
 #include <MitkSegmentationExports.h>
 #include <mitkOperation.h>
 
@@ -37,6 +38,10 @@ namespace mitk
      timestep               the timestep in an 4D image.
      currentWorldGeometry   specifies the axis where the slice has to be applied in the volume.
 
+    Instead of the whole slice, the operation can hold a SparseSliceDiff with only the voxels to be written.
+    GetSlice() then extracts the current slice from the volume and applies the diff to it. Segmentation tools
+    use this for undo-redo, because a brush stroke usually changes few voxels of a slice.
+
     This Operation can be used to realize undo-redo functionality for e.g. segmentation purposes.
   */
   class MITKSEGMENTATION_EXPORT DiffSliceOperation : public Operation
@@ -61,6 +66,12 @@ namespace mitk
                        unsigned int timestep,
                        BaseGeometry *currentWorldGeometry);
 
+    /** \brief Creates an operation that only writes the voxels of sliceDiff into the slice of the volume.*/
+    DiffSliceOperation(mitk::Image *imageVolume,
+                       SparseSliceDiff *sliceDiff,
+                       unsigned int timestep,
+                       BaseGeometry *currentWorldGeometry);
+
     /** \brief Check if it is a valid operation.*/
     bool IsValid();
 
@@ -70,9 +81,29 @@ namespace mitk
     mitk::Image *GetImage() { return this->m_Image; }
     /** \brief Set thee slice to be applied.*/
     void SetImage(vtkImageData *slice) { this->m_Slice = slice; }
-    /** \brief Get the slice that is applied in the operation.*/
+    /** \brief Get the slice that is applied in the operation.
+      For operations holding a SparseSliceDiff, this is the current slice of the volume with the diff applied, or
+      nullptr if the slice does not match the diff anymore. The current slice is extracted from the volume, callers
+      that already extracted it should use GetSlice(const Image *).
+    */
     Image::Pointer GetSlice();
 
+    /** \brief Get the slice that is applied in the operation, based on the already extracted current slice.
+      For operations holding a SparseSliceDiff, the diff is applied to a copy of currentSlice, which must be the slice
+      of the volume as returned by ExtractCurrentSlice(). Returns nullptr if currentSlice is nullptr or does not
+      match the diff. Operations holding the whole slice ignore currentSlice.
+    */
+    Image::Pointer GetSlice(const Image *currentSlice);
+
+    /** \brief Extracts the slice of the volume the operation is applied to, in its current state.*/
+    Image::Pointer ExtractCurrentSlice();
+
+    /** \brief Check if the operation only holds the changed voxels, see GetSlice(const Image *).*/
+    bool HasSliceDiff() const { return m_SliceDiff.IsNotNull(); }
+
+    /** \brief Returns the memory of the stored slice or slice diff.*/
+    std::size_t GetMemorySize() const override;
+
     /** \brief Get timeStep.*/
     void SetTimeStep(unsigned int timestep) { this->m_TimeStep = timestep; }
     /** \brief Set timeStep*/
@@ -91,8 +122,13 @@ namespace mitk
     /** \brief Callback for image observer.*/
     void OnImageDeleted();
 
+    /** \brief Sets the image volume and observes its deletion.*/
+    void ObserveImage(mitk::Image *imageVolume);
+
     CompressedImageContainer::Pointer m_zlibSliceContainer;
 
+    SparseSliceDiff::Pointer m_SliceDiff;
+
     mitk::Image *m_Image;
 
     vtkSmartPointer<vtkImageData> m_Slice;
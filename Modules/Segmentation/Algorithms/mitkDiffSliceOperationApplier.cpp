@@ -20,6 +20,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkRenderingManager.h"
 #include "mitkSegTool2D.h"
 #include <mitkExtractSliceFilter.h>
+#include <mitkLabelSetImage.h>
 #include <mitkVtkImageOverwrite.h>
 
 // VTK
@@ -44,10 +45,23 @@ void mitk::DiffSliceOperationApplier::ExecuteOperation(Operation *operation)
   // chak if the operation is valid
   if (imageOperation->IsValid())
   {
+    // label set images update the statistics of their labels by the voxels of the slice as it is before it is
+    // overwritten, and slice diffs only hold the changed voxels. Both use the same extraction of the current slice.
+    auto *labelSetImage = dynamic_cast<LabelSetImage *>(imageOperation->GetImage());
+    mitk::Image::Pointer previousSlice;
+    if (nullptr != labelSetImage || imageOperation->HasSliceDiff())
+      previousSlice = imageOperation->ExtractCurrentSlice();
+
     // the actual overwrite filter (vtk)
     vtkSmartPointer<mitkVtkImageOverwrite> reslice = vtkSmartPointer<mitkVtkImageOverwrite>::New();
 
-    mitk::Image::Pointer slice = imageOperation->GetSlice();
+    mitk::Image::Pointer slice = imageOperation->GetSlice(previousSlice);
+    if (slice.IsNull())
+    {
+      MITK_WARN << "Slice of the undo or redo operation does not match the image anymore.";
+      return;
+    }
+
     // Set the slice as 'input'
     reslice->SetInputSlice(slice->GetVtkImageData());
 
@@ -68,21 +82,15 @@ void mitk::DiffSliceOperationApplier::ExecuteOperation(Operation *operation)
 
     // make sure the modification is rendered
     RenderingManager::GetInstance()->RequestUpdateAll();
-    imageOperation->GetImage()->Modified();
-
-    mitk::ExtractSliceFilter::Pointer extractor2 = mitk::ExtractSliceFilter::New();
-    extractor2->SetInput(imageOperation->GetImage());
-    extractor2->SetTimeStep(imageOperation->GetTimeStep());
-    extractor2->SetWorldGeometry(dynamic_cast<PlaneGeometry *>(imageOperation->GetWorldGeometry()));
-    extractor2->SetResliceTransformByGeometry(imageOperation->GetImage()->GetGeometry(imageOperation->GetTimeStep()));
-    extractor2->Modified();
-    extractor2->Update();
+    if (nullptr != labelSetImage)
+      labelSetImage->UpdateLabelIndex(previousSlice, imageOperation->GetTimeStep());
+    else
+      imageOperation->GetImage()->Modified();
 
+    // the written slice is what the volume contains at the plane now, so it does not need to be extracted again
     // TODO Move this code to SurfaceInterpolationController!
-    mitk::Image::Pointer slice2 = extractor2->GetOutput();
     mitk::PlaneGeometry::Pointer plane = dynamic_cast<PlaneGeometry *>(imageOperation->GetWorldGeometry());
-    slice2->DisconnectPipeline();
-    mitk::SegTool2D::UpdateSurfaceInterpolation(slice2, imageOperation->GetImage(), plane, true);
+    mitk::SegTool2D::UpdateSurfaceInterpolation(slice, imageOperation->GetImage(), plane, true);
   }
 }
 
@@ -15,6 +15,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include "mitkImageLiveWireContourModelFilter.h"
+#include <algorithm>
 
 #include <itkCastImageFilter.h>
 #include <itkGradientMagnitudeImageFilter.h>
@@ -142,6 +143,16 @@ void mitk::ImageLiveWireContourModelFilter::AddRepulsivePoint(const itk::Index<2
   m_CostFunction->AddRepulsivePoint(idx);
 }
 
+void mitk::ImageLiveWireContourModelFilter::SetCostFeatures(const CostFeaturesPointer &features)
+{
+  m_CostFunction->SetCostFeatures(features);
+}
+
+mitk::ImageLiveWireContourModelFilter::CostFeaturesPointer mitk::ImageLiveWireContourModelFilter::GetCostFeatures() const
+{
+  return m_CostFunction->GetCostFeatures();
+}
+
 void mitk::ImageLiveWireContourModelFilter::DumpMaskImage()
 {
   mitk::Image::Pointer mask = mitk::Image::New();
@@ -205,6 +216,23 @@ void mitk::ImageLiveWireContourModelFilter::UpdateLiveWire()
   // m_ShortestPathFilter->SetInput( m_CostFunction->SetImage(m_InternalImage) );
   m_ShortestPathFilter->SetMakeOutputImage(false);
 
+  // restrict the search to a window around the start point that extends at least twice the distance to the end
+  // point. The window grows in powers of two, so the search tree of the previous query is kept while the end point
+  // is moved around the same start point.
+  itk::IndexValueType radius = 64;
+  while (radius < 2 * std::max(std::abs(startPoint[0] - endPoint[0]), std::abs(startPoint[1] - endPoint[1])))
+  {
+    radius *= 2;
+  }
+
+  InternalImageType::RegionType searchRegion;
+  searchRegion.SetIndex(0, startPoint[0] - radius);
+  searchRegion.SetIndex(1, startPoint[1] - radius);
+  searchRegion.SetSize(0, 2 * radius + 1);
+  searchRegion.SetSize(1, 2 * radius + 1);
+  searchRegion.Crop(m_InternalImage->GetLargestPossibleRegion());
+  m_ShortestPathFilter->SetSearchRegion(searchRegion);
+
   // m_ShortestPathFilter->SetCalcAllDistances(true);
   m_ShortestPathFilter->SetStartIndex(startPoint);
   m_ShortestPathFilter->SetEndIndex(endPoint);
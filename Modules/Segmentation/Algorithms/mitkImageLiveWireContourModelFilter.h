@@ -63,6 +63,7 @@ namespace mitk
     typedef itk::Image<float, 2> InternalImageType;
     typedef itk::ShortestPathImageFilter<InternalImageType, InternalImageType> ShortestPathImageFilterType;
     typedef itk::ShortestPathCostFunctionLiveWire<InternalImageType> CostFunctionType;
+    typedef CostFunctionType::CostFeaturesPointer CostFeaturesPointer;
     typedef std::vector<itk::Index<2>> ShortestPathType;
 
     /** \brief start point in world coordinates*/
@@ -101,6 +102,15 @@ namespace mitk
     */
     void RemoveRepulsivePoint(const itk::Index<2> &idx);
 
+    /** \brief Use precomputed cost features of the input image, e.g. from mitk::LiveWireCostFeatureCache.
+    Has to be called after the input is set, setting a new input discards them.
+    */
+    void SetCostFeatures(const CostFeaturesPointer &features);
+
+    /** \brief Cost features of the input image, available after the first update or if they were set
+    */
+    CostFeaturesPointer GetCostFeatures() const;
+
     virtual void SetInput(const InputType *input);
 
     using Superclass::SetInput;
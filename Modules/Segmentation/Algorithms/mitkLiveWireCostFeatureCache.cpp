@@ -0,0 +1,295 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkLiveWireCostFeatureCache.h"
+
+#include <mitkImageCast.h>
+
+#include <algorithm>
+
+namespace
+{
+  /** Features are only reused for planes that are equal up to this tolerance in mm */
+  const mitk::ScalarType PlaneEpsilon = 1e-6;
+
+  const std::size_t DefaultCapacity = 16;
+
+  unsigned long GetImageMTime(const mitk::Image *image, unsigned int timeStep)
+  {
+    unsigned long mTime = std::max(image->GetMTime(), image->GetTimeGeometry()->GetMTime());
+
+    auto geometry = image->GetTimeGeometry()->GetGeometryForTimeStep(timeStep);
+    if (geometry.IsNotNull())
+      mTime = std::max(mTime, geometry->GetMTime());
+
+    return mTime;
+  }
+}
+
+mitk::LiveWireCostFeatureCache::SliceKey::SliceKey() : m_ReferenceImage(nullptr), m_ImageMTime(0), m_TimeStep(0), m_Component(0)
+{
+}
+
+mitk::LiveWireCostFeatureCache::SliceKey::SliceKey(const Image *referenceImage,
+                                                   const PlaneGeometry *plane,
+                                                   unsigned int timeStep,
+                                                   unsigned int component)
+  : m_ReferenceImage(referenceImage),
+    m_ImageMTime(nullptr != referenceImage ? GetImageMTime(referenceImage, timeStep) : 0),
+    m_TimeStep(timeStep),
+    m_Component(component)
+{
+  // The plane of a render window is modified while navigating, so a copy is kept
+  if (nullptr != plane)
+    m_Plane = plane->Clone();
+}
+
+mitk::LiveWireCostFeatureCache *mitk::LiveWireCostFeatureCache::GetInstance()
+{
+  static LiveWireCostFeatureCache instance;
+  return &instance;
+}
+
+mitk::LiveWireCostFeatureCache::LiveWireCostFeatureCache()
+  : m_Capacity(DefaultCapacity), m_Generation(0), m_IsBusy(false), m_Stop(false)
+{
+}
+
+mitk::LiveWireCostFeatureCache::~LiveWireCostFeatureCache()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stop = true;
+    m_Requests.clear();
+  }
+
+  m_RequestAdded.notify_all();
+
+  if (m_Thread.joinable())
+    m_Thread.join();
+}
+
+bool mitk::LiveWireCostFeatureCache::Matches(const SliceKey &a, const SliceKey &b)
+{
+  return nullptr != a.m_ReferenceImage && a.m_Plane.IsNotNull() && b.m_Plane.IsNotNull() &&
+         a.m_ReferenceImage == b.m_ReferenceImage && a.m_ImageMTime == b.m_ImageMTime &&
+         a.m_TimeStep == b.m_TimeStep && a.m_Component == b.m_Component &&
+         Equal(*a.m_Plane, *b.m_Plane, PlaneEpsilon, false);
+}
+
+mitk::LiveWireCostFeatureCache::FeaturesPointer mitk::LiveWireCostFeatureCache::ComputeFeatures(const Image *slice)
+{
+  try
+  {
+    ImageLiveWireContourModelFilter::InternalImageType::Pointer itkSlice;
+    CastToItkImage(slice, itkSlice);
+    return ImageLiveWireContourModelFilter::CostFunctionType::ComputeCostFeatures(itkSlice);
+  }
+  catch (const std::exception &e)
+  {
+    MITK_DEBUG << "LiveWire cost features could not be computed: " << e.what();
+  }
+
+  return nullptr;
+}
+
+bool mitk::LiveWireCostFeatureCache::Contains(const SliceKey &key) const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  if (m_IsBusy && Matches(m_CurrentKey, key))
+    return true;
+
+  for (const auto &entry : m_Cache)
+  {
+    if (Matches(entry.m_Key, key))
+      return true;
+  }
+
+  for (const auto &request : m_Requests)
+  {
+    if (Matches(request.m_Key, key))
+      return true;
+  }
+
+  return false;
+}
+
+void mitk::LiveWireCostFeatureCache::Prefetch(const SliceKey &key, const Image *slice)
+{
+  if (nullptr == slice || nullptr == key.m_ReferenceImage || key.m_Plane.IsNull())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    // Features of a modified image are useless
+    m_Cache.erase(std::remove_if(m_Cache.begin(),
+                                 m_Cache.end(),
+                                 [&](const CacheEntry &entry) {
+                                   return entry.m_Key.m_ReferenceImage == key.m_ReferenceImage &&
+                                          entry.m_Key.m_ImageMTime != key.m_ImageMTime;
+                                 }),
+                  m_Cache.end());
+
+    Request request;
+    request.m_Key = key;
+    request.m_Slice = slice;
+    request.m_Generation = m_Generation;
+
+    // Only the slice the user currently looks at is of interest
+    m_Requests.clear();
+    m_Requests.push_back(request);
+
+    if (!m_Thread.joinable())
+      m_Thread = std::thread(&LiveWireCostFeatureCache::ThreadMain, this);
+  }
+
+  m_RequestAdded.notify_one();
+}
+
+mitk::LiveWireCostFeatureCache::FeaturesPointer mitk::LiveWireCostFeatureCache::GetFeatures(const SliceKey &key,
+                                                                                           const Image *slice)
+{
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    while (true)
+    {
+      for (auto iter = m_Cache.begin(); iter != m_Cache.end(); ++iter)
+      {
+        if (Matches(iter->m_Key, key))
+        {
+          // Move the entry to the back, it is the most recently used one now
+          CacheEntry entry = *iter;
+          m_Cache.erase(iter);
+          m_Cache.push_back(entry);
+          return entry.m_Features;
+        }
+      }
+
+      if (!m_IsBusy || !Matches(m_CurrentKey, key))
+        break;
+
+      m_RequestProcessed.wait(lock);
+    }
+
+    // The features are computed right here, a pending request for the same slice is obsolete
+    m_Requests.erase(std::remove_if(m_Requests.begin(),
+                                    m_Requests.end(),
+                                    [&](const Request &request) { return Matches(request.m_Key, key); }),
+                     m_Requests.end());
+  }
+
+  if (nullptr == slice)
+    return nullptr;
+
+  auto features = ComputeFeatures(slice);
+
+  if (nullptr != features && nullptr != key.m_ReferenceImage && key.m_Plane.IsNotNull())
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    this->Insert(key, features);
+  }
+
+  return features;
+}
+
+void mitk::LiveWireCostFeatureCache::SetCapacity(std::size_t capacity)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  m_Capacity = std::max<std::size_t>(1, capacity);
+
+  while (m_Cache.size() > m_Capacity)
+    m_Cache.pop_front();
+}
+
+std::size_t mitk::LiveWireCostFeatureCache::GetCapacity() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Capacity;
+}
+
+std::size_t mitk::LiveWireCostFeatureCache::GetNumberOfCachedSlices() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Cache.size();
+}
+
+void mitk::LiveWireCostFeatureCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  ++m_Generation;
+  m_Requests.clear();
+  m_Cache.clear();
+}
+
+void mitk::LiveWireCostFeatureCache::WaitUntilIdle()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_RequestProcessed.wait(lock, [this]() { return m_Requests.empty() && !m_IsBusy; });
+}
+
+void mitk::LiveWireCostFeatureCache::Insert(const SliceKey &key, const FeaturesPointer &features)
+{
+  for (const auto &entry : m_Cache)
+  {
+    if (Matches(entry.m_Key, key))
+      return;
+  }
+
+  m_Cache.push_back({key, features});
+
+  while (m_Cache.size() > m_Capacity)
+    m_Cache.pop_front();
+}
+
+void mitk::LiveWireCostFeatureCache::ThreadMain()
+{
+  while (true)
+  {
+    Request request;
+
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_RequestAdded.wait(lock, [this]() { return m_Stop || !m_Requests.empty(); });
+
+      if (m_Stop)
+        return;
+
+      request = m_Requests.front();
+      m_Requests.pop_front();
+      m_CurrentKey = request.m_Key;
+      m_IsBusy = true;
+    }
+
+    auto features = ComputeFeatures(request.m_Slice);
+
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+
+      if (nullptr != features && request.m_Generation == m_Generation)
+        this->Insert(request.m_Key, features);
+
+      m_CurrentKey = SliceKey();
+      m_IsBusy = false;
+    }
+
+    m_RequestProcessed.notify_all();
+  }
+}
@@ -0,0 +1,139 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkLiveWireCostFeatureCache_h
+#define mitkLiveWireCostFeatureCache_h
+
+#include <MitkSegmentationExports.h>
+#include <mitkImage.h>
+#include <mitkImageLiveWireContourModelFilter.h>
+#include <mitkPlaneGeometry.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace mitk
+{
+  /**
+   * \brief Caches the image features that LiveWire costs are computed from, per slice of a reference image.
+   *
+   * Computing the gradient magnitude, gradient and edge images of a slice dominates the time until the first
+   * LiveWire path is shown. LiveWireTool2D therefore requests the features of the slice under the mouse cursor
+   * via Prefetch() before a contour is started; they are computed in a background thread. GetFeatures() returns
+   * cached features, waits for a pending computation of the same slice or computes them in the calling thread.
+   *
+   * Slices are identified by the reference image, its modification time, the time step, the image component
+   * and the plane geometry. The least recently used slices are evicted once the capacity is exceeded. All
+   * LiveWire tools and interactors share the cache returned by GetInstance(), so the features survive the
+   * end of a LiveWire session.
+   *
+   * \ingroup Segmentation
+   */
+  class MITKSEGMENTATION_EXPORT LiveWireCostFeatureCache
+  {
+  public:
+    typedef ImageLiveWireContourModelFilter::CostFeaturesPointer FeaturesPointer;
+
+    /** \brief Identifies a slice of a reference image */
+    struct SliceKey
+    {
+      SliceKey();
+      SliceKey(const Image *referenceImage, const PlaneGeometry *plane, unsigned int timeStep, unsigned int component);
+
+      /** Only used to identify the image, so the cache does not keep it alive. Modification times are unique,
+       * so a new image at the same address never matches. */
+      const Image *m_ReferenceImage;
+      unsigned long m_ImageMTime;
+      PlaneGeometry::ConstPointer m_Plane;
+      unsigned int m_TimeStep;
+      unsigned int m_Component;
+    };
+
+    /** \brief Returns the cache shared by all LiveWire tools. */
+    static LiveWireCostFeatureCache *GetInstance();
+
+    LiveWireCostFeatureCache();
+    ~LiveWireCostFeatureCache();
+
+    /** \brief Returns true if the features of the slice are cached or being computed. */
+    bool Contains(const SliceKey &key) const;
+
+    /** \brief Requests the features of a slice, which are computed in a background thread.
+     *
+     * slice is the 2D image of the slice identified by key; it must not be modified afterwards.
+     * Pending requests for other slices are dropped. */
+    void Prefetch(const SliceKey &key, const Image *slice);
+
+    /** \brief Returns the features of a slice.
+     *
+     * If they are neither cached nor being computed, they are computed from slice in the calling thread. */
+    FeaturesPointer GetFeatures(const SliceKey &key, const Image *slice);
+
+    /** \brief Sets the maximum number of cached slices (default: 16). */
+    void SetCapacity(std::size_t capacity);
+    std::size_t GetCapacity() const;
+
+    /** \brief Returns the number of cached slices. */
+    std::size_t GetNumberOfCachedSlices() const;
+
+    /** \brief Drops all pending requests and cached slices. */
+    void Clear();
+
+    /** \brief Blocks until all pending requests are processed. Intended for testing. */
+    void WaitUntilIdle();
+
+  private:
+    LiveWireCostFeatureCache(const LiveWireCostFeatureCache &) = delete;
+    LiveWireCostFeatureCache &operator=(const LiveWireCostFeatureCache &) = delete;
+
+    struct Request
+    {
+      SliceKey m_Key;
+      Image::ConstPointer m_Slice;
+      unsigned long m_Generation;
+    };
+
+    struct CacheEntry
+    {
+      SliceKey m_Key;
+      FeaturesPointer m_Features;
+    };
+
+    static bool Matches(const SliceKey &a, const SliceKey &b);
+    static FeaturesPointer ComputeFeatures(const Image *slice);
+
+    /** Adds features to the cache and evicts the least recently used slices. Expects m_Mutex to be locked. */
+    void Insert(const SliceKey &key, const FeaturesPointer &features);
+
+    void ThreadMain();
+
+    std::thread m_Thread;
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_RequestAdded;
+    std::condition_variable m_RequestProcessed;
+    std::deque<Request> m_Requests;
+    std::deque<CacheEntry> m_Cache; // least recently used first
+    std::size_t m_Capacity;
+    SliceKey m_CurrentKey;
+    unsigned long m_Generation;
+    bool m_IsBusy;
+    bool m_Stop;
+  };
+}
+
+#endif
@@ -16,10 +16,30 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkManualSegmentationToSurfaceFilter.h>
 
+#include <vtkAppendPolyData.h>
+#include <vtkCleanPolyData.h>
+#include <vtkImageChangeInformation.h>
+#include <vtkImageClip.h>
 #include <vtkImageShiftScale.h>
+#include <vtkInformation.h>
+#include <vtkMarchingCubes.h>
+#include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
 
 #include "mitkProgressBar.h"
+#include "mitkRunInParallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+  /** Radius of the Gaussian kernel in multiples of the standard deviation */
+  const double GaussianRadiusFactor = 0.49;
+}
 
 mitk::ManualSegmentationToSurfaceFilter::ManualSegmentationToSurfaceFilter()
 {
@@ -33,6 +53,8 @@ mitk::ManualSegmentationToSurfaceFilter::ManualSegmentationToSurfaceFilter()
   m_InterpolationX = 1.0f;
   m_InterpolationY = 1.0f;
   m_InterpolationZ = 1.0f;
+  m_MemoryLimit = 0;
+  m_NumberOfThreads = mitk::GetDefaultNumberOfThreads();
 };
 
 mitk::ManualSegmentationToSurfaceFilter::~ManualSegmentationToSurfaceFilter(){};
@@ -61,76 +83,23 @@ void mitk::ManualSegmentationToSurfaceFilter::GenerateData()
   {
     vtkSmartPointer<vtkImageData> vtkimage = image->GetVtkImageData(t);
 
-    // Median -->smooth 3D
-    // MITK_INFO << (m_MedianFilter3D ? "Applying median..." : "No median filtering");
-    if (m_MedianFilter3D)
+    const int numberOfSlices = vtkimage->GetDimensions()[2];
+    if (m_MemoryLimit > 0 && numberOfSlices > 1 &&
+        this->EstimateMemoryPerSlice(vtkimage) * numberOfSlices > static_cast<double>(m_MemoryLimit))
     {
-      vtkImageMedian3D *median = vtkImageMedian3D::New();
-      median->SetInputData(vtkimage);                                                       // RC++ (VTK < 5.0)
-      median->SetKernelSize(m_MedianKernelSizeX, m_MedianKernelSizeY, m_MedianKernelSizeZ); // Std: 3x3x3
-      median->ReleaseDataFlagOn();
-      median->UpdateInformation();
-      median->Update();
-      vtkimage = median->GetOutput(); //->Out
-      median->Delete();
-    }
-    ProgressBar::GetInstance()->Progress();
+      vtkSmartPointer<vtkPolyData> polydata = this->CreateSurfaceInSlabs(vtkimage, thresholdExpanded);
+      ProgressBar::GetInstance()->Progress(3);
 
-    // Interpolate image spacing
-    // MITK_INFO << (m_Interpolation ? "Resampling..." : "No resampling");
-    if (m_Interpolation)
-    {
-      vtkImageResample *imageresample = vtkImageResample::New();
-      imageresample->SetInputData(vtkimage);
-
-      // Set Spacing Manual to 1mm in each direction (Original spacing is lost during image processing)
-      imageresample->SetAxisOutputSpacing(0, m_InterpolationX);
-      imageresample->SetAxisOutputSpacing(1, m_InterpolationY);
-      imageresample->SetAxisOutputSpacing(2, m_InterpolationZ);
-      imageresample->UpdateInformation();
-      imageresample->Update();
-      vtkimage = imageresample->GetOutput(); //->Output
-      imageresample->Delete();
+      this->ProcessSurface(t, polydata, surface);
     }
-    ProgressBar::GetInstance()->Progress();
-
-    // MITK_INFO << (m_UseGaussianImageSmooth ? "Applying gaussian smoothing..." : "No gaussian smoothing");
-    if (m_UseGaussianImageSmooth) // gauss
+    else
     {
-      vtkImageShiftScale *scalefilter = vtkImageShiftScale::New();
-      scalefilter->SetScale(100);
-      scalefilter->SetInputData(vtkimage);
-      scalefilter->Update();
-
-      vtkImageGaussianSmooth *gaussian = vtkImageGaussianSmooth::New();
-      gaussian->SetInputConnection(scalefilter->GetOutputPort());
-      gaussian->SetDimensionality(3);
-      gaussian->SetRadiusFactor(0.49);
-      gaussian->SetStandardDeviation(m_GaussianStandardDeviation);
-      gaussian->ReleaseDataFlagOn();
-      gaussian->UpdateInformation();
-      gaussian->Update();
-
-      vtkimage = scalefilter->GetOutput();
-
-      double range[2];
-      vtkimage->GetScalarRange(range);
-
-      if (range[1] != 0) // too little slices, image smoothing eliminates all segmentation pixels
-      {
-        vtkimage = gaussian->GetOutput(); //->Out
-      }
-      else
-      {
-        MITK_INFO << "Smoothing would remove all pixels of the segmentation. Use unsmoothed result instead.";
-      }
-      gaussian->Delete();
-      scalefilter->Delete();
-    }
-    ProgressBar::GetInstance()->Progress();
+      vtkimage = this->PreprocessImage(vtkimage, 0, false);
+      ProgressBar::GetInstance()->Progress(3);
 
-    // Create surface for t-Slice
-    CreateSurface(t, vtkimage, surface, thresholdExpanded);
+      // Create surface for t-Slice
+      CreateSurface(t, vtkimage, surface, thresholdExpanded);
+    }
     ProgressBar::GetInstance()->Progress();
   }
 
@@ -153,6 +122,236 @@ void mitk::ManualSegmentationToSurfaceFilter::GenerateData()
   }
 };
 
+vtkSmartPointer<vtkImageData> mitk::ManualSegmentationToSurfaceFilter::PreprocessImage(vtkImageData *image,
+                                                                                       int numberOfThreads,
+                                                                                       bool isSlab)
+{
+  vtkSmartPointer<vtkImageData> vtkimage = image;
+
+  // Median -->smooth 3D
+  // MITK_INFO << (m_MedianFilter3D ? "Applying median..." : "No median filtering");
+  if (m_MedianFilter3D)
+  {
+    vtkImageMedian3D *median = vtkImageMedian3D::New();
+    median->SetInputData(vtkimage);                                                       // RC++ (VTK < 5.0)
+    median->SetKernelSize(m_MedianKernelSizeX, m_MedianKernelSizeY, m_MedianKernelSizeZ); // Std: 3x3x3
+    if (numberOfThreads > 0)
+      median->SetNumberOfThreads(numberOfThreads);
+    median->ReleaseDataFlagOn();
+    median->UpdateInformation();
+    median->Update();
+    vtkimage = median->GetOutput(); //->Out
+    median->Delete();
+  }
+
+  // Interpolate image spacing
+  // MITK_INFO << (m_Interpolation ? "Resampling..." : "No resampling");
+  if (m_Interpolation)
+  {
+    vtkImageResample *imageresample = vtkImageResample::New();
+    imageresample->SetInputData(vtkimage);
+
+    // Set Spacing Manual to 1mm in each direction (Original spacing is lost during image processing)
+    imageresample->SetAxisOutputSpacing(0, m_InterpolationX);
+    imageresample->SetAxisOutputSpacing(1, m_InterpolationY);
+    imageresample->SetAxisOutputSpacing(2, m_InterpolationZ);
+    if (numberOfThreads > 0)
+      imageresample->SetNumberOfThreads(numberOfThreads);
+    imageresample->UpdateInformation();
+    imageresample->Update();
+    vtkimage = imageresample->GetOutput(); //->Output
+    imageresample->Delete();
+  }
+
+  // MITK_INFO << (m_UseGaussianImageSmooth ? "Applying gaussian smoothing..." : "No gaussian smoothing");
+  if (m_UseGaussianImageSmooth) // gauss
+  {
+    vtkImageShiftScale *scalefilter = vtkImageShiftScale::New();
+    scalefilter->SetScale(100);
+    scalefilter->SetInputData(vtkimage);
+    if (numberOfThreads > 0)
+      scalefilter->SetNumberOfThreads(numberOfThreads);
+    scalefilter->Update();
+
+    vtkImageGaussianSmooth *gaussian = vtkImageGaussianSmooth::New();
+    gaussian->SetInputConnection(scalefilter->GetOutputPort());
+    gaussian->SetDimensionality(3);
+    gaussian->SetRadiusFactor(GaussianRadiusFactor);
+    gaussian->SetStandardDeviation(m_GaussianStandardDeviation);
+    if (numberOfThreads > 0)
+      gaussian->SetNumberOfThreads(numberOfThreads);
+    gaussian->ReleaseDataFlagOn();
+    gaussian->UpdateInformation();
+    gaussian->Update();
+
+    vtkimage = scalefilter->GetOutput();
+
+    double range[2];
+    vtkimage->GetScalarRange(range);
+
+    // a slab without segmentation pixels is all zero with and without smoothing
+    if (range[1] != 0) // too little slices, image smoothing eliminates all segmentation pixels
+    {
+      vtkimage = gaussian->GetOutput(); //->Out
+    }
+    else if (!isSlab)
+    {
+      MITK_INFO << "Smoothing would remove all pixels of the segmentation. Use unsmoothed result instead.";
+    }
+    gaussian->Delete();
+    scalefilter->Delete();
+  }
+
+  return vtkimage;
+}
+
+double mitk::ManualSegmentationToSurfaceFilter::EstimateMemoryPerSlice(vtkImageData *vtkimage) const
+{
+  int dimensions[3];
+  vtkimage->GetDimensions(dimensions);
+  double spacing[3];
+  vtkimage->GetSpacing(spacing);
+
+  const double sliceSize = static_cast<double>(dimensions[0]) * dimensions[1] * vtkimage->GetScalarSize() *
+                           vtkimage->GetNumberOfScalarComponents();
+
+  // copy of the input slices and median
+  double numberOfImages = m_MedianFilter3D ? 2.0 : 1.0;
+
+  // resampled, scaled and smoothed images have the size of the interpolated grid
+  double resampledSize = 1.0;
+  if (m_Interpolation)
+  {
+    resampledSize = spacing[0] / m_InterpolationX * spacing[1] / m_InterpolationY * spacing[2] / m_InterpolationZ;
+    numberOfImages += resampledSize;
+  }
+
+  if (m_UseGaussianImageSmooth)
+    numberOfImages += 2.0 * resampledSize;
+
+  return sliceSize * numberOfImages;
+}
+
+vtkSmartPointer<vtkPolyData> mitk::ManualSegmentationToSurfaceFilter::CreateSurfaceInSlabs(vtkImageData *vtkimage,
+                                                                                          ScalarType threshold)
+{
+  int inputExtent[6];
+  vtkimage->GetExtent(inputExtent);
+  double spacing[3];
+  vtkimage->GetSpacing(spacing);
+
+  // extent of the preprocessed volume and preprocessed slices per input slice
+  int outputExtent[6];
+  std::copy_n(inputExtent, 6, outputExtent);
+  double zoom = 1.0;
+  if (m_Interpolation)
+  {
+    vtkSmartPointer<vtkImageResample> imageresample = vtkSmartPointer<vtkImageResample>::New();
+    imageresample->SetInputData(vtkimage);
+    imageresample->SetAxisOutputSpacing(0, m_InterpolationX);
+    imageresample->SetAxisOutputSpacing(1, m_InterpolationY);
+    imageresample->SetAxisOutputSpacing(2, m_InterpolationZ);
+    imageresample->UpdateInformation();
+    imageresample->GetOutputInformation(0)->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), outputExtent);
+    zoom = spacing[2] / m_InterpolationZ;
+  }
+
+  // Input slices a slab needs beyond its preprocessed slices, so that the median, the linear interpolation and
+  // the Gaussian filter compute the same voxels as for the whole volume
+  const int gaussianRadius =
+    m_UseGaussianImageSmooth ? static_cast<int>(std::ceil(m_GaussianStandardDeviation * GaussianRadiusFactor)) : 0;
+  const int margin = (m_MedianFilter3D ? m_MedianKernelSizeZ / 2 : 0) +
+                     static_cast<int>(std::ceil((gaussianRadius + 1) / zoom)) + 1;
+
+  const unsigned int numberOfThreads = std::max(1u, m_NumberOfThreads);
+  int slabSlices =
+    static_cast<int>(m_MemoryLimit / (numberOfThreads * this->EstimateMemoryPerSlice(vtkimage))) - 2 * margin;
+  if (slabSlices < 1)
+  {
+    MITK_WARN << "Memory limit of " << m_MemoryLimit << " bytes is exceeded by slabs of a single slice.";
+    slabSlices = 1;
+  }
+
+  // Neighboring slabs share the preprocessed slice between them, so that marching cubes creates the same vertices
+  // on it for both slabs
+  const int slabOutputSlices = std::max(1, static_cast<int>(slabSlices * zoom));
+  std::vector<std::pair<int, int>> slabs;
+  for (int firstSlice = outputExtent[4]; firstSlice < outputExtent[5]; firstSlice += slabOutputSlices)
+    slabs.emplace_back(firstSlice, std::min(firstSlice + slabOutputSlices, outputExtent[5]));
+
+  if (slabs.empty())
+    return vtkSmartPointer<vtkPolyData>::New();
+
+  MITK_INFO << "Creating surface in " << slabs.size() << " slabs of " << slabOutputSlices << " slices";
+
+  // VTK filters of a slab run single threaded if several slabs are processed at a time
+  const int numberOfVtkThreads = numberOfThreads > 1 && slabs.size() > 1 ? 1 : 0;
+  const std::size_t voxelSize = vtkimage->GetScalarSize() * vtkimage->GetNumberOfScalarComponents();
+  const std::size_t sliceSize =
+    static_cast<std::size_t>(inputExtent[1] - inputExtent[0] + 1) * (inputExtent[3] - inputExtent[2] + 1) * voxelSize;
+
+  std::vector<vtkSmartPointer<vtkPolyData>> slabSurfaces(slabs.size());
+
+  mitk::RunInParallel(numberOfThreads, slabs.size(), [&](std::size_t slabId, std::size_t) {
+    const int firstSlice =
+      std::max(inputExtent[4], static_cast<int>(std::floor(slabs[slabId].first / zoom)) - margin);
+    const int lastSlice = std::min(inputExtent[5], static_cast<int>(std::ceil(slabs[slabId].second / zoom)) + margin);
+
+    // a copy of the input slices keeps the extent and thus the index coordinates of the whole volume
+    vtkSmartPointer<vtkImageData> slab = vtkSmartPointer<vtkImageData>::New();
+    slab->SetExtent(inputExtent[0], inputExtent[1], inputExtent[2], inputExtent[3], firstSlice, lastSlice);
+    slab->SetOrigin(vtkimage->GetOrigin());
+    slab->SetSpacing(spacing);
+    slab->AllocateScalars(vtkimage->GetScalarType(), vtkimage->GetNumberOfScalarComponents());
+    std::memcpy(slab->GetScalarPointer(),
+                vtkimage->GetScalarPointer(inputExtent[0], inputExtent[2], firstSlice),
+                sliceSize * (lastSlice - firstSlice + 1));
+
+    vtkSmartPointer<vtkImageData> preprocessedSlab = this->PreprocessImage(slab, numberOfVtkThreads, true);
+
+    int clipExtent[6];
+    preprocessedSlab->GetExtent(clipExtent);
+    clipExtent[4] = slabs[slabId].first;
+    clipExtent[5] = slabs[slabId].second;
+
+    vtkSmartPointer<vtkImageClip> clip = vtkSmartPointer<vtkImageClip>::New();
+    clip->SetInputData(preprocessedSlab);
+    clip->SetOutputWholeExtent(clipExtent);
+    clip->ClipDataOn();
+
+    vtkSmartPointer<vtkImageChangeInformation> indexCoordinatesImageFilter =
+      vtkSmartPointer<vtkImageChangeInformation>::New();
+    indexCoordinatesImageFilter->SetInputConnection(clip->GetOutputPort());
+    indexCoordinatesImageFilter->SetOutputOrigin(0.0, 0.0, 0.0);
+
+    vtkSmartPointer<vtkMarchingCubes> skinExtractor = vtkSmartPointer<vtkMarchingCubes>::New();
+    skinExtractor->ComputeScalarsOff();
+    skinExtractor->SetInputConnection(indexCoordinatesImageFilter->GetOutputPort());
+    skinExtractor->SetValue(0, threshold);
+    skinExtractor->Update();
+
+    slabSurfaces[slabId] = skinExtractor->GetOutput();
+  });
+
+  vtkSmartPointer<vtkAppendPolyData> appendPolyData = vtkSmartPointer<vtkAppendPolyData>::New();
+  for (const auto &slabSurface : slabSurfaces)
+    appendPolyData->AddInputData(slabSurface);
+
+  // the vertices on the shared slices are identical, exact point merging stitches the slabs
+  vtkSmartPointer<vtkCleanPolyData> cleanPolyDataFilter = vtkSmartPointer<vtkCleanPolyData>::New();
+  cleanPolyDataFilter->SetInputConnection(appendPolyData->GetOutputPort());
+  cleanPolyDataFilter->PieceInvariantOff();
+  cleanPolyDataFilter->ConvertLinesToPointsOff();
+  cleanPolyDataFilter->ConvertPolysToLinesOff();
+  cleanPolyDataFilter->ConvertStripsToPolysOff();
+  cleanPolyDataFilter->PointMergingOn();
+  cleanPolyDataFilter->SetTolerance(0.0);
+  cleanPolyDataFilter->Update();
+
+  vtkSmartPointer<vtkPolyData> polydata = cleanPolyDataFilter->GetOutput();
+  return polydata;
+}
+
 void mitk::ManualSegmentationToSurfaceFilter::SetMedianKernelSize(int x, int y, int z)
 {
   m_MedianKernelSizeX = x;
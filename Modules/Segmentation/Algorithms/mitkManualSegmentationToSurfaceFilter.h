@@ -24,6 +24,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkImageMedian3D.h>
 #include <vtkImageResample.h>
 #include <vtkImageThreshold.h>
+#include <vtkSmartPointer.h>
+
+class vtkPolyData;
 
 namespace mitk
 {
@@ -37,6 +40,12 @@ namespace mitk
    * resulting isotropic image has 1mm isotropic voxel by default. But
    * can be varied freely.
    *
+   * If a memory limit is set and the intermediate images of the whole volume would exceed it, the volume is
+   * processed in slabs along the third image axis (see SetMemoryLimit()). Each slab is extended by enough slices
+   * for the median, interpolation and Gaussian filters to compute the same voxels as for the whole volume. The
+   * marching cubes surfaces of neighboring slabs share the vertices on the slice between them and are merged
+   * without seams. Smoothing and decimation of the mesh are done once for the merged surface.
+   *
    * @ingroup ImageFilters
    * @ingroup Process
    */
@@ -148,10 +157,52 @@ namespace mitk
      */
     void SetInterpolation(vtkDouble x, vtkDouble y, vtkDouble z);
 
+    /**
+     * Set a limit in bytes for the intermediate images of the filter pipeline, not counting the input image and
+     * the resulting mesh. If the estimated memory of processing the whole volume at once exceeds the limit, the
+     * volume is processed in slabs small enough to stay within the limit with NumberOfThreads slabs at a time.
+     * @param _arg by default 0, which always processes the whole volume at once
+     */
+    itkSetMacro(MemoryLimit, std::size_t);
+
+    /**
+     * Returns the memory limit for the intermediate images of the filter pipeline in bytes.
+     */
+    itkGetConstMacro(MemoryLimit, std::size_t);
+
+    /**
+     * Set the number of slabs that are processed in parallel if the volume is processed in slabs.
+     * @param _arg by default the global default number of threads of ITK
+     */
+    itkSetMacro(NumberOfThreads, unsigned int);
+
+    /**
+     * Returns the number of slabs that are processed in parallel.
+     */
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
   protected:
     ManualSegmentationToSurfaceFilter();
     ~ManualSegmentationToSurfaceFilter() override;
 
+    /**
+     * Applies the enabled median, interpolation and Gaussian filters to an image.
+     * @param numberOfThreads threads of each VTK filter, 0 for the VTK default
+     * @param isSlab true if vtkimage is a slab of the volume
+     */
+    vtkSmartPointer<vtkImageData> PreprocessImage(vtkImageData *vtkimage, int numberOfThreads, bool isSlab);
+
+    /**
+     * Returns the approximate memory of the intermediate images per slice of the input image in bytes.
+     */
+    double EstimateMemoryPerSlice(vtkImageData *vtkimage) const;
+
+    /**
+     * Creates the marching cubes surface of the preprocessed image slab by slab, see SetMemoryLimit().
+     * The surface has index coordinates like in CreateSurface().
+     */
+    vtkSmartPointer<vtkPolyData> CreateSurfaceInSlabs(vtkImageData *vtkimage, ScalarType threshold);
+
     bool m_MedianFilter3D;
     int m_MedianKernelSizeX, m_MedianKernelSizeY, m_MedianKernelSizeZ;
     bool m_UseGaussianImageSmooth; // Gaussian Filter
@@ -162,6 +213,9 @@ namespace mitk
     vtkDouble m_InterpolationY;
     vtkDouble m_InterpolationZ;
 
+    std::size_t m_MemoryLimit;
+    unsigned int m_NumberOfThreads;
+
   }; // namespace
 }
 #endif //_MITKMANUALSEGMENTATIONTISURFACEFILTER_h__
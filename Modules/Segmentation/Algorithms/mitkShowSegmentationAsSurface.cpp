@@ -52,6 +52,7 @@ namespace mitk
     SetParameter("Decimate mesh", true);
     SetParameter("Decimation rate", 0.8);
     SetParameter("Wireframe", false);
+    SetParameter("Memory limit in MB", 0u); // 0: no limit, see ManualSegmentationToSurfaceFilter::SetMemoryLimit()
 
     m_SurfaceNodes.clear();
   }
@@ -257,8 +258,12 @@ namespace mitk
     double reductionRate = 0.8;
     GetParameter("Decimation rate", reductionRate);
 
+    unsigned int memoryLimit = 0;
+    GetParameter("Memory limit in MB", memoryLimit);
+
     auto filter = ManualSegmentationToSurfaceFilter::New();
     filter->SetInput(binaryImage);
+    filter->SetMemoryLimit(static_cast<std::size_t>(memoryLimit) * 1024 * 1024);
     filter->SetThreshold(0.5);
     filter->SetUseGaussianImageSmooth(smooth);
     filter->SetSmooth(smooth);
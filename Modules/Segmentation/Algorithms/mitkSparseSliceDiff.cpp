@@ -0,0 +1,165 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkSparseSliceDiff.h"
+
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+  /** Retrieves the size of a slice; false if the image has more than one slice */
+  bool GetSliceDimensions(const mitk::Image *slice, unsigned int dimensions[2])
+  {
+    if (nullptr == slice || slice->GetDimension() < 2)
+      return false;
+
+    for (unsigned int dim = 2; dim < slice->GetDimension(); ++dim)
+    {
+      if (1 != slice->GetDimension(dim))
+        return false;
+    }
+
+    dimensions[0] = slice->GetDimension(0);
+    dimensions[1] = slice->GetDimension(1);
+    return true;
+  }
+}
+
+mitk::SparseSliceDiff::SparseSliceDiff() : m_PixelSize(0), m_NumberOfVoxels(0)
+{
+  std::fill_n(m_Dimensions, 2, 0);
+  std::fill_n(m_MinimumIndex, 2, 0);
+  std::fill_n(m_MaximumIndex, 2, 0);
+}
+
+mitk::SparseSliceDiff::~SparseSliceDiff()
+{
+}
+
+bool mitk::SparseSliceDiff::IsCompatible(const mitk::Image *slice) const
+{
+  unsigned int dimensions[2];
+  return GetSliceDimensions(slice, dimensions) && dimensions[0] == m_Dimensions[0] &&
+         dimensions[1] == m_Dimensions[1] && slice->GetPixelType().GetSize() == m_PixelSize;
+}
+
+bool mitk::SparseSliceDiff::Compute(const mitk::Image *referenceSlice, const mitk::Image *slice)
+{
+  m_Runs.clear();
+  m_NumberOfVoxels = 0;
+  m_PixelSize = 0;
+  std::fill_n(m_Dimensions, 2, 0);
+
+  unsigned int referenceDimensions[2];
+  if (!GetSliceDimensions(referenceSlice, referenceDimensions) || !GetSliceDimensions(slice, m_Dimensions) ||
+      referenceDimensions[0] != m_Dimensions[0] || referenceDimensions[1] != m_Dimensions[1] ||
+      referenceSlice->GetPixelType() != slice->GetPixelType() ||
+      slice->GetPixelType().GetSize() > sizeof(std::uint64_t))
+  {
+    std::fill_n(m_Dimensions, 2, 0);
+    this->Modified();
+    return false;
+  }
+
+  m_PixelSize = slice->GetPixelType().GetSize();
+
+  mitk::ImageReadAccessor referenceAccessor(referenceSlice);
+  mitk::ImageReadAccessor accessor(slice);
+  auto referenceData = static_cast<const char *>(referenceAccessor.GetData());
+  auto data = static_cast<const char *>(accessor.GetData());
+
+  m_MinimumIndex[0] = m_Dimensions[0];
+  m_MinimumIndex[1] = m_Dimensions[1];
+  m_MaximumIndex[0] = 0;
+  m_MaximumIndex[1] = 0;
+
+  unsigned int offset = 0;
+  for (unsigned int y = 0; y < m_Dimensions[1]; ++y)
+  {
+    for (unsigned int x = 0; x < m_Dimensions[0]; ++x, ++offset)
+    {
+      const char *voxel = data + static_cast<std::size_t>(offset) * m_PixelSize;
+      if (0 == std::memcmp(referenceData + static_cast<std::size_t>(offset) * m_PixelSize, voxel, m_PixelSize))
+        continue;
+
+      std::uint64_t value = 0;
+      std::memcpy(&value, voxel, m_PixelSize);
+
+      if (!m_Runs.empty() && m_Runs.back().m_Offset + m_Runs.back().m_Length == offset &&
+          m_Runs.back().m_Value == value)
+      {
+        ++m_Runs.back().m_Length;
+      }
+      else
+      {
+        m_Runs.push_back({offset, 1, value});
+      }
+
+      ++m_NumberOfVoxels;
+      m_MinimumIndex[0] = std::min(m_MinimumIndex[0], x);
+      m_MinimumIndex[1] = std::min(m_MinimumIndex[1], y);
+      m_MaximumIndex[0] = std::max(m_MaximumIndex[0], x);
+      m_MaximumIndex[1] = std::max(m_MaximumIndex[1], y);
+    }
+  }
+
+  m_Runs.shrink_to_fit();
+  this->Modified();
+  return true;
+}
+
+bool mitk::SparseSliceDiff::Apply(mitk::Image *slice) const
+{
+  if (!this->IsCompatible(slice))
+    return false;
+
+  mitk::ImageWriteAccessor accessor(slice);
+  auto data = static_cast<char *>(accessor.GetData());
+
+  for (const auto &run : m_Runs)
+  {
+    char *voxel = data + static_cast<std::size_t>(run.m_Offset) * m_PixelSize;
+    for (unsigned int i = 0; i < run.m_Length; ++i, voxel += m_PixelSize)
+      std::memcpy(voxel, &run.m_Value, m_PixelSize);
+  }
+
+  slice->Modified();
+  return true;
+}
+
+std::size_t mitk::SparseSliceDiff::GetNumberOfVoxels() const
+{
+  return m_NumberOfVoxels;
+}
+
+bool mitk::SparseSliceDiff::GetBoundingBox(unsigned int minimumIndex[2], unsigned int maximumIndex[2]) const
+{
+  if (0 == m_NumberOfVoxels)
+    return false;
+
+  std::copy_n(m_MinimumIndex, 2, minimumIndex);
+  std::copy_n(m_MaximumIndex, 2, maximumIndex);
+  return true;
+}
+
+std::size_t mitk::SparseSliceDiff::GetMemorySize() const
+{
+  return sizeof(*this) + m_Runs.capacity() * sizeof(Run);
+}
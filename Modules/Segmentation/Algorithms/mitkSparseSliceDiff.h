@@ -0,0 +1,109 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkSparseSliceDiff_h
+#define mitkSparseSliceDiff_h
+
+#include <MitkSegmentationExports.h>
+#include <mitkCommon.h>
+#include <mitkImage.h>
+
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * \brief Stores only the voxels in which a slice differs from a reference slice.
+   *
+   * Changed voxels are kept as runs of consecutive voxels (in raster order of the slice) with the same new value.
+   * A brush stroke therefore needs a few runs per slice row it touches, instead of a copy of the whole slice.
+   * Unchanged voxels are not stored at all, so Apply() leaves them untouched.
+   *
+   * DiffSliceOperation uses two of these diffs for undo and redo of a slice write: one with the voxels of the
+   * previous slice that have been overwritten, and one with the voxels that have been written.
+   *
+   * Only scalar or vector pixels of up to eight bytes are supported, which covers all segmentation images.
+   */
+  class MITKSEGMENTATION_EXPORT SparseSliceDiff : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(SparseSliceDiff, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    /**
+     * \brief Stores the voxels of slice that differ from referenceSlice, replacing the previous content.
+     *
+     * \return false if the slices differ in size or pixel type, are no single slices, or the pixels are larger
+     *         than eight bytes; the diff is empty then
+     */
+    bool Compute(const mitk::Image *referenceSlice, const mitk::Image *slice);
+
+    /**
+     * \brief Writes the stored voxels into a slice of the size and pixel type the diff has been computed from.
+     *
+     * \return false if the slice does not match
+     */
+    bool Apply(mitk::Image *slice) const;
+
+    /**
+     * \brief Returns the number of stored voxels.
+     */
+    std::size_t GetNumberOfVoxels() const;
+
+    /**
+     * \brief Retrieves the bounding box of the stored voxels in index coordinates of the slice.
+     *
+     * Both corners are part of the bounding box.
+     * \return false if no voxel is stored
+     */
+    bool GetBoundingBox(unsigned int minimumIndex[2], unsigned int maximumIndex[2]) const;
+
+    /**
+     * \brief Returns the approximate number of bytes allocated for the diff.
+     */
+    std::size_t GetMemorySize() const;
+
+  protected:
+    SparseSliceDiff();
+    ~SparseSliceDiff() override;
+
+  private:
+    /** Voxels [m_Offset, m_Offset + m_Length) of the slice that have the value m_Value */
+    struct Run
+    {
+      unsigned int m_Offset;
+      unsigned int m_Length;
+      std::uint64_t m_Value;
+    };
+
+    bool IsCompatible(const mitk::Image *slice) const;
+
+    unsigned int m_Dimensions[2];
+    std::size_t m_PixelSize;
+    std::size_t m_NumberOfVoxels;
+
+    unsigned int m_MinimumIndex[2];
+    unsigned int m_MaximumIndex[2];
+
+    std::vector<Run> m_Runs;
+  };
+}
+
+#endif
@@ -146,6 +146,12 @@ void mitk::ContourModelLiveWireInteractor::SetWorkingImage(mitk::Image *_arg)
   }
 }
 
+void mitk::ContourModelLiveWireInteractor::SetCostFeatures(
+  const mitk::ImageLiveWireContourModelFilter::CostFeaturesPointer &features)
+{
+  this->m_LiveWireFilter->SetCostFeatures(features);
+}
+
 void mitk::ContourModelLiveWireInteractor::OnDeletePoint(StateMachineAction *, InteractionEvent *interactionEvent)
 {
   int timestep = interactionEvent->GetSender()->GetTimeStep();
@@ -48,6 +48,10 @@ namespace mitk
 
     virtual void SetWorkingImage(mitk::Image *_arg);
 
+    /** \brief Use precomputed LiveWire cost features of the working image (see mitk::LiveWireCostFeatureCache).
+        Has to be called after SetWorkingImage(). */
+    void SetCostFeatures(const mitk::ImageLiveWireContourModelFilter::CostFeaturesPointer &features);
+
     void ConnectActionsAndFunctions() override;
 
   protected:
@@ -91,6 +91,7 @@ void mitk::LiveWireTool2D::ConnectActionsAndFunctions()
 {
   CONNECT_CONDITION("CheckContourClosed", OnCheckPoint);
 
+  CONNECT_FUNCTION("PrefetchCostFeatures", OnPrefetchCostFeatures);
   CONNECT_FUNCTION("InitObject", OnInitLiveWire);
   CONNECT_FUNCTION("AddPoint", OnAddPoint);
   CONNECT_FUNCTION("CtrlAddPoint", OnAddPoint);
@@ -200,6 +201,47 @@ bool mitk::LiveWireTool2D::IsPositionEventInsideImageRegion(mitk::InteractionPos
   return isPositionEventInsideImageRegion;
 }
 
+mitk::LiveWireCostFeatureCache::SliceKey mitk::LiveWireTool2D::GetReferenceSliceKey(
+  const InteractionPositionEvent *positionEvent)
+{
+  auto referenceNode = m_ToolManager->GetReferenceData(0);
+
+  if (nullptr == referenceNode)
+    return LiveWireCostFeatureCache::SliceKey();
+
+  auto referenceImage = dynamic_cast<Image *>(referenceNode->GetData());
+
+  if (nullptr == referenceImage)
+    return LiveWireCostFeatureCache::SliceKey();
+
+  int displayedComponent = 0;
+  referenceNode->GetIntProperty("Image.Displayed Component", displayedComponent);
+
+  return LiveWireCostFeatureCache::SliceKey(referenceImage,
+                                            positionEvent->GetSender()->GetCurrentWorldPlaneGeometry(),
+                                            positionEvent->GetSender()->GetTimeStep(referenceImage),
+                                            displayedComponent);
+}
+
+void mitk::LiveWireTool2D::OnPrefetchCostFeatures(StateMachineAction *, InteractionEvent *interactionEvent)
+{
+  auto positionEvent = dynamic_cast<mitk::InteractionPositionEvent *>(interactionEvent);
+
+  if (nullptr == positionEvent || positionEvent->GetSender()->GetMapperID() != BaseRenderer::Standard2D)
+    return;
+
+  auto key = this->GetReferenceSliceKey(positionEvent);
+
+  if (nullptr == key.m_ReferenceImage || key.m_Plane.IsNull())
+    return;
+
+  // The slice is only extracted once per displayed slice, as long as the mouse stays within it
+  auto cache = LiveWireCostFeatureCache::GetInstance();
+
+  if (!cache->Contains(key))
+    cache->Prefetch(key, this->GetAffectedReferenceSlice(positionEvent));
+}
+
 void mitk::LiveWireTool2D::OnInitLiveWire(StateMachineAction *, InteractionEvent *interactionEvent)
 {
   auto positionEvent = dynamic_cast<mitk::InteractionPositionEvent *>(interactionEvent);
@@ -270,6 +312,8 @@ void mitk::LiveWireTool2D::OnInitLiveWire(StateMachineAction *, InteractionEvent
 
   m_LiveWireFilter = ImageLiveWireContourModelFilter::New();
   m_LiveWireFilter->SetInput(m_WorkingSlice);
+  m_LiveWireFilter->SetCostFeatures(
+    LiveWireCostFeatureCache::GetInstance()->GetFeatures(this->GetReferenceSliceKey(positionEvent), m_WorkingSlice));
 
   // Map click to pixel coordinates
   auto click = positionEvent->GetPositionInWorld();
@@ -436,6 +480,7 @@ void mitk::LiveWireTool2D::FinishTool()
   m_ContourInteractor->LoadStateMachine("ContourModelModificationInteractor.xml", us::GetModuleContext()->GetModule());
   m_ContourInteractor->SetEventConfig("ContourModelModificationConfig.xml", us::GetModuleContext()->GetModule());
   m_ContourInteractor->SetWorkingImage(this->m_WorkingSlice);
+  m_ContourInteractor->SetCostFeatures(m_LiveWireFilter->GetCostFeatures());
   m_ContourInteractor->SetEditingContourModelNode(this->m_EditingContourNode);
 
   m_ContourNode->SetDataInteractor(m_ContourInteractor.GetPointer());
@@ -19,6 +19,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkSegTool2D.h>
 #include <mitkContourModelLiveWireInteractor.h>
+#include <mitkLiveWireCostFeatureCache.h>
 
 namespace mitk
 {
@@ -63,6 +64,9 @@ namespace mitk
     void Deactivated() override;
 
   private:
+    /// \brief Compute the LiveWire cost features of the slice under the mouse cursor in the background.
+    void OnPrefetchCostFeatures(StateMachineAction *, InteractionEvent *interactionEvent);
+
     /// \brief Initialize tool.
     void OnInitLiveWire(StateMachineAction *, InteractionEvent *interactionEvent);
 
@@ -91,6 +95,9 @@ namespace mitk
 
     bool IsPositionEventInsideImageRegion(InteractionPositionEvent *positionEvent, BaseData *data);
 
+    /// \brief Identifies the slice of the reference image that GetAffectedReferenceSlice() returns for the event.
+    LiveWireCostFeatureCache::SliceKey GetReferenceSliceKey(const InteractionPositionEvent *positionEvent);
+
     void ReleaseInteractors();
 
     void ReleaseHelperObjects();
@@ -38,11 +38,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkITKImageImport.h"
 #include "mitkImageAccessByItk.h"
 #include <itkConnectedComponentImageFilter.h>
-#include <itkConnectedThresholdImageFilter.h>
 #include <itkImageRegionIteratorWithIndex.h>
 #include <itkNeighborhoodIterator.h>
 
 #include <itkImageDuplicator.h>
+#include <itkParallelConnectedThresholdImageFilter.h>
 
 namespace mitk
 {
@@ -105,6 +105,7 @@ void mitk::RegionGrowingTool::Activated()
 
 void mitk::RegionGrowingTool::Deactivated()
 {
+  m_RegionGrower = nullptr;
   Superclass::Deactivated();
 }
 
@@ -199,11 +200,20 @@ void mitk::RegionGrowingTool::StartRegionGrowing(itk::Image<TPixel, imageDimensi
   typedef itk::Image<TPixel, imageDimension> InputImageType;
   typedef itk::Image<DefaultSegmentationDataType, imageDimension> OutputImageType;
 
-  typedef itk::ConnectedThresholdImageFilter<InputImageType, OutputImageType> RegionGrowingFilterType;
-  typename RegionGrowingFilterType::Pointer regionGrower = RegionGrowingFilterType::New();
+  typedef itk::ParallelConnectedThresholdImageFilter<InputImageType, OutputImageType> RegionGrowingFilterType;
+  typename RegionGrowingFilterType::Pointer regionGrower =
+    dynamic_cast<RegionGrowingFilterType *>(m_RegionGrower.GetPointer());
+  if (regionGrower.IsNull())
+  {
+    // the filter is kept while the mouse is moved, so that widening the thresholds continues the previous result
+    regionGrower = RegionGrowingFilterType::New();
+    regionGrower->IncrementalUpdateOn();
+    m_RegionGrower = regionGrower;
+  }
 
   // perform region growing in desired segmented region
   regionGrower->SetInput(inputImage);
+  regionGrower->ClearSeeds();
   regionGrower->AddSeed(seedIndex);
 
   regionGrower->SetLower(thresholds[0]);
@@ -234,8 +244,9 @@ void mitk::RegionGrowingTool::StartRegionGrowing(itk::Image<TPixel, imageDimensi
 
   typename OutputImageType::Pointer resultDup = duplicator->GetOutput();
 
-  NeighborhoodIteratorType neighborhoodIterator(radius, resultDup, resultDup->GetRequestedRegion());
-  ImageIteratorType imageIterator(resultImage, resultImage->GetRequestedRegion());
+  // the output of the region grower is kept for the next update and must not be modified
+  NeighborhoodIteratorType neighborhoodIterator(radius, resultImage, resultImage->GetRequestedRegion());
+  ImageIteratorType imageIterator(resultDup, resultDup->GetRequestedRegion());
 
   for (neighborhoodIterator.GoToBegin(), imageIterator.GoToBegin(); !neighborhoodIterator.IsAtEnd();
        ++neighborhoodIterator, ++imageIterator)
@@ -274,7 +285,7 @@ void mitk::RegionGrowingTool::StartRegionGrowing(itk::Image<TPixel, imageDimensi
   typedef itk::ConnectedComponentImageFilter<OutputImageType, OutputImageType> ConnectedComponentImageFilterType;
   typename ConnectedComponentImageFilterType::Pointer connectedComponentFilter =
     ConnectedComponentImageFilterType::New();
-  connectedComponentFilter->SetInput(resultImage);
+  connectedComponentFilter->SetInput(resultDup);
   connectedComponentFilter->Update();
   typename OutputImageType::Pointer resultImageCC = connectedComponentFilter->GetOutput();
   m_ConnectedComponentValue = resultImageCC->GetPixel(seedIndex);
@@ -446,7 +457,8 @@ void mitk::RegionGrowingTool::OnMousePressedOutside(StateMachineAction *, Intera
     m_Thresholds[0] = m_InitialThresholds[0];
     m_Thresholds[1] = m_InitialThresholds[1];
 
-    // Perform region growing
+    // Perform region growing with a new filter for the new seed
+    m_RegionGrower = nullptr;
     mitk::Image::Pointer resultImage = mitk::Image::New();
     AccessFixedDimensionByItk_3(
       m_ReferenceSlice, StartRegionGrowing, 2, indexInWorkingSlice2D, m_Thresholds, resultImage);
@@ -20,6 +20,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkFeedbackContourTool.h"
 #include <MitkSegmentationExports.h>
 #include <array>
+#include <itkProcessObject.h>
 
 namespace us
 {
@@ -126,6 +127,8 @@ namespace mitk
 
     /**
      * @brief Template that calls an ITK filter to do the region growing.
+     * While the mouse is moved, the filter continues the previous result as long as the threshold window is only
+     * widened.
      */
     template <typename TPixel, unsigned int imageDimension>
     void StartRegionGrowing(itk::Image<TPixel, imageDimension> *itkImage,
@@ -149,6 +152,7 @@ namespace mitk
     int m_PaintingPixelValue;
     bool m_FillFeedbackContour;
     int m_ConnectedComponentValue;
+    itk::ProcessObject::Pointer m_RegionGrower;
   };
 
 } // namespace
@@ -373,14 +373,8 @@ void mitk::SegTool2D::WriteSliceToVolume(const mitk::SegTool2D::SliceInformation
   auto *image = dynamic_cast<Image *>(workingNode->GetData());
 
   /*============= BEGIN undo/redo feature block ========================*/
-  // Create undo operation by caching the not yet modified slices
+  // Keep the not yet modified slice for the undo operation
   mitk::Image::Pointer originalSlice = GetAffectedImageSliceAs2DImage(sliceInfo.plane, image, sliceInfo.timestep);
-  auto *undoOperation =
-    new DiffSliceOperation(image,
-                           originalSlice,
-                           dynamic_cast<SlicedGeometry3D *>(originalSlice->GetGeometry()),
-                           sliceInfo.timestep,
-                           sliceInfo.plane);
   /*============= END undo/redo feature block ========================*/
 
   // Make sure that for reslicing and overwriting the same alogrithm is used. We can specify the mode of the vtk
@@ -404,18 +398,41 @@ void mitk::SegTool2D::WriteSliceToVolume(const mitk::SegTool2D::SliceInformation
   extractor->Modified();
   extractor->Update();
 
-  // the image was modified within the pipeline, but not marked so
-  image->Modified();
+  // the image was modified within the pipeline, but not marked so; label set images additionally update the
+  // statistics of their labels by the voxels of the overwritten slice
+  auto *labelSetImage = dynamic_cast<LabelSetImage *>(image);
+  if (nullptr != labelSetImage)
+    labelSetImage->UpdateLabelIndex(originalSlice, sliceInfo.timestep);
+  else
+    image->Modified();
   image->GetVtkImageData()->Modified();
 
   /*============= BEGIN undo/redo feature block ========================*/
-  // specify the undo operation with the edited slice
-  auto *doOperation =
-    new DiffSliceOperation(image,
-                           extractor->GetOutput(),
-                           dynamic_cast<SlicedGeometry3D *>(sliceInfo.slice->GetGeometry()),
-                           sliceInfo.timestep,
-                           sliceInfo.plane);
+  // Undo and redo only store the voxels that have been changed. Whole slices are kept if the slices can not be
+  // compared voxel by voxel.
+  DiffSliceOperation *undoOperation = nullptr;
+  DiffSliceOperation *doOperation = nullptr;
+
+  SparseSliceDiff::Pointer undoDiff = SparseSliceDiff::New();
+  SparseSliceDiff::Pointer doDiff = SparseSliceDiff::New();
+  if (undoDiff->Compute(sliceInfo.slice, originalSlice) && doDiff->Compute(originalSlice, sliceInfo.slice))
+  {
+    undoOperation = new DiffSliceOperation(image, undoDiff, sliceInfo.timestep, sliceInfo.plane);
+    doOperation = new DiffSliceOperation(image, doDiff, sliceInfo.timestep, sliceInfo.plane);
+  }
+  else
+  {
+    undoOperation = new DiffSliceOperation(image,
+                                           originalSlice,
+                                           dynamic_cast<SlicedGeometry3D *>(originalSlice->GetGeometry()),
+                                           sliceInfo.timestep,
+                                           sliceInfo.plane);
+    doOperation = new DiffSliceOperation(image,
+                                         extractor->GetOutput(),
+                                         dynamic_cast<SlicedGeometry3D *>(sliceInfo.slice->GetGeometry()),
+                                         sliceInfo.timestep,
+                                         sliceInfo.plane);
+  }
 
   // create an operation event for the undo stack
   OperationEvent *undoStackItem =
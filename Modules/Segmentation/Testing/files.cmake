@@ -11,6 +11,10 @@ set(MODULE_TESTS
 #  mitkToolManagerTest.cpp
   mitkToolManagerProviderTest.cpp
   mitkManualSegmentationToSurfaceFilterTest.cpp #new cpp unit style
+  mitkLiveWireCostFeatureCacheTest.cpp
+  mitkImageLiveWireContourModelFilterTest.cpp
+  mitkSparseSliceDiffTest.cpp
+  mitkParallelConnectedThresholdImageFilterTest.cpp
 )
 
 if(MITK_ENABLE_RENDERING_TESTING) #since mitkInteractionTestHelper is currently creating a vtkRenderWindow
@@ -0,0 +1,150 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include <mitkTestFixture.h>
+
+#include <mitkImageCast.h>
+#include <mitkImageLiveWireContourModelFilter.h>
+
+#include <itkImageRegionIteratorWithIndex.h>
+
+#include <random>
+
+class mitkImageLiveWireContourModelFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageLiveWireContourModelFilterTestSuite);
+  MITK_TEST(ContourReachesEndPointOutsideOfInitialWindow);
+  MITK_TEST(MovedEndPointMatchesFreshFilter);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::ImageLiveWireContourModelFilter FilterType;
+
+  // larger than the initial search window of the live wire (64 pixels around the start point)
+  static const unsigned int ImageSize = 400;
+
+  mitk::Image::Pointer m_Image;
+
+  mitk::Point3D MakePoint(double x, double y)
+  {
+    mitk::Point3D point;
+    point[0] = x;
+    point[1] = y;
+    point[2] = 0.0;
+    return point;
+  }
+
+  mitk::ContourModel::Pointer ComputeContour(FilterType *filter, const mitk::Point3D &start, const mitk::Point3D &end)
+  {
+    filter->SetStartPoint(start);
+    filter->SetEndPoint(end);
+    filter->Update();
+    return filter->GetOutput();
+  }
+
+  mitk::ContourModel::Pointer ComputeContourWithFreshFilter(const mitk::Point3D &start, const mitk::Point3D &end)
+  {
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(m_Image);
+    return this->ComputeContour(filter, start, end);
+  }
+
+  void AssertContourConnects(const mitk::ContourModel *contour, const mitk::Point3D &start, const mitk::Point3D &end)
+  {
+    CPPUNIT_ASSERT(contour->GetNumberOfVertices() > 1);
+    CPPUNIT_ASSERT(mitk::Equal(start, contour->GetVertexAt(0)->Coordinates));
+    CPPUNIT_ASSERT(mitk::Equal(end, contour->GetVertexAt(contour->GetNumberOfVertices() - 1)->Coordinates));
+  }
+
+  void AssertEqualContours(const mitk::ContourModel *expected, const mitk::ContourModel *actual)
+  {
+    CPPUNIT_ASSERT_EQUAL(expected->GetNumberOfVertices(), actual->GetNumberOfVertices());
+    for (int i = 0; i < expected->GetNumberOfVertices(); ++i)
+    {
+      CPPUNIT_ASSERT(mitk::Equal(expected->GetVertexAt(i)->Coordinates, actual->GetVertexAt(i)->Coordinates));
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    typedef itk::Image<float, 2> ImageType;
+
+    ImageType::Pointer image = ImageType::New();
+    ImageType::SizeType size;
+    size.Fill(ImageSize);
+    image->SetRegions(size);
+    image->Allocate();
+
+    // bright disk on a noisy background, the noise avoids paths of equal costs
+    std::mt19937 generator(4711);
+    std::uniform_real_distribution<float> noise(0.0f, 20.0f);
+    for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+    {
+      const double dx = it.GetIndex()[0] - 200.0;
+      const double dy = it.GetIndex()[1] - 200.0;
+      it.Set((dx * dx + dy * dy < 120.0 * 120.0 ? 200.0f : 10.0f) + noise(generator));
+    }
+
+    mitk::CastToMitkImage(image, m_Image);
+  }
+
+  void tearDown() override { m_Image = nullptr; }
+
+  void ContourReachesEndPointOutsideOfInitialWindow()
+  {
+    const mitk::Point3D start = MakePoint(200, 80);
+
+    // 100 pixels and 300 pixels from the start point, the window has to grow once respectively up to the image size
+    for (const auto &end : {MakePoint(300, 110), MakePoint(210, 380), MakePoint(20, 80)})
+    {
+      this->AssertContourConnects(this->ComputeContourWithFreshFilter(start, end), start, end);
+    }
+  }
+
+  void MovedEndPointMatchesFreshFilter()
+  {
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(m_Image);
+
+    const mitk::Point3D start = MakePoint(200, 80);
+
+    // the end point is moved around the start point like during the interaction, the window grows and shrinks again
+    for (const auto &end : {MakePoint(210, 85),
+                            MakePoint(230, 95),
+                            MakePoint(260, 100),
+                            MakePoint(320, 130),
+                            MakePoint(300, 120),
+                            MakePoint(340, 250),
+                            MakePoint(230, 95),
+                            MakePoint(200, 80)})
+    {
+      mitk::ContourModel::Pointer expected = this->ComputeContourWithFreshFilter(start, end);
+      mitk::ContourModel::Pointer actual = this->ComputeContour(filter, start, end);
+      this->AssertEqualContours(expected, actual);
+    }
+
+    // a new start point
+    const mitk::Point3D newStart = MakePoint(80, 200);
+    const mitk::Point3D end = MakePoint(200, 320);
+    mitk::ContourModel::Pointer actual = this->ComputeContour(filter, newStart, end);
+    this->AssertContourConnects(actual, newStart, end);
+    this->AssertEqualContours(this->ComputeContourWithFreshFilter(newStart, end), actual);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageLiveWireContourModelFilter)
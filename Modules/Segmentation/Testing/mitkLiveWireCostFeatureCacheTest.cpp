@@ -0,0 +1,160 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include <mitkTestFixture.h>
+
+#include <mitkImageCast.h>
+#include <mitkLiveWireCostFeatureCache.h>
+
+#include <itkImageRegionIteratorWithIndex.h>
+
+class mitkLiveWireCostFeatureCacheTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLiveWireCostFeatureCacheTestSuite);
+  MITK_TEST(FeaturesAreComputedOnceAndCached);
+  MITK_TEST(PrefetchedFeaturesAreReused);
+  MITK_TEST(FeaturesOfModifiedImageAreNotReused);
+  MITK_TEST(LeastRecentlyUsedSliceIsEvicted);
+  MITK_TEST(CostFunctionUsesPrecomputedFeatures);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::LiveWireCostFeatureCache CacheType;
+
+  mitk::Image::Pointer m_ReferenceImage;
+  mitk::Image::Pointer m_Slice;
+
+  template <unsigned int VDimension>
+  mitk::Image::Pointer CreateImage()
+  {
+    typedef itk::Image<float, VDimension> ImageType;
+
+    typename ImageType::Pointer image = ImageType::New();
+    typename ImageType::SizeType size;
+    size.Fill(32);
+    image->SetRegions(size);
+    image->Allocate();
+
+    // bright square in the middle of each slice
+    for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+    {
+      const auto &index = it.GetIndex();
+      it.Set(index[0] > 8 && index[0] < 24 && index[1] > 8 && index[1] < 24 ? 200.0f : 10.0f);
+    }
+
+    mitk::Image::Pointer result;
+    mitk::CastToMitkImage(image, result);
+    return result;
+  }
+
+  CacheType::SliceKey CreateKey(unsigned int sliceIndex)
+  {
+    mitk::PlaneGeometry::Pointer plane = mitk::PlaneGeometry::New();
+    plane->InitializeStandardPlane(m_ReferenceImage->GetGeometry(), mitk::PlaneGeometry::Axial, sliceIndex);
+    return CacheType::SliceKey(m_ReferenceImage, plane, 0, 0);
+  }
+
+public:
+  void setUp() override
+  {
+    m_ReferenceImage = this->CreateImage<3>();
+    m_Slice = this->CreateImage<2>();
+  }
+
+  void tearDown() override
+  {
+    m_ReferenceImage = nullptr;
+    m_Slice = nullptr;
+  }
+
+  void FeaturesAreComputedOnceAndCached()
+  {
+    CacheType cache;
+    auto features = cache.GetFeatures(this->CreateKey(5), m_Slice);
+
+    CPPUNIT_ASSERT_MESSAGE("Features are computed", nullptr != features);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), cache.GetNumberOfCachedSlices());
+    CPPUNIT_ASSERT_MESSAGE("Features are taken from the cache",
+                           features == cache.GetFeatures(this->CreateKey(5), nullptr));
+
+    mitk::ImageLiveWireContourModelFilter::InternalImageType::Pointer itkSlice;
+    mitk::CastToItkImage(m_Slice, itkSlice);
+    auto reference = mitk::ImageLiveWireContourModelFilter::CostFunctionType::ComputeCostFeatures(itkSlice);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(reference->m_GradientMax, features->m_GradientMax, mitk::eps);
+  }
+
+  void PrefetchedFeaturesAreReused()
+  {
+    CacheType cache;
+    CPPUNIT_ASSERT(!cache.Contains(this->CreateKey(5)));
+
+    cache.Prefetch(this->CreateKey(5), m_Slice);
+    CPPUNIT_ASSERT(cache.Contains(this->CreateKey(5)));
+
+    cache.WaitUntilIdle();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), cache.GetNumberOfCachedSlices());
+    CPPUNIT_ASSERT_MESSAGE("Prefetched features are returned without a slice",
+                           nullptr != cache.GetFeatures(this->CreateKey(5), nullptr));
+    CPPUNIT_ASSERT(!cache.Contains(this->CreateKey(6)));
+  }
+
+  void FeaturesOfModifiedImageAreNotReused()
+  {
+    CacheType cache;
+    cache.GetFeatures(this->CreateKey(5), m_Slice);
+
+    m_ReferenceImage->Modified();
+
+    CPPUNIT_ASSERT(!cache.Contains(this->CreateKey(5)));
+    CPPUNIT_ASSERT(nullptr == cache.GetFeatures(this->CreateKey(5), nullptr));
+  }
+
+  void LeastRecentlyUsedSliceIsEvicted()
+  {
+    CacheType cache;
+    cache.SetCapacity(2);
+
+    cache.GetFeatures(this->CreateKey(1), m_Slice);
+    cache.GetFeatures(this->CreateKey(2), m_Slice);
+    cache.GetFeatures(this->CreateKey(1), nullptr);
+    cache.GetFeatures(this->CreateKey(3), m_Slice);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), cache.GetNumberOfCachedSlices());
+    CPPUNIT_ASSERT(cache.Contains(this->CreateKey(1)));
+    CPPUNIT_ASSERT(!cache.Contains(this->CreateKey(2)));
+    CPPUNIT_ASSERT(cache.Contains(this->CreateKey(3)));
+  }
+
+  void CostFunctionUsesPrecomputedFeatures()
+  {
+    CacheType cache;
+    auto features = cache.GetFeatures(this->CreateKey(5), m_Slice);
+
+    mitk::ImageLiveWireContourModelFilter::InternalImageType::Pointer itkSlice;
+    mitk::CastToItkImage(m_Slice, itkSlice);
+
+    auto costFunction = mitk::ImageLiveWireContourModelFilter::CostFunctionType::New();
+    costFunction->SetImage(itkSlice);
+    costFunction->SetCostFeatures(features);
+    costFunction->Initialize();
+
+    CPPUNIT_ASSERT(costFunction->GetGradientMagnitudeImage() == features->m_GradientMagnitudeImage.GetPointer());
+    CPPUNIT_ASSERT(costFunction->GetEdgeImage() == features->m_EdgeImage.GetPointer());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLiveWireCostFeatureCache)
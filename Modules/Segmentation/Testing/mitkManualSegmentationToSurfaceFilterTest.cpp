@@ -20,6 +20,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkTestingConfig.h>
 #include <mitkTestingMacros.h>
 
+#include <vtkPolyData.h>
+
 class mitkManualSegmentationToSurfaceFilterTestSuite : public mitk::TestFixture
 {
   CPPUNIT_TEST_SUITE(mitkManualSegmentationToSurfaceFilterTestSuite);
@@ -35,6 +37,9 @@ class mitkManualSegmentationToSurfaceFilterTestSuite : public mitk::TestFixture
   MITK_PARAMETERIZED_TEST_2(Update_BallBinaryAndSmooth_OutputEqualsReference,
                             "BallBinary30x30x30.nrrd",
                             "BallBinary30x30x30SmoothReference.vtp");
+  MITK_PARAMETERIZED_TEST_2(Update_BallBinaryInSlabs_OutputEqualsWholeVolume,
+                            "BallBinary30x30x30.nrrd",
+                            "BallBinary30x30x30SmoothReference.vtp");
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -86,5 +91,41 @@ public:
 
     MITK_ASSERT_EQUAL(computedOutput, m_ReferenceSurface, "Computed equals the reference?");
   }
+
+  void Update_BallBinaryInSlabs_OutputEqualsWholeVolume()
+  {
+    auto setUpFilter = [](mitk::ManualSegmentationToSurfaceFilter *filter) {
+      filter->MedianFilter3DOn();
+      filter->SetGaussianStandardDeviation(1.5);
+      filter->InterpolationOn();
+      filter->UseGaussianImageSmoothOn();
+      filter->SetThreshold(1);
+    };
+
+    setUpFilter(m_Filter);
+    m_Filter->Update();
+    vtkPolyData *wholeVolumeOutput = m_Filter->GetOutput()->GetVtkPolyData();
+
+    // a limit of one byte results in slabs of a single slice
+    mitk::ManualSegmentationToSurfaceFilter::Pointer slabFilter = mitk::ManualSegmentationToSurfaceFilter::New();
+    slabFilter->SetInput(m_Filter->GetInput());
+    setUpFilter(slabFilter);
+    slabFilter->SetMemoryLimit(1);
+    slabFilter->SetNumberOfThreads(2);
+    slabFilter->Update();
+    vtkPolyData *slabOutput = slabFilter->GetOutput()->GetVtkPolyData();
+
+    // the slab surfaces are stitched without additional or missing vertices
+    CPPUNIT_ASSERT(wholeVolumeOutput->GetNumberOfPoints() > 0);
+    CPPUNIT_ASSERT_EQUAL(wholeVolumeOutput->GetNumberOfPoints(), slabOutput->GetNumberOfPoints());
+    CPPUNIT_ASSERT_EQUAL(wholeVolumeOutput->GetNumberOfCells(), slabOutput->GetNumberOfCells());
+
+    double wholeVolumeBounds[6];
+    double slabBounds[6];
+    wholeVolumeOutput->GetBounds(wholeVolumeBounds);
+    slabOutput->GetBounds(slabBounds);
+    for (unsigned int i = 0; i < 6; ++i)
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(wholeVolumeBounds[i], slabBounds[i], mitk::eps);
+  }
 };
 MITK_TEST_SUITE_REGISTRATION(mitkManualSegmentationToSurfaceFilter)
@@ -0,0 +1,220 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <itkBinaryThresholdImageFilter.h>
+#include <itkConnectedAdaptiveThresholdImageFilter.h>
+#include <itkConnectedThresholdImageFilter.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkParallelConnectedThresholdImageFilter.h>
+
+#include <random>
+
+class mitkParallelConnectedThresholdImageFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkParallelConnectedThresholdImageFilterTestSuite);
+  MITK_TEST(Update_FaceConnectivity_EqualsConnectedThresholdImageFilter);
+  MITK_TEST(Update_FullConnectivity_EqualsConnectedThresholdImageFilter);
+  MITK_TEST(Update_WidenedThresholds_IncrementalResultEqualsFullResult);
+  MITK_TEST(Update_NarrowedThresholds_IncrementalResultEqualsFullResult);
+  MITK_TEST(Update_MaximumNumberOfVoxels_StopsGrowing);
+  MITK_TEST(Update_AdaptiveThreshold_StatesEqualConnectedThresholdImageFilter);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<short, 3> ImageType;
+  typedef itk::Image<unsigned short, 3> OutputImageType;
+  typedef itk::ParallelConnectedThresholdImageFilter<ImageType, OutputImageType> ParallelFilterType;
+  typedef itk::ConnectedThresholdImageFilter<ImageType, OutputImageType> ReferenceFilterType;
+
+  ImageType::Pointer m_Image;
+  ImageType::IndexType m_Seed;
+
+  /** Counts the voxels that differ in being zero */
+  template <typename TImage, typename TOtherImage>
+  static unsigned int CountDifferences(const TImage *image, const TOtherImage *other)
+  {
+    itk::ImageRegionConstIterator<TImage> it(image, image->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<TOtherImage> otherIt(other, other->GetLargestPossibleRegion());
+    unsigned int differences = 0;
+    for (; !it.IsAtEnd(); ++it, ++otherIt)
+    {
+      if ((it.Get() != 0) != (otherIt.Get() != 0))
+        ++differences;
+    }
+    return differences;
+  }
+
+  static unsigned int CountVoxels(const OutputImageType *image)
+  {
+    itk::ImageRegionConstIterator<OutputImageType> it(image, image->GetLargestPossibleRegion());
+    unsigned int count = 0;
+    for (; !it.IsAtEnd(); ++it)
+    {
+      if (it.Get() != 0)
+        ++count;
+    }
+    return count;
+  }
+
+  OutputImageType::Pointer GrowReference(short lower, short upper, bool fullyConnected)
+  {
+    ReferenceFilterType::Pointer filter = ReferenceFilterType::New();
+    filter->SetInput(m_Image);
+    filter->AddSeed(m_Seed);
+    filter->SetLower(lower);
+    filter->SetUpper(upper);
+    if (fullyConnected)
+      filter->SetConnectivity(ReferenceFilterType::FullConnectivity);
+    filter->Update();
+    return filter->GetOutput();
+  }
+
+  ParallelFilterType::Pointer CreateParallelFilter(short lower, short upper)
+  {
+    ParallelFilterType::Pointer filter = ParallelFilterType::New();
+    filter->SetInput(m_Image);
+    filter->AddSeed(m_Seed);
+    filter->SetLower(lower);
+    filter->SetUpper(upper);
+    filter->SetNumberOfThreads(4);
+    return filter;
+  }
+
+public:
+  void setUp() override
+  {
+    // noise, in which the region around the seed percolates through most of the volume
+    m_Image = ImageType::New();
+    ImageType::SizeType size;
+    size.Fill(96);
+    m_Image->SetRegions(size);
+    m_Image->Allocate();
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<short> distribution(0, 99);
+    itk::ImageRegionIterator<ImageType> it(m_Image, m_Image->GetLargestPossibleRegion());
+    for (; !it.IsAtEnd(); ++it)
+      it.Set(distribution(generator));
+
+    m_Seed.Fill(48);
+    m_Image->SetPixel(m_Seed, 50);
+  }
+
+  void tearDown() override { m_Image = nullptr; }
+
+  void Update_FaceConnectivity_EqualsConnectedThresholdImageFilter()
+  {
+    ParallelFilterType::Pointer filter = this->CreateParallelFilter(20, 80);
+    filter->Update();
+
+    OutputImageType::Pointer reference = this->GrowReference(20, 80, false);
+    CPPUNIT_ASSERT(CountVoxels(reference) > 100000);
+    CPPUNIT_ASSERT_EQUAL(0u, CountDifferences(filter->GetOutput(), reference.GetPointer()));
+    CPPUNIT_ASSERT_EQUAL(static_cast<itk::SizeValueType>(CountVoxels(reference)), filter->GetNumberOfVoxels());
+    CPPUNIT_ASSERT(!filter->GetMaximumNumberOfVoxelsReached());
+  }
+
+  void Update_FullConnectivity_EqualsConnectedThresholdImageFilter()
+  {
+    ParallelFilterType::Pointer filter = this->CreateParallelFilter(40, 60);
+    filter->SetConnectivity(ParallelFilterType::FullConnectivity);
+    filter->Update();
+
+    OutputImageType::Pointer reference = this->GrowReference(40, 60, true);
+    CPPUNIT_ASSERT(CountVoxels(reference) > 1);
+    CPPUNIT_ASSERT_EQUAL(0u, CountDifferences(filter->GetOutput(), reference.GetPointer()));
+  }
+
+  void Update_WidenedThresholds_IncrementalResultEqualsFullResult()
+  {
+    ParallelFilterType::Pointer filter = this->CreateParallelFilter(40, 60);
+    filter->IncrementalUpdateOn();
+    filter->Update();
+
+    filter->SetLower(30);
+    filter->SetUpper(65);
+    filter->Update();
+    CPPUNIT_ASSERT_EQUAL(0u, CountDifferences(filter->GetOutput(), this->GrowReference(30, 65, false).GetPointer()));
+
+    filter->SetLower(20);
+    filter->SetUpper(80);
+    filter->Update();
+    OutputImageType::Pointer reference = this->GrowReference(20, 80, false);
+    CPPUNIT_ASSERT_EQUAL(0u, CountDifferences(filter->GetOutput(), reference.GetPointer()));
+    CPPUNIT_ASSERT_EQUAL(static_cast<itk::SizeValueType>(CountVoxels(reference)), filter->GetNumberOfVoxels());
+  }
+
+  void Update_NarrowedThresholds_IncrementalResultEqualsFullResult()
+  {
+    ParallelFilterType::Pointer filter = this->CreateParallelFilter(20, 80);
+    filter->IncrementalUpdateOn();
+    filter->Update();
+
+    filter->SetLower(30);
+    filter->Update();
+    CPPUNIT_ASSERT_EQUAL(0u, CountDifferences(filter->GetOutput(), this->GrowReference(30, 80, false).GetPointer()));
+  }
+
+  void Update_MaximumNumberOfVoxels_StopsGrowing()
+  {
+    ParallelFilterType::Pointer filter = this->CreateParallelFilter(20, 80);
+    filter->SetMaximumNumberOfVoxels(5000);
+    filter->Update();
+
+    const unsigned int numberOfVoxels = CountVoxels(filter->GetOutput());
+    CPPUNIT_ASSERT(filter->GetMaximumNumberOfVoxelsReached());
+    CPPUNIT_ASSERT(numberOfVoxels >= 5000);
+    CPPUNIT_ASSERT(numberOfVoxels < CountVoxels(this->GrowReference(20, 80, false)));
+    CPPUNIT_ASSERT_EQUAL(static_cast<itk::SizeValueType>(numberOfVoxels), filter->GetNumberOfVoxels());
+  }
+
+  void Update_AdaptiveThreshold_StatesEqualConnectedThresholdImageFilter()
+  {
+    typedef itk::ConnectedAdaptiveThresholdImageFilter<ImageType, ImageType> AdaptiveFilterType;
+    const short minTH = 20;
+    const short maxTH = 90;
+    const short seedValue = m_Image->GetPixel(m_Seed);
+
+    AdaptiveFilterType::Pointer filter = AdaptiveFilterType::New();
+    filter->SetInput(m_Image);
+    filter->AddSeed(m_Seed);
+    filter->SetLower(minTH);
+    filter->SetUpper(maxTH);
+    filter->SetGrowingDirectionIsUpwards(true);
+    filter->SetNumberOfThreads(4);
+    filter->Update();
+
+    // voxels are labeled with initializeValue - state, the voxels up to a state are connected at seed + state
+    const short initializeValue = maxTH - seedValue + 1;
+    for (short state = 1; state < initializeValue; state += 10)
+    {
+      typedef itk::BinaryThresholdImageFilter<ImageType, OutputImageType> ThresholdFilterType;
+      ThresholdFilterType::Pointer thresholdFilter = ThresholdFilterType::New();
+      thresholdFilter->SetInput(filter->GetOutput());
+      thresholdFilter->SetLowerThreshold(initializeValue - state);
+      thresholdFilter->SetUpperThreshold(initializeValue);
+      thresholdFilter->Update();
+
+      OutputImageType::Pointer reference = this->GrowReference(minTH, seedValue + state, false);
+      CPPUNIT_ASSERT_EQUAL(0u, CountDifferences(thresholdFilter->GetOutput(), reference.GetPointer()));
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkParallelConnectedThresholdImageFilter)
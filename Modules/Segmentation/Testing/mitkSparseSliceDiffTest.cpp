@@ -0,0 +1,210 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkCompressedImageContainer.h>
+#include <mitkDiffSliceOperation.h>
+#include <mitkImagePixelReadAccessor.h>
+#include <mitkImagePixelWriteAccessor.h>
+#include <mitkSparseSliceDiff.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <algorithm>
+#include <memory>
+
+class mitkSparseSliceDiffTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkSparseSliceDiffTestSuite);
+  MITK_TEST(TestComputeAndApply);
+  MITK_TEST(TestIncompatibleSlices);
+  MITK_TEST(TestOperationKeepsCurrentSlice);
+  MITK_TEST(TestUndoMemoryPerBrushStroke);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef unsigned short PixelType;
+
+  static itk::Index<2> GetIndex(unsigned int x, unsigned int y)
+  {
+    itk::Index<2> index;
+    index[0] = x;
+    index[1] = y;
+    return index;
+  }
+
+  static mitk::Image::Pointer CreateSlice(unsigned int size)
+  {
+    mitk::Image::Pointer slice = mitk::Image::New();
+    unsigned int dimensions[2] = {size, size};
+    slice->Initialize(mitk::MakeScalarPixelType<PixelType>(), 2, dimensions);
+
+    mitk::ImagePixelWriteAccessor<PixelType, 2> accessor(slice);
+    for (unsigned int y = 0; y < size; ++y)
+      for (unsigned int x = 0; x < size; ++x)
+        accessor.SetPixelByIndex(GetIndex(x, y), 0);
+
+    return slice;
+  }
+
+  static mitk::Image::Pointer CloneSlice(mitk::Image *slice)
+  {
+    mitk::Image::Pointer clone = slice->Clone();
+    return clone;
+  }
+
+  /** Paints a disc like the paintbrush tool does */
+  static void PaintDisc(mitk::Image *slice, int centerX, int centerY, int radius, PixelType value)
+  {
+    mitk::ImagePixelWriteAccessor<PixelType, 2> accessor(slice);
+    const int size = static_cast<int>(slice->GetDimension(0));
+    for (int y = std::max(0, centerY - radius); y <= std::min(size - 1, centerY + radius); ++y)
+    {
+      for (int x = std::max(0, centerX - radius); x <= std::min(size - 1, centerX + radius); ++x)
+      {
+        if ((x - centerX) * (x - centerX) + (y - centerY) * (y - centerY) <= radius * radius)
+          accessor.SetPixelByIndex(GetIndex(x, y), value);
+      }
+    }
+  }
+
+  static bool SlicesAreEqual(mitk::Image *slice, mitk::Image *other)
+  {
+    mitk::ImagePixelReadAccessor<PixelType, 2> accessor(slice);
+    mitk::ImagePixelReadAccessor<PixelType, 2> otherAccessor(other);
+    for (unsigned int y = 0; y < slice->GetDimension(1); ++y)
+    {
+      for (unsigned int x = 0; x < slice->GetDimension(0); ++x)
+      {
+        if (accessor.GetPixelByIndex(GetIndex(x, y)) != otherAccessor.GetPixelByIndex(GetIndex(x, y)))
+          return false;
+      }
+    }
+    return true;
+  }
+
+public:
+  void TestComputeAndApply()
+  {
+    mitk::Image::Pointer previousSlice = CreateSlice(64);
+    PaintDisc(previousSlice, 20, 20, 6, 1);
+    mitk::Image::Pointer slice = CloneSlice(previousSlice);
+    PaintDisc(slice, 24, 30, 5, 2);
+
+    mitk::SparseSliceDiff::Pointer undoDiff = mitk::SparseSliceDiff::New();
+    mitk::SparseSliceDiff::Pointer doDiff = mitk::SparseSliceDiff::New();
+    CPPUNIT_ASSERT(undoDiff->Compute(slice, previousSlice));
+    CPPUNIT_ASSERT(doDiff->Compute(previousSlice, slice));
+    CPPUNIT_ASSERT_EQUAL(doDiff->GetNumberOfVoxels(), undoDiff->GetNumberOfVoxels());
+
+    unsigned int minimumIndex[2];
+    unsigned int maximumIndex[2];
+    CPPUNIT_ASSERT(doDiff->GetBoundingBox(minimumIndex, maximumIndex));
+    CPPUNIT_ASSERT_EQUAL(19u, minimumIndex[0]);
+    CPPUNIT_ASSERT_EQUAL(25u, minimumIndex[1]);
+    CPPUNIT_ASSERT_EQUAL(29u, maximumIndex[0]);
+    CPPUNIT_ASSERT_EQUAL(35u, maximumIndex[1]);
+
+    // undo and redo on a copy of the volume slice
+    mitk::Image::Pointer current = CloneSlice(slice);
+    CPPUNIT_ASSERT(undoDiff->Apply(current));
+    CPPUNIT_ASSERT_MESSAGE("Undo does not restore the previous slice", SlicesAreEqual(current, previousSlice));
+    CPPUNIT_ASSERT(doDiff->Apply(current));
+    CPPUNIT_ASSERT_MESSAGE("Redo does not restore the slice", SlicesAreEqual(current, slice));
+
+    // identical slices result in an empty diff
+    CPPUNIT_ASSERT(doDiff->Compute(slice, slice));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), doDiff->GetNumberOfVoxels());
+    CPPUNIT_ASSERT(!doDiff->GetBoundingBox(minimumIndex, maximumIndex));
+  }
+
+  void TestIncompatibleSlices()
+  {
+    mitk::Image::Pointer slice = CreateSlice(64);
+    mitk::Image::Pointer otherSlice = CreateSlice(32);
+
+    mitk::SparseSliceDiff::Pointer diff = mitk::SparseSliceDiff::New();
+    CPPUNIT_ASSERT(!diff->Compute(slice, otherSlice));
+
+    CPPUNIT_ASSERT(diff->Compute(slice, slice));
+    CPPUNIT_ASSERT_MESSAGE("Diff is applied to a slice of different size", !diff->Apply(otherSlice));
+  }
+
+  void TestOperationKeepsCurrentSlice()
+  {
+    mitk::Image::Pointer previousSlice = CreateSlice(64);
+    mitk::Image::Pointer slice = CloneSlice(previousSlice);
+    PaintDisc(slice, 24, 30, 5, 2);
+
+    mitk::SparseSliceDiff::Pointer undoDiff = mitk::SparseSliceDiff::New();
+    CPPUNIT_ASSERT(undoDiff->Compute(slice, previousSlice));
+
+    mitk::Image::Pointer volume = mitk::Image::New();
+    unsigned int dimensions[3] = {64, 64, 4};
+    volume->Initialize(mitk::MakeScalarPixelType<PixelType>(), 3, dimensions);
+    mitk::PlaneGeometry::Pointer plane = mitk::PlaneGeometry::New();
+
+    // the destructor of the operation is protected, operations are deleted as mitk::Operation
+    auto *operation = new mitk::DiffSliceOperation(volume, undoDiff, 0, plane);
+    std::unique_ptr<mitk::Operation> operationGuard(operation);
+    CPPUNIT_ASSERT(operation->HasSliceDiff());
+
+    // the diff is applied to a copy, the current slice is still needed by the caller afterwards
+    mitk::Image::Pointer current = CloneSlice(slice);
+    mitk::Image::Pointer undoneSlice = operation->GetSlice(current);
+    CPPUNIT_ASSERT(undoneSlice.IsNotNull());
+    CPPUNIT_ASSERT_MESSAGE("Undo does not restore the previous slice", SlicesAreEqual(undoneSlice, previousSlice));
+    CPPUNIT_ASSERT_MESSAGE("Current slice is modified by the operation", SlicesAreEqual(current, slice));
+
+    CPPUNIT_ASSERT(operation->GetSlice(nullptr).IsNull());
+    CPPUNIT_ASSERT(operation->GetSlice(CreateSlice(32)).IsNull());
+  }
+
+  void TestUndoMemoryPerBrushStroke()
+  {
+    // a stroke of 20 brush positions on a large slice, each position is written back as one undo step
+    mitk::Image::Pointer slice = CreateSlice(1024);
+    std::size_t sparseMemory = 0;
+    std::size_t compressedMemory = 0;
+    const unsigned int numberOfSteps = 20;
+
+    for (unsigned int step = 0; step < numberOfSteps; ++step)
+    {
+      mitk::Image::Pointer previousSlice = CloneSlice(slice);
+      PaintDisc(slice, 100 + 8 * step, 200 + 3 * step, 10, 1);
+
+      mitk::SparseSliceDiff::Pointer undoDiff = mitk::SparseSliceDiff::New();
+      mitk::SparseSliceDiff::Pointer doDiff = mitk::SparseSliceDiff::New();
+      undoDiff->Compute(slice, previousSlice);
+      doDiff->Compute(previousSlice, slice);
+      sparseMemory += undoDiff->GetMemorySize() + doDiff->GetMemorySize();
+
+      mitk::CompressedImageContainer::Pointer undoContainer = mitk::CompressedImageContainer::New();
+      mitk::CompressedImageContainer::Pointer doContainer = mitk::CompressedImageContainer::New();
+      undoContainer->SetImage(previousSlice);
+      doContainer->SetImage(slice);
+      compressedMemory += undoContainer->GetMemorySize() + doContainer->GetMemorySize();
+    }
+
+    MITK_INFO << "Undo memory per brush step on a 1024x1024 slice: " << sparseMemory / numberOfSteps
+              << " bytes with sparse slice diffs, " << compressedMemory / numberOfSteps
+              << " bytes with compressed slices";
+
+    CPPUNIT_ASSERT_MESSAGE("Sparse slice diffs need more memory than compressed slices",
+                           sparseMemory < compressedMemory);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkSparseSliceDiff)
@@ -141,6 +141,20 @@ QmitkSlicesInterpolator::QmitkSlicesInterpolator(QWidget *parent, const char * /
   command2->SetCallbackFunction(this, &QmitkSlicesInterpolator::OnSurfaceInterpolationInfoChanged);
   SurfaceInterpolationInfoChangedObserverTag = m_SurfaceInterpolator->AddObserver(itk::ModifiedEvent(), command2);
 
+  itk::ReceptorMemberCommand<QmitkSlicesInterpolator>::Pointer command3 =
+    itk::ReceptorMemberCommand<QmitkSlicesInterpolator>::New();
+  command3->SetCallbackFunction(this, &QmitkSlicesInterpolator::OnSurfaceInterpolationFinishedEvent);
+  SurfaceInterpolationFinishedObserverTag =
+    m_SurfaceInterpolator->AddObserver(mitk::SurfaceInterpolationFinishedEvent(), command3);
+
+  // Results of the background interpolation are applied in the GUI thread
+  m_SurfaceInterpolator->SetInterpolationReadyCallback([this]() {
+    QMetaObject::invokeMethod(this, "OnAsyncSurfaceInterpolationFinished", Qt::QueuedConnection);
+  });
+
+  // New contours only update the previous solution
+  m_SurfaceInterpolator->SetIncrementalInterpolation(true);
+
   // feedback node and its visualization properties
   m_FeedbackNode = mitk::DataNode::New();
   mitk::CoreObjectFactory::GetInstance()->SetDefaultProperties(m_FeedbackNode);
@@ -321,6 +335,9 @@ QmitkSlicesInterpolator::~QmitkSlicesInterpolator()
     Uninitialize();
   }
 
+  m_SurfaceInterpolator->SetInterpolationReadyCallback(nullptr);
+  m_SurfaceInterpolator->RemoveObserver(SurfaceInterpolationFinishedObserverTag);
+
   WaitForFutures();
 
   if (m_DataStorage.IsNotNull())
@@ -1215,13 +1232,24 @@ void QmitkSlicesInterpolator::OnSurfaceInterpolationInfoChanged(const itk::Event
 {
   if (m_3DInterpolationEnabled)
   {
-    if (m_Watcher.isRunning())
-      m_Watcher.waitForFinished();
-    m_Future = QtConcurrent::run(this, &QmitkSlicesInterpolator::Run3DInterpolation);
-    m_Watcher.setFuture(m_Future);
+    // Runs in the background and supersedes interpolations for the previous set of contours,
+    // so drawing contours is not blocked by a running interpolation
+    this->StartUpdateInterpolationTimer();
+    m_SurfaceInterpolator->InterpolateAsync();
   }
 }
 
+void QmitkSlicesInterpolator::OnSurfaceInterpolationFinishedEvent(const itk::EventObject & /*e*/)
+{
+  this->StopUpdateInterpolationTimer();
+  this->OnSurfaceInterpolationFinished();
+}
+
+void QmitkSlicesInterpolator::OnAsyncSurfaceInterpolationFinished()
+{
+  m_SurfaceInterpolator->ApplyInterpolationResult();
+}
+
 void QmitkSlicesInterpolator::SetCurrentContourListID()
 {
   // New ContourList = hide current interpolation
@@ -1333,6 +1361,8 @@ void QmitkSlicesInterpolator::OnSliceNavigationControllerDeleted(const itk::Obje
 
 void QmitkSlicesInterpolator::WaitForFutures()
 {
+  m_SurfaceInterpolator->WaitForInterpolation();
+
   if (m_Watcher.isRunning())
   {
     m_Watcher.waitForFinished();
@@ -121,6 +121,11 @@ public:
   */
   void OnSurfaceInterpolationInfoChanged(const itk::EventObject &);
 
+  /**
+    Just public because it is called by itk::Commands. You should not need to call this.
+  */
+  void OnSurfaceInterpolationFinishedEvent(const itk::EventObject &);
+
   /**
    * @brief Set the visibility of the 3d interpolation
    */
@@ -194,6 +199,8 @@ protected slots:
 
   void OnSurfaceInterpolationFinished();
 
+  void OnAsyncSurfaceInterpolationFinished();
+
   void StartUpdateInterpolationTimer();
 
   void StopUpdateInterpolationTimer();
@@ -256,6 +263,7 @@ private:
 
   unsigned int InterpolationInfoChangedObserverTag;
   unsigned int SurfaceInterpolationInfoChangedObserverTag;
+  unsigned int SurfaceInterpolationFinishedObserverTag;
 
   QGroupBox *m_GroupBoxEnableExclusiveInterpolationMode;
   QComboBox *m_CmbInterpolation;
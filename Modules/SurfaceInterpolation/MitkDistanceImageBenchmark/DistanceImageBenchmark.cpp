@@ -0,0 +1,189 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkCommandLineParser.h>
+#include <mitkCommon.h>
+#include <mitkCreateDistanceImageFromSurfaceFilter.h>
+#include <mitkExceptionMacro.h>
+#include <mitkImageCast.h>
+#include <mitkRunInParallel.h>
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDoubleArray.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include <itkMath.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+typedef mitk::CreateDistanceImageFromSurfaceFilter FilterType;
+
+struct BenchmarkParameters
+{
+  std::vector<unsigned int> contours;
+  unsigned int maxLinearContours;
+  unsigned int threads;
+};
+
+const unsigned int POINTS_PER_CONTOUR = 12;
+const double CONTOUR_GAP = 2.0; // mm along z
+
+BenchmarkParameters parseInput(int argc, char* argv[])
+{
+  mitkCommandLineParser parser;
+  parser.setCategory("MITK-SurfaceInterpolation");
+  parser.setTitle("Mitk Distance Image Benchmark");
+  parser.setDescription("Measures the run time of mitk::CreateDistanceImageFromSurfaceFilter for the contours of a synthetic tube with the linear and the compactly supported kernel.");
+  parser.setContributor("MBI, DKFZ");
+
+  parser.setArgumentPrefix("--", "-");
+
+  parser.beginGroup("Optional parameters");
+  parser.addArgument(
+    "contours", "c", mitkCommandLineParser::Int,
+    "Contours", "number of contours (default: 10, 50, 100 and 500)");
+  parser.addArgument(
+    "maxLinearContours", "l", mitkCommandLineParser::Int,
+    "Maximum contours of the linear kernel", "the dense solve of the linear kernel is cubic in the number of contour points, it is skipped for more contours (default: 50)");
+  parser.addArgument(
+    "threads", "t", mitkCommandLineParser::Int,
+    "Threads", "number of threads of the filter (default: global default of ITK)");
+  parser.endGroup();
+
+  std::map<std::string, us::Any> parsedArgs = parser.parseArguments(argc, argv);
+  if (parsedArgs.size() == 0 && argc > 1)
+    exit(-1);
+
+  BenchmarkParameters input;
+  if (parsedArgs.count("contours"))
+    input.contours.push_back(us::any_cast<int>(parsedArgs["contours"]));
+  else
+    input.contours = { 10, 50, 100, 500 };
+
+  input.maxLinearContours = parsedArgs.count("maxLinearContours") ? us::any_cast<int>(parsedArgs["maxLinearContours"]) : 50;
+  input.threads = parsedArgs.count("threads") ? us::any_cast<int>(parsedArgs["threads"]) : mitk::GetDefaultNumberOfThreads();
+
+  return input;
+}
+
+double GetRadius(double z)
+{
+  return 8.0 + 2.0 * std::sin(z / 7.0);
+}
+
+// a circular contour of a tube along z, the normals are stored per point in the cell data
+// like mitk::ComputeContourSetNormalsFilter does it
+mitk::Surface::Pointer CreateContour(double z)
+{
+  auto points = vtkSmartPointer<vtkPoints>::New();
+  auto normals = vtkSmartPointer<vtkDoubleArray>::New();
+  normals->SetNumberOfComponents(3);
+  auto polygon = vtkSmartPointer<vtkCellArray>::New();
+  polygon->InsertNextCell(POINTS_PER_CONTOUR);
+
+  for (unsigned int i = 0; i < POINTS_PER_CONTOUR; ++i)
+  {
+    const double angle = 2.0 * itk::Math::pi * i / POINTS_PER_CONTOUR;
+    polygon->InsertCellPoint(points->InsertNextPoint(GetRadius(z) * std::cos(angle), GetRadius(z) * std::sin(angle), z));
+    normals->InsertNextTuple3(std::cos(angle), std::sin(angle), 0.0);
+  }
+
+  auto polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->SetPoints(points);
+  polyData->SetPolys(polygon);
+  polyData->GetCellData()->SetNormals(normals);
+
+  mitk::Surface::Pointer contour = mitk::Surface::New();
+  contour->SetVtkPolyData(polyData);
+  return contour;
+}
+
+FilterType::Pointer CreateFilter(unsigned int numberOfContours, FilterType::RBFKernelType kernel, unsigned int threads)
+{
+  itk::ImageBase<3>::Pointer referenceImage = itk::ImageBase<3>::New();
+  itk::ImageBase<3>::RegionType region;
+  region.SetSize(0, 32);
+  region.SetSize(1, 32);
+  region.SetSize(2, static_cast<itk::SizeValueType>(numberOfContours * CONTOUR_GAP) + 10);
+  referenceImage->SetRegions(region);
+  itk::ImageBase<3>::PointType origin;
+  origin[0] = -16.0;
+  origin[1] = -16.0;
+  origin[2] = -5.0;
+  referenceImage->SetOrigin(origin);
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetReferenceImage(referenceImage);
+  for (unsigned int i = 0; i < numberOfContours; ++i)
+  {
+    filter->SetInput(i, CreateContour(i * CONTOUR_GAP));
+  }
+
+  filter->SetSupportRadius(3.0 * CONTOUR_GAP);
+  filter->SetRBFKernel(kernel);
+  filter->SetNumberOfThreads(threads);
+  return filter;
+}
+
+// the distance image is negative inside the surface, which contains the axis of the tube
+bool IsAxisInside(mitk::Image* distanceImage, double z)
+{
+  FilterType::DistanceImageType::Pointer itkImage;
+  mitk::CastToItkImage(distanceImage, itkImage);
+
+  FilterType::DistanceImageType::PointType point;
+  point[0] = 0.0;
+  point[1] = 0.0;
+  point[2] = z;
+  FilterType::DistanceImageType::IndexType index;
+  return itkImage->TransformPhysicalPointToIndex(point, index) && itkImage->GetPixel(index) < 0.0;
+}
+
+double Run(unsigned int numberOfContours, FilterType::RBFKernelType kernel, unsigned int threads)
+{
+  auto filter = CreateFilter(numberOfContours, kernel, threads);
+
+  auto begin = std::chrono::high_resolution_clock::now();
+  filter->Update();
+  const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+
+  if (!IsAxisInside(filter->GetOutput(), numberOfContours * CONTOUR_GAP / 2))
+    mitkThrow() << "The axis of the tube is not inside for " << numberOfContours << " contours.";
+
+  return seconds;
+}
+
+int main(int argc, char* argv[])
+{
+  auto input = parseInput(argc, argv);
+
+  for (unsigned int numberOfContours : input.contours)
+  {
+    std::cout << numberOfContours << " contours, " << input.threads << " threads:" << std::endl;
+    std::cout << "  compact kernel: " << Run(numberOfContours, FilterType::CompactKernel, input.threads) << " s" << std::endl;
+
+    if (numberOfContours <= input.maxLinearContours)
+      std::cout << "  linear kernel: " << Run(numberOfContours, FilterType::LinearKernel, input.threads) << " s" << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,191 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkCreateDistanceImageFromSurfaceFilter.h>
+#include <mitkImageCast.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDoubleArray.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include <itkMath.h>
+
+#include <cmath>
+
+class mitkCreateDistanceImageFromSurfaceFilterKernelTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkCreateDistanceImageFromSurfaceFilterKernelTestSuite);
+  MITK_TEST(TestResultDoesNotDependOnNumberOfThreads);
+  MITK_TEST(TestCompactKernelSeparatesInsideAndOutside);
+  MITK_TEST(TestWarmStartYieldsSameResult);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::CreateDistanceImageFromSurfaceFilter FilterType;
+
+  static const unsigned int NumberOfPointsPerContour = 12;
+
+  /** Distance between two contours along z in mm */
+  static constexpr double ContourGap = 2.0;
+
+  static double GetRadius(double z) { return 8.0 + 2.0 * std::sin(z / 7.0); }
+
+  /** Creates a circular contour of a tube along z, the normals are stored per point in the cell data
+   * like mitk::ComputeContourSetNormalsFilter does it. */
+  mitk::Surface::Pointer CreateContour(double z)
+  {
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    auto normals = vtkSmartPointer<vtkDoubleArray>::New();
+    normals->SetNumberOfComponents(3);
+    auto polygon = vtkSmartPointer<vtkCellArray>::New();
+    polygon->InsertNextCell(NumberOfPointsPerContour);
+
+    for (unsigned int i = 0; i < NumberOfPointsPerContour; ++i)
+    {
+      const double angle = 2.0 * itk::Math::pi * i / NumberOfPointsPerContour;
+      polygon->InsertCellPoint(points->InsertNextPoint(GetRadius(z) * std::cos(angle), GetRadius(z) * std::sin(angle), z));
+      normals->InsertNextTuple3(std::cos(angle), std::sin(angle), 0.0);
+    }
+
+    auto polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->SetPoints(points);
+    polyData->SetPolys(polygon);
+    polyData->GetCellData()->SetNormals(normals);
+
+    mitk::Surface::Pointer contour = mitk::Surface::New();
+    contour->SetVtkPolyData(polyData);
+    return contour;
+  }
+
+  FilterType::Pointer CreateFilter(unsigned int numberOfContours)
+  {
+    itk::ImageBase<3>::Pointer referenceImage = itk::ImageBase<3>::New();
+    itk::ImageBase<3>::RegionType region;
+    region.SetSize(0, 32);
+    region.SetSize(1, 32);
+    region.SetSize(2, static_cast<itk::SizeValueType>(numberOfContours * ContourGap) + 10);
+    referenceImage->SetRegions(region);
+    itk::ImageBase<3>::PointType origin;
+    origin[0] = -16.0;
+    origin[1] = -16.0;
+    origin[2] = -5.0;
+    referenceImage->SetOrigin(origin);
+
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetReferenceImage(referenceImage);
+    for (unsigned int i = 0; i < numberOfContours; ++i)
+    {
+      filter->SetInput(i, this->CreateContour(i * ContourGap));
+    }
+
+    filter->SetSupportRadius(3.0 * ContourGap);
+    return filter;
+  }
+
+  double GetValueOnAxis(mitk::Image *distanceImage, double z)
+  {
+    FilterType::DistanceImageType::Pointer itkImage;
+    mitk::CastToItkImage(distanceImage, itkImage);
+
+    FilterType::DistanceImageType::PointType point;
+    point[0] = 0.0;
+    point[1] = 0.0;
+    point[2] = z;
+    FilterType::DistanceImageType::IndexType index;
+    CPPUNIT_ASSERT(itkImage->TransformPhysicalPointToIndex(point, index));
+    return itkImage->GetPixel(index);
+  }
+
+  mitk::Image::Pointer Run(FilterType *filter)
+  {
+    filter->Update();
+    return filter->GetOutput()->Clone();
+  }
+
+public:
+  void TestResultDoesNotDependOnNumberOfThreads()
+  {
+    for (auto kernel : {FilterType::LinearKernel, FilterType::CompactKernel})
+    {
+      auto filter = this->CreateFilter(10);
+      filter->SetRBFKernel(kernel);
+      filter->SetNumberOfThreads(1);
+      auto reference = this->Run(filter);
+
+      filter = this->CreateFilter(10);
+      filter->SetRBFKernel(kernel);
+      filter->SetNumberOfThreads(4);
+      auto result = this->Run(filter);
+
+      CPPUNIT_ASSERT_MESSAGE("Distance image does not depend on the number of threads",
+                             mitk::Equal(*reference, *result, mitk::eps, true));
+    }
+  }
+
+  void TestCompactKernelSeparatesInsideAndOutside()
+  {
+    auto filter = this->CreateFilter(20);
+    filter->SetRBFKernel(FilterType::CompactKernel);
+    filter->Update();
+
+    CPPUNIT_ASSERT_MESSAGE("Axis of the tube is inside", this->GetValueOnAxis(filter->GetOutput(), 19.0) < 0.0);
+
+    // A point of the middle contour lies on the surface
+    FilterType::DistanceImageType::Pointer itkImage;
+    mitk::CastToItkImage(filter->GetOutput(), itkImage);
+    FilterType::DistanceImageType::PointType point;
+    point[0] = GetRadius(20.0);
+    point[1] = 0.0;
+    point[2] = 20.0;
+    FilterType::DistanceImageType::IndexType index;
+    CPPUNIT_ASSERT(itkImage->TransformPhysicalPointToIndex(point, index));
+    CPPUNIT_ASSERT_MESSAGE("Contour point lies within the narrow band",
+                           std::abs(itkImage->GetPixel(index)) <= 2.0 * filter->GetDistanceImageSpacing());
+  }
+
+  void TestWarmStartYieldsSameResult()
+  {
+    for (auto kernel : {FilterType::LinearKernel, FilterType::CompactKernel})
+    {
+      auto warmFilter = this->CreateFilter(11);
+      warmFilter->SetRBFKernel(kernel);
+      warmFilter->WarmStartOn();
+      warmFilter->Update();
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("First solve is direct", 0u, warmFilter->GetNumberOfSolverIterations());
+
+      // Move the last contour a little, all other contours keep their weights
+      warmFilter->SetInput(10, this->CreateContour(10 * ContourGap + 0.5));
+      auto warmResult = this->Run(warmFilter);
+
+      auto coldFilter = this->CreateFilter(11);
+      coldFilter->SetRBFKernel(kernel);
+      coldFilter->SetInput(10, this->CreateContour(10 * ContourGap + 0.5));
+      auto coldResult = this->Run(coldFilter);
+
+      MITK_INFO << "Warm started solve took " << warmFilter->GetNumberOfSolverIterations() << " iterations";
+
+      CPPUNIT_ASSERT_MESSAGE("Warm started solve yields the same distance image",
+                             mitk::Equal(*coldResult, *warmResult, 1e-6, true));
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkCreateDistanceImageFromSurfaceFilterKernel)
@@ -18,12 +18,18 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkTestFixture.h>
 #include <mitkTestingMacros.h>
 
+#include <itkCommand.h>
+
 #include <vtkDebugLeaks.h>
 #include <vtkRegularPolygonSource.h>
 
 #include "mitkImagePixelWriteAccessor.h"
 #include "mitkImageTimeSelector.h"
 
+#include <atomic>
+#include <cmath>
+#include <thread>
+
 class mitkSurfaceInterpolationControllerTestSuite : public mitk::TestFixture
 {
   CPPUNIT_TEST_SUITE(mitkSurfaceInterpolationControllerTestSuite);
@@ -45,10 +51,50 @@ class mitkSurfaceInterpolationControllerTestSuite : public mitk::TestFixture
 
   MITK_TEST(TestAddNewContour);
   MITK_TEST(TestRemoveContour);
+  MITK_TEST(TestInterpolateAsync);
   CPPUNIT_TEST_SUITE_END();
 
 private:
   mitk::SurfaceInterpolationController::Pointer m_Controller;
+  std::atomic<unsigned int> m_NumberOfFinishedEvents;
+  std::atomic<bool> m_FinishedEventInOtherThread;
+  std::thread::id m_TestThread;
+
+  void OnInterpolationFinished(const itk::EventObject &)
+  {
+    ++m_NumberOfFinishedEvents;
+    if (std::this_thread::get_id() != m_TestThread)
+      m_FinishedEventInOtherThread = true;
+  }
+
+  mitk::Surface::Pointer createCircularContour(double z)
+  {
+    double center[3] = {10.0, 10.0, z};
+    double normal[3] = {0.0, 0.0, 1.0};
+    vtkSmartPointer<vtkRegularPolygonSource> source = vtkSmartPointer<vtkRegularPolygonSource>::New();
+    source->SetNumberOfSides(20);
+    source->SetCenter(center);
+    source->SetRadius(4);
+    source->SetNormal(normal);
+    source->Update();
+    mitk::Surface::Pointer contour = mitk::Surface::New();
+    contour->SetVtkPolyData(source->GetOutput());
+    return contour;
+  }
+
+  bool BoundsAreEqual(mitk::Surface *surface1, mitk::Surface *surface2, double tolerance)
+  {
+    double bounds1[6];
+    double bounds2[6];
+    surface1->GetVtkPolyData()->GetBounds(bounds1);
+    surface2->GetVtkPolyData()->GetBounds(bounds2);
+    for (int i = 0; i < 6; ++i)
+    {
+      if (std::abs(bounds1[i] - bounds2[i]) > tolerance)
+        return false;
+    }
+    return true;
+  }
 
 public:
   mitk::Image::Pointer createImage(unsigned int *dimensions)
@@ -824,5 +870,70 @@ public:
     CPPUNIT_ASSERT_MESSAGE("Number of interpolation session not 0",
                            m_Controller->GetNumberOfInterpolationSessions() == 0);
   }
+
+  void TestInterpolateAsync()
+  {
+    unsigned int dimensions[] = {20, 20, 20};
+    mitk::Image::Pointer segmentation = createImage(dimensions);
+    {
+      mitk::ImagePixelWriteAccessor<unsigned char, 3> writeAccessor(segmentation);
+      std::fill_n(writeAccessor.GetData(), 20 * 20 * 20, 0);
+    }
+    m_Controller->SetCurrentInterpolationSession(segmentation);
+
+    m_Controller->AddNewContour(this->createCircularContour(4.0));
+    m_Controller->AddNewContour(this->createCircularContour(9.0));
+    m_Controller->AddNewContour(this->createCircularContour(14.0));
+
+    m_Controller->Interpolate();
+    mitk::Surface::Pointer reference = m_Controller->GetInterpolationResult();
+    CPPUNIT_ASSERT_MESSAGE("Synchronous interpolation failed!", reference.IsNotNull());
+
+    m_NumberOfFinishedEvents = 0;
+    m_FinishedEventInOtherThread = false;
+    m_TestThread = std::this_thread::get_id();
+    auto command = itk::ReceptorMemberCommand<mitkSurfaceInterpolationControllerTestSuite>::New();
+    command->SetCallbackFunction(this, &mitkSurfaceInterpolationControllerTestSuite::OnInterpolationFinished);
+    auto observerTag = m_Controller->AddObserver(mitk::SurfaceInterpolationFinishedEvent(), command);
+
+    // The background thread only reports the result, it is applied when the owner waits for it
+    std::atomic<unsigned int> numberOfReadyCalls(0);
+    m_Controller->SetInterpolationReadyCallback([&numberOfReadyCalls]() { ++numberOfReadyCalls; });
+
+    m_Controller->InterpolateAsync();
+    m_Controller->WaitForInterpolation();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Ready callback was not called!", 1u, numberOfReadyCalls.load());
+    CPPUNIT_ASSERT_MESSAGE("Interpolation is still running!", !m_Controller->IsInterpolationRunning());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Finished event was not invoked!", 1u, m_NumberOfFinishedEvents.load());
+
+    mitk::Surface::Pointer result = m_Controller->GetInterpolationResult();
+    CPPUNIT_ASSERT_MESSAGE("Background interpolation failed!", result.IsNotNull());
+    CPPUNIT_ASSERT_MESSAGE(
+      "Background interpolation differs from synchronous interpolation!",
+      mitk::Equal(*(reference->GetVtkPolyData()), *(result->GetVtkPolyData()), 0.000001, true));
+
+    // A request made while the previous one is running supersedes it
+    m_Controller->SetIncrementalInterpolation(true);
+    m_Controller->AddNewContour(this->createCircularContour(7.0));
+    m_Controller->InterpolateAsync();
+    m_Controller->AddNewContour(this->createCircularContour(11.0));
+    m_Controller->InterpolateAsync();
+    m_Controller->WaitForInterpolation();
+    m_Controller->RemoveObserver(observerTag);
+    m_Controller->SetInterpolationReadyCallback(nullptr);
+
+    CPPUNIT_ASSERT_MESSAGE("Wrong number of finished events!",
+                           m_NumberOfFinishedEvents >= 2 && m_NumberOfFinishedEvents <= 3);
+    CPPUNIT_ASSERT_MESSAGE("Finished event was invoked in the background thread!", !m_FinishedEventInOtherThread);
+    result = m_Controller->GetInterpolationResult();
+
+    m_Controller->Interpolate();
+    reference = m_Controller->GetInterpolationResult();
+    CPPUNIT_ASSERT_MESSAGE("Interpolation failed!", result.IsNotNull() && reference.IsNotNull());
+    CPPUNIT_ASSERT_MESSAGE("Incremental interpolation differs from synchronous interpolation!",
+                           this->BoundsAreEqual(reference, result, m_Controller->GetDistanceImageSpacing()));
+
+    m_Controller->RemoveInterpolationSession(segmentation);
+  }
 };
 MITK_TEST_SUITE_REGISTRATION(mitkSurfaceInterpolationController)
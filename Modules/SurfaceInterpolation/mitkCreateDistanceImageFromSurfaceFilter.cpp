@@ -16,6 +16,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkCreateDistanceImageFromSurfaceFilter.h"
 #include "mitkImageCast.h"
+#include "mitkRunInParallel.h"
 
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
@@ -24,9 +25,44 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "vtkSmartPointer.h"
 
 #include "itkImageRegionIteratorWithIndex.h"
-#include "itkNeighborhoodIterator.h"
 
-#include <queue>
+#include <Eigen/IterativeLinearSolvers>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <set>
+
+namespace
+{
+  /** Number of voxels or equations processed by a thread before it fetches the next chunk */
+  const std::size_t ChunkSize = 256;
+
+  /** Minimum number of candidates per thread for evaluating a front in parallel. Fronts near the seed
+   * and at the end of the narrow band are small, they are evaluated on the calling thread. */
+  const std::size_t MinimumCandidatesPerThread = 4 * ChunkSize;
+
+  std::size_t GetNumberOfChunks(std::size_t numberOfItems) { return (numberOfItems + ChunkSize - 1) / ChunkSize; }
+
+  /** Wendland's compactly supported function for r = distance / support radius in [0, 1) */
+  inline double Wendland(double r)
+  {
+    const double t = 1.0 - r;
+    const double t2 = t * t;
+    return t2 * t2 * (4.0 * r + 1.0);
+  }
+
+  /** Lexicographic order, used to eliminate duplicated contour points */
+  struct PointLess
+  {
+    bool operator()(const mitk::CreateDistanceImageFromSurfaceFilter::PointType &a,
+                    const mitk::CreateDistanceImageFromSurfaceFilter::PointType &b) const
+    {
+      return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+    }
+  };
+}
 
 void mitk::CreateDistanceImageFromSurfaceFilter::CreateEmptyDistanceImage()
 {
@@ -109,7 +145,16 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateEmptyDistanceImage()
 }
 
 mitk::CreateDistanceImageFromSurfaceFilter::CreateDistanceImageFromSurfaceFilter()
-  : m_DistanceImageSpacing(0.0), m_DistanceImageDefaultBufferValue(0.0)
+  : m_DistanceImageSpacing(0.0),
+    m_DistanceImageDefaultBufferValue(0.0),
+    m_RBFKernel(LinearKernel),
+    m_SupportRadius(0.0),
+    m_NarrowBandWidth(2.0),
+    m_NumberOfThreads(mitk::GetDefaultNumberOfThreads()),
+    m_WarmStart(false),
+    m_NumberOfSolverIterations(0),
+    m_NumberOfSurfaceCenters(0),
+    m_EffectiveSupportRadius(0.0)
 {
   m_DistanceImageVolume = 50000;
   this->m_UseProgressBar = false;
@@ -134,7 +179,7 @@ void mitk::CreateDistanceImageFromSurfaceFilter::GenerateData()
   if (this->m_UseProgressBar)
     mitk::ProgressBar::GetInstance()->Progress(1);
 
-  m_Weights = m_SolutionMatrix.partialPivLu().solve(m_FunctionValues);
+  this->SolveEquationSystem();
 
   if (this->m_UseProgressBar)
     mitk::ProgressBar::GetInstance()->Progress(2);
@@ -147,6 +192,9 @@ void mitk::CreateDistanceImageFromSurfaceFilter::GenerateData()
 
   m_Centers.clear();
   m_Normals.clear();
+  m_ContourCentroids.clear();
+  m_GridCellStart.clear();
+  m_GridCenterIds.clear();
 }
 
 void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
@@ -172,8 +220,12 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
   PointType currentPoint;
   PointType normal;
 
+  std::set<PointType, PointLess> existingCenters;
+
   for (unsigned int i = 0; i < numberOfInputs; i++)
   {
+    const std::size_t firstCenterOfContour = m_Centers.size();
+
     auto currentSurface = this->GetInput(i);
     polyData = currentSurface->GetVtkPolyData();
 
@@ -203,9 +255,7 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
 
         currentPoint.copy_in(p);
 
-        int count = std::count(m_Centers.begin(), m_Centers.end(), currentPoint);
-
-        if (count == 0)
+        if (existingCenters.insert(currentPoint).second)
         {
           double currentNormal[3];
           currentCellNormals->GetTuple(cell[j], currentNormal);
@@ -219,13 +269,65 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
 
       } // end for all points
     }   // end for all cells
-  }     // end for all outputs
+
+    // The centroids of the contours are used to estimate the support radius of the compact kernel
+    if (m_Centers.size() > firstCenterOfContour)
+    {
+      PointType centroid(0.0);
+      for (std::size_t j = firstCenterOfContour; j < m_Centers.size(); ++j)
+      {
+        centroid += m_Centers[j];
+      }
+      m_ContourCentroids.push_back(centroid / static_cast<double>(m_Centers.size() - firstCenterOfContour));
+    }
+  } // end for all outputs
+}
+
+template <typename TFunction>
+void mitk::CreateDistanceImageFromSurfaceFilter::ForEachCenterInSupport(const Eigen::Vector3d &p,
+                                                                        const TFunction &function) const
+{
+  const double squaredRadius = m_EffectiveSupportRadius * m_EffectiveSupportRadius;
+  const Eigen::Vector3d gridPosition = (p - m_GridOrigin) / m_EffectiveSupportRadius;
+
+  int first[3], last[3];
+  for (unsigned int dim = 0; dim < 3; ++dim)
+  {
+    const double cell = std::floor(gridPosition[dim]);
+    // points further than one cell away from the grid cannot be supported by any center
+    if (cell < -1.0 || cell > m_GridSize[dim])
+      return;
+
+    first[dim] = std::max(0, static_cast<int>(cell) - 1);
+    last[dim] = std::min(m_GridSize[dim] - 1, static_cast<int>(cell) + 1);
+  }
+
+  for (int z = first[2]; z <= last[2]; ++z)
+  {
+    for (int y = first[1]; y <= last[1]; ++y)
+    {
+      for (int x = first[0]; x <= last[0]; ++x)
+      {
+        const std::size_t cell = (static_cast<std::size_t>(z) * m_GridSize[1] + y) * m_GridSize[0] + x;
+        for (unsigned int k = m_GridCellStart[cell]; k < m_GridCellStart[cell + 1]; ++k)
+        {
+          const unsigned int id = m_GridCenterIds[k];
+          const double squaredDistance = (m_CenterMatrix.col(id) - p).squaredNorm();
+          if (squaredDistance < squaredRadius)
+          {
+            function(id, std::sqrt(squaredDistance) / m_EffectiveSupportRadius);
+          }
+        }
+      }
+    }
+  }
 }
 
 void mitk::CreateDistanceImageFromSurfaceFilter::CreateSolutionMatrixAndFunctionValues()
 {
   // For we can now calculate the exact size of the centers we initialize the data structures
   unsigned int numberOfCenters = m_Centers.size();
+  m_NumberOfSurfaceCenters = numberOfCenters;
   m_Centers.reserve(numberOfCenters * 3);
 
   m_FunctionValues.resize(numberOfCenters * 3);
@@ -268,26 +370,219 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateSolutionMatrixAndFunction
   // Now we have created all centers and all function values. Next step is to create the solution matrix
   numberOfCenters = m_Centers.size();
 
-  m_SolutionMatrix.resize(numberOfCenters, numberOfCenters);
+  m_CenterMatrix.resize(3, numberOfCenters);
+  for (unsigned int i = 0; i < numberOfCenters; i++)
+  {
+    m_CenterMatrix.col(i) = Eigen::Vector3d(m_Centers[i][0], m_Centers[i][1], m_Centers[i][2]);
+  }
 
   m_Weights.resize(numberOfCenters);
 
-  PointType p1;
-  PointType p2;
-  double norm;
+  if (m_RBFKernel == CompactKernel)
+  {
+    this->CreateCenterGrid();
+
+    // Each chunk of rows collects its own entries, so the matrix does not depend on the number of threads
+    std::vector<std::vector<Eigen::Triplet<double>>> chunkEntries(GetNumberOfChunks(numberOfCenters));
 
-  for (unsigned int i = 0; i < numberOfCenters; i++)
+    mitk::RunInParallel(m_NumberOfThreads, chunkEntries.size(), [&](std::size_t chunkId, std::size_t) {
+      const unsigned int end = std::min<std::size_t>(numberOfCenters, (chunkId + 1) * ChunkSize);
+      for (unsigned int i = chunkId * ChunkSize; i < end; i++)
+      {
+        this->ForEachCenterInSupport(m_CenterMatrix.col(i), [&](unsigned int j, double r) {
+          chunkEntries[chunkId].emplace_back(i, j, Wendland(r));
+        });
+      }
+    });
+
+    std::vector<Eigen::Triplet<double>> entries;
+    for (const auto &chunk : chunkEntries)
+    {
+      entries.insert(entries.end(), chunk.begin(), chunk.end());
+    }
+
+    m_SolutionMatrix.resize(0, 0);
+    m_SparseSolutionMatrix.resize(numberOfCenters, numberOfCenters);
+    m_SparseSolutionMatrix.setFromTriplets(entries.begin(), entries.end());
+  }
+  else
+  {
+    // Calculate the RBF values. Currently using Phi(r) = r with r is the euclidian distance between two points
+    m_SparseSolutionMatrix.resize(0, 0);
+    m_SolutionMatrix.resize(numberOfCenters, numberOfCenters);
+
+    const std::size_t numberOfChunks = GetNumberOfChunks(numberOfCenters);
+    mitk::RunInParallel(m_NumberOfThreads, numberOfChunks, [&](std::size_t chunkId, std::size_t) {
+      const unsigned int end = std::min<std::size_t>(numberOfCenters, (chunkId + 1) * ChunkSize);
+      for (unsigned int j = chunkId * ChunkSize; j < end; j++)
+      {
+        m_SolutionMatrix.col(j) = (m_CenterMatrix.colwise() - m_CenterMatrix.col(j)).colwise().norm().transpose();
+      }
+    });
+  }
+}
+
+void mitk::CreateDistanceImageFromSurfaceFilter::SolveEquationSystem()
+{
+  m_NumberOfSolverIterations = 0;
+
+  if (!m_WarmStart || !this->SolveEquationSystemWithWarmStart())
   {
-    for (unsigned int j = 0; j < numberOfCenters; j++)
+    m_NumberOfSolverIterations = 0;
+
+    if (m_RBFKernel == LinearKernel)
+    {
+      m_Weights = m_SolutionMatrix.partialPivLu().solve(m_FunctionValues);
+    }
+    else
     {
-      // Calculate the RBF value. Currently using Phi(r) = r with r is the euclidian distance between two points
-      p1 = m_Centers.at(i);
-      p2 = m_Centers.at(j);
-      p1 = p1 - p2;
-      norm = p1.two_norm();
-      m_SolutionMatrix(i, j) = norm;
+      // Wendland's function is positive definite, so a sparse Cholesky factorization usually succeeds.
+      // Nearly coinciding centers can make the matrix numerically singular; then the more robust LU is used.
+      Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> ldlt(m_SparseSolutionMatrix);
+      if (ldlt.info() == Eigen::Success)
+        m_Weights = ldlt.solve(m_FunctionValues);
+
+      if (ldlt.info() != Eigen::Success)
+      {
+        MITK_WARN << "mitk::CreateDistanceImageFromSurfaceFilter: Cholesky factorization of the sparse equation "
+                     "system failed, falling back to sparse LU decomposition.";
+
+        m_SparseSolutionMatrix.makeCompressed();
+        Eigen::SparseLU<Eigen::SparseMatrix<double>> lu;
+        lu.compute(m_SparseSolutionMatrix);
+        if (lu.info() != Eigen::Success)
+        {
+          itkExceptionMacro("mitk::CreateDistanceImageFromSurfaceFilter: The equation system could not be solved!");
+        }
+        m_Weights = lu.solve(m_FunctionValues);
+      }
     }
   }
+
+  m_PreviousSurfaceCenters.assign(m_Centers.begin(), m_Centers.begin() + m_NumberOfSurfaceCenters);
+  m_PreviousWeights = m_Weights;
+}
+
+bool mitk::CreateDistanceImageFromSurfaceFilter::SolveEquationSystemWithWarmStart()
+{
+  const unsigned int numberOfPreviousCenters = m_PreviousSurfaceCenters.size();
+  if (numberOfPreviousCenters == 0 || m_PreviousWeights.size() != 3 * numberOfPreviousCenters)
+    return false;
+
+  std::map<PointType, unsigned int, PointLess> previousIds;
+  for (unsigned int i = 0; i < numberOfPreviousCenters; ++i)
+  {
+    previousIds.insert(std::make_pair(m_PreviousSurfaceCenters[i], i));
+  }
+
+  // The inner and outer points of a contour point follow with an offset of n resp. 2n
+  const unsigned int n = m_NumberOfSurfaceCenters;
+  Eigen::VectorXd initialGuess = Eigen::VectorXd::Zero(m_FunctionValues.size());
+  unsigned int numberOfReusedCenters(0);
+  for (unsigned int i = 0; i < n; ++i)
+  {
+    auto previous = previousIds.find(m_Centers[i]);
+    if (previous != previousIds.end())
+    {
+      initialGuess[i] = m_PreviousWeights[previous->second];
+      initialGuess[n + i] = m_PreviousWeights[numberOfPreviousCenters + previous->second];
+      initialGuess[2 * n + i] = m_PreviousWeights[2 * numberOfPreviousCenters + previous->second];
+      ++numberOfReusedCenters;
+    }
+  }
+
+  if (numberOfReusedCenters == 0)
+    return false;
+
+  // Beyond this number of iterations the direct solve is cheaper anyway
+  const int maxIterations = std::max<int>(100, m_FunctionValues.size() / 10);
+  const double tolerance = 1e-10;
+
+  if (m_RBFKernel == LinearKernel)
+  {
+    // phi(r) = r is indefinite and its matrix has a zero diagonal, so neither CG nor a Jacobi preconditioner apply
+    Eigen::BiCGSTAB<Eigen::MatrixXd, Eigen::IdentityPreconditioner> solver;
+    solver.setMaxIterations(maxIterations);
+    solver.setTolerance(tolerance);
+    solver.compute(m_SolutionMatrix);
+    m_Weights = solver.solveWithGuess(m_FunctionValues, initialGuess);
+    m_NumberOfSolverIterations = solver.iterations();
+    return solver.info() == Eigen::Success;
+  }
+
+  Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower | Eigen::Upper> solver;
+  solver.setMaxIterations(maxIterations);
+  solver.setTolerance(tolerance);
+  solver.compute(m_SparseSolutionMatrix);
+  m_Weights = solver.solveWithGuess(m_FunctionValues, initialGuess);
+  m_NumberOfSolverIterations = solver.iterations();
+  return solver.info() == Eigen::Success;
+}
+
+void mitk::CreateDistanceImageFromSurfaceFilter::CreateCenterGrid()
+{
+  m_EffectiveSupportRadius = m_SupportRadius;
+
+  if (m_EffectiveSupportRadius <= 0.0)
+  {
+    // The support has to bridge the largest gap between neighboring contours
+    double largestGap = 0.0;
+    for (std::size_t i = 0; i < m_ContourCentroids.size(); ++i)
+    {
+      double gap = std::numeric_limits<double>::max();
+      for (std::size_t j = 0; j < m_ContourCentroids.size(); ++j)
+      {
+        if (i != j)
+          gap = std::min(gap, (m_ContourCentroids[i] - m_ContourCentroids[j]).two_norm());
+      }
+      if (gap < std::numeric_limits<double>::max())
+        largestGap = std::max(largestGap, gap);
+    }
+
+    if (largestGap == 0.0)
+    {
+      // A single contour, every center supports every other one
+      largestGap = (m_CenterMatrix.rowwise().maxCoeff() - m_CenterMatrix.rowwise().minCoeff()).norm();
+    }
+
+    m_EffectiveSupportRadius = std::max(3.0 * largestGap, 5.0 * m_DistanceImageSpacing);
+  }
+
+  m_GridOrigin = m_CenterMatrix.rowwise().minCoeff();
+  const Eigen::Vector3d extent = m_CenterMatrix.rowwise().maxCoeff() - m_GridOrigin;
+  for (unsigned int dim = 0; dim < 3; ++dim)
+  {
+    m_GridSize[dim] = static_cast<int>(extent[dim] / m_EffectiveSupportRadius) + 1;
+  }
+
+  // Counting sort of the centers into the cells, the centers of a cell keep their order
+  const unsigned int numberOfCenters = m_CenterMatrix.cols();
+  std::vector<unsigned int> cellOfCenter(numberOfCenters);
+  m_GridCellStart.assign(static_cast<std::size_t>(m_GridSize.prod()) + 1, 0);
+
+  for (unsigned int i = 0; i < numberOfCenters; ++i)
+  {
+    int cell[3];
+    for (unsigned int dim = 0; dim < 3; ++dim)
+    {
+      cell[dim] = std::min(m_GridSize[dim] - 1,
+                           static_cast<int>((m_CenterMatrix(dim, i) - m_GridOrigin[dim]) / m_EffectiveSupportRadius));
+    }
+    cellOfCenter[i] = (cell[2] * m_GridSize[1] + cell[1]) * m_GridSize[0] + cell[0];
+    ++m_GridCellStart[cellOfCenter[i] + 1];
+  }
+
+  for (std::size_t cell = 1; cell < m_GridCellStart.size(); ++cell)
+  {
+    m_GridCellStart[cell] += m_GridCellStart[cell - 1];
+  }
+
+  m_GridCenterIds.resize(numberOfCenters);
+  std::vector<unsigned int> nextPosition(m_GridCellStart.begin(), m_GridCellStart.end() - 1);
+  for (unsigned int i = 0; i < numberOfCenters; ++i)
+  {
+    m_GridCenterIds[nextPosition[cellOfCenter[i]]++] = i;
+  }
 }
 
 void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
@@ -296,21 +591,25 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   * Now we must calculate the distance for each pixel. But instead of calculating the distance value
   * for all of the image's pixels we proceed similar to the region growing algorithm:
   *
-  * 1. Take the first pixel from the narrowband_point_list and calculate the distance for each neighbor (6er)
-  * 2. If the current index's distance value is below a certain threshold push it into the list
-  * 3. Next iteration take the next index from the list and originAsIndex with 1. again
+  * 1. Collect the not yet visited neighbors (6er) of all pixels of the current front
+  * 2. Calculate the distance for all of them in parallel
+  * 3. The pixels whose distance value is below a certain threshold form the next front
   *
-  * This is done until the narrowband_point_list is empty.
+  * This is done until the front is empty. Every pixel is evaluated at most once and the result
+  * does not depend on the number of threads.
   */
 
   typedef itk::ImageRegionIteratorWithIndex<DistanceImageType> ImageIterator;
-  typedef itk::NeighborhoodIterator<DistanceImageType> NeighborhoodImageIterator;
 
-  std::queue<DistanceImageType::IndexType> narrowbandPoints;
-  PointType currentPoint = m_Centers.at(0);
-  double distance = this->CalculateDistanceValue(currentPoint);
+  const DistanceImageType::RegionType region = m_DistanceImageITK->GetLargestPossibleRegion();
+  const DistanceImageType::SizeType size = region.GetSize();
+  const DistanceImageType::OffsetValueType *offsetTable = m_DistanceImageITK->GetOffsetTable();
+  double *buffer = m_DistanceImageITK->GetBufferPointer();
+
+  const double narrowBand = m_DistanceImageSpacing * m_NarrowBandWidth;
 
   // create itk::Point from vnl_vector
+  PointType currentPoint = m_Centers.at(0);
   DistanceImageType::PointType currentPointAsPoint;
   currentPointAsPoint[0] = currentPoint[0];
   currentPointAsPoint[1] = currentPoint[1];
@@ -320,49 +619,63 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   DistanceImageType::IndexType currentIndex;
   m_DistanceImageITK->TransformPhysicalPointToIndex(currentPointAsPoint, currentIndex);
 
-  assert(
-    m_DistanceImageITK->GetLargestPossibleRegion().IsInside(currentIndex)); // we are quite certain this should hold
+  assert(region.IsInside(currentIndex)); // we are quite certain this should hold
 
-  narrowbandPoints.push(currentIndex);
-  m_DistanceImageITK->SetPixel(currentIndex, distance);
+  std::vector<bool> isVisited(region.GetNumberOfPixels(), false);
+  std::vector<DistanceImageType::OffsetValueType> front(1, m_DistanceImageITK->ComputeOffset(currentIndex));
+  std::vector<DistanceImageType::OffsetValueType> candidates;
+  std::vector<double> distances;
 
-  NeighborhoodImageIterator::RadiusType radius;
-  radius.Fill(1);
-  NeighborhoodImageIterator nIt(radius, m_DistanceImageITK, m_DistanceImageITK->GetLargestPossibleRegion());
-  unsigned int relativeNbIdx[] = {4, 10, 12, 14, 16, 22};
+  isVisited[front.front()] = true;
+  buffer[front.front()] = this->CalculateDistanceValue(Eigen::Vector3d(currentPoint[0], currentPoint[1], currentPoint[2]));
 
-  bool isInBounds = false;
-  while (!narrowbandPoints.empty())
+  while (!front.empty())
   {
-    nIt.SetLocation(narrowbandPoints.front());
-    narrowbandPoints.pop();
-
-    unsigned int *relativeNb = &relativeNbIdx[0];
-    for (int i = 0; i < 6; i++)
+    candidates.clear();
+    for (const auto offset : front)
     {
-      nIt.GetPixel(*relativeNb, isInBounds);
-      if (isInBounds && nIt.GetPixel(*relativeNb) == m_DistanceImageDefaultBufferValue)
+      currentIndex = m_DistanceImageITK->ComputeIndex(offset);
+      for (unsigned int dim = 0; dim < 3; ++dim)
       {
-        currentIndex = nIt.GetIndex(*relativeNb);
+        if (currentIndex[dim] > 0 && !isVisited[offset - offsetTable[dim]])
+        {
+          isVisited[offset - offsetTable[dim]] = true;
+          candidates.push_back(offset - offsetTable[dim]);
+        }
+        if (currentIndex[dim] + 1 < static_cast<DistanceImageType::IndexValueType>(size[dim]) &&
+            !isVisited[offset + offsetTable[dim]])
+        {
+          isVisited[offset + offsetTable[dim]] = true;
+          candidates.push_back(offset + offsetTable[dim]);
+        }
+      }
+    }
 
-        // Transform the currently checked point from index-coordinates to
-        // world-coordinates
-        m_DistanceImageITK->TransformIndexToPhysicalPoint(currentIndex, currentPointAsPoint);
+    // threads are only started for fronts that are large enough to amortize their start
+    const auto numberOfFrontThreads = static_cast<unsigned int>(
+      std::min<std::size_t>(m_NumberOfThreads, candidates.size() / MinimumCandidatesPerThread));
+    const std::size_t numberOfChunks = GetNumberOfChunks(candidates.size());
 
-        // create a vnl_vector
-        currentPoint[0] = currentPointAsPoint[0];
-        currentPoint[1] = currentPointAsPoint[1];
-        currentPoint[2] = currentPointAsPoint[2];
+    distances.resize(candidates.size());
+    mitk::RunInParallel(numberOfFrontThreads, numberOfChunks, [&](std::size_t chunkId, std::size_t) {
+      const std::size_t end = std::min(candidates.size(), (chunkId + 1) * ChunkSize);
+      DistanceImageType::PointType point;
+      for (std::size_t i = chunkId * ChunkSize; i < end; ++i)
+      {
+        // Transform the currently checked point from index-coordinates to world-coordinates
+        m_DistanceImageITK->TransformIndexToPhysicalPoint(m_DistanceImageITK->ComputeIndex(candidates[i]), point);
+        distances[i] = this->CalculateDistanceValue(Eigen::Vector3d(point[0], point[1], point[2]));
+      }
+    });
 
-        // and check the distance
-        distance = this->CalculateDistanceValue(currentPoint);
-        if (std::fabs(distance) <= m_DistanceImageSpacing * 2)
-        {
-          nIt.SetPixel(*relativeNb, distance);
-          narrowbandPoints.push(currentIndex);
-        }
+    front.clear();
+    for (std::size_t i = 0; i < candidates.size(); ++i)
+    {
+      if (std::fabs(distances[i]) <= narrowBand)
+      {
+        buffer[candidates[i]] = distances[i];
+        front.push_back(candidates[i]);
       }
-      relativeNb++;
     }
   }
 
@@ -423,25 +736,21 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   CastToMitkImage(m_DistanceImageITK, resultImage);
 }
 
-double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValue(PointType p)
+double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValue(const Eigen::Vector3d &p) const
 {
-  double distanceValue(0);
-  PointType p1;
-  PointType p2;
-  double norm;
-
-  CenterList::iterator centerIter;
-
-  unsigned int count(0);
-  for (centerIter = m_Centers.begin(); centerIter != m_Centers.end(); centerIter++)
+  if (m_RBFKernel == LinearKernel)
   {
-    p1 = *centerIter;
-    p2 = p - p1;
-    norm = p2.two_norm();
-    distanceValue = distanceValue + (norm * m_Weights[count]);
-    ++count;
+    return (m_CenterMatrix.colwise() - p).colwise().norm().dot(m_Weights.transpose());
   }
-  return distanceValue;
+
+  double distanceValue(0);
+  bool isSupported(false);
+  this->ForEachCenterInSupport(p, [&](unsigned int id, double r) {
+    distanceValue += Wendland(r) * m_Weights[id];
+    isSupported = true;
+  });
+
+  return isSupported ? distanceValue : std::numeric_limits<double>::max();
 }
 
 void mitk::CreateDistanceImageFromSurfaceFilter::GenerateOutputInformation()
@@ -450,6 +759,11 @@ void mitk::CreateDistanceImageFromSurfaceFilter::GenerateOutputInformation()
 
 void mitk::CreateDistanceImageFromSurfaceFilter::PrintEquationSystem()
 {
+  if (m_RBFKernel == CompactKernel)
+  {
+    m_SolutionMatrix = Eigen::MatrixXd(m_SparseSolutionMatrix);
+  }
+
   std::stringstream out;
   out << "Nummber of rows: " << m_SolutionMatrix.rows() << " ****** Number of columns: " << m_SolutionMatrix.cols()
       << endl;
@@ -28,6 +28,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "itkImageBase.h"
 
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include <vector>
 
 namespace mitk
 {
@@ -61,6 +64,13 @@ namespace mitk
          adjusted by calling SetDistanceImageVolume(unsigned int volume) which specifies the number ob pixels enclosed
   by the image.
 
+         By default the globally supported kernel phi(r) = r is used, which requires a dense solve that is cubic in the
+         number of contour points. For many contours SetRBFKernel(CompactKernel) switches to Wendland's compactly
+         supported kernel: the equation system becomes sparse and each voxel only sums up the centers within the
+         support radius. The distance function is only evaluated within a narrow band around the surface (see
+         SetNarrowBandWidth()); the evaluation is distributed over NumberOfThreads threads and yields the same result
+         for any number of threads.
+
   \ingroup Process
 
   $Author: fetzer$
@@ -78,6 +88,15 @@ namespace mitk
 
     typedef std::vector<Surface::Pointer> SurfaceList;
 
+    /** \brief Radial basis functions available for the interpolation */
+    enum RBFKernelType
+    {
+      /** phi(r) = r, globally supported. The equation system is dense and solved by LU decomposition. */
+      LinearKernel,
+      /** Wendland's phi(r) = (1 - r/R)^4 * (4r/R + 1) for r < R, zero otherwise. The equation system is sparse. */
+      CompactKernel
+    };
+
     mitkClassMacro(CreateDistanceImageFromSurfaceFilter, ImageSource);
     itkFactorylessNewMacro(Self) itkCloneMacro(Self)
 
@@ -103,6 +122,52 @@ namespace mitk
     */
     itkSetMacro(DistanceImageVolume, unsigned int);
 
+    /**
+    \brief Set the radial basis function used for the interpolation (default: LinearKernel).
+
+    The compact kernel is considerably faster for many contours but only approximates the result of the linear
+    kernel. Points that are not within the support radius of any contour point are treated as outside.
+    */
+    itkSetEnumMacro(RBFKernel, RBFKernelType);
+    itkGetEnumMacro(RBFKernel, RBFKernelType);
+
+    /**
+    \brief Set the support radius R of the compact kernel in mm.
+
+    R has to bridge the gaps between the contours. If it is 0 (default), R is three times the largest distance
+    between the centroid of a contour and the nearest centroid of another contour, but at least five times the
+    spacing of the distance image.
+    */
+    itkSetMacro(SupportRadius, double);
+    itkGetConstMacro(SupportRadius, double);
+
+    /**
+    \brief Set the half width of the narrow band around the surface in which the distance function is
+    evaluated, in multiples of the distance image spacing (default: 2).
+    */
+    itkSetMacro(NarrowBandWidth, double);
+    itkGetConstMacro(NarrowBandWidth, double);
+
+    /** \brief Set the number of threads used to set up the equation system and to evaluate the distance function.
+     *  Defaults to the global default number of threads of ITK. */
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
+    /**
+    \brief Set whether the weights of the previous update are used as initial guess (default: false).
+
+    If enabled, the equation system is solved iteratively. Centers at the same position as in the previous update
+    start with their previous weights, new centers with zero. So adding or replacing a single contour only needs
+    a few iterations instead of a full decomposition. If the iterative solver does not converge, the system is
+    solved directly.
+    */
+    itkSetMacro(WarmStart, bool);
+    itkGetConstMacro(WarmStart, bool);
+    itkBooleanMacro(WarmStart);
+
+    /** \brief Returns the number of iterations of the last iterative solve, 0 if the system was solved directly. */
+    itkGetConstMacro(NumberOfSolverIterations, unsigned int);
+
     void PrintEquationSystem();
 
     // Resets the filter, i.e. removes all inputs and outputs
@@ -132,7 +197,26 @@ namespace mitk
 
   private:
     void CreateSolutionMatrixAndFunctionValues();
-    double CalculateDistanceValue(PointType p);
+    void SolveEquationSystem();
+
+    /** \brief Solves the system iteratively, starting from the weights of the previous update.
+     * Returns false if there are no previous weights or the solver did not converge. */
+    bool SolveEquationSystemWithWarmStart();
+
+    /**
+    * \brief Evaluates the interpolated distance function at p.
+    *
+    * For the compact kernel std::numeric_limits<double>::max() is returned if p is not within the support
+    * radius of any center. The method is thread-safe.
+    */
+    double CalculateDistanceValue(const Eigen::Vector3d &p) const;
+
+    /** \brief Determines the support radius of the compact kernel and sorts the centers into a grid of that cell size. */
+    void CreateCenterGrid();
+
+    /** \brief Calls function(centerId, r / R) for all centers within the support radius R around p. */
+    template <typename TFunction>
+    void ForEachCenterInSupport(const Eigen::Vector3d &p, const TFunction &function) const;
 
     void FillDistanceImage();
 
@@ -161,8 +245,13 @@ namespace mitk
     // Datastructures for the interpolation
     CenterList m_Centers;
     NormalList m_Normals;
+    CenterList m_ContourCentroids;
+
+    // The centers as columns of a matrix, so that the evaluation can be vectorized
+    Eigen::Matrix3Xd m_CenterMatrix;
 
     Eigen::MatrixXd m_SolutionMatrix;
+    Eigen::SparseMatrix<double> m_SparseSolutionMatrix;
     Eigen::VectorXd m_FunctionValues;
     Eigen::VectorXd m_Weights;
 
@@ -175,6 +264,26 @@ namespace mitk
 
     bool m_UseProgressBar;
     unsigned int m_ProgressStepSize;
+
+    RBFKernelType m_RBFKernel;
+    double m_SupportRadius;
+    double m_NarrowBandWidth;
+    unsigned int m_NumberOfThreads;
+    bool m_WarmStart;
+    unsigned int m_NumberOfSolverIterations;
+
+    // The contour points and weights of the previous update, used as initial guess if m_WarmStart is set
+    unsigned int m_NumberOfSurfaceCenters;
+    CenterList m_PreviousSurfaceCenters;
+    Eigen::VectorXd m_PreviousWeights;
+
+    // Uniform grid over the centers with the support radius as cell size, only used by the compact kernel.
+    // The ids of the centers in cell c are m_GridCenterIds[m_GridCellStart[c]] ... m_GridCenterIds[m_GridCellStart[c+1]-1]
+    double m_EffectiveSupportRadius;
+    Eigen::Vector3d m_GridOrigin;
+    Eigen::Vector3i m_GridSize;
+    std::vector<unsigned int> m_GridCellStart;
+    std::vector<unsigned int> m_GridCenterIds;
   };
 
 } // namespace
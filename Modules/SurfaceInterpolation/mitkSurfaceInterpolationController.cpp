@@ -78,7 +78,17 @@ mitk::SurfaceInterpolationController::ContourPositionInformation CreateContourPo
 }
 
 mitk::SurfaceInterpolationController::SurfaceInterpolationController()
-  : m_SelectedSegmentation(nullptr), m_CurrentTimeStep(0)
+  : m_SelectedSegmentation(nullptr),
+    m_CurrentTimeStep(0),
+    m_MinSpacing(-1.0),
+    m_MaxSpacing(-1.0),
+    m_DistanceImageVolume(50000),
+    m_IncrementalInterpolation(false),
+    m_HasPendingJob(false),
+    m_HasFinishedResult(false),
+    m_IsInterpolating(false),
+    m_StopInterpolationThread(false),
+    m_InterpolationGeneration(0)
 {
   m_DistanceImageSpacing = 0.0;
   m_ReduceFilter = ReduceContourSetFilter::New();
@@ -101,10 +111,23 @@ mitk::SurfaceInterpolationController::SurfaceInterpolationController()
 
   m_InterpolationResult = nullptr;
   m_CurrentNumberOfReducedContours = 0;
+
+  m_AsyncInterpolateSurfaceFilter = CreateDistanceImageFromSurfaceFilter::New();
 }
 
 mitk::SurfaceInterpolationController::~SurfaceInterpolationController()
 {
+  {
+    std::lock_guard<std::mutex> lock(m_InterpolationMutex);
+    m_StopInterpolationThread = true;
+    m_HasPendingJob = false;
+  }
+
+  m_InterpolationRequested.notify_all();
+
+  if (m_InterpolationThread.joinable())
+    m_InterpolationThread.join();
+
   // Removing all observers
   auto dataIter = m_SegmentationObserverTags.begin();
   for (; dataIter != m_SegmentationObserverTags.end(); ++dataIter)
@@ -265,6 +288,9 @@ unsigned int mitk::SurfaceInterpolationController::GetNumberOfContours()
 
 void mitk::SurfaceInterpolationController::Interpolate()
 {
+  // A result of a background interpolation must not overwrite this one
+  this->SupersedeInterpolation();
+
   m_ReduceFilter->Update();
 
   m_CurrentNumberOfReducedContours = m_ReduceFilter->GetNumberOfOutputs();
@@ -296,6 +322,7 @@ void mitk::SurfaceInterpolationController::Interpolate()
   if (m_CurrentNumberOfReducedContours < 2)
   {
     // If no interpolation is possible reset the interpolation result
+    std::lock_guard<std::mutex> lock(m_InterpolationMutex);
     m_InterpolationResult = nullptr;
     return;
   }
@@ -313,6 +340,8 @@ void mitk::SurfaceInterpolationController::Interpolate()
 
   mitk::Surface::Pointer interpolationResult = mitk::Surface::New();
   interpolationResult->SetVtkPolyData(imageToSurfaceFilter->GetOutput()->GetVtkPolyData(), m_CurrentTimeStep);
+
+  std::lock_guard<std::mutex> lock(m_InterpolationMutex);
   m_InterpolationResult = interpolationResult;
 
   m_DistanceImageSpacing = m_InterpolateSurfaceFilter->GetDistanceImageSpacing();
@@ -332,8 +361,262 @@ void mitk::SurfaceInterpolationController::Interpolate()
   m_InterpolationResult->DisconnectPipeline();
 }
 
+void mitk::SurfaceInterpolationController::InterpolateAsync()
+{
+  if (!m_SelectedSegmentation || m_CurrentTimeStep >= m_SelectedSegmentation->GetTimeSteps())
+  {
+    return;
+  }
+
+  InterpolationJob job;
+  job.contours = m_ListOfInterpolationSessions[m_SelectedSegmentation][m_CurrentTimeStep];
+  job.timeStep = m_CurrentTimeStep;
+  job.minSpacing = m_MinSpacing;
+  job.maxSpacing = m_MaxSpacing;
+  job.distanceImageVolume = m_DistanceImageVolume;
+  job.incremental = m_IncrementalInterpolation;
+
+  // The segmentation is edited while the interpolation is running
+  mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
+  timeSelector->SetInput(m_SelectedSegmentation);
+  timeSelector->SetTimeNr(m_CurrentTimeStep);
+  timeSelector->SetChannelNr(0);
+  timeSelector->Update();
+  job.segmentation = timeSelector->GetOutput()->Clone();
+
+  {
+    std::lock_guard<std::mutex> lock(m_InterpolationMutex);
+
+    job.generation = ++m_InterpolationGeneration;
+    m_PendingJob = job;
+    m_HasPendingJob = true;
+
+    if (!m_InterpolationThread.joinable())
+      m_InterpolationThread = std::thread(&SurfaceInterpolationController::InterpolationThreadMain, this);
+  }
+
+  m_InterpolationRequested.notify_one();
+}
+
+bool mitk::SurfaceInterpolationController::IsInterpolationRunning() const
+{
+  std::lock_guard<std::mutex> lock(m_InterpolationMutex);
+  return m_HasPendingJob || m_IsInterpolating;
+}
+
+void mitk::SurfaceInterpolationController::WaitForInterpolation()
+{
+  {
+    std::unique_lock<std::mutex> lock(m_InterpolationMutex);
+    m_InterpolationFinished.wait(lock, [this]() { return !m_HasPendingJob && !m_IsInterpolating; });
+  }
+
+  this->ApplyInterpolationResult();
+}
+
+void mitk::SurfaceInterpolationController::SetInterpolationReadyCallback(const std::function<void()> &callback)
+{
+  std::lock_guard<std::mutex> lock(m_InterpolationMutex);
+  m_InterpolationReadyCallback = callback;
+}
+
+bool mitk::SurfaceInterpolationController::ApplyInterpolationResult()
+{
+  InterpolationJobResult result;
+
+  {
+    std::lock_guard<std::mutex> lock(m_InterpolationMutex);
+
+    if (!m_HasFinishedResult)
+      return false;
+
+    result = m_FinishedResult;
+    m_FinishedResult = InterpolationJobResult();
+    m_HasFinishedResult = false;
+
+    if (result.generation != m_InterpolationGeneration)
+      return false;
+
+    m_InterpolationResult = result.surface;
+    if (result.surface.IsNotNull())
+      m_DistanceImageSpacing = result.distanceImageSpacing;
+  }
+
+  m_Contours->SetVtkPolyData(result.contours);
+  this->InvokeEvent(SurfaceInterpolationFinishedEvent());
+
+  return true;
+}
+
+void mitk::SurfaceInterpolationController::SetIncrementalInterpolation(bool incremental)
+{
+  m_IncrementalInterpolation = incremental;
+  m_InterpolateSurfaceFilter->SetWarmStart(incremental);
+}
+
+bool mitk::SurfaceInterpolationController::GetIncrementalInterpolation() const
+{
+  return m_IncrementalInterpolation;
+}
+
+void mitk::SurfaceInterpolationController::SupersedeInterpolation()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_InterpolationMutex);
+    ++m_InterpolationGeneration;
+    m_HasPendingJob = false;
+    m_PendingJob = InterpolationJob();
+    m_HasFinishedResult = false;
+    m_FinishedResult = InterpolationJobResult();
+  }
+
+  m_InterpolationFinished.notify_all();
+}
+
+bool mitk::SurfaceInterpolationController::RunInterpolationJob(const InterpolationJob &job,
+                                                               InterpolationJobResult &result)
+{
+  auto isSuperseded = [&]() { return job.generation != m_InterpolationGeneration; };
+
+  // The contours for the 3D visualization
+  vtkSmartPointer<vtkAppendPolyData> polyDataAppender = vtkSmartPointer<vtkAppendPolyData>::New();
+  for (const auto &contourInfo : job.contours)
+  {
+    polyDataAppender->AddInputData(contourInfo.contour->GetVtkPolyData());
+  }
+  polyDataAppender->Update();
+  result.contours = polyDataAppender->GetOutput();
+  result.distanceImageSpacing = 0.0;
+  result.generation = job.generation;
+
+  // Reducing the contours and computing their normals is linear in the number of contour points,
+  // so only the distance image filter that holds the previous solution is kept
+  ReduceContourSetFilter::Pointer reduceFilter = ReduceContourSetFilter::New();
+  reduceFilter->SetMinSpacing(job.minSpacing);
+  reduceFilter->SetMaxSpacing(job.maxSpacing);
+  for (unsigned int i = 0; i < job.contours.size(); ++i)
+  {
+    reduceFilter->SetInput(i, job.contours[i].contour);
+  }
+  reduceFilter->Update();
+
+  unsigned int numberOfReducedContours = reduceFilter->GetNumberOfOutputs();
+  if (numberOfReducedContours == 1 && reduceFilter->GetOutput(0)->GetVtkPolyData() == nullptr)
+  {
+    numberOfReducedContours = 0;
+  }
+
+  if (numberOfReducedContours < 2)
+  {
+    // No interpolation is possible
+    return !isSuperseded();
+  }
+
+  if (isSuperseded())
+  {
+    return false;
+  }
+
+  ComputeContourSetNormalsFilter::Pointer normalsFilter = ComputeContourSetNormalsFilter::New();
+  normalsFilter->SetSegmentationBinaryImage(job.segmentation);
+  if (job.maxSpacing > 0)
+  {
+    normalsFilter->SetMaxSpacing(job.maxSpacing);
+  }
+
+  itk::ImageBase<3>::Pointer itkImage = itk::ImageBase<3>::New();
+  AccessFixedDimensionByItk_1(job.segmentation, GetImageBase, 3, itkImage);
+
+  m_AsyncInterpolateSurfaceFilter->Reset();
+  m_AsyncInterpolateSurfaceFilter->SetReferenceImage(itkImage.GetPointer());
+  m_AsyncInterpolateSurfaceFilter->SetDistanceImageVolume(job.distanceImageVolume);
+  m_AsyncInterpolateSurfaceFilter->SetWarmStart(job.incremental);
+
+  for (unsigned int i = 0; i < numberOfReducedContours; i++)
+  {
+    mitk::Surface::Pointer reducedContour = reduceFilter->GetOutput(i);
+    reducedContour->DisconnectPipeline();
+    normalsFilter->SetInput(i, reducedContour);
+    m_AsyncInterpolateSurfaceFilter->SetInput(i, normalsFilter->GetOutput(i));
+  }
+
+  normalsFilter->Update();
+
+  if (isSuperseded())
+  {
+    return false;
+  }
+
+  // create a surface from the distance-image
+  mitk::ImageToSurfaceFilter::Pointer imageToSurfaceFilter = mitk::ImageToSurfaceFilter::New();
+  imageToSurfaceFilter->SetInput(m_AsyncInterpolateSurfaceFilter->GetOutput());
+  imageToSurfaceFilter->SetThreshold(0);
+  imageToSurfaceFilter->SetSmooth(true);
+  imageToSurfaceFilter->SetSmoothIteration(20);
+  imageToSurfaceFilter->Update();
+
+  result.surface = mitk::Surface::New();
+  result.surface->SetVtkPolyData(imageToSurfaceFilter->GetOutput()->GetVtkPolyData(), job.timeStep);
+  result.surface->DisconnectPipeline();
+  result.distanceImageSpacing = m_AsyncInterpolateSurfaceFilter->GetDistanceImageSpacing();
+
+  return !isSuperseded();
+}
+
+void mitk::SurfaceInterpolationController::InterpolationThreadMain()
+{
+  while (true)
+  {
+    InterpolationJob job;
+
+    {
+      std::unique_lock<std::mutex> lock(m_InterpolationMutex);
+      m_InterpolationRequested.wait(lock, [this]() { return m_StopInterpolationThread || m_HasPendingJob; });
+
+      if (m_StopInterpolationThread)
+        return;
+
+      job = m_PendingJob;
+      m_PendingJob = InterpolationJob();
+      m_HasPendingJob = false;
+      m_IsInterpolating = true;
+    }
+
+    InterpolationJobResult result;
+    bool isValid = false;
+
+    try
+    {
+      isValid = this->RunInterpolationJob(job, result);
+    }
+    catch (const std::exception &e)
+    {
+      MITK_ERROR << "Surface interpolation failed: " << e.what();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_InterpolationMutex);
+
+      // The result is only handed over here, it is applied on the owning thread, see ApplyInterpolationResult()
+      if (isValid && job.generation == m_InterpolationGeneration)
+      {
+        m_FinishedResult = result;
+        m_HasFinishedResult = true;
+
+        if (m_InterpolationReadyCallback)
+          m_InterpolationReadyCallback();
+      }
+
+      m_IsInterpolating = false;
+    }
+
+    m_InterpolationFinished.notify_all();
+  }
+}
+
 mitk::Surface::Pointer mitk::SurfaceInterpolationController::GetInterpolationResult()
 {
+  std::lock_guard<std::mutex> lock(m_InterpolationMutex);
   return m_InterpolationResult;
 }
 
@@ -349,17 +632,20 @@ void mitk::SurfaceInterpolationController::SetDataStorage(DataStorage::Pointer d
 
 void mitk::SurfaceInterpolationController::SetMinSpacing(double minSpacing)
 {
+  m_MinSpacing = minSpacing;
   m_ReduceFilter->SetMinSpacing(minSpacing);
 }
 
 void mitk::SurfaceInterpolationController::SetMaxSpacing(double maxSpacing)
 {
+  m_MaxSpacing = maxSpacing;
   m_ReduceFilter->SetMaxSpacing(maxSpacing);
   m_NormalsFilter->SetMaxSpacing(maxSpacing);
 }
 
 void mitk::SurfaceInterpolationController::SetDistanceImageVolume(unsigned int distImgVolume)
 {
+  m_DistanceImageVolume = distImgVolume;
   m_InterpolateSurfaceFilter->SetDistanceImageVolume(distImgVolume);
 }
 
@@ -404,6 +690,8 @@ void mitk::SurfaceInterpolationController::SetCurrentInterpolationSession(mitk::
   if (currentSegmentationImage.GetPointer() == m_SelectedSegmentation)
     return;
 
+  this->SupersedeInterpolation();
+
   if (currentSegmentationImage.IsNull())
   {
     m_SelectedSegmentation = nullptr;
@@ -485,6 +773,7 @@ void mitk::SurfaceInterpolationController::RemoveInterpolationSession(mitk::Imag
   {
     if (m_SelectedSegmentation == segmentationImage)
     {
+      this->SupersedeInterpolation();
       m_NormalsFilter->SetSegmentationBinaryImage(nullptr);
       m_SelectedSegmentation = nullptr;
     }
@@ -501,6 +790,8 @@ void mitk::SurfaceInterpolationController::RemoveInterpolationSession(mitk::Imag
 
 void mitk::SurfaceInterpolationController::RemoveAllInterpolationSessions()
 {
+  this->SupersedeInterpolation();
+
   // Removing all observers
   auto dataIter = m_SegmentationObserverTags.begin();
   while (dataIter != m_SegmentationObserverTags.end())
@@ -631,6 +922,7 @@ void mitk::SurfaceInterpolationController::OnSegmentationDeleted(const itk::Obje
   {
     if (m_SelectedSegmentation == tempImage)
     {
+      this->SupersedeInterpolation();
       m_NormalsFilter->SetSegmentationBinaryImage(nullptr);
       m_SelectedSegmentation = nullptr;
     }
@@ -641,6 +933,9 @@ void mitk::SurfaceInterpolationController::OnSegmentationDeleted(const itk::Obje
 
 void mitk::SurfaceInterpolationController::ReinitializeInterpolation()
 {
+  // Results of background interpolations belong to the previous session, time step or set of contours
+  this->SupersedeInterpolation();
+
   // If session has changed reset the pipeline
   m_ReduceFilter->Reset();
   m_NormalsFilter->Reset();
@@ -47,8 +47,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkProgressBar.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
 namespace mitk
 {
+  /** \brief Invoked by SurfaceInterpolationController when the result of InterpolateAsync() is available. */
+  itkEventMacro(SurfaceInterpolationFinishedEvent, itk::AnyEvent);
+
   class MITKSURFACEINTERPOLATION_EXPORT SurfaceInterpolationController : public itk::Object
   {
   public:
@@ -124,6 +133,57 @@ namespace mitk
      */
     void Interpolate();
 
+    /**
+     * @brief Interpolates the 3D surface from the given extracted contours in a background thread.
+     *
+     * The contours and the segmentation of the current session and time step are copied, so they can be
+     * changed while the interpolation is running; the contour surfaces themselves must not be modified.
+     * A request supersedes all requests that have not been started yet. The result of a running
+     * interpolation is discarded if another interpolation was requested in the meantime, the session or the
+     * time step changed. Otherwise the result is kept until ApplyInterpolationResult() is called on the
+     * thread that owns the controller, see SetInterpolationReadyCallback().
+     */
+    void InterpolateAsync();
+
+    /**
+     * @brief Sets a function that is called in the background thread when a result of InterpolateAsync() is ready.
+     *
+     * The function is called while an internal lock is held. It must not access the controller, but only
+     * schedule a call of ApplyInterpolationResult() on the thread that owns the controller, e.g. by a queued
+     * Qt invocation. Pass nullptr to remove the function; it is not called anymore once this returns.
+     */
+    void SetInterpolationReadyCallback(const std::function<void()> &callback);
+
+    /**
+     * @brief Makes the latest result of InterpolateAsync() available via GetInterpolationResult() and
+     * GetContoursAsSurface() and invokes a SurfaceInterpolationFinishedEvent.
+     *
+     * Must be called on the thread that owns the controller. Returns false if no result is ready or if it
+     * was superseded in the meantime.
+     */
+    bool ApplyInterpolationResult();
+
+    /**
+     * @brief Returns true if an interpolation requested by InterpolateAsync() is pending or running.
+     */
+    bool IsInterpolationRunning() const;
+
+    /**
+     * @brief Blocks until all interpolations requested by InterpolateAsync() are finished and applies the
+     * result, see ApplyInterpolationResult().
+     */
+    void WaitForInterpolation();
+
+    /**
+     * @brief Set whether the interpolation reuses the previous solution (default: false).
+     *
+     * The equation system of the distance function is then solved iteratively, starting from the weights
+     * of the previous interpolation. The contour points of unchanged contours keep their weights, so adding a
+     * single contour only needs a few iterations instead of a full decomposition.
+     */
+    void SetIncrementalInterpolation(bool incremental);
+    bool GetIncrementalInterpolation() const;
+
     mitk::Surface::Pointer GetInterpolationResult();
 
     /**
@@ -226,6 +286,36 @@ namespace mitk
 
     void AddToInterpolationPipeline(ContourPositionInformation contourInfo);
 
+    /** Everything a background interpolation needs, copied when it is requested */
+    struct InterpolationJob
+    {
+      ContourPositionInformationList contours;
+      mitk::Image::Pointer segmentation;
+      unsigned int timeStep;
+      double minSpacing;
+      double maxSpacing;
+      unsigned int distanceImageVolume;
+      bool incremental;
+      unsigned long generation;
+    };
+
+    /** Result of a background interpolation. surface is nullptr if less than two contours are available */
+    struct InterpolationJobResult
+    {
+      mitk::Surface::Pointer surface;
+      vtkSmartPointer<vtkPolyData> contours;
+      double distanceImageSpacing;
+      unsigned long generation;
+    };
+
+    /** Discards pending requests and the results of running interpolations */
+    void SupersedeInterpolation();
+
+    /** Runs a background interpolation. Returns false if the job was superseded in the meantime */
+    bool RunInterpolationJob(const InterpolationJob &job, InterpolationJobResult &result);
+
+    void InterpolationThreadMain();
+
     ReduceContourSetFilter::Pointer m_ReduceFilter;
     ComputeContourSetNormalsFilter::Pointer m_NormalsFilter;
     CreateDistanceImageFromSurfaceFilter::Pointer m_InterpolateSurfaceFilter;
@@ -249,6 +339,27 @@ namespace mitk
     std::map<mitk::Image *, unsigned long> m_SegmentationObserverTags;
 
     unsigned int m_CurrentTimeStep;
+
+    double m_MinSpacing;
+    double m_MaxSpacing;
+    unsigned int m_DistanceImageVolume;
+    bool m_IncrementalInterpolation;
+
+    // Background interpolation, see InterpolateAsync(). The distance image filter is kept, so that
+    // its previous solution can be reused.
+    CreateDistanceImageFromSurfaceFilter::Pointer m_AsyncInterpolateSurfaceFilter;
+    std::thread m_InterpolationThread;
+    mutable std::mutex m_InterpolationMutex;
+    std::condition_variable m_InterpolationRequested;
+    std::condition_variable m_InterpolationFinished;
+    InterpolationJob m_PendingJob;
+    bool m_HasPendingJob;
+    InterpolationJobResult m_FinishedResult;
+    bool m_HasFinishedResult;
+    std::function<void()> m_InterpolationReadyCallback;
+    bool m_IsInterpolating;
+    bool m_StopInterpolationThread;
+    std::atomic<unsigned long> m_InterpolationGeneration;
   };
 }
 #endif
@@ -20,16 +20,30 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <QCheckBox>
 #include <QFormLayout>
+#include <QSpinBox>
 
 #include <berryIPreferencesService.h>
 #include <berryPlatform.h>
 
+#include <mitkUndoController.h>
+
+#include <algorithm>
+
+const QString QmitkGeneralPreferencePage::UNDO_PREFERENCES_NODE = "org.mitk.gui.qt.application.undo";
+
 QmitkGeneralPreferencePage::QmitkGeneralPreferencePage()
   : m_MainControl(nullptr)
 {
   // nothing here
 }
 
+void QmitkGeneralPreferencePage::ApplyUndoPreferences(berry::IPreferences::Pointer undoPreferences)
+{
+  // 0: no limit
+  std::size_t memoryLimit = std::max(0, undoPreferences->GetInt("memory limit", 0));
+  mitk::UndoController::SetMemoryLimit(memoryLimit * 1024 * 1024);
+}
+
 void QmitkGeneralPreferencePage::Init(berry::IWorkbench::Pointer)
 {
   // nothing here
@@ -39,15 +53,23 @@ void QmitkGeneralPreferencePage::CreateQtControl(QWidget* parent)
 {
   berry::IPreferencesService* prefService = berry::Platform::GetPreferencesService();
   m_GeneralPreferencesNode = prefService->GetSystemPreferences()->Node(QmitkDataNodeGlobalReinitAction::ACTION_ID);
+  m_UndoPreferencesNode = prefService->GetSystemPreferences()->Node(UNDO_PREFERENCES_NODE);
 
   m_MainControl = new QWidget(parent);
 
   m_GlobalReinitOnNodeDelete = new QCheckBox;
   m_GlobalReinitOnNodeVisibilityChanged = new QCheckBox;
+  m_UndoMemoryLimit = new QSpinBox;
+  m_UndoMemoryLimit->setRange(0, 1024 * 1024);
+  m_UndoMemoryLimit->setSingleStep(64);
+  m_UndoMemoryLimit->setSuffix(" MB");
+  m_UndoMemoryLimit->setSpecialValueText("No limit");
+  m_UndoMemoryLimit->setToolTip("The oldest undo steps are dropped if the undo history needs more memory");
 
   auto formLayout = new QFormLayout;
   formLayout->addRow("&Call global reinit if node is deleted", m_GlobalReinitOnNodeDelete);
   formLayout->addRow("&Call global reinit if node visibility is changed", m_GlobalReinitOnNodeVisibilityChanged);
+  formLayout->addRow("&Memory limit of the undo history", m_UndoMemoryLimit);
 
   m_MainControl->setLayout(formLayout);
   Update();
@@ -63,6 +85,9 @@ bool QmitkGeneralPreferencePage::PerformOk()
   m_GeneralPreferencesNode->PutBool("Call global reinit if node is deleted", m_GlobalReinitOnNodeDelete->isChecked());
   m_GeneralPreferencesNode->PutBool("Call global reinit if node visibility is changed", m_GlobalReinitOnNodeVisibilityChanged->isChecked());
 
+  m_UndoPreferencesNode->PutInt("memory limit", m_UndoMemoryLimit->value());
+  ApplyUndoPreferences(m_UndoPreferencesNode);
+
   return true;
 }
 
@@ -75,4 +100,5 @@ void QmitkGeneralPreferencePage::Update()
 {
   m_GlobalReinitOnNodeDelete->setChecked(m_GeneralPreferencesNode->GetBool("Call global reinit if node is deleted", true));
   m_GlobalReinitOnNodeVisibilityChanged->setChecked(m_GeneralPreferencesNode->GetBool("Call global reinit if node visibility is changed", false));
+  m_UndoMemoryLimit->setValue(m_UndoPreferencesNode->GetInt("memory limit", 0));
 }
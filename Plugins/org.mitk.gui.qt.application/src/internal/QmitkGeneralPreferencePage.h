@@ -22,6 +22,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 class QWidget;
 class QCheckBox;
+class QSpinBox;
 
 class QmitkGeneralPreferencePage : public QObject, public berry::IQtPreferencePage
 {
@@ -30,8 +31,16 @@ class QmitkGeneralPreferencePage : public QObject, public berry::IQtPreferencePa
 
 public:
 
+  /** Name of the preferences node of the undo history */
+  static const QString UNDO_PREFERENCES_NODE;
+
   QmitkGeneralPreferencePage();
 
+  /**
+  * @brief Applies the memory limit of the undo history from the given preferences to mitk::UndoController.
+  */
+  static void ApplyUndoPreferences(berry::IPreferences::Pointer undoPreferences);
+
   /**
   * @see berry::IPreferencePage::Init(berry::IWorkbench::Pointer workbench)
   */
@@ -68,8 +77,10 @@ protected:
 
     QCheckBox* m_GlobalReinitOnNodeDelete;
     QCheckBox* m_GlobalReinitOnNodeVisibilityChanged;
+    QSpinBox* m_UndoMemoryLimit;
 
     berry::IPreferences::Pointer m_GeneralPreferencesNode;
+    berry::IPreferences::Pointer m_UndoPreferencesNode;
 };
 
 #endif // QMITKGENERALPREFERENCEPAGE_H
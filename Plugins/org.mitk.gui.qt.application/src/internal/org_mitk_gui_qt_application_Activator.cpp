@@ -42,6 +42,13 @@ namespace mitk
 
     this->m_PrefServiceTracker.reset(new ctkServiceTracker<berry::IPreferencesService*>(context));
     this->m_PrefServiceTracker->open();
+
+    // the memory limit of the undo history applies right from the start, not only after the preferences are edited
+    if (berry::IPreferencesService* prefService = this->GetPreferencesService())
+    {
+      QmitkGeneralPreferencePage::ApplyUndoPreferences(
+        prefService->GetSystemPreferences()->Node(QmitkGeneralPreferencePage::UNDO_PREFERENCES_NODE));
+    }
   }
 
   void org_mitk_gui_qt_application_Activator::stop(ctkPluginContext* context)